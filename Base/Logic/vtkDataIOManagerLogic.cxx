@@ -316,6 +316,8 @@ int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
   //--- This test has been done in MRML (DataIOManager), but with asynchIO,
   //--- Cache may have become full since the remote read was queued.
   //---
+  //--- Evict least recently used files first to make room for the download.
+  cm->EnforceCacheLimit();
   float bufsize = (cm->GetRemoteCacheLimit() * 1000000.0) -  (cm->GetRemoteCacheFreeBufferSize() * 1000000.0);
   if ( (cm->GetCurrentCacheSize()*1000000.0) >= bufsize )
     {
@@ -717,6 +719,10 @@ void vtkDataIOManagerLogic::ApplyTransfer( void *clientdata )
         dt->SetTransferStatusNoModify ( vtkDataTransfer::Running );
         this->GetApplicationLogic()->RequestModified( dt );
         handler->StageFileRead( source, dest);
+        if ( iom != nullptr && iom->GetCacheManager() != nullptr )
+          {
+          iom->GetCacheManager()->AddToCacheIndex ( dest );
+          }
         dt->SetTransferStatusNoModify ( vtkDataTransfer::Completed );
         this->GetApplicationLogic()->RequestModified( dt );
 
@@ -759,6 +765,10 @@ void vtkDataIOManagerLogic::ApplyTransfer( void *clientdata )
         {
         vtkDebugMacro("ApplyTransfer: stage file read on the handler..., source = " << source << ", dest = " << dest);
         handler->StageFileRead( source, dest);
+        if ( iom != nullptr && iom->GetCacheManager() != nullptr )
+          {
+          iom->GetCacheManager()->AddToCacheIndex ( dest );
+          }
         }
       }
     }
@@ -21,6 +21,8 @@
 #include "qSlicerApplicationHelper.h"
 
 // Qt includes
+#include <QDir>
+#include <QFileInfo>
 #include <QFont>
 #include <QLabel>
 #include <QSettings>
@@ -122,6 +124,15 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
 
   qSlicerCommandOptions* options = qSlicerApplication::application()->commandOptions();
 
+  // Cache the result of module discovery next to the revision specific
+  // settings so that it is discarded when the application is updated.
+  if (!options->disableModuleDiscoveryCache() && !options->settingsDisabled())
+    {
+    QFileInfo settingsFileInfo(app->slicerRevisionUserSettingsFilePath());
+    moduleFactoryManager->setDiscoveryCacheFilePath(
+      settingsFileInfo.dir().filePath(settingsFileInfo.completeBaseName() + "-ModuleDiscoveryCache.bin"));
+    }
+
   if(options->disableModules())
     {
     return;
@@ -179,6 +190,7 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
 
     qSlicerCLIExecutableModuleFactory* cliExecutableFactory = new qSlicerCLIExecutableModuleFactory();
     cliExecutableFactory->setTempDirectory(tempDirectory);
+    cliExecutableFactory->setDiscoveryCache(moduleFactoryManager->discoveryCache());
     moduleFactoryManager->registerFactory(cliExecutableFactory, preferExecutableCLIs ? 1 : 0);
 
     if (!options->disableBuiltInModules() &&
@@ -212,6 +224,12 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
   moduleFactoryManager->setModulesToIgnore(modulesToIgnore);
 
   moduleFactoryManager->setVerboseModuleDiscovery(app->commandOptions()->verboseModuleDiscovery());
+
+  // Optionally defer the setup of modules until they are used
+  moduleFactoryManager->setLazyModuleSetup(
+    app->userSettings()->value("Modules/LazySetup", false).toBool());
+  moduleFactoryManager->setModulesToSetupAtStartup(
+    app->userSettings()->value("Modules/SetupAtStartup").toStringList());
 }
 
 //----------------------------------------------------------------------------
@@ -42,6 +42,7 @@
 # include "qSlicerCLILoadableModuleFactory.h"
 #endif
 #include "qSlicerCommandOptions.h"
+#include "qSlicerModuleDiscoveryCache.h"
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerModuleManager.h"
 
@@ -200,9 +201,15 @@ int qSlicerApplicationHelper::postInitializeApplication(
     splashMessage(splashScreen, "Loading module \"" + name + "\"...");
     moduleFactoryManager->loadModule(name);
     }
+  if (moduleFactoryManager->discoveryCache())
+    {
+    // Save information gathered while setting up the modules
+    moduleFactoryManager->discoveryCache()->save();
+    }
   if (app.commandOptions()->verboseModuleDiscovery())
     {
     qDebug() << "Number of loaded modules:" << moduleManager->modulesNames().count();
+    qDebug().noquote() << "Module startup times (ms):\n" << moduleFactoryManager->moduleTimingReport();
     }
 
   splashMessage(splashScreen, QString());
@@ -26,6 +26,7 @@
 #include "qSlicerCLIExecutableModuleFactory.h"
 #include "qSlicerCLIModule.h"
 #include "qSlicerCLIModuleFactoryHelper.h"
+#include "qSlicerModuleDiscoveryCache.h"
 #include "qSlicerUtils.h"
 #include <vtkSlicerCLIModuleLogic.h>
 
@@ -49,7 +50,10 @@ QString findPython()
 
 //-----------------------------------------------------------------------------
 qSlicerCLIExecutableModuleFactoryItem::qSlicerCLIExecutableModuleFactoryItem(
-  const QString& newTempDirectory) : TempDirectory(newTempDirectory)
+  const QString& newTempDirectory, qSlicerModuleDiscoveryCache* discoveryCache)
+  : TempDirectory(newTempDirectory)
+  , DiscoveryCache(discoveryCache)
+  , CLIModule(nullptr)
 {
 }
 
@@ -96,7 +100,8 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
 
   //
   // If the xml file exists, read it and associate it with the module
-  // description. If not, run the CLI executable with "--xml".
+  // description. If not, look for a description cached during a previous
+  // startup and, as a last resort, run the CLI executable with "--xml".
   //
   QString xmlDescription;
   if (QFile::exists(xmlFilePath))
@@ -114,7 +119,19 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
     }
   else
     {
-    xmlDescription = this->runCLIWithXmlArgument();
+    QFileInfo executableFile(this->path());
+    if (this->DiscoveryCache)
+      {
+      xmlDescription = this->DiscoveryCache->value(executableFile, "xmlDescription").toString();
+      }
+    if (xmlDescription.isEmpty())
+      {
+      xmlDescription = this->runCLIWithXmlArgument();
+      if (this->DiscoveryCache && !xmlDescription.isEmpty())
+        {
+        this->DiscoveryCache->setValue(executableFile, "xmlDescription", xmlDescription);
+        }
+      }
     }
   if (xmlDescription.isEmpty())
     {
@@ -233,6 +250,7 @@ public:
 
 private:
   QString TempDirectory;
+  qSlicerModuleDiscoveryCache* DiscoveryCache;
 };
 
 //-----------------------------------------------------------------------------
@@ -240,6 +258,7 @@ qSlicerCLIExecutableModuleFactoryPrivate::qSlicerCLIExecutableModuleFactoryPriva
 :q_ptr(&object)
 {
   this->TempDirectory = QDir::tempPath();
+  this->DiscoveryCache = nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -284,7 +303,7 @@ ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLIExecutableModuleFac
 ::createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLIExecutableModuleFactory);
-  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory);
+  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory, d->DiscoveryCache);
 }
 
 //-----------------------------------------------------------------------------
@@ -299,3 +318,10 @@ void qSlicerCLIExecutableModuleFactory::setTempDirectory(const QString& newTempD
   Q_D(qSlicerCLIExecutableModuleFactory);
   d->TempDirectory = newTempDirectory;
 }
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactory::setDiscoveryCache(qSlicerModuleDiscoveryCache* discoveryCache)
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  d->DiscoveryCache = discoveryCache;
+}
@@ -25,6 +25,7 @@
 #include "qSlicerAbstractCoreModule.h"
 #include "qSlicerBaseQTCLIExport.h"
 class qSlicerCLIModule;
+class qSlicerModuleDiscoveryCache;
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -35,7 +36,8 @@ class qSlicerCLIExecutableModuleFactoryItem
   : public ctkAbstractFactoryFileBasedItem<qSlicerAbstractCoreModule>
 {
 public:
-  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory);
+  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory,
+                                        qSlicerModuleDiscoveryCache* discoveryCache = nullptr);
   bool load() override;
   void uninstantiate() override;
 protected:
@@ -46,6 +48,7 @@ protected:
   QString runCLIWithXmlArgument();
 private:
   QString TempDirectory;
+  qSlicerModuleDiscoveryCache* DiscoveryCache;
   qSlicerCLIModule* CLIModule;
 };
 
@@ -71,6 +74,13 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Set the cache used to store the XML description of CLI executables
+  /// without an associated XML file. This avoids running each executable
+  /// with "--xml" at startup when the executable has not changed.
+  /// The cache is not owned by the factory.
+  /// \sa qSlicerAbstractModuleFactoryManager::discoveryCache()
+  void setDiscoveryCache(qSlicerModuleDiscoveryCache* discoveryCache);
+
 protected:
   bool isValidFile(const QFileInfo& file)const override;
 
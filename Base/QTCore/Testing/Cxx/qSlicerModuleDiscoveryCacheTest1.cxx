@@ -0,0 +1,161 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+// SlicerQt includes
+#include "qSlicerModuleDiscoveryCache.h"
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+//-----------------------------------------------------------------------------
+bool writeFile(const QString& filePath, const QString& content)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::Text | QIODevice::WriteOnly))
+    {
+    return false;
+    }
+  QTextStream out(&file);
+  out << content;
+  return true;
+}
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerModuleDiscoveryCacheTest1(int, char * [] )
+{
+  QTemporaryDir temporaryDir;
+  if (!temporaryDir.isValid())
+    {
+    std::cerr << "Line " << __LINE__ << " - Failed to create temporary directory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  QDir dir(temporaryDir.path());
+  QString moduleFilePath = dir.filePath("AModule");
+  QString cacheFilePath = dir.filePath("Cache/ModuleDiscoveryCache.bin");
+  if (!writeFile(moduleFilePath, "A module"))
+    {
+    std::cerr << "Line " << __LINE__ << " - Failed to write " << qPrintable(moduleFilePath) << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Store values and save
+  {
+    qSlicerModuleDiscoveryCache cache;
+    cache.setFilePath(cacheFilePath);
+    if (cache.load())
+      {
+      std::cerr << "Line " << __LINE__ << " - load() is expected to fail without cache file" << std::endl;
+      return EXIT_FAILURE;
+      }
+    cache.setValue(QFileInfo(moduleFilePath), "xmlDescription", QString("<?xml"));
+    cache.setValue(QFileInfo(dir.absolutePath()), "moduleFiles", QStringList() << "AModule");
+    if (!cache.isModified() || cache.count() != 2)
+      {
+      std::cerr << "Line " << __LINE__ << " - Problem with setValue()" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (!cache.save() || cache.isModified() || !QFile::exists(cacheFilePath))
+      {
+      std::cerr << "Line " << __LINE__ << " - Problem with save()" << std::endl;
+      return EXIT_FAILURE;
+      }
+  }
+
+  // Load and check values
+  {
+    qSlicerModuleDiscoveryCache cache;
+    cache.setFilePath(cacheFilePath);
+    if (!cache.load() || cache.count() != 2)
+      {
+      std::cerr << "Line " << __LINE__ << " - Problem with load()" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (!cache.contains(QFileInfo(moduleFilePath)) ||
+        cache.value(QFileInfo(moduleFilePath), "xmlDescription").toString() != "<?xml")
+      {
+      std::cerr << "Line " << __LINE__ << " - Problem with value()" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (cache.value(QFileInfo(dir.absolutePath()), "moduleFiles").toStringList() != (QStringList() << "AModule"))
+      {
+      std::cerr << "Line " << __LINE__ << " - Problem with value() for directory" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (cache.value(QFileInfo(moduleFilePath), "unknown", 42).toInt() != 42)
+      {
+      std::cerr << "Line " << __LINE__ << " - Problem with value() default value" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Modifying the file invalidates its entry
+    writeFile(moduleFilePath, "A modified module");
+    if (cache.contains(QFileInfo(moduleFilePath)) ||
+        cache.value(QFileInfo(moduleFilePath), "xmlDescription").isValid())
+      {
+      std::cerr << "Line " << __LINE__ << " - Stale entry is expected to be ignored" << std::endl;
+      return EXIT_FAILURE;
+      }
+    cache.setValue(QFileInfo(moduleFilePath), "title", QString("A"));
+    if (cache.value(QFileInfo(moduleFilePath), "xmlDescription").isValid() ||
+        cache.value(QFileInfo(moduleFilePath), "title").toString() != "A")
+      {
+      std::cerr << "Line " << __LINE__ << " - Stale values are expected to be discarded" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    cache.remove(QFileInfo(moduleFilePath));
+    if (cache.contains(QFileInfo(moduleFilePath)) || cache.count() != 1)
+      {
+      std::cerr << "Line " << __LINE__ << " - Problem with remove()" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Entries of removed files are pruned
+    cache.setValue(QFileInfo(moduleFilePath), "factory", QString("A"));
+    QFile::remove(moduleFilePath);
+    if (cache.removeMissingEntries() != 1 || cache.count() != 1 ||
+        cache.removeMissingEntries() != 0)
+      {
+      std::cerr << "Line " << __LINE__ << " - Problem with removeMissingEntries()" << std::endl;
+      return EXIT_FAILURE;
+      }
+  }
+
+  // Corrupted cache is discarded
+  {
+    writeFile(cacheFilePath, "corrupted");
+    qSlicerModuleDiscoveryCache cache;
+    cache.setFilePath(cacheFilePath);
+    if (cache.load() || cache.count() != 0)
+      {
+      std::cerr << "Line " << __LINE__ << " - Corrupted cache is expected to be discarded" << std::endl;
+      return EXIT_FAILURE;
+      }
+  }
+
+  return EXIT_SUCCESS;
+}
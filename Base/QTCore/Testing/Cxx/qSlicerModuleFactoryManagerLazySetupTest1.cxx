@@ -0,0 +1,194 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// CTK includes
+#include <ctkAbstractQObjectFactory.h>
+
+// SlicerQt includes
+#include "qSlicerAbstractCoreModule.h"
+#include "qSlicerModuleFactoryManager.h"
+
+// MRML includes
+#include <vtkMRMLAbstractLogic.h>
+#include <vtkMRMLNode.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+//-----------------------------------------------------------------------------
+class vtkMRMLLazySetupTestNode : public vtkMRMLNode
+{
+public:
+  static vtkMRMLLazySetupTestNode *New();
+  vtkTypeMacro(vtkMRMLLazySetupTestNode, vtkMRMLNode);
+  vtkMRMLNode* CreateNodeInstance() override
+    {
+    return vtkMRMLLazySetupTestNode::New();
+    }
+  const char* GetNodeTagName() override
+    {
+    return "LazySetupTest";
+    }
+};
+vtkStandardNewMacro(vtkMRMLLazySetupTestNode);
+
+//-----------------------------------------------------------------------------
+class vtkLazySetupTestLogic : public vtkMRMLAbstractLogic
+{
+public:
+  static vtkLazySetupTestLogic *New();
+  vtkTypeMacro(vtkLazySetupTestLogic, vtkMRMLAbstractLogic);
+protected:
+  void RegisterNodes() override
+    {
+    vtkLazySetupTestLogic::RegisterNodeClasses(this->GetMRMLScene());
+    }
+public:
+  static void RegisterNodeClasses(vtkMRMLScene* scene)
+    {
+    if (scene)
+      {
+      vtkNew<vtkMRMLLazySetupTestNode> node;
+      scene->RegisterNodeClass(node.GetPointer());
+      }
+    }
+};
+vtkStandardNewMacro(vtkLazySetupTestLogic);
+
+//-----------------------------------------------------------------------------
+class qSlicerLazySetupTestModule : public qSlicerAbstractCoreModule
+{
+  Q_OBJECT
+public:
+  typedef qSlicerAbstractCoreModule Superclass;
+  qSlicerLazySetupTestModule(QObject* parent = nullptr) : Superclass(parent) {}
+  QString title()const override { return "Lazy Setup Test";}
+  qSlicerAbstractModuleRepresentation* createWidgetRepresentation() override
+  {
+    return nullptr;
+  }
+  vtkMRMLAbstractLogic* createLogic() override
+  {
+    ++LogicCount;
+    return vtkLazySetupTestLogic::New();
+  }
+  bool registerNodes(vtkMRMLScene* scene) override
+  {
+    vtkLazySetupTestLogic::RegisterNodeClasses(scene);
+    return true;
+  }
+  static int SetupCount;
+  static int LogicCount;
+protected:
+  void setup() override { ++SetupCount; }
+};
+
+int qSlicerLazySetupTestModule::SetupCount = 0;
+int qSlicerLazySetupTestModule::LogicCount = 0;
+
+//-----------------------------------------------------------------------------
+class qSlicerLazySetupTestModuleFactory
+  : public ctkAbstractQObjectFactory<qSlicerAbstractCoreModule>
+{
+public:
+  void registerItems() override
+  {
+    QString key;
+    this->registerQObject<qSlicerLazySetupTestModule>(key);
+  }
+};
+
+//-----------------------------------------------------------------------------
+class qSlicerLazySetupTestModuleFactoryManager : public qSlicerModuleFactoryManager
+{
+protected:
+  bool isSetupRequiredAtLoad(const QString& vtkNotUsed(name))const override
+  {
+    return false;
+  }
+};
+
+//-----------------------------------------------------------------------------
+int qSlicerModuleFactoryManagerLazySetupTest1(int, char * [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  qSlicerLazySetupTestModuleFactoryManager moduleFactoryManager;
+  moduleFactoryManager.registerFactory(new qSlicerLazySetupTestModuleFactory);
+  moduleFactoryManager.setLazyModuleSetup(true);
+  moduleFactoryManager.setMRMLScene(scene.GetPointer());
+  moduleFactoryManager.registerModules();
+  moduleFactoryManager.instantiateModules();
+  if (moduleFactoryManager.loadModules() != 1)
+    {
+    std::cerr << "Line " << __LINE__ << " - Failed to load the test module" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const QString moduleName = "qSlicerLazySetupTestModule";
+
+  // The setup and the logic are deferred but the module registered the node class
+  if (moduleFactoryManager.isSetup(moduleName) || qSlicerLazySetupTestModule::SetupCount != 0)
+    {
+    std::cerr << "Line " << __LINE__ << " - Module setup is expected to be deferred" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (qSlicerLazySetupTestModule::LogicCount != 0)
+    {
+    std::cerr << "Line " << __LINE__ << " - Logic of a deferred module is not expected to be created" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!scene->IsNodeClassRegistered("vtkMRMLLazySetupTestNode"))
+    {
+    std::cerr << "Line " << __LINE__ << " - Node class of a deferred module is not registered" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A scene containing a node of the deferred module can be loaded
+  scene->SetLoadFromXMLString(1);
+  scene->SetSceneXMLString(
+    "<MRML version=\"Slicer4\">"
+    "<LazySetupTest id=\"vtkMRMLLazySetupTestNode1\" name=\"LazyNode\"></LazySetupTest>"
+    "</MRML>");
+  scene->Import();
+  if (vtkMRMLLazySetupTestNode::SafeDownCast(scene->GetFirstNodeByName("LazyNode")) == nullptr)
+    {
+    std::cerr << "Line " << __LINE__ << " - Failed to load a node of a deferred module" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The setup is done on demand, only once
+  if (!moduleFactoryManager.setupModule(moduleName) ||
+      !moduleFactoryManager.setupModule(moduleName) ||
+      !moduleFactoryManager.isSetup(moduleName) ||
+      qSlicerLazySetupTestModule::SetupCount != 1 ||
+      qSlicerLazySetupTestModule::LogicCount != 1)
+    {
+    std::cerr << "Line " << __LINE__ << " - Problem with setupModule()" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  moduleFactoryManager.unloadModules();
+  return EXIT_SUCCESS;
+}
+
+#include "moc_qSlicerModuleFactoryManagerLazySetupTest1.cxx"
@@ -25,6 +25,9 @@
 // SlicerQt includes
 #include "qSlicerAbstractCoreModule.h"
 #include "qSlicerAbstractModuleRepresentation.h"
+#include "qSlicerCoreApplication.h"
+#include "qSlicerModuleFactoryManager.h"
+#include "qSlicerModuleManager.h"
 
 // SlicerLogic includes
 #include "vtkSlicerModuleLogic.h"
@@ -48,6 +51,7 @@ public:
   bool                                       Installed;
   bool                                       BuiltIn;
   bool                                       WidgetRepresentationCreationEnabled;
+  bool                                       InitializationDeferred;
   qSlicerAbstractModuleRepresentation*       WidgetRepresentation;
   QList<qSlicerAbstractModuleRepresentation*> WidgetRepresentations;
   vtkSmartPointer<vtkMRMLScene>              MRMLScene;
@@ -65,6 +69,7 @@ qSlicerAbstractCoreModulePrivate::qSlicerAbstractCoreModulePrivate()
   this->Installed = false;
   this->BuiltIn = false;
   this->WidgetRepresentationCreationEnabled = true;
+  this->InitializationDeferred = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -86,6 +91,7 @@ qSlicerAbstractCoreModulePrivate::~qSlicerAbstractCoreModulePrivate()
 qSlicerAbstractCoreModule::qSlicerAbstractCoreModule(QObject* _parent)
   : Superclass(_parent)
   , d_ptr(new qSlicerAbstractCoreModulePrivate)
+  , Initialized(false)
 {
 }
 
@@ -96,11 +102,24 @@ qSlicerAbstractCoreModule::~qSlicerAbstractCoreModule()
 //-----------------------------------------------------------------------------
 void qSlicerAbstractCoreModule::initialize(vtkSlicerApplicationLogic* _appLogic)
 {
+  Q_D(qSlicerAbstractCoreModule);
+  if (this->Initialized)
+    {
+    return;
+    }
+  // Set the flag first so that setup() can safely request the widget
+  // representation without re-entering initialize()
+  this->Initialized = true;
+  d->InitializationDeferred = false;
   this->setAppLogic(_appLogic);
   this->logic(); // Create the logic if it hasn't been created already.
   this->setup(); // Setup is a virtual pure method overloaded in subclass
 }
 
+//-----------------------------------------------------------------------------
+CTK_GET_CPP(qSlicerAbstractCoreModule, bool, isInitializationDeferred, InitializationDeferred);
+CTK_SET_CPP(qSlicerAbstractCoreModule, bool, setInitializationDeferred, InitializationDeferred);
+
 //-----------------------------------------------------------------------------
 void qSlicerAbstractCoreModule::printAdditionalInfo()
 {
@@ -168,6 +187,12 @@ void qSlicerAbstractCoreModule::setMRMLScene(vtkMRMLScene* _mrmlScene)
     {// logic should be updated first (because it doesn't depends on the widget
     d->Logic->SetMRMLScene(_mrmlScene);
     }
+  else if (d->InitializationDeferred && _mrmlScene)
+    {
+    // The logic is created when the module is initialized, until then the
+    // nodes of the module can still be read from a scene
+    this->registerNodes(_mrmlScene);
+    }
   if (d->WidgetRepresentation)
     {
     d->WidgetRepresentation->setMRMLScene(_mrmlScene);
@@ -204,6 +229,12 @@ QStringList qSlicerAbstractCoreModule::dependencies()const
   return QStringList();
 }
 
+//-----------------------------------------------------------------------------
+bool qSlicerAbstractCoreModule::registerNodes(vtkMRMLScene* vtkNotUsed(scene))
+{
+  return false;
+}
+
 //-----------------------------------------------------------------------------
 CTK_GET_CPP(qSlicerAbstractCoreModule, QString, path, Path);
 CTK_SET_CPP(qSlicerAbstractCoreModule, const QString&, setPath, Path);
@@ -225,6 +256,18 @@ qSlicerAbstractModuleRepresentation* qSlicerAbstractCoreModule::widgetRepresenta
 {
   Q_D(qSlicerAbstractCoreModule);
 
+  // The module is selected for the first time, initialize it (and the modules
+  // it depends on) if it was deferred at startup.
+  if (d->InitializationDeferred && !this->Initialized)
+    {
+    qSlicerCoreApplication* app = qSlicerCoreApplication::application();
+    if (!app || !app->moduleManager() ||
+        !app->moduleManager()->factoryManager()->setupModule(this->name()))
+      {
+      this->initialize(d->AppLogic);
+      }
+    }
+
   // If required, create widgetRepresentation
   if (!d->WidgetRepresentation)
     {
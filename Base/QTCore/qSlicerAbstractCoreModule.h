@@ -202,9 +202,18 @@ public:
 
   /// Initialize the module, an appLogic must be given to
   /// initialize the module
+  /// Calling initialize() on an initialized module is a no-op.
   void initialize(vtkSlicerApplicationLogic* appLogic);
   inline bool initialized() { return this->Initialized; }
 
+  /// Set/Get if the initialization of the module has been deferred.
+  /// A deferred module is initialized the first time its widget
+  /// representation is requested, after the modules it depends on.
+  /// \sa qSlicerModuleFactoryManager::setupModule(),
+  /// qSlicerModuleFactoryManager::lazyModuleSetup
+  void setInitializationDeferred(bool deferred);
+  bool isInitializationDeferred()const;
+
   /// Set/Get the name of the module. The name is used to uniquely describe
   /// a module: name must be unique.
   /// The name is set by the module factory (the registered item key string).
@@ -295,6 +304,15 @@ public:
   /// Return node types associated with this module (e.g., node types this module can edit)
   virtual QStringList associatedNodeTypes()const;
 
+  /// Register the MRML node classes of the module in \a scene without
+  /// creating the module logic, so that a scene containing these nodes can
+  /// be loaded while the initialization of the module is deferred.
+  /// Returns true if the module supports it, even if \a scene is null.
+  /// By default, node classes are only registered by the logic and false is
+  /// returned.
+  /// \sa isInitializationDeferred(), vtkMRMLAbstractLogic::RegisterNodes()
+  virtual bool registerNodes(vtkMRMLScene* scene);
+
 public slots:
 
   /// Set the current MRML scene to the module, it is propagated to the logic
@@ -20,13 +20,17 @@
 
 // Qt includes
 #include <QDir>
+#include <QElapsedTimer>
+#include <QTextStream>
 
 // SlicerQt includes
 #include "qSlicerCoreApplication.h"
 #include "qSlicerAbstractModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
+#include "qSlicerModuleDiscoveryCache.h"
 
 // STD includes
+#include <algorithm>
 #include <csignal>
 #include <typeinfo>
 
@@ -52,6 +56,21 @@ public:
   // the risk of creating a nullptr entry if the module is not registered.
   qSlicerModuleFactory* registeredModuleFactory(const QString& moduleName)const;
 
+  // Return the first file based factory that can register \a file.
+  // The discovery cache is used (and updated) if enabled.
+  qSlicerFileBasedModuleFactory* fileBasedFactory(const QFileInfo& file);
+
+  // Return a string identifying the registered file based factories. Cached
+  // directory content is discarded if the registered factories change.
+  QString fileBasedFactoriesSignature()const;
+
+  // Register the module of \a file with \a moduleFactory.
+  // Nothing is done if \a moduleFactory is nullptr.
+  void registerModule(const QFileInfo& file, qSlicerFileBasedModuleFactory* moduleFactory);
+
+  // Save module properties that do not require instantiation into the cache
+  void cacheModuleDescription(qSlicerAbstractCoreModule* module);
+
   QStringList SearchPaths;
   QStringList ExplicitModules;
   QStringList ModulesToIgnore;
@@ -59,6 +78,10 @@ public:
   QMap<qSlicerModuleFactory*, int> Factories;
   QMap<QString, qSlicerModuleFactory*> RegisteredModules;
   QMap<QString, QStringList> ModuleDependees;
+  QMap<QString, QFileInfo> ModuleFiles;
+  QMap<QString, QVariantMap> ModuleTimings;
+
+  QScopedPointer<qSlicerModuleDiscoveryCache> DiscoveryCache;
 
   bool Verbose;
 };
@@ -116,6 +139,77 @@ qSlicerAbstractModuleFactoryManagerPrivate
   return this->RegisteredModules[moduleName];
 }
 
+//-----------------------------------------------------------------------------
+qSlicerAbstractModuleFactoryManagerPrivate::qSlicerFileBasedModuleFactory*
+qSlicerAbstractModuleFactoryManagerPrivate::fileBasedFactory(const QFileInfo& file)
+{
+  QVector<qSlicerFileBasedModuleFactory*> factories = this->fileBasedFactories();
+  if (!this->DiscoveryCache.isNull())
+    {
+    QString cachedFactoryName = this->DiscoveryCache->value(file, "factory").toString();
+    if (!cachedFactoryName.isEmpty())
+      {
+      foreach(qSlicerFileBasedModuleFactory* factory, factories)
+        {
+        if (cachedFactoryName == typeid(*factory).name())
+          {
+          return factory;
+          }
+        }
+      }
+    }
+  foreach(qSlicerFileBasedModuleFactory* factory, factories)
+    {
+    if (this->Verbose)
+      {
+      qDebug() << " checking file: " << file.absoluteFilePath() << " as a " << typeid(*factory).name();
+      }
+    if (!factory->isValidFile(file))
+      {
+      continue;
+      }
+    if (this->Verbose)
+      {
+      qDebug() << " recognized file: " << file.absoluteFilePath() << " as a " << typeid(*factory).name();
+      }
+    if (!this->DiscoveryCache.isNull())
+      {
+      this->DiscoveryCache->setValue(file, "factory", QString(typeid(*factory).name()));
+      }
+    return factory;
+    }
+  return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerAbstractModuleFactoryManagerPrivate::fileBasedFactoriesSignature()const
+{
+  QStringList factoryNames;
+  foreach(qSlicerFileBasedModuleFactory* factory, this->fileBasedFactories())
+    {
+    factoryNames << QString("%1:%2").arg(typeid(*factory).name()).arg(this->Factories.value(factory));
+    }
+  factoryNames.sort();
+  return factoryNames.join(";");
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerAbstractModuleFactoryManagerPrivate::cacheModuleDescription(qSlicerAbstractCoreModule* module)
+{
+  if (this->DiscoveryCache.isNull() || !this->ModuleFiles.contains(module->name()))
+    {
+    return;
+    }
+  QFileInfo file = this->ModuleFiles.value(module->name());
+  this->DiscoveryCache->setValue(file, "name", module->name());
+  this->DiscoveryCache->setValue(file, "title", module->title());
+  this->DiscoveryCache->setValue(file, "categories", module->categories());
+  this->DiscoveryCache->setValue(file, "index", module->index());
+  this->DiscoveryCache->setValue(file, "hidden", module->isHidden());
+  this->DiscoveryCache->setValue(file, "dependencies", module->dependencies());
+  this->DiscoveryCache->setValue(file, "associatedNodeTypes", module->associatedNodeTypes());
+}
+
 //-----------------------------------------------------------------------------
 QVector<qSlicerAbstractModuleFactoryManagerPrivate::qSlicerModuleFactory*>
 qSlicerAbstractModuleFactoryManagerPrivate
@@ -250,6 +344,10 @@ QStringList qSlicerAbstractModuleFactoryManager::ignoredModuleNames()const
 void qSlicerAbstractModuleFactoryManager::registerModules()
 {
   Q_D(qSlicerAbstractModuleFactoryManager);
+  if (!d->DiscoveryCache.isNull())
+    {
+    d->DiscoveryCache->load();
+    }
   // Register "regular" factories first
   // \todo: don't support factories other than filebased factories
   foreach(qSlicerModuleFactory* factory, d->notFileBasedFactories())
@@ -280,12 +378,46 @@ void qSlicerAbstractModuleFactoryManager::registerModules()
 //-----------------------------------------------------------------------------
 void qSlicerAbstractModuleFactoryManager::registerModules(const QString& path)
 {
+  Q_D(qSlicerAbstractModuleFactoryManager);
   QDir directory(path);
+  QFileInfo directoryInfo(directory.absolutePath());
+  QString factoriesSignature = d->fileBasedFactoriesSignature();
+
+  // The modification time of a directory changes when files are added,
+  // removed or renamed: if the directory was scanned with the same factories,
+  // only the files previously recognized as modules need to be considered.
+  if (!d->DiscoveryCache.isNull() &&
+      d->DiscoveryCache->value(directoryInfo, "factories").toString() == factoriesSignature)
+    {
+    if (d->Verbose)
+      {
+      qDebug() << " using cached content of directory: " << directoryInfo.absoluteFilePath();
+      }
+    foreach (const QString& fileName,
+             d->DiscoveryCache->value(directoryInfo, "moduleFiles").toStringList())
+      {
+      this->registerModule(QFileInfo(directory, fileName));
+      }
+    return;
+    }
+
+  QStringList moduleFileNames;
   /// \tbd recursive search ?
   foreach (const QFileInfo& file,
            directory.entryInfoList(QDir::Files))
     {
-    this->registerModule(file);
+    qSlicerFileBasedModuleFactory* moduleFactory = d->fileBasedFactory(file);
+    if (!moduleFactory)
+      {
+      continue;
+      }
+    moduleFileNames << file.fileName();
+    d->registerModule(file, moduleFactory);
+    }
+  if (!d->DiscoveryCache.isNull() && directoryInfo.exists())
+    {
+    d->DiscoveryCache->setValue(directoryInfo, "moduleFiles", moduleFileNames);
+    d->DiscoveryCache->setValue(directoryInfo, "factories", factoriesSignature);
     }
 }
 
@@ -293,25 +425,14 @@ void qSlicerAbstractModuleFactoryManager::registerModules(const QString& path)
 void qSlicerAbstractModuleFactoryManager::registerModule(const QFileInfo& file)
 {
   Q_D(qSlicerAbstractModuleFactoryManager);
+  d->registerModule(file, d->fileBasedFactory(file));
+}
 
-  qSlicerFileBasedModuleFactory* moduleFactory = nullptr;
-  foreach(qSlicerFileBasedModuleFactory* factory, d->fileBasedFactories())
-    {
-    if (d->Verbose)
-      {
-      qDebug() << " checking file: " << file.absoluteFilePath() << " as a " << typeid(*factory).name();
-      }
-    if (!factory->isValidFile(file))
-      {
-      continue;
-      }
-    if (d->Verbose)
-      {
-      qDebug() << " recognized file: " << file.absoluteFilePath() << " as a " << typeid(*factory).name();
-      }
-    moduleFactory = factory;
-    break;
-    }
+//-----------------------------------------------------------------------------
+void qSlicerAbstractModuleFactoryManagerPrivate::registerModule(
+  const QFileInfo& file, qSlicerFileBasedModuleFactory* moduleFactory)
+{
+  Q_Q(qSlicerAbstractModuleFactoryManager);
   // File not supported by any factory
   if (moduleFactory == nullptr)
     {
@@ -320,13 +441,13 @@ void qSlicerAbstractModuleFactoryManager::registerModule(const QFileInfo& file)
   QString moduleName = moduleFactory->itemKey(file);
   bool dontEmitSignal = false;
   // Has the module been already registered
-  qSlicerModuleFactory* existingModuleFactory = d->registeredModuleFactory(moduleName);
+  qSlicerModuleFactory* existingModuleFactory = this->registeredModuleFactory(moduleName);
   if (existingModuleFactory)
     {
-    if (d->Factories[existingModuleFactory] >=
-        d->Factories[moduleFactory])
+    if (this->Factories[existingModuleFactory] >=
+        this->Factories[moduleFactory])
       {
-      if (d->Verbose)
+      if (this->Verbose)
         {
         qDebug() << " file: " << file.absoluteFilePath() << " already registered";
         }
@@ -337,33 +458,37 @@ void qSlicerAbstractModuleFactoryManager::registerModule(const QFileInfo& file)
     //existingModuleFactory->unregisterItem(file);
     dontEmitSignal = true;
     }
-  if (d->ModulesToIgnore.contains(moduleName))
+  if (this->ModulesToIgnore.contains(moduleName))
     {
     //qDebug() << "Ignore module" << moduleName;
-    if (d->Verbose)
+    if (this->Verbose)
       {
       qDebug() << " file: " << file.absoluteFilePath() << " is in ignore list";
       }
-    d->IgnoredModules[moduleName] = file;
-    emit moduleIgnored(moduleName);
+    this->IgnoredModules[moduleName] = file;
+    emit q->moduleIgnored(moduleName);
     return;
     }
+  QElapsedTimer timer;
+  timer.start();
   QString registeredModuleName = moduleFactory->registerFileItem(file);
   if (registeredModuleName != moduleName)
     {
     //qDebug() << "Ignore module" << moduleName;
-    if (d->Verbose)
+    if (this->Verbose)
       {
       qDebug() << " file: " << file.absoluteFilePath() << " ignored because moduleName does not match registeredModuleName";
       }
-    d->IgnoredModules[moduleName] = file;
-    emit moduleIgnored(moduleName);
+    this->IgnoredModules[moduleName] = file;
+    emit q->moduleIgnored(moduleName);
     return;
     }
-  d->RegisteredModules[moduleName] = moduleFactory;
+  this->RegisteredModules[moduleName] = moduleFactory;
+  this->ModuleFiles[moduleName] = file;
+  q->recordModuleTiming(moduleName, "register", timer.elapsed());
   if (!dontEmitSignal)
     {
-    emit moduleRegistered(moduleName);
+    emit q->moduleRegistered(moduleName);
     }
 }
 
@@ -386,6 +511,13 @@ void qSlicerAbstractModuleFactoryManager::instantiateModules()
   signal(SIGINT, SIG_DFL);
   #endif
 
+  if (!d->DiscoveryCache.isNull())
+    {
+    // Forget about the modules and directories that have been removed
+    d->DiscoveryCache->removeMissingEntries();
+    d->DiscoveryCache->save();
+    }
+
   emit this->modulesInstantiated(this->instantiatedModuleNames());
 }
 
@@ -400,6 +532,8 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager
     qCritical() << "Fail to instantiate module " << moduleName << " (not registered)";
     return nullptr;
     }
+  QElapsedTimer timer;
+  timer.start();
   qSlicerAbstractCoreModule* module = factory->instantiate(moduleName);
   if (!module)
     {
@@ -420,6 +554,8 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager
       d->ModuleDependees.insert(dependency, dependees << moduleName);
       }
     }
+  d->cacheModuleDescription(module);
+  this->recordModuleTiming(moduleName, "instantiate", timer.elapsed());
   emit moduleInstantiated(moduleName);
   return module;
 }
@@ -518,6 +654,125 @@ void qSlicerAbstractModuleFactoryManager::setVerboseModuleDiscovery(bool verbose
   this->setIsVerbose(verbose);
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerAbstractModuleFactoryManager::setDiscoveryCacheFilePath(const QString& filePath)
+{
+  Q_D(qSlicerAbstractModuleFactoryManager);
+  if (filePath.isEmpty())
+    {
+    d->DiscoveryCache.reset();
+    return;
+    }
+  if (d->DiscoveryCache.isNull())
+    {
+    d->DiscoveryCache.reset(new qSlicerModuleDiscoveryCache);
+    }
+  d->DiscoveryCache->setFilePath(filePath);
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerAbstractModuleFactoryManager::discoveryCacheFilePath()const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  return d->DiscoveryCache.isNull() ? QString() : d->DiscoveryCache->filePath();
+}
+
+//-----------------------------------------------------------------------------
+qSlicerModuleDiscoveryCache* qSlicerAbstractModuleFactoryManager::discoveryCache()const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  return d->DiscoveryCache.data();
+}
+
+//-----------------------------------------------------------------------------
+QVariantMap qSlicerAbstractModuleFactoryManager::cachedModuleDescription(const QString& moduleName)const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  QVariantMap description;
+  if (d->DiscoveryCache.isNull() || !d->ModuleFiles.contains(moduleName))
+    {
+    return description;
+    }
+  QFileInfo file = d->ModuleFiles.value(moduleName);
+  // The description is only cached once the module has been instantiated
+  if (d->DiscoveryCache->value(file, "name").toString() != moduleName)
+    {
+    return description;
+    }
+  QStringList keys;
+  keys << "name" << "title" << "categories" << "index" << "hidden"
+       << "dependencies" << "associatedNodeTypes";
+  foreach(const QString& key, keys)
+    {
+    description[key] = d->DiscoveryCache->value(file, key);
+    }
+  return description;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerAbstractModuleFactoryManager::recordModuleTiming(
+  const QString& moduleName, const QString& stage, qint64 elapsedMs)
+{
+  Q_D(qSlicerAbstractModuleFactoryManager);
+  QVariantMap& timings = d->ModuleTimings[moduleName];
+  timings[stage] = timings.value(stage).toLongLong() + elapsedMs;
+}
+
+//-----------------------------------------------------------------------------
+QVariantMap qSlicerAbstractModuleFactoryManager::moduleTimings(const QString& moduleName)const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  return d->ModuleTimings.value(moduleName);
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerAbstractModuleFactoryManager::moduleTimingReport()const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  QStringList stages;
+  QList<QPair<qint64, QString> > totals;
+  foreach(const QString& moduleName, d->ModuleTimings.keys())
+    {
+    qint64 total = 0;
+    const QVariantMap& timings = d->ModuleTimings[moduleName];
+    foreach(const QString& stage, timings.keys())
+      {
+      total += timings[stage].toLongLong();
+      if (!stages.contains(stage))
+        {
+        stages << stage;
+        }
+      }
+    totals << qMakePair(total, moduleName);
+    }
+  std::sort(totals.begin(), totals.end(),
+            [](const QPair<qint64, QString>& a, const QPair<qint64, QString>& b)
+            { return a.first > b.first; });
+
+  QString report;
+  QTextStream stream(&report);
+  stream << qSetFieldWidth(40) << left << "Module" << qSetFieldWidth(12) << right;
+  foreach(const QString& stage, stages)
+    {
+    stream << stage;
+    }
+  stream << "total" << qSetFieldWidth(0) << "\n";
+  qint64 grandTotal = 0;
+  for (int i = 0; i < totals.count(); ++i)
+    {
+    const QVariantMap& timings = d->ModuleTimings[totals[i].second];
+    stream << qSetFieldWidth(40) << left << totals[i].second << qSetFieldWidth(12) << right;
+    foreach(const QString& stage, stages)
+      {
+      stream << timings.value(stage, 0).toLongLong();
+      }
+    stream << totals[i].first << qSetFieldWidth(0) << "\n";
+    grandTotal += totals[i].first;
+    }
+  stream << "Total: " << grandTotal << " ms (" << totals.count() << " modules)\n";
+  return report;
+}
+
 //---------------------------------------------------------------------------
 QStringList qSlicerAbstractModuleFactoryManager::dependentModules(const QString& dependency)const
 {
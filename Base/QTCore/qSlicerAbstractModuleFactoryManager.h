@@ -24,6 +24,7 @@
 // Qt includes
 #include <QObject>
 #include <QString>
+#include <QVariant>
 
 // CTK includes
 #include <ctkAbstractFileBasedFactory.h>
@@ -31,6 +32,7 @@
 #include "qSlicerBaseQTCoreExport.h"
 
 class qSlicerAbstractCoreModule;
+class qSlicerModuleDiscoveryCache;
 
 class qSlicerAbstractModuleFactoryManagerPrivate;
 
@@ -62,6 +64,14 @@ class qSlicerAbstractModuleFactoryManagerPrivate;
 /// The order of initialization is defined with the dependencies of the modules.
 /// If module B depends of module A, it is assured that module B is initialized/setup after A.
 ///   factoryManager->loadModules();
+///
+/// To speed up subsequent startups, a discovery cache file can be specified
+/// before registering the modules:
+///   factoryManager->setDiscoveryCacheFilePath(cacheDir + "/ModuleDiscoveryCache.bin");
+/// Directories whose content is unchanged are then not scanned again and the
+/// XML description of CLI executables is read from the cache instead of
+/// running the executables with "--xml".
+/// \sa qSlicerModuleDiscoveryCache
 class Q_SLICER_BASE_QTCORE_EXPORT qSlicerAbstractModuleFactoryManager : public QObject
 {
   Q_OBJECT
@@ -186,6 +196,36 @@ public:
   /// Enable/Disable verbose output during module discovery process
   void setVerboseModuleDiscovery(bool value);
 
+  /// Set the file used to persist the module discovery cache.
+  /// The cache is read by registerModules() and written by
+  /// instantiateModules(). An empty path (the default) disables the cache.
+  /// \sa discoveryCache()
+  void setDiscoveryCacheFilePath(const QString& filePath);
+  QString discoveryCacheFilePath()const;
+
+  /// Return the module discovery cache, nullptr if the cache is disabled.
+  /// Factories can use it to store information expensive to compute.
+  /// \sa setDiscoveryCacheFilePath()
+  qSlicerModuleDiscoveryCache* discoveryCache()const;
+
+  /// Return the description of the registered module \a moduleName as saved
+  /// in the discovery cache the last time the module was instantiated:
+  /// "name", "title", "categories", "index", "hidden", "dependencies" and
+  /// "associatedNodeTypes". It is available without instantiating the
+  /// module. An empty map is returned if the cache is disabled or has no
+  /// up-to-date description of the module file.
+  /// \sa discoveryCache()
+  Q_INVOKABLE QVariantMap cachedModuleDescription(const QString& moduleName)const;
+
+  /// Return the time in milliseconds spent in each startup stage
+  /// ("register", "instantiate", "load", ...) of module \a moduleName.
+  /// \sa moduleTimingReport()
+  Q_INVOKABLE QVariantMap moduleTimings(const QString& moduleName)const;
+
+  /// Return a human readable report of the time spent in each startup stage
+  /// for all the modules, sorted by decreasing total time.
+  Q_INVOKABLE QString moduleTimingReport()const;
+
   /// Return the list of modules that have \a module as a dependency.
   /// Note that the list can contain unloaded modules.
   /// \sa qSlicerAbstractCoreModule::dependencies(), moduleDependees()
@@ -233,6 +273,11 @@ protected:
   /// Uninstantiate a module given its \a moduleName
   virtual void uninstantiateModule(const QString& moduleName);
 
+  /// Add \a elapsedMs milliseconds to the time spent by \a moduleName in
+  /// the startup \a stage.
+  /// \sa moduleTimings()
+  void recordModuleTiming(const QString& moduleName, const QString& stage, qint64 elapsedMs);
+
 private:
   Q_DECLARE_PRIVATE(qSlicerAbstractModuleFactoryManager);
   Q_DISABLE_COPY(qSlicerAbstractModuleFactoryManager);
@@ -309,6 +309,13 @@ bool qSlicerCoreCommandOptions::verboseModuleDiscovery() const
   return d->ParsedArgs.value("verbose-module-discovery").toBool();
 }
 
+//-----------------------------------------------------------------------------
+bool qSlicerCoreCommandOptions::disableModuleDiscoveryCache() const
+{
+  Q_D(const qSlicerCoreCommandOptions);
+  return d->ParsedArgs.value("disable-module-discovery-cache").toBool();
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCoreCommandOptions::verbose()const
 {
@@ -458,6 +465,9 @@ void qSlicerCoreCommandOptions::addArguments()
   this->addArgument("verbose-module-discovery", "", QVariant::Bool,
                     "Enable verbose output during module discovery process.");
 
+  this->addArgument("disable-module-discovery-cache", "", QVariant::Bool,
+                    "Discover modules without using the cache of previously discovered modules.");
+
   this->addArgument("disable-settings", "", QVariant::Bool,
                     "Start application ignoring user settings and using new temporary settings.");
 
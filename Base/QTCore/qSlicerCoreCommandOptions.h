@@ -53,6 +53,7 @@ class Q_SLICER_BASE_QTCORE_EXPORT qSlicerCoreCommandOptions : public ctkCommandL
   Q_PROPERTY(bool displayTemporaryPathAndExit READ displayTemporaryPathAndExit CONSTANT)
   Q_PROPERTY(bool displayMessageAndExit READ displayMessageAndExit STORED false CONSTANT)
   Q_PROPERTY(bool verboseModuleDiscovery READ verboseModuleDiscovery CONSTANT)
+  Q_PROPERTY(bool disableModuleDiscoveryCache READ disableModuleDiscoveryCache CONSTANT)
   Q_PROPERTY(bool disableMessageHandlers READ disableMessageHandlers CONSTANT)
   Q_PROPERTY(bool testingEnabled READ isTestingEnabled CONSTANT)
 #ifdef Slicer_USE_PYTHONQT
@@ -157,6 +158,10 @@ public:
   /// Return True if slicer should display details regarding the module discovery process
   bool verboseModuleDiscovery()const;
 
+  /// Return True if modules should be discovered without reading or
+  /// updating the module discovery cache.
+  bool disableModuleDiscoveryCache()const;
+
   /// Return True if slicer should display information at startup
   bool verbose()const;
 
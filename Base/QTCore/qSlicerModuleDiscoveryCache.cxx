@@ -0,0 +1,310 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+
+// SlicerQt includes
+#include "qSlicerModuleDiscoveryCache.h"
+
+namespace
+{
+// Magic number and version written in the cache header. The version must be
+// incremented each time the layout of qSlicerModuleDiscoveryCacheEntry changes.
+const quint32 CacheMagicNumber = 0x534D4443; // "SMDC"
+const quint32 CacheVersion = 1;
+}
+
+//-----------------------------------------------------------------------------
+struct qSlicerModuleDiscoveryCacheEntry
+{
+  qSlicerModuleDiscoveryCacheEntry() : Size(-1), LastModified(0) {}
+  qint64 Size;
+  qint64 LastModified;
+  QVariantMap Values;
+};
+
+//-----------------------------------------------------------------------------
+QDataStream& operator<<(QDataStream& stream, const qSlicerModuleDiscoveryCacheEntry& entry)
+{
+  stream << entry.Size << entry.LastModified << entry.Values;
+  return stream;
+}
+
+//-----------------------------------------------------------------------------
+QDataStream& operator>>(QDataStream& stream, qSlicerModuleDiscoveryCacheEntry& entry)
+{
+  stream >> entry.Size >> entry.LastModified >> entry.Values;
+  return stream;
+}
+
+//-----------------------------------------------------------------------------
+class qSlicerModuleDiscoveryCachePrivate
+{
+public:
+  qSlicerModuleDiscoveryCachePrivate();
+
+  static QString key(const QFileInfo& file);
+  static qint64 lastModified(const QFileInfo& file);
+  bool isValid(const qSlicerModuleDiscoveryCacheEntry& entry, const QFileInfo& file)const;
+
+  QString FilePath;
+  QHash<QString, qSlicerModuleDiscoveryCacheEntry> Entries;
+  bool Modified;
+};
+
+//-----------------------------------------------------------------------------
+// qSlicerModuleDiscoveryCachePrivate methods
+
+//-----------------------------------------------------------------------------
+qSlicerModuleDiscoveryCachePrivate::qSlicerModuleDiscoveryCachePrivate()
+{
+  this->Modified = false;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerModuleDiscoveryCachePrivate::key(const QFileInfo& file)
+{
+  return QDir::cleanPath(file.absoluteFilePath());
+}
+
+//-----------------------------------------------------------------------------
+qint64 qSlicerModuleDiscoveryCachePrivate::lastModified(const QFileInfo& file)
+{
+  return file.lastModified().toMSecsSinceEpoch();
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerModuleDiscoveryCachePrivate::isValid(
+  const qSlicerModuleDiscoveryCacheEntry& entry, const QFileInfo& file)const
+{
+  // QFileInfo caches the file attributes, make sure they are up-to-date.
+  QFileInfo currentFile(file.absoluteFilePath());
+  if (!currentFile.exists())
+    {
+    return false;
+    }
+  return entry.Size == currentFile.size()
+    && entry.LastModified == qSlicerModuleDiscoveryCachePrivate::lastModified(currentFile);
+}
+
+//-----------------------------------------------------------------------------
+// qSlicerModuleDiscoveryCache methods
+
+//-----------------------------------------------------------------------------
+qSlicerModuleDiscoveryCache::qSlicerModuleDiscoveryCache()
+  : d_ptr(new qSlicerModuleDiscoveryCachePrivate)
+{
+}
+
+//-----------------------------------------------------------------------------
+qSlicerModuleDiscoveryCache::~qSlicerModuleDiscoveryCache() = default;
+
+//-----------------------------------------------------------------------------
+void qSlicerModuleDiscoveryCache::setFilePath(const QString& filePath)
+{
+  Q_D(qSlicerModuleDiscoveryCache);
+  d->FilePath = filePath;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerModuleDiscoveryCache::filePath()const
+{
+  Q_D(const qSlicerModuleDiscoveryCache);
+  return d->FilePath;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerModuleDiscoveryCache::load()
+{
+  Q_D(qSlicerModuleDiscoveryCache);
+  d->Entries.clear();
+  d->Modified = false;
+
+  QFile file(d->FilePath);
+  if (d->FilePath.isEmpty() || !file.open(QIODevice::ReadOnly))
+    {
+    return false;
+    }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_0);
+
+  quint32 magicNumber = 0;
+  quint32 version = 0;
+  stream >> magicNumber >> version;
+  if (magicNumber != CacheMagicNumber || version != CacheVersion)
+    {
+    return false;
+    }
+  QHash<QString, qSlicerModuleDiscoveryCacheEntry> entries;
+  stream >> entries;
+  if (stream.status() != QDataStream::Ok)
+    {
+    qWarning() << "Failed to read module discovery cache" << d->FilePath;
+    return false;
+    }
+  d->Entries = entries;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerModuleDiscoveryCache::save()
+{
+  Q_D(qSlicerModuleDiscoveryCache);
+  if (!d->Modified)
+    {
+    return true;
+    }
+  if (d->FilePath.isEmpty())
+    {
+    return false;
+    }
+  QDir().mkpath(QFileInfo(d->FilePath).absolutePath());
+
+  // Write into a temporary file first so that a concurrently starting
+  // application never reads a partially written cache.
+  QSaveFile file(d->FilePath);
+  if (!file.open(QIODevice::WriteOnly))
+    {
+    qWarning() << "Failed to write module discovery cache" << d->FilePath;
+    return false;
+    }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream << CacheMagicNumber << CacheVersion << d->Entries;
+  if (!file.commit())
+    {
+    qWarning() << "Failed to write module discovery cache" << d->FilePath;
+    return false;
+    }
+  d->Modified = false;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerModuleDiscoveryCache::clear()
+{
+  Q_D(qSlicerModuleDiscoveryCache);
+  if (d->Entries.isEmpty())
+    {
+    return;
+    }
+  d->Entries.clear();
+  d->Modified = true;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerModuleDiscoveryCache::isModified()const
+{
+  Q_D(const qSlicerModuleDiscoveryCache);
+  return d->Modified;
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerModuleDiscoveryCache::count()const
+{
+  Q_D(const qSlicerModuleDiscoveryCache);
+  return d->Entries.count();
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerModuleDiscoveryCache::contains(const QFileInfo& file)const
+{
+  Q_D(const qSlicerModuleDiscoveryCache);
+  QHash<QString, qSlicerModuleDiscoveryCacheEntry>::const_iterator it =
+    d->Entries.constFind(qSlicerModuleDiscoveryCachePrivate::key(file));
+  return it != d->Entries.constEnd() && d->isValid(it.value(), file);
+}
+
+//-----------------------------------------------------------------------------
+QVariant qSlicerModuleDiscoveryCache::value(const QFileInfo& file, const QString& key,
+                                            const QVariant& defaultValue)const
+{
+  Q_D(const qSlicerModuleDiscoveryCache);
+  QHash<QString, qSlicerModuleDiscoveryCacheEntry>::const_iterator it =
+    d->Entries.constFind(qSlicerModuleDiscoveryCachePrivate::key(file));
+  if (it == d->Entries.constEnd() || !d->isValid(it.value(), file))
+    {
+    return defaultValue;
+    }
+  return it.value().Values.value(key, defaultValue);
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerModuleDiscoveryCache::setValue(const QFileInfo& file, const QString& key,
+                                           const QVariant& value)
+{
+  Q_D(qSlicerModuleDiscoveryCache);
+  QFileInfo currentFile(file.absoluteFilePath());
+  if (!currentFile.exists())
+    {
+    return;
+    }
+  qSlicerModuleDiscoveryCacheEntry& entry =
+    d->Entries[qSlicerModuleDiscoveryCachePrivate::key(currentFile)];
+  if (!d->isValid(entry, currentFile))
+    {
+    entry.Size = currentFile.size();
+    entry.LastModified = qSlicerModuleDiscoveryCachePrivate::lastModified(currentFile);
+    entry.Values.clear();
+    }
+  else if (entry.Values.value(key) == value)
+    {
+    return;
+    }
+  entry.Values.insert(key, value);
+  d->Modified = true;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerModuleDiscoveryCache::remove(const QFileInfo& file)
+{
+  Q_D(qSlicerModuleDiscoveryCache);
+  if (d->Entries.remove(qSlicerModuleDiscoveryCachePrivate::key(file)) > 0)
+    {
+    d->Modified = true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerModuleDiscoveryCache::removeMissingEntries()
+{
+  Q_D(qSlicerModuleDiscoveryCache);
+  int removedCount = 0;
+  QHash<QString, qSlicerModuleDiscoveryCacheEntry>::iterator it = d->Entries.begin();
+  while (it != d->Entries.end())
+    {
+    if (QFileInfo::exists(it.key()))
+      {
+      ++it;
+      continue;
+      }
+    it = d->Entries.erase(it);
+    ++removedCount;
+    }
+  if (removedCount > 0)
+    {
+    d->Modified = true;
+    }
+  return removedCount;
+}
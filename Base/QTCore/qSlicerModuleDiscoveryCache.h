@@ -0,0 +1,100 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qSlicerModuleDiscoveryCache_h
+#define __qSlicerModuleDiscoveryCache_h
+
+// Qt includes
+#include <QFileInfo>
+#include <QScopedPointer>
+#include <QStringList>
+#include <QVariant>
+
+#include "qSlicerBaseQTCoreExport.h"
+
+class qSlicerModuleDiscoveryCachePrivate;
+
+/// \brief On-disk cache of the information gathered during module discovery.
+///
+/// Each entry is keyed on the absolute path of a file (or directory) and is
+/// only considered valid as long as the size and the last modification time
+/// of that path are unchanged. Any number of named values can be associated
+/// with an entry (e.g. the factory that recognized a module file, the module
+/// dependencies or the XML description of a CLI executable).
+///
+/// The cache is loaded from and saved to filePath() using a versioned binary
+/// format. An incompatible or corrupted file is silently discarded.
+///
+/// \sa qSlicerAbstractModuleFactoryManager::setDiscoveryCache()
+class Q_SLICER_BASE_QTCORE_EXPORT qSlicerModuleDiscoveryCache
+{
+public:
+  qSlicerModuleDiscoveryCache();
+  virtual ~qSlicerModuleDiscoveryCache();
+
+  /// Set/Get the file where the cache is persisted.
+  void setFilePath(const QString& filePath);
+  QString filePath()const;
+
+  /// Read the cache from filePath(). Existing entries are discarded.
+  /// Return false if the file does not exist or is not a valid cache.
+  bool load();
+
+  /// Write the cache to filePath() if it has been modified since the
+  /// last call to load() or save().
+  /// Return false if the file could not be written.
+  bool save();
+
+  /// Remove all the entries.
+  void clear();
+
+  /// Return true if the cache has entries that are not saved yet.
+  bool isModified()const;
+
+  /// Return the number of entries (valid or stale).
+  int count()const;
+
+  /// Return true if \a file has an entry whose size and modification time
+  /// match the file on disk.
+  bool contains(const QFileInfo& file)const;
+
+  /// Return the value associated with \a key for \a file.
+  /// \a defaultValue is returned if there is no valid entry for \a file or
+  /// if the entry has no such key.
+  QVariant value(const QFileInfo& file, const QString& key,
+                 const QVariant& defaultValue = QVariant())const;
+
+  /// Associate \a value with \a key for \a file. If the existing entry
+  /// of \a file is stale, all its values are discarded first.
+  void setValue(const QFileInfo& file, const QString& key, const QVariant& value);
+
+  /// Remove the entry associated with \a file.
+  void remove(const QFileInfo& file);
+
+  /// Remove the entries of the files and directories that no longer exist.
+  /// Return the number of removed entries.
+  int removeMissingEntries();
+
+protected:
+  QScopedPointer<qSlicerModuleDiscoveryCachePrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qSlicerModuleDiscoveryCache);
+  Q_DISABLE_COPY(qSlicerModuleDiscoveryCache);
+};
+
+#endif
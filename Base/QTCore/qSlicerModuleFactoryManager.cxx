@@ -18,12 +18,26 @@
 
 ==============================================================================*/
 
+// Qt includes
+#include <QElapsedTimer>
+#include <QFileInfo>
+
 // SlicerQt includes
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
+#include "qSlicerCoreApplication.h"
+#include "qSlicerCoreIOManager.h"
+#include "qSlicerModuleDiscoveryCache.h"
 
 #include "vtkSlicerConfigure.h" // XXX For modulePaths() function.
 
+// MRMLDisplayableManager includes
+#include <vtkMRMLSliceViewDisplayableManagerFactory.h>
+#include <vtkMRMLThreeDViewDisplayableManagerFactory.h>
+
+// MRML includes
+#include <vtkMRMLScene.h>
+
 // STD includes
 #include <algorithm>
 
@@ -36,7 +50,20 @@ protected:
 public:
   qSlicerModuleFactoryManagerPrivate(qSlicerModuleFactoryManager& object);
 
+  /// Return the number of file readers and writers registered in the
+  /// application IO manager.
+  int registeredIOCount()const;
+
+  /// Return the number of displayable managers registered in the slice and
+  /// 3D view factories.
+  int registeredDisplayableManagerCount()const;
+
+  /// Return the number of node classes registered in the scene.
+  int registeredNodeClassCount()const;
+
   QStringList LoadedModules;
+  QStringList ModulesToSetupAtStartup;
+  bool LazyModuleSetup;
   vtkSlicerApplicationLogic* AppLogic;
   vtkMRMLScene* MRMLScene;
 };
@@ -47,10 +74,35 @@ qSlicerModuleFactoryManagerPrivate
 ::qSlicerModuleFactoryManagerPrivate(qSlicerModuleFactoryManager& object)
   : q_ptr(&object)
 {
+  this->LazyModuleSetup = false;
   this->AppLogic = nullptr;
   this->MRMLScene = nullptr;
 }
 
+//-----------------------------------------------------------------------------
+int qSlicerModuleFactoryManagerPrivate::registeredIOCount()const
+{
+  qSlicerCoreApplication* app = qSlicerCoreApplication::application();
+  if (!app || !app->coreIOManager())
+    {
+    return 0;
+    }
+  return app->coreIOManager()->readers().count() + app->coreIOManager()->writers().count();
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerModuleFactoryManagerPrivate::registeredDisplayableManagerCount()const
+{
+  return vtkMRMLSliceViewDisplayableManagerFactory::GetInstance()->GetRegisteredDisplayableManagerCount()
+    + vtkMRMLThreeDViewDisplayableManagerFactory::GetInstance()->GetRegisteredDisplayableManagerCount();
+}
+
+//-----------------------------------------------------------------------------
+int qSlicerModuleFactoryManagerPrivate::registeredNodeClassCount()const
+{
+  return this->MRMLScene ? this->MRMLScene->GetNumberOfRegisteredNodeClasses() : 0;
+}
+
 //-----------------------------------------------------------------------------
 // qSlicerModuleFactoryManager methods
 
@@ -81,6 +133,10 @@ int qSlicerModuleFactoryManager::loadModules()
     {
     this->loadModule(name);
     }
+  if (this->discoveryCache())
+    {
+    this->discoveryCache()->save();
+    }
   emit this->modulesLoaded(this->loadedModuleNames());
   return this->loadedModuleNames().count();
 }
@@ -168,8 +224,30 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
   // Update internal Map
   d->LoadedModules << name;
 
-  // Initialize module
-  instance->initialize(d->AppLogic);
+  // Initialize module, unless its setup can be deferred until the module
+  // is selected or required by another module. The logic of a deferred
+  // module is only created when the module is set up: a module whose logic
+  // registers MRML node classes can only be deferred if it can register
+  // them without its logic.
+  bool deferSetup = d->LazyModuleSetup && !this->isSetupRequiredAtLoad(name);
+  if (deferSetup && this->registersNodes(name) && !instance->registerNodes(d->MRMLScene))
+    {
+    deferSetup = false;
+    }
+  if (deferSetup)
+    {
+    instance->setAppLogic(d->AppLogic);
+    instance->setInitializationDeferred(true);
+    }
+  else
+    {
+    this->setupModule(name);
+    }
+
+  // Time spent loading the dependencies and setting up the module is
+  // accounted separately
+  QElapsedTimer timer;
+  timer.start();
 
   // Check the module has a title (required)
   if (instance->title().isEmpty())
@@ -186,12 +264,158 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
   this->connect(this,SIGNAL(mrmlSceneChanged(vtkMRMLScene*)),
                 instance, SLOT(setMRMLScene(vtkMRMLScene*)));
 
+  this->recordModuleTiming(name, "load", timer.elapsed());
+
   // Handle post-load initialization
   emit this->moduleLoaded(name);
 
   return true;
 }
 
+//---------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::setupModule(const QString& name)
+{
+  Q_D(qSlicerModuleFactoryManager);
+  if (!this->isLoaded(name))
+    {
+    return false;
+    }
+  qSlicerAbstractCoreModule* instance = this->moduleInstance(name);
+  if (!instance)
+    {
+    return false;
+    }
+  if (instance->initialized())
+    {
+    return true;
+    }
+
+  // Dependencies are loaded before the module, they must also be set up before.
+  foreach(const QString& dependency, instance->dependencies())
+    {
+    this->setupModule(dependency);
+    }
+
+  if (this->Superclass::isVerbose())
+    {
+    qDebug() << "Setting up module" << name;
+    }
+
+  QElapsedTimer timer;
+  timer.start();
+  int ioCount = d->registeredIOCount();
+  int displayableManagerCount = d->registeredDisplayableManagerCount();
+  int nodeClassCount = d->registeredNodeClassCount();
+
+  instance->initialize(d->AppLogic);
+
+  this->recordModuleTiming(name, "setup", timer.elapsed());
+
+  // Remember if the module registers readers, writers or displayable
+  // managers so that its setup is not deferred at the next startup, and if
+  // its logic registers node classes.
+  qSlicerModuleDiscoveryCache* cache = this->discoveryCache();
+  if (cache && !instance->path().isEmpty())
+    {
+    cache->setValue(QFileInfo(instance->path()), "registersIO", d->registeredIOCount() != ioCount);
+    cache->setValue(QFileInfo(instance->path()), "registersDisplayableManagers",
+                    d->registeredDisplayableManagerCount() != displayableManagerCount);
+    // The logic may have been created before the setup, in which case its
+    // node classes are already registered: a known registration is kept.
+    if (d->MRMLScene)
+      {
+      bool registersNodes = d->registeredNodeClassCount() != nodeClassCount
+        || cache->value(QFileInfo(instance->path()), "registersNodes", false).toBool();
+      cache->setValue(QFileInfo(instance->path()), "registersNodes", registersNodes);
+      }
+    }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::isSetup(const QString& name)const
+{
+  qSlicerAbstractCoreModule* instance = this->moduleInstance(name);
+  return this->isLoaded(name) && instance && instance->initialized();
+}
+
+//---------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::isSetupRequiredAtLoad(const QString& name)const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  if (d->ModulesToSetupAtStartup.contains(name))
+    {
+    return true;
+    }
+  qSlicerAbstractCoreModule* instance = this->moduleInstance(name);
+  if (!instance)
+    {
+    return true;
+    }
+  // Subject hierarchy plugins are registered in the setup of the modules
+  // depending on the SubjectHierarchy module, they must be available as soon
+  // as nodes are added to the scene.
+  if (instance->dependencies().contains("SubjectHierarchy"))
+    {
+    return true;
+    }
+  // Modules that were never set up may register IO plugins or the
+  // displayable managers needed to show their nodes.
+  qSlicerModuleDiscoveryCache* cache = this->discoveryCache();
+  if (!cache || instance->path().isEmpty())
+    {
+    return true;
+    }
+  QFileInfo moduleFile(instance->path());
+  return cache->value(moduleFile, "registersIO", true).toBool()
+    || cache->value(moduleFile, "registersDisplayableManagers", true).toBool();
+}
+
+//---------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::registersNodes(const QString& name)const
+{
+  qSlicerAbstractCoreModule* instance = this->moduleInstance(name);
+  if (!instance)
+    {
+    return true;
+    }
+  // Modules that were never set up may register node classes in their logic
+  qSlicerModuleDiscoveryCache* cache = this->discoveryCache();
+  if (!cache || instance->path().isEmpty())
+    {
+    return true;
+    }
+  return cache->value(QFileInfo(instance->path()), "registersNodes", true).toBool();
+}
+
+//---------------------------------------------------------------------------
+void qSlicerModuleFactoryManager::setLazyModuleSetup(bool lazy)
+{
+  Q_D(qSlicerModuleFactoryManager);
+  d->LazyModuleSetup = lazy;
+}
+
+//---------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::lazyModuleSetup()const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->LazyModuleSetup;
+}
+
+//---------------------------------------------------------------------------
+void qSlicerModuleFactoryManager::setModulesToSetupAtStartup(const QStringList& moduleNames)
+{
+  Q_D(qSlicerModuleFactoryManager);
+  d->ModulesToSetupAtStartup = moduleNames;
+}
+
+//---------------------------------------------------------------------------
+QStringList qSlicerModuleFactoryManager::modulesToSetupAtStartup()const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->ModulesToSetupAtStartup;
+}
+
 //---------------------------------------------------------------------------
 bool qSlicerModuleFactoryManager::isLoaded(const QString& name)const
 {
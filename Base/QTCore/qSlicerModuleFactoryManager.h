@@ -38,6 +38,25 @@ class Q_SLICER_BASE_QTCORE_EXPORT qSlicerModuleFactoryManager
   : public qSlicerAbstractModuleFactoryManager
 {
   Q_OBJECT
+  /// This property controls if loading a module also sets it up.
+  /// When enabled, loaded modules are connected to the scene and register
+  /// their MRML node classes, but their logic and widget representation are
+  /// not created and qSlicerAbstractCoreModule::setup() is not called until
+  /// the module is selected for the first time, or until setupModule() is
+  /// called (e.g. by a module that depends on it).
+  /// Modules listed in \a modulesToSetupAtStartup and modules that are
+  /// known (from the discovery cache) or suspected to register file readers,
+  /// file writers, displayable managers or subject hierarchy plugins are
+  /// always set up at load time. So are the modules whose logic registers
+  /// node classes, unless they implement
+  /// qSlicerAbstractCoreModule::registerNodes().
+  /// Disabled by default.
+  /// \sa setupModule(), modulesToSetupAtStartup
+  Q_PROPERTY(bool lazyModuleSetup READ lazyModuleSetup WRITE setLazyModuleSetup)
+
+  /// List of modules that are set up at load time even if
+  /// \a lazyModuleSetup is enabled.
+  Q_PROPERTY(QStringList modulesToSetupAtStartup READ modulesToSetupAtStartup WRITE setModulesToSetupAtStartup)
 public:
   typedef qSlicerAbstractModuleFactoryManager Superclass;
   qSlicerModuleFactoryManager(QObject* newParent = nullptr);
@@ -91,6 +110,22 @@ public:
   /// Return all module paths that are direct child of \a basePath.
   QStringList modulePaths(const QString& basePath);
 
+  void setLazyModuleSetup(bool lazy);
+  bool lazyModuleSetup()const;
+
+  void setModulesToSetupAtStartup(const QStringList& moduleNames);
+  QStringList modulesToSetupAtStartup()const;
+
+  /// Set up the loaded module identified by \a name if not already done:
+  /// the modules it depends on are set up first, then its logic is created
+  /// and qSlicerAbstractCoreModule::setup() is called.
+  /// Return false if the module is not loaded.
+  /// \sa lazyModuleSetup
+  Q_INVOKABLE bool setupModule(const QString& name);
+
+  /// Return true if the module identified by \a name has been set up.
+  Q_INVOKABLE bool isSetup(const QString& name)const;
+
 public slots:
   /// Set the MRML scene to pass to modules at "load" time.
   void setMRMLScene(vtkMRMLScene* mrmlScene);
@@ -112,6 +147,16 @@ protected:
 
   bool loadModule(const QString& name, const QString& dependee);
 
+  /// Return true if the setup of the loaded module \a name can not be
+  /// deferred when \a lazyModuleSetup is enabled.
+  virtual bool isSetupRequiredAtLoad(const QString& name)const;
+
+  /// Return true if the logic of the module \a name may register MRML node
+  /// classes. The module must then register them without its logic for its
+  /// setup to be deferred.
+  /// \sa qSlicerAbstractCoreModule::registerNodes()
+  virtual bool registersNodes(const QString& name)const;
+
   /// Unload module identified by \a name
   void unloadModule(const QString& name);
 
@@ -0,0 +1,125 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkCacheManager.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+namespace
+{
+//----------------------------------------------------------------------------
+bool WriteFile(const std::string& fileName, size_t size)
+{
+  vtksys::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  std::string content(size, 'x');
+  file << content;
+  return file.good();
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkCacheManagerTest1(int argc, char * argv[] )
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string cacheDirectory = std::string(argv[1]) + "/vtkCacheManagerTest1";
+  vtksys::SystemTools::RemoveADirectory(cacheDirectory);
+
+  {
+    vtkNew<vtkCacheManager> cacheManager;
+    EXERCISE_BASIC_OBJECT_METHODS(cacheManager.GetPointer());
+    cacheManager->SetRemoteCacheDirectory(cacheDirectory.c_str());
+    cacheManager->SetRemoteCacheLimit(1);
+    cacheManager->SetRemoteCacheFreeBufferSize(0);
+    CHECK_INT(cacheManager->GetNumberOfCacheIndexEntries(), 0);
+
+    // Files are downloaded in order, then the first one is accessed again
+    vtksys::SystemTools::MakeDirectory(cacheDirectory + "/Study");
+    const char* fileNames[4] = {"file1.nrrd", "file2.nrrd", "Study/file3.nrrd", "file4.nrrd"};
+    for (int i = 0; i < 4; ++i)
+      {
+      std::string fileName = cacheDirectory + "/" + fileNames[i];
+      CHECK_BOOL(WriteFile(fileName, 300000), true);
+      cacheManager->AddToCacheIndex(fileName.c_str());
+      }
+    // files outside of the cache are ignored
+    cacheManager->AddToCacheIndex((std::string(argv[1]) + "/outside.nrrd").c_str());
+    CHECK_INT(cacheManager->GetNumberOfCacheIndexEntries(), 4);
+    CHECK_DOUBLE(cacheManager->GetCurrentCacheSize(), 1.2f);
+    CHECK_BOOL(cacheManager->CachedFileExists("file1.nrrd") != 0, true);
+
+    // Least recently used file is evicted
+    CHECK_INT(cacheManager->EnforceCacheLimit(), 1);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(cacheDirectory + "/file1.nrrd"), true);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(cacheDirectory + "/file2.nrrd"), false);
+    CHECK_INT(cacheManager->GetNumberOfCacheIndexEntries(), 3);
+    CHECK_DOUBLE(cacheManager->GetCurrentCacheSize(), 0.9f);
+    CHECK_INT(static_cast<int>(cacheManager->GetCachedFiles().size()), 3);
+
+    // Disabled eviction keeps files
+    cacheManager->SetRemoteCacheLimit(0);
+    cacheManager->EnableLRUEvictionOff();
+    CHECK_INT(cacheManager->EnforceCacheLimit(), 0);
+    cacheManager->SetRemoteCacheLimit(1);
+
+    CHECK_INT(cacheManager->SaveCacheIndex(), 1);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(cacheManager->GetCacheIndexFileName(), true), true);
+  }
+
+  // Index is loaded from disk, access times are preserved
+  {
+    vtkNew<vtkMRMLScene> scene;
+    vtkNew<vtkCacheManager> cacheManager;
+    cacheManager->SetMRMLScene(scene.GetPointer());
+    cacheManager->SetRemoteCacheDirectory(cacheDirectory.c_str());
+    cacheManager->SetRemoteCacheLimit(1);
+    cacheManager->SetRemoteCacheFreeBufferSize(0);
+    CHECK_INT(cacheManager->GetNumberOfCacheIndexEntries(), 3);
+    CHECK_DOUBLE(cacheManager->GetCurrentCacheSize(), 0.9f);
+
+    std::string fileName = cacheDirectory + "/file5.nrrd";
+    CHECK_BOOL(WriteFile(fileName, 300000), true);
+    cacheManager->AddToCacheIndex(fileName.c_str());
+    CHECK_INT(cacheManager->EvictLeastRecentlyUsedFiles(0.6f), 2);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(cacheDirectory + "/Study/file3.nrrd"), false);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(cacheDirectory + "/file4.nrrd"), false);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(cacheDirectory + "/file1.nrrd"), true);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(fileName), true);
+
+    // Removing a directory removes all its files from the index
+    std::string studyFileName = cacheDirectory + "/Study/file6.nrrd";
+    CHECK_BOOL(WriteFile(studyFileName, 1000), true);
+    cacheManager->AddToCacheIndex((cacheDirectory + "/Study").c_str());
+    CHECK_INT(cacheManager->GetNumberOfCacheIndexEntries(), 3);
+    cacheManager->RemoveFromCacheIndex((cacheDirectory + "/Study").c_str());
+    CHECK_INT(cacheManager->GetNumberOfCacheIndexEntries(), 2);
+
+    // Full scan finds all the files
+    cacheManager->RebuildCacheIndex();
+    CHECK_INT(cacheManager->GetNumberOfCacheIndexEntries(), 3);
+
+    CHECK_INT(cacheManager->ClearCache(), 1);
+    CHECK_INT(cacheManager->GetNumberOfCacheIndexEntries(), 0);
+    CHECK_INT(cacheManager->ClearCacheCheck(), 1);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLChunkedVolumeStorageNode.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// vtkAddon includes
+#include <vtkChunkedImageReader.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+short VoxelValue(int i, int j, int k)
+{
+  return static_cast<short>(i + 100 * j + 1000 * k);
+}
+
+//---------------------------------------------------------------------------
+int CheckVoxels(vtkImageData* image, const int offset[3])
+{
+  int* extent = image->GetExtent();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        short value = *static_cast<short*>(image->GetScalarPointer(i, j, k));
+        CHECK_INT(value, VoxelValue(i + offset[0], j + offset[1], k + offset[2]));
+        }
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestReadWrite(vtkMRMLScene* scene, bool useCompression)
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(20, 15, 10);
+  image->AllocateScalars(VTK_SHORT, 1);
+  for (int k = 0; k < 10; ++k)
+    {
+    for (int j = 0; j < 15; ++j)
+      {
+      for (int i = 0; i < 20; ++i)
+        {
+        *static_cast<short*>(image->GetScalarPointer(i, j, k)) = VoxelValue(i, j, k);
+        }
+      }
+    }
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(image.GetPointer());
+  volumeNode->SetOrigin(10.0, 20.0, 30.0);
+  volumeNode->SetSpacing(0.5, 1.0, 2.0);
+  volumeNode->SetAttribute("Description", "chunked test\nsecond line");
+  scene->AddNode(volumeNode.GetPointer());
+
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLChunkedVolumeStorageNodeTest1.cvol";
+  vtkNew<vtkMRMLChunkedVolumeStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetUseCompression(useCompression);
+  // Chunk size is chosen so that chunks are clipped at the image boundary
+  storageNode->SetChunkSize(8, 8, 4);
+  CHECK_BOOL(storageNode->WriteData(volumeNode.GetPointer()), true);
+
+  // Chunk information is available in the file
+  vtkNew<vtkChunkedImageReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->UpdateInformation();
+  CHECK_INT(reader->GetChunkSize()[0], 8);
+  CHECK_INT(reader->GetChunkSize()[2], 4);
+  reader->Update();
+  CHECK_INT(reader->GetNumberOfChunksRead(), 3 * 2 * 3);
+
+  // Read whole volume
+  vtkNew<vtkMRMLScalarVolumeNode> readVolumeNode;
+  scene->AddNode(readVolumeNode.GetPointer());
+  CHECK_BOOL(storageNode->ReadData(readVolumeNode.GetPointer()), true);
+  int* dimensions = readVolumeNode->GetImageData()->GetDimensions();
+  CHECK_INT(dimensions[0], 20);
+  CHECK_INT(dimensions[1], 15);
+  CHECK_INT(dimensions[2], 10);
+  int noOffset[3] = { 0, 0, 0 };
+  CHECK_EXIT_SUCCESS(CheckVoxels(readVolumeNode->GetImageData(), noOffset));
+  CHECK_DOUBLE_TOLERANCE(readVolumeNode->GetOrigin()[0], 10.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(readVolumeNode->GetSpacing()[2], 2.0, 1e-6);
+  CHECK_STRING(readVolumeNode->GetAttribute("Description"), "chunked test\nsecond line");
+
+  // Read region, only intersecting chunks are decompressed
+  vtkNew<vtkMRMLScalarVolumeNode> regionVolumeNode;
+  scene->AddNode(regionVolumeNode.GetPointer());
+  storageNode->SetReadExtent(5, 12, 3, 9, 2, 5);
+  CHECK_BOOL(storageNode->ReadData(regionVolumeNode.GetPointer()), true);
+  dimensions = regionVolumeNode->GetImageData()->GetDimensions();
+  CHECK_INT(dimensions[0], 8);
+  CHECK_INT(dimensions[1], 7);
+  CHECK_INT(dimensions[2], 4);
+  int regionOffset[3] = { 5, 3, 2 };
+  CHECK_EXIT_SUCCESS(CheckVoxels(regionVolumeNode->GetImageData(), regionOffset));
+  CHECK_DOUBLE_TOLERANCE(regionVolumeNode->GetOrigin()[0], 10.0 + 5 * 0.5, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(regionVolumeNode->GetOrigin()[1], 20.0 + 3 * 1.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(regionVolumeNode->GetOrigin()[2], 30.0 + 2 * 2.0, 1e-6);
+
+  // Region outside of the volume
+  storageNode->SetReadExtent(30, 40, 0, 1, 0, 1);
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(storageNode->ReadData(regionVolumeNode.GetPointer()), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  scene->Clear(1);
+  return EXIT_SUCCESS;
+}
+
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLChunkedVolumeStorageNodeTest1(int argc, char * argv[] )
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkMRMLChunkedVolumeStorageNode> node1;
+  EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetRootDirectory(argv[1]);
+
+  CHECK_EXIT_SUCCESS(TestReadWrite(scene.GetPointer(), true));
+  CHECK_EXIT_SUCCESS(TestReadWrite(scene.GetPointer(), false));
+
+  return EXIT_SUCCESS;
+}
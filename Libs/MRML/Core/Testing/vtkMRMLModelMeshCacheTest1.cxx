@@ -0,0 +1,177 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkCacheManager.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelMeshCache.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
+#include "vtkMRMLScene.h"
+
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+#include <vtksys/SystemTools.hxx>
+
+//---------------------------------------------------------------------------
+int TestReadWriteMesh(const std::string& tempDir, bool memoryMapping);
+int TestStorageNode(const std::string& tempDir);
+
+//---------------------------------------------------------------------------
+int vtkMRMLModelMeshCacheTest1(int argc, char * argv[] )
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = std::string(argv[1]) + "/vtkMRMLModelMeshCacheTest1";
+  vtksys::SystemTools::RemoveADirectory(tempDir);
+  vtksys::SystemTools::MakeDirectory(tempDir);
+
+  vtkNew<vtkMRMLModelMeshCache> meshCache;
+  EXERCISE_BASIC_OBJECT_METHODS(meshCache.GetPointer());
+
+  CHECK_EXIT_SUCCESS(TestReadWriteMesh(tempDir, true));
+  CHECK_EXIT_SUCCESS(TestReadWriteMesh(tempDir, false));
+  CHECK_EXIT_SUCCESS(TestStorageNode(tempDir));
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestReadWriteMesh(const std::string& tempDir, bool memoryMapping)
+{
+  std::string sourceFileName = tempDir + "/source.stl";
+  {
+    vtksys::ofstream sourceFile(sourceFileName.c_str());
+    sourceFile << "solid source\nendsolid source\n";
+  }
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->Update();
+  vtkNew<vtkPolyData> mesh;
+  mesh->DeepCopy(sphere->GetOutput());
+  vtkNew<vtkFloatArray> cellScalars;
+  cellScalars->SetName("CellScalars");
+  cellScalars->SetNumberOfTuples(mesh->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < mesh->GetNumberOfCells(); ++cellId)
+    {
+    cellScalars->SetValue(cellId, static_cast<float>(cellId));
+    }
+  mesh->GetCellData()->SetScalars(cellScalars.GetPointer());
+  CHECK_BOOL(vtkMRMLModelMeshCache::CanCacheMesh(mesh.GetPointer()), true);
+
+  vtkNew<vtkMRMLModelMeshCache> meshCache;
+  meshCache->SetCacheDirectory(tempDir + "/Cache");
+  meshCache->SetMemoryMapping(memoryMapping);
+  meshCache->ClearCache();
+
+  // Nothing is cached yet
+  vtkNew<vtkPolyData> output;
+  CHECK_BOOL(meshCache->ReadMesh(sourceFileName, output.GetPointer()), false);
+
+  CHECK_BOOL(meshCache->WriteMesh(sourceFileName, mesh.GetPointer()), true);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(meshCache->GetCacheFilePath(sourceFileName), true), true);
+  CHECK_BOOL(meshCache->ReadMesh(sourceFileName, output.GetPointer()), true);
+
+  CHECK_INT(output->GetNumberOfPoints(), mesh->GetNumberOfPoints());
+  CHECK_INT(output->GetNumberOfPolys(), mesh->GetNumberOfPolys());
+  CHECK_NOT_NULL(output->GetPointData()->GetNormals());
+  CHECK_NOT_NULL(output->GetCellData()->GetScalars());
+  CHECK_STRING(output->GetCellData()->GetScalars()->GetName(), "CellScalars");
+  for (vtkIdType pointId = 0; pointId < mesh->GetNumberOfPoints(); ++pointId)
+    {
+    double* expected = mesh->GetPoint(pointId);
+    double* actual = output->GetPoint(pointId);
+    for (int i = 0; i < 3; ++i)
+      {
+      CHECK_DOUBLE(actual[i], expected[i]);
+      }
+    }
+  vtkIdType lastCellId = mesh->GetNumberOfCells() - 1;
+  CHECK_DOUBLE(output->GetCellData()->GetScalars()->GetTuple1(lastCellId), lastCellId);
+  vtkNew<vtkIdList> expectedPointIds;
+  vtkNew<vtkIdList> actualPointIds;
+  mesh->GetCellPoints(lastCellId, expectedPointIds.GetPointer());
+  output->GetCellPoints(lastCellId, actualPointIds.GetPointer());
+  CHECK_INT(actualPointIds->GetNumberOfIds(), expectedPointIds->GetNumberOfIds());
+  for (vtkIdType i = 0; i < expectedPointIds->GetNumberOfIds(); ++i)
+    {
+    CHECK_INT(actualPointIds->GetId(i), expectedPointIds->GetId(i));
+    }
+
+  // Mapped arrays can be modified without affecting the cache file
+  output->GetPoints()->SetPoint(0, 100., 100., 100.);
+  vtkNew<vtkPolyData> output2;
+  CHECK_BOOL(meshCache->ReadMesh(sourceFileName, output2.GetPointer()), true);
+  CHECK_DOUBLE(output2->GetPoint(0)[0], mesh->GetPoint(0)[0]);
+
+  // Modifying the source file invalidates the cache
+  {
+    vtksys::ofstream sourceFile(sourceFileName.c_str(), std::ios::app);
+    sourceFile << "\n";
+  }
+  vtkNew<vtkPolyData> output3;
+  CHECK_BOOL(meshCache->ReadMesh(sourceFileName, output3.GetPointer()), false);
+
+  meshCache->ClearCache();
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestStorageNode(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetRootDirectory(tempDir.c_str());
+  scene->GetCacheManager()->SetRemoteCacheDirectory((tempDir + "/RemoteCache").c_str());
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->Update();
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetAndObservePolyData(sphere->GetOutput());
+  scene->AddNode(modelNode.GetPointer());
+
+  std::string fileName = tempDir + "/sphere.vtk";
+  vtkNew<vtkMRMLModelStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->WriteData(modelNode.GetPointer()), true);
+
+  storageNode->UseMeshCacheOn();
+  std::string cacheDirectory = storageNode->GetMeshCacheDirectory();
+  CHECK_STD_STRING(cacheDirectory, tempDir + "/RemoteCache/ModelMeshCache");
+  vtkNew<vtkMRMLModelMeshCache> meshCache;
+  meshCache->SetCacheDirectory(cacheDirectory);
+  std::string cacheFileName = meshCache->GetCacheFilePath(fileName);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(cacheFileName, true), false);
+
+  // First read parses the file and populates the cache
+  vtkNew<vtkMRMLModelNode> readModelNode;
+  scene->AddNode(readModelNode.GetPointer());
+  CHECK_BOOL(storageNode->ReadData(readModelNode.GetPointer()), true);
+  CHECK_INT(readModelNode->GetPolyData()->GetNumberOfPoints(), sphere->GetOutput()->GetNumberOfPoints());
+  CHECK_BOOL(vtksys::SystemTools::FileExists(cacheFileName, true), true);
+
+  // Second read uses the cache
+  vtkNew<vtkMRMLModelNode> cachedModelNode;
+  scene->AddNode(cachedModelNode.GetPointer());
+  CHECK_BOOL(storageNode->ReadData(cachedModelNode.GetPointer()), true);
+  CHECK_INT(cachedModelNode->GetPolyData()->GetNumberOfPoints(), sphere->GetOutput()->GetNumberOfPoints());
+  CHECK_INT(cachedModelNode->GetPolyData()->GetNumberOfPolys(), sphere->GetOutput()->GetNumberOfPolys());
+
+  return EXIT_SUCCESS;
+}
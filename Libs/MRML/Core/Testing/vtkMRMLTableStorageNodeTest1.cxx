@@ -25,15 +25,25 @@
 #include "vtkMRMLTableNode.h"
 #include "vtkMRMLTableStorageNode.h"
 #include "vtkDoubleArray.h"
+#include "vtkMath.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
+#include "vtkVariant.h"
 
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <fstream>
+
 //---------------------------------------------------------------------------
 int TestReadWriteWithoutSchema(vtkMRMLScene* scene);
 int TestReadWriteWithSchema(vtkMRMLScene* scene);
+int TestReadTypedColumns(vtkMRMLScene* scene);
+int TestReadNumberFormats(vtkMRMLScene* scene);
+int TestDetectNumericColumns(vtkMRMLScene* scene);
+int TestReadLargeTable(vtkMRMLScene* scene);
 int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* table, bool schemaExpected);
+vtkTable* ReadTableFile(vtkMRMLScene* scene, vtkMRMLTableNode* tableNode, const std::string& fileName);
 
 int vtkMRMLTableStorageNodeTest1(int argc, char * argv[])
 {
@@ -52,6 +62,10 @@ int vtkMRMLTableStorageNodeTest1(int argc, char * argv[])
 
   CHECK_EXIT_SUCCESS(TestReadWriteWithoutSchema(scene.GetPointer()));
   CHECK_EXIT_SUCCESS(TestReadWriteWithSchema(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadTypedColumns(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadNumberFormats(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestDetectNumericColumns(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadLargeTable(scene.GetPointer()));
 
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
@@ -104,6 +118,271 @@ int TestReadWriteWithSchema(vtkMRMLScene* scene)
   return EXIT_SUCCESS;
 }
 
+//---------------------------------------------------------------------------
+int TestReadTypedColumns(vtkMRMLScene* scene)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Typed.tsv";
+  std::string schemaFileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Typed.schema.tsv";
+  {
+    std::ofstream schemaFile(schemaFileName.c_str());
+    schemaFile << "columnName\ttype\tnullValue\n"
+               << "int\tint\t-1\n"
+               << "double\tdouble\t\n"
+               << "uchar\tunsigned char\t\n";
+    std::ofstream file(fileName.c_str());
+    file << "int\tdouble\tuchar\n"
+         << "12\t1.5\t65\n"
+         << "\t-2e3\t300\n"
+         << "99999999999\tabc\t\n"
+         << "1.5\t7\t-1\n";
+  }
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  vtkNew<vtkMRMLTableStorageNode> storageNode;
+  scene->AddNode(tableNode.GetPointer());
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()), true);
+  vtkTable* table = tableNode->GetTable();
+  CHECK_NOT_NULL(table);
+  CHECK_INT(table->GetNumberOfRows(), 4);
+  CHECK_INT(table->GetColumnByName("int")->GetDataType(), VTK_INT);
+  CHECK_INT(table->GetColumnByName("double")->GetDataType(), VTK_DOUBLE);
+  CHECK_INT(table->GetColumnByName("uchar")->GetDataType(), VTK_UNSIGNED_CHAR);
+
+  // Empty, invalid and out of range values are replaced by the null value
+  CHECK_INT(table->GetValueByName(0, "int").ToInt(), 12);
+  CHECK_INT(table->GetValueByName(1, "int").ToInt(), -1);
+  CHECK_INT(table->GetValueByName(2, "int").ToInt(), -1);
+  CHECK_INT(table->GetValueByName(3, "int").ToInt(), -1);
+  CHECK_DOUBLE(table->GetValueByName(0, "double").ToDouble(), 1.5);
+  CHECK_DOUBLE(table->GetValueByName(1, "double").ToDouble(), -2000.0);
+  CHECK_DOUBLE(table->GetValueByName(2, "double").ToDouble(), 0.0);
+  CHECK_DOUBLE(table->GetValueByName(3, "double").ToDouble(), 7.0);
+  // Character columns are converted as vtkVariant does
+  const char* ucharStrings[] = { "65", "300", "", "-1" };
+  for (int row = 0; row < 4; ++row)
+    {
+    bool valid = false;
+    unsigned char expectedValue = vtkVariant(vtkStdString(ucharStrings[row])).ToUnsignedChar(&valid);
+    CHECK_INT(table->GetValueByName(row, "uchar").ToInt(), valid ? expectedValue : 0);
+    }
+
+  scene->RemoveNode(tableNode.GetPointer());
+  scene->RemoveNode(storageNode.GetPointer());
+  vtksys::SystemTools::RemoveFile(fileName);
+  vtksys::SystemTools::RemoveFile(schemaFileName);
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+bool IsSameNumber(double value1, double value2)
+{
+  return value1 == value2 || (vtkMath::IsNan(value1) && vtkMath::IsNan(value2));
+}
+
+//---------------------------------------------------------------------------
+int TestReadNumberFormats(vtkMRMLScene* scene)
+{
+  // Values are parsed as vtkVariant converts them, whatever their format
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Formats.tsv";
+  std::string schemaFileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Formats.schema.tsv";
+  const char* strings[] = {
+    "12", "+12", "-12", "007", "1.5", ".5", "5.", "-2e3", "1E+2", "1e", "e5", ".", "-",
+    " 12", "12 ", " 1.5", "1.5 ", "0x1A", "0X1a", "1e400", "-1e400", "1e-320", "99999999999",
+    "inf", "-inf", "INF", "infinity", "nan", "NaN", "-nan", "abc", "1,5", "12abc" };
+  const int numberOfStrings = sizeof(strings) / sizeof(strings[0]);
+  {
+    std::ofstream schemaFile(schemaFileName.c_str());
+    schemaFile << "columnName\ttype\tnullValue\n"
+               << "double\tdouble\t-100\n"
+               << "float\tfloat\t-100\n"
+               << "int\tint\t-100\n"
+               << "ushort\tunsigned short\t100\n";
+    std::ofstream file(fileName.c_str());
+    file << "label\tdouble\tfloat\tint\tushort\n";
+    for (int row = 0; row < numberOfStrings; ++row)
+      {
+      file << "row" << row << "\t" << strings[row] << "\t" << strings[row]
+           << "\t" << strings[row] << "\t" << strings[row] << "\n";
+      }
+  }
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  scene->AddNode(tableNode.GetPointer());
+  vtkTable* table = ReadTableFile(scene, tableNode.GetPointer(), fileName);
+  CHECK_NOT_NULL(table);
+  CHECK_INT(table->GetNumberOfRows(), numberOfStrings);
+  for (int row = 0; row < numberOfStrings; ++row)
+    {
+    vtkVariant variant = vtkVariant(vtkStdString(strings[row]));
+    bool validDouble = false;
+    double expectedDouble = variant.ToDouble(&validDouble);
+    bool validFloat = false;
+    float expectedFloat = variant.ToFloat(&validFloat);
+    bool validInt = false;
+    int expectedInt = variant.ToInt(&validInt);
+    bool validUShort = false;
+    unsigned short expectedUShort = variant.ToUnsignedShort(&validUShort);
+    if (!IsSameNumber(table->GetValueByName(row, "double").ToDouble(), validDouble ? expectedDouble : -100.0)
+      || !IsSameNumber(table->GetValueByName(row, "float").ToFloat(), validFloat ? expectedFloat : -100.0f)
+      || table->GetValueByName(row, "int").ToInt() != (validInt ? expectedInt : -100)
+      || table->GetValueByName(row, "ushort").ToUnsignedShort() != (validUShort ? expectedUShort : 100))
+      {
+      std::cerr << "Line " << __LINE__ << ": '" << strings[row] << "' is not parsed as vtkVariant does: "
+                << table->GetValueByName(row, "double").ToDouble() << ", "
+                << table->GetValueByName(row, "float").ToFloat() << ", "
+                << table->GetValueByName(row, "int").ToInt() << ", "
+                << table->GetValueByName(row, "ushort").ToUnsignedShort() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  scene->RemoveNode(tableNode.GetPointer());
+  vtksys::SystemTools::RemoveFile(fileName);
+  vtksys::SystemTools::RemoveFile(schemaFileName);
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestDetectNumericColumns(vtkMRMLScene* scene)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Detect.csv";
+  {
+    std::ofstream file(fileName.c_str());
+    file << "int,double,string,mixed,empty\n"
+         << "1,1.5,a,1,\n"
+         << "-2,,b,x,\n"
+         << ",3,3,2.5,\n";
+  }
+
+  // Columns without schema are read as strings by default
+  vtkNew<vtkMRMLTableNode> tableNode;
+  scene->AddNode(tableNode.GetPointer());
+  vtkNew<vtkMRMLTableStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  CHECK_BOOL(storageNode->GetDetectNumericColumns(), false);
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()), true);
+  vtkTable* table = tableNode->GetTable();
+  CHECK_NOT_NULL(table);
+  for (int column = 0; column < table->GetNumberOfColumns(); ++column)
+    {
+    CHECK_INT(table->GetColumn(column)->GetDataType(), VTK_STRING);
+    }
+
+  // Opt-in detection of numeric columns
+  storageNode->DetectNumericColumnsOn();
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()), true);
+  table = tableNode->GetTable();
+  CHECK_NOT_NULL(table);
+  CHECK_INT(table->GetNumberOfRows(), 3);
+  CHECK_INT(table->GetColumnByName("int")->GetDataType(), VTK_INT);
+  CHECK_INT(table->GetColumnByName("double")->GetDataType(), VTK_DOUBLE);
+  CHECK_INT(table->GetColumnByName("string")->GetDataType(), VTK_STRING);
+  CHECK_INT(table->GetColumnByName("mixed")->GetDataType(), VTK_STRING);
+  CHECK_INT(table->GetColumnByName("empty")->GetDataType(), VTK_STRING);
+  CHECK_INT(table->GetValueByName(1, "int").ToInt(), -2);
+  CHECK_INT(table->GetValueByName(2, "int").ToInt(), 0);
+  CHECK_DOUBLE(table->GetValueByName(0, "double").ToDouble(), 1.5);
+  CHECK_DOUBLE(table->GetValueByName(1, "double").ToDouble(), 0.0);
+  CHECK_DOUBLE(table->GetValueByName(2, "double").ToDouble(), 3.0);
+  CHECK_STD_STRING(table->GetValueByName(2, "string").ToString(), "3");
+
+  scene->RemoveNode(tableNode.GetPointer());
+  scene->RemoveNode(storageNode.GetPointer());
+  vtksys::SystemTools::RemoveFile(fileName);
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+vtkTable* ReadTableFile(vtkMRMLScene* scene, vtkMRMLTableNode* tableNode, const std::string& fileName)
+{
+  vtkNew<vtkMRMLTableStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.c_str());
+  bool success = storageNode->ReadData(tableNode);
+  scene->RemoveNode(storageNode.GetPointer());
+  return success ? tableNode->GetTable() : nullptr;
+}
+
+//---------------------------------------------------------------------------
+int TestReadLargeTable(vtkMRMLScene* scene)
+{
+  // The file is large enough to be tokenized in several blocks of rows. The same
+  // table is also written with quoted values, which is read by vtkDelimitedTextReader.
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Large.tsv";
+  std::string quotedFileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1LargeQuoted.tsv";
+  std::string schemaFileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Large.schema.tsv";
+  std::string quotedSchemaFileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1LargeQuoted.schema.tsv";
+  const int numberOfRows = 100000;
+  {
+    std::ofstream schemaFile(schemaFileName.c_str());
+    schemaFile << "columnName\ttype\n"
+               << "index\tint\n"
+               << "value\tdouble\n";
+    std::ofstream quotedSchemaFile(quotedSchemaFileName.c_str());
+    quotedSchemaFile << "columnName\ttype\n"
+                     << "index\tint\n"
+                     << "value\tdouble\n";
+    std::ofstream file(fileName.c_str());
+    std::ofstream quotedFile(quotedFileName.c_str());
+    file << "index\tname\tvalue\tcomment\n";
+    quotedFile << "index\tname\tvalue\tcomment\n";
+    for (int row = 0; row < numberOfRows; ++row)
+      {
+      file << row << "\trow " << row << "\t" << row * 0.5 << "\t" << (row % 3 ? "" : "third") << "\n";
+      quotedFile << row << "\t\"row " << row << "\"\t" << row * 0.5 << "\t" << (row % 3 ? "" : "third") << "\n";
+      }
+  }
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  scene->AddNode(tableNode.GetPointer());
+  vtkTable* table = ReadTableFile(scene, tableNode.GetPointer(), fileName);
+  CHECK_NOT_NULL(table);
+  vtkNew<vtkMRMLTableNode> quotedTableNode;
+  scene->AddNode(quotedTableNode.GetPointer());
+  vtkTable* quotedTable = ReadTableFile(scene, quotedTableNode.GetPointer(), quotedFileName);
+  CHECK_NOT_NULL(quotedTable);
+
+  CHECK_INT(table->GetNumberOfRows(), numberOfRows);
+  CHECK_INT(table->GetNumberOfColumns(), 4);
+  CHECK_INT(quotedTable->GetNumberOfRows(), numberOfRows);
+  CHECK_INT(quotedTable->GetNumberOfColumns(), 4);
+  for (int column = 0; column < table->GetNumberOfColumns(); ++column)
+    {
+    CHECK_STRING(table->GetColumn(column)->GetName(), quotedTable->GetColumn(column)->GetName());
+    CHECK_INT(table->GetColumn(column)->GetDataType(), quotedTable->GetColumn(column)->GetDataType());
+    }
+  CHECK_INT(table->GetColumnByName("index")->GetDataType(), VTK_INT);
+  CHECK_INT(table->GetColumnByName("name")->GetDataType(), VTK_STRING);
+  for (int row = 0; row < numberOfRows; ++row)
+    {
+    for (int column = 0; column < table->GetNumberOfColumns(); ++column)
+      {
+      if (table->GetValue(row, column) != quotedTable->GetValue(row, column))
+        {
+        std::cerr << "Line " << __LINE__ << ": value mismatch at row " << row << ", column " << column << ": "
+                  << table->GetValue(row, column).ToString() << " != " << quotedTable->GetValue(row, column).ToString() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  CHECK_INT(table->GetValueByName(numberOfRows - 1, "index").ToInt(), numberOfRows - 1);
+  CHECK_STD_STRING(table->GetValueByName(numberOfRows - 1, "name").ToString(), "row 99999");
+  CHECK_DOUBLE(table->GetValueByName(numberOfRows - 1, "value").ToDouble(), (numberOfRows - 1) * 0.5);
+  CHECK_STD_STRING(table->GetValueByName(3, "comment").ToString(), "third");
+  CHECK_STD_STRING(table->GetValueByName(4, "comment").ToString(), "");
+
+  scene->RemoveNode(tableNode.GetPointer());
+  scene->RemoveNode(quotedTableNode.GetPointer());
+  vtksys::SystemTools::RemoveFile(fileName);
+  vtksys::SystemTools::RemoveFile(quotedFileName);
+  vtksys::SystemTools::RemoveFile(schemaFileName);
+  vtksys::SystemTools::RemoveFile(quotedSchemaFileName);
+  return EXIT_SUCCESS;
+}
+
 //---------------------------------------------------------------------------
 int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* table, bool schemaExpected)
 {
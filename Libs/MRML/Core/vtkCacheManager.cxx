@@ -5,15 +5,59 @@
 #include "vtkMRMLStorageNode.h"
 
 #include <vtksys/Directory.hxx>
+#include <vtksys/FStream.hxx>
 #include <vtksys/SystemTools.hxx>
 
 #include <vtkCallbackCommand.h>
 #include <vtkObjectFactory.h>
 
+// STD includes
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <sstream>
+
 vtkStandardNewMacro ( vtkCacheManager );
 
 #define MB 1000000.0
 
+namespace
+{
+const char CacheIndexFileName[] = ".vtkCacheManagerIndex";
+const char CacheIndexHeader[] = "# vtkCacheManager index 1";
+}
+
+//----------------------------------------------------------------------------
+class vtkCacheManager::vtkInternal
+{
+public:
+  struct Entry
+    {
+    unsigned long long Size;
+    long long LastAccessTime;
+    };
+
+  /// Returns the current time in microseconds, used as last access time.
+  /// Successive calls return strictly increasing values so that the
+  /// access order is preserved even within the clock resolution.
+  long long Now()
+    {
+    long long now = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+    this->LastTime = std::max(now, this->LastTime + 1);
+    return this->LastTime;
+    }
+
+  /// Files in the cache, keyed on their path relative to the cache directory.
+  std::map<std::string, Entry> Entries;
+  unsigned long long TotalSize{0};
+  bool Modified{false};
+  long long LastTime{0};
+  /// Files are added to the index from the data transfer threads.
+  std::recursive_mutex Mutex;
+};
+
 //----------------------------------------------------------------------------
 vtkCacheManager::vtkCacheManager()
 {
@@ -26,14 +70,18 @@ vtkCacheManager::vtkCacheManager()
   this->CurrentCacheSize = 0;
   this->EnableForceRedownload = 0;
   this->InsufficientFreeBufferNotificationFlag = 0;
+  this->EnableLRUEviction = 1;
   // this->EnableRemoteCacheOverwriting = 1;
   this->uriMap.clear();
+  this->Internal = new vtkInternal;
 }
 
 
 //----------------------------------------------------------------------------
 vtkCacheManager::~vtkCacheManager()
 {
+  this->SaveCacheIndex();
+  delete this->Internal;
 
   this->MRMLScene = nullptr;
   this->uriMap.clear();
@@ -128,13 +176,24 @@ void vtkCacheManager::SetRemoteCacheDirectory (const char *dir )
     return;
     }
 
+  // persist the index of the previous cache directory
+  this->SaveCacheIndex();
+
   this->RemoteCacheDirectory = dirstring;
   if (!vtksys::SystemTools::FileExists(this->RemoteCacheDirectory.c_str()))
     {
     vtksys::SystemTools::MakeDirectory(this->RemoteCacheDirectory.c_str());
     }
-  // scan files in cache, it calls Modified
-  this->UpdateCacheInformation();
+  if (this->LoadCacheIndex())
+    {
+    this->UpdateCachedFileListFromIndex();
+    this->Modified();
+    }
+  else
+    {
+    // scan files in cache, it calls Modified
+    this->UpdateCacheInformation();
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -254,6 +313,8 @@ void vtkCacheManager::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "RemoteCacheFreeBufferSize: " << this->GetRemoteCacheFreeBufferSize() << "\n";
   //os << indent << "EnableRemoteCacheOverwriting: " << this->GetEnableRemoteCacheOverwriting() << "\n";
   os << indent << "EnableForceRedownload: " << this->GetEnableForceRedownload() << "\n";
+  os << indent << "EnableLRUEviction: " << this->GetEnableLRUEviction() << "\n";
+  os << indent << "NumberOfCacheIndexEntries: " << this->GetNumberOfCacheIndexEntries() << "\n";
 }
 
 
@@ -307,7 +368,7 @@ int vtkCacheManager::GetCachedFileList ( const char *dirname )
               return (0);
               }
             }
-          else
+          else if ( strcmp(dir.GetFile(static_cast<unsigned long>(fileNum)), CacheIndexFileName) )
             {
             this->CachedFileList.push_back ( dir.GetFile(static_cast<unsigned long>(fileNum) ));
             }
@@ -515,8 +576,8 @@ void vtkCacheManager::UpdateCacheInformation ( )
   // this->RemoteCacheFreeBufferSize = ?;
 
   //--- and refresh list of cached files.
-  this->CachedFileList.clear();
-  this->GetCachedFileList ( this->GetRemoteCacheDirectory() );
+  this->RebuildCacheIndex();
+  this->UpdateCachedFileListFromIndex();
   this->Modified();
 }
 
@@ -580,7 +641,9 @@ void vtkCacheManager::DeleteFromCache( const char *target )
         }
       else
         {
-        this->UpdateCacheInformation ( );
+        this->RemoveFromCacheIndex ( str.c_str() );
+        this->UpdateCachedFileListFromIndex ( );
+        this->Modified();
         this->InvokeEvent ( vtkCacheManager::CacheDeleteEvent );
         }
       }
@@ -592,7 +655,9 @@ void vtkCacheManager::DeleteFromCache( const char *target )
         }
       else
         {
-        this->UpdateCacheInformation ( );
+        this->RemoveFromCacheIndex ( str.c_str() );
+        this->UpdateCachedFileListFromIndex ( );
+        this->Modified();
         this->InvokeEvent ( vtkCacheManager::CacheDeleteEvent );
         }
       }
@@ -616,7 +681,11 @@ int vtkCacheManager::ClearCacheCheck()
   if ( cachedir.c_str() != nullptr )
     {
     unsigned long numFiles = vtksys::Directory::GetNumberOfFilesInDirectory( cachedir.c_str() );
-    //--- assume method will return . and ..
+    //--- assume method will return . and .., the cache index is ignored
+    if ( vtksys::SystemTools::FileExists ( this->GetCacheIndexFileName().c_str(), true ) )
+      {
+      numFiles--;
+      }
     if ( numFiles > 2 )
       {
       this->InvokeEvent ( vtkCacheManager::CacheDirtyEvent );
@@ -648,6 +717,12 @@ int vtkCacheManager::ClearCache()
     vtkWarningMacro ( "Cache cleared: Error: unable to recreate cache directory after deleting its contents." );
     return 0;
     }
+    {
+    std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+    this->Internal->Entries.clear();
+    this->Internal->TotalSize = 0;
+    this->Internal->Modified = true;
+    }
   this->UpdateCacheInformation();
   this->InvokeEvent ( vtkCacheManager::CacheClearEvent );
   return 1;
@@ -658,12 +733,16 @@ int vtkCacheManager::ClearCache()
 //----------------------------------------------------------------------------
 float vtkCacheManager::GetCurrentCacheSize ()
 {
-  if ( this->RemoteCacheDirectory.c_str() == nullptr )
+  if ( this->RemoteCacheDirectory.empty() )
     {
     return (0.0);
     }
-  float size = this->ComputeCacheSize ( this->RemoteCacheDirectory.c_str(), 0 );
-  this->SetCurrentCacheSize ( size );
+  unsigned long long totalSize = 0;
+    {
+    std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+    totalSize = this->Internal->TotalSize;
+    }
+  this->CurrentCacheSize = static_cast<float>(totalSize / MB);
   return ( this->CurrentCacheSize );
 
 }
@@ -830,8 +909,11 @@ float vtkCacheManager::ComputeCacheSize( const char *dirName, unsigned long sz )
 void vtkCacheManager::CacheSizeCheck()
 {
 
+  //--- Make room for new downloads by evicting least recently used files
+  this->EnforceCacheLimit();
   //--- Compute size of the current cache
-  this->ComputeCacheSize(this->RemoteCacheDirectory.c_str(), 0);
+  this->GetCurrentCacheSize();
+  this->SaveCacheIndex();
   //--- Invoke an event if cache size is exceeded.
   if ( this->CurrentCacheSize > (float) (this->RemoteCacheLimit) )
     {
@@ -844,7 +926,7 @@ void vtkCacheManager::CacheSizeCheck()
 float vtkCacheManager::GetFreeCacheSpaceRemaining()
 {
 
-  float cachesize = this->ComputeCacheSize(this->RemoteCacheDirectory.c_str(), 0);
+  float cachesize = this->GetCurrentCacheSize();
   // cache limit - current cache size = total space left in cache.
   // total space in cache - free buffer size = amount that can be used.
   float diff = ( float (this->RemoteCacheLimit) - cachesize );
@@ -872,6 +954,7 @@ int vtkCacheManager::CachedFileExists ( const char *filename )
 {
   if ( vtksys::SystemTools::FileExists ( filename ) )
     {
+    this->TouchCachedFile ( filename );
     return 1;
     }
   else
@@ -882,6 +965,7 @@ int vtkCacheManager::CachedFileExists ( const char *filename )
     testFile += filename;
     if ( vtksys::SystemTools::FileExists ( testFile.c_str() ))
       {
+      this->TouchCachedFile ( testFile.c_str() );
       return 1;
       }
     else
@@ -997,3 +1081,393 @@ const char* vtkCacheManager::FindCachedFile ( const char * target, const char *d
     }
 
 }
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::UpdateCachedFileListFromIndex()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+  this->CachedFileList.clear();
+  for (std::map<std::string, vtkInternal::Entry>::const_iterator it = this->Internal->Entries.begin();
+       it != this->Internal->Entries.end(); ++it)
+    {
+    //--- list contains file names without path
+    this->CachedFileList.push_back ( vtksys::SystemTools::GetFilenameName ( it->first ) );
+    }
+}
+
+//----------------------------------------------------------------------------
+std::string vtkCacheManager::GetCacheIndexFileName()
+{
+  if ( this->RemoteCacheDirectory.empty() )
+    {
+    return std::string();
+    }
+  return this->RemoteCacheDirectory + "/" + CacheIndexFileName;
+}
+
+//----------------------------------------------------------------------------
+int vtkCacheManager::GetNumberOfCacheIndexEntries()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+  return static_cast<int>(this->Internal->Entries.size());
+}
+
+//----------------------------------------------------------------------------
+// Returns the path of filename relative to the cache directory, or an empty
+// string if filename is not in the cache directory.
+static std::string vtkCacheManagerRelativePath ( const std::string& cacheDirectory, const char *filename )
+{
+  if ( cacheDirectory.empty() || filename == nullptr || strlen(filename) == 0 )
+    {
+    return std::string();
+    }
+  std::string fullCacheDirectory = vtksys::SystemTools::CollapseFullPath ( cacheDirectory );
+  std::string fullPath = vtksys::SystemTools::CollapseFullPath ( filename, fullCacheDirectory );
+  std::string prefix = fullCacheDirectory + "/";
+  if ( fullPath.size() <= prefix.size() || fullPath.compare ( 0, prefix.size(), prefix ) != 0 )
+    {
+    return std::string();
+    }
+  std::string relativePath = fullPath.substr ( prefix.size() );
+  if ( relativePath == CacheIndexFileName )
+    {
+    return std::string();
+    }
+  return relativePath;
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::AddToCacheIndex ( const char *filename )
+{
+  std::string relativePath = vtkCacheManagerRelativePath ( this->RemoteCacheDirectory, filename );
+  if ( relativePath.empty() )
+    {
+    return;
+    }
+  std::string fullPath = this->RemoteCacheDirectory + "/" + relativePath;
+  if ( !vtksys::SystemTools::FileExists ( fullPath.c_str(), true ) )
+    {
+    //--- directories are added file by file
+    if ( vtksys::SystemTools::FileIsDirectory ( fullPath ) )
+      {
+      vtksys::Directory dir;
+      dir.Load ( fullPath );
+      for ( unsigned long fileNum = 0; fileNum < dir.GetNumberOfFiles(); ++fileNum )
+        {
+        if ( strcmp(dir.GetFile(fileNum), ".") && strcmp(dir.GetFile(fileNum), "..") )
+          {
+          this->AddToCacheIndex ( (fullPath + "/" + dir.GetFile(fileNum)).c_str() );
+          }
+        }
+      }
+    return;
+    }
+  unsigned long long size = vtksys::SystemTools::FileLength ( fullPath );
+
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+  std::map<std::string, vtkInternal::Entry>::iterator it = this->Internal->Entries.find ( relativePath );
+  if ( it != this->Internal->Entries.end() )
+    {
+    this->Internal->TotalSize -= it->second.Size;
+    }
+  vtkInternal::Entry& entry = this->Internal->Entries[relativePath];
+  entry.Size = size;
+  entry.LastAccessTime = this->Internal->Now();
+  this->Internal->TotalSize += size;
+  this->Internal->Modified = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::TouchCachedFile ( const char *filename )
+{
+  std::string relativePath = vtkCacheManagerRelativePath ( this->RemoteCacheDirectory, filename );
+  if ( relativePath.empty() )
+    {
+    return;
+    }
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+  std::map<std::string, vtkInternal::Entry>::iterator it = this->Internal->Entries.find ( relativePath );
+  if ( it != this->Internal->Entries.end() )
+    {
+    it->second.LastAccessTime = this->Internal->Now();
+    this->Internal->Modified = true;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::RemoveFromCacheIndex ( const char *filename )
+{
+  std::string relativePath = vtkCacheManagerRelativePath ( this->RemoteCacheDirectory, filename );
+  if ( relativePath.empty() )
+    {
+    return;
+    }
+  std::string directoryPrefix = relativePath + "/";
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+  std::map<std::string, vtkInternal::Entry>::iterator it = this->Internal->Entries.lower_bound ( relativePath );
+  while ( it != this->Internal->Entries.end() )
+    {
+    if ( it->first != relativePath && it->first.compare ( 0, directoryPrefix.size(), directoryPrefix ) != 0 )
+      {
+      //--- entries are sorted, keep scanning only while names start with relativePath
+      if ( it->first.compare ( 0, relativePath.size(), relativePath ) != 0 )
+        {
+        break;
+        }
+      ++it;
+      continue;
+      }
+    this->Internal->TotalSize -= it->second.Size;
+    this->Internal->Modified = true;
+    it = this->Internal->Entries.erase ( it );
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::RebuildCacheIndex()
+{
+  std::map<std::string, vtkInternal::Entry> entries;
+  unsigned long long totalSize = 0;
+  std::vector<std::string> directories;
+  if ( vtksys::SystemTools::FileIsDirectory ( this->RemoteCacheDirectory ) )
+    {
+    directories.push_back ( std::string() );
+    }
+
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+  while ( !directories.empty() )
+    {
+    std::string relativeDirectory = directories.back();
+    directories.pop_back();
+    std::string directoryPath = this->RemoteCacheDirectory;
+    if ( !relativeDirectory.empty() )
+      {
+      directoryPath += "/" + relativeDirectory;
+      }
+    vtksys::Directory dir;
+    dir.Load ( directoryPath );
+    for ( unsigned long fileNum = 0; fileNum < dir.GetNumberOfFiles(); ++fileNum )
+      {
+      std::string name = dir.GetFile ( fileNum );
+      if ( name == "." || name == ".." || ( relativeDirectory.empty() && name == CacheIndexFileName ) )
+        {
+        continue;
+        }
+      std::string relativePath = relativeDirectory.empty() ? name : relativeDirectory + "/" + name;
+      std::string fullPath = directoryPath + "/" + name;
+      if ( vtksys::SystemTools::FileIsDirectory ( fullPath ) )
+        {
+        directories.push_back ( relativePath );
+        continue;
+        }
+      vtkInternal::Entry entry;
+      entry.Size = vtksys::SystemTools::FileLength ( fullPath );
+      std::map<std::string, vtkInternal::Entry>::iterator it = this->Internal->Entries.find ( relativePath );
+      if ( it != this->Internal->Entries.end() )
+        {
+        entry.LastAccessTime = it->second.LastAccessTime;
+        }
+      else
+        {
+        //--- unknown files are considered accessed when last modified
+        entry.LastAccessTime = static_cast<long long>(
+          vtksys::SystemTools::ModifiedTime ( fullPath ) ) * 1000000LL;
+        }
+      entries[relativePath] = entry;
+      totalSize += entry.Size;
+      }
+    }
+  this->Internal->Entries.swap ( entries );
+  this->Internal->TotalSize = totalSize;
+  this->Internal->Modified = true;
+}
+
+//----------------------------------------------------------------------------
+int vtkCacheManager::LoadCacheIndex()
+{
+  std::string indexFileName = this->GetCacheIndexFileName();
+  if ( indexFileName.empty() )
+    {
+    return 0;
+    }
+  vtksys::ifstream file ( indexFileName.c_str() );
+  if ( !file.is_open() )
+    {
+    return 0;
+    }
+  std::string line;
+  if ( !std::getline ( file, line ) || line != CacheIndexHeader )
+    {
+    vtkWarningMacro ( "LoadCacheIndex: ignoring invalid cache index " << indexFileName );
+    return 0;
+    }
+
+  std::map<std::string, vtkInternal::Entry> entries;
+  unsigned long long totalSize = 0;
+  long long lastTime = 0;
+  bool modified = false;
+  while ( std::getline ( file, line ) )
+    {
+    //--- each line is: size lastAccessTime relativePath
+    std::istringstream lineStream ( line );
+    vtkInternal::Entry entry;
+    std::string relativePath;
+    if ( !(lineStream >> entry.Size >> entry.LastAccessTime) )
+      {
+      vtkWarningMacro ( "LoadCacheIndex: ignoring invalid cache index " << indexFileName );
+      return 0;
+      }
+    lineStream.get();
+    std::getline ( lineStream, relativePath );
+    std::string fullPath = this->RemoteCacheDirectory + "/" + relativePath;
+    if ( relativePath.empty() || !vtksys::SystemTools::FileExists ( fullPath.c_str(), true ) )
+      {
+      //--- file was removed outside of the cache manager
+      modified = true;
+      continue;
+      }
+    entries[relativePath] = entry;
+    totalSize += entry.Size;
+    lastTime = std::max ( lastTime, entry.LastAccessTime );
+    }
+
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+  this->Internal->Entries.swap ( entries );
+  this->Internal->TotalSize = totalSize;
+  this->Internal->LastTime = std::max ( this->Internal->LastTime, lastTime );
+  this->Internal->Modified = modified;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkCacheManager::SaveCacheIndex()
+{
+  std::string indexFileName = this->GetCacheIndexFileName();
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+  if ( !this->Internal->Modified )
+    {
+    return 1;
+    }
+  if ( indexFileName.empty() || !vtksys::SystemTools::FileIsDirectory ( this->RemoteCacheDirectory ) )
+    {
+    return 0;
+    }
+  //--- write into a temporary file so that a partially written index is never read
+  std::string temporaryFileName = indexFileName + ".tmp";
+    {
+    vtksys::ofstream file ( temporaryFileName.c_str(), std::ios::out | std::ios::trunc );
+    if ( !file.is_open() )
+      {
+      vtkWarningMacro ( "SaveCacheIndex: unable to write " << temporaryFileName );
+      return 0;
+      }
+    file << CacheIndexHeader << "\n";
+    for (std::map<std::string, vtkInternal::Entry>::const_iterator it = this->Internal->Entries.begin();
+         it != this->Internal->Entries.end(); ++it)
+      {
+      file << it->second.Size << " " << it->second.LastAccessTime << " " << it->first << "\n";
+      }
+    if ( !file.good() )
+      {
+      vtkWarningMacro ( "SaveCacheIndex: unable to write " << temporaryFileName );
+      return 0;
+      }
+    }
+  vtksys::SystemTools::RemoveFile ( indexFileName );
+  if ( !vtksys::SystemTools::RenameFile ( temporaryFileName.c_str(), indexFileName.c_str() ) )
+    {
+    vtkWarningMacro ( "SaveCacheIndex: unable to write " << indexFileName );
+    return 0;
+    }
+  this->Internal->Modified = false;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkCacheManager::EvictLeastRecentlyUsedFiles ( float targetSize )
+{
+  unsigned long long targetBytes = static_cast<unsigned long long> ( std::max ( targetSize, 0.f ) * MB );
+
+  //--- files referenced by the scene are in use, they must be kept.
+  std::set<std::string> filesInUse;
+  if ( this->MRMLScene != nullptr )
+    {
+    int nnodes = this->MRMLScene->GetNumberOfNodesByClass ( "vtkMRMLStorageNode" );
+    for ( int n = 0; n < nnodes; n++ )
+      {
+      vtkMRMLStorageNode *storageNode = vtkMRMLStorageNode::SafeDownCast (
+        this->MRMLScene->GetNthNodeByClass ( n, "vtkMRMLStorageNode" ) );
+      if ( storageNode == nullptr )
+        {
+        continue;
+        }
+      std::string relativePath = vtkCacheManagerRelativePath (
+        this->RemoteCacheDirectory, storageNode->GetFullNameFromFileName().c_str() );
+      if ( !relativePath.empty() )
+        {
+        filesInUse.insert ( relativePath );
+        }
+      for ( int i = 0; i < storageNode->GetNumberOfFileNames(); i++ )
+        {
+        relativePath = vtkCacheManagerRelativePath (
+          this->RemoteCacheDirectory, storageNode->GetFullNameFromNthFileName(i).c_str() );
+        if ( !relativePath.empty() )
+          {
+          filesInUse.insert ( relativePath );
+          }
+        }
+      }
+    }
+
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->Mutex);
+  if ( this->Internal->TotalSize <= targetBytes )
+    {
+    return 0;
+    }
+  std::vector< std::pair<long long, std::string> > candidates;
+  for (std::map<std::string, vtkInternal::Entry>::const_iterator it = this->Internal->Entries.begin();
+       it != this->Internal->Entries.end(); ++it)
+    {
+    if ( filesInUse.find ( it->first ) == filesInUse.end() )
+      {
+      candidates.push_back ( std::make_pair ( it->second.LastAccessTime, it->first ) );
+      }
+    }
+  std::sort ( candidates.begin(), candidates.end() );
+
+  int numberOfEvictedFiles = 0;
+  for ( size_t i = 0; i < candidates.size() && this->Internal->TotalSize > targetBytes; ++i )
+    {
+    std::string fullPath = this->RemoteCacheDirectory + "/" + candidates[i].second;
+    if ( vtksys::SystemTools::FileExists ( fullPath.c_str(), true )
+      && !vtksys::SystemTools::RemoveFile ( fullPath ) )
+      {
+      vtkWarningMacro ( "EvictLeastRecentlyUsedFiles: unable to remove cached file " << fullPath );
+      continue;
+      }
+    vtkDebugMacro ( "EvictLeastRecentlyUsedFiles: removed " << fullPath );
+    std::map<std::string, vtkInternal::Entry>::iterator it = this->Internal->Entries.find ( candidates[i].second );
+    this->Internal->TotalSize -= it->second.Size;
+    this->Internal->Entries.erase ( it );
+    this->Internal->Modified = true;
+    ++numberOfEvictedFiles;
+    }
+  if ( numberOfEvictedFiles > 0 )
+    {
+    this->UpdateCachedFileListFromIndex();
+    this->Modified();
+    this->InvokeEvent ( vtkCacheManager::CacheDeleteEvent );
+    }
+  return numberOfEvictedFiles;
+}
+
+//----------------------------------------------------------------------------
+int vtkCacheManager::EnforceCacheLimit()
+{
+  if ( !this->EnableLRUEviction || this->RemoteCacheDirectory.empty() )
+    {
+    return 0;
+    }
+  float targetSize = static_cast<float> ( this->RemoteCacheLimit - this->RemoteCacheFreeBufferSize );
+  return this->EvictLeastRecentlyUsedFiles ( targetSize );
+}
@@ -108,12 +108,69 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
   const char* AddCachePathToFilename ( const char *filename );
   const char* EncodeURI ( const char *uri );
 
+  ///
+  /// Evicts least recently used files if EnableLRUEviction is set and
+  /// the cache size exceeds RemoteCacheLimit, then invokes
+  /// CacheLimitExceededEvent if the limit is still exceeded.
   void CacheSizeCheck();
   void FreeCacheBufferCheck();
+  ///
+  /// Traverses \a dirname recursively and returns the combined size
+  /// of all files in MB. GetCurrentCacheSize() should be preferred, it
+  /// uses the cache index and does not access the disk.
   float ComputeCacheSize( const char *dirname, unsigned long size );
+  ///
+  /// Returns the size of the cache in MB, as recorded in the cache index.
   float GetCurrentCacheSize();
   float GetFreeCacheSpaceRemaining();
 
+  ///
+  /// The cache index records the size and last access time of every file
+  /// in the RemoteCacheDirectory so that the cache size can be known
+  /// without traversing the directory, and least recently used files can
+  /// be evicted first. It is persisted in the cache directory
+  /// (see GetCacheIndexFileName()) and loaded when the directory is set.
+  /// Adds \a filename (absolute or relative to the cache directory) to
+  /// the cache index or refreshes its size, and marks it as accessed.
+  /// Files outside of the cache directory are ignored.
+  void AddToCacheIndex( const char *filename );
+  ///
+  /// Marks \a filename as accessed if it is in the cache index.
+  void TouchCachedFile( const char *filename );
+  ///
+  /// Removes \a filename, or all files under \a filename if it is a
+  /// directory, from the cache index. Files on disk are not deleted.
+  void RemoveFromCacheIndex( const char *filename );
+  ///
+  /// Traverses the cache directory and rebuilds the cache index. Last
+  /// access times of files already in the index are preserved.
+  void RebuildCacheIndex();
+  ///
+  /// Reads the cache index from disk. Entries of files that do not exist
+  /// anymore are discarded. Returns 0 if the index file is missing or invalid.
+  int LoadCacheIndex();
+  ///
+  /// Writes the cache index to disk if it has been modified since it
+  /// was loaded or saved. Returns 0 on failure.
+  int SaveCacheIndex();
+  ///
+  /// Returns the full path of the file where the cache index is saved.
+  std::string GetCacheIndexFileName();
+  ///
+  /// Returns the number of files in the cache index.
+  int GetNumberOfCacheIndexEntries();
+  ///
+  /// Deletes least recently used files until the cache size is below
+  /// \a targetSize (in MB). Files referenced by storage nodes of the scene
+  /// are never evicted. Returns the number of deleted files.
+  int EvictLeastRecentlyUsedFiles( float targetSize );
+  ///
+  /// Deletes least recently used files until the cache size leaves at
+  /// least RemoteCacheFreeBufferSize MB free below RemoteCacheLimit.
+  /// Does nothing if EnableLRUEviction is not set. Returns the number
+  /// of deleted files.
+  int EnforceCacheLimit();
+
   std::vector< std::string > GetCachedFiles()const;
 
   ///
@@ -124,6 +181,12 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
   vtkSetMacro ( RemoteCacheFreeBufferSize, int );
   vtkGetMacro ( EnableForceRedownload, int );
   vtkSetMacro ( EnableForceRedownload, int );
+  ///
+  /// If set, least recently used files are automatically deleted when the
+  /// cache size exceeds RemoteCacheLimit. On by default.
+  vtkGetMacro ( EnableLRUEviction, int );
+  vtkSetMacro ( EnableLRUEviction, int );
+  vtkBooleanMacro ( EnableLRUEviction, int );
   //vtkGetMacro ( EnableRemoteCacheOverwriting, int );
   //vtkSetMacro ( EnableRemoteCacheOverwriting, int );
   void SetMRMLScene ( vtkMRMLScene *scene )
@@ -160,6 +223,7 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
   float CurrentCacheSize;
   int RemoteCacheFreeBufferSize;
   int EnableForceRedownload;
+  int EnableLRUEviction;
   //int EnableRemoteCacheOverwriting;
   vtkMRMLScene *MRMLScene;
 
@@ -172,6 +236,12 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
   /// with every download, remove from cache, and clearcache call.
   std::vector< std::string > CachedFileList;
 
+  /// Refreshes CachedFileList from the cache index.
+  void UpdateCachedFileListFromIndex();
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
  protected:
   vtkCacheManager();
   ~vtkCacheManager() override;
@@ -396,6 +396,8 @@ void vtkDataIOManager::QueueRead ( vtkMRMLNode *node )
     //--- a large scene that consists of multiple datasets.
     //--- ***The risk with this implementation  is that they may
     //--- forget to adjust the cache size, but aren't notified again...
+    //--- Evict least recently used files first to make room for the download.
+    cm->EnforceCacheLimit();
     float bufsize = (cm->GetRemoteCacheLimit() * 1000000.0) -  (cm->GetRemoteCacheFreeBufferSize() * 1000000.0);
     if ( (cm->GetCurrentCacheSize()*1000000.0) >= bufsize )
       {
@@ -425,7 +427,9 @@ void vtkDataIOManager::QueueRead ( vtkMRMLNode *node )
       //--- and signal this remote read event to Logic and GUI.
       vtkDebugMacro("QueueRead: invoking a remote read event on the data io manager");
       this->InvokeEvent ( vtkDataIOManager::RemoteReadEvent, node);
-      cm->UpdateCacheInformation();
+      //--- downloaded files are added to the cache index when the
+      //--- transfer completes, there is no need to scan the cache directory.
+      cm->SaveCacheIndex();
       }
     }
   else
@@ -0,0 +1,314 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLChunkedVolumeStorageNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// vtkAddon includes
+#include <vtkChunkedImageReader.h>
+#include <vtkChunkedImageWriter.h>
+
+// VTK includes
+#include <vtkErrorCode.h>
+#include <vtkImageChangeInformation.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtkStringArray.h>
+
+// STD includes
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+vtkMRMLNodeNewMacro(vtkMRMLChunkedVolumeStorageNode);
+
+//----------------------------------------------------------------------------
+vtkMRMLChunkedVolumeStorageNode::vtkMRMLChunkedVolumeStorageNode()
+{
+  this->CenterImage = false;
+  this->ChunkSize[0] = 64;
+  this->ChunkSize[1] = 64;
+  this->ChunkSize[2] = 64;
+  this->ReadExtent[0] = 0;
+  this->ReadExtent[1] = -1;
+  this->ReadExtent[2] = 0;
+  this->ReadExtent[3] = -1;
+  this->ReadExtent[4] = 0;
+  this->ReadExtent[5] = -1;
+  this->DefaultWriteFileExtension = "cvol";
+
+  this->CompressionPresets.push_back(vtkMRMLStorageNode::CompressionPreset(this->GetCompressionParameterFastest(), "Fastest"));
+  this->CompressionPresets.push_back(vtkMRMLStorageNode::CompressionPreset(this->GetCompressionParameterNormal(), "Normal"));
+  this->CompressionPresets.push_back(vtkMRMLStorageNode::CompressionPreset(this->GetCompressionParameterMinimumSize(), "Minimum size"));
+
+  this->CompressionParameter = this->GetCompressionParameterFastest();
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLChunkedVolumeStorageNode::~vtkMRMLChunkedVolumeStorageNode()
+= default;
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::WriteXML(ostream& of, int nIndent)
+{
+  Superclass::WriteXML(of, nIndent);
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(centerImage, CenterImage);
+  vtkMRMLWriteXMLVectorMacro(chunkSize, ChunkSize, int, 3);
+  vtkMRMLWriteXMLVectorMacro(readExtent, ReadExtent, int, 6);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::ReadXMLAttributes(const char** atts)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::ReadXMLAttributes(atts);
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLBooleanMacro(centerImage, CenterImage);
+  vtkMRMLReadXMLVectorMacro(chunkSize, ChunkSize, int, 3);
+  vtkMRMLReadXMLVectorMacro(readExtent, ReadExtent, int, 6);
+  vtkMRMLReadXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+// Copy the node's attributes to this object.
+// Does NOT copy: ID, FilePrefix, Name, StorageID
+void vtkMRMLChunkedVolumeStorageNode::Copy(vtkMRMLNode *anode)
+{
+  MRMLNodeModifyBlocker blocker(this);
+  Superclass::Copy(anode);
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyBooleanMacro(CenterImage);
+  vtkMRMLCopyVectorMacro(ChunkSize, int, 3);
+  vtkMRMLCopyVectorMacro(ReadExtent, int, 6);
+  vtkMRMLCopyEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os,indent);
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintBooleanMacro(CenterImage);
+  vtkMRMLPrintVectorMacro(ChunkSize, int, 3);
+  vtkMRMLPrintVectorMacro(ReadExtent, int, 6);
+  vtkMRMLPrintEndMacro();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLChunkedVolumeStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
+{
+  return refNode->IsA("vtkMRMLScalarVolumeNode");
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLChunkedVolumeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
+{
+  vtkMRMLScalarVolumeNode* volNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (!volNode)
+    {
+    vtkErrorMacro(<< "ReadData: Do not recognize node type " << refNode->GetClassName());
+    return 0;
+    }
+
+  if (volNode->GetImageData())
+    {
+    volNode->SetAndObserveImageData(nullptr);
+    }
+
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+    {
+    vtkErrorMacro("ReadData: File name not specified");
+    return 0;
+    }
+  if (!vtkChunkedImageReader::CanReadFile(fullName.c_str()))
+    {
+    vtkErrorMacro("ReadData: This is not a chunked volume file: " << fullName);
+    return 0;
+    }
+
+  vtkNew<vtkChunkedImageReader> reader;
+  reader->SetFileName(fullName.c_str());
+  reader->UpdateInformation();
+  if (reader->GetErrorCode() != vtkErrorCode::NoError)
+    {
+    vtkErrorMacro("ReadData: Failed to read header of " << fullName);
+    return 0;
+    }
+
+  // Only the chunks that intersect the requested extent are read
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  reader->GetOutputInformation(0)->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent);
+  if (this->ReadExtent[0] <= this->ReadExtent[1]
+    && this->ReadExtent[2] <= this->ReadExtent[3]
+    && this->ReadExtent[4] <= this->ReadExtent[5])
+    {
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      extent[2 * axis] = std::max(extent[2 * axis], this->ReadExtent[2 * axis]);
+      extent[2 * axis + 1] = std::min(extent[2 * axis + 1], this->ReadExtent[2 * axis + 1]);
+      }
+    if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+      {
+      vtkErrorMacro("ReadData: Read extent does not intersect the volume in " << fullName);
+      return 0;
+      }
+    }
+  if (!reader->UpdateExtent(extent) || reader->GetErrorCode() != vtkErrorCode::NoError)
+    {
+    vtkErrorMacro("ReadData: Failed to read image data from " << fullName);
+    return 0;
+    }
+
+  // The loaded image starts at voxel (0,0,0), so the origin is shifted
+  // to keep the region at the same physical location.
+  vtkNew<vtkMatrix4x4> ijkToRas;
+  ijkToRas->DeepCopy(reader->GetIJKToRASMatrix());
+  for (int row = 0; row < 3; ++row)
+    {
+    double origin = ijkToRas->GetElement(row, 3);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      origin += ijkToRas->GetElement(row, axis) * extent[2 * axis];
+      }
+    ijkToRas->SetElement(row, 3, origin);
+    }
+  if (this->CenterImage)
+    {
+    for (int row = 0; row < 3; ++row)
+      {
+      double center = ijkToRas->GetElement(row, 3);
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        center += ijkToRas->GetElement(row, axis) * (extent[2 * axis + 1] - extent[2 * axis]) * 0.5;
+        }
+      ijkToRas->SetElement(row, 3, ijkToRas->GetElement(row, 3) - center);
+      }
+    }
+  volNode->SetIJKToRASMatrix(ijkToRas);
+
+  // parse non-specific key-value pairs
+  std::vector<std::string> keys = reader->GetMetaDataKeys();
+  for (std::vector<std::string>::iterator kit = keys.begin(); kit != keys.end(); ++kit)
+    {
+    volNode->SetAttribute(kit->c_str(), reader->GetMetaDataValue(*kit).c_str());
+    }
+
+  vtkNew<vtkImageChangeInformation> ici;
+  ici->SetInputData(reader->GetOutput());
+  ici->SetOutputSpacing(1, 1, 1);
+  ici->SetOutputOrigin(0, 0, 0);
+  ici->SetOutputExtentStart(0, 0, 0);
+  ici->Update();
+
+  volNode->SetImageDataConnection(ici->GetOutputPort());
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLChunkedVolumeStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
+{
+  vtkMRMLScalarVolumeNode* volNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (!volNode)
+    {
+    vtkErrorMacro(<< "WriteData: Do not recognize node type " << refNode->GetClassName());
+    return 0;
+    }
+  if (volNode->GetImageData() == nullptr)
+    {
+    vtkErrorMacro("WriteData: Cannot write nullptr ImageData");
+    return 0;
+    }
+
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+    {
+    vtkErrorMacro("WriteData: File name not specified");
+    return 0;
+    }
+
+  vtkNew<vtkMatrix4x4> ijkToRas;
+  volNode->GetIJKToRASMatrix(ijkToRas.GetPointer());
+
+  vtkNew<vtkChunkedImageWriter> writer;
+  writer->SetFileName(fullName.c_str());
+  writer->SetInputConnection(volNode->GetImageDataConnection());
+  writer->SetChunkSize(this->ChunkSize);
+  writer->SetUseCompression(this->GetUseCompression());
+  writer->SetCompressionLevel(this->GetCompressionLevelFromCompressionParameter(this->CompressionParameter));
+  writer->SetIJKToRASMatrix(ijkToRas.GetPointer());
+
+  // pass down all MRML attributes
+  std::vector<std::string> attributeNames = volNode->GetAttributeNames();
+  for (std::vector<std::string>::iterator ait = attributeNames.begin(); ait != attributeNames.end(); ++ait)
+    {
+    writer->SetMetaData(*ait, volNode->GetAttribute(ait->c_str()));
+    }
+
+  writer->Write();
+  int writeFlag = 1;
+  if (writer->GetErrorCode() != vtkErrorCode::NoError)
+    {
+    vtkErrorMacro("ERROR writing chunked volume file " << fullName);
+    writeFlag = 0;
+    }
+
+  this->StageWriteData(refNode);
+
+  return writeFlag;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::InitializeSupportedReadFileTypes()
+{
+  this->SupportedReadFileTypes->InsertNextValue("Chunked volume (.cvol)");
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::InitializeSupportedWriteFileTypes()
+{
+  this->SupportedWriteFileTypes->InsertNextValue("Chunked volume (.cvol)");
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLChunkedVolumeStorageNode::GetCompressionLevelFromCompressionParameter(const std::string& compressionParameter)
+{
+  if (compressionParameter == this->GetCompressionParameterFastest())
+    {
+    return 1;
+    }
+  else if (compressionParameter == this->GetCompressionParameterNormal())
+    {
+    return 6;
+    }
+  else if (compressionParameter == this->GetCompressionParameterMinimumSize())
+    {
+    return 9;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLChunkedVolumeStorageNode::ConfigureForDataExchange()
+{
+  this->UseCompressionOff();
+}
@@ -0,0 +1,108 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLChunkedVolumeStorageNode_h
+#define __vtkMRMLChunkedVolumeStorageNode_h
+
+#include "vtkMRMLStorageNode.h"
+
+/// \brief MRML node for storing volumes as independently compressed chunks.
+///
+/// Chunks are compressed and decompressed in parallel, which makes saving and
+/// loading of very large volumes much faster than with a single compressed
+/// stream. A sub-region of the volume can be loaded by setting ReadExtent,
+/// in which case only the chunks intersecting the region are read.
+///
+/// \sa vtkChunkedImageReader, vtkChunkedImageWriter
+class VTK_MRML_EXPORT vtkMRMLChunkedVolumeStorageNode : public vtkMRMLStorageNode
+{
+public:
+  static vtkMRMLChunkedVolumeStorageNode *New();
+  vtkTypeMacro(vtkMRMLChunkedVolumeStorageNode, vtkMRMLStorageNode);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  vtkMRMLNode* CreateNodeInstance() override;
+
+  /// Read node attributes from XML file
+  void ReadXMLAttributes(const char** atts) override;
+
+  /// Write this node's information to a MRML file in XML format.
+  void WriteXML(ostream& of, int indent) override;
+
+  /// Copy the node's attributes to this object
+  void Copy(vtkMRMLNode *node) override;
+
+  /// Get node XML tag name (like Storage, Model)
+  const char* GetNodeTagName() override {return "ChunkedVolumeStorage";}
+
+  /// Center image on read
+  vtkGetMacro(CenterImage, bool);
+  vtkSetMacro(CenterImage, bool);
+  vtkBooleanMacro(CenterImage, bool);
+
+  /// Number of voxels along each axis of a chunk, used when writing.
+  /// Default is 64x64x64.
+  vtkSetVector3Macro(ChunkSize, int);
+  vtkGetVector3Macro(ChunkSize, int);
+
+  /// Region of the volume (in the IJK coordinate system of the file) to read.
+  /// If the extent is empty (default) then the whole volume is read.
+  /// The loaded volume's origin is adjusted so that it stays at the same
+  /// physical location.
+  vtkSetVector6Macro(ReadExtent, int);
+  vtkGetVector6Macro(ReadExtent, int);
+
+  /// Return true if the node can be read in.
+  bool CanReadInReferenceNode(vtkMRMLNode *refNode) override;
+
+  /// Configure the storage node for data exchange. This is an
+  /// opportunity to optimize the storage node's settings, for
+  /// instance to turn off compression.
+  void ConfigureForDataExchange() override;
+
+  /// Compression parameter corresponding to minimum compression (fast)
+  std::string GetCompressionParameterFastest() { return "zlib_fastest"; };
+  /// Compression parameter corresponding to normal compression
+  std::string GetCompressionParameterNormal() { return "zlib_normal"; };
+  /// Compression parameter corresponding to maximum compression (slow)
+  std::string GetCompressionParameterMinimumSize() { return "zlib_minimum_size"; };
+
+protected:
+  vtkMRMLChunkedVolumeStorageNode();
+  ~vtkMRMLChunkedVolumeStorageNode() override;
+  vtkMRMLChunkedVolumeStorageNode(const vtkMRMLChunkedVolumeStorageNode&);
+  void operator=(const vtkMRMLChunkedVolumeStorageNode&);
+
+  /// Initialize all the supported read file types
+  void InitializeSupportedReadFileTypes() override;
+
+  /// Initialize all the supported write file types
+  void InitializeSupportedWriteFileTypes() override;
+
+  /// Read data and set it in the referenced node
+  int ReadDataInternal(vtkMRMLNode *refNode) override;
+
+  /// Write data from a referenced node
+  int WriteDataInternal(vtkMRMLNode *refNode) override;
+
+  /// Convert compression parameter string to zlib compression level
+  int GetCompressionLevelFromCompressionParameter(const std::string& parameter);
+
+  bool CenterImage;
+  int ChunkSize[3];
+  int ReadExtent[6];
+};
+
+#endif
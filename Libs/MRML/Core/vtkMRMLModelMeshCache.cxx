@@ -0,0 +1,686 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLModelMeshCache.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkFieldData.h>
+#include <vtkIdTypeArray.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtksys/Directory.hxx>
+#include <vtksys/Encoding.hxx>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLModelMeshCache);
+
+namespace
+{
+
+const char CacheFileExtension[] = ".mrmlmesh";
+const char CacheMagic[8] = { 'M', 'R', 'M', 'L', 'M', 'E', 'S', 'H' };
+const vtkTypeUInt32 CacheVersion = 1;
+const vtkTypeUInt32 CacheByteOrderMark = 0x01020304;
+const vtkTypeUInt64 CacheAlignment = 64;
+
+enum SectionRole
+{
+  RolePoints = 0,
+  RoleVerts,
+  RoleLines,
+  RolePolys,
+  RoleStrips,
+  RolePointData,
+  RoleCellData
+};
+
+// All the structures written in the cache file have a size that is a
+// multiple of CacheAlignment.
+struct CacheHeader
+{
+  char Magic[8];
+  vtkTypeUInt32 Version;
+  vtkTypeUInt32 ByteOrderMark;
+  vtkTypeUInt32 IdTypeSize;
+  vtkTypeUInt32 NumberOfSections;
+  vtkTypeUInt64 SourceHash;
+  vtkTypeUInt64 SourceSize;
+  char Reserved[24];
+};
+
+struct CacheSection
+{
+  char Name[64];
+  vtkTypeInt32 Role;
+  vtkTypeInt32 DataType;
+  vtkTypeInt32 NumberOfComponents;
+  vtkTypeInt32 AttributeType;
+  vtkTypeInt64 NumberOfTuples;
+  vtkTypeInt64 NumberOfCells;
+  vtkTypeUInt64 Offset;
+  vtkTypeUInt64 ByteSize;
+  char Reserved[16];
+};
+
+//----------------------------------------------------------------------------
+vtkTypeUInt64 AlignOffset(vtkTypeUInt64 offset)
+{
+  return (offset + CacheAlignment - 1) / CacheAlignment * CacheAlignment;
+}
+
+//----------------------------------------------------------------------------
+std::string CacheFilePath(const std::string& directory, vtkTypeUInt64 hash)
+{
+  std::stringstream ss;
+  ss << std::hex;
+  ss.width(16);
+  ss.fill('0');
+  ss << hash;
+  return directory + "/" + ss.str() + CacheFileExtension;
+}
+
+//----------------------------------------------------------------------------
+// Read-only file mapped in memory with copy-on-write semantic: filters
+// modifying the arrays in place get private copies of the modified pages.
+class MappedFile
+{
+public:
+  MappedFile() = default;
+  ~MappedFile()
+  {
+#ifdef _WIN32
+    if (this->Address)
+      {
+      UnmapViewOfFile(this->Address);
+      }
+#else
+    if (this->Address)
+      {
+      munmap(this->Address, this->Length);
+      }
+#endif
+  }
+
+  bool Map(const std::string& fileName)
+  {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(vtksys::Encoding::ToWide(fileName).c_str(), GENERIC_READ,
+      FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      {
+      return false;
+      }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+      {
+      CloseHandle(file);
+      return false;
+      }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+      {
+      return false;
+      }
+    this->Address = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    this->Length = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+      {
+      return false;
+      }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+      {
+      close(fd);
+      return false;
+      }
+    this->Length = static_cast<size_t>(fileStat.st_size);
+    void* address = mmap(nullptr, this->Length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    this->Address = (address == MAP_FAILED ? nullptr : address);
+#endif
+    return this->Address != nullptr;
+  }
+
+  void* Address{nullptr};
+  size_t Length{0};
+};
+
+//----------------------------------------------------------------------------
+// Arrays referencing mapped memory keep the mapping alive. The mapping is
+// released when the last array referencing it is deleted.
+std::mutex MappedArraysMutex;
+std::map<void*, std::shared_ptr<MappedFile> > MappedArrays;
+
+//----------------------------------------------------------------------------
+void ReleaseMappedArray(void* pointer)
+{
+  std::lock_guard<std::mutex> lock(MappedArraysMutex);
+  MappedArrays.erase(pointer);
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray> CreateArray(const CacheSection& section, char* data,
+                                          const std::shared_ptr<MappedFile>& mapping)
+{
+  vtkSmartPointer<vtkDataArray> array = vtkSmartPointer<vtkDataArray>::Take(
+    vtkDataArray::CreateDataArray(section.DataType));
+  if (!array || array->GetDataTypeSize() * section.NumberOfComponents * section.NumberOfTuples
+      != static_cast<vtkTypeInt64>(section.ByteSize))
+    {
+    return nullptr;
+    }
+  array->SetNumberOfComponents(section.NumberOfComponents);
+  if (strlen(section.Name) > 0)
+    {
+    array->SetName(section.Name);
+    }
+  vtkIdType numberOfValues = static_cast<vtkIdType>(section.NumberOfTuples * section.NumberOfComponents);
+  if (mapping && numberOfValues > 0)
+    {
+    void* pointer = data + section.Offset;
+      {
+      std::lock_guard<std::mutex> lock(MappedArraysMutex);
+      MappedArrays[pointer] = mapping;
+      }
+    array->SetArrayFreeFunction(ReleaseMappedArray);
+    array->SetVoidArray(pointer, numberOfValues, 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+    }
+  else
+    {
+    array->SetNumberOfTuples(section.NumberOfTuples);
+    if (section.ByteSize > 0)
+      {
+      memcpy(array->GetVoidPointer(0), data + section.Offset, section.ByteSize);
+      }
+    }
+  return array;
+}
+
+//----------------------------------------------------------------------------
+bool AddArraySection(std::vector<CacheSection>& sections, std::vector<vtkDataArray*>& arrays,
+                     vtkDataArray* array, int role, int attributeType, vtkIdType numberOfCells)
+{
+  if (!array)
+    {
+    return true;
+    }
+  CacheSection section;
+  memset(&section, 0, sizeof(section));
+  if (array->GetName())
+    {
+    if (strlen(array->GetName()) >= sizeof(section.Name))
+      {
+      // name would be truncated
+      return false;
+      }
+    strncpy(section.Name, array->GetName(), sizeof(section.Name) - 1);
+    }
+  section.Role = role;
+  section.DataType = array->GetDataType();
+  section.NumberOfComponents = array->GetNumberOfComponents();
+  section.AttributeType = attributeType;
+  section.NumberOfTuples = array->GetNumberOfTuples();
+  section.NumberOfCells = numberOfCells;
+  section.ByteSize = static_cast<vtkTypeUInt64>(array->GetDataTypeSize())
+    * array->GetNumberOfComponents() * array->GetNumberOfTuples();
+  sections.push_back(section);
+  arrays.push_back(array);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool AddAttributeSections(std::vector<CacheSection>& sections, std::vector<vtkDataArray*>& arrays,
+                          vtkDataSetAttributes* attributes, int role)
+{
+  for (int arrayIndex = 0; arrayIndex < attributes->GetNumberOfArrays(); ++arrayIndex)
+    {
+    vtkDataArray* array = attributes->GetArray(arrayIndex);
+    if (!array)
+      {
+      return false;
+      }
+    if (!AddArraySection(sections, arrays, array, role, attributes->IsArrayAnAttribute(arrayIndex), 0))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkMRMLModelMeshCache::vtkMRMLModelMeshCache()
+{
+  this->MaximumCacheSize = 0;
+  this->MemoryMapping = true;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLModelMeshCache::~vtkMRMLModelMeshCache() = default;
+
+//----------------------------------------------------------------------------
+void vtkMRMLModelMeshCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "CacheDirectory: " << this->CacheDirectory << "\n";
+  os << indent << "MaximumCacheSize: " << this->MaximumCacheSize << "\n";
+  os << indent << "MemoryMapping: " << this->MemoryMapping << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLModelMeshCache::SetCacheDirectory(const std::string& directory)
+{
+  if (this->CacheDirectory == directory)
+    {
+    return;
+    }
+  this->CacheDirectory = directory;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLModelMeshCache::GetCacheDirectory()const
+{
+  return this->CacheDirectory;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLModelMeshCache::ComputeFileHash(const std::string& fileName, vtkTypeUInt64& hash, vtkTypeUInt64& size)
+{
+  vtksys::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    {
+    return false;
+    }
+  // 64-bit FNV-1a
+  hash = 14695981039346656037ULL;
+  size = 0;
+  std::vector<char> buffer(1 << 20);
+  while (file)
+    {
+    file.read(buffer.data(), buffer.size());
+    std::streamsize count = file.gcount();
+    for (std::streamsize i = 0; i < count; ++i)
+      {
+      hash ^= static_cast<unsigned char>(buffer[i]);
+      hash *= 1099511628211ULL;
+      }
+    size += static_cast<vtkTypeUInt64>(count);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLModelMeshCache::GetCacheFilePath(const std::string& sourceFileName)
+{
+  vtkTypeUInt64 hash = 0;
+  vtkTypeUInt64 size = 0;
+  if (this->CacheDirectory.empty() || !vtkMRMLModelMeshCache::ComputeFileHash(sourceFileName, hash, size))
+    {
+    return std::string();
+    }
+  return CacheFilePath(this->CacheDirectory, hash);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLModelMeshCache::CanCacheMesh(vtkPolyData* mesh)
+{
+  if (!mesh || !mesh->GetPoints() || mesh->GetNumberOfPoints() == 0)
+    {
+    return false;
+    }
+  if (mesh->GetFieldData() && mesh->GetFieldData()->GetNumberOfArrays() > 0)
+    {
+    return false;
+    }
+  vtkDataSetAttributes* attributes[2] = { mesh->GetPointData(), mesh->GetCellData() };
+  for (int i = 0; i < 2; ++i)
+    {
+    for (int arrayIndex = 0; arrayIndex < attributes[i]->GetNumberOfArrays(); ++arrayIndex)
+      {
+      // only numeric arrays can be mapped
+      if (!attributes[i]->GetArray(arrayIndex))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLModelMeshCache::WriteMesh(const std::string& sourceFileName, vtkPolyData* mesh)
+{
+  if (!vtkMRMLModelMeshCache::CanCacheMesh(mesh))
+    {
+    return false;
+    }
+  vtkTypeUInt64 hash = 0;
+  vtkTypeUInt64 size = 0;
+  if (this->CacheDirectory.empty() || !vtkMRMLModelMeshCache::ComputeFileHash(sourceFileName, hash, size))
+    {
+    return false;
+    }
+
+  std::vector<CacheSection> sections;
+  std::vector<vtkDataArray*> arrays;
+  bool success = AddArraySection(sections, arrays, mesh->GetPoints()->GetData(), RolePoints, -1, 0);
+  vtkCellArray* cellArrays[4] = { mesh->GetVerts(), mesh->GetLines(), mesh->GetPolys(), mesh->GetStrips() };
+  int cellRoles[4] = { RoleVerts, RoleLines, RolePolys, RoleStrips };
+  for (int i = 0; i < 4 && success; ++i)
+    {
+    if (cellArrays[i] && cellArrays[i]->GetNumberOfCells() > 0)
+      {
+      success = AddArraySection(sections, arrays, cellArrays[i]->GetData(), cellRoles[i], -1,
+                                cellArrays[i]->GetNumberOfCells());
+      }
+    }
+  success = success && AddAttributeSections(sections, arrays, mesh->GetPointData(), RolePointData);
+  success = success && AddAttributeSections(sections, arrays, mesh->GetCellData(), RoleCellData);
+  if (!success)
+    {
+    return false;
+    }
+
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+  header.Version = CacheVersion;
+  header.ByteOrderMark = CacheByteOrderMark;
+  header.IdTypeSize = sizeof(vtkIdType);
+  header.NumberOfSections = static_cast<vtkTypeUInt32>(sections.size());
+  header.SourceHash = hash;
+  header.SourceSize = size;
+
+  vtkTypeUInt64 offset = AlignOffset(sizeof(CacheHeader) + sections.size() * sizeof(CacheSection));
+  for (CacheSection& section : sections)
+    {
+    section.Offset = offset;
+    offset = AlignOffset(offset + section.ByteSize);
+    }
+
+  vtksys::SystemTools::MakeDirectory(this->CacheDirectory);
+  std::string cacheFileName = CacheFilePath(this->CacheDirectory, hash);
+  // Write into a temporary file to never leave a partially written cache file
+  std::string temporaryFileName = cacheFileName + ".tmp";
+  {
+    vtksys::ofstream file(temporaryFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+      {
+      vtkWarningMacro("WriteMesh: failed to write cache file " << temporaryFileName);
+      return false;
+      }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(CacheSection));
+    const char padding[CacheAlignment] = { 0 };
+    for (size_t i = 0; i < sections.size(); ++i)
+      {
+      vtkTypeUInt64 position = static_cast<vtkTypeUInt64>(file.tellp());
+      file.write(padding, static_cast<std::streamsize>(sections[i].Offset - position));
+      file.write(static_cast<const char*>(arrays[i]->GetVoidPointer(0)),
+                 static_cast<std::streamsize>(sections[i].ByteSize));
+      }
+    if (!file.good())
+      {
+      file.close();
+      vtksys::SystemTools::RemoveFile(temporaryFileName);
+      vtkWarningMacro("WriteMesh: failed to write cache file " << temporaryFileName);
+      return false;
+      }
+  }
+  vtksys::SystemTools::RemoveFile(cacheFileName);
+  if (!vtksys::SystemTools::RenameFile(temporaryFileName.c_str(), cacheFileName.c_str()))
+    {
+    vtksys::SystemTools::RemoveFile(temporaryFileName);
+    return false;
+    }
+  this->LastCacheFilePath = cacheFileName;
+  this->PruneCache();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLModelMeshCache::ReadMesh(const std::string& sourceFileName, vtkPolyData* output)
+{
+  if (!output)
+    {
+    return false;
+    }
+  vtkTypeUInt64 hash = 0;
+  vtkTypeUInt64 size = 0;
+  if (this->CacheDirectory.empty() || !vtkMRMLModelMeshCache::ComputeFileHash(sourceFileName, hash, size))
+    {
+    return false;
+    }
+  std::string cacheFileName = CacheFilePath(this->CacheDirectory, hash);
+  if (!vtksys::SystemTools::FileExists(cacheFileName, true))
+    {
+    return false;
+    }
+
+  std::shared_ptr<MappedFile> mapping;
+  std::vector<char> buffer;
+  char* data = nullptr;
+  vtkTypeUInt64 dataLength = 0;
+  if (this->MemoryMapping)
+    {
+    mapping = std::make_shared<MappedFile>();
+    if (mapping->Map(cacheFileName))
+      {
+      data = static_cast<char*>(mapping->Address);
+      dataLength = mapping->Length;
+      }
+    else
+      {
+      mapping.reset();
+      }
+    }
+  if (!data)
+    {
+    vtksys::ifstream file(cacheFileName.c_str(), std::ios::in | std::ios::binary);
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    dataLength = buffer.size();
+    }
+
+  // Validate header and section table
+  if (dataLength < sizeof(CacheHeader))
+    {
+    return false;
+    }
+  const CacheHeader* header = reinterpret_cast<const CacheHeader*>(data);
+  if (memcmp(header->Magic, CacheMagic, sizeof(CacheMagic)) != 0
+    || header->Version != CacheVersion
+    || header->ByteOrderMark != CacheByteOrderMark
+    || header->IdTypeSize != sizeof(vtkIdType)
+    || header->SourceHash != hash
+    || header->SourceSize != size
+    || dataLength < sizeof(CacheHeader) + header->NumberOfSections * sizeof(CacheSection))
+    {
+    vtkDebugMacro("ReadMesh: ignoring incompatible cache file " << cacheFileName);
+    return false;
+    }
+  const CacheSection* sections = reinterpret_cast<const CacheSection*>(data + sizeof(CacheHeader));
+
+  vtkNew<vtkPolyData> mesh;
+  for (vtkTypeUInt32 i = 0; i < header->NumberOfSections; ++i)
+    {
+    CacheSection section = sections[i];
+    section.Name[sizeof(section.Name) - 1] = '\0';
+    if (section.Offset + section.ByteSize > dataLength)
+      {
+      return false;
+      }
+    vtkSmartPointer<vtkDataArray> array = CreateArray(section, data, mapping);
+    if (!array)
+      {
+      return false;
+      }
+    switch (section.Role)
+      {
+      case RolePoints:
+        {
+        vtkNew<vtkPoints> points;
+        points->SetData(array);
+        mesh->SetPoints(points.GetPointer());
+        break;
+        }
+      case RoleVerts:
+      case RoleLines:
+      case RolePolys:
+      case RoleStrips:
+        {
+        vtkIdTypeArray* ids = vtkIdTypeArray::SafeDownCast(array);
+        if (!ids)
+          {
+          return false;
+          }
+        vtkNew<vtkCellArray> cells;
+        cells->SetCells(section.NumberOfCells, ids);
+        if (section.Role == RoleVerts) { mesh->SetVerts(cells.GetPointer()); }
+        else if (section.Role == RoleLines) { mesh->SetLines(cells.GetPointer()); }
+        else if (section.Role == RolePolys) { mesh->SetPolys(cells.GetPointer()); }
+        else { mesh->SetStrips(cells.GetPointer()); }
+        break;
+        }
+      case RolePointData:
+      case RoleCellData:
+        {
+        vtkDataSetAttributes* attributes = (section.Role == RolePointData ?
+          static_cast<vtkDataSetAttributes*>(mesh->GetPointData()) :
+          static_cast<vtkDataSetAttributes*>(mesh->GetCellData()));
+        int arrayIndex = attributes->AddArray(array);
+        if (section.AttributeType >= 0)
+          {
+          attributes->SetActiveAttribute(arrayIndex, section.AttributeType);
+          }
+        break;
+        }
+      default:
+        return false;
+      }
+    }
+
+  output->ShallowCopy(mesh.GetPointer());
+
+  // Mark the cache file as recently used
+  vtksys::SystemTools::Touch(cacheFileName, false);
+  this->LastCacheFilePath = cacheFileName;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLModelMeshCache::PruneCache()
+{
+  if (this->MaximumCacheSize <= 0 || this->CacheDirectory.empty())
+    {
+    return;
+    }
+  vtksys::Directory directory;
+  if (!directory.Load(this->CacheDirectory))
+    {
+    return;
+    }
+  struct CacheFile
+  {
+    std::string Path;
+    unsigned long Size;
+    long ModifiedTime;
+  };
+  std::vector<CacheFile> files;
+  unsigned long long totalSize = 0;
+  for (unsigned long i = 0; i < directory.GetNumberOfFiles(); ++i)
+    {
+    std::string fileName = directory.GetFile(i);
+    if (vtksys::SystemTools::GetFilenameLastExtension(fileName) != CacheFileExtension)
+      {
+      continue;
+      }
+    CacheFile file;
+    file.Path = this->CacheDirectory + "/" + fileName;
+    file.Size = vtksys::SystemTools::FileLength(file.Path);
+    file.ModifiedTime = vtksys::SystemTools::ModifiedTime(file.Path);
+    totalSize += file.Size;
+    files.push_back(file);
+    }
+  unsigned long long maximumSize = static_cast<unsigned long long>(this->MaximumCacheSize) * 1024 * 1024;
+  if (totalSize <= maximumSize)
+    {
+    return;
+    }
+  std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b)
+    { return a.ModifiedTime < b.ModifiedTime; });
+  for (const CacheFile& file : files)
+    {
+    if (totalSize <= maximumSize)
+      {
+      break;
+      }
+    // Files currently mapped stay valid until unmapped (POSIX) or can not be
+    // removed (Windows), in both cases it is safe to attempt removal.
+    if (vtksys::SystemTools::RemoveFile(file.Path))
+      {
+      totalSize -= file.Size;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLModelMeshCache::ClearCache()
+{
+  vtksys::Directory directory;
+  if (this->CacheDirectory.empty() || !directory.Load(this->CacheDirectory))
+    {
+    return;
+    }
+  for (unsigned long i = 0; i < directory.GetNumberOfFiles(); ++i)
+    {
+    std::string fileName = directory.GetFile(i);
+    if (vtksys::SystemTools::GetFilenameLastExtension(fileName) == CacheFileExtension)
+      {
+      vtksys::SystemTools::RemoveFile(this->CacheDirectory + "/" + fileName);
+      }
+    }
+}
@@ -0,0 +1,110 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLModelMeshCache_h
+#define __vtkMRMLModelMeshCache_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+class vtkPolyData;
+
+// STD includes
+#include <string>
+
+/// \brief Binary cache of the meshes read by vtkMRMLModelStorageNode.
+///
+/// Parsing text mesh formats (STL, OBJ, PLY, legacy VTK) of dense meshes is
+/// slow. This class stores the parsed vtkPolyData in a flat binary layout:
+/// points, cell arrays and point/cell data arrays are written one after the
+/// other, each aligned on a 64-byte boundary. When the same file content is
+/// read again, the cache file is memory mapped (copy-on-write) and the VTK
+/// arrays directly reference the mapped memory, no parsing or copy is needed.
+///
+/// Cache files are keyed on a hash of the content of the source file, they
+/// are stored in \a CacheDirectory (typically a subdirectory of the
+/// vtkCacheManager remote cache directory). Least recently used cache files
+/// are removed when the total size exceeds \a MaximumCacheSize.
+///
+/// Only polydata with numeric point and cell data arrays (and without field
+/// data) can be cached.
+/// \sa vtkMRMLModelStorageNode::SetUseMeshCache()
+class VTK_MRML_EXPORT vtkMRMLModelMeshCache : public vtkObject
+{
+public:
+  static vtkMRMLModelMeshCache *New();
+  vtkTypeMacro(vtkMRMLModelMeshCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Directory where cache files are stored. It is created if needed.
+  void SetCacheDirectory(const std::string& directory);
+  std::string GetCacheDirectory()const;
+
+  /// Maximum total size of the cache files in MB. 0 means no limit.
+  /// Default is 0: vtkMRMLModelStorageNode registers the cache files in
+  /// the vtkCacheManager index and lets the cache manager evict them.
+  vtkSetMacro(MaximumCacheSize, int);
+  vtkGetMacro(MaximumCacheSize, int);
+
+  /// Enable/disable memory mapping of the cache files. When disabled, the
+  /// content of the cache file is read into newly allocated arrays.
+  /// Enabled by default.
+  vtkSetMacro(MemoryMapping, bool);
+  vtkGetMacro(MemoryMapping, bool);
+  vtkBooleanMacro(MemoryMapping, bool);
+
+  /// Read the mesh cached for \a sourceFileName into \a output.
+  /// Return false if there is no valid cache file for the current content
+  /// of the source file.
+  bool ReadMesh(const std::string& sourceFileName, vtkPolyData* output);
+
+  /// Write \a mesh into the cache, associated with the current content of
+  /// \a sourceFileName. Return false if the mesh can not be cached.
+  bool WriteMesh(const std::string& sourceFileName, vtkPolyData* mesh);
+
+  /// Return true if \a mesh only contains data that can be cached.
+  static bool CanCacheMesh(vtkPolyData* mesh);
+
+  /// Return the path of the cache file associated with the current content
+  /// of \a sourceFileName. Empty if the file can not be read.
+  std::string GetCacheFilePath(const std::string& sourceFileName);
+
+  /// Return the path of the cache file read or written by the last
+  /// successful ReadMesh() or WriteMesh() call.
+  const std::string& GetLastCacheFilePath() const { return this->LastCacheFilePath; }
+
+  /// Compute a 64-bit FNV-1a hash of the content of a file.
+  /// Return false if the file can not be read.
+  static bool ComputeFileHash(const std::string& fileName, vtkTypeUInt64& hash, vtkTypeUInt64& size);
+
+  /// Remove least recently used cache files until the total size is below
+  /// \a MaximumCacheSize.
+  void PruneCache();
+
+  /// Remove all the cache files.
+  void ClearCache();
+
+protected:
+  vtkMRMLModelMeshCache();
+  ~vtkMRMLModelMeshCache() override;
+  vtkMRMLModelMeshCache(const vtkMRMLModelMeshCache&);
+  void operator=(const vtkMRMLModelMeshCache&);
+
+  std::string CacheDirectory;
+  std::string LastCacheFilePath;
+  int MaximumCacheSize;
+  bool MemoryMapping;
+};
+
+#endif
@@ -12,7 +12,9 @@
 
 =========================================================================auto=*/
 
+#include "vtkCacheManager.h"
 #include "vtkMRMLDisplayNode.h"
+#include "vtkMRMLModelMeshCache.h"
 #include "vtkMRMLModelNode.h"
 #include "vtkMRMLModelStorageNode.h"
 #include "vtkMRMLScene.h"
@@ -27,6 +29,7 @@
 #include <vtkObjectFactory.h>
 #include <vtkOBJReader.h>
 #include <vtkOBJExporter.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkPLYReader.h>
 #include <vtkPLYWriter.h>
@@ -90,6 +93,7 @@ vtkMRMLNodeNewMacro(vtkMRMLModelStorageNode);
 vtkMRMLModelStorageNode::vtkMRMLModelStorageNode()
 {
   this->DefaultWriteFileExtension = "vtk";
+  this->UseMeshCache = false;
 }
 
 //----------------------------------------------------------------------------
@@ -100,6 +104,7 @@ vtkMRMLModelStorageNode::~vtkMRMLModelStorageNode()
 void vtkMRMLModelStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   vtkMRMLStorageNode::PrintSelf(os,indent);
+  os << indent << "UseMeshCache: " << this->UseMeshCache << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -113,6 +118,21 @@ void vtkMRMLModelStorageNode::WriteXML(ostream& of, int nIndent)
   of << " coordinateSystem=\"RAS\"";
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLModelStorageNode::Copy(vtkMRMLNode *anode)
+{
+  int disabledModify = this->StartModify();
+
+  Superclass::Copy(anode);
+  vtkMRMLModelStorageNode *node = vtkMRMLModelStorageNode::SafeDownCast(anode);
+  if (node)
+    {
+    this->SetUseMeshCache(node->UseMeshCache);
+    }
+
+  this->EndModify(disabledModify);
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLModelStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
 {
@@ -148,10 +168,18 @@ int vtkMRMLModelStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
   vtkDebugMacro("ReadDataInternal: extension = " << extension.c_str());
 
+  bool useMeshCache = this->UseMeshCache
+    && vtkMRMLModelStorageNode::IsMeshCacheSupportedExtension(extension);
+  bool meshReadFromCache = useMeshCache && this->ReadMeshFromCache(modelNode, fullName);
+
   int result = 1;
   try
     {
-    if ( extension == std::string(".g") || extension == std::string(".byu") )
+    if (meshReadFromCache)
+      {
+      vtkDebugMacro("ReadDataInternal: mesh read from cache for " << fullName.c_str());
+      }
+    else if ( extension == std::string(".g") || extension == std::string(".byu") )
       {
       vtkNew<vtkBYUReader> reader;
       reader->SetGeometryFileName(fullName.c_str());
@@ -302,6 +330,11 @@ int vtkMRMLModelStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     result = 0;
     }
 
+  if (result && useMeshCache && !meshReadFromCache)
+    {
+    this->WriteMeshToCache(modelNode, fullName);
+    }
+
   if (modelNode->GetMesh() != nullptr)
     {
     // is there an active scalar array?
@@ -320,6 +353,73 @@ int vtkMRMLModelStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
   return result;
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLModelStorageNode::IsMeshCacheSupportedExtension(const std::string& extension)
+{
+  // Only formats that require slow parsing benefit from the cache
+  return extension == ".stl" || extension == ".obj" || extension == ".ply" || extension == ".vtk";
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLModelStorageNode::GetMeshCacheDirectory()
+{
+  if (!this->GetScene() || !this->GetScene()->GetCacheManager()
+    || !this->GetScene()->GetCacheManager()->GetRemoteCacheDirectory())
+    {
+    return std::string();
+    }
+  std::string remoteCacheDirectory = this->GetScene()->GetCacheManager()->GetRemoteCacheDirectory();
+  if (remoteCacheDirectory.empty())
+    {
+    return std::string();
+    }
+  return remoteCacheDirectory + "/ModelMeshCache";
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLModelStorageNode::ReadMeshFromCache(vtkMRMLModelNode* modelNode, const std::string& fileName)
+{
+  std::string cacheDirectory = this->GetMeshCacheDirectory();
+  if (!modelNode || cacheDirectory.empty())
+    {
+    return false;
+    }
+  vtkNew<vtkMRMLModelMeshCache> meshCache;
+  meshCache->SetCacheDirectory(cacheDirectory);
+  vtkNew<vtkPolyData> mesh;
+  if (!meshCache->ReadMesh(fileName, mesh.GetPointer()))
+    {
+    return false;
+    }
+  // Mark the cache file as recently used (and index it if it was not yet)
+  this->GetScene()->GetCacheManager()->AddToCacheIndex(meshCache->GetLastCacheFilePath().c_str());
+  modelNode->SetAndObservePolyData(mesh.GetPointer());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLModelStorageNode::WriteMeshToCache(vtkMRMLModelNode* modelNode, const std::string& fileName)
+{
+  std::string cacheDirectory = this->GetMeshCacheDirectory();
+  if (!modelNode || cacheDirectory.empty()
+    || modelNode->GetMeshType() != vtkMRMLModelNode::PolyDataMeshType
+    || !vtkMRMLModelMeshCache::CanCacheMesh(modelNode->GetPolyData()))
+    {
+    return;
+    }
+  vtkNew<vtkMRMLModelMeshCache> meshCache;
+  meshCache->SetCacheDirectory(cacheDirectory);
+  if (!meshCache->WriteMesh(fileName, modelNode->GetPolyData()))
+    {
+    vtkDebugMacro("WriteMeshToCache: failed to cache mesh of " << fileName.c_str());
+    return;
+    }
+  // Cache files are evicted by the cache manager, along with downloaded files
+  vtkCacheManager* cacheManager = this->GetScene()->GetCacheManager();
+  cacheManager->AddToCacheIndex(meshCache->GetLastCacheFilePath().c_str());
+  cacheManager->EnforceCacheLimit();
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLModelStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
 {
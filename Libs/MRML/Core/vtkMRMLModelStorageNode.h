@@ -38,9 +38,31 @@ public:
   /// Write this node's information to a MRML file in XML format.
   void WriteXML(ostream& of, int indent) override;
 
+  /// Copy the node's attributes to this object
+  void Copy(vtkMRMLNode *node) override;
+
   /// Return true if the reference node can be read in
   bool CanReadInReferenceNode(vtkMRMLNode *refNode) override;
 
+  /// Enable/disable the binary mesh cache. When enabled, meshes read from
+  /// STL, OBJ, PLY and legacy VTK files are stored in a binary cache in the
+  /// cache manager directory, and the next time the same file content is
+  /// read the cached mesh is memory mapped instead of parsing the file.
+  /// This is a per-application setting, it is not saved in the scene:
+  /// the Models module sets it on the scene default model storage node.
+  /// Cache files are added to the cache manager index, they are evicted
+  /// with the other cached files when RemoteCacheLimit is exceeded.
+  /// Disabled by default.
+  /// \sa vtkMRMLModelMeshCache
+  vtkSetMacro(UseMeshCache, bool);
+  vtkGetMacro(UseMeshCache, bool);
+  vtkBooleanMacro(UseMeshCache, bool);
+
+  /// Return the directory where the binary mesh cache files are stored:
+  /// "ModelMeshCache" subdirectory of the scene cache manager remote cache
+  /// directory. Empty if there is no scene or cache manager.
+  std::string GetMeshCacheDirectory();
+
 protected:
   vtkMRMLModelStorageNode();
   ~vtkMRMLModelStorageNode() override;
@@ -62,6 +84,18 @@ protected:
   /// Write data from a  referenced node
   int WriteDataInternal(vtkMRMLNode *refNode) override;
 
+  /// Return true if meshes read from files with \a extension can be cached.
+  static bool IsMeshCacheSupportedExtension(const std::string& extension);
+
+  /// Read the mesh cached for \a fileName into \a modelNode.
+  /// Return false if there is no valid cached mesh.
+  bool ReadMeshFromCache(vtkMRMLModelNode* modelNode, const std::string& fileName);
+
+  /// Store the mesh of \a modelNode that was read from \a fileName in the cache.
+  void WriteMeshToCache(vtkMRMLModelNode* modelNode, const std::string& fileName);
+
+  bool UseMeshCache;
+
 };
 
 #endif
@@ -23,6 +23,7 @@ Version:   $Revision: 1.18 $
 #include "vtkMRMLCameraNode.h"
 #include "vtkMRMLChartNode.h"
 #include "vtkMRMLChartViewNode.h"
+#include "vtkMRMLChunkedVolumeStorageNode.h"
 #include "vtkMRMLClipModelsNode.h"
 #include "vtkMRMLColorTableStorageNode.h"
 #include "vtkMRMLCrosshairNode.h"
@@ -179,6 +180,7 @@ vtkMRMLScene::vtkMRMLScene()
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLSelectionNode >::New() );
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLSliceNode >::New() );
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLVolumeArchetypeStorageNode >::New() );
+  this->RegisterNodeClass( vtkSmartPointer< vtkMRMLChunkedVolumeStorageNode >::New() );
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLScalarVolumeDisplayNode >::New() );
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLLabelMapVolumeDisplayNode >::New() );
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLLabelMapVolumeNode >::New() );
@@ -525,6 +527,12 @@ void vtkMRMLScene::RegisterNodeClass(vtkMRMLNode* node, const char* tagName)
     {
     if (this->RegisteredNodeTags[i] == xmlTag)
       {
+      // Node classes may be registered both by a module and by its logic,
+      // registering the same class again is a no-op.
+      if (strcmp(this->RegisteredNodeClasses[i]->GetClassName(), node->GetClassName()) == 0)
+        {
+        return;
+        }
       vtkWarningMacro("Tag " << tagName
                       << " has already been registered, unregistering previous node class "
                       << (this->RegisteredNodeClasses[i]->GetClassName() ? this->RegisteredNodeClasses[i]->GetClassName() : "(no class name)")
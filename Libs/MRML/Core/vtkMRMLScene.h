@@ -136,6 +136,8 @@ public:
   /// \a tagName can be 0 or an XML tag a custom tagName.
   /// If \a tagName is 0 (default), the \a node GetNodeTagName() is used.
   /// Otherwise, tagName is used.
+  /// A class registered with another class' tag replaces it, registering the
+  /// same class again for the same tag does nothing.
   ///
   /// The signature with tagName != 0 is useful to add support for
   /// scene backward compatibility. Calls with an obsolete tag should be
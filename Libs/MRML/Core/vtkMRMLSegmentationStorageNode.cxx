@@ -32,12 +32,15 @@
 #include "vtkMRMLSegmentationDisplayNode.h"
 
 // VTK includes
+#include <vtkChunkedImageReader.h>
+#include <vtkChunkedImageWriter.h>
 #include <vtkDataObject.h>
 #include <vtkDoubleArray.h>
 #include <vtkErrorCode.h>
 #include <vtkFieldData.h>
 #include <vtkImageAccumulate.h>
 #include <vtkImageAppendComponents.h>
+#include <vtkImageChangeInformation.h>
 #include <vtkImageCast.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageExtractComponents.h>
@@ -147,6 +150,7 @@ void vtkMRMLSegmentationStorageNode::InitializeSupportedReadFileTypes()
 {
   this->SupportedReadFileTypes->InsertNextValue("Segmentation (.seg.nrrd)");
   this->SupportedReadFileTypes->InsertNextValue("Segmentation (.seg.vtm)");
+  this->SupportedReadFileTypes->InsertNextValue("Segmentation (.seg.cvol)");
   this->SupportedReadFileTypes->InsertNextValue("Segmentation (.nrrd)");
   this->SupportedReadFileTypes->InsertNextValue("Segmentation (.vtm)");
   this->SupportedReadFileTypes->InsertNextValue("Segmentation (.nii.gz)");
@@ -177,6 +181,7 @@ void vtkMRMLSegmentationStorageNode::InitializeSupportedWriteFileTypes()
     {
     this->SupportedWriteFileTypes->InsertNextValue("Segmentation (.seg.nrrd)");
     this->SupportedWriteFileTypes->InsertNextValue("Segmentation (.nrrd)");
+    this->SupportedWriteFileTypes->InsertNextValue("Segmentation (.seg.cvol)");
     }
   if (masterIsPolyData)
     {
@@ -532,30 +537,53 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
   int numberOfSegments = 0;
   std::map<int, std::vector<int> > segmentIndexInLayer;
   std::string containedRepresentationNames;
-  vtkMatrix4x4* rasToFileIjk = nullptr;
+  vtkNew<vtkChunkedImageReader> chunkedImageReader;
+  vtkNew<vtkMatrix4x4> rasToFileIjk;
   int imageExtentInFile[6] = { 0, -1, 0, -1, 0, -1 };
   int commonGeometryExtent[6] = { 0, -1, 0, -1, 0, -1 };
   int referenceImageExtentOffset[3] = { 0, 0, 0 };
+  itk::MetaDataDictionary dictionary;
 
-  if (archetypeImageReader->CanReadFile(path.c_str()))
+  bool chunkedFile = vtkChunkedImageReader::CanReadFile(path.c_str());
+  if (chunkedFile || archetypeImageReader->CanReadFile(path.c_str()))
     {
     // Read the volume
-    archetypeImageReader->Update();
-    if (archetypeImageReader->GetErrorCode() != vtkErrorCode::NoError)
+    if (chunkedFile)
       {
-      vtkErrorMacro("ReadBinaryLabelmapRepresentation: Error reading image!");
-      return 0;
+      // Chunks are decompressed in parallel
+      chunkedImageReader->SetFileName(path.c_str());
+      chunkedImageReader->Update();
+      if (chunkedImageReader->GetErrorCode() != vtkErrorCode::NoError)
+        {
+        vtkErrorMacro("ReadBinaryLabelmapRepresentation: Error reading image!");
+        return 0;
+        }
+      imageData = chunkedImageReader->GetOutput();
+      vtkMatrix4x4::Invert(chunkedImageReader->GetIJKToRASMatrix(), rasToFileIjk.GetPointer());
+      std::vector<std::string> keys = chunkedImageReader->GetMetaDataKeys();
+      for (std::vector<std::string>::iterator keyIt = keys.begin(); keyIt != keys.end(); ++keyIt)
+        {
+        itk::EncapsulateMetaData<std::string>(dictionary, *keyIt, chunkedImageReader->GetMetaDataValue(*keyIt));
+        }
+      }
+    else
+      {
+      archetypeImageReader->Update();
+      if (archetypeImageReader->GetErrorCode() != vtkErrorCode::NoError)
+        {
+        vtkErrorMacro("ReadBinaryLabelmapRepresentation: Error reading image!");
+        return 0;
+        }
+      imageData = archetypeImageReader->GetOutput();
+      rasToFileIjk->DeepCopy(archetypeImageReader->GetRasToIjkMatrix());
+      // Get metadata dictionary from image
+      dictionary = archetypeImageReader->GetMetaDataDictionary();
       }
 
     // Copy image data to sequence of volume nodes
-    imageData = archetypeImageReader->GetOutput();
-    rasToFileIjk = archetypeImageReader->GetRasToIjkMatrix();
     imageData->GetExtent(imageExtentInFile);
     imageData->GetExtent(commonGeometryExtent);
 
-    // Get metadata dictionary from image
-    itk::MetaDataDictionary dictionary = archetypeImageReader->GetMetaDataDictionary();
-
     // Read common geometry
     std::string referenceImageExtentOffsetStr;
     if (this->GetSegmentationMetaDataFromDicitionary(referenceImageExtentOffsetStr, dictionary, KEY_SEGMENTATION_REFERENCE_IMAGE_EXTENT_OFFSET))
@@ -650,7 +678,7 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
   fileIjkToIjk->SetElement(1, 3, referenceImageExtentOffset[1]);
   fileIjkToIjk->SetElement(2, 3, referenceImageExtentOffset[2]);
   vtkNew<vtkMatrix4x4> rasToIjk;
-  vtkMatrix4x4::Multiply4x4(fileIjkToIjk.GetPointer(), rasToFileIjk, rasToIjk.GetPointer());
+  vtkMatrix4x4::Multiply4x4(fileIjkToIjk.GetPointer(), rasToFileIjk.GetPointer(), rasToIjk.GetPointer());
   vtkNew<vtkMatrix4x4> imageToWorldMatrix; // = ijkToRas;
   vtkMatrix4x4::Invert(rasToIjk.GetPointer(), imageToWorldMatrix.GetPointer());
 
@@ -661,9 +689,6 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
   vtkNew<vtkImageConstantPad> padder;
   padder->SetInputConnection(extractComponents->GetOutputPort());
 
-  // Get metadata for current segment
-  itk::MetaDataDictionary dictionary = archetypeImageReader->GetMetaDataDictionary();
-
   std::vector<vtkSmartPointer<vtkSegment> > segments(numberOfSegments);
   std::map<int, vtkSmartPointer<vtkOrientedImageData> > layerToImage;
   for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
@@ -1152,20 +1177,15 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
     }
   vtkOrientedImageDataResample::FillImage(commonGeometryImage, 0);
 
-  vtkNew<vtkTeemNRRDWriter> writer;
-  writer->SetFileName(fullName.c_str());
-  writer->SetUseCompression(this->GetUseCompression());
-  writer->SetSpace(nrrdSpaceLeftPosteriorSuperior);
-  writer->SetMeasurementFrameMatrix(nullptr);
-
   // Create metadata dictionary
+  std::map<std::string, std::string> headerAttributes;
 
   // Save extent start of common geometry image so that we can restore original extents when reading from file
-  //writer->SetAttribute(GetSegmentationMetaDataKey(KEY_SEGMENTATION_EXTENT).c_str(), GetImageExtentAsString(commonGeometryImage));
+  //headerAttributes[GetSegmentationMetaDataKey(KEY_SEGMENTATION_EXTENT)] = GetImageExtentAsString(commonGeometryImage);
   int referenceImageExtentOffset[3] = { commonGeometryExtent[0], commonGeometryExtent[2], commonGeometryExtent[4] };
   std::stringstream ssReferenceImageExtentOffset;
   ssReferenceImageExtentOffset << referenceImageExtentOffset[0] << " " << referenceImageExtentOffset[1] << " " << referenceImageExtentOffset[2];
-  writer->SetAttribute(GetSegmentationMetaDataKey(KEY_SEGMENTATION_REFERENCE_IMAGE_EXTENT_OFFSET).c_str(), ssReferenceImageExtentOffset.str());
+  headerAttributes[GetSegmentationMetaDataKey(KEY_SEGMENTATION_REFERENCE_IMAGE_EXTENT_OFFSET)] = ssReferenceImageExtentOffset.str();
 
   vtkNew<vtkMatrix4x4> rasToIjk;
   commonGeometryImage->GetWorldToImageMatrix(rasToIjk.GetPointer());
@@ -1178,17 +1198,15 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
   vtkMatrix4x4::Multiply4x4(ijkToFileIjk.GetPointer(), rasToIjk.GetPointer(), rasToFileIjk.GetPointer());
   vtkNew<vtkMatrix4x4> fileIjkToRas;
   vtkMatrix4x4::Invert(rasToFileIjk.GetPointer(), fileIjkToRas.GetPointer());
-  writer->SetIJKToRASMatrix(fileIjkToRas.GetPointer());
 
   // Save master representation name
-  writer->SetAttribute(GetSegmentationMetaDataKey(KEY_SEGMENTATION_MASTER_REPRESENTATION).c_str(),
-    segmentationNode->GetSegmentation()->GetMasterRepresentationName());
+  headerAttributes[GetSegmentationMetaDataKey(KEY_SEGMENTATION_MASTER_REPRESENTATION)] = segmentationNode->GetSegmentation()->GetMasterRepresentationName();
   // Save conversion parameters
   std::string conversionParameters = segmentation->SerializeAllConversionParameters();
-  writer->SetAttribute(GetSegmentationMetaDataKey(KEY_SEGMENTATION_CONVERSION_PARAMETERS).c_str(), conversionParameters);
+  headerAttributes[GetSegmentationMetaDataKey(KEY_SEGMENTATION_CONVERSION_PARAMETERS)] = conversionParameters;
   // Save created representation names so that they are re-created when loading
   std::string containedRepresentationNames = this->SerializeContainedRepresentationNames(segmentation);
-  writer->SetAttribute(GetSegmentationMetaDataKey(KEY_SEGMENTATION_CONTAINED_REPRESENTATION_NAMES).c_str(), containedRepresentationNames);
+  headerAttributes[GetSegmentationMetaDataKey(KEY_SEGMENTATION_CONTAINED_REPRESENTATION_NAMES)] = containedRepresentationNames;
 
   vtkNew<vtkImageAppendComponents> appender;
 
@@ -1259,11 +1277,11 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
       }
 
     // Set metadata for current segment
-    writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_ID).c_str(), currentSegmentID);
-    writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_NAME).c_str(), currentSegment->GetName());
-    writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_COLOR).c_str(), GetSegmentColorAsString(segmentationNode, currentSegmentID));
-    writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_NAME_AUTO_GENERATED).c_str(), (currentSegment->GetNameAutoGenerated() ? "1" : "0") );
-    writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_COLOR_AUTO_GENERATED).c_str(), (currentSegment->GetColorAutoGenerated() ? "1" : "0") );
+    headerAttributes[GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_ID)] = currentSegmentID;
+    headerAttributes[GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_NAME)] = currentSegment->GetName();
+    headerAttributes[GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_COLOR)] = GetSegmentColorAsString(segmentationNode, currentSegmentID);
+    headerAttributes[GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_NAME_AUTO_GENERATED)] = (currentSegment->GetNameAutoGenerated() ? "1" : "0");
+    headerAttributes[GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_COLOR_AUTO_GENERATED)] = (currentSegment->GetColorAutoGenerated() ? "1" : "0");
     // Save the geometry relative to the current image (so that the extent in the file describe the extent of the segment in the
     // saved image buffer)
     for (int i = 0; i < 3; i++)
@@ -1271,11 +1289,11 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
       currentBinaryLabelmapExtent[i * 2] -= referenceImageExtentOffset[i];
       currentBinaryLabelmapExtent[i * 2 + 1] -= referenceImageExtentOffset[i];
       }
-    writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_EXTENT).c_str(), GetImageExtentAsString(currentBinaryLabelmapExtent));
-    writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_TAGS).c_str(), GetSegmentTagsAsString(currentSegment));
+    headerAttributes[GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_EXTENT)] = GetImageExtentAsString(currentBinaryLabelmapExtent);
+    headerAttributes[GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_TAGS)] = GetSegmentTagsAsString(currentSegment);
     std::stringstream labelValueSS;
     labelValueSS << currentSegment->GetLabelValue();
-    writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_LABEL_VALUE).c_str(), labelValueSS.str());
+    headerAttributes[GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_LABEL_VALUE)] = labelValueSS.str();
 
     vtkDataObject* originalRepresentation = currentSegment->GetRepresentation(segmentationNode->GetSegmentation()->GetMasterRepresentationName());
     if (labelmapLayers.find(originalRepresentation) == labelmapLayers.end())
@@ -1287,25 +1305,62 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
     unsigned int layer = labelmapLayers[originalRepresentation];
     std::stringstream layerIndexSS;
     layerIndexSS << layer;
-    writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_LAYER).c_str(), layerIndexSS.str());
+    headerAttributes[GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_LAYER)] = layerIndexSS.str();
 
     } // For each segment
 
+  vtkImageData* imageToWrite = commonGeometryImage;
   if (segmentationNode->GetSegmentation()->GetNumberOfSegments() > 0)
     {
     appender->Update();
-    writer->SetInputConnection(appender->GetOutputPort());
-    writer->SetVectorAxisKind(nrrdKindList);
+    imageToWrite = appender->GetOutput();
     }
-  else
+  // If there are no segments, we still write the data so that we can store
+  // various metadata fields.
+
+  int writeFlag = 1;
+  if (vtkMRMLStorageNode::GetLowercaseExtensionFromFileName(fullName) == ".cvol")
+    {
+    // Chunked volume file stores the voxels starting from file IJK origin
+    vtkNew<vtkImageChangeInformation> fileIjkImage;
+    fileIjkImage->SetInputData(imageToWrite);
+    fileIjkImage->SetOutputExtentStart(0, 0, 0);
+
+    vtkNew<vtkChunkedImageWriter> writer;
+    writer->SetFileName(fullName.c_str());
+    writer->SetUseCompression(this->GetUseCompression());
+    writer->SetIJKToRASMatrix(fileIjkToRas.GetPointer());
+    for (std::map<std::string, std::string>::iterator it = headerAttributes.begin(); it != headerAttributes.end(); ++it)
+      {
+      writer->SetMetaData(it->first, it->second);
+      }
+    writer->SetInputConnection(fileIjkImage->GetOutputPort());
+    writer->Write();
+    if (writer->GetErrorCode() != vtkErrorCode::NoError)
+      {
+      vtkErrorMacro("ERROR writing chunked volume file " << fullName);
+      writeFlag = 0;
+      }
+    return writeFlag;
+    }
+
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetFileName(fullName.c_str());
+  writer->SetUseCompression(this->GetUseCompression());
+  writer->SetSpace(nrrdSpaceLeftPosteriorSuperior);
+  writer->SetMeasurementFrameMatrix(nullptr);
+  writer->SetIJKToRASMatrix(fileIjkToRas.GetPointer());
+  for (std::map<std::string, std::string>::iterator it = headerAttributes.begin(); it != headerAttributes.end(); ++it)
     {
-    // If there are no segments, we still write the data so that we can store
-    // various metadata fields.
-    writer->SetInputData(commonGeometryImage);
+    writer->SetAttribute(it->first, it->second);
     }
+  if (segmentationNode->GetSegmentation()->GetNumberOfSegments() > 0)
+    {
+    writer->SetVectorAxisKind(nrrdKindList);
+    }
+  writer->SetInputData(imageToWrite);
 
   writer->Write();
-  int writeFlag = 1;
   if (writer->GetWriteError())
     {
     vtkErrorMacro("ERROR writing NRRD file " << (writer->GetFileName() == nullptr ? "null" : writer->GetFileName()));
@@ -46,6 +46,9 @@ vtkMRMLStreamingVolumeNode::vtkMRMLStreamingVolumeNode()
   , FrameDecoded(false)
   , FrameDecodingInProgress(false)
   , FrameModifiedCallbackCommand(vtkSmartPointer<vtkCallbackCommand>::New())
+  , AsynchronousDecoding(false)
+  , FrameQueuedForDecoding(false)
+  , FrameDecoder(nullptr)
 {
   this->FrameModifiedCallbackCommand->SetClientData(reinterpret_cast<void *>(this));
   this->FrameModifiedCallbackCommand->SetCallback(vtkMRMLStreamingVolumeNode::FrameModifiedCallback);
@@ -53,7 +56,12 @@ vtkMRMLStreamingVolumeNode::vtkMRMLStreamingVolumeNode()
 
 //-----------------------------------------------------------------------------
 vtkMRMLStreamingVolumeNode::~vtkMRMLStreamingVolumeNode()
-= default;
+{
+  if (this->FrameDecoder)
+    {
+    this->FrameDecoder->Stop();
+    }
+}
 
 //---------------------------------------------------------------------------
 void vtkMRMLStreamingVolumeNode::FrameModifiedCallback(vtkObject *caller, unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
@@ -66,7 +74,12 @@ void vtkMRMLStreamingVolumeNode::FrameModifiedCallback(vtkObject *caller, unsign
 
   if (vtkStreamingVolumeFrame::SafeDownCast(caller) == self->Frame)
     {
-    if (self->HasExternalImageObserver())
+    self->FrameDecoded = false;
+    if (self->AsynchronousDecoding)
+      {
+      self->QueueFrameForDecoding();
+      }
+    else if (self->HasExternalImageObserver())
       {
       self->DecodeFrame();
       }
@@ -187,6 +200,7 @@ void vtkMRMLStreamingVolumeNode::SetAndObserveFrame(vtkStreamingVolumeFrame* fra
 
   this->Frame = frame;
   this->FrameDecoded = false;
+  this->FrameQueuedForDecoding = false;
 
   if (this->Frame)
     {
@@ -197,9 +211,14 @@ void vtkMRMLStreamingVolumeNode::SetAndObserveFrame(vtkStreamingVolumeFrame* fra
     {
     this->CodecFourCC = this->Frame->GetCodecFourCC();
 
+    if (this->AsynchronousDecoding)
+      {
+      // The image data is updated when the frame has been decoded in the background
+      this->QueueFrameForDecoding();
+      }
     // If the image is being observed beyond the default internal observations of the volume node, then the frame should be decoded
     // since some external class is observing the image data.
-    if (this->HasExternalImageObserver())
+    else if (this->HasExternalImageObserver())
       {
       this->DecodeFrame();
       }
@@ -230,6 +249,18 @@ bool vtkMRMLStreamingVolumeNode::DecodeFrame()
     return true;
     }
 
+  if (this->AsynchronousDecoding)
+    {
+    if (!this->FrameQueuedForDecoding && !this->QueueFrameForDecoding())
+      {
+      return false;
+      }
+    // Never wait for the decoding threads, the image data is updated when
+    // UpdateDecodedImage() is polled after the frame has been decoded
+    this->UpdateDecodedImage();
+    return true;
+    }
+
   this->FrameDecodingInProgress = true;
   this->FrameDecoded = false;
 
@@ -266,6 +297,84 @@ bool vtkMRMLStreamingVolumeNode::DecodeFrame()
   return success;
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::SetAsynchronousDecoding(bool asynchronousDecoding)
+{
+  if (this->AsynchronousDecoding == asynchronousDecoding)
+    {
+    return;
+    }
+  this->AsynchronousDecoding = asynchronousDecoding;
+  this->FrameQueuedForDecoding = false;
+  if (!this->AsynchronousDecoding && this->FrameDecoder)
+    {
+    this->FrameDecoder->Stop();
+    }
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+vtkStreamingVolumeFrameDecoder* vtkMRMLStreamingVolumeNode::GetFrameDecoder()
+{
+  if (!this->FrameDecoder)
+    {
+    this->FrameDecoder = vtkSmartPointer<vtkStreamingVolumeFrameDecoder>::New();
+    }
+  return this->FrameDecoder;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeNode::QueueFrameForDecoding()
+{
+  if (!this->Frame)
+    {
+    return false;
+    }
+
+  vtkStreamingVolumeFrameDecoder* decoder = this->GetFrameDecoder();
+  if (!decoder->IsRunning() || decoder->GetCodec() != this->GetCodec())
+    {
+    if (!this->GetCodec())
+      {
+      vtkErrorMacro("Could not find codec \"" << this->GetCodecFourCC() << "\"");
+      return false;
+      }
+    decoder->SetCodec(this->Codec);
+    if (!decoder->Start())
+      {
+      return false;
+      }
+    }
+
+  this->FrameQueuedForDecoding = decoder->PushFrame(this->Frame);
+  return this->FrameQueuedForDecoding;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeNode::UpdateDecodedImage()
+{
+  if (!this->FrameDecoder || this->FrameDecodingInProgress)
+    {
+    return false;
+    }
+
+  this->FrameDecodingInProgress = true;
+  vtkSmartPointer<vtkImageData> imageData = Superclass::GetImageData();
+  if (!imageData)
+    {
+    imageData = vtkSmartPointer<vtkImageData>::New();
+    }
+  // The image data references the decoded buffer, no voxels are copied
+  vtkStreamingVolumeFrame* decodedFrame = this->FrameDecoder->UpdateOutputImage(imageData);
+  if (decodedFrame)
+    {
+    this->FrameDecoded = (decodedFrame == this->Frame);
+    this->SetAndObserveImageData(imageData);
+    }
+  this->FrameDecodingInProgress = false;
+  return decodedFrame != nullptr;
+}
+
 //---------------------------------------------------------------------------
 bool vtkMRMLStreamingVolumeNode::EncodeImageData(bool forceKeyFrame/*=false*/)
 {
@@ -304,6 +413,12 @@ void vtkMRMLStreamingVolumeNode::SetCodecParameterString(std::string parameterSt
     return;
     }
   this->Codec->SetParametersFromString(parameterString);
+  if (this->FrameDecoder && this->FrameDecoder->IsRunning())
+    {
+    // Decoding threads use a copy of the codec parameters, restart them
+    this->FrameDecoder->Stop();
+    this->FrameQueuedForDecoding = false;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -357,6 +472,7 @@ void vtkMRMLStreamingVolumeNode::PrintSelf(ostream& os, vtkIndent indent)
   Superclass::PrintSelf(os,indent);
   vtkMRMLPrintBeginMacro(os, indent);
   os << indent << this->Frame << "\n";
+  vtkMRMLPrintBooleanMacro(AsynchronousDecoding);
   if (this->Codec)
     {
     os << indent << this->Codec << "\n";
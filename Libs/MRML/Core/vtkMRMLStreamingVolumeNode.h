@@ -31,6 +31,7 @@ Care Ontario.
 
 // vtkAddon includes
 #include "vtkStreamingVolumeCodec.h"
+#include "vtkStreamingVolumeFrameDecoder.h"
 
 // VTK includes
 #include <vtkImageData.h>
@@ -87,6 +88,30 @@ public:
   /// Returns true if the frame is successfully decoded
   virtual bool DecodeFrame();
 
+  /// Enable decoding of frames in background threads.
+  /// When enabled, new frames are queued for decoding instead of being decoded
+  /// when they are set, and the image data is updated with the most recent
+  /// decoded image when UpdateDecodedImage() is called (or when the image data
+  /// is requested). Frames may be skipped if decoding falls behind the stream.
+  /// Disabled by default. This setting is not saved in the scene.
+  /// \sa GetFrameDecoder(), UpdateDecodedImage()
+  void SetAsynchronousDecoding(bool asynchronousDecoding);
+  vtkGetMacro(AsynchronousDecoding, bool);
+  vtkBooleanMacro(AsynchronousDecoding, bool);
+
+  /// Decoder used when AsynchronousDecoding is enabled.
+  /// Can be used to customize the frame skip policy and buffering, and to
+  /// access decoding statistics.
+  vtkStreamingVolumeFrameDecoder* GetFrameDecoder();
+
+  /// Update the image data with the most recent image decoded in the background.
+  /// Does not wait for the decoding threads. Must be called from the main thread:
+  /// the Volumes module polls all the asynchronously decoded streaming volume
+  /// nodes of the scene from a timer.
+  /// Returns true if the image data was updated.
+  /// \sa vtkSlicerVolumesLogic::UpdateStreamingVolumeNodes()
+  virtual bool UpdateDecodedImage();
+
   /// Returns true if the current frame is a keyframe
   /// Keyframes are not interpolated and don't require any additional frames in order to be decoded to an uncompressed image
   virtual bool IsKeyFrame();
@@ -125,6 +150,10 @@ protected:
   /// Returns true if the number of observers on the ImageData or ImageDataConnection is greater than the default expected number
   bool HasExternalImageObserver();
 
+  /// Queue the current frame for decoding in the background.
+  /// Starts the frame decoder if it is not running yet or if the codec has changed.
+  bool QueueFrameForDecoding();
+
 protected:
   vtkSmartPointer<vtkStreamingVolumeCodec> Codec;
   std::string                              CodecFourCC;
@@ -132,6 +161,9 @@ protected:
   bool                                     FrameDecoded;
   bool                                     FrameDecodingInProgress;
   vtkSmartPointer<vtkCallbackCommand>      FrameModifiedCallbackCommand;
+  bool                                     AsynchronousDecoding;
+  bool                                     FrameQueuedForDecoding;
+  vtkSmartPointer<vtkStreamingVolumeFrameDecoder> FrameDecoder;
 
 };
 
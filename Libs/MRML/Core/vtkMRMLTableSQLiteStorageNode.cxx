@@ -181,9 +181,10 @@ int vtkMRMLTableSQLiteStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
   createTableQuery += this->TableName;
   createTableQuery += "(";
 
-  std::string insertPreamble = "INSERT into ";
-  insertPreamble += this->TableName;
-  insertPreamble += "(";
+  std::string insertQuery = "INSERT into ";
+  insertQuery += this->TableName;
+  insertQuery += "(";
+  std::string insertParameters;
 
   //get the columns from the vtkTable to finish the query
   vtkIdType numColumns = table->GetNumberOfColumns();
@@ -192,7 +193,8 @@ int vtkMRMLTableSQLiteStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     //get this column's name
     std::string columnName = table->GetColumn(i)->GetName();
     createTableQuery += columnName;
-    insertPreamble += "'" + columnName + "'";
+    insertQuery += "'" + columnName + "'";
+    insertParameters += "?";
 
     //figure out what type of data is stored in this column
     std::string columnType = table->GetColumn(i)->GetClassName();
@@ -215,12 +217,13 @@ int vtkMRMLTableSQLiteStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     if(i == numColumns - 1)
       {
       createTableQuery += ");";
-      insertPreamble += ") VALUES (";
+      insertQuery += ") VALUES (" + insertParameters + ");";
       }
     else
       {
       createTableQuery += ", ";
-      insertPreamble += ", ";
+      insertQuery += ", ";
+      insertParameters += ", ";
       }
     }
 
@@ -235,27 +238,29 @@ int vtkMRMLTableSQLiteStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     vtkErrorMacro(<<"Error performing 'create table' query");
     }
 
-  //iterate over the rows of the vtkTable to complete the insert query
+  //insert all the rows in a single transaction, using a prepared statement:
+  //committing each row separately would make writing large tables very slow.
+  //Values are bound as text, the column type affinity converts them.
+  bool transactionStarted = query->BeginTransaction();
+  query->SetQuery(insertQuery.c_str());
   vtkIdType numRows = table->GetNumberOfRows();
   for(vtkIdType i = 0; i < numRows; i++)
     {
-    std::string insertQuery = insertPreamble;
     for (vtkIdType j = 0; j < numColumns; j++)
       {
-      insertQuery += "'" + table->GetValue(i, j).ToString() + "'";
-      if(j < numColumns - 1)
-        {
-        insertQuery += ", ";
-        }
+      vtkStdString value = table->GetValue(i, j).ToString();
+      query->BindParameter(static_cast<int>(j), value.c_str(), value.size());
       }
-    insertQuery += ");";
     //perform the insert query for this row
-    query->SetQuery(insertQuery.c_str());
     if(!query->Execute())
       {
       vtkErrorMacro(<<"Error performing 'insert' query");
       }
     }
+  if (transactionStarted && !query->CommitTransaction())
+    {
+    vtkErrorMacro(<<"Error committing inserted rows");
+    }
 
   //cleanup and return
   query->Delete();
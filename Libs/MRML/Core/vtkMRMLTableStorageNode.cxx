@@ -34,8 +34,500 @@
 #include <vtkStringArray.h>
 #include <vtkBitArray.h>
 #include <vtkNew.h>
+#include <vtkSMPTools.h>
+#include <vtkVariantCast.h>
+#include <vtksys/FStream.hxx>
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// Return true if the string is a decimal integer, with an optional sign and
+// without any whitespace.
+bool IsPlainInteger(const char* str)
+{
+  if (*str == '+' || *str == '-')
+    {
+    ++str;
+    }
+  if (*str < '0' || *str > '9')
+    {
+    return false;
+    }
+  while (*str >= '0' && *str <= '9')
+    {
+    ++str;
+    }
+  return *str == '\0';
+}
+
+//----------------------------------------------------------------------------
+// Return true if the string is a decimal floating-point number, with optional
+// sign, fractional part and exponent, and without any whitespace.
+bool IsPlainDecimal(const char* str)
+{
+  if (*str == '+' || *str == '-')
+    {
+    ++str;
+    }
+  bool hasDigits = false;
+  while (*str >= '0' && *str <= '9')
+    {
+    ++str;
+    hasDigits = true;
+    }
+  if (*str == '.')
+    {
+    ++str;
+    while (*str >= '0' && *str <= '9')
+      {
+      ++str;
+      hasDigits = true;
+      }
+    }
+  if (!hasDigits)
+    {
+    return false;
+    }
+  if (*str == 'e' || *str == 'E')
+    {
+    ++str;
+    if (*str == '+' || *str == '-')
+      {
+      ++str;
+      }
+    if (*str < '0' || *str > '9')
+      {
+      return false;
+      }
+    while (*str >= '0' && *str <= '9')
+      {
+      ++str;
+      }
+    }
+  return *str == '\0';
+}
+
+//----------------------------------------------------------------------------
+// Convert the string as vtkDataArray::SetVariantValue() does
+template <typename T>
+bool ParseNumberWithVariant(const char* str, T& value)
+{
+  bool valid = false;
+  T variantValue = vtkVariantCast<T>(vtkVariant(vtkStdString(str)), &valid);
+  if (valid)
+    {
+    value = variantValue;
+    }
+  return valid;
+}
+
+//----------------------------------------------------------------------------
+// Number parsing that accepts the same strings and gives the same values as
+// vtkVariant conversion. Plain decimal numbers, which are the vast majority
+// of the cells, are parsed directly with strtod/strtoll, without the stream
+// based conversion and string allocation of vtkVariant. Anything else
+// (whitespace, hexadecimal, inf or nan, out of range values, characters...)
+// is converted with vtkVariant.
+bool ParseNumber(const char* str, double& value)
+{
+  if (IsPlainDecimal(str))
+    {
+    errno = 0;
+    double parsedValue = strtod(str, nullptr);
+    if (errno != ERANGE)
+      {
+      value = parsedValue;
+      return true;
+      }
+    }
+  return ParseNumberWithVariant(str, value);
+}
+
+//----------------------------------------------------------------------------
+bool ParseNumber(const char* str, float& value)
+{
+  if (IsPlainDecimal(str))
+    {
+    errno = 0;
+    float parsedValue = strtof(str, nullptr);
+    if (errno != ERANGE)
+      {
+      value = parsedValue;
+      return true;
+      }
+    }
+  return ParseNumberWithVariant(str, value);
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+bool ParseNumber(const char* str, T& value)
+{
+  // Streams read characters, not numbers: vtkVariant has its own rules for
+  // them. Negative values of unsigned types are also left to vtkVariant.
+  if (sizeof(T) > 1 && IsPlainInteger(str) && (std::is_signed<T>::value || *str != '-'))
+    {
+    typedef typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type ParsedType;
+    errno = 0;
+    ParsedType parsedValue = (std::is_signed<T>::value ?
+      static_cast<ParsedType>(strtoll(str, nullptr, 10)) : static_cast<ParsedType>(strtoull(str, nullptr, 10)));
+    if (errno != ERANGE
+      && parsedValue >= static_cast<ParsedType>(std::numeric_limits<T>::min())
+      && parsedValue <= static_cast<ParsedType>(std::numeric_limits<T>::max()))
+      {
+      value = static_cast<T>(parsedValue);
+      return true;
+      }
+    }
+  return ParseNumberWithVariant(str, value);
+}
+
+//----------------------------------------------------------------------------
+// Convert a range of rows of a string column into a typed value buffer.
+// Empty or invalid cells are left unchanged (they keep the null value).
+template <typename T>
+class StringToNumericColumnFunctor
+{
+public:
+  StringToNumericColumnFunctor(vtkStringArray* stringColumn, T* values)
+    : Strings(stringColumn->GetPointer(0))
+    , Values(values)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType row = begin; row < end; ++row)
+      {
+      const std::string& str = this->Strings[row];
+      if (str.empty())
+        {
+        continue;
+        }
+      T value;
+      if (ParseNumber(str.c_str(), value))
+        {
+        this->Values[row] = value;
+        }
+      }
+  }
+
+private:
+  const vtkStdString* Strings;
+  T* Values;
+};
+
+//----------------------------------------------------------------------------
+template <typename T>
+void StringToNumericColumn(vtkStringArray* stringColumn, T* values)
+{
+  StringToNumericColumnFunctor<T> functor(stringColumn, values);
+  vtkSMPTools::For(0, stringColumn->GetNumberOfValues(), functor);
+}
+
+//----------------------------------------------------------------------------
+// Check whether all the non-empty values of a range of rows of a string
+// column are integers or numbers. The check stops as soon as a value that is
+// not a number is found.
+class DetectColumnTypeFunctor
+{
+public:
+  DetectColumnTypeFunctor(vtkStringArray* stringColumn)
+    : Strings(stringColumn->GetPointer(0))
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType row = begin; row < end && !this->NotNumeric; ++row)
+      {
+      const std::string& str = this->Strings[row];
+      if (str.empty())
+        {
+        continue;
+        }
+      this->HasValues = true;
+      int intValue;
+      if (!this->NotInteger && ParseNumber(str.c_str(), intValue))
+        {
+        continue;
+        }
+      this->NotInteger = true;
+      double doubleValue;
+      if (!ParseNumber(str.c_str(), doubleValue))
+        {
+        this->NotNumeric = true;
+        }
+      }
+  }
+
+  int GetValueType() const
+  {
+    if (!this->HasValues || this->NotNumeric)
+      {
+      return VTK_STRING;
+      }
+    return this->NotInteger ? VTK_DOUBLE : VTK_INT;
+  }
+
+private:
+  const vtkStdString* Strings;
+  mutable std::atomic<bool> HasValues{false};
+  mutable std::atomic<bool> NotInteger{false};
+  mutable std::atomic<bool> NotNumeric{false};
+};
+
+//----------------------------------------------------------------------------
+int DetectColumnValueType(vtkStringArray* stringColumn)
+{
+  if (stringColumn->GetNumberOfValues() == 0)
+    {
+    return VTK_STRING;
+    }
+  DetectColumnTypeFunctor functor(stringColumn);
+  vtkSMPTools::For(0, stringColumn->GetNumberOfValues(), functor);
+  return functor.GetValueType();
+}
+
+//----------------------------------------------------------------------------
+// Size of the blocks of rows that are tokenized in parallel
+const size_t TextChunkSize = 1 << 20;
+
+//----------------------------------------------------------------------------
+// Range of lines of a delimited text file. Chunks start at line boundaries.
+struct TextChunk
+{
+  const char* Begin{nullptr};
+  const char* End{nullptr};
+  vtkIdType FirstRow{0};
+  vtkIdType NumberOfRows{0};
+  bool Valid{false};
+};
+
+//----------------------------------------------------------------------------
+const char* GetLineEnd(const char* line, const char* end)
+{
+  const char* lineEnd = static_cast<const char*>(memchr(line, '\n', end - line));
+  return lineEnd ? lineEnd : end;
+}
+
+//----------------------------------------------------------------------------
+// Return the number of fields if the line is split by vtkDelimitedTextReader
+// at each delimiter, without any other processing, and 0 otherwise.
+// Only non-empty ASCII lines without string delimiters, escape characters,
+// control characters and leading whitespace are accepted.
+int GetNumberOfFieldsInSimpleLine(const char* line, const char* lineEnd, char delimiter)
+{
+  if (line == lineEnd || *line == ' ' || *line == '\t')
+    {
+    return 0;
+    }
+  int numberOfFields = 1;
+  for (const char* c = line; c < lineEnd; ++c)
+    {
+    if (*c == delimiter)
+      {
+      ++numberOfFields;
+      }
+    else if (static_cast<unsigned char>(*c) < 0x20 || static_cast<unsigned char>(*c) >= 0x80
+      || *c == '"' || *c == '\\')
+      {
+      return 0;
+      }
+    }
+  return numberOfFields;
+}
+
+//----------------------------------------------------------------------------
+// Count the rows of each chunk and check that they can be split at delimiters
+class CheckTextChunkFunctor
+{
+public:
+  CheckTextChunkFunctor(std::vector<TextChunk>& chunks, char delimiter, int numberOfFields)
+    : Chunks(chunks)
+    , Delimiter(delimiter)
+    , NumberOfFields(numberOfFields)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType chunkIndex = begin; chunkIndex < end; ++chunkIndex)
+      {
+      TextChunk& chunk = this->Chunks[chunkIndex];
+      chunk.Valid = true;
+      for (const char* line = chunk.Begin; line < chunk.End; )
+        {
+        const char* lineEnd = GetLineEnd(line, chunk.End);
+        if (GetNumberOfFieldsInSimpleLine(line, lineEnd, this->Delimiter) != this->NumberOfFields)
+          {
+          chunk.Valid = false;
+          break;
+          }
+        ++chunk.NumberOfRows;
+        line = (lineEnd < chunk.End ? lineEnd + 1 : chunk.End);
+        }
+      }
+  }
+
+private:
+  std::vector<TextChunk>& Chunks;
+  char Delimiter;
+  int NumberOfFields;
+};
+
+//----------------------------------------------------------------------------
+// Split the rows of each chunk into the preallocated string columns
+class TokenizeTextChunkFunctor
+{
+public:
+  TokenizeTextChunkFunctor(const std::vector<TextChunk>& chunks, char delimiter, const std::vector<vtkStdString*>& columnValues)
+    : Chunks(chunks)
+    , Delimiter(delimiter)
+    , ColumnValues(columnValues)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType chunkIndex = begin; chunkIndex < end; ++chunkIndex)
+      {
+      const TextChunk& chunk = this->Chunks[chunkIndex];
+      vtkIdType row = chunk.FirstRow;
+      for (const char* line = chunk.Begin; line < chunk.End; ++row)
+        {
+        const char* lineEnd = GetLineEnd(line, chunk.End);
+        size_t column = 0;
+        const char* field = line;
+        for (const char* c = line; c <= lineEnd; ++c)
+          {
+          if (c == lineEnd || *c == this->Delimiter)
+            {
+            this->ColumnValues[column][row].assign(field, c);
+            ++column;
+            field = c + 1;
+            }
+          }
+        line = (lineEnd < chunk.End ? lineEnd + 1 : chunk.End);
+        }
+      }
+  }
+
+private:
+  const std::vector<TextChunk>& Chunks;
+  char Delimiter;
+  const std::vector<vtkStdString*>& ColumnValues;
+};
+
+//----------------------------------------------------------------------------
+// Read a delimited text file with header into string columns, tokenizing
+// blocks of rows in parallel. The result is the same as reading the file with
+// vtkDelimitedTextReader (with headers, string delimiters used and no numeric
+// column detection). Files that would need any processing other than splitting
+// lines at the delimiter (quoted or escaped values, empty lines, leading
+// whitespace, non-ASCII characters, rows of different length) are not read and
+// nullptr is returned, these files are read with vtkDelimitedTextReader.
+vtkSmartPointer<vtkTable> ReadSimpleDelimitedText(const std::string& filename, char delimiter)
+{
+  vtksys::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    {
+    return nullptr;
+    }
+  file.seekg(0, std::ios::end);
+  std::streamoff fileSize = file.tellg();
+  file.seekg(0, std::ios::beg);
+  if (fileSize <= 0)
+    {
+    return nullptr;
+    }
+  std::vector<char> buffer(static_cast<size_t>(fileSize));
+  if (!file.read(buffer.data(), fileSize))
+    {
+    return nullptr;
+    }
+  const char* text = buffer.data();
+  const char* textEnd = text + buffer.size();
+
+  // Header
+  const char* headerEnd = GetLineEnd(text, textEnd);
+  int numberOfFields = GetNumberOfFieldsInSimpleLine(text, headerEnd, delimiter);
+  if (numberOfFields == 0)
+    {
+    return nullptr;
+    }
+  vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+  const char* field = text;
+  for (const char* c = text; c <= headerEnd; ++c)
+    {
+    if (c == headerEnd || *c == delimiter)
+      {
+      if (c == field)
+        {
+        // empty column name
+        return nullptr;
+        }
+      vtkNew<vtkStringArray> column;
+      column->SetName(std::string(field, c).c_str());
+      table->AddColumn(column.GetPointer());
+      field = c + 1;
+      }
+    }
+
+  // Split the rows into chunks that end at a line end
+  std::vector<TextChunk> chunks;
+  const char* chunkBegin = (headerEnd < textEnd ? headerEnd + 1 : textEnd);
+  while (chunkBegin < textEnd)
+    {
+    TextChunk chunk;
+    chunk.Begin = chunkBegin;
+    chunk.End = chunkBegin + std::min(TextChunkSize, static_cast<size_t>(textEnd - chunkBegin));
+    if (chunk.End < textEnd)
+      {
+      const char* lineEnd = GetLineEnd(chunk.End - 1, textEnd);
+      chunk.End = (lineEnd < textEnd ? lineEnd + 1 : textEnd);
+      }
+    chunks.push_back(chunk);
+    chunkBegin = chunk.End;
+    }
+
+  CheckTextChunkFunctor checker(chunks, delimiter, numberOfFields);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(chunks.size()), 1, checker);
+  vtkIdType numberOfRows = 0;
+  for (TextChunk& chunk : chunks)
+    {
+    if (!chunk.Valid)
+      {
+      return nullptr;
+      }
+    chunk.FirstRow = numberOfRows;
+    numberOfRows += chunk.NumberOfRows;
+    }
+
+  std::vector<vtkStdString*> columnValues;
+  for (int column = 0; column < numberOfFields; ++column)
+    {
+    vtkStringArray* columnArray = vtkStringArray::SafeDownCast(table->GetColumn(column));
+    columnArray->SetNumberOfValues(numberOfRows);
+    columnValues.push_back(numberOfRows > 0 ? columnArray->GetPointer(0) : nullptr);
+    }
+  TokenizeTextChunkFunctor tokenizer(chunks, delimiter, columnValues);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(chunks.size()), 1, tokenizer);
+  return table;
+}
+}
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTableStorageNode);
 
@@ -44,6 +536,7 @@ vtkMRMLTableStorageNode::vtkMRMLTableStorageNode()
 {
   this->DefaultWriteFileExtension = "tsv";
   this->AutoFindSchema = true;
+  this->DetectNumericColumns = false;
 }
 
 //----------------------------------------------------------------------------
@@ -54,6 +547,8 @@ vtkMRMLTableStorageNode::~vtkMRMLTableStorageNode()
 void vtkMRMLTableStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   vtkMRMLStorageNode::PrintSelf(os,indent);
+  os << indent << "AutoFindSchema: " << this->AutoFindSchema << "\n";
+  os << indent << "DetectNumericColumns: " << this->DetectNumericColumns << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -318,26 +813,37 @@ bool vtkMRMLTableStorageNode::ReadSchema(std::string filename, vtkMRMLTableNode*
 //----------------------------------------------------------------------------
 bool vtkMRMLTableStorageNode::ReadTable(std::string filename, vtkMRMLTableNode* tableNode)
 {
-  vtkNew<vtkDelimitedTextReader> reader;
-  reader->SetFileName(filename.c_str());
-  reader->SetHaveHeaders(true);
-  reader->SetFieldDelimiterCharacters(this->GetFieldDelimiterCharacters(filename).c_str());
-  // Make sure string delimiter characters are removed (somebody may have written a tsv with string delimiters)
-  reader->SetUseStringDelimiter(true);
-  // File contents is preserved better if we don't try to detect numeric columns
-  reader->DetectNumericColumnsOff();
+  std::string fieldDelimiterCharacters = this->GetFieldDelimiterCharacters(filename);
 
-  // Read table
-  vtkTable* rawTable = nullptr;
-  try
+  // Most files can be split at delimiters and line ends, which is done in parallel
+  vtkSmartPointer<vtkTable> rawTable;
+  if (fieldDelimiterCharacters.size() == 1)
     {
-    reader->Update();
-    rawTable = reader->GetOutput();
+    rawTable = ReadSimpleDelimitedText(filename, fieldDelimiterCharacters[0]);
     }
-  catch (...)
+
+  vtkNew<vtkDelimitedTextReader> reader;
+  if (!rawTable)
     {
-    vtkErrorMacro("vtkMRMLTableStorageNode::ReadTable: failed to read table file: " << filename);
-    return 0;
+    reader->SetFileName(filename.c_str());
+    reader->SetHaveHeaders(true);
+    reader->SetFieldDelimiterCharacters(fieldDelimiterCharacters.c_str());
+    // Make sure string delimiter characters are removed (somebody may have written a tsv with string delimiters)
+    reader->SetUseStringDelimiter(true);
+    // File contents is preserved better if we don't try to detect numeric columns
+    reader->DetectNumericColumnsOff();
+
+    // Read table
+    try
+      {
+      reader->Update();
+      rawTable = reader->GetOutput();
+      }
+    catch (...)
+      {
+      vtkErrorMacro("vtkMRMLTableStorageNode::ReadTable: failed to read table file: " << filename);
+      return 0;
+      }
     }
 
   vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
@@ -360,7 +866,7 @@ bool vtkMRMLTableStorageNode::ReadTable(std::string filename, vtkMRMLTableNode*
     if (valueTypeId == VTK_VOID)
       {
       // schema is not defined or no valid column type is defined for column
-      valueTypeId = VTK_STRING;
+      valueTypeId = (this->DetectNumericColumns ? DetectColumnValueType(column) : VTK_STRING);
       }
     if (valueTypeId == VTK_STRING)
       {
@@ -396,35 +902,20 @@ bool vtkMRMLTableStorageNode::ReadTable(std::string filename, vtkMRMLTableNode*
         }
 
       // Set values
-      if (valueTypeId == VTK_CHAR || valueTypeId == VTK_SIGNED_CHAR || valueTypeId == VTK_UNSIGNED_CHAR)
+      switch (valueTypeId)
         {
-        bool valid = false;
-        for (vtkIdType row = 0; row < numberOfTuples; ++row)
-          {
-          if (column->GetValue(row).empty())
-            {
-            // empty cell, leave the null value
-            continue;
-            }
-          int value = column->GetVariantValue(row).ToInt(&valid);
-          if (!valid)
+        // Columns of standard numeric types are parsed in parallel, directly into the value buffer
+        vtkTemplateMacro(StringToNumericColumn(column, static_cast<VTK_TT*>(typedColumn->GetVoidPointer(0))));
+        default:
+          for (vtkIdType row = 0; row < numberOfTuples; ++row)
             {
-            continue;
+            if (column->GetValue(row).empty())
+              {
+              // empty cell, leave the null value
+              continue;
+              }
+            typedColumn->SetVariantValue(row, column->GetVariantValue(row));
             }
-          typedColumn->SetVariantValue(row, vtkVariant(value));
-          }
-        }
-      else
-        {
-        for (vtkIdType row = 0; row < numberOfTuples; ++row)
-          {
-          if (column->GetValue(row).empty())
-            {
-            // empty cell, leave the null value
-            continue;
-            }
-          typedColumn->SetVariantValue(row, column->GetVariantValue(row));
-          }
         }
 
       table->AddColumn(typedColumn);
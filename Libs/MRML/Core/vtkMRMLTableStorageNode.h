@@ -68,6 +68,17 @@ public:
   vtkGetMacro(AutoFindSchema, bool);
   vtkBooleanMacro(AutoFindSchema, bool);
 
+  /// If enabled, the type of the columns that have no type in the schema (or
+  /// of all the columns if there is no schema) is detected when the data is
+  /// read. A column is read as int if all its non-empty values are integers,
+  /// as double if they are all numbers, and as string otherwise. Empty cells
+  /// of detected numeric columns are set to 0.
+  /// Disabled by default: columns without type are read as strings, which
+  /// preserves the file content.
+  vtkSetMacro(DetectNumericColumns, bool);
+  vtkGetMacro(DetectNumericColumns, bool);
+  vtkBooleanMacro(DetectNumericColumns, bool);
+
 protected:
   vtkMRMLTableStorageNode();
   ~vtkMRMLTableStorageNode() override;
@@ -97,6 +108,7 @@ protected:
   bool WriteSchema(std::string filename, vtkMRMLTableNode* tableNode);
 
   bool AutoFindSchema;
+  bool DetectNumericColumns;
 };
 
 #endif
@@ -13,6 +13,7 @@ Version:   $Revision: 1.6 $
 =========================================================================auto=*/
 
 // MRML includes
+#include "vtkCacheManager.h"
 #include "vtkDataFileFormatHelper.h"
 #include "vtkDataIOManager.h"
 #include "vtkMRMLScene.h"
@@ -317,6 +318,18 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
   reader->AddObserver( vtkCommand::ProgressEvent,  this->MRMLCallbackCommand);
 
+  // Analyzed DICOM headers are indexed in the cache directory, so that
+  // the series is loaded faster next time
+  if (this->GetScene() && this->GetScene()->GetCacheManager()
+    && this->GetScene()->GetCacheManager()->GetRemoteCacheDirectory()
+    && strlen(this->GetScene()->GetCacheManager()->GetRemoteCacheDirectory()) > 0)
+    {
+    std::string headerIndexDirectory =
+      std::string(this->GetScene()->GetCacheManager()->GetRemoteCacheDirectory()) + "/DICOMHeaderIndex";
+    reader->SetUseHeaderIndexFile(true);
+    reader->SetHeaderIndexDirectory(headerIndexDirectory.c_str());
+    }
+
   if (volNode->GetImageData())
     {
     volNode->SetAndObserveImageData(nullptr);
@@ -0,0 +1,121 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkMRMLColorTableCache.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include <vtkMRMLColorTableNode.h>
+#include <vtkMRMLColorTableStorageNode.h>
+
+// VTK includes
+#include <vtkLookupTable.h>
+#include <vtkNew.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+//-----------------------------------------------------------------------------
+int vtkMRMLColorTableCacheTest1(int argc, char * argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Line " << __LINE__
+      << " - Missing parameters!\n"
+      << "Usage: " << argv[0] << " /path/to/temp"
+      << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string tempDir = argv[1];
+  const std::string colorFileName = tempDir + "/vtkMRMLColorTableCacheTest1.ctbl";
+  const std::string cacheFileName = tempDir + "/vtkMRMLColorTableCacheTest1.bin";
+  vtksys::SystemTools::RemoveFile(cacheFileName);
+
+  {
+    std::ofstream colorFile(colorFileName.c_str());
+    colorFile << "0 background 0 0 0 0\n"
+              << "1 first 255 0 0 255\n"
+              << "3 third 10 20 30 40\n";
+  }
+
+  vtkNew<vtkMRMLColorTableNode> readNode;
+  vtkNew<vtkMRMLColorTableStorageNode> storageNode;
+  storageNode->SetFileName(colorFileName.c_str());
+  CHECK_BOOL(storageNode->ReadData(readNode.GetPointer()), true);
+
+  // Nothing is cached yet
+  {
+    vtkNew<vtkMRMLColorTableCache> cache;
+    cache->SetFileName(cacheFileName);
+    CHECK_BOOL(cache->Load(), false);
+    CHECK_BOOL(cache->ReadColorTable(colorFileName, readNode.GetPointer()), false);
+    cache->AddColorTable(colorFileName, readNode.GetPointer());
+    CHECK_INT(cache->GetNumberOfColorTables(), 1);
+    CHECK_BOOL(cache->Save(), true);
+  }
+
+  // Populate a node from the cache file
+  vtkNew<vtkMRMLColorTableCache> cache;
+  cache->SetFileName(cacheFileName);
+  CHECK_BOOL(cache->Load(), true);
+  CHECK_INT(cache->GetNumberOfColorTables(), 1);
+  vtkNew<vtkMRMLColorTableNode> cachedNode;
+  CHECK_BOOL(cache->ReadColorTable(colorFileName, cachedNode.GetPointer()), true);
+  CHECK_INT(cachedNode->GetNumberOfColors(), readNode->GetNumberOfColors());
+  for (int i = 0; i < readNode->GetNumberOfColors(); ++i)
+    {
+    double expectedColor[4];
+    double color[4];
+    readNode->GetColor(i, expectedColor);
+    cachedNode->GetColor(i, color);
+    for (int c = 0; c < 4; ++c)
+      {
+      CHECK_DOUBLE(color[c], expectedColor[c]);
+      }
+    CHECK_STD_STRING(cachedNode->GetColorName(i), readNode->GetColorName(i));
+    }
+  CHECK_DOUBLE(cachedNode->GetLookupTable()->GetRange()[1],
+               readNode->GetLookupTable()->GetRange()[1]);
+
+  // A modified source file invalidates its table
+  {
+    std::ofstream colorFile(colorFileName.c_str(), std::ios::app);
+    colorFile << "4 fourth 1 2 3 4\n";
+  }
+  CHECK_BOOL(cache->ReadColorTable(colorFileName, cachedNode.GetPointer()), false);
+
+  // Color names without terminating null character are rejected
+  std::string content;
+  {
+    std::ifstream cacheFile(cacheFileName.c_str(), std::ios::in | std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(cacheFile), std::istreambuf_iterator<char>());
+  }
+  size_t namesPosition = content.find("background");
+  CHECK_BOOL(namesPosition != std::string::npos, true);
+  std::replace(content.begin() + namesPosition, content.end(), '\0', 'x');
+  {
+    std::ofstream cacheFile(cacheFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    cacheFile.write(content.data(), content.size());
+  }
+  vtkNew<vtkMRMLColorTableCache> corruptedCache;
+  corruptedCache->SetFileName(cacheFileName);
+  TESTING_OUTPUT_ASSERT_WARNINGS_BEGIN();
+  CHECK_BOOL(corruptedCache->Load(), false);
+  TESTING_OUTPUT_ASSERT_WARNINGS_END();
+  CHECK_INT(corruptedCache->GetNumberOfColorTables(), 0);
+
+  vtksys::SystemTools::RemoveFile(colorFileName);
+  vtksys::SystemTools::RemoveFile(cacheFileName);
+  return EXIT_SUCCESS;
+}
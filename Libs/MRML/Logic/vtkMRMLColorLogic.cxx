@@ -14,6 +14,7 @@
 
 // MRMLLogic includes
 #include "vtkMRMLColorLogic.h"
+#include "vtkMRMLColorTableCache.h"
 
 // MRML includes
 #include "vtkMRMLColorTableNode.h"
@@ -50,6 +51,9 @@ vtkStandardNewMacro(vtkMRMLColorLogic);
 vtkMRMLColorLogic::vtkMRMLColorLogic()
 {
   this->UserColorFilePaths = nullptr;
+  this->ColorTableCacheFileName = nullptr;
+  this->ColorTableCache = vtkMRMLColorTableCache::New();
+  this->UseColorTableCache = false;
 }
 
 //----------------------------------------------------------------------------
@@ -67,6 +71,9 @@ vtkMRMLColorLogic::~vtkMRMLColorLogic()
     delete [] this->UserColorFilePaths;
     this->UserColorFilePaths = nullptr;
     }
+  this->SetColorTableCacheFileName(nullptr);
+  this->ColorTableCache->Delete();
+  this->ColorTableCache = nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -98,6 +105,8 @@ void vtkMRMLColorLogic::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "vtkMRMLColorLogic:             " << this->GetClassName() << "\n";
 
   os << indent << "UserColorFilePaths: " << this->GetUserColorFilePaths() << "\n";
+  os << indent << "ColorTableCacheFileName: "
+     << (this->ColorTableCacheFileName ? this->ColorTableCacheFileName : "(none)") << "\n";
   os << indent << "Color Files:\n";
   for (size_t i = 0; i < this->ColorFiles.size(); i++)
     {
@@ -124,6 +133,16 @@ void vtkMRMLColorLogic::AddDefaultColorNodes()
 
   this->GetMRMLScene()->StartState(vtkMRMLScene::BatchProcessState);
 
+  // default file based color tables (hidden and not saved with the scene)
+  // are read from the cache if their file did not change
+  bool useColorTableCache = (this->ColorTableCacheFileName != nullptr
+                             && strlen(this->ColorTableCacheFileName) > 0);
+  if (useColorTableCache)
+    {
+    this->ColorTableCache->SetFileName(this->ColorTableCacheFileName);
+    this->ColorTableCache->Load();
+    }
+
   // add the labels first
   this->AddLabelsNode();
 
@@ -133,6 +152,8 @@ void vtkMRMLColorLogic::AddDefaultColorNodes()
   // add default procedural nodes, including a random one
   this->AddDefaultProceduralNodes();
 
+  this->UseColorTableCache = useColorTableCache;
+
   // add freesurfer nodes
   this->AddFreeSurferNodes();
 
@@ -148,10 +169,18 @@ void vtkMRMLColorLogic::AddDefaultColorNodes()
   // load the one from the default resources directory
   this->AddDefaultFileNodes();
 
+  this->UseColorTableCache = false;
+
   // now add ones in files that the user pointed to, these ones are not hidden
   // from the editors
   this->AddUserFileNodes();
 
+  if (useColorTableCache)
+    {
+    // only rewritten if a color file was added, removed or changed
+    this->ColorTableCache->Save();
+    }
+
   vtkDebugMacro("Done adding default color nodes");
   this->GetMRMLScene()->EndState(vtkMRMLScene::BatchProcessState);
 }
@@ -736,6 +765,14 @@ vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName)
   std::string uname( this->GetMRMLScene()->GetUniqueNameByString(basename.c_str()));
   ctnode->SetName(uname.c_str());
 
+  if (this->UseColorTableCache && this->ColorTableCache->ReadColorTable(fileName, ctnode))
+    {
+    vtkDebugMacro("CreateFileNode: read color table from cache for file " << fileName);
+    ctnode->SetSingletonTag(
+      this->GetFileColorNodeSingletonTag(fileName).c_str());
+    return ctnode;
+    }
+
   vtkDebugMacro("CreateFileNode: About to read user file " << fileName);
 
   if (ctnode->GetStorageNode()->ReadData(ctnode) == 0)
@@ -753,6 +790,10 @@ vtkMRMLColorTableNode* vtkMRMLColorLogic::CreateFileNode(const char* fileName)
       return nullptr;
     }
   vtkDebugMacro("CreateFileNode: finished reading user file " << fileName);
+  if (this->UseColorTableCache)
+    {
+    this->ColorTableCache->AddColorTable(fileName, ctnode);
+    }
   ctnode->SetSingletonTag(
     this->GetFileColorNodeSingletonTag(fileName).c_str());
 
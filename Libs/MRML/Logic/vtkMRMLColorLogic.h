@@ -16,6 +16,7 @@
 
 // MRML includes
 class vtkMRMLColorNode;
+class vtkMRMLColorTableCache;
 class vtkMRMLColorTableNode;
 class vtkMRMLFreeSurferProceduralColorNode;
 class vtkMRMLProceduralColorNode;
@@ -207,6 +208,18 @@ public:
   vtkGetStringMacro(UserColorFilePaths);
   vtkSetStringMacro(UserColorFilePaths);
 
+  /// Get/Set the file where the color tables read from the default color
+  /// files (including the FreeSurfer labels file) are cached. When set,
+  /// AddDefaultColorNodes() populates these color table nodes from the cache
+  /// instead of parsing the color files again, files that changed since they
+  /// were cached are parsed and the cache is updated.
+  /// User color files are always parsed: their nodes are saved with the
+  /// scene and must be flagged as read from their file.
+  /// No cache is used if null (default).
+  /// \sa vtkMRMLColorTableCache
+  vtkGetStringMacro(ColorTableCacheFileName);
+  vtkSetStringMacro(ColorTableCacheFileName);
+
   /// Returns a vtkMRMLColorTableNode copy (type = vtkMRMLColorTableNode::User)
   /// of the \a color node. The node is not added to the scene and you are
   /// responsible for deleting it.
@@ -284,6 +297,13 @@ protected:
   /// vtkMRMLApplication::GetColorFilePaths
   char *UserColorFilePaths;
 
+  /// Path of the color table cache file, see SetColorTableCacheFileName()
+  char *ColorTableCacheFileName;
+  /// Cache of the color tables read from files, only used while
+  /// AddDefaultColorNodes() adds the default file based nodes.
+  vtkMRMLColorTableCache* ColorTableCache;
+  bool UseColorTableCache;
+
   static std::string TempColorNodeID;
 
   std::string RemoveLeadAndTrailSpaces(std::string);
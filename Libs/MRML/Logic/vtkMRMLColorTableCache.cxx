@@ -0,0 +1,434 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkMRMLColorTableCache.h"
+
+// MRML includes
+#include "vtkMRMLColorTableNode.h"
+
+// VTK includes
+#include <vtkLookupTable.h>
+#include <vtkObjectFactory.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLColorTableCache);
+
+namespace
+{
+
+const char CacheMagic[8] = { 'M', 'R', 'M', 'L', 'C', 'T', 'A', 'B' };
+const vtkTypeUInt32 CacheVersion = 1;
+const vtkTypeUInt32 CacheByteOrderMark = 0x01020304;
+const vtkTypeUInt64 CacheAlignment = 8;
+
+// All the structures written in the cache file have a size that is a
+// multiple of CacheAlignment.
+struct CacheHeader
+{
+  char Magic[8];
+  vtkTypeUInt32 Version;
+  vtkTypeUInt32 ByteOrderMark;
+  vtkTypeUInt32 NumberOfTables;
+  vtkTypeUInt32 Reserved;
+};
+
+// A record is followed by the source path, the RGBA colors (4 unsigned
+// chars per color) and the null terminated color names, each padded to
+// CacheAlignment.
+struct CacheRecord
+{
+  vtkTypeUInt64 SourceSize;
+  vtkTypeInt64 SourceModifiedTime;
+  double TableRange[2];
+  vtkTypeUInt64 PathByteSize;
+  vtkTypeUInt64 ColorsByteSize;
+  vtkTypeUInt64 NamesByteSize;
+  vtkTypeInt32 NumberOfColors;
+  vtkTypeInt32 Reserved;
+};
+
+//----------------------------------------------------------------------------
+vtkTypeUInt64 AlignOffset(vtkTypeUInt64 offset)
+{
+  return (offset + CacheAlignment - 1) / CacheAlignment * CacheAlignment;
+}
+
+//----------------------------------------------------------------------------
+bool GetSourceStamp(const std::string& fileName, vtkTypeUInt64& size, vtkTypeInt64& modifiedTime)
+{
+  if (!vtksys::SystemTools::FileExists(fileName, true))
+    {
+    return false;
+    }
+  size = static_cast<vtkTypeUInt64>(vtksys::SystemTools::FileLength(fileName));
+  modifiedTime = static_cast<vtkTypeInt64>(vtksys::SystemTools::ModifiedTime(fileName));
+  return true;
+}
+
+//----------------------------------------------------------------------------
+long GetProcessId()
+{
+#ifdef _WIN32
+  return static_cast<long>(_getpid());
+#else
+  return static_cast<long>(getpid());
+#endif
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkMRMLColorTableCache::vtkInternal
+{
+public:
+  struct ColorTable
+    {
+    vtkTypeUInt64 SourceSize{0};
+    vtkTypeInt64 SourceModifiedTime{0};
+    double TableRange[2]{0., 0.};
+    std::vector<unsigned char> Colors;
+    std::vector<std::string> Names;
+    /// Set when the table is read or added after the last Load()
+    bool Used{false};
+    };
+
+  std::string FileName;
+  /// Key is the source file path
+  std::map<std::string, ColorTable> ColorTables;
+  /// Set when the content differs from the cache file
+  bool Dirty{false};
+};
+
+//----------------------------------------------------------------------------
+vtkMRMLColorTableCache::vtkMRMLColorTableCache()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLColorTableCache::~vtkMRMLColorTableCache()
+{
+  delete this->Internal;
+  this->Internal = nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLColorTableCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << this->Internal->FileName << "\n";
+  os << indent << "NumberOfColorTables: " << this->GetNumberOfColorTables() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLColorTableCache::SetFileName(const std::string& fileName)
+{
+  if (this->Internal->FileName == fileName)
+    {
+    return;
+    }
+  this->Internal->FileName = fileName;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLColorTableCache::GetFileName()const
+{
+  return this->Internal->FileName;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLColorTableCache::GetNumberOfColorTables()const
+{
+  return static_cast<int>(this->Internal->ColorTables.size());
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLColorTableCache::Load()
+{
+  this->Internal->ColorTables.clear();
+  this->Internal->Dirty = true;
+  if (this->Internal->FileName.empty())
+    {
+    return false;
+    }
+
+  // Read the whole file at once
+  vtksys::ifstream file(this->Internal->FileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    {
+    vtkDebugMacro("Load: no color table cache file " << this->Internal->FileName);
+    return false;
+    }
+  file.seekg(0, std::ios::end);
+  std::streamoff fileSize = file.tellg();
+  file.seekg(0, std::ios::beg);
+  if (fileSize < static_cast<std::streamoff>(sizeof(CacheHeader)))
+    {
+    return false;
+    }
+  std::vector<char> buffer(static_cast<size_t>(fileSize));
+  if (!file.read(buffer.data(), fileSize))
+    {
+    vtkWarningMacro("Load: failed to read color table cache file " << this->Internal->FileName);
+    return false;
+    }
+
+  CacheHeader header;
+  memcpy(&header, buffer.data(), sizeof(header));
+  if (memcmp(header.Magic, CacheMagic, sizeof(CacheMagic)) != 0
+    || header.Version != CacheVersion
+    || header.ByteOrderMark != CacheByteOrderMark)
+    {
+    vtkDebugMacro("Load: ignore color table cache file of a different version " << this->Internal->FileName);
+    return false;
+    }
+
+  vtkTypeUInt64 offset = sizeof(CacheHeader);
+  const vtkTypeUInt64 size = static_cast<vtkTypeUInt64>(fileSize);
+  for (vtkTypeUInt32 tableIndex = 0; tableIndex < header.NumberOfTables; ++tableIndex)
+    {
+    CacheRecord record;
+    if (offset + sizeof(record) > size)
+      {
+      break;
+      }
+    memcpy(&record, buffer.data() + offset, sizeof(record));
+    offset += sizeof(record);
+    const vtkTypeUInt64 pathOffset = offset;
+    const vtkTypeUInt64 colorsOffset = AlignOffset(pathOffset + record.PathByteSize);
+    const vtkTypeUInt64 namesOffset = AlignOffset(colorsOffset + record.ColorsByteSize);
+    offset = AlignOffset(namesOffset + record.NamesByteSize);
+    if (offset > size || record.NumberOfColors < 0
+      || record.ColorsByteSize != 4 * static_cast<vtkTypeUInt64>(record.NumberOfColors))
+      {
+      vtkWarningMacro("Load: invalid color table cache file " << this->Internal->FileName);
+      this->Internal->ColorTables.clear();
+      return false;
+      }
+
+    std::string sourceFileName(buffer.data() + pathOffset, record.PathByteSize);
+    vtkInternal::ColorTable& colorTable = this->Internal->ColorTables[sourceFileName];
+    colorTable.SourceSize = record.SourceSize;
+    colorTable.SourceModifiedTime = record.SourceModifiedTime;
+    colorTable.TableRange[0] = record.TableRange[0];
+    colorTable.TableRange[1] = record.TableRange[1];
+    const unsigned char* colors = reinterpret_cast<const unsigned char*>(buffer.data() + colorsOffset);
+    colorTable.Colors.assign(colors, colors + record.ColorsByteSize);
+    colorTable.Names.reserve(record.NumberOfColors);
+    const char* name = buffer.data() + namesOffset;
+    const char* namesEnd = name + record.NamesByteSize;
+    for (int colorIndex = 0; colorIndex < record.NumberOfColors && name < namesEnd; ++colorIndex)
+      {
+      // Names are null terminated, do not read past the names of this record
+      const char* nameEnd = static_cast<const char*>(memchr(name, '\0', namesEnd - name));
+      if (!nameEnd)
+        {
+        break;
+        }
+      colorTable.Names.emplace_back(name, nameEnd);
+      name = nameEnd + 1;
+      }
+    if (static_cast<int>(colorTable.Names.size()) != record.NumberOfColors)
+      {
+      vtkWarningMacro("Load: invalid color names in color table cache file " << this->Internal->FileName);
+      this->Internal->ColorTables.clear();
+      return false;
+      }
+    }
+
+  this->Internal->Dirty = false;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLColorTableCache::Save()
+{
+  if (this->Internal->FileName.empty())
+    {
+    return false;
+    }
+
+  // Tables of files that are not used anymore are not saved
+  std::map<std::string, vtkInternal::ColorTable>::iterator tableIt = this->Internal->ColorTables.begin();
+  while (tableIt != this->Internal->ColorTables.end())
+    {
+    if (!tableIt->second.Used)
+      {
+      this->Internal->ColorTables.erase(tableIt++);
+      this->Internal->Dirty = true;
+      }
+    else
+      {
+      ++tableIt;
+      }
+    }
+  if (!this->Internal->Dirty)
+    {
+    return true;
+    }
+
+  std::vector<char> buffer;
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+  header.Version = CacheVersion;
+  header.ByteOrderMark = CacheByteOrderMark;
+  header.NumberOfTables = static_cast<vtkTypeUInt32>(this->Internal->ColorTables.size());
+  buffer.insert(buffer.end(), reinterpret_cast<char*>(&header), reinterpret_cast<char*>(&header) + sizeof(header));
+
+  for (tableIt = this->Internal->ColorTables.begin(); tableIt != this->Internal->ColorTables.end(); ++tableIt)
+    {
+    const vtkInternal::ColorTable& colorTable = tableIt->second;
+    std::string names;
+    for (const std::string& name : colorTable.Names)
+      {
+      names.append(name);
+      names.push_back('\0');
+      }
+    CacheRecord record;
+    memset(&record, 0, sizeof(record));
+    record.SourceSize = colorTable.SourceSize;
+    record.SourceModifiedTime = colorTable.SourceModifiedTime;
+    record.TableRange[0] = colorTable.TableRange[0];
+    record.TableRange[1] = colorTable.TableRange[1];
+    record.PathByteSize = tableIt->first.size();
+    record.ColorsByteSize = colorTable.Colors.size();
+    record.NamesByteSize = names.size();
+    record.NumberOfColors = static_cast<vtkTypeInt32>(colorTable.Names.size());
+    buffer.insert(buffer.end(), reinterpret_cast<char*>(&record), reinterpret_cast<char*>(&record) + sizeof(record));
+    buffer.insert(buffer.end(), tableIt->first.begin(), tableIt->first.end());
+    buffer.resize(AlignOffset(buffer.size()), '\0');
+    buffer.insert(buffer.end(), colorTable.Colors.begin(), colorTable.Colors.end());
+    buffer.resize(AlignOffset(buffer.size()), '\0');
+    buffer.insert(buffer.end(), names.begin(), names.end());
+    buffer.resize(AlignOffset(buffer.size()), '\0');
+    }
+
+  // Write into a temporary file first so that concurrent readers never see
+  // a partially written cache. The temporary file name is specific to the
+  // process so that concurrent instances do not write the same file.
+  std::string directory = vtksys::SystemTools::GetFilenamePath(this->Internal->FileName);
+  if (!directory.empty() && !vtksys::SystemTools::MakeDirectory(directory))
+    {
+    vtkWarningMacro("Save: failed to create directory " << directory);
+    return false;
+    }
+  std::stringstream temporaryFileNameStream;
+  temporaryFileNameStream << this->Internal->FileName << "." << GetProcessId() << ".tmp";
+  std::string temporaryFileName = temporaryFileNameStream.str();
+    {
+    vtksys::ofstream file(temporaryFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open() || !file.write(buffer.data(), buffer.size()))
+      {
+      vtkWarningMacro("Save: failed to write color table cache file " << temporaryFileName);
+      return false;
+      }
+    }
+  vtksys::SystemTools::RemoveFile(this->Internal->FileName);
+  if (!vtksys::SystemTools::RenameFile(temporaryFileName, this->Internal->FileName))
+    {
+    vtkWarningMacro("Save: failed to write color table cache file " << this->Internal->FileName);
+    vtksys::SystemTools::RemoveFile(temporaryFileName);
+    return false;
+    }
+
+  this->Internal->Dirty = false;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLColorTableCache::ReadColorTable(const std::string& sourceFileName, vtkMRMLColorTableNode* node)
+{
+  if (!node || !node->GetLookupTable())
+    {
+    return false;
+    }
+  std::map<std::string, vtkInternal::ColorTable>::iterator tableIt = this->Internal->ColorTables.find(sourceFileName);
+  if (tableIt == this->Internal->ColorTables.end())
+    {
+    return false;
+    }
+  vtkInternal::ColorTable& colorTable = tableIt->second;
+  vtkTypeUInt64 sourceSize = 0;
+  vtkTypeInt64 sourceModifiedTime = 0;
+  if (!GetSourceStamp(sourceFileName, sourceSize, sourceModifiedTime)
+    || sourceSize != colorTable.SourceSize || sourceModifiedTime != colorTable.SourceModifiedTime)
+    {
+    // Source file changed, the table must be read again
+    return false;
+    }
+
+  // Same result as vtkMRMLColorTableStorageNode::ReadData
+  int wasModifying = node->StartModify();
+  node->NamesInitialisedOff();
+  const int numberOfColors = static_cast<int>(colorTable.Names.size());
+  node->SetNumberOfColors(numberOfColors);
+  node->GetLookupTable()->SetTableRange(colorTable.TableRange);
+  const unsigned char* rgba = colorTable.Colors.data();
+  for (int colorIndex = 0; colorIndex < numberOfColors; ++colorIndex, rgba += 4)
+    {
+    node->SetColor(colorIndex, colorTable.Names[colorIndex].c_str(),
+      rgba[0] / 255.0, rgba[1] / 255.0, rgba[2] / 255.0, rgba[3] / 255.0);
+    }
+  node->NamesInitialisedOn();
+  node->EndModify(wasModifying);
+
+  colorTable.Used = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLColorTableCache::AddColorTable(const std::string& sourceFileName, vtkMRMLColorTableNode* node)
+{
+  if (!node || !node->GetLookupTable())
+    {
+    return;
+    }
+  vtkInternal::ColorTable colorTable;
+  if (!GetSourceStamp(sourceFileName, colorTable.SourceSize, colorTable.SourceModifiedTime))
+    {
+    return;
+    }
+  vtkLookupTable* lookupTable = node->GetLookupTable();
+  lookupTable->GetTableRange(colorTable.TableRange);
+  const int numberOfColors = node->GetNumberOfColors();
+  colorTable.Names.reserve(numberOfColors);
+  for (int colorIndex = 0; colorIndex < numberOfColors; ++colorIndex)
+    {
+    const char* name = node->GetColorName(colorIndex);
+    colorTable.Names.emplace_back(name ? name : "");
+    }
+  colorTable.Colors.resize(4 * static_cast<size_t>(numberOfColors));
+  if (numberOfColors > 0)
+    {
+    memcpy(colorTable.Colors.data(), lookupTable->GetTable()->GetPointer(0), colorTable.Colors.size());
+    }
+  colorTable.Used = true;
+
+  this->Internal->ColorTables[sourceFileName] = colorTable;
+  this->Internal->Dirty = true;
+}
@@ -0,0 +1,92 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLColorTableCache_h
+#define __vtkMRMLColorTableCache_h
+
+// MRMLLogic includes
+#include "vtkMRMLLogicExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// MRML includes
+class vtkMRMLColorTableNode;
+
+// STD includes
+#include <string>
+
+/// \brief Binary cache of the color tables read from color files.
+///
+/// Parsing the text color files (e.g. the large FreeSurfer lookup table)
+/// each time default color nodes are added to a scene is slow. This class
+/// stores the parsed tables (colors, names and lookup table range) in a
+/// single versioned binary file. Records are flat and 8-byte aligned, the
+/// whole file is read at once and no parsing of text is needed to populate
+/// a color table node.
+///
+/// Each table is associated with the path, size and modification time of
+/// its source file: a table whose source file changed is not used and
+/// the cache file is rewritten with the new content when \a Save() is called.
+///
+/// Typical usage:
+/// \code
+/// cache->SetFileName(cacheFilePath);
+/// cache->Load();
+/// if (!cache->ReadColorTable(colorFileName, node))
+///   {
+///   // read the node from colorFileName, then
+///   cache->AddColorTable(colorFileName, node);
+///   }
+/// cache->Save();
+/// \endcode
+/// \sa vtkMRMLColorLogic::SetColorTableCacheFileName()
+class VTK_MRML_LOGIC_EXPORT vtkMRMLColorTableCache : public vtkObject
+{
+public:
+  static vtkMRMLColorTableCache *New();
+  vtkTypeMacro(vtkMRMLColorTableCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Path of the cache file.
+  void SetFileName(const std::string& fileName);
+  std::string GetFileName()const;
+
+  /// Read the tables from the cache file, previous content is discarded.
+  /// Return false if the file does not exist or is not a valid cache file
+  /// of the current version, the cache is then empty.
+  bool Load();
+
+  /// Write the tables read or added since the last \a Load() to the cache
+  /// file. The file is not written if it is already up-to-date.
+  /// Return false if the file can not be written.
+  bool Save();
+
+  /// Populate \a node with the table cached for \a sourceFileName.
+  /// Return false if there is no table for the current content of the file.
+  bool ReadColorTable(const std::string& sourceFileName, vtkMRMLColorTableNode* node);
+
+  /// Store the colors and names of \a node, associated with the current
+  /// content of \a sourceFileName.
+  void AddColorTable(const std::string& sourceFileName, vtkMRMLColorTableNode* node);
+
+  /// Number of tables currently in the cache.
+  int GetNumberOfColorTables()const;
+
+protected:
+  vtkMRMLColorTableCache();
+  ~vtkMRMLColorTableCache() override;
+  vtkMRMLColorTableCache(const vtkMRMLColorTableCache&);
+  void operator=(const vtkMRMLColorTableCache&);
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
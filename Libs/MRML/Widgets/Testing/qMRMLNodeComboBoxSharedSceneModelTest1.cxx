@@ -0,0 +1,101 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// qMRML includes
+#include "qMRMLNodeComboBox.h"
+#include "qMRMLVirtualSceneModel.h"
+#include "qMRMLWidget.h"
+
+// MRML includes
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLTransformNode.h>
+
+// VTK includes
+#include <vtkNew.h>
+
+// test comboboxes listing the nodes from a shared scene model
+int qMRMLNodeComboBoxSharedSceneModelTest1( int argc, char * argv [] )
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLModelNode> modelNode1;
+  scene->AddNode(modelNode1.GetPointer());
+  vtkNew<vtkMRMLTransformNode> transformNode;
+  scene->AddNode(transformNode.GetPointer());
+
+  qMRMLNodeComboBox modelSelector;
+  modelSelector.setNodeTypes(QStringList("vtkMRMLModelNode"));
+  modelSelector.setNoneEnabled(true);
+  modelSelector.setSharedSceneModel(true);
+  modelSelector.setMRMLScene(scene.GetPointer());
+  CHECK_BOOL(modelSelector.sharedSceneModel(), true);
+  CHECK_NULL(modelSelector.sceneModel());
+  CHECK_INT(modelSelector.nodeCount(), 1);
+
+  qMRMLNodeComboBox transformSelector;
+  transformSelector.setNodeTypes(QStringList("vtkMRMLTransformNode"));
+  transformSelector.setMRMLScene(scene.GetPointer());
+  transformSelector.setCurrentNode(transformNode.GetPointer());
+  // Switching model keeps the current node
+  transformSelector.setSharedSceneModel(true);
+  CHECK_POINTER(transformSelector.currentNode(), transformNode.GetPointer());
+  CHECK_INT(transformSelector.nodeCount(), 1);
+
+  // Both comboboxes filter the same model
+  CHECK_POINTER(modelSelector.sortFilterProxyModel()->sourceModel(),
+                transformSelector.sortFilterProxyModel()->sourceModel());
+
+  vtkNew<vtkMRMLModelNode> modelNode2;
+  scene->AddNode(modelNode2.GetPointer());
+  CHECK_INT(modelSelector.nodeCount(), 2);
+  CHECK_INT(transformSelector.nodeCount(), 1);
+  CHECK_POINTER(modelSelector.nodeFromIndex(1), modelNode2.GetPointer());
+
+  // "None" is the first item, extra items are not counted as nodes
+  modelSelector.setCurrentNodeIndex(1);
+  CHECK_POINTER(modelSelector.currentNode(), modelNode2.GetPointer());
+  modelSelector.setCurrentNode(nullptr);
+  CHECK_NULL(modelSelector.currentNode());
+
+  scene->RemoveNode(modelNode1.GetPointer());
+  CHECK_INT(modelSelector.nodeCount(), 1);
+  CHECK_POINTER(modelSelector.nodeFromIndex(0), modelNode2.GetPointer());
+
+  // Switch back to the combobox own scene model
+  modelSelector.setCurrentNode(modelNode2.GetPointer());
+  modelSelector.setSharedSceneModel(false);
+  CHECK_BOOL(modelSelector.sharedSceneModel(), false);
+  CHECK_NOT_NULL(modelSelector.sceneModel());
+  CHECK_INT(modelSelector.nodeCount(), 1);
+  CHECK_POINTER(modelSelector.currentNode(), modelNode2.GetPointer());
+
+  // The shared model is released with the last combobox using it
+  QSharedPointer<qMRMLVirtualSceneModel> sharedModel = qMRMLVirtualSceneModel::sharedModel(scene.GetPointer());
+  CHECK_POINTER(sharedModel.data(), transformSelector.sortFilterProxyModel()->sourceModel());
+  transformSelector.setMRMLScene(nullptr);
+  CHECK_NULL(transformSelector.sortFilterProxyModel()->sourceModel());
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// qMRML includes
+#include "qMRMLPlotView_p.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkNew.h>
+#include <vtkTable.h>
+
+// STD includes
+#include <iostream>
+
+namespace
+{
+
+const vtkIdType NumberOfSamples = 200000;
+const vtkIdType MinimumRowId = 54321;
+const vtkIdType MaximumRowId = 123457;
+
+//-----------------------------------------------------------------------------
+double XValue(vtkIdType rowId)
+{
+  return 0.1 * rowId;
+}
+
+//-----------------------------------------------------------------------------
+// Values in [0, 10) with a single minimum and maximum spike
+double YValue(vtkIdType rowId)
+{
+  if (rowId == MinimumRowId)
+    {
+    return -1000.0;
+    }
+  if (rowId == MaximumRowId)
+    {
+    return 1000.0;
+    }
+  return ((rowId * 7919) % 1000) * 0.01;
+}
+
+//-----------------------------------------------------------------------------
+// Check that the visible points are samples of the series in X order, that
+// the first and last samples and the extrema of the series are kept, and that
+// there are at most maximumNumberOfRows points.
+bool CheckVisibleTable(const qMRMLPlotSeriesLevelOfDetail& levelOfDetail, vtkIdType maximumNumberOfRows)
+{
+  vtkTable* visibleTable = levelOfDetail.visibleTable();
+  vtkIdType numberOfRows = visibleTable->GetNumberOfRows();
+  if (numberOfRows < 2 || numberOfRows > maximumNumberOfRows)
+    {
+    std::cerr << "Unexpected number of visible points: " << numberOfRows
+              << " (maximum " << maximumNumberOfRows << ")" << std::endl;
+    return false;
+    }
+  bool minimumFound = false;
+  bool maximumFound = false;
+  vtkIdType previousRowId = -1;
+  for (vtkIdType visibleRowId = 0; visibleRowId < numberOfRows; ++visibleRowId)
+    {
+    vtkIdType rowId = levelOfDetail.originalRowId(visibleRowId);
+    if (rowId <= previousRowId || rowId >= NumberOfSamples)
+      {
+      std::cerr << "Visible point " << visibleRowId << " is not in sample order: row " << rowId
+                << " after row " << previousRowId << std::endl;
+      return false;
+      }
+    if (visibleTable->GetValue(visibleRowId, 0).ToDouble() != XValue(rowId)
+      || visibleTable->GetValue(visibleRowId, 1).ToDouble() != YValue(rowId))
+      {
+      std::cerr << "Visible point " << visibleRowId << " differs from row " << rowId << std::endl;
+      return false;
+      }
+    minimumFound = minimumFound || (rowId == MinimumRowId);
+    maximumFound = maximumFound || (rowId == MaximumRowId);
+    previousRowId = rowId;
+    }
+  if (levelOfDetail.originalRowId(0) != 0 || previousRowId != NumberOfSamples - 1)
+    {
+    std::cerr << "First or last sample is not visible" << std::endl;
+    return false;
+    }
+  if (!minimumFound || !maximumFound)
+    {
+    std::cerr << "Minimum or maximum is not visible" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType GetNumberOfVisibleRowsInRange(const qMRMLPlotSeriesLevelOfDetail& levelOfDetail,
+                                        vtkIdType beginRowId, vtkIdType endRowId)
+{
+  vtkIdType numberOfRows = 0;
+  for (vtkIdType visibleRowId = 0; visibleRowId < levelOfDetail.visibleTable()->GetNumberOfRows(); ++visibleRowId)
+    {
+    vtkIdType rowId = levelOfDetail.originalRowId(visibleRowId);
+    if (rowId >= beginRowId && rowId < endRowId)
+      {
+      ++numberOfRows;
+      }
+    }
+  return numberOfRows;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qMRMLPlotSeriesLevelOfDetailTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkTable> table;
+  vtkNew<vtkDoubleArray> xColumn;
+  xColumn->SetName("x");
+  xColumn->SetNumberOfValues(NumberOfSamples);
+  vtkNew<vtkDoubleArray> yColumn;
+  yColumn->SetName("y");
+  yColumn->SetNumberOfValues(NumberOfSamples);
+  for (vtkIdType rowId = 0; rowId < NumberOfSamples; ++rowId)
+    {
+    xColumn->SetValue(rowId, XValue(rowId));
+    yColumn->SetValue(rowId, YValue(rowId));
+    }
+  table->AddColumn(xColumn.GetPointer());
+  table->AddColumn(yColumn.GetPointer());
+
+  qMRMLPlotSeriesLevelOfDetail levelOfDetail;
+  CHECK_BOOL(levelOfDetail.update(table.GetPointer(), "x", "y"), true);
+
+  // Whole series: the extrema are kept at each level, and there are at most
+  // two points per pixel (plus the first and last samples)
+  const double wholeRange[2] = { 1.0, 0.0 };
+  const int viewWidths[] = { 1, 10, 100, 1000, 10000, 100000 };
+  for (int viewWidth : viewWidths)
+    {
+    levelOfDetail.updateVisibleTable(wholeRange, viewWidth);
+    if (!CheckVisibleTable(levelOfDetail, 2 * viewWidth + 2))
+      {
+      std::cerr << "Line " << __LINE__ << ": failed for view width " << viewWidth << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  // The view is wider than the number of samples: all the samples are displayed
+  levelOfDetail.updateVisibleTable(wholeRange, NumberOfSamples);
+  CHECK_INT(levelOfDetail.visibleTable()->GetNumberOfRows(), NumberOfSamples);
+  CHECK_BOOL(CheckVisibleTable(levelOfDetail, NumberOfSamples), true);
+
+  // The visible table is only modified if the view width requires another level
+  // (buckets of 512 samples for 500 and 1000 pixels, of 64 samples for 5000 pixels)
+  CHECK_BOOL(levelOfDetail.updateVisibleTable(wholeRange, 500), true);
+  CHECK_BOOL(levelOfDetail.updateVisibleTable(wholeRange, 500), false);
+  CHECK_BOOL(levelOfDetail.updateVisibleTable(wholeRange, 1000), false);
+  CHECK_BOOL(levelOfDetail.updateVisibleTable(wholeRange, 5000), true);
+
+  // Zoomed in: samples 1000-3000 in a 500 pixel wide view. The visible range
+  // is aligned to the buckets of the overview level (512 samples), which covers
+  // samples 512-3072. 2560 samples are displayed using buckets of 8 samples
+  // (level 1), the rest of the series using buckets of 512 samples (level 3).
+  const double zoomedRange[2] = { XValue(1000) + 0.05, XValue(3000) - 0.05 };
+  CHECK_BOOL(levelOfDetail.updateVisibleTable(zoomedRange, 500), true);
+  CHECK_BOOL(CheckVisibleTable(levelOfDetail, 2 * 500 + 2 * 500 + 2), true);
+  vtkIdType numberOfZoomedRows = GetNumberOfVisibleRowsInRange(levelOfDetail, 512, 3072);
+  if (numberOfZoomedRows <= 2 * 2560 / 64 || numberOfZoomedRows > 2 * 2560 / 8)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected number of points in the visible range: "
+              << numberOfZoomedRows << std::endl;
+    return EXIT_FAILURE;
+    }
+  CHECK_BOOL(GetNumberOfVisibleRowsInRange(levelOfDetail, 0, 512) <= 2 + 1, true);
+  CHECK_BOOL(GetNumberOfVisibleRowsInRange(levelOfDetail, 3072, NumberOfSamples) <= 2 * (NumberOfSamples / 512 + 1) + 1, true);
+
+  // Fewer samples than pixels in the aligned visible range (samples 9728-10240):
+  // all the samples of the visible range are displayed
+  const double detailedRange[2] = { XValue(10001) - 0.05, XValue(10100) + 0.05 };
+  CHECK_BOOL(levelOfDetail.updateVisibleTable(detailedRange, 1000), true);
+  CHECK_BOOL(CheckVisibleTable(levelOfDetail, 2 * 1000 + 2 * 1000 + 2), true);
+  CHECK_INT(GetNumberOfVisibleRowsInRange(levelOfDetail, 10001, 10101), 100);
+
+  // Row index is used as X value if there is no X column
+  qMRMLPlotSeriesLevelOfDetail indexLevelOfDetail;
+  CHECK_BOOL(indexLevelOfDetail.update(table.GetPointer(), "", "y"), true);
+  const double indexRange[2] = { 10001.0, 10100.0 };
+  indexLevelOfDetail.updateVisibleTable(indexRange, 1000);
+  CHECK_INT(GetNumberOfVisibleRowsInRange(indexLevelOfDetail, 10001, 10101), 100);
+  CHECK_BOOL(indexLevelOfDetail.visibleTable()->GetValue(1, 0).ToDouble()
+    == static_cast<double>(indexLevelOfDetail.originalRowId(1)), true);
+
+  // Unsorted X values cannot be downsampled, the pyramid is rebuilt when the table is modified
+  xColumn->SetValue(100, XValue(200));
+  table->Modified();
+  CHECK_BOOL(levelOfDetail.update(table.GetPointer(), "x", "y"), false);
+  CHECK_BOOL(levelOfDetail.updateVisibleTable(wholeRange, 500), false);
+  xColumn->SetValue(100, XValue(100));
+  table->Modified();
+  CHECK_BOOL(levelOfDetail.update(table.GetPointer(), "x", "y"), true);
+  CHECK_BOOL(levelOfDetail.updateVisibleTable(wholeRange, 500), true);
+  CHECK_BOOL(CheckVisibleTable(levelOfDetail, 2 * 500 + 2), true);
+
+  // Missing Y column
+  CHECK_BOOL(levelOfDetail.update(table.GetPointer(), "x", "missing"), false);
+
+  return EXIT_SUCCESS;
+}
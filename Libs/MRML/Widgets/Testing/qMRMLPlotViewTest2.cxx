@@ -0,0 +1,151 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// qMRML includes
+#include "qMRMLPlotView.h"
+#include "qMRMLWidget.h"
+
+// MRML includes
+#include "vtkMRMLPlotChartNode.h"
+#include "vtkMRMLPlotSeriesNode.h"
+#include "vtkMRMLPlotViewNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTableNode.h"
+
+// VTK includes
+#include <vtkAxis.h>
+#include <vtkChartXY.h>
+#include <vtkCommand.h>
+#include <vtkDoubleArray.h>
+#include <vtkNew.h>
+#include <vtkPlot.h>
+#include <vtkTable.h>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// Number of points of the plot with an X value in the range
+vtkIdType GetNumberOfPointsInRange(vtkPlot* plot, double minimumX, double maximumX)
+{
+  vtkTable* table = plot->GetInput();
+  vtkIdType numberOfPoints = 0;
+  for (vtkIdType rowId = 0; rowId < table->GetNumberOfRows(); ++rowId)
+    {
+    double x = table->GetValue(rowId, 0).ToDouble();
+    if (x >= minimumX && x <= maximumX)
+      {
+      ++numberOfPoints;
+      }
+    }
+  return numberOfPoints;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+// Check that zooming in a chart with automatic axis range displays a large
+// series at a finer level of detail.
+int qMRMLPlotViewTest2(int argc, char* argv[])
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  vtkNew<vtkMRMLScene> scene;
+
+  const vtkIdType numberOfSamples = 200000;
+  vtkNew<vtkTable> table;
+  vtkNew<vtkDoubleArray> xColumn;
+  xColumn->SetName("x");
+  xColumn->SetNumberOfValues(numberOfSamples);
+  vtkNew<vtkDoubleArray> yColumn;
+  yColumn->SetName("y");
+  yColumn->SetNumberOfValues(numberOfSamples);
+  for (vtkIdType rowId = 0; rowId < numberOfSamples; ++rowId)
+    {
+    xColumn->SetValue(rowId, 0.1 * rowId);
+    yColumn->SetValue(rowId, ((rowId * 7919) % 1000) * 0.01);
+    }
+  table->AddColumn(xColumn.GetPointer());
+  table->AddColumn(yColumn.GetPointer());
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  scene->AddNode(tableNode.GetPointer());
+  tableNode->SetAndObserveTable(table.GetPointer());
+
+  vtkNew<vtkMRMLPlotSeriesNode> plotSeriesNode;
+  scene->AddNode(plotSeriesNode.GetPointer());
+  plotSeriesNode->SetPlotType(vtkMRMLPlotSeriesNode::PlotTypeScatter);
+  plotSeriesNode->SetLineStyle(vtkMRMLPlotSeriesNode::LineStyleSolid);
+  plotSeriesNode->SetAndObserveTableNodeID(tableNode->GetID());
+  plotSeriesNode->SetXColumnName("x");
+  plotSeriesNode->SetYColumnName("y");
+
+  // Default chart, with automatic axis ranges
+  vtkNew<vtkMRMLPlotChartNode> plotChartNode;
+  scene->AddNode(plotChartNode.GetPointer());
+  plotChartNode->AddAndObservePlotSeriesNodeID(plotSeriesNode->GetID());
+  CHECK_BOOL(plotChartNode->GetXAxisRangeAuto(), true);
+
+  vtkNew<vtkMRMLPlotViewNode> plotViewNode;
+  scene->AddNode(plotViewNode.GetPointer());
+  plotViewNode->SetPlotChartNodeID(plotChartNode->GetID());
+
+  qMRMLPlotView plotView;
+  plotView.setMRMLScene(scene.GetPointer());
+  plotView.setMRMLPlotViewNode(plotViewNode.GetPointer());
+  plotView.resize(500, 300);
+  plotView.show();
+  app.processEvents();
+
+  CHECK_INT(plotView.chart()->GetNumberOfPlots(), 1);
+  vtkPlot* plot = plotView.chart()->GetPlot(0);
+  CHECK_NOT_NULL(plot);
+  // The whole series is displayed with about one bucket of samples per pixel
+  CHECK_BOOL(plot->GetInput()->GetNumberOfRows() < numberOfSamples / 100, true);
+  vtkIdType numberOfPointsBeforeZoom = GetNumberOfPointsInRange(plot, 100.0, 300.0);
+  CHECK_BOOL(numberOfPointsBeforeZoom < 20, true);
+
+  // Zoom in on samples 1000-3000, as mouse interaction does
+  vtkAxis* bottomAxis = plotView.chart()->GetAxis(vtkAxis::BOTTOM);
+  CHECK_INT(bottomAxis->GetBehavior(), vtkAxis::AUTO);
+  bottomAxis->SetUnscaledRange(100.0, 300.0);
+  plotView.chart()->InvokeEvent(vtkCommand::InteractionEvent);
+  app.processEvents();
+
+  CHECK_BOOL(plotChartNode->GetXAxisRangeAuto(), true);
+  CHECK_BOOL(plotView.chart()->GetPlot(0) == plot, true);
+  vtkIdType numberOfPointsAfterZoom = GetNumberOfPointsInRange(plot, 100.0, 300.0);
+  if (numberOfPointsAfterZoom <= 5 * numberOfPointsBeforeZoom || numberOfPointsAfterZoom < 2000 / 8)
+    {
+    std::cerr << "Line " << __LINE__ << ": finer level not selected after zoom: "
+              << numberOfPointsBeforeZoom << " points before zoom, "
+              << numberOfPointsAfterZoom << " points after zoom" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (argc < 2 || QString(argv[1]) != "-I")
+    {
+    return EXIT_SUCCESS;
+    }
+  return app.exec();
+}
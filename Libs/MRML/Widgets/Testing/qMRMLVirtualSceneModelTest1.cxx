@@ -0,0 +1,151 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+
+// qMRML includes
+#include "qMRMLSceneModel.h"
+#include "qMRMLSortFilterProxyModel.h"
+#include "qMRMLVirtualSceneModel.h"
+#include "qMRMLWidget.h"
+
+// MRML includes
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLTransformNode.h>
+
+// VTK includes
+#include <vtkNew.h>
+
+// STD includes
+#include <iostream>
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+bool checkRow(qMRMLVirtualSceneModel& model, vtkMRMLNode* node, int expectedRow, int line)
+{
+  QModelIndex nodeIndex = model.indexFromNode(node);
+  if (nodeIndex.row() != expectedRow
+    || model.mrmlNodeFromIndex(nodeIndex) != node
+    || (node && model.data(nodeIndex).toString() != QString(node->GetName())))
+    {
+    std::cerr << "Line " << line << " - Wrong row for node " << (node ? node->GetID() : "(none)")
+              << ": " << nodeIndex.row() << " (expected " << expectedRow << ")" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+}
+
+//------------------------------------------------------------------------------
+int qMRMLVirtualSceneModelTest1(int argc, char * argv [])
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  qMRMLVirtualSceneModel model;
+  if (model.rowCount() != 0)
+    {
+    std::cerr << "Line " << __LINE__ << " - Wrong row count without scene" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLModelNode> modelNode1;
+  modelNode1->SetName("model1");
+  scene->AddNode(modelNode1.GetPointer());
+
+  model.setMRMLScene(scene.GetPointer());
+  if (model.rowCount() != 1 || model.rowCount(model.mrmlSceneIndex()) != 1)
+    {
+    std::cerr << "Line " << __LINE__ << " - Wrong row count after setMRMLScene" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkMRMLTransformNode> transformNode;
+  transformNode->SetName("transform");
+  scene->AddNode(transformNode.GetPointer());
+  vtkNew<vtkMRMLModelNode> modelNode2;
+  modelNode2->SetName("model2");
+  scene->AddNode(modelNode2.GetPointer());
+
+  if (!checkRow(model, modelNode1.GetPointer(), 0, __LINE__)
+    || !checkRow(model, transformNode.GetPointer(), 1, __LINE__)
+    || !checkRow(model, modelNode2.GetPointer(), 2, __LINE__))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Node data is read from the node
+  modelNode2->SetName("renamed");
+  if (!checkRow(model, modelNode2.GetPointer(), 2, __LINE__))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Rows of following nodes are updated on removal
+  scene->RemoveNode(transformNode.GetPointer());
+  if (model.rowCount(model.mrmlSceneIndex()) != 2
+    || model.indexFromNode(transformNode.GetPointer()).isValid()
+    || !checkRow(model, modelNode2.GetPointer(), 1, __LINE__))
+    {
+    std::cerr << "Line " << __LINE__ << " - Node removal failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Nodes added during batch processing are added at the end
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  vtkNew<vtkMRMLModelNode> modelNode3;
+  modelNode3->SetName("model3");
+  scene->AddNode(modelNode3.GetPointer());
+  scene->RemoveNode(modelNode1.GetPointer());
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  if (model.rowCount(model.mrmlSceneIndex()) != 2
+    || !checkRow(model, modelNode2.GetPointer(), 0, __LINE__)
+    || !checkRow(model, modelNode3.GetPointer(), 1, __LINE__))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Use as source of the sort filter proxy model
+  qMRMLSortFilterProxyModel proxyModel;
+  proxyModel.setSourceModel(&model);
+  QStringList nodeTypes;
+  nodeTypes << "vtkMRMLModelNode";
+  proxyModel.setNodeTypes(nodeTypes);
+  scene->AddNode(transformNode.GetPointer());
+  if (proxyModel.mrmlScene() != scene.GetPointer()
+    || proxyModel.rowCount(proxyModel.mrmlSceneIndex()) != 2
+    || proxyModel.mrmlNodeFromIndex(proxyModel.indexFromMRMLNode(modelNode3.GetPointer())) != modelNode3.GetPointer()
+    || proxyModel.indexFromMRMLNode(transformNode.GetPointer()).isValid())
+    {
+    std::cerr << "Line " << __LINE__ << " - Filtering of virtual scene model failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  scene->Clear(0);
+  if (model.rowCount(model.mrmlSceneIndex()) != scene->GetNumberOfNodes())
+    {
+    std::cerr << "Line " << __LINE__ << " - Wrong row count after scene clear" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -65,6 +65,8 @@ void qMRMLCheckableNodeComboBoxPrivate::init(QAbstractItemModel* model)
 
   this->ComboBox = new ctkCheckableComboBox;
   this->qMRMLNodeComboBoxPrivate::init(model);
+  // Check states are stored in the scene model items
+  this->SharedSceneModelSupported = false;
 
   q->setAddEnabled(false);
   q->setRemoveEnabled(false);
@@ -0,0 +1,602 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QList>
+#include <QPersistentModelIndex>
+
+// qMRML includes
+#include "qMRMLExtraItemsProxyModel.h"
+#include "qMRMLSceneModel.h"
+
+namespace
+{
+/// Internal ID of the top-level indexes. Indexes of the children of the
+/// top-level row N have an internal ID of N + 1.
+const quintptr TopLevelInternalId = 0;
+
+enum ExtraItemType
+{
+  NotExtraItem = 0,
+  PreItem,
+  PostItem
+};
+
+/// Persistent index saved before a layout change of the source model
+struct PersistentItem
+{
+  QModelIndex ProxyIndex;
+  QPersistentModelIndex SourceIndex;
+  ExtraItemType Type;
+  /// Position of the extra item in the pre or post item list
+  int ExtraItemPosition;
+};
+}
+
+//------------------------------------------------------------------------------
+class qMRMLExtraItemsProxyModelPrivate
+{
+  Q_DECLARE_PUBLIC(qMRMLExtraItemsProxyModel);
+protected:
+  qMRMLExtraItemsProxyModel* const q_ptr;
+public:
+  qMRMLExtraItemsProxyModelPrivate(qMRMLExtraItemsProxyModel& object);
+
+  /// Return true if the proxy index is the scene index (first top-level row)
+  bool isSceneIndex(const QModelIndex& proxyIndex)const;
+  /// Number of rows of the source scene index
+  int sourceSceneRowCount()const;
+  /// Return the type of extra item of the proxy index and its position in
+  /// the pre/post item list.
+  ExtraItemType extraItemType(const QModelIndex& proxyIndex, int* position = nullptr)const;
+  /// Row offset of the children of a source parent in the proxy model.
+  /// Returns -1 if the children of the source parent are not mapped.
+  int rowOffset(const QModelIndex& sourceParent)const;
+
+  QStringList PreItems;
+  QStringList PostItems;
+  int ExtraItemColumn;
+
+  /// Set when a source insertion/removal is forwarded, to know whether the
+  /// matching end signal must be forwarded as well.
+  bool InsertingRows;
+  bool RemovingRows;
+  QList<PersistentItem> LayoutChangePersistentItems;
+};
+
+//------------------------------------------------------------------------------
+qMRMLExtraItemsProxyModelPrivate::qMRMLExtraItemsProxyModelPrivate(qMRMLExtraItemsProxyModel& object)
+  : q_ptr(&object)
+{
+  this->ExtraItemColumn = 0;
+  this->InsertingRows = false;
+  this->RemovingRows = false;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLExtraItemsProxyModelPrivate::isSceneIndex(const QModelIndex& proxyIndex)const
+{
+  return proxyIndex.isValid()
+    && proxyIndex.internalId() == TopLevelInternalId
+    && proxyIndex.row() == 0;
+}
+
+//------------------------------------------------------------------------------
+int qMRMLExtraItemsProxyModelPrivate::sourceSceneRowCount()const
+{
+  Q_Q(const qMRMLExtraItemsProxyModel);
+  QAbstractItemModel* sourceModel = q->sourceModel();
+  if (!sourceModel)
+    {
+    return 0;
+    }
+  QModelIndex sourceSceneIndex = sourceModel->index(0, 0);
+  return sourceSceneIndex.isValid() ? sourceModel->rowCount(sourceSceneIndex) : 0;
+}
+
+//------------------------------------------------------------------------------
+ExtraItemType qMRMLExtraItemsProxyModelPrivate::extraItemType(const QModelIndex& proxyIndex, int* position)const
+{
+  // Extra items are children of the scene index
+  if (!proxyIndex.isValid() || proxyIndex.internalId() != TopLevelInternalId + 1)
+    {
+    return NotExtraItem;
+    }
+  int row = proxyIndex.row();
+  if (row < this->PreItems.count())
+    {
+    if (position)
+      {
+      *position = row;
+      }
+    return PreItem;
+    }
+  row -= this->PreItems.count() + this->sourceSceneRowCount();
+  if (row >= 0 && row < this->PostItems.count())
+    {
+    if (position)
+      {
+      *position = row;
+      }
+    return PostItem;
+    }
+  return NotExtraItem;
+}
+
+//------------------------------------------------------------------------------
+int qMRMLExtraItemsProxyModelPrivate::rowOffset(const QModelIndex& sourceParent)const
+{
+  if (!sourceParent.isValid())
+    {
+    return 0;
+    }
+  if (sourceParent.parent().isValid())
+    {
+    // only the top-level indexes and their children are mapped
+    return -1;
+    }
+  return sourceParent.row() == 0 ? this->PreItems.count() : 0;
+}
+
+//------------------------------------------------------------------------------
+// qMRMLExtraItemsProxyModel
+
+//------------------------------------------------------------------------------
+qMRMLExtraItemsProxyModel::qMRMLExtraItemsProxyModel(QObject *vparent)
+  : QAbstractProxyModel(vparent)
+  , d_ptr(new qMRMLExtraItemsProxyModelPrivate(*this))
+{
+}
+
+//------------------------------------------------------------------------------
+qMRMLExtraItemsProxyModel::~qMRMLExtraItemsProxyModel() = default;
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::setSourceModel(QAbstractItemModel* newSourceModel)
+{
+  if (newSourceModel == this->sourceModel())
+    {
+    return;
+    }
+  this->beginResetModel();
+  if (this->sourceModel())
+    {
+    QObject::disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+  this->Superclass::setSourceModel(newSourceModel);
+  if (newSourceModel)
+    {
+    this->connect(newSourceModel, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)),
+                  this, SLOT(onSourceRowsAboutToBeInserted(QModelIndex,int,int)));
+    this->connect(newSourceModel, SIGNAL(rowsInserted(QModelIndex,int,int)),
+                  this, SLOT(onSourceRowsInserted()));
+    this->connect(newSourceModel, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)),
+                  this, SLOT(onSourceRowsAboutToBeRemoved(QModelIndex,int,int)));
+    this->connect(newSourceModel, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+                  this, SLOT(onSourceRowsRemoved()));
+    this->connect(newSourceModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+                  this, SLOT(onSourceDataChanged(QModelIndex,QModelIndex)));
+    this->connect(newSourceModel, SIGNAL(modelAboutToBeReset()),
+                  this, SLOT(onSourceModelAboutToBeReset()));
+    this->connect(newSourceModel, SIGNAL(modelReset()),
+                  this, SLOT(onSourceModelReset()));
+    this->connect(newSourceModel, SIGNAL(layoutAboutToBeChanged()),
+                  this, SLOT(onSourceLayoutAboutToBeChanged()));
+    this->connect(newSourceModel, SIGNAL(layoutChanged()),
+                  this, SLOT(onSourceLayoutChanged()));
+    }
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::setPreItems(const QStringList& extraItems)
+{
+  Q_D(qMRMLExtraItemsProxyModel);
+  if (d->PreItems == extraItems)
+    {
+    return;
+    }
+  QModelIndex sceneIndex = this->index(0, 0);
+  if (!sceneIndex.isValid())
+    {
+    d->PreItems = extraItems;
+    return;
+    }
+  if (d->PreItems.count() == extraItems.count())
+    {
+    d->PreItems = extraItems;
+    emit dataChanged(this->index(0, 0, sceneIndex),
+                     this->index(extraItems.count() - 1, this->columnCount() - 1, sceneIndex));
+    return;
+    }
+  if (!d->PreItems.isEmpty())
+    {
+    this->beginRemoveRows(sceneIndex, 0, d->PreItems.count() - 1);
+    d->PreItems.clear();
+    this->endRemoveRows();
+    }
+  if (!extraItems.isEmpty())
+    {
+    this->beginInsertRows(sceneIndex, 0, extraItems.count() - 1);
+    d->PreItems = extraItems;
+    this->endInsertRows();
+    }
+}
+
+//------------------------------------------------------------------------------
+QStringList qMRMLExtraItemsProxyModel::preItems()const
+{
+  Q_D(const qMRMLExtraItemsProxyModel);
+  return d->PreItems;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::setPostItems(const QStringList& extraItems)
+{
+  Q_D(qMRMLExtraItemsProxyModel);
+  if (d->PostItems == extraItems)
+    {
+    return;
+    }
+  QModelIndex sceneIndex = this->index(0, 0);
+  if (!sceneIndex.isValid())
+    {
+    d->PostItems = extraItems;
+    return;
+    }
+  int firstPostItemRow = d->PreItems.count() + d->sourceSceneRowCount();
+  if (d->PostItems.count() == extraItems.count())
+    {
+    d->PostItems = extraItems;
+    emit dataChanged(this->index(firstPostItemRow, 0, sceneIndex),
+                     this->index(firstPostItemRow + extraItems.count() - 1, this->columnCount() - 1, sceneIndex));
+    return;
+    }
+  if (!d->PostItems.isEmpty())
+    {
+    this->beginRemoveRows(sceneIndex, firstPostItemRow, firstPostItemRow + d->PostItems.count() - 1);
+    d->PostItems.clear();
+    this->endRemoveRows();
+    }
+  if (!extraItems.isEmpty())
+    {
+    this->beginInsertRows(sceneIndex, firstPostItemRow, firstPostItemRow + extraItems.count() - 1);
+    d->PostItems = extraItems;
+    this->endInsertRows();
+    }
+}
+
+//------------------------------------------------------------------------------
+QStringList qMRMLExtraItemsProxyModel::postItems()const
+{
+  Q_D(const qMRMLExtraItemsProxyModel);
+  return d->PostItems;
+}
+
+//------------------------------------------------------------------------------
+int qMRMLExtraItemsProxyModel::extraItemColumn()const
+{
+  Q_D(const qMRMLExtraItemsProxyModel);
+  return d->ExtraItemColumn;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::setExtraItemColumn(int column)
+{
+  Q_D(qMRMLExtraItemsProxyModel);
+  if (d->ExtraItemColumn == column)
+    {
+    return;
+    }
+  this->beginResetModel();
+  d->ExtraItemColumn = column;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLExtraItemsProxyModel::mapFromSource(const QModelIndex& sourceIndex)const
+{
+  Q_D(const qMRMLExtraItemsProxyModel);
+  if (!sourceIndex.isValid())
+    {
+    return QModelIndex();
+    }
+  QModelIndex sourceParent = sourceIndex.parent();
+  if (!sourceParent.isValid())
+    {
+    return this->createIndex(sourceIndex.row(), sourceIndex.column(), TopLevelInternalId);
+    }
+  int offset = d->rowOffset(sourceParent);
+  if (offset < 0)
+    {
+    return QModelIndex();
+    }
+  return this->createIndex(sourceIndex.row() + offset, sourceIndex.column(),
+                           TopLevelInternalId + 1 + sourceParent.row());
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLExtraItemsProxyModel::mapToSource(const QModelIndex& proxyIndex)const
+{
+  Q_D(const qMRMLExtraItemsProxyModel);
+  QAbstractItemModel* sourceModel = this->sourceModel();
+  if (!proxyIndex.isValid() || !sourceModel)
+    {
+    return QModelIndex();
+    }
+  if (proxyIndex.internalId() == TopLevelInternalId)
+    {
+    return sourceModel->index(proxyIndex.row(), proxyIndex.column());
+    }
+  int parentRow = static_cast<int>(proxyIndex.internalId() - TopLevelInternalId - 1);
+  QModelIndex sourceParent = sourceModel->index(parentRow, 0);
+  int sourceRow = proxyIndex.row() - d->rowOffset(sourceParent);
+  if (sourceRow < 0 || sourceRow >= sourceModel->rowCount(sourceParent))
+    {
+    // extra item
+    return QModelIndex();
+    }
+  return sourceModel->index(sourceRow, proxyIndex.column(), sourceParent);
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLExtraItemsProxyModel::index(int row, int column, const QModelIndex &parent)const
+{
+  if (row < 0 || column < 0
+      || row >= this->rowCount(parent) || column >= this->columnCount(parent))
+    {
+    return QModelIndex();
+    }
+  if (!parent.isValid())
+    {
+    return this->createIndex(row, column, TopLevelInternalId);
+    }
+  if (parent.internalId() == TopLevelInternalId)
+    {
+    return this->createIndex(row, column, TopLevelInternalId + 1 + parent.row());
+    }
+  return QModelIndex();
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLExtraItemsProxyModel::parent(const QModelIndex &child)const
+{
+  if (!child.isValid() || child.internalId() == TopLevelInternalId)
+    {
+    return QModelIndex();
+    }
+  return this->createIndex(static_cast<int>(child.internalId() - TopLevelInternalId - 1),
+                           0, TopLevelInternalId);
+}
+
+//------------------------------------------------------------------------------
+int qMRMLExtraItemsProxyModel::rowCount(const QModelIndex &parent)const
+{
+  Q_D(const qMRMLExtraItemsProxyModel);
+  QAbstractItemModel* sourceModel = this->sourceModel();
+  if (!sourceModel)
+    {
+    return 0;
+    }
+  if (!parent.isValid())
+    {
+    return sourceModel->rowCount();
+    }
+  if (parent.internalId() != TopLevelInternalId || parent.column() != 0)
+    {
+    return 0;
+    }
+  int count = sourceModel->rowCount(this->mapToSource(parent));
+  if (d->isSceneIndex(parent))
+    {
+    count += d->PreItems.count() + d->PostItems.count();
+    }
+  return count;
+}
+
+//------------------------------------------------------------------------------
+int qMRMLExtraItemsProxyModel::columnCount(const QModelIndex &parent)const
+{
+  Q_UNUSED(parent);
+  QAbstractItemModel* sourceModel = this->sourceModel();
+  return sourceModel ? sourceModel->columnCount() : 0;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLExtraItemsProxyModel::hasChildren(const QModelIndex &parent)const
+{
+  return this->rowCount(parent) > 0;
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLExtraItemsProxyModel::data(const QModelIndex &index, int role)const
+{
+  Q_D(const qMRMLExtraItemsProxyModel);
+  int position = -1;
+  ExtraItemType type = d->extraItemType(index, &position);
+  if (type == NotExtraItem)
+    {
+    return this->Superclass::data(index, role);
+    }
+  if (index.column() != d->ExtraItemColumn)
+    {
+    return QVariant();
+    }
+  QString text = (type == PreItem ? d->PreItems[position] : d->PostItems[position]);
+  switch (role)
+    {
+    case qMRMLSceneModel::UIDRole:
+      return type == PreItem ? QString("preItem") : QString("postItem");
+    case Qt::AccessibleDescriptionRole:
+      return text == "separator" ? QVariant(text) : QVariant();
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+      return text == "separator" ? QVariant() : QVariant(text);
+    default:
+      break;
+    }
+  return QVariant();
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLExtraItemsProxyModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+  Q_D(qMRMLExtraItemsProxyModel);
+  if (d->extraItemType(index) != NotExtraItem)
+    {
+    return false;
+    }
+  return this->Superclass::setData(index, value, role);
+}
+
+//------------------------------------------------------------------------------
+Qt::ItemFlags qMRMLExtraItemsProxyModel::flags(const QModelIndex &index)const
+{
+  Q_D(const qMRMLExtraItemsProxyModel);
+  ExtraItemType type = d->extraItemType(index);
+  if (type == NotExtraItem)
+    {
+    return this->Superclass::flags(index);
+    }
+  if (index.column() != d->ExtraItemColumn)
+    {
+    return Qt::NoItemFlags;
+    }
+  Qt::ItemFlags extraItemFlags = Qt::ItemIsEnabled;
+  if (type == PreItem)
+    {
+    extraItemFlags |= Qt::ItemIsSelectable;
+    }
+  return extraItemFlags;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::onSourceRowsAboutToBeInserted(const QModelIndex& sourceParent, int start, int end)
+{
+  Q_D(qMRMLExtraItemsProxyModel);
+  int offset = d->rowOffset(sourceParent);
+  d->InsertingRows = (offset >= 0);
+  if (d->InsertingRows)
+    {
+    this->beginInsertRows(this->mapFromSource(sourceParent), start + offset, end + offset);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::onSourceRowsInserted()
+{
+  Q_D(qMRMLExtraItemsProxyModel);
+  if (d->InsertingRows)
+    {
+    d->InsertingRows = false;
+    this->endInsertRows();
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::onSourceRowsAboutToBeRemoved(const QModelIndex& sourceParent, int start, int end)
+{
+  Q_D(qMRMLExtraItemsProxyModel);
+  int offset = d->rowOffset(sourceParent);
+  d->RemovingRows = (offset >= 0);
+  if (d->RemovingRows)
+    {
+    this->beginRemoveRows(this->mapFromSource(sourceParent), start + offset, end + offset);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::onSourceRowsRemoved()
+{
+  Q_D(qMRMLExtraItemsProxyModel);
+  if (d->RemovingRows)
+    {
+    d->RemovingRows = false;
+    this->endRemoveRows();
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::onSourceDataChanged(const QModelIndex& sourceTopLeft,
+                                                    const QModelIndex& sourceBottomRight)
+{
+  QModelIndex topLeft = this->mapFromSource(sourceTopLeft);
+  QModelIndex bottomRight = this->mapFromSource(sourceBottomRight);
+  if (topLeft.isValid() && bottomRight.isValid())
+    {
+    emit dataChanged(topLeft, bottomRight);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::onSourceModelAboutToBeReset()
+{
+  this->beginResetModel();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::onSourceModelReset()
+{
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::onSourceLayoutAboutToBeChanged()
+{
+  Q_D(qMRMLExtraItemsProxyModel);
+  emit layoutAboutToBeChanged();
+  // The number of scene children may change (e.g. the sort filter proxy model
+  // is invalidated), the position of the post items is saved instead of their row.
+  d->LayoutChangePersistentItems.clear();
+  foreach(const QModelIndex& proxyIndex, this->persistentIndexList())
+    {
+    PersistentItem item;
+    item.ProxyIndex = proxyIndex;
+    item.ExtraItemPosition = -1;
+    item.Type = d->extraItemType(proxyIndex, &item.ExtraItemPosition);
+    if (item.Type == NotExtraItem)
+      {
+      item.SourceIndex = this->mapToSource(proxyIndex);
+      }
+    d->LayoutChangePersistentItems << item;
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLExtraItemsProxyModel::onSourceLayoutChanged()
+{
+  Q_D(qMRMLExtraItemsProxyModel);
+  QModelIndex sceneIndex = this->index(0, 0);
+  foreach(const PersistentItem& item, d->LayoutChangePersistentItems)
+    {
+    QModelIndex newProxyIndex;
+    switch (item.Type)
+      {
+      case PreItem:
+        newProxyIndex = this->index(item.ExtraItemPosition, item.ProxyIndex.column(), sceneIndex);
+        break;
+      case PostItem:
+        newProxyIndex = this->index(d->PreItems.count() + d->sourceSceneRowCount() + item.ExtraItemPosition,
+                                    item.ProxyIndex.column(), sceneIndex);
+        break;
+      default:
+        newProxyIndex = this->mapFromSource(item.SourceIndex);
+        break;
+      }
+    this->changePersistentIndex(item.ProxyIndex, newProxyIndex);
+    }
+  d->LayoutChangePersistentItems.clear();
+  emit layoutChanged();
+}
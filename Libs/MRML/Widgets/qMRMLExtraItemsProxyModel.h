@@ -0,0 +1,101 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qMRMLExtraItemsProxyModel_h
+#define __qMRMLExtraItemsProxyModel_h
+
+// Qt includes
+#include <QAbstractProxyModel>
+#include <QStringList>
+
+// CTK includes
+#include <ctkPimpl.h>
+
+// qMRML includes
+#include "qMRMLWidgetsExport.h"
+
+class qMRMLExtraItemsProxyModelPrivate;
+
+/// \brief Proxy model that adds extra items around the nodes of a scene model.
+///
+/// The extra items are displayed before (pre items) and after (post items)
+/// the children of the scene index (first top-level row of the source model),
+/// similarly to qMRMLSceneModel::setPreItems() and
+/// qMRMLSceneModel::setPostItems(). Extra items have the same roles as the
+/// ones of qMRMLSceneModel: qMRMLSceneModel::UIDRole is "preItem" or
+/// "postItem" and the "separator" item text is set to
+/// Qt::AccessibleDescriptionRole instead of Qt::DisplayRole.
+///
+/// It allows widgets to have their own extra items (e.g. "None" or
+/// "Create new node") on top of a source model shared with other widgets.
+/// Only the scene index and its direct children are mapped, it is intended to
+/// be used with flat models such as qMRMLVirtualSceneModel.
+/// \sa qMRMLSceneModel, qMRMLVirtualSceneModel
+class QMRML_WIDGETS_EXPORT qMRMLExtraItemsProxyModel : public QAbstractProxyModel
+{
+  Q_OBJECT
+  /// Column where the extra item text is displayed. 0 by default.
+  Q_PROPERTY (int extraItemColumn READ extraItemColumn WRITE setExtraItemColumn)
+
+public:
+  typedef QAbstractProxyModel Superclass;
+  qMRMLExtraItemsProxyModel(QObject *parent=nullptr);
+  ~qMRMLExtraItemsProxyModel() override;
+
+  void setSourceModel(QAbstractItemModel* sourceModel) override;
+
+  /// Items displayed before the nodes.
+  void setPreItems(const QStringList& extraItems);
+  QStringList preItems()const;
+
+  /// Items displayed after the nodes.
+  void setPostItems(const QStringList& extraItems);
+  QStringList postItems()const;
+
+  int extraItemColumn()const;
+  void setExtraItemColumn(int column);
+
+  QModelIndex mapFromSource(const QModelIndex& sourceIndex)const override;
+  QModelIndex mapToSource(const QModelIndex& proxyIndex)const override;
+
+  QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex())const override;
+  QModelIndex parent(const QModelIndex &child)const override;
+  int rowCount(const QModelIndex &parent = QModelIndex())const override;
+  int columnCount(const QModelIndex &parent = QModelIndex())const override;
+  bool hasChildren(const QModelIndex &parent = QModelIndex())const override;
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole)const override;
+  bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+  Qt::ItemFlags flags(const QModelIndex &index)const override;
+
+protected slots:
+  void onSourceRowsAboutToBeInserted(const QModelIndex& sourceParent, int start, int end);
+  void onSourceRowsInserted();
+  void onSourceRowsAboutToBeRemoved(const QModelIndex& sourceParent, int start, int end);
+  void onSourceRowsRemoved();
+  void onSourceDataChanged(const QModelIndex& sourceTopLeft, const QModelIndex& sourceBottomRight);
+  void onSourceModelAboutToBeReset();
+  void onSourceModelReset();
+  void onSourceLayoutAboutToBeChanged();
+  void onSourceLayoutChanged();
+
+protected:
+  QScopedPointer<qMRMLExtraItemsProxyModelPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qMRMLExtraItemsProxyModel);
+  Q_DISABLE_COPY(qMRMLExtraItemsProxyModel);
+};
+
+#endif
@@ -31,11 +31,13 @@
 #include <ctkComboBox.h>
 
 // MRMLWidgets includes
+#include "qMRMLExtraItemsProxyModel.h"
 #include "qMRMLNodeComboBoxDelegate.h"
 #include "qMRMLNodeComboBoxMenuDelegate.h"
 #include "qMRMLNodeComboBox_p.h"
 #include "qMRMLNodeFactory.h"
 #include "qMRMLSceneModel.h"
+#include "qMRMLVirtualSceneModel.h"
 
 // MRML includes
 #include <vtkMRMLNode.h>
@@ -48,6 +50,10 @@ qMRMLNodeComboBoxPrivate::qMRMLNodeComboBoxPrivate(qMRMLNodeComboBox& object)
   this->ComboBox = nullptr;
   this->MRMLNodeFactory = nullptr;
   this->MRMLSceneModel = nullptr;
+  this->SourceModel = nullptr;
+  this->SortFilterModel = nullptr;
+  this->SharedSceneModelSupported = true;
+  this->ExtraItemsModel = nullptr;
   this->NoneEnabled = false;
   this->AddEnabled = true;
   this->RemoveEnabled = true;
@@ -98,12 +104,16 @@ void qMRMLNodeComboBoxPrivate::init(QAbstractItemModel* model)
     }
   this->MRMLSceneModel = qobject_cast<qMRMLSceneModel*>(rootModel);
   Q_ASSERT(this->MRMLSceneModel);
+  this->SourceModel = model;
+  // Custom models can't be replaced by the shared scene model
+  this->SharedSceneModelSupported = (model == this->MRMLSceneModel);
   // no need to reset the root model index here as the model is not yet set
   this->updateNoneItem(false);
   this->updateActionItems(false);
 
   qMRMLSortFilterProxyModel* sortFilterModel = new qMRMLSortFilterProxyModel(q);
   sortFilterModel->setSourceModel(model);
+  this->SortFilterModel = sortFilterModel;
   this->setModel(sortFilterModel);
 
   // nodeTypeLabel() works only when the model is set.
@@ -223,10 +233,7 @@ void qMRMLNodeComboBoxPrivate::updateNoneItem(bool resetRootIndex)
   //QVariant currentNode =
   //  this->ComboBox->itemData(this->ComboBox->currentIndex(), qMRMLSceneModel::UIDRole);
   //qDebug() << "updateNoneItem: " << this->MRMLSceneModel->mrmlSceneItem();
-  if (this->MRMLSceneModel->mrmlSceneItem())
-    {
-    this->MRMLSceneModel->setPreItems(noneItem, this->MRMLSceneModel->mrmlSceneItem());
-    }
+  this->setPreItems(noneItem);
 /*  if (resetRootIndex)
     {
     this->ComboBox->setRootModelIndex(q->model()->index(0, 0));
@@ -291,7 +298,7 @@ void qMRMLNodeComboBoxPrivate::updateActionItems(bool resetRootIndex)
       extraItems.append(action->text());
       }
     }
-  this->MRMLSceneModel->setPostItems(extraItems, this->MRMLSceneModel->mrmlSceneItem());
+  this->setPostItems(extraItems);
   QObject::connect(this->ComboBox->view(), SIGNAL(clicked(QModelIndex)),
                    q, SLOT(activateExtraItem(QModelIndex)),
                    Qt::UniqueConnection);
@@ -337,8 +344,7 @@ void qMRMLNodeComboBoxPrivate::updateDelegate(bool force)
 // --------------------------------------------------------------------------
 bool qMRMLNodeComboBoxPrivate::hasPostItem(const QString& name)const
 {
-  foreach(const QString& item,
-          this->MRMLSceneModel->postItems(this->MRMLSceneModel->mrmlSceneItem()))
+  foreach(const QString& item, this->postItems())
     {
     if (item.startsWith(name))
       {
@@ -348,6 +354,103 @@ bool qMRMLNodeComboBoxPrivate::hasPostItem(const QString& name)const
   return false;
 }
 
+// --------------------------------------------------------------------------
+QStringList qMRMLNodeComboBoxPrivate::preItems()const
+{
+  if (this->ExtraItemsModel)
+    {
+    return this->ExtraItemsModel->preItems();
+    }
+  return this->MRMLSceneModel->preItems(this->MRMLSceneModel->mrmlSceneItem());
+}
+
+// --------------------------------------------------------------------------
+void qMRMLNodeComboBoxPrivate::setPreItems(const QStringList& extraItems)
+{
+  if (this->ExtraItemsModel)
+    {
+    this->ExtraItemsModel->setPreItems(extraItems);
+    }
+  else if (this->MRMLSceneModel->mrmlSceneItem())
+    {
+    this->MRMLSceneModel->setPreItems(extraItems, this->MRMLSceneModel->mrmlSceneItem());
+    }
+}
+
+// --------------------------------------------------------------------------
+QStringList qMRMLNodeComboBoxPrivate::postItems()const
+{
+  if (this->ExtraItemsModel)
+    {
+    return this->ExtraItemsModel->postItems();
+    }
+  return this->MRMLSceneModel->postItems(this->MRMLSceneModel->mrmlSceneItem());
+}
+
+// --------------------------------------------------------------------------
+void qMRMLNodeComboBoxPrivate::setPostItems(const QStringList& extraItems)
+{
+  if (this->ExtraItemsModel)
+    {
+    this->ExtraItemsModel->setPostItems(extraItems);
+    }
+  else
+    {
+    this->MRMLSceneModel->setPostItems(extraItems, this->MRMLSceneModel->mrmlSceneItem());
+    }
+}
+
+// --------------------------------------------------------------------------
+void qMRMLNodeComboBoxPrivate::setSceneModelMRMLScene(vtkMRMLScene* scene)
+{
+  if (!this->ExtraItemsModel)
+    {
+    this->MRMLSceneModel->setMRMLScene(scene);
+    return;
+    }
+  // Keep the previous shared model alive until the proxy model doesn't
+  // observe it anymore.
+  QSharedPointer<qMRMLVirtualSceneModel> previousModel = this->SharedModel;
+  this->SharedModel = qMRMLVirtualSceneModel::sharedModel(scene);
+  this->SortFilterModel->setSourceModel(this->SharedModel.data());
+}
+
+// --------------------------------------------------------------------------
+void qMRMLNodeComboBoxPrivate::setSharedSceneModel(bool shared)
+{
+  Q_Q(qMRMLNodeComboBox);
+  Q_ASSERT(q->mrmlScene() == nullptr);
+  if ((this->ExtraItemsModel != nullptr) == shared)
+    {
+    return;
+    }
+  QAbstractItemModel* oldModel = this->ComboBox->model();
+  qMRMLExtraItemsProxyModel* oldExtraItemsModel = this->ExtraItemsModel;
+  QAbstractItemModel* newModel = nullptr;
+  if (shared)
+    {
+    // The shared model is set when the scene is set
+    this->SortFilterModel->setSourceModel(nullptr);
+    this->ExtraItemsModel = new qMRMLExtraItemsProxyModel(q);
+    this->ExtraItemsModel->setExtraItemColumn(this->ComboBox->modelColumn());
+    this->ExtraItemsModel->setSourceModel(this->SortFilterModel);
+    newModel = this->ExtraItemsModel;
+    }
+  else
+    {
+    this->SharedModel.clear();
+    this->ExtraItemsModel = nullptr;
+    this->SortFilterModel->setSourceModel(this->SourceModel);
+    newModel = this->SortFilterModel;
+    }
+  QObject::disconnect(oldModel, nullptr, q, nullptr);
+  this->setModel(newModel);
+  if (!shared)
+    {
+    delete oldExtraItemsModel;
+    }
+}
+
 // --------------------------------------------------------------------------
 // qMRMLNodeComboBox
 
@@ -693,6 +796,10 @@ void qMRMLNodeComboBox::emitNodeActivated(int currentIndex)
 vtkMRMLScene* qMRMLNodeComboBox::mrmlScene()const
 {
   Q_D(const qMRMLNodeComboBox);
+  if (d->ExtraItemsModel)
+    {
+    return d->SharedModel ? d->SharedModel->mrmlScene() : nullptr;
+    }
   return d->MRMLSceneModel->mrmlScene();
 }
 
@@ -700,9 +807,7 @@ vtkMRMLScene* qMRMLNodeComboBox::mrmlScene()const
 int qMRMLNodeComboBox::nodeCount()const
 {
   Q_D(const qMRMLNodeComboBox);
-  int extraItemsCount =
-    d->MRMLSceneModel->preItems(d->MRMLSceneModel->mrmlSceneItem()).count()
-    + d->MRMLSceneModel->postItems(d->MRMLSceneModel->mrmlSceneItem()).count();
+  int extraItemsCount = d->preItems().count() + d->postItems().count();
   //qDebug() << d->MRMLSceneModel->invisibleRootItem() << d->MRMLSceneModel->mrmlSceneItem() << d->ComboBox->count() <<extraItemsCount;
   //printStandardItem(d->MRMLSceneModel->invisibleRootItem(), "  ");
   //qDebug() << d->ComboBox->rootModelIndex();
@@ -730,7 +835,7 @@ void qMRMLNodeComboBox::setMRMLScene(vtkMRMLScene* scene)
   // Be careful when commenting that out. you really need a good reason for
   // forcing a new set. You should probably expose
   // qMRMLSceneModel::UpdateScene() and make sure there is no nested calls
-  if (d->MRMLSceneModel->mrmlScene() == scene)
+  if (this->mrmlScene() == scene)
     {
     return ;
     }
@@ -742,7 +847,7 @@ void qMRMLNodeComboBox::setMRMLScene(vtkMRMLScene* scene)
 
   // Update factory
   d->MRMLNodeFactory->setMRMLScene(scene);
-  d->MRMLSceneModel->setMRMLScene(scene);
+  d->setSceneModelMRMLScene(scene);
   d->updateDefaultText();
   d->updateNoneItem(false);
   d->updateActionItems(false);
@@ -1055,8 +1160,9 @@ QList<vtkMRMLNode*> qMRMLNodeComboBox::nodes()const
 //--------------------------------------------------------------------------
 qMRMLSortFilterProxyModel* qMRMLNodeComboBox::sortFilterProxyModel()const
 {
-  Q_ASSERT(qobject_cast<qMRMLSortFilterProxyModel*>(this->model()));
-  return qobject_cast<qMRMLSortFilterProxyModel*>(this->model());
+  Q_D(const qMRMLNodeComboBox);
+  Q_ASSERT(d->SortFilterModel);
+  return d->SortFilterModel;
 }
 
 //--------------------------------------------------------------------------
@@ -1073,6 +1179,36 @@ qMRMLSceneModel* qMRMLNodeComboBox::sceneModel()const
   return this->sortFilterProxyModel()->sceneModel();
 }
 
+//--------------------------------------------------------------------------
+void qMRMLNodeComboBox::setSharedSceneModel(bool shared)
+{
+  Q_D(qMRMLNodeComboBox);
+  if (this->sharedSceneModel() == shared)
+    {
+    return;
+    }
+  if (shared && !d->SharedSceneModelSupported)
+    {
+    qWarning() << Q_FUNC_INFO << " failed: the combobox requires its own scene model";
+    return;
+    }
+  // The model is changed when there is no scene, the current node is
+  // restored once the scene is set back.
+  vtkMRMLScene* scene = this->mrmlScene();
+  QString currentNodeID = this->currentNodeID();
+  this->setMRMLScene(nullptr);
+  d->setSharedSceneModel(shared);
+  this->setCurrentNodeID(currentNodeID);
+  this->setMRMLScene(scene);
+}
+
+//--------------------------------------------------------------------------
+bool qMRMLNodeComboBox::sharedSceneModel()const
+{
+  Q_D(const qMRMLNodeComboBox);
+  return d->ExtraItemsModel != nullptr;
+}
+
 //--------------------------------------------------------------------------
 QAbstractItemModel* qMRMLNodeComboBox::rootModel()const
 {
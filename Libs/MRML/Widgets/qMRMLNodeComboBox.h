@@ -84,6 +84,19 @@ class QMRML_WIDGETS_EXPORT qMRMLNodeComboBox
 
   Q_PROPERTY(QComboBox::SizeAdjustPolicy sizeAdjustPolicy READ sizeAdjustPolicy WRITE setSizeAdjustPolicy)
 
+  /// This property controls whether the nodes are listed from a scene model
+  /// shared with all the other comboboxes of the scene (see
+  /// qMRMLVirtualSceneModel::sharedModel()) instead of a scene model owned by
+  /// the combobox. Sharing the scene model saves memory and event processing
+  /// time when many comboboxes observe the same scene. sceneModel() returns
+  /// nullptr when the scene model is shared.
+  /// False by default because code that accesses the scene model of the
+  /// combobox (sceneModel(), rootModel() or the source model of
+  /// sortFilterProxyModel()) requires an owned model. Module panels with
+  /// plain node selectors enable it in their .ui file.
+  /// \sa sharedSceneModel(), setSharedSceneModel()
+  Q_PROPERTY(bool sharedSceneModel READ sharedSceneModel WRITE setSharedSceneModel)
+
 public:
   typedef QWidget Superclass;
 
@@ -231,9 +244,20 @@ public:
   /// Retrieve the scene model internally used.
   /// The scene model is usually not used directly, but a sortFilterProxyModel
   /// is plugged in.
-  /// \sa sortFilterProxyModel()
+  /// Returns nullptr if the scene model is shared.
+  /// \sa sortFilterProxyModel(), sharedSceneModel
   qMRMLSceneModel* sceneModel()const;
 
+  /// Return true if the nodes are listed from a model shared with the other
+  /// comboboxes of the scene.
+  /// \sa sharedSceneModel
+  bool sharedSceneModel()const;
+  /// Set whether the nodes are listed from a model shared with the other
+  /// comboboxes of the scene. Not supported by comboboxes that require their
+  /// own scene model (e.g. qMRMLCheckableNodeComboBox).
+  /// \sa sharedSceneModel
+  void setSharedSceneModel(bool shared);
+
   /// Return the node factory used to create nodes when "Add Node"
   /// is selected (property \a AddEnabled should be true).
   /// A typical use would be to connect the node factory signal
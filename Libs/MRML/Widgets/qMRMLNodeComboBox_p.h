@@ -32,14 +32,19 @@
 // We mean it.
 //
 
+// Qt includes
+#include <QSharedPointer>
+
 // CTK includes
 #include <ctkPimpl.h>
 
 // qMRML includes
 #include "qMRMLNodeComboBox.h"
 class QComboBox;
+class qMRMLExtraItemsProxyModel;
 class qMRMLNodeFactory;
 class qMRMLSceneModel;
+class qMRMLVirtualSceneModel;
 
 #include "vtkWeakPointer.h"
 
@@ -66,9 +71,37 @@ public:
 
   bool hasPostItem(const QString& name)const;
 
+  /// Extra items are either in the scene model or, if the scene model is
+  /// shared, in the extra items proxy model.
+  QStringList preItems()const;
+  void setPreItems(const QStringList& extraItems);
+  QStringList postItems()const;
+  void setPostItems(const QStringList& extraItems);
+
+  /// Set the scene to the scene model or retrieve the shared model of the scene.
+  void setSceneModelMRMLScene(vtkMRMLScene* scene);
+  /// Switch the source of the sort filter proxy model between the scene model
+  /// and the shared model. The scene must be unset.
+  void setSharedSceneModel(bool shared);
+
   QComboBox*        ComboBox;
   qMRMLNodeFactory* MRMLNodeFactory;
   qMRMLSceneModel*  MRMLSceneModel;
+  /// Model given to init(), source model of the sort filter proxy model
+  /// when the scene model is not shared.
+  QAbstractItemModel* SourceModel;
+  qMRMLSortFilterProxyModel* SortFilterModel;
+
+  /// False if the combobox requires its own scene model (e.g. to store
+  /// item check states).
+  bool SharedSceneModelSupported;
+  /// Model shared with other comboboxes of the same scene, null if the
+  /// scene model is not shared or if there is no scene.
+  QSharedPointer<qMRMLVirtualSceneModel> SharedModel;
+  /// Adds the "None" and action items on top of the sort filter proxy model
+  /// when the scene model is shared, null otherwise.
+  qMRMLExtraItemsProxyModel* ExtraItemsModel;
+
   bool              NoneEnabled;
   bool              AddEnabled;
   bool              RemoveEnabled;
@@ -55,7 +55,9 @@
 #include <vtkContextMouseEvent.h>
 #include <vtkContextScene.h>
 #include <vtkContextView.h>
+#include <vtkDoubleArray.h>
 #include <vtkGL2PSExporter.h>
+#include <vtkIdTypeArray.h>
 #include <vtkNew.h>
 #include <vtkPen.h>
 #include <vtkPlot.h>
@@ -68,6 +70,325 @@
 #include <vtkTable.h>
 #include <vtkTextProperty.h>
 
+//--------------------------------------------------------------------------
+// qMRMLPlotSeriesLevelOfDetail methods
+
+namespace
+{
+/// Number of buckets (or samples) of a pyramid level merged into a bucket of the next level
+const int LevelOfDetailBucketSizeLog2 = 3;
+}
+
+const vtkIdType qMRMLPlotSeriesLevelOfDetail::MinimumNumberOfSamples = 100000;
+
+//---------------------------------------------------------------------------
+qMRMLPlotSeriesLevelOfDetail::qMRMLPlotSeriesLevelOfDetail()
+{
+  this->TableMTime = 0;
+  this->NumberOfSamples = 0;
+  this->VisibleTable = vtkSmartPointer<vtkTable>::New();
+  this->VisibleX = vtkSmartPointer<vtkDoubleArray>::New();
+  this->VisibleX->SetName("x");
+  this->VisibleTable->AddColumn(this->VisibleX);
+  this->VisibleY = vtkSmartPointer<vtkDoubleArray>::New();
+  this->VisibleY->SetName("y");
+  this->VisibleTable->AddColumn(this->VisibleY);
+  this->VisibleBeginRowId = -1;
+  this->VisibleEndRowId = -1;
+  this->VisibleLevel = -1;
+  this->OverviewLevel = -1;
+}
+
+//---------------------------------------------------------------------------
+bool qMRMLPlotSeriesLevelOfDetail::update(vtkTable* table,
+  const std::string& xColumnName, const std::string& yColumnName)
+{
+  vtkDataArray* xColumn = nullptr;
+  if (!xColumnName.empty())
+    {
+    xColumn = vtkDataArray::SafeDownCast(table->GetColumnByName(xColumnName.c_str()));
+    if (!xColumn)
+      {
+      return false;
+      }
+    }
+  vtkDataArray* yColumn = vtkDataArray::SafeDownCast(table->GetColumnByName(yColumnName.c_str()));
+  if (!yColumn)
+    {
+    return false;
+    }
+  if (table == this->Table && xColumn == this->XColumn && yColumn == this->YColumn
+    && table->GetMTime() == this->TableMTime)
+    {
+    // up-to-date
+    return !this->Levels.empty();
+    }
+
+  this->Table = table;
+  this->XColumn = xColumn;
+  this->YColumn = yColumn;
+  this->TableMTime = table->GetMTime();
+  this->NumberOfSamples = table->GetNumberOfRows();
+  this->Levels.clear();
+  // force update of the visible table
+  this->VisibleLevel = -1;
+
+  if (this->NumberOfSamples < 1
+    || yColumn->GetNumberOfComponents() != 1 || (xColumn && xColumn->GetNumberOfComponents() != 1))
+    {
+    return false;
+    }
+
+  // Min/max buckets only preserve the shape of the curve if X values are sorted
+  if (xColumn)
+    {
+    double previousX = xColumn->GetTuple1(0);
+    for (vtkIdType rowId = 1; rowId < this->NumberOfSamples; ++rowId)
+      {
+      double x = xColumn->GetTuple1(rowId);
+      if (x < previousX)
+        {
+        return false;
+        }
+      previousX = x;
+      }
+    }
+
+  // First level is computed from the samples, next levels from the previous level
+  const vtkIdType bucketSize = (1 << LevelOfDetailBucketSizeLog2);
+  vtkIdType numberOfBuckets = (this->NumberOfSamples + bucketSize - 1) / bucketSize;
+  std::vector<vtkIdType> level(2 * numberOfBuckets);
+  for (vtkIdType bucketIndex = 0; bucketIndex < numberOfBuckets; ++bucketIndex)
+    {
+    vtkIdType minRowId = bucketIndex * bucketSize;
+    vtkIdType maxRowId = minRowId;
+    double minY = yColumn->GetTuple1(minRowId);
+    double maxY = minY;
+    vtkIdType endRowId = std::min(minRowId + bucketSize, this->NumberOfSamples);
+    for (vtkIdType rowId = minRowId + 1; rowId < endRowId; ++rowId)
+      {
+      double y = yColumn->GetTuple1(rowId);
+      if (y < minY)
+        {
+        minY = y;
+        minRowId = rowId;
+        }
+      if (y > maxY)
+        {
+        maxY = y;
+        maxRowId = rowId;
+        }
+      }
+    level[2 * bucketIndex] = minRowId;
+    level[2 * bucketIndex + 1] = maxRowId;
+    }
+  this->Levels.push_back(level);
+
+  while (numberOfBuckets > 1)
+    {
+    const std::vector<vtkIdType>& previousLevel = this->Levels.back();
+    vtkIdType previousNumberOfBuckets = numberOfBuckets;
+    numberOfBuckets = (previousNumberOfBuckets + bucketSize - 1) / bucketSize;
+    std::vector<vtkIdType> nextLevel(2 * numberOfBuckets);
+    for (vtkIdType bucketIndex = 0; bucketIndex < numberOfBuckets; ++bucketIndex)
+      {
+      vtkIdType previousBucketIndex = bucketIndex * bucketSize;
+      vtkIdType minRowId = previousLevel[2 * previousBucketIndex];
+      vtkIdType maxRowId = previousLevel[2 * previousBucketIndex + 1];
+      double minY = yColumn->GetTuple1(minRowId);
+      double maxY = yColumn->GetTuple1(maxRowId);
+      vtkIdType endBucketIndex = std::min(previousBucketIndex + bucketSize, previousNumberOfBuckets);
+      for (++previousBucketIndex; previousBucketIndex < endBucketIndex; ++previousBucketIndex)
+        {
+        vtkIdType rowId = previousLevel[2 * previousBucketIndex];
+        double y = yColumn->GetTuple1(rowId);
+        if (y < minY)
+          {
+          minY = y;
+          minRowId = rowId;
+          }
+        rowId = previousLevel[2 * previousBucketIndex + 1];
+        y = yColumn->GetTuple1(rowId);
+        if (y > maxY)
+          {
+          maxY = y;
+          maxRowId = rowId;
+          }
+        }
+      nextLevel[2 * bucketIndex] = minRowId;
+      nextLevel[2 * bucketIndex + 1] = maxRowId;
+      }
+    this->Levels.push_back(nextLevel);
+    }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+double qMRMLPlotSeriesLevelOfDetail::xValue(vtkIdType rowId)const
+{
+  return this->XColumn ? this->XColumn->GetTuple1(rowId) : static_cast<double>(rowId);
+}
+
+//---------------------------------------------------------------------------
+vtkIdType qMRMLPlotSeriesLevelOfDetail::bucketSize(int level)const
+{
+  return static_cast<vtkIdType>(1) << (LevelOfDetailBucketSizeLog2 * level);
+}
+
+//---------------------------------------------------------------------------
+int qMRMLPlotSeriesLevelOfDetail::levelForNumberOfSamples(vtkIdType numberOfSamples, int maximumNumberOfBuckets)const
+{
+  // Level 0 is the samples themselves
+  int level = 0;
+  while (level < static_cast<int>(this->Levels.size())
+    && numberOfSamples > this->bucketSize(level) * maximumNumberOfBuckets)
+    {
+    ++level;
+    }
+  return level;
+}
+
+//---------------------------------------------------------------------------
+bool qMRMLPlotSeriesLevelOfDetail::updateVisibleTable(const double visibleXRange[2], int viewWidth)
+{
+  if (this->Levels.empty() || !this->YColumn)
+    {
+    return false;
+    }
+  viewWidth = std::max(viewWidth, 1);
+
+  // Visible rows, including the samples just outside the range so that
+  // the line continues to the border of the view
+  vtkIdType beginRowId = 0;
+  vtkIdType endRowId = this->NumberOfSamples;
+  if (visibleXRange[0] <= visibleXRange[1])
+    {
+    vtkIdType low = 0;
+    vtkIdType high = this->NumberOfSamples;
+    while (low < high)
+      {
+      vtkIdType middle = low + (high - low) / 2;
+      if (this->xValue(middle) < visibleXRange[0])
+        {
+        low = middle + 1;
+        }
+      else
+        {
+        high = middle;
+        }
+      }
+    beginRowId = std::max(low - 1, static_cast<vtkIdType>(0));
+    high = this->NumberOfSamples;
+    while (low < high)
+      {
+      vtkIdType middle = low + (high - low) / 2;
+      if (this->xValue(middle) <= visibleXRange[1])
+        {
+        low = middle + 1;
+        }
+      else
+        {
+        high = middle;
+        }
+      }
+    endRowId = std::min(low + 1, this->NumberOfSamples);
+    }
+
+  // The rest of the series is displayed at the resolution of the whole series
+  // in the view. The visible range is aligned to buckets of that level so that
+  // the buckets of the finer level exactly cover it.
+  int overviewLevel = this->levelForNumberOfSamples(this->NumberOfSamples, viewWidth);
+  vtkIdType overviewBucketSize = this->bucketSize(overviewLevel);
+  beginRowId = (beginRowId / overviewBucketSize) * overviewBucketSize;
+  endRowId = std::min(((endRowId + overviewBucketSize - 1) / overviewBucketSize) * overviewBucketSize,
+    this->NumberOfSamples);
+  int visibleLevel = std::min(this->levelForNumberOfSamples(endRowId - beginRowId, viewWidth), overviewLevel);
+
+  if (beginRowId == this->VisibleBeginRowId && endRowId == this->VisibleEndRowId
+    && visibleLevel == this->VisibleLevel && overviewLevel == this->OverviewLevel)
+    {
+    // no change
+    return false;
+    }
+  this->VisibleBeginRowId = beginRowId;
+  this->VisibleEndRowId = endRowId;
+  this->VisibleLevel = visibleLevel;
+  this->OverviewLevel = overviewLevel;
+
+  this->VisibleRowIds.clear();
+  // First and last samples are always kept to preserve the X bounds
+  this->appendRow(0);
+  this->appendRange(0, beginRowId, overviewLevel);
+  this->appendRange(beginRowId, endRowId, visibleLevel);
+  this->appendRange(endRowId, this->NumberOfSamples, overviewLevel);
+  this->appendRow(this->NumberOfSamples - 1);
+
+  vtkIdType numberOfVisibleRows = static_cast<vtkIdType>(this->VisibleRowIds.size());
+  this->VisibleX->SetNumberOfTuples(numberOfVisibleRows);
+  this->VisibleY->SetNumberOfTuples(numberOfVisibleRows);
+  for (vtkIdType visibleRowId = 0; visibleRowId < numberOfVisibleRows; ++visibleRowId)
+    {
+    vtkIdType rowId = this->VisibleRowIds[visibleRowId];
+    this->VisibleX->SetValue(visibleRowId, this->xValue(rowId));
+    this->VisibleY->SetValue(visibleRowId, this->YColumn->GetTuple1(rowId));
+    }
+  this->VisibleX->Modified();
+  this->VisibleY->Modified();
+  this->VisibleTable->Modified();
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void qMRMLPlotSeriesLevelOfDetail::appendRange(vtkIdType beginRowId, vtkIdType endRowId, int level)
+{
+  if (level == 0)
+    {
+    for (vtkIdType rowId = beginRowId; rowId < endRowId; ++rowId)
+      {
+      this->appendRow(rowId);
+      }
+    return;
+    }
+  const std::vector<vtkIdType>& buckets = this->Levels[level - 1];
+  vtkIdType bucketSize = this->bucketSize(level);
+  vtkIdType endBucketIndex = (endRowId + bucketSize - 1) / bucketSize;
+  for (vtkIdType bucketIndex = beginRowId / bucketSize; bucketIndex < endBucketIndex; ++bucketIndex)
+    {
+    // Extrema are added in the order of the samples to keep X values sorted
+    vtkIdType minRowId = buckets[2 * bucketIndex];
+    vtkIdType maxRowId = buckets[2 * bucketIndex + 1];
+    this->appendRow(std::min(minRowId, maxRowId));
+    this->appendRow(std::max(minRowId, maxRowId));
+    }
+}
+
+//---------------------------------------------------------------------------
+void qMRMLPlotSeriesLevelOfDetail::appendRow(vtkIdType rowId)
+{
+  if (!this->VisibleRowIds.empty() && rowId <= this->VisibleRowIds.back())
+    {
+    // already added
+    return;
+    }
+  this->VisibleRowIds.push_back(rowId);
+}
+
+//---------------------------------------------------------------------------
+vtkTable* qMRMLPlotSeriesLevelOfDetail::visibleTable()const
+{
+  return this->VisibleTable;
+}
+
+//---------------------------------------------------------------------------
+vtkIdType qMRMLPlotSeriesLevelOfDetail::originalRowId(vtkIdType visibleRowId)const
+{
+  if (visibleRowId < 0 || visibleRowId >= static_cast<vtkIdType>(this->VisibleRowIds.size()))
+    {
+    return -1;
+    }
+  return this->VisibleRowIds[visibleRowId];
+}
+
 //--------------------------------------------------------------------------
 // qMRMLPlotViewPrivate methods
 
@@ -81,6 +402,7 @@ qMRMLPlotViewPrivate::qMRMLPlotViewPrivate(qMRMLPlotView& object)
   //this->PinButton = 0;
 //  this->PopupWidget = 0;
   this->UpdatingWidgetFromMRML = false;
+  this->XAxisRangeComputed = false;
 }
 
 //---------------------------------------------------------------------------
@@ -99,6 +421,7 @@ void qMRMLPlotViewPrivate::init()
 
   qvtkConnect(q->chart(), vtkCommand::SelectionChangedEvent, this, SLOT(emitSelection()));
   qvtkConnect(q->chart(), vtkCommand::InteractionEvent, q, SLOT(updateMRMLChartAxisRangeFromWidget()));
+  qvtkConnect(q->chart(), vtkCommand::InteractionEvent, this, SLOT(onChartInteraction()));
 
   if (!q->chart()->GetBackgroundBrush() ||
       !q->chart()->GetTitleProperties() ||
@@ -234,9 +557,54 @@ void qMRMLPlotViewPrivate::adjustRangeForLogScale(double range[2], double comput
     }
 }
 
+// --------------------------------------------------------------------------
+void qMRMLPlotViewPrivate::updateLevelOfDetail()
+{
+  Q_Q(qMRMLPlotView);
+  if (this->MapPlotToLevelOfDetail.isEmpty() || !q->chart())
+    {
+    return;
+    }
+
+  // The chart only computes an automatic X range when it is rendered, the
+  // whole series is used until the range is known (zoom, pan or fit).
+  double visibleXRange[2] = { 1.0, 0.0 };
+  vtkAxis* bottomAxis = q->chart()->GetAxis(vtkAxis::BOTTOM);
+  if (bottomAxis && (bottomAxis->GetBehavior() != vtkAxis::AUTO || this->XAxisRangeComputed))
+    {
+    bottomAxis->GetUnscaledRange(visibleXRange);
+    }
+
+  bool modified = false;
+  QMap< vtkPlot*, QSharedPointer<qMRMLPlotSeriesLevelOfDetail> >::iterator levelOfDetailIt;
+  for (levelOfDetailIt = this->MapPlotToLevelOfDetail.begin();
+    levelOfDetailIt != this->MapPlotToLevelOfDetail.end(); ++levelOfDetailIt)
+    {
+    if (levelOfDetailIt.value()->updateVisibleTable(visibleXRange, q->width()))
+      {
+      // selected point indices refer to the previous points
+      levelOfDetailIt.key()->SetSelection(nullptr);
+      modified = true;
+      }
+    }
+  if (modified)
+    {
+    q->scene()->SetDirty(true);
+    }
+}
+
+// --------------------------------------------------------------------------
+void qMRMLPlotViewPrivate::onChartInteraction()
+{
+  // Zoom and pan set the axis range, a finer level may be needed
+  this->XAxisRangeComputed = true;
+  this->updateLevelOfDetail();
+}
+
 // --------------------------------------------------------------------------
 vtkSmartPointer<vtkPlot> qMRMLPlotViewPrivate::updatePlotFromPlotSeriesNode(vtkMRMLPlotSeriesNode* plotSeriesNode, vtkPlot* existingPlot)
 {
+  Q_Q(qMRMLPlotView);
   if (plotSeriesNode == nullptr)
     {
     return nullptr;
@@ -358,15 +726,50 @@ vtkSmartPointer<vtkPlot> qMRMLPlotViewPrivate::updatePlotFromPlotSeriesNode(vtkM
     plotLine->SetMarkerStyle(markerStyleVtk);
     }
 
+  // Lines of series that have many more samples than the view has pixels are
+  // displayed from a downsampling pyramid. Not used when points can be moved,
+  // as the chart would then modify the downsampled table.
+  QSharedPointer<qMRMLPlotSeriesLevelOfDetail> levelOfDetail;
+  if (plotLine && plotSeriesNode->GetLineStyle() != vtkMRMLPlotSeriesNode::LineStyleNone
+    && table->GetNumberOfRows() > qMRMLPlotSeriesLevelOfDetail::MinimumNumberOfSamples
+    && !q->chart()->GetDragPointAlongX() && !q->chart()->GetDragPointAlongY())
+    {
+    levelOfDetail = this->MapPlotToLevelOfDetail.value(newPlot);
+    if (!levelOfDetail)
+      {
+      levelOfDetail = QSharedPointer<qMRMLPlotSeriesLevelOfDetail>(new qMRMLPlotSeriesLevelOfDetail);
+      }
+    if (!levelOfDetail->update(table, plotSeriesNode->IsXColumnRequired() ? xColumnName : std::string(), yColumnName))
+      {
+      levelOfDetail.clear();
+      }
+    }
+  if (levelOfDetail)
+    {
+    this->MapPlotToLevelOfDetail[newPlot] = levelOfDetail;
+    }
+  else
+    {
+    this->MapPlotToLevelOfDetail.remove(newPlot);
+    }
+
   vtkStringArray* labelArray = nullptr;
   std::string labelColumnName = plotSeriesNode->GetLabelColumnName();
-  if (!labelColumnName.empty())
+  if (!labelColumnName.empty() && !levelOfDetail)
     {
     labelArray = vtkStringArray::SafeDownCast(table->GetColumnByName(labelColumnName.c_str()));
     }
   newPlot->SetIndexedLabels(labelArray);
 
-  if (plotSeriesNode->IsXColumnRequired())
+  if (levelOfDetail)
+    {
+    // Only the points needed for the displayed range are sent to the chart,
+    // they are computed in updateLevelOfDetail() once the axis range is set
+    newPlot->SetUseIndexForXSeries(false);
+    newPlot->SetInputData(levelOfDetail->visibleTable(), "x", "y");
+    newPlot->SetTooltipLabelFormat("%l = (%x, %y)");
+    }
+  else if (plotSeriesNode->IsXColumnRequired())
     {
     newPlot->SetUseIndexForXSeries(false);
     newPlot->SetInputData(table, xColumnName, yColumnName);
@@ -601,6 +1004,7 @@ void qMRMLPlotViewPrivate::RecalculateBounds()
 
   //q->chart()->RecalculatePlotTransforms();
 
+  this->XAxisRangeComputed = true;
   q->updateMRMLChartAxisRangeFromWidget();
 }
 
@@ -655,7 +1059,22 @@ void qMRMLPlotViewPrivate::emitSelection()
 
     if (selection->GetNumberOfValues() > 0)
       {
-      selectionCol->AddItem(selection);
+      QSharedPointer<qMRMLPlotSeriesLevelOfDetail> levelOfDetail = this->MapPlotToLevelOfDetail.value(plot);
+      if (levelOfDetail)
+        {
+        // Selection is made on the downsampled points, report the rows of the series table
+        vtkNew<vtkIdTypeArray> seriesSelection;
+        seriesSelection->SetNumberOfValues(selection->GetNumberOfValues());
+        for (vtkIdType index = 0; index < selection->GetNumberOfValues(); ++index)
+          {
+          seriesSelection->SetValue(index, levelOfDetail->originalRowId(selection->GetValue(index)));
+          }
+        selectionCol->AddItem(seriesSelection.GetPointer());
+        }
+      else
+        {
+        selectionCol->AddItem(selection);
+        }
       vtkMRMLPlotSeriesNode* plotSeriesNode = this->plotSeriesNodeFromPlot(plot);
       if (plotSeriesNode)
         {
@@ -740,6 +1159,7 @@ void qMRMLPlotViewPrivate::updateWidgetFromMRML()
       q->removePlot(q->chart()->GetPlot(0));
       }
     this->MapPlotToPlotSeriesNodeID.clear();
+    this->MapPlotToLevelOfDetail.clear();
     this->UpdatingWidgetFromMRML = false;
     return;
     }
@@ -797,6 +1217,7 @@ void qMRMLPlotViewPrivate::updateWidgetFromMRML()
         {
         this->MapPlotToPlotSeriesNodeID[plot] = plotSeriesNode->GetID();
         q->addPlot(newPlot);
+        this->XAxisRangeComputed = false;
         }
       }
 
@@ -814,6 +1235,8 @@ void qMRMLPlotViewPrivate::updateWidgetFromMRML()
 
       q->removePlot(plot);
       this->MapPlotToPlotSeriesNodeID.remove(plot);
+      this->MapPlotToLevelOfDetail.remove(plot);
+      this->XAxisRangeComputed = false;
       }
     }
 
@@ -833,6 +1256,7 @@ void qMRMLPlotViewPrivate::updateWidgetFromMRML()
       }
     this->MapPlotToPlotSeriesNodeID[newPlot] = plotSeriesNode->GetID();
     q->addPlot(newPlot);
+    this->XAxisRangeComputed = false;
     }
 
   int fontTypeIndex = q->chart()->GetTitleProperties()->GetFontFamilyFromString(plotChartNode->GetFontType() ? plotChartNode->GetFontType() : "Arial");
@@ -941,6 +1365,8 @@ void qMRMLPlotViewPrivate::updateWidgetFromMRML()
     axis->GetLabelProperties()->SetFontSize(plotChartNode->GetAxisLabelFontSize());
     }
 
+  this->updateLevelOfDetail();
+
   q->scene()->SetDirty(true);
   this->UpdatingWidgetFromMRML = false;
 }
@@ -1063,6 +1489,15 @@ void qMRMLPlotView::keyReleaseEvent(QKeyEvent *event)
   this->Superclass::keyPressEvent(event);
 }
 
+// --------------------------------------------------------------------------
+void qMRMLPlotView::resizeEvent(QResizeEvent* event)
+{
+  Q_D(qMRMLPlotView);
+  this->Superclass::resizeEvent(event);
+  // The number of points of downsampled series depends on the view width
+  d->updateLevelOfDetail();
+}
+
 // --------------------------------------------------------------------------
 void qMRMLPlotView::fitToContent()
 {
@@ -104,6 +104,9 @@ protected:
 
   void keyReleaseEvent(QKeyEvent* event) override;
 
+  /// Update downsampled series for the new view width
+  void resizeEvent(QResizeEvent* event) override;
+
 private:
   Q_DECLARE_PRIVATE(qMRMLPlotView);
   Q_DISABLE_COPY(qMRMLPlotView);
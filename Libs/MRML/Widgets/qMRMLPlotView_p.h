@@ -34,6 +34,11 @@
 // Qt includes
 class QToolButton;
 #include <QMap>
+#include <QSharedPointer>
+
+// STD includes
+#include <string>
+#include <vector>
 
 // VTK includes
 #include <vtkWeakPointer.h>
@@ -50,12 +55,78 @@ class QToolButton;
 #include <vtkSmartPointer.h>
 class vtkPlot;
 
+class vtkDataArray;
+class vtkDoubleArray;
 class vtkMRMLPlotSeriesNode;
 class vtkMRMLPlotViewNode;
 class vtkMRMLPlotChartNode;
 class vtkObject;
 class vtkPlot;
 class vtkStringArray;
+class vtkTable;
+
+//-----------------------------------------------------------------------------
+/// \brief Min/max preserving downsampling pyramid of a line plot series.
+///
+/// Series that have many more samples than the view has pixels are not
+/// passed to the chart at full resolution. Each pyramid level stores the
+/// row of the minimum and maximum Y value of consecutive buckets of samples.
+/// The samples in the visible X range are replaced by the extrema of the
+/// level that matches the view width and the rest of the series by a coarse
+/// overview, so that the shape of the curve and the plot bounds are exact.
+///
+/// The pyramid is built once and only rebuilt when the table is modified.
+/// X values must be sorted.
+class QMRML_WIDGETS_EXPORT qMRMLPlotSeriesLevelOfDetail
+{
+public:
+  qMRMLPlotSeriesLevelOfDetail();
+
+  /// Build the pyramid if the table or the columns changed since the last call.
+  /// If \a xColumnName is empty then the row index is used as X value.
+  /// Returns false if the series cannot be downsampled (non-numeric column or unsorted X values).
+  bool update(vtkTable* table, const std::string& xColumnName, const std::string& yColumnName);
+
+  /// Update the points of the visible table for the displayed X range and
+  /// view width (in pixels). Returns true if the visible table has changed.
+  bool updateVisibleTable(const double visibleXRange[2], int viewWidth);
+
+  /// Table of the points to display, it contains a "x" and a "y" column.
+  vtkTable* visibleTable()const;
+
+  /// Row of the series table that a row of the visible table was taken from.
+  vtkIdType originalRowId(vtkIdType visibleRowId)const;
+
+  /// Series with fewer samples are displayed at full resolution.
+  static const vtkIdType MinimumNumberOfSamples;
+
+protected:
+  double xValue(vtkIdType rowId)const;
+  vtkIdType bucketSize(int level)const;
+  int levelForNumberOfSamples(vtkIdType numberOfSamples, int maximumNumberOfBuckets)const;
+  void appendRange(vtkIdType beginRowId, vtkIdType endRowId, int level);
+  void appendRow(vtkIdType rowId);
+
+  vtkWeakPointer<vtkTable> Table;
+  vtkWeakPointer<vtkDataArray> XColumn;
+  vtkWeakPointer<vtkDataArray> YColumn;
+  vtkMTimeType TableMTime;
+  vtkIdType NumberOfSamples;
+
+  /// Levels[i] contains the rows of the minimum and maximum Y value of each
+  /// bucket of bucketSize(i+1) samples, interleaved.
+  std::vector< std::vector<vtkIdType> > Levels;
+
+  vtkSmartPointer<vtkTable> VisibleTable;
+  vtkSmartPointer<vtkDoubleArray> VisibleX;
+  vtkSmartPointer<vtkDoubleArray> VisibleY;
+  std::vector<vtkIdType> VisibleRowIds;
+  /// Parameters the visible table was computed for
+  vtkIdType VisibleBeginRowId;
+  vtkIdType VisibleEndRowId;
+  int VisibleLevel;
+  int OverviewLevel;
+};
 
 //-----------------------------------------------------------------------------
 class qMRMLPlotViewPrivate: public QObject
@@ -83,6 +154,10 @@ public:
   // Adjust range to make it displayable with logarithmic scale
   void adjustRangeForLogScale(double range[2], double computedLimit[2]);
 
+  // Update the points sent to the chart for downsampled series from the
+  // current X axis range and view width
+  void updateLevelOfDetail();
+
 public slots:
   /// Handle MRML scene event
   void startProcessing();
@@ -96,6 +171,8 @@ public slots:
 
   void emitSelection();
 
+  void onChartInteraction();
+
 protected:
 
   vtkWeakPointer<vtkMRMLScene>         MRMLScene;
@@ -106,8 +183,13 @@ protected:
 //  ctkPopupWidget*                    PopupWidget;
 
   bool                               UpdatingWidgetFromMRML;
+  /// Set when the current X axis range is known (interaction or fit to
+  /// content), reset when plots are added or removed.
+  bool                               XAxisRangeComputed;
 
   QMap< vtkPlot*, QString > MapPlotToPlotSeriesNodeID;
+  /// Downsampling pyramid of the plots of large series
+  QMap< vtkPlot*, QSharedPointer<qMRMLPlotSeriesLevelOfDetail> > MapPlotToLevelOfDetail;
 };
 
 #endif
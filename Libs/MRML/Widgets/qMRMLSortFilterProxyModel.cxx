@@ -23,6 +23,7 @@
 // qMRML includes
 #include "qMRMLSceneModel.h"
 #include "qMRMLSortFilterProxyModel.h"
+#include "qMRMLVirtualSceneModel.h"
 
 // VTK includes
 #include <vtkMRMLNode.h>
@@ -97,6 +98,11 @@ QStandardItem* qMRMLSortFilterProxyModel::sourceItem(const QModelIndex& sourceIn
 vtkMRMLScene* qMRMLSortFilterProxyModel::mrmlScene()const
 {
   qMRMLSceneModel* sceneModel = qobject_cast<qMRMLSceneModel*>(this->sourceModel());
+  if (sceneModel == nullptr)
+    {
+    qMRMLVirtualSceneModel* virtualSceneModel = this->virtualSceneModel();
+    return virtualSceneModel ? virtualSceneModel->mrmlScene() : nullptr;
+    }
   return sceneModel->mrmlScene();
 }
 
@@ -104,6 +110,11 @@ vtkMRMLScene* qMRMLSortFilterProxyModel::mrmlScene()const
 QModelIndex qMRMLSortFilterProxyModel::mrmlSceneIndex()const
 {
   qMRMLSceneModel* sceneModel = qobject_cast<qMRMLSceneModel*>(this->sourceModel());
+  if (sceneModel == nullptr)
+    {
+    qMRMLVirtualSceneModel* virtualSceneModel = this->virtualSceneModel();
+    return virtualSceneModel ? this->mapFromSource(virtualSceneModel->mrmlSceneIndex()) : QModelIndex();
+    }
   return this->mapFromSource(sceneModel->mrmlSceneIndex());
 }
 
@@ -111,6 +122,11 @@ QModelIndex qMRMLSortFilterProxyModel::mrmlSceneIndex()const
 vtkMRMLNode* qMRMLSortFilterProxyModel::mrmlNodeFromIndex(const QModelIndex& proxyIndex)const
 {
   qMRMLSceneModel* sceneModel = qobject_cast<qMRMLSceneModel*>(this->sourceModel());
+  if (sceneModel == nullptr)
+    {
+    qMRMLVirtualSceneModel* virtualSceneModel = this->virtualSceneModel();
+    return virtualSceneModel ? virtualSceneModel->mrmlNodeFromIndex(this->mapToSource(proxyIndex)) : nullptr;
+    }
   return sceneModel->mrmlNodeFromIndex(this->mapToSource(proxyIndex));
 }
 
@@ -118,6 +134,11 @@ vtkMRMLNode* qMRMLSortFilterProxyModel::mrmlNodeFromIndex(const QModelIndex& pro
 QModelIndex qMRMLSortFilterProxyModel::indexFromMRMLNode(vtkMRMLNode* node, int column)const
 {
   qMRMLSceneModel* sceneModel = qobject_cast<qMRMLSceneModel*>(this->sourceModel());
+  if (sceneModel == nullptr)
+    {
+    qMRMLVirtualSceneModel* virtualSceneModel = this->virtualSceneModel();
+    return virtualSceneModel ? this->mapFromSource(virtualSceneModel->indexFromNode(node, column)) : QModelIndex();
+    }
   return this->mapFromSource(sceneModel->indexFromNode(node, column));
 }
 
@@ -167,6 +188,19 @@ QVariant qMRMLSortFilterProxyModel::attributeFilter(const QString& nodeType,
 //------------------------------------------------------------------------------
 bool qMRMLSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent)const
 {
+  qMRMLVirtualSceneModel* virtualSceneModel = this->virtualSceneModel();
+  if (virtualSceneModel)
+    {
+    // Virtual models have no items, the node is retrieved from the index directly
+    vtkMRMLNode* node = virtualSceneModel->mrmlNodeFromIndex(
+      virtualSceneModel->index(source_row, 0, source_parent));
+    AcceptType accept = this->filterAcceptsNode(node);
+    if (accept == AcceptButPotentiallyRejectable)
+      {
+      return this->QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
+      }
+    return (accept == Accept);
+    }
   QStandardItem* parentItem = this->sourceItem(source_parent);
   if (parentItem == nullptr)
     {
@@ -212,6 +246,7 @@ qMRMLSortFilterProxyModel::AcceptType qMRMLSortFilterProxyModel
 {
   Q_D(const qMRMLSortFilterProxyModel);
   qMRMLSceneModel* sceneModel = qobject_cast<qMRMLSceneModel*>(this->sourceModel());
+  vtkMRMLScene* scene = this->mrmlScene();
   if (!node || !node->GetID())
     {
     return Accept;
@@ -252,9 +287,10 @@ qMRMLSortFilterProxyModel::AcceptType qMRMLSortFilterProxyModel
 
   if (!d->HideNodesUnaffiliatedWithNodeID.isEmpty())
     {
-    vtkMRMLNode* theNode = sceneModel->mrmlScene()->GetNodeByID(
-      d->HideNodesUnaffiliatedWithNodeID.toLatin1());
-    bool affiliated = sceneModel->isAffiliatedNode(node, theNode);
+    vtkMRMLNode* theNode = scene ? scene->GetNodeByID(
+      d->HideNodesUnaffiliatedWithNodeID.toLatin1()) : nullptr;
+    // there is no parent-child relationship in virtual scene models
+    bool affiliated = sceneModel ? sceneModel->isAffiliatedNode(node, theNode) : false;
     if (!affiliated)
       {
       return Reject;
@@ -548,3 +584,9 @@ qMRMLSceneModel* qMRMLSortFilterProxyModel::sceneModel()const
 {
   return qobject_cast<qMRMLSceneModel*>(this->sourceModel());
 }
+
+// --------------------------------------------------------------------------
+qMRMLVirtualSceneModel* qMRMLSortFilterProxyModel::virtualSceneModel()const
+{
+  return qobject_cast<qMRMLVirtualSceneModel*>(this->sourceModel());
+}
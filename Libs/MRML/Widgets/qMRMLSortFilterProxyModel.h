@@ -36,6 +36,7 @@ class vtkMRMLNode;
 class vtkMRMLScene;
 class qMRMLAbstractItemHelper;
 class qMRMLSceneModel;
+class qMRMLVirtualSceneModel;
 class qMRMLSortFilterProxyModelPrivate;
 
 /// Filter nodes based on their types and attributes
@@ -216,6 +217,10 @@ public:
   /// Return the scene model used as input if any.
   Q_INVOKABLE qMRMLSceneModel* sceneModel()const;
 
+  /// Return the virtual scene model used as input if any.
+  /// \sa qMRMLVirtualSceneModel
+  Q_INVOKABLE qMRMLVirtualSceneModel* virtualSceneModel()const;
+
 public slots:
   /// Set the showHidden flag.
   /// \sa showHidden, showHidden()
@@ -0,0 +1,658 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QHash>
+#include <QVector>
+#include <QWeakPointer>
+
+// qMRML includes
+#include "qMRMLSceneModel.h"
+#include "qMRMLVirtualSceneModel.h"
+
+// MRML includes
+#include <vtkMRMLNode.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
+#include <vtkSmartPointer.h>
+
+namespace
+{
+/// Internal ID of the scene index
+const quintptr SceneInternalId = 0;
+/// Internal ID of the node indexes (children of the scene)
+const quintptr NodeInternalId = 1;
+
+/// Models shared by the widgets of a scene (see qMRMLVirtualSceneModel::sharedModel())
+typedef QHash<vtkMRMLScene*, QWeakPointer<qMRMLVirtualSceneModel> > SharedModelMap;
+SharedModelMap& sharedModels()
+{
+  static SharedModelMap models;
+  return models;
+}
+
+//------------------------------------------------------------------------------
+void deleteSharedModel(qMRMLVirtualSceneModel* model)
+{
+  // The last reference is released, the weak pointer of the model is expired.
+  SharedModelMap& models = sharedModels();
+  for (SharedModelMap::iterator it = models.begin(); it != models.end();)
+    {
+    if (it.value().isNull())
+      {
+      it = models.erase(it);
+      }
+    else
+      {
+      ++it;
+      }
+    }
+  delete model;
+}
+}
+
+//------------------------------------------------------------------------------
+class qMRMLVirtualSceneModelPrivate
+{
+  Q_DECLARE_PUBLIC(qMRMLVirtualSceneModel);
+protected:
+  qMRMLVirtualSceneModel* const q_ptr;
+public:
+  qMRMLVirtualSceneModelPrivate(qMRMLVirtualSceneModel& object);
+  ~qMRMLVirtualSceneModelPrivate();
+  void init();
+
+  /// Append node to the node list and observe it, no model signal is emitted.
+  void appendNode(vtkMRMLNode* node);
+  /// Rebuild the node list from the scene, no model signal is emitted.
+  void populateNodes();
+  /// Remove all nodes from the node list, no model signal is emitted.
+  void clearNodes();
+  void observeNode(vtkMRMLNode* node);
+
+  vtkSmartPointer<vtkCallbackCommand> CallBack;
+  vtkMRMLScene* MRMLScene;
+
+  /// Nodes in the order they are displayed. During scene updates (import,
+  /// close, batch processing) removed nodes are set to nullptr until the
+  /// node list is rebuilt.
+  QVector<vtkMRMLNode*> Nodes;
+  /// Row of each node in Nodes
+  QHash<vtkMRMLNode*, int> NodeRows;
+
+  bool ListenNodeModifiedEvent;
+  int NameColumn;
+  int IDColumn;
+  int ToolTipNameColumn;
+};
+
+//------------------------------------------------------------------------------
+qMRMLVirtualSceneModelPrivate::qMRMLVirtualSceneModelPrivate(qMRMLVirtualSceneModel& object)
+  : q_ptr(&object)
+{
+  this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->MRMLScene = nullptr;
+  this->ListenNodeModifiedEvent = true;
+  this->NameColumn = 0;
+  this->IDColumn = -1;
+  this->ToolTipNameColumn = -1;
+}
+
+//------------------------------------------------------------------------------
+qMRMLVirtualSceneModelPrivate::~qMRMLVirtualSceneModelPrivate()
+{
+  if (this->MRMLScene)
+    {
+    this->MRMLScene->RemoveObserver(this->CallBack);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModelPrivate::init()
+{
+  Q_Q(qMRMLVirtualSceneModel);
+  this->CallBack->SetClientData(q);
+  this->CallBack->SetCallback(qMRMLVirtualSceneModel::onMRMLSceneEvent);
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModelPrivate::observeNode(vtkMRMLNode* node)
+{
+  Q_Q(qMRMLVirtualSceneModel);
+  q->qvtkConnect(node, vtkCommand::ModifiedEvent,
+                 q, SLOT(onMRMLNodeModified(vtkObject*)));
+  q->qvtkConnect(node, vtkMRMLNode::IDChangedEvent,
+                 q, SLOT(onMRMLNodeModified(vtkObject*)));
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModelPrivate::appendNode(vtkMRMLNode* node)
+{
+  this->NodeRows[node] = this->Nodes.size();
+  this->Nodes.push_back(node);
+  if (this->ListenNodeModifiedEvent)
+    {
+    this->observeNode(node);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModelPrivate::populateNodes()
+{
+  if (!this->MRMLScene)
+    {
+    return;
+    }
+  int numberOfNodes = this->MRMLScene->GetNodes()->GetNumberOfItems();
+  this->Nodes.reserve(numberOfNodes);
+  this->NodeRows.reserve(numberOfNodes);
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (this->MRMLScene->GetNodes()->InitTraversal(it);
+       (node = (vtkMRMLNode*)this->MRMLScene->GetNodes()->GetNextItemAsObject(it)) ;)
+    {
+    this->appendNode(node);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModelPrivate::clearNodes()
+{
+  Q_Q(qMRMLVirtualSceneModel);
+  foreach(vtkMRMLNode* node, this->Nodes)
+    {
+    if (node)
+      {
+      q->qvtkDisconnect(node, vtkCommand::NoEvent, q, nullptr);
+      }
+    }
+  this->Nodes.clear();
+  this->NodeRows.clear();
+}
+
+//------------------------------------------------------------------------------
+// qMRMLVirtualSceneModel
+
+//------------------------------------------------------------------------------
+qMRMLVirtualSceneModel::qMRMLVirtualSceneModel(QObject *_parent)
+  : QAbstractItemModel(_parent)
+  , d_ptr(new qMRMLVirtualSceneModelPrivate(*this))
+{
+  Q_D(qMRMLVirtualSceneModel);
+  d->init();
+}
+
+//------------------------------------------------------------------------------
+qMRMLVirtualSceneModel::~qMRMLVirtualSceneModel()
+= default;
+
+//------------------------------------------------------------------------------
+QSharedPointer<qMRMLVirtualSceneModel> qMRMLVirtualSceneModel::sharedModel(vtkMRMLScene* scene)
+{
+  if (!scene)
+    {
+    return QSharedPointer<qMRMLVirtualSceneModel>();
+    }
+  SharedModelMap& models = sharedModels();
+  QSharedPointer<qMRMLVirtualSceneModel> model = models.value(scene).toStrongRef();
+  // A scene may have been deleted and a new scene allocated at the same address.
+  if (!model.isNull() && model->mrmlScene() == scene)
+    {
+    return model;
+    }
+  model = QSharedPointer<qMRMLVirtualSceneModel>(new qMRMLVirtualSceneModel, deleteSharedModel);
+  model->setMRMLScene(scene);
+  models[scene] = model;
+  return model;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::setMRMLScene(vtkMRMLScene* scene)
+{
+  Q_D(qMRMLVirtualSceneModel);
+  if (scene == d->MRMLScene)
+    {
+    return;
+    }
+  if (d->MRMLScene)
+    {
+    d->MRMLScene->RemoveObserver(d->CallBack);
+    }
+  this->beginResetModel();
+  d->clearNodes();
+  d->MRMLScene = scene;
+  d->populateNodes();
+  this->endResetModel();
+  if (scene)
+    {
+    scene->AddObserver(vtkMRMLScene::NodeAddedEvent, d->CallBack, 10.);
+    scene->AddObserver(vtkMRMLScene::NodeAboutToBeRemovedEvent, d->CallBack, -10.);
+    scene->AddObserver(vtkCommand::DeleteEvent, d->CallBack);
+    // Closing, importing and restoring are batch processes as well
+    scene->AddObserver(vtkMRMLScene::StartBatchProcessEvent, d->CallBack);
+    scene->AddObserver(vtkMRMLScene::EndBatchProcessEvent, d->CallBack);
+    }
+}
+
+//------------------------------------------------------------------------------
+vtkMRMLScene* qMRMLVirtualSceneModel::mrmlScene()const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  return d->MRMLScene;
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLVirtualSceneModel::mrmlSceneIndex()const
+{
+  return this->index(0, 0);
+}
+
+//------------------------------------------------------------------------------
+vtkMRMLNode* qMRMLVirtualSceneModel::mrmlNodeFromIndex(const QModelIndex &nodeIndex)const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  if (!nodeIndex.isValid()
+    || nodeIndex.model() != this
+    || nodeIndex.internalId() != NodeInternalId
+    || nodeIndex.row() >= d->Nodes.size())
+    {
+    return nullptr;
+    }
+  return d->Nodes[nodeIndex.row()];
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLVirtualSceneModel::indexFromNode(vtkMRMLNode* node, int column)const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  QHash<vtkMRMLNode*, int>::const_iterator rowIt = d->NodeRows.constFind(node);
+  if (node == nullptr || rowIt == d->NodeRows.constEnd())
+    {
+    return QModelIndex();
+    }
+  return this->createIndex(rowIt.value(), column, NodeInternalId);
+}
+
+//------------------------------------------------------------------------------
+QModelIndexList qMRMLVirtualSceneModel::indexes(vtkMRMLNode* node)const
+{
+  QModelIndexList nodeIndexes;
+  QModelIndex nodeIndex = this->indexFromNode(node);
+  if (!nodeIndex.isValid())
+    {
+    return nodeIndexes;
+    }
+  const int columns = this->columnCount();
+  for (int column = 0; column < columns; ++column)
+    {
+    nodeIndexes << nodeIndex.sibling(nodeIndex.row(), column);
+    }
+  return nodeIndexes;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLVirtualSceneModel::listenNodeModifiedEvent()const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  return d->ListenNodeModifiedEvent;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::setListenNodeModifiedEvent(bool listen)
+{
+  Q_D(qMRMLVirtualSceneModel);
+  if (d->ListenNodeModifiedEvent == listen)
+    {
+    return;
+    }
+  d->ListenNodeModifiedEvent = listen;
+  foreach(vtkMRMLNode* node, d->Nodes)
+    {
+    if (!node)
+      {
+      continue;
+      }
+    this->qvtkDisconnect(node, vtkCommand::NoEvent, this, nullptr);
+    if (listen)
+      {
+      d->observeNode(node);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+int qMRMLVirtualSceneModel::nameColumn()const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  return d->NameColumn;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::setNameColumn(int column)
+{
+  Q_D(qMRMLVirtualSceneModel);
+  this->beginResetModel();
+  d->NameColumn = column;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLVirtualSceneModel::idColumn()const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  return d->IDColumn;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::setIDColumn(int column)
+{
+  Q_D(qMRMLVirtualSceneModel);
+  this->beginResetModel();
+  d->IDColumn = column;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLVirtualSceneModel::toolTipNameColumn()const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  return d->ToolTipNameColumn;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::setToolTipNameColumn(int column)
+{
+  Q_D(qMRMLVirtualSceneModel);
+  this->beginResetModel();
+  d->ToolTipNameColumn = column;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLVirtualSceneModel::index(int row, int column, const QModelIndex &parent)const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  if (row < 0 || column < 0 || column >= this->columnCount())
+    {
+    return QModelIndex();
+    }
+  if (!parent.isValid())
+    {
+    return (d->MRMLScene && row == 0) ? this->createIndex(row, column, SceneInternalId) : QModelIndex();
+    }
+  if (parent.internalId() == SceneInternalId && parent.column() == 0 && row < d->Nodes.size())
+    {
+    return this->createIndex(row, column, NodeInternalId);
+    }
+  return QModelIndex();
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLVirtualSceneModel::parent(const QModelIndex &child)const
+{
+  if (!child.isValid() || child.internalId() != NodeInternalId)
+    {
+    return QModelIndex();
+    }
+  return this->createIndex(0, 0, SceneInternalId);
+}
+
+//------------------------------------------------------------------------------
+int qMRMLVirtualSceneModel::rowCount(const QModelIndex &parent)const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  if (!parent.isValid())
+    {
+    return d->MRMLScene ? 1 : 0;
+    }
+  if (parent.internalId() == SceneInternalId && parent.column() == 0)
+    {
+    return d->Nodes.size();
+    }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+int qMRMLVirtualSceneModel::columnCount(const QModelIndex &parent)const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  Q_UNUSED(parent);
+  return qMax(qMax(d->NameColumn, d->IDColumn), d->ToolTipNameColumn) + 1;
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLVirtualSceneModel::data(const QModelIndex &index, int role)const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  if (!index.isValid())
+    {
+    return QVariant();
+    }
+  const int column = index.column();
+  if (index.internalId() == SceneInternalId)
+    {
+    switch (role)
+      {
+      case Qt::DisplayRole:
+        return column == d->NameColumn ? QVariant(QString("Scene")) : QVariant();
+      case qMRMLSceneModel::UIDRole:
+        return QString("scene");
+      case qMRMLSceneModel::PointerRole:
+        return QVariant::fromValue(reinterpret_cast<long long>(d->MRMLScene));
+      default:
+        return QVariant();
+      }
+    }
+  vtkMRMLNode* node = this->mrmlNodeFromIndex(index);
+  if (!node)
+    {
+    return QVariant();
+    }
+  switch (role)
+    {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+      if (column == d->NameColumn)
+        {
+        return QString(node->GetName());
+        }
+      if (column == d->IDColumn)
+        {
+        return QString(node->GetID());
+        }
+      break;
+    case Qt::ToolTipRole:
+      if (column == d->ToolTipNameColumn)
+        {
+        return QString(node->GetName());
+        }
+      if (column == d->NameColumn)
+        {
+        return QString(node->GetNodeTagName());
+        }
+      break;
+    case qMRMLSceneModel::UIDRole:
+      return QString(node->GetID());
+    case qMRMLSceneModel::PointerRole:
+      return QVariant::fromValue(reinterpret_cast<long long>(node));
+    default:
+      break;
+    }
+  return QVariant();
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLVirtualSceneModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+  Q_D(qMRMLVirtualSceneModel);
+  vtkMRMLNode* node = this->mrmlNodeFromIndex(index);
+  if (!node || role != Qt::EditRole || index.column() != d->NameColumn)
+    {
+    return false;
+    }
+  // The node modified event updates the views
+  node->SetName(value.toString().toUtf8());
+  return true;
+}
+
+//------------------------------------------------------------------------------
+Qt::ItemFlags qMRMLVirtualSceneModel::flags(const QModelIndex &index)const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  if (!index.isValid())
+    {
+    return Qt::NoItemFlags;
+    }
+  Qt::ItemFlags flags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+  if (index.internalId() == NodeInternalId && index.column() == d->NameColumn)
+    {
+    flags |= Qt::ItemIsEditable;
+    }
+  return flags;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::updateScene()
+{
+  Q_D(qMRMLVirtualSceneModel);
+  this->beginResetModel();
+  d->clearNodes();
+  d->populateNodes();
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLVirtualSceneModel::isSceneUpdatePending()const
+{
+  Q_D(const qMRMLVirtualSceneModel);
+  return d->MRMLScene && d->MRMLScene->IsBatchProcessing();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::onMRMLSceneEvent(vtkObject* vtk_obj, unsigned long event,
+                                              void* client_data, void* call_data)
+{
+  vtkMRMLScene* scene = reinterpret_cast<vtkMRMLScene*>(vtk_obj);
+  qMRMLVirtualSceneModel* sceneModel = reinterpret_cast<qMRMLVirtualSceneModel*>(client_data);
+  vtkMRMLNode* node = reinterpret_cast<vtkMRMLNode*>(call_data);
+  Q_ASSERT(scene);
+  Q_ASSERT(sceneModel);
+  Q_UNUSED(scene);
+  switch(event)
+    {
+    case vtkMRMLScene::NodeAddedEvent:
+      Q_ASSERT(node);
+      sceneModel->onMRMLSceneNodeAdded(node);
+      break;
+    case vtkMRMLScene::NodeAboutToBeRemovedEvent:
+      Q_ASSERT(node);
+      sceneModel->onMRMLSceneNodeAboutToBeRemoved(node);
+      break;
+    case vtkCommand::DeleteEvent:
+      sceneModel->onMRMLSceneDeleted();
+      break;
+    case vtkMRMLScene::StartBatchProcessEvent:
+      sceneModel->onMRMLSceneStartUpdate();
+      break;
+    case vtkMRMLScene::EndBatchProcessEvent:
+      sceneModel->onMRMLSceneEndUpdate();
+      break;
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::onMRMLSceneNodeAdded(vtkMRMLNode* node)
+{
+  Q_D(qMRMLVirtualSceneModel);
+  if (this->isSceneUpdatePending() || d->NodeRows.contains(node))
+    {
+    // the node list is rebuilt when the scene update is complete
+    return;
+    }
+  const int row = d->Nodes.size();
+  this->beginInsertRows(this->mrmlSceneIndex(), row, row);
+  d->appendNode(node);
+  this->endInsertRows();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLNode* node)
+{
+  Q_D(qMRMLVirtualSceneModel);
+  QHash<vtkMRMLNode*, int>::iterator rowIt = d->NodeRows.find(node);
+  if (rowIt == d->NodeRows.end())
+    {
+    return;
+    }
+  const int row = rowIt.value();
+  d->NodeRows.erase(rowIt);
+  this->qvtkDisconnect(node, vtkCommand::NoEvent, this, nullptr);
+
+  if (this->isSceneUpdatePending())
+    {
+    // Keep the rows unchanged until the node list is rebuilt, but make sure
+    // the removed node is not accessed anymore.
+    d->Nodes[row] = nullptr;
+    return;
+    }
+
+  this->beginRemoveRows(this->mrmlSceneIndex(), row, row);
+  d->Nodes.remove(row);
+  for (int i = row; i < d->Nodes.size(); ++i)
+    {
+    if (d->Nodes[i])
+      {
+      d->NodeRows[d->Nodes[i]] = i;
+      }
+    }
+  this->endRemoveRows();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::onMRMLSceneStartUpdate()
+{
+  emit sceneAboutToBeUpdated();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::onMRMLSceneEndUpdate()
+{
+  this->updateScene();
+  emit sceneUpdated();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::onMRMLSceneDeleted()
+{
+  Q_D(qMRMLVirtualSceneModel);
+  this->beginResetModel();
+  d->clearNodes();
+  d->MRMLScene = nullptr;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVirtualSceneModel::onMRMLNodeModified(vtkObject* node)
+{
+  QModelIndex nodeIndex = this->indexFromNode(vtkMRMLNode::SafeDownCast(node));
+  if (!nodeIndex.isValid())
+    {
+    return;
+    }
+  emit dataChanged(nodeIndex, nodeIndex.sibling(nodeIndex.row(), this->columnCount() - 1));
+}
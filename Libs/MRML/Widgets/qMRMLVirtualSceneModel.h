@@ -0,0 +1,165 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qMRMLVirtualSceneModel_h
+#define __qMRMLVirtualSceneModel_h
+
+// Qt includes
+#include <QAbstractItemModel>
+#include <QSharedPointer>
+
+// CTK includes
+#include <ctkPimpl.h>
+#include <ctkVTKObject.h>
+
+// qMRML includes
+#include "qMRMLWidgetsExport.h"
+
+class vtkMRMLNode;
+class vtkMRMLScene;
+
+class qMRMLVirtualSceneModelPrivate;
+
+/// \brief Flat scene model that reads item data directly from the MRML nodes.
+///
+/// Contrary to qMRMLSceneModel, no QStandardItem is created for the nodes:
+/// display data is queried from the node when the view asks for it and the
+/// row of a node is retrieved from a node-to-row map maintained when nodes
+/// are added and removed. It makes the model suitable for very large scenes
+/// where views only need to display node names and IDs.
+///
+/// The model has the same layout as qMRMLSceneModel without extra items:
+/// \verbatim
+///    Column 0           Column 1
+///
+///  - Scene
+///    |- ViewNode        vtkMRMLViewNode1
+///    |- CameraNode      vtkMRMLCameraNode1
+///    ...
+/// \endverbatim
+/// qMRMLSceneModel::UIDRole and qMRMLSceneModel::PointerRole are supported,
+/// the model can be used as source model of qMRMLSortFilterProxyModel.
+///
+/// Nodes added while the scene is importing, closing or batch processing are
+/// not inserted one by one, the model is reset once the operation is complete.
+///
+/// Widgets that only need to list the nodes of a scene can share the same
+/// model (and scene observations) using sharedModel().
+/// \sa qMRMLSceneModel, qMRMLExtraItemsProxyModel
+class QMRML_WIDGETS_EXPORT qMRMLVirtualSceneModel : public QAbstractItemModel
+{
+  Q_OBJECT
+  QVTK_OBJECT
+
+  /// Control whether node modified events are observed to notify views
+  /// when the node name or ID is changed.
+  /// True by default.
+  Q_PROPERTY (bool listenNodeModifiedEvent READ listenNodeModifiedEvent WRITE setListenNodeModifiedEvent)
+
+  /// Control in which column vtkMRMLNode names are displayed (Qt::DisplayRole).
+  /// A value of -1 hides it. First column (0) by default.
+  Q_PROPERTY (int nameColumn READ nameColumn WRITE setNameColumn)
+  /// Control in which column vtkMRMLNode IDs are displayed (Qt::DisplayRole).
+  /// A value of -1 hides it. Hidden by default (value of -1)
+  Q_PROPERTY (int idColumn READ idColumn WRITE setIDColumn)
+  /// Control in which column tooltips are displayed (Qt::ToolTipRole).
+  /// A value of -1 hides it. Hidden by default (value of -1).
+  Q_PROPERTY (int toolTipNameColumn READ toolTipNameColumn WRITE setToolTipNameColumn)
+
+public:
+  typedef QAbstractItemModel Superclass;
+  qMRMLVirtualSceneModel(QObject *parent=nullptr);
+  ~qMRMLVirtualSceneModel() override;
+
+  /// Return the model of \a scene shared by all its callers. The model is
+  /// created when it is requested the first time for the scene and deleted
+  /// when the last returned pointer is released.
+  /// The properties of the shared model (e.g. nameColumn) must not be changed.
+  /// Returns a null pointer if \a scene is null.
+  static QSharedPointer<qMRMLVirtualSceneModel> sharedModel(vtkMRMLScene* scene);
+
+  /// 0 by default
+  Q_INVOKABLE void setMRMLScene(vtkMRMLScene* scene);
+  Q_INVOKABLE vtkMRMLScene* mrmlScene()const;
+
+  /// Invalid until a valid scene is set
+  QModelIndex mrmlSceneIndex()const;
+
+  /// Return the vtkMRMLNode associated to the node index.
+  /// 0 if the index is not a MRML node (e.g. the scene index).
+  vtkMRMLNode* mrmlNodeFromIndex(const QModelIndex &nodeIndex)const;
+  /// Return the index of the node. The lookup does not depend on the number
+  /// of nodes in the scene.
+  QModelIndex indexFromNode(vtkMRMLNode* node, int column = 0)const;
+  /// Return all the QModelIndexes (all the columns) for a given node
+  QModelIndexList indexes(vtkMRMLNode* node)const;
+
+  bool listenNodeModifiedEvent()const;
+  void setListenNodeModifiedEvent(bool listen);
+
+  int nameColumn()const;
+  void setNameColumn(int column);
+
+  int idColumn()const;
+  void setIDColumn(int column);
+
+  int toolTipNameColumn()const;
+  void setToolTipNameColumn(int column);
+
+  QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex())const override;
+  QModelIndex parent(const QModelIndex &child)const override;
+  int rowCount(const QModelIndex &parent = QModelIndex())const override;
+  int columnCount(const QModelIndex &parent = QModelIndex())const override;
+  QVariant data(const QModelIndex &index, int role = Qt::DisplayRole)const override;
+  bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+  Qt::ItemFlags flags(const QModelIndex &index)const override;
+
+signals:
+  /// This signal is sent when the scene is about to be updated
+  void sceneAboutToBeUpdated();
+
+  /// This signal is sent after the scene is updated
+  void sceneUpdated();
+
+protected slots:
+  void onMRMLNodeModified(vtkObject* node);
+
+protected:
+  /// Rebuild the list of nodes from the scene.
+  void updateScene();
+
+  /// Returns true if the nodes added to or removed from the scene are
+  /// processed only once the scene batch processing (including import and
+  /// close) is complete.
+  bool isSceneUpdatePending()const;
+
+  void onMRMLSceneNodeAdded(vtkMRMLNode* node);
+  void onMRMLSceneNodeAboutToBeRemoved(vtkMRMLNode* node);
+  void onMRMLSceneStartUpdate();
+  void onMRMLSceneEndUpdate();
+  void onMRMLSceneDeleted();
+
+  static void onMRMLSceneEvent(vtkObject* vtk_obj, unsigned long event,
+                               void* client_data, void* call_data);
+
+protected:
+  QScopedPointer<qMRMLVirtualSceneModelPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qMRMLVirtualSceneModel);
+  Q_DISABLE_COPY(qMRMLVirtualSceneModel);
+};
+
+#endif
@@ -0,0 +1,136 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkAddonTestingMacros.h"
+#include "vtkRawRGBVolumeCodec.h"
+#include "vtkStreamingVolumeFrameDecoder.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkStreamingVolumeFrame> CreateFrame(vtkStreamingVolumeCodec* codec, unsigned char value)
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(16, 8, 4);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  unsigned char* pixels = static_cast<unsigned char*>(image->GetScalarPointer());
+  std::fill(pixels, pixels + 16 * 8 * 4 * 3, value);
+  vtkSmartPointer<vtkStreamingVolumeFrame> frame = vtkSmartPointer<vtkStreamingVolumeFrame>::New();
+  codec->EncodeImageData(image, frame);
+  return frame;
+}
+
+//----------------------------------------------------------------------------
+unsigned char GetFirstVoxelValue(vtkImageData* image)
+{
+  return *static_cast<unsigned char*>(image->GetScalarPointer());
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingVolumeFrameDecoderTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkRawRGBVolumeCodec> codec;
+  std::vector<vtkSmartPointer<vtkStreamingVolumeFrame> > frames;
+  for (unsigned char value = 1; value <= 6; ++value)
+    {
+    frames.push_back(CreateFrame(codec, value));
+    }
+
+  vtkNew<vtkStreamingVolumeFrameDecoder> decoder;
+  decoder->SetCodec(codec);
+  CHECK_BOOL(decoder->IsRunning(), false);
+  CHECK_BOOL(decoder->PushFrame(frames[0]), false);
+
+  // Single frame
+  CHECK_BOOL(decoder->Start(), true);
+  CHECK_BOOL(decoder->IsRunning(), true);
+  CHECK_BOOL(decoder->PushFrame(frames[0]), true);
+  CHECK_BOOL(decoder->WaitForDecodedImage(10.0), true);
+  vtkNew<vtkImageData> outputImage;
+  CHECK_POINTER(decoder->UpdateOutputImage(outputImage), frames[0].GetPointer());
+  CHECK_INT(outputImage->GetDimensions()[0], 16);
+  CHECK_INT(outputImage->GetNumberOfScalarComponents(), 3);
+  CHECK_INT(GetFirstVoxelValue(outputImage), 1);
+  // No new image
+  CHECK_NULL(decoder->UpdateOutputImage(outputImage));
+  CHECK_INT(GetFirstVoxelValue(outputImage), 1);
+
+  // Images that were returned are never overwritten by the decoder
+  vtkNew<vtkImageData> previousImage;
+  previousImage->ShallowCopy(outputImage);
+  for (int i = 1; i < 6; ++i)
+    {
+    CHECK_BOOL(decoder->PushFrame(frames[i]), true);
+    }
+  while (decoder->WaitForDecodedImage(10.0))
+    {
+    decoder->UpdateOutputImage(outputImage);
+    }
+  CHECK_INT(GetFirstVoxelValue(outputImage), 6);
+  CHECK_INT(GetFirstVoxelValue(previousImage), 1);
+  CHECK_INT(decoder->GetNumberOfPendingFrames(), 0);
+  CHECK_INT(decoder->GetNumberOfFailedFrames(), 0);
+  CHECK_INT(decoder->GetNumberOfDecodedFrames() + decoder->GetNumberOfSkippedFrames(), 6);
+  decoder->Stop();
+  CHECK_BOOL(decoder->IsRunning(), false);
+
+  // All frames are decoded by multiple threads, the most recent image is returned
+  decoder->SetFrameSkipPolicy(vtkStreamingVolumeFrameDecoder::SkipNone);
+  decoder->SetMaximumNumberOfThreads(3);
+  CHECK_BOOL(decoder->Start(), true);
+  for (int i = 0; i < 6; ++i)
+    {
+    CHECK_BOOL(decoder->PushFrame(frames[i]), true);
+    }
+  vtkStreamingVolumeFrame* lastDecodedFrame = nullptr;
+  while (decoder->WaitForDecodedImage(10.0))
+    {
+    lastDecodedFrame = decoder->UpdateOutputImage(outputImage);
+    }
+  CHECK_POINTER(lastDecodedFrame, frames[5].GetPointer());
+  CHECK_INT(GetFirstVoxelValue(outputImage), 6);
+  CHECK_INT(decoder->GetNumberOfDecodedFrames(), 6);
+  CHECK_INT(decoder->GetNumberOfSkippedFrames(), 0);
+
+  // Oldest frames are skipped when the queue is full
+  decoder->Stop();
+  decoder->SetMaximumNumberOfPendingFrames(1);
+  decoder->SetMaximumNumberOfThreads(1);
+  CHECK_BOOL(decoder->Start(), true);
+  for (int i = 0; i < 6; ++i)
+    {
+    decoder->PushFrame(frames[i]);
+    }
+  while (decoder->WaitForDecodedImage(10.0))
+    {
+    lastDecodedFrame = decoder->UpdateOutputImage(outputImage);
+    }
+  CHECK_POINTER(lastDecodedFrame, frames[5].GetPointer());
+  CHECK_INT(decoder->GetNumberOfDecodedFrames() + decoder->GetNumberOfSkippedFrames(), 6);
+  decoder->Stop();
+
+  return EXIT_SUCCESS;
+}
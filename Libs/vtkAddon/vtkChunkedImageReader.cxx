@@ -0,0 +1,504 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkChunkedImageReader.h"
+
+// VTK includes
+#include <vtkByteSwap.h>
+#include <vtkDataArray.h>
+#include <vtkErrorCode.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMatrix4x4.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtk_zlib.h>
+#include <vtksys/FStream.hxx>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+vtkStandardNewMacro(vtkChunkedImageReader);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Image layout read from the file header
+struct ChunkedImageLayout
+{
+  int Extent[6] = { 0, -1, 0, -1, 0, -1 };
+  int NumberOfComponents{1};
+  int ScalarType{VTK_UNSIGNED_CHAR};
+  bool BigEndian{false};
+  bool Compressed{false};
+  double Spacing[3] = { 1.0, 1.0, 1.0 };
+  double Origin[3] = { 0.0, 0.0, 0.0 };
+  int NumberOfChunks[3] = { 0, 0, 0 };
+  /// File offset and size of each chunk
+  std::vector<vtkTypeUInt64> ChunkTable;
+};
+
+//----------------------------------------------------------------------------
+std::string UnescapeMetaDataString(const std::string& text)
+{
+  std::string unescaped;
+  for (size_t i = 0; i < text.size(); ++i)
+    {
+    if (text[i] == '\\' && i + 1 < text.size())
+      {
+      ++i;
+      unescaped += (text[i] == 'n' ? '\n' : text[i]);
+      }
+    else
+      {
+      unescaped += text[i];
+      }
+    }
+  return unescaped;
+}
+
+//----------------------------------------------------------------------------
+// Reads and decompresses chunks and copies the voxels that are inside
+// the output extent into the output image.
+class ChunkDecoder
+{
+public:
+  ChunkDecoder(const std::string& fileName, const ChunkedImageLayout* internal,
+    const int chunkSize[3], const std::vector<vtkIdType>& chunkIndices, vtkImageData* output)
+    : FileName(fileName)
+    , Internal(internal)
+    , ChunkIndices(chunkIndices)
+  {
+    std::copy(chunkSize, chunkSize + 3, this->ChunkSize);
+    output->GetExtent(this->OutputExtent);
+    this->OutputVoxels = static_cast<char*>(output->GetScalarPointer());
+    this->ScalarSize = output->GetScalarSize();
+    this->VoxelSize = this->ScalarSize * internal->NumberOfComponents;
+#ifdef VTK_WORDS_BIGENDIAN
+    this->SwapBytes = !internal->BigEndian && this->ScalarSize > 1;
+#else
+    this->SwapBytes = internal->BigEndian && this->ScalarSize > 1;
+#endif
+    this->Failed = false;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtksys::ifstream file(this->FileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file.good())
+      {
+      this->Failed = true;
+      return;
+      }
+    std::vector<char> storedChunk;
+    std::vector<char> rawChunk;
+    const int* numberOfChunks = this->Internal->NumberOfChunks;
+    const vtkIdType outputRowLength = this->OutputExtent[1] - this->OutputExtent[0] + 1;
+    const vtkIdType outputSliceLength = outputRowLength * (this->OutputExtent[3] - this->OutputExtent[2] + 1);
+    for (vtkIdType listIndex = begin; listIndex < end && !this->Failed; ++listIndex)
+      {
+      vtkIdType chunkIndex = this->ChunkIndices[listIndex];
+      int chunkPosition[3] =
+        {
+        static_cast<int>(chunkIndex % numberOfChunks[0]),
+        static_cast<int>((chunkIndex / numberOfChunks[0]) % numberOfChunks[1]),
+        static_cast<int>(chunkIndex / (vtkIdType(numberOfChunks[0]) * numberOfChunks[1]))
+        };
+      // Chunk extent and the part of it that is copied to the output
+      int chunkExtent[6] = { 0, -1, 0, -1, 0, -1 };
+      int copyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        chunkExtent[2 * axis] = this->Internal->Extent[2 * axis] + chunkPosition[axis] * this->ChunkSize[axis];
+        chunkExtent[2 * axis + 1] = std::min(chunkExtent[2 * axis] + this->ChunkSize[axis] - 1,
+          this->Internal->Extent[2 * axis + 1]);
+        copyExtent[2 * axis] = std::max(chunkExtent[2 * axis], this->OutputExtent[2 * axis]);
+        copyExtent[2 * axis + 1] = std::min(chunkExtent[2 * axis + 1], this->OutputExtent[2 * axis + 1]);
+        }
+      const vtkIdType chunkRowLength = chunkExtent[1] - chunkExtent[0] + 1;
+      const vtkIdType chunkSliceLength = chunkRowLength * (chunkExtent[3] - chunkExtent[2] + 1);
+      const size_t rawChunkSize = static_cast<size_t>(chunkSliceLength
+        * (chunkExtent[5] - chunkExtent[4] + 1) * this->VoxelSize);
+
+      vtkTypeUInt64 offset = this->Internal->ChunkTable[2 * chunkIndex];
+      vtkTypeUInt64 storedSize = this->Internal->ChunkTable[2 * chunkIndex + 1];
+      storedChunk.resize(storedSize);
+      file.seekg(static_cast<std::streamoff>(offset));
+      file.read(storedChunk.data(), static_cast<std::streamsize>(storedSize));
+      if (file.fail())
+        {
+        this->Failed = true;
+        return;
+        }
+      if (this->Internal->Compressed)
+        {
+        rawChunk.resize(rawChunkSize);
+        uLongf uncompressedSize = static_cast<uLongf>(rawChunkSize);
+        if (uncompress(reinterpret_cast<Bytef*>(rawChunk.data()), &uncompressedSize,
+          reinterpret_cast<const Bytef*>(storedChunk.data()), static_cast<uLong>(storedSize)) != Z_OK
+          || uncompressedSize != rawChunkSize)
+          {
+          this->Failed = true;
+          return;
+          }
+        }
+      else
+        {
+        if (storedSize != rawChunkSize)
+          {
+          this->Failed = true;
+          return;
+          }
+        rawChunk.swap(storedChunk);
+        }
+      if (this->SwapBytes)
+        {
+        vtkByteSwap::SwapVoidRange(rawChunk.data(), rawChunkSize / this->ScalarSize, this->ScalarSize);
+        }
+
+      const size_t copyRowSize = static_cast<size_t>(copyExtent[1] - copyExtent[0] + 1) * this->VoxelSize;
+      for (int k = copyExtent[4]; k <= copyExtent[5]; ++k)
+        {
+        for (int j = copyExtent[2]; j <= copyExtent[3]; ++j)
+          {
+          const char* input = rawChunk.data() + ((k - chunkExtent[4]) * chunkSliceLength
+            + (j - chunkExtent[2]) * chunkRowLength + (copyExtent[0] - chunkExtent[0])) * this->VoxelSize;
+          char* output = this->OutputVoxels + ((k - this->OutputExtent[4]) * outputSliceLength
+            + (j - this->OutputExtent[2]) * outputRowLength + (copyExtent[0] - this->OutputExtent[0])) * this->VoxelSize;
+          memcpy(output, input, copyRowSize);
+          }
+        }
+      }
+  }
+
+  std::atomic<bool> Failed;
+
+private:
+  std::string FileName;
+  const ChunkedImageLayout* Internal;
+  const std::vector<vtkIdType>& ChunkIndices;
+  int ChunkSize[3];
+  int OutputExtent[6];
+  char* OutputVoxels;
+  int ScalarSize;
+  int VoxelSize;
+  bool SwapBytes;
+};
+
+}
+
+//----------------------------------------------------------------------------
+class vtkChunkedImageReader::vtkInternal : public ChunkedImageLayout
+{
+};
+
+//----------------------------------------------------------------------------
+vtkChunkedImageReader::vtkChunkedImageReader()
+{
+  this->Internal = new vtkInternal;
+  this->FileName = nullptr;
+  this->ChunkSize[0] = 0;
+  this->ChunkSize[1] = 0;
+  this->ChunkSize[2] = 0;
+  this->NumberOfChunksRead = 0;
+  this->IJKToRASMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  this->SetNumberOfInputPorts(0);
+}
+
+//----------------------------------------------------------------------------
+vtkChunkedImageReader::~vtkChunkedImageReader()
+{
+  this->SetFileName(nullptr);
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkChunkedImageReader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "ChunkSize: " << this->ChunkSize[0] << " " << this->ChunkSize[1] << " " << this->ChunkSize[2] << "\n";
+  os << indent << "NumberOfChunksRead: " << this->NumberOfChunksRead << "\n";
+  os << indent << "Number of metadata items: " << this->MetaData.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkChunkedImageReader::GetFileSignature()
+{
+  return "SLICER_CHUNKED_IMAGE 1";
+}
+
+//----------------------------------------------------------------------------
+bool vtkChunkedImageReader::CanReadFile(const char* fileName)
+{
+  if (!fileName)
+    {
+    return false;
+    }
+  vtksys::ifstream file(fileName, std::ios::in | std::ios::binary);
+  std::string line;
+  if (!std::getline(file, line))
+    {
+    return false;
+    }
+  return line == vtkChunkedImageReader::GetFileSignature();
+}
+
+//----------------------------------------------------------------------------
+vtkMatrix4x4* vtkChunkedImageReader::GetIJKToRASMatrix()
+{
+  return this->IJKToRASMatrix;
+}
+
+//----------------------------------------------------------------------------
+std::vector<std::string> vtkChunkedImageReader::GetMetaDataKeys()
+{
+  std::vector<std::string> keys;
+  for (std::map<std::string, std::string>::iterator it = this->MetaData.begin(); it != this->MetaData.end(); ++it)
+    {
+    keys.push_back(it->first);
+    }
+  return keys;
+}
+
+//----------------------------------------------------------------------------
+bool vtkChunkedImageReader::HasMetaData(const std::string& key)
+{
+  return this->MetaData.find(key) != this->MetaData.end();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkChunkedImageReader::GetMetaDataValue(const std::string& key)
+{
+  std::map<std::string, std::string>::iterator it = this->MetaData.find(key);
+  if (it == this->MetaData.end())
+    {
+    return "";
+    }
+  return it->second;
+}
+
+//----------------------------------------------------------------------------
+bool vtkChunkedImageReader::ReadHeader()
+{
+  this->MetaData.clear();
+  this->IJKToRASMatrix->Identity();
+  this->Internal->ChunkTable.clear();
+  if (!this->FileName)
+    {
+    vtkErrorMacro("ReadHeader: file name is not specified");
+    return false;
+    }
+  vtksys::ifstream file(this->FileName, std::ios::in | std::ios::binary);
+  std::string line;
+  if (!std::getline(file, line) || line != vtkChunkedImageReader::GetFileSignature())
+    {
+    vtkErrorMacro("ReadHeader: " << this->FileName << " is not a chunked image file");
+    return false;
+    }
+
+  vtkInternal* internal = this->Internal;
+  bool headerComplete = false;
+  while (std::getline(file, line))
+    {
+    if (line.empty())
+      {
+      headerComplete = true;
+      break;
+      }
+    size_t metaDataSeparator = line.find(":=");
+    if (metaDataSeparator != std::string::npos)
+      {
+      this->MetaData[UnescapeMetaDataString(line.substr(0, metaDataSeparator))] =
+        UnescapeMetaDataString(line.substr(metaDataSeparator + 2));
+      continue;
+      }
+    size_t separator = line.find(": ");
+    if (separator == std::string::npos)
+      {
+      vtkErrorMacro("ReadHeader: invalid header line in " << this->FileName << ": " << line);
+      return false;
+      }
+    std::string field = line.substr(0, separator);
+    std::stringstream value(line.substr(separator + 2));
+    if (field == "extent")
+      {
+      for (int i = 0; i < 6; ++i)
+        {
+        value >> internal->Extent[i];
+        }
+      }
+    else if (field == "components")
+      {
+      value >> internal->NumberOfComponents;
+      }
+    else if (field == "scalar type")
+      {
+      value >> internal->ScalarType;
+      }
+    else if (field == "endian")
+      {
+      internal->BigEndian = (value.str() == "big");
+      }
+    else if (field == "chunk size")
+      {
+      value >> this->ChunkSize[0] >> this->ChunkSize[1] >> this->ChunkSize[2];
+      }
+    else if (field == "compression")
+      {
+      internal->Compressed = (value.str() == "zlib");
+      }
+    else if (field == "spacing")
+      {
+      value >> internal->Spacing[0] >> internal->Spacing[1] >> internal->Spacing[2];
+      }
+    else if (field == "origin")
+      {
+      value >> internal->Origin[0] >> internal->Origin[1] >> internal->Origin[2];
+      }
+    else if (field == "ijk to ras")
+      {
+      for (int row = 0; row < 4; ++row)
+        {
+        for (int column = 0; column < 4; ++column)
+          {
+          double element = 0.0;
+          value >> element;
+          this->IJKToRASMatrix->SetElement(row, column, element);
+          }
+        }
+      }
+    if (value.fail())
+      {
+      vtkErrorMacro("ReadHeader: invalid " << field << " value in " << this->FileName);
+      return false;
+      }
+    }
+  if (!headerComplete)
+    {
+    vtkErrorMacro("ReadHeader: incomplete header in " << this->FileName);
+    return false;
+    }
+  if (this->ChunkSize[0] < 1 || this->ChunkSize[1] < 1 || this->ChunkSize[2] < 1
+    || internal->NumberOfComponents < 1 || vtkDataArray::GetDataTypeSize(internal->ScalarType) == 0)
+    {
+    vtkErrorMacro("ReadHeader: invalid image description in " << this->FileName);
+    return false;
+    }
+
+  vtkIdType totalNumberOfChunks = 1;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    int imageSize = std::max(0, internal->Extent[2 * axis + 1] - internal->Extent[2 * axis] + 1);
+    internal->NumberOfChunks[axis] = (imageSize + this->ChunkSize[axis] - 1) / this->ChunkSize[axis];
+    totalNumberOfChunks *= internal->NumberOfChunks[axis];
+    }
+  internal->ChunkTable.resize(2 * totalNumberOfChunks);
+  file.read(reinterpret_cast<char*>(internal->ChunkTable.data()),
+    static_cast<std::streamsize>(internal->ChunkTable.size() * sizeof(vtkTypeUInt64)));
+  if (file.fail())
+    {
+    vtkErrorMacro("ReadHeader: failed to read chunk table from " << this->FileName);
+    internal->ChunkTable.clear();
+    return false;
+    }
+  vtkByteSwap::Swap8LERange(internal->ChunkTable.data(), internal->ChunkTable.size());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkChunkedImageReader::RequestInformation(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* outputVector)
+{
+  this->SetErrorCode(vtkErrorCode::NoError);
+  if (!this->ReadHeader())
+    {
+    this->SetErrorCode(vtkErrorCode::FileFormatError);
+    return 0;
+    }
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), this->Internal->Extent, 6);
+  outInfo->Set(vtkDataObject::SPACING(), this->Internal->Spacing, 3);
+  outInfo->Set(vtkDataObject::ORIGIN(), this->Internal->Origin, 3);
+  outInfo->Set(vtkAlgorithm::CAN_PRODUCE_SUB_EXTENT(), 1);
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, this->Internal->ScalarType, this->Internal->NumberOfComponents);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkChunkedImageReader::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* outputVector)
+{
+  this->NumberOfChunksRead = 0;
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkImageData* output = vtkImageData::GetData(outInfo);
+  if (this->Internal->ChunkTable.empty() && !this->ReadHeader())
+    {
+    this->SetErrorCode(vtkErrorCode::FileFormatError);
+    return 0;
+    }
+
+  int updateExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent);
+  int chunkRange[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    updateExtent[2 * axis] = std::max(updateExtent[2 * axis], this->Internal->Extent[2 * axis]);
+    updateExtent[2 * axis + 1] = std::min(updateExtent[2 * axis + 1], this->Internal->Extent[2 * axis + 1]);
+    chunkRange[2 * axis] = (updateExtent[2 * axis] - this->Internal->Extent[2 * axis]) / this->ChunkSize[axis];
+    chunkRange[2 * axis + 1] = (updateExtent[2 * axis + 1] - this->Internal->Extent[2 * axis]) / this->ChunkSize[axis];
+    }
+  output->SetExtent(updateExtent);
+  output->AllocateScalars(this->Internal->ScalarType, this->Internal->NumberOfComponents);
+  output->GetPointData()->GetScalars()->SetName("ImageScalars");
+  if (updateExtent[0] > updateExtent[1] || updateExtent[2] > updateExtent[3] || updateExtent[4] > updateExtent[5])
+    {
+    return 1;
+    }
+
+  // Only chunks that intersect the update extent are read
+  std::vector<vtkIdType> chunkIndices;
+  const int* numberOfChunks = this->Internal->NumberOfChunks;
+  for (int k = chunkRange[4]; k <= chunkRange[5]; ++k)
+    {
+    for (int j = chunkRange[2]; j <= chunkRange[3]; ++j)
+      {
+      for (int i = chunkRange[0]; i <= chunkRange[1]; ++i)
+        {
+        chunkIndices.push_back((vtkIdType(k) * numberOfChunks[1] + j) * numberOfChunks[0] + i);
+        }
+      }
+    }
+
+  ChunkDecoder decoder(this->FileName, this->Internal, this->ChunkSize, chunkIndices, output);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(chunkIndices.size()), decoder);
+  if (decoder.Failed)
+    {
+    vtkErrorMacro("RequestData: failed to read image data from " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::PrematureEndOfFileError);
+    return 0;
+    }
+  this->NumberOfChunksRead = static_cast<int>(chunkIndices.size());
+  return 1;
+}
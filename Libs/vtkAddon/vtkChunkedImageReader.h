@@ -0,0 +1,109 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkChunkedImageReader_h
+#define __vtkChunkedImageReader_h
+
+// vtkAddon includes
+#include "vtkAddon.h"
+
+// VTK includes
+#include <vtkImageAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <map>
+#include <string>
+#include <vector>
+
+class vtkMatrix4x4;
+
+/// \brief Reads images stored as independently compressed chunks.
+///
+/// Only the chunks that intersect the requested update extent are read and
+/// decompressed, in parallel.
+///
+/// File format: a text header, a chunk table, then the chunk data.
+/// The header starts with the line "SLICER_CHUNKED_IMAGE 1", followed by
+/// "field: value" lines (extent, components, scalar type, endian, chunk size,
+/// compression, spacing, origin, ijk to ras) and "key:=value" custom
+/// metadata lines, and ends with an empty line. The chunk table contains the
+/// file offset and byte size (two little-endian 64-bit unsigned integers) of
+/// each chunk, in i, j, k order with i increasing fastest. Each chunk contains
+/// the voxels of its block (clipped at the image boundary), with i
+/// increasing fastest, compressed with zlib if compression is "zlib".
+///
+/// \sa vtkChunkedImageWriter
+class VTK_ADDON_EXPORT vtkChunkedImageReader : public vtkImageAlgorithm
+{
+public:
+  static vtkChunkedImageReader* New();
+  vtkTypeMacro(vtkChunkedImageReader, vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Input file name
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  /// Returns true if the file is a chunked image file.
+  static bool CanReadFile(const char* fileName);
+
+  /// Magic string at the beginning of chunked image files.
+  static const char* GetFileSignature();
+
+  /// IJK to RAS matrix stored in the file.
+  /// Valid after UpdateInformation().
+  vtkMatrix4x4* GetIJKToRASMatrix();
+
+  /// Custom key-value pairs stored in the file.
+  /// Valid after UpdateInformation().
+  std::vector<std::string> GetMetaDataKeys();
+  bool HasMetaData(const std::string& key);
+  std::string GetMetaDataValue(const std::string& key);
+
+  /// Chunk size stored in the file.
+  /// Valid after UpdateInformation().
+  vtkGetVector3Macro(ChunkSize, int);
+
+  /// Number of chunks that were read by the last update.
+  vtkGetMacro(NumberOfChunksRead, int);
+
+protected:
+  vtkChunkedImageReader();
+  ~vtkChunkedImageReader() override;
+
+  int RequestInformation(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  /// Read header and chunk table. Returns false on error.
+  bool ReadHeader();
+
+  char* FileName;
+  int ChunkSize[3];
+  int NumberOfChunksRead;
+  vtkSmartPointer<vtkMatrix4x4> IJKToRASMatrix;
+  std::map<std::string, std::string> MetaData;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkChunkedImageReader(const vtkChunkedImageReader&) = delete;
+  void operator=(const vtkChunkedImageReader&) = delete;
+};
+
+#endif
@@ -0,0 +1,364 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkChunkedImageReader.h"
+#include "vtkChunkedImageWriter.h"
+
+// VTK includes
+#include <vtkByteSwap.h>
+#include <vtkDataArray.h>
+#include <vtkErrorCode.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtk_zlib.h>
+#include <vtksys/FStream.hxx>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+vtkStandardNewMacro(vtkChunkedImageWriter);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+std::string EscapeMetaDataString(const std::string& text)
+{
+  std::string escaped;
+  for (char c : text)
+    {
+    if (c == '\\')
+      {
+      escaped += "\\\\";
+      }
+    else if (c == '\n')
+      {
+      escaped += "\\n";
+      }
+    else
+      {
+      escaped += c;
+      }
+    }
+  return escaped;
+}
+
+//----------------------------------------------------------------------------
+// Copies the voxels of a chunk into a contiguous buffer and compresses it.
+class ChunkEncoder
+{
+public:
+  ChunkEncoder(const char* voxels, const int extent[6], const int chunkSize[3], const int numberOfChunks[3],
+    int voxelSize, bool compress, int compressionLevel, vtkIdType firstChunkIndex, std::vector<std::vector<char> >& chunks)
+    : Voxels(voxels)
+    , VoxelSize(voxelSize)
+    , Compress(compress)
+    , CompressionLevel(compressionLevel)
+    , FirstChunkIndex(firstChunkIndex)
+    , Chunks(chunks)
+  {
+    std::copy(extent, extent + 6, this->Extent);
+    std::copy(chunkSize, chunkSize + 3, this->ChunkSize);
+    std::copy(numberOfChunks, numberOfChunks + 3, this->NumberOfChunks);
+    this->Failed = false;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::vector<char> rawChunk;
+    const vtkIdType rowLength = this->Extent[1] - this->Extent[0] + 1;
+    const vtkIdType sliceLength = rowLength * (this->Extent[3] - this->Extent[2] + 1);
+    for (vtkIdType chunkIndex = begin; chunkIndex < end; ++chunkIndex)
+      {
+      // Chunk voxel range, relative to the image extent start
+      int chunkPosition[3] =
+        {
+        static_cast<int>(chunkIndex % this->NumberOfChunks[0]),
+        static_cast<int>((chunkIndex / this->NumberOfChunks[0]) % this->NumberOfChunks[1]),
+        static_cast<int>(chunkIndex / (vtkIdType(this->NumberOfChunks[0]) * this->NumberOfChunks[1]))
+        };
+      int first[3] = { 0, 0, 0 };
+      int size[3] = { 0, 0, 0 };
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        first[axis] = chunkPosition[axis] * this->ChunkSize[axis];
+        int imageSize = this->Extent[2 * axis + 1] - this->Extent[2 * axis] + 1;
+        size[axis] = std::min(this->ChunkSize[axis], imageSize - first[axis]);
+        }
+
+      const size_t rowSize = static_cast<size_t>(size[0]) * this->VoxelSize;
+      rawChunk.resize(rowSize * size[1] * size[2]);
+      char* output = rawChunk.data();
+      for (int k = first[2]; k < first[2] + size[2]; ++k)
+        {
+        for (int j = first[1]; j < first[1] + size[1]; ++j)
+          {
+          const char* input = this->Voxels + (k * sliceLength + j * rowLength + first[0]) * this->VoxelSize;
+          memcpy(output, input, rowSize);
+          output += rowSize;
+          }
+        }
+
+      std::vector<char>& chunk = this->Chunks[chunkIndex - this->FirstChunkIndex];
+      if (!this->Compress)
+        {
+        chunk.swap(rawChunk);
+        continue;
+        }
+      uLongf compressedSize = compressBound(static_cast<uLong>(rawChunk.size()));
+      chunk.resize(compressedSize);
+      if (compress2(reinterpret_cast<Bytef*>(chunk.data()), &compressedSize,
+        reinterpret_cast<const Bytef*>(rawChunk.data()), static_cast<uLong>(rawChunk.size()),
+        this->CompressionLevel) != Z_OK)
+        {
+        this->Failed = true;
+        return;
+        }
+      chunk.resize(compressedSize);
+      }
+  }
+
+  std::atomic<bool> Failed;
+
+private:
+  const char* Voxels;
+  int Extent[6];
+  int ChunkSize[3];
+  int NumberOfChunks[3];
+  int VoxelSize;
+  bool Compress;
+  int CompressionLevel;
+  vtkIdType FirstChunkIndex;
+  std::vector<std::vector<char> >& Chunks;
+};
+
+}
+
+//----------------------------------------------------------------------------
+vtkChunkedImageWriter::vtkChunkedImageWriter()
+{
+  this->FileName = nullptr;
+  this->ChunkSize[0] = 64;
+  this->ChunkSize[1] = 64;
+  this->ChunkSize[2] = 64;
+  this->UseCompression = true;
+  this->CompressionLevel = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkChunkedImageWriter::~vtkChunkedImageWriter()
+{
+  this->SetFileName(nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkChunkedImageWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "ChunkSize: " << this->ChunkSize[0] << " " << this->ChunkSize[1] << " " << this->ChunkSize[2] << "\n";
+  os << indent << "UseCompression: " << this->UseCompression << "\n";
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
+  os << indent << "Number of metadata items: " << this->MetaData.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkChunkedImageWriter::FillInputPortInformation(int vtkNotUsed(port), vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkChunkedImageWriter::GetInput()
+{
+  return vtkImageData::SafeDownCast(this->Superclass::GetInput());
+}
+
+//----------------------------------------------------------------------------
+void vtkChunkedImageWriter::SetIJKToRASMatrix(vtkMatrix4x4* matrix)
+{
+  if (this->IJKToRASMatrix == matrix)
+    {
+    return;
+    }
+  this->IJKToRASMatrix = matrix;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkMatrix4x4* vtkChunkedImageWriter::GetIJKToRASMatrix()
+{
+  return this->IJKToRASMatrix;
+}
+
+//----------------------------------------------------------------------------
+void vtkChunkedImageWriter::SetMetaData(const std::string& key, const std::string& value)
+{
+  this->MetaData[key] = value;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkChunkedImageWriter::ClearMetaData()
+{
+  if (this->MetaData.empty())
+    {
+    return;
+    }
+  this->MetaData.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkChunkedImageWriter::WriteData()
+{
+  this->SetErrorCode(vtkErrorCode::NoError);
+  if (!this->FileName || strlen(this->FileName) == 0)
+    {
+    vtkErrorMacro("WriteData: file name is not specified");
+    this->SetErrorCode(vtkErrorCode::NoFileNameError);
+    return;
+    }
+  vtkImageData* image = this->GetInput();
+  vtkDataArray* scalars = (image ? image->GetPointData()->GetScalars() : nullptr);
+  if (!scalars)
+    {
+    vtkErrorMacro("WriteData: input image has no scalars");
+    this->SetErrorCode(vtkErrorCode::UnknownError);
+    return;
+    }
+
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(extent);
+  int chunkSize[3] = { 1, 1, 1 };
+  int numberOfChunks[3] = { 0, 0, 0 };
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    chunkSize[axis] = std::max(1, this->ChunkSize[axis]);
+    int imageSize = std::max(0, extent[2 * axis + 1] - extent[2 * axis] + 1);
+    numberOfChunks[axis] = (imageSize + chunkSize[axis] - 1) / chunkSize[axis];
+    }
+  const vtkIdType totalNumberOfChunks = vtkIdType(numberOfChunks[0]) * numberOfChunks[1] * numberOfChunks[2];
+  const int voxelSize = scalars->GetDataTypeSize() * scalars->GetNumberOfComponents();
+
+  vtkNew<vtkMatrix4x4> ijkToRas;
+  if (this->IJKToRASMatrix)
+    {
+    ijkToRas->DeepCopy(this->IJKToRASMatrix);
+    }
+  else
+    {
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      ijkToRas->SetElement(axis, axis, image->GetSpacing()[axis]);
+      ijkToRas->SetElement(axis, 3, image->GetOrigin()[axis]);
+      }
+    }
+
+  std::stringstream header;
+  header << std::setprecision(17);
+  header << vtkChunkedImageReader::GetFileSignature() << "\n";
+  header << "extent: " << extent[0] << " " << extent[1] << " " << extent[2] << " "
+    << extent[3] << " " << extent[4] << " " << extent[5] << "\n";
+  header << "components: " << scalars->GetNumberOfComponents() << "\n";
+  header << "scalar type: " << scalars->GetDataType() << "\n";
+#ifdef VTK_WORDS_BIGENDIAN
+  header << "endian: big\n";
+#else
+  header << "endian: little\n";
+#endif
+  header << "chunk size: " << chunkSize[0] << " " << chunkSize[1] << " " << chunkSize[2] << "\n";
+  header << "compression: " << (this->UseCompression ? "zlib" : "none") << "\n";
+  header << "spacing: " << image->GetSpacing()[0] << " " << image->GetSpacing()[1] << " " << image->GetSpacing()[2] << "\n";
+  header << "origin: " << image->GetOrigin()[0] << " " << image->GetOrigin()[1] << " " << image->GetOrigin()[2] << "\n";
+  header << "ijk to ras:";
+  for (int row = 0; row < 4; ++row)
+    {
+    for (int column = 0; column < 4; ++column)
+      {
+      header << " " << ijkToRas->GetElement(row, column);
+      }
+    }
+  header << "\n";
+  for (std::map<std::string, std::string>::iterator it = this->MetaData.begin(); it != this->MetaData.end(); ++it)
+    {
+    header << EscapeMetaDataString(it->first) << ":=" << EscapeMetaDataString(it->second) << "\n";
+    }
+  header << "\n";
+
+  vtksys::ofstream file(this->FileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.good())
+    {
+    vtkErrorMacro("WriteData: cannot open file " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::CannotOpenFileError);
+    return;
+    }
+  std::string headerString = header.str();
+  file.write(headerString.data(), headerString.size());
+
+  // Chunk table is written after all the chunks are written
+  std::vector<vtkTypeUInt64> chunkTable(2 * totalNumberOfChunks, 0);
+  std::streamoff chunkTablePosition = file.tellp();
+  file.write(reinterpret_cast<const char*>(chunkTable.data()), chunkTable.size() * sizeof(vtkTypeUInt64));
+
+  // Chunks are compressed in parallel, in batches to limit memory usage,
+  // and written to file in order.
+  const vtkIdType batchSize = 256;
+  std::vector<std::vector<char> > chunks(batchSize);
+  const char* voxels = static_cast<const char*>(scalars->GetVoidPointer(0));
+  for (vtkIdType batchStart = 0; batchStart < totalNumberOfChunks; batchStart += batchSize)
+    {
+    vtkIdType batchEnd = std::min(batchStart + batchSize, totalNumberOfChunks);
+    ChunkEncoder encoder(voxels, extent, chunkSize, numberOfChunks, voxelSize,
+      this->UseCompression, this->CompressionLevel, batchStart, chunks);
+    vtkSMPTools::For(batchStart, batchEnd, encoder);
+    if (encoder.Failed)
+      {
+      vtkErrorMacro("WriteData: failed to compress image data");
+      this->SetErrorCode(vtkErrorCode::UnknownError);
+      return;
+      }
+    for (vtkIdType chunkIndex = batchStart; chunkIndex < batchEnd; ++chunkIndex)
+      {
+      std::vector<char>& chunk = chunks[chunkIndex - batchStart];
+      chunkTable[2 * chunkIndex] = static_cast<vtkTypeUInt64>(file.tellp());
+      chunkTable[2 * chunkIndex + 1] = chunk.size();
+      file.write(chunk.data(), chunk.size());
+      }
+    this->UpdateProgress(static_cast<double>(batchEnd) / totalNumberOfChunks);
+    }
+
+  vtkByteSwap::Swap8LERange(chunkTable.data(), chunkTable.size());
+  file.seekp(chunkTablePosition);
+  file.write(reinterpret_cast<const char*>(chunkTable.data()), chunkTable.size() * sizeof(vtkTypeUInt64));
+  file.close();
+  if (file.fail())
+    {
+    vtkErrorMacro("WriteData: failed to write file " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
+    }
+}
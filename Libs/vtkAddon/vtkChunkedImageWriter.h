@@ -0,0 +1,97 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkChunkedImageWriter_h
+#define __vtkChunkedImageWriter_h
+
+// vtkAddon includes
+#include "vtkAddon.h"
+
+// VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkWriter.h>
+
+// STD includes
+#include <map>
+#include <string>
+
+class vtkImageData;
+class vtkMatrix4x4;
+
+/// \brief Writes images as independently compressed chunks.
+///
+/// The image is split into blocks of ChunkSize voxels. Each chunk is
+/// compressed separately, in parallel, so that a region of the image can
+/// later be read without decompressing the whole image.
+/// See vtkChunkedImageReader for a description of the file format.
+///
+/// \sa vtkChunkedImageReader
+class VTK_ADDON_EXPORT vtkChunkedImageWriter : public vtkWriter
+{
+public:
+  static vtkChunkedImageWriter* New();
+  vtkTypeMacro(vtkChunkedImageWriter, vtkWriter);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Output file name
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  /// Number of voxels along each axis of a chunk. Default is 64x64x64.
+  vtkSetVector3Macro(ChunkSize, int);
+  vtkGetVector3Macro(ChunkSize, int);
+
+  /// Compress chunks with zlib. Default is true.
+  vtkSetMacro(UseCompression, bool);
+  vtkGetMacro(UseCompression, bool);
+  vtkBooleanMacro(UseCompression, bool);
+
+  /// zlib compression level (1 = fastest, 9 = smallest). Default is 1.
+  vtkSetClampMacro(CompressionLevel, int, 1, 9);
+  vtkGetMacro(CompressionLevel, int);
+
+  /// IJK to RAS matrix stored in the file header.
+  /// If not set, the matrix is computed from the image origin and spacing.
+  void SetIJKToRASMatrix(vtkMatrix4x4* matrix);
+  vtkMatrix4x4* GetIJKToRASMatrix();
+
+  /// Custom key-value pairs stored in the file header.
+  void SetMetaData(const std::string& key, const std::string& value);
+  void ClearMetaData();
+
+  /// Get input image
+  vtkImageData* GetInput();
+
+protected:
+  vtkChunkedImageWriter();
+  ~vtkChunkedImageWriter() override;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+
+  void WriteData() override;
+
+  char* FileName;
+  int ChunkSize[3];
+  bool UseCompression;
+  int CompressionLevel;
+  vtkSmartPointer<vtkMatrix4x4> IJKToRASMatrix;
+  std::map<std::string, std::string> MetaData;
+
+private:
+  vtkChunkedImageWriter(const vtkChunkedImageWriter&) = delete;
+  void operator=(const vtkChunkedImageWriter&) = delete;
+};
+
+#endif
@@ -37,6 +37,9 @@ public:
   // FourCC code representing 24-bit RGB using 8 bits per color
   std::string GetFourCC() override { return "RV24"; };
 
+  // All frames are keyframes, they can be decoded independently
+  bool IsConcurrentDecodingSupported() override { return true; };
+
 protected:
   vtkRawRGBVolumeCodec();
   ~vtkRawRGBVolumeCodec() override;
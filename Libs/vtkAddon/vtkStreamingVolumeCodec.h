@@ -65,6 +65,14 @@ public:
   /// Returns true if the frame is decoded successfully
   virtual bool DecodeFrame(vtkStreamingVolumeFrame* frame, vtkImageData* outputImageData);
 
+  /// Returns true if separate instances of the codec can decode different frames of
+  /// the same stream at the same time. This requires that decoding a frame does not
+  /// depend on decoder state left by the previously decoded frames (for example,
+  /// intra-frame only codecs).
+  /// Codecs that return false are decoded by a single thread, in stream order.
+  /// \sa vtkStreamingVolumeFrameDecoder
+  virtual bool IsConcurrentDecodingSupported() { return false; };
+
   /// Encode the image data and store it in the frame
   /// \param inputImageData Input image containing the uncompressed image
   /// \param outputStreamingFrame Output frame that will be used to store the compressed frame
@@ -0,0 +1,468 @@
+/*==============================================================================
+
+Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkStreamingVolumeFrameDecoder.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------
+vtkStandardNewMacro(vtkStreamingVolumeFrameDecoder);
+
+//---------------------------------------------------------------------------
+class vtkStreamingVolumeFrameDecoder::vtkInternal
+{
+public:
+  enum BufferState
+  {
+    Free,
+    Decoding,
+    Ready,
+    Output
+  };
+
+  struct ImageBuffer
+  {
+    vtkSmartPointer<vtkImageData> Image;
+    vtkSmartPointer<vtkStreamingVolumeFrame> Frame;
+    unsigned long long Sequence{0};
+    BufferState State{Free};
+  };
+
+  struct PendingFrame
+  {
+    vtkSmartPointer<vtkStreamingVolumeFrame> Frame;
+    unsigned long long Sequence;
+  };
+
+  /// Returns the index of a buffer that can be used for decoding, or -1.
+  /// Free buffers are preferred, otherwise the oldest decoded image is dropped.
+  /// Must be called with Mutex locked.
+  int AcquireBufferForDecoding(int& numberOfDroppedImages)
+  {
+    int oldestReadyIndex = -1;
+    for (size_t i = 0; i < this->Buffers.size(); ++i)
+      {
+      if (this->Buffers[i].State == Free)
+        {
+        return static_cast<int>(i);
+        }
+      if (this->Buffers[i].State == Ready &&
+        (oldestReadyIndex < 0 || this->Buffers[i].Sequence < this->Buffers[oldestReadyIndex].Sequence))
+        {
+        oldestReadyIndex = static_cast<int>(i);
+        }
+      }
+    if (oldestReadyIndex >= 0)
+      {
+      ++numberOfDroppedImages;
+      }
+    return oldestReadyIndex;
+  }
+
+  /// Returns true if a decoded image has not been retrieved yet.
+  /// Must be called with Mutex locked.
+  bool HasReadyBuffer()
+  {
+    for (const ImageBuffer& buffer : this->Buffers)
+      {
+      if (buffer.State == Ready && buffer.Sequence > this->OutputSequence)
+        {
+        return true;
+        }
+      }
+    return false;
+  }
+
+  std::mutex Mutex;
+  /// Notified when a frame is queued or when decoding is stopped
+  std::condition_variable FrameQueued;
+  /// Notified when a frame has been decoded
+  std::condition_variable FrameDecoded;
+
+  std::deque<PendingFrame> PendingFrames;
+  std::vector<ImageBuffer> Buffers;
+  std::vector<std::thread> Threads;
+  std::vector<vtkSmartPointer<vtkStreamingVolumeCodec> > ThreadCodecs;
+  int NumberOfActiveDecodes{0};
+  unsigned long long NextSequence{1};
+  unsigned long long OutputSequence{0};
+  bool StopRequested{false};
+  bool Running{false};
+};
+
+//---------------------------------------------------------------------------
+vtkStreamingVolumeFrameDecoder::vtkStreamingVolumeFrameDecoder()
+  : Codec(nullptr)
+  , FrameSkipPolicy(SkipToLatestFrame)
+  , NumberOfImageBuffers(4)
+  , MaximumNumberOfPendingFrames(8)
+  , MaximumNumberOfThreads(0)
+  , NumberOfDecodedFrames(0)
+  , NumberOfSkippedFrames(0)
+  , NumberOfDroppedImages(0)
+  , NumberOfFailedFrames(0)
+  , Internal(new vtkInternal)
+{
+}
+
+//---------------------------------------------------------------------------
+vtkStreamingVolumeFrameDecoder::~vtkStreamingVolumeFrameDecoder()
+{
+  this->Stop();
+  delete this->Internal;
+}
+
+//---------------------------------------------------------------------------
+void vtkStreamingVolumeFrameDecoder::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Codec: " << (this->Codec ? this->Codec->GetFourCC() : "(none)") << std::endl;
+  os << indent << "FrameSkipPolicy: " << this->FrameSkipPolicy << std::endl;
+  os << indent << "NumberOfImageBuffers: " << this->NumberOfImageBuffers << std::endl;
+  os << indent << "MaximumNumberOfPendingFrames: " << this->MaximumNumberOfPendingFrames << std::endl;
+  os << indent << "MaximumNumberOfThreads: " << this->MaximumNumberOfThreads << std::endl;
+  os << indent << "Running: " << this->IsRunning() << std::endl;
+  os << indent << "NumberOfDecodedFrames: " << this->NumberOfDecodedFrames << std::endl;
+  os << indent << "NumberOfSkippedFrames: " << this->NumberOfSkippedFrames << std::endl;
+  os << indent << "NumberOfDroppedImages: " << this->NumberOfDroppedImages << std::endl;
+  os << indent << "NumberOfFailedFrames: " << this->NumberOfFailedFrames << std::endl;
+}
+
+//---------------------------------------------------------------------------
+void vtkStreamingVolumeFrameDecoder::SetCodec(vtkStreamingVolumeCodec* codec)
+{
+  if (this->Codec == codec)
+    {
+    return;
+    }
+  this->Codec = codec;
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+vtkStreamingVolumeCodec* vtkStreamingVolumeFrameDecoder::GetCodec()
+{
+  return this->Codec;
+}
+
+//---------------------------------------------------------------------------
+bool vtkStreamingVolumeFrameDecoder::IsRunning()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->Running;
+}
+
+//---------------------------------------------------------------------------
+bool vtkStreamingVolumeFrameDecoder::Start()
+{
+  if (!this->Codec)
+    {
+    vtkErrorMacro("Start: No codec is set!");
+    return false;
+    }
+  this->Stop();
+
+  int numberOfThreads = 1;
+  if (this->Codec->IsConcurrentDecodingSupported() && this->FrameSkipPolicy == SkipNone)
+    {
+    numberOfThreads = this->MaximumNumberOfThreads > 0 ?
+      this->MaximumNumberOfThreads : static_cast<int>(std::thread::hardware_concurrency());
+    // One buffer is always kept for the output image
+    numberOfThreads = std::max(1, std::min(numberOfThreads, this->NumberOfImageBuffers - 1));
+    }
+
+  // Codecs are created on this thread, each decoding thread has its own instance
+  std::string parameters = this->Codec->GetParametersAsString();
+  this->Internal->ThreadCodecs.clear();
+  for (int i = 0; i < numberOfThreads; ++i)
+    {
+    vtkSmartPointer<vtkStreamingVolumeCodec> codec = vtkSmartPointer<vtkStreamingVolumeCodec>::Take(
+      this->Codec->CreateCodecInstance());
+    if (!codec)
+      {
+      vtkErrorMacro("Start: Could not create codec instance!");
+      this->Internal->ThreadCodecs.clear();
+      return false;
+      }
+    if (!parameters.empty())
+      {
+      codec->SetParametersFromString(parameters);
+      }
+    this->Internal->ThreadCodecs.push_back(codec);
+    }
+
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    this->Internal->Buffers.clear();
+    this->Internal->Buffers.resize(this->NumberOfImageBuffers);
+    for (vtkInternal::ImageBuffer& buffer : this->Internal->Buffers)
+      {
+      buffer.Image = vtkSmartPointer<vtkImageData>::New();
+      }
+    this->Internal->PendingFrames.clear();
+    this->Internal->NextSequence = 1;
+    this->Internal->OutputSequence = 0;
+    this->Internal->NumberOfActiveDecodes = 0;
+    this->Internal->StopRequested = false;
+    this->Internal->Running = true;
+    this->NumberOfDecodedFrames = 0;
+    this->NumberOfSkippedFrames = 0;
+    this->NumberOfDroppedImages = 0;
+    this->NumberOfFailedFrames = 0;
+  }
+
+  for (int i = 0; i < numberOfThreads; ++i)
+    {
+    this->Internal->Threads.push_back(std::thread(
+      &vtkStreamingVolumeFrameDecoder::DecodeLoop, this, this->Internal->ThreadCodecs[i].GetPointer()));
+    }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkStreamingVolumeFrameDecoder::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    if (!this->Internal->Running)
+      {
+      return;
+      }
+    this->Internal->StopRequested = true;
+    this->Internal->PendingFrames.clear();
+  }
+  this->Internal->FrameQueued.notify_all();
+  for (std::thread& thread : this->Internal->Threads)
+    {
+    thread.join();
+    }
+  this->Internal->Threads.clear();
+  this->Internal->ThreadCodecs.clear();
+
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->Running = false;
+  this->Internal->FrameDecoded.notify_all();
+}
+
+//---------------------------------------------------------------------------
+bool vtkStreamingVolumeFrameDecoder::PushFrame(vtkStreamingVolumeFrame* frame)
+{
+  if (!frame)
+    {
+    return false;
+    }
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    if (!this->Internal->Running || this->Internal->StopRequested)
+      {
+      return false;
+      }
+    while (static_cast<int>(this->Internal->PendingFrames.size()) >= this->MaximumNumberOfPendingFrames)
+      {
+      this->Internal->PendingFrames.pop_front();
+      ++this->NumberOfSkippedFrames;
+      }
+    vtkInternal::PendingFrame pendingFrame;
+    pendingFrame.Frame = frame;
+    pendingFrame.Sequence = this->Internal->NextSequence++;
+    this->Internal->PendingFrames.push_back(pendingFrame);
+  }
+  this->Internal->FrameQueued.notify_one();
+  return true;
+}
+
+//---------------------------------------------------------------------------
+int vtkStreamingVolumeFrameDecoder::GetNumberOfPendingFrames()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return static_cast<int>(this->Internal->PendingFrames.size());
+}
+
+//---------------------------------------------------------------------------
+void vtkStreamingVolumeFrameDecoder::DecodeLoop(vtkStreamingVolumeCodec* codec)
+{
+  std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+  while (true)
+    {
+    this->Internal->FrameQueued.wait(lock, [this]
+      { return this->Internal->StopRequested || !this->Internal->PendingFrames.empty(); });
+    if (this->Internal->StopRequested)
+      {
+      return;
+      }
+
+    vtkInternal::PendingFrame pendingFrame;
+    if (this->FrameSkipPolicy == SkipToLatestFrame)
+      {
+      // Older frames do not need to be decoded separately: if the latest frame
+      // is not a keyframe, the codec decodes the chain of previous frames.
+      pendingFrame = this->Internal->PendingFrames.back();
+      this->NumberOfSkippedFrames += static_cast<int>(this->Internal->PendingFrames.size()) - 1;
+      this->Internal->PendingFrames.clear();
+      }
+    else
+      {
+      pendingFrame = this->Internal->PendingFrames.front();
+      this->Internal->PendingFrames.pop_front();
+      }
+
+    int bufferIndex = this->Internal->AcquireBufferForDecoding(this->NumberOfDroppedImages);
+    if (bufferIndex < 0)
+      {
+      // Cannot happen as long as there are more buffers than decoding threads
+      ++this->NumberOfSkippedFrames;
+      continue;
+      }
+    vtkInternal::ImageBuffer& buffer = this->Internal->Buffers[bufferIndex];
+    buffer.State = vtkInternal::Decoding;
+    vtkSmartPointer<vtkImageData> image = buffer.Image;
+    ++this->Internal->NumberOfActiveDecodes;
+    lock.unlock();
+
+    // Reuse the preallocated buffer unless it does not match the frame or
+    // it is still referenced by an image previously returned to the caller.
+    vtkStreamingVolumeFrame* frame = pendingFrame.Frame;
+    int frameDimensions[3] = { 0, 0, 0 };
+    frame->GetDimensions(frameDimensions);
+    int imageDimensions[3] = { 0, 0, 0 };
+    image->GetDimensions(imageDimensions);
+    vtkDataArray* scalars = image->GetPointData()->GetScalars();
+    if (!scalars
+      || scalars->GetReferenceCount() > 1
+      || imageDimensions[0] != frameDimensions[0]
+      || imageDimensions[1] != frameDimensions[1]
+      || imageDimensions[2] != frameDimensions[2]
+      || image->GetScalarType() != frame->GetVTKScalarType()
+      || image->GetNumberOfScalarComponents() != frame->GetNumberOfComponents())
+      {
+      image->SetDimensions(frameDimensions);
+      image->AllocateScalars(frame->GetVTKScalarType(), frame->GetNumberOfComponents());
+      }
+    bool success = codec->DecodeFrame(frame, image);
+
+    lock.lock();
+    --this->Internal->NumberOfActiveDecodes;
+    if (success && pendingFrame.Sequence > this->Internal->OutputSequence)
+      {
+      buffer.State = vtkInternal::Ready;
+      buffer.Frame = pendingFrame.Frame;
+      buffer.Sequence = pendingFrame.Sequence;
+      ++this->NumberOfDecodedFrames;
+      }
+    else
+      {
+      // Failed, or a more recent frame has already been retrieved
+      buffer.State = vtkInternal::Free;
+      buffer.Frame = nullptr;
+      if (success)
+        {
+        ++this->NumberOfDecodedFrames;
+        ++this->NumberOfDroppedImages;
+        }
+      else
+        {
+        ++this->NumberOfFailedFrames;
+        }
+      }
+    this->Internal->FrameDecoded.notify_all();
+    }
+}
+
+//---------------------------------------------------------------------------
+vtkStreamingVolumeFrame* vtkStreamingVolumeFrameDecoder::UpdateOutputImage(vtkImageData* outputImage)
+{
+  if (!outputImage)
+    {
+    vtkErrorMacro("UpdateOutputImage: Invalid output image!");
+    return nullptr;
+    }
+
+  vtkSmartPointer<vtkImageData> decodedImage;
+  vtkSmartPointer<vtkStreamingVolumeFrame> decodedFrame;
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    int latestIndex = -1;
+    for (size_t i = 0; i < this->Internal->Buffers.size(); ++i)
+      {
+      const vtkInternal::ImageBuffer& buffer = this->Internal->Buffers[i];
+      if (buffer.State == vtkInternal::Ready && buffer.Sequence > this->Internal->OutputSequence &&
+        (latestIndex < 0 || buffer.Sequence > this->Internal->Buffers[latestIndex].Sequence))
+        {
+        latestIndex = static_cast<int>(i);
+        }
+      }
+    if (latestIndex < 0)
+      {
+      return nullptr;
+      }
+    for (size_t i = 0; i < this->Internal->Buffers.size(); ++i)
+      {
+      vtkInternal::ImageBuffer& buffer = this->Internal->Buffers[i];
+      if (static_cast<int>(i) == latestIndex)
+        {
+        continue;
+        }
+      if (buffer.State == vtkInternal::Output)
+        {
+        buffer.State = vtkInternal::Free;
+        buffer.Frame = nullptr;
+        }
+      else if (buffer.State == vtkInternal::Ready)
+        {
+        // Older decoded images are not displayed
+        buffer.State = vtkInternal::Free;
+        buffer.Frame = nullptr;
+        ++this->NumberOfDroppedImages;
+        }
+      }
+    vtkInternal::ImageBuffer& latestBuffer = this->Internal->Buffers[latestIndex];
+    latestBuffer.State = vtkInternal::Output;
+    this->Internal->OutputSequence = latestBuffer.Sequence;
+    decodedImage = latestBuffer.Image;
+    decodedFrame = latestBuffer.Frame;
+  }
+
+  // The buffer is not modified by the decoding threads while it is in Output state
+  outputImage->ShallowCopy(decodedImage);
+  return decodedFrame;
+}
+
+//---------------------------------------------------------------------------
+bool vtkStreamingVolumeFrameDecoder::WaitForDecodedImage(double timeoutSeconds)
+{
+  std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->FrameDecoded.wait_for(lock,
+    std::chrono::duration<double>(timeoutSeconds), [this]
+    {
+    return this->Internal->HasReadyBuffer() || !this->Internal->Running ||
+      (this->Internal->PendingFrames.empty() && this->Internal->NumberOfActiveDecodes == 0);
+    });
+  return this->Internal->HasReadyBuffer();
+}
@@ -0,0 +1,156 @@
+/*==============================================================================
+
+Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkStreamingVolumeFrameDecoder_h
+#define __vtkStreamingVolumeFrameDecoder_h
+
+// vtkAddon includes
+#include "vtkAddon.h"
+#include "vtkStreamingVolumeCodec.h"
+#include "vtkStreamingVolumeFrame.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+class vtkImageData;
+
+/// \brief Decodes streaming volume frames in background threads.
+///
+/// Frames are queued with PushFrame() and decoded by worker threads into a
+/// bounded ring of preallocated image buffers. The most recent decoded image
+/// is retrieved from the main thread with UpdateOutputImage(), which makes the
+/// output image reference the decoded buffer (no copy).
+///
+/// When decoding or rendering falls behind the stream:
+/// - pending frames are skipped according to FrameSkipPolicy. Skipping a frame
+///   never breaks the decoding of the following ones: the codec decodes the
+///   chain of previous frames up to the last keyframe when needed
+///   (see vtkStreamingVolumeCodec::DecodeFrame()).
+/// - decoded images that have not been retrieved are overwritten by newer ones.
+///
+/// Frames are decoded by multiple threads only if the codec supports it
+/// (see vtkStreamingVolumeCodec::IsConcurrentDecodingSupported()), otherwise a
+/// single thread decodes frames in stream order.
+///
+/// \sa vtkMRMLStreamingVolumeNode::SetAsynchronousDecoding()
+class VTK_ADDON_EXPORT vtkStreamingVolumeFrameDecoder : public vtkObject
+{
+public:
+  static vtkStreamingVolumeFrameDecoder* New();
+  vtkTypeMacro(vtkStreamingVolumeFrameDecoder, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum FrameSkipPolicyType
+  {
+    SkipNone, ///< All frames are decoded, the oldest pending frames are skipped only if the queue is full
+    SkipToLatestFrame, ///< Only the most recent pending frame is decoded
+  };
+
+  /// Codec used for decoding. Each decoding thread uses its own instance
+  /// of the codec, configured with the parameters of this codec when
+  /// decoding is started.
+  void SetCodec(vtkStreamingVolumeCodec* codec);
+  vtkStreamingVolumeCodec* GetCodec();
+
+  /// Policy for skipping pending frames. Default is SkipToLatestFrame.
+  vtkSetMacro(FrameSkipPolicy, int);
+  vtkGetMacro(FrameSkipPolicy, int);
+
+  /// Number of preallocated image buffers in the ring buffer, including
+  /// the one referenced by the output image. Default is 4.
+  /// Takes effect at the next Start().
+  vtkSetClampMacro(NumberOfImageBuffers, int, 2, 64);
+  vtkGetMacro(NumberOfImageBuffers, int);
+
+  /// Maximum number of frames waiting to be decoded. When the queue is full,
+  /// the oldest pending frame is skipped. Default is 8.
+  vtkSetClampMacro(MaximumNumberOfPendingFrames, int, 1, 1024);
+  vtkGetMacro(MaximumNumberOfPendingFrames, int);
+
+  /// Maximum number of decoding threads. Only used if the codec supports
+  /// concurrent decoding and FrameSkipPolicy is SkipNone. The number of
+  /// threads is also limited by the number of image buffers.
+  /// 0 (default) means number of processor cores.
+  /// Takes effect at the next Start().
+  vtkSetClampMacro(MaximumNumberOfThreads, int, 0, 256);
+  vtkGetMacro(MaximumNumberOfThreads, int);
+
+  /// Start the decoding threads. Returns false if no codec is set.
+  bool Start();
+
+  /// Stop the decoding threads. Pending frames are discarded.
+  void Stop();
+
+  /// Returns true if the decoding threads are running.
+  bool IsRunning();
+
+  /// Queue a frame for decoding. Can be called from any thread.
+  /// Returns false if the decoder is not running.
+  bool PushFrame(vtkStreamingVolumeFrame* frame);
+
+  /// Make \a outputImage reference the most recently decoded image.
+  /// Must not be called concurrently from multiple threads.
+  /// Returns the frame that the image was decoded from, or nullptr if no image
+  /// was decoded since the last call.
+  /// The image buffer previously referenced by \a outputImage is given back to
+  /// the decoder. If it is still referenced elsewhere when it gets reused, a new
+  /// buffer is allocated so that previously returned images are never overwritten.
+  vtkStreamingVolumeFrame* UpdateOutputImage(vtkImageData* outputImage);
+
+  /// Wait until an image that has not been retrieved by UpdateOutputImage() is
+  /// available, or until there is no pending frame left to decode.
+  /// Returns true if an image is available.
+  bool WaitForDecodedImage(double timeoutSeconds);
+
+  /// Number of frames waiting to be decoded.
+  int GetNumberOfPendingFrames();
+
+  /// Statistics since the last Start().
+  /// Skipped frames are pending frames that were not decoded, dropped images
+  /// are decoded images that were overwritten before being retrieved.
+  vtkGetMacro(NumberOfDecodedFrames, int);
+  vtkGetMacro(NumberOfSkippedFrames, int);
+  vtkGetMacro(NumberOfDroppedImages, int);
+  vtkGetMacro(NumberOfFailedFrames, int);
+
+protected:
+  vtkStreamingVolumeFrameDecoder();
+  ~vtkStreamingVolumeFrameDecoder() override;
+
+  /// Decoding thread main loop
+  void DecodeLoop(vtkStreamingVolumeCodec* codec);
+
+protected:
+  vtkSmartPointer<vtkStreamingVolumeCodec> Codec;
+  int FrameSkipPolicy;
+  int NumberOfImageBuffers;
+  int MaximumNumberOfPendingFrames;
+  int MaximumNumberOfThreads;
+  int NumberOfDecodedFrames;
+  int NumberOfSkippedFrames;
+  int NumberOfDroppedImages;
+  int NumberOfFailedFrames;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkStreamingVolumeFrameDecoder(const vtkStreamingVolumeFrameDecoder&) = delete;
+  void operator=(const vtkStreamingVolumeFrameDecoder&) = delete;
+};
+
+#endif
@@ -0,0 +1,213 @@
+
+#include <itkTimeSeriesDatabase.h>
+
+// ITK includes
+#include <itkConfigure.h>
+#include <itkFactoryRegistration.h>
+#include <itkImage.h>
+#include <itkImageFileWriter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+typedef short                                     PixelType;
+typedef itk::Image<PixelType, 3>                  ImageType;
+typedef itk::TimeSeriesDatabase<PixelType>        DatabaseType;
+
+//----------------------------------------------------------------------------
+// Volume size is not a multiple of the block size so that partial blocks are tested
+ImageType::Pointer CreateVolume(unsigned int volume)
+{
+  ImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 20;
+  size[2] = 18;
+  ImageType::RegionType region;
+  region.SetSize(size);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    const ImageType::IndexType& index = it.GetIndex();
+    it.Set(static_cast<PixelType>((index[0] * 7 + index[1] * 131 + index[2] * 17 + volume * 1009) % 30011 - 15000));
+    }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+int CheckVoxelTimeSeries(DatabaseType* database, const std::vector<ImageType::Pointer>& volumes,
+                         const ImageType::IndexType& index)
+{
+  DatabaseType::ArrayType timeSeries;
+  database->GetVoxelTimeSeries(index, timeSeries);
+  if (timeSeries.GetSize() != volumes.size())
+    {
+    std::cerr << "GetVoxelTimeSeries: expected " << volumes.size() << " values, got "
+              << timeSeries.GetSize() << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (unsigned int volume = 0; volume < volumes.size(); ++volume)
+    {
+    if (timeSeries[volume] != volumes[volume]->GetPixel(index))
+      {
+      std::cerr << "GetVoxelTimeSeries: mismatch at " << index << " in volume " << volume
+                << ": " << timeSeries[volume] << " != " << volumes[volume]->GetPixel(index) << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int CheckRegionTimeSeries(DatabaseType* database, const std::vector<ImageType::Pointer>& volumes,
+                          const ImageType::RegionType& region)
+{
+  itk::Array<double> timeSeries;
+  database->GetRegionTimeSeries(region, timeSeries);
+  if (timeSeries.GetSize() != volumes.size())
+    {
+    std::cerr << "GetRegionTimeSeries: expected " << volumes.size() << " values, got "
+              << timeSeries.GetSize() << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (unsigned int volume = 0; volume < volumes.size(); ++volume)
+    {
+    double sum = 0.0;
+    itk::ImageRegionConstIterator<ImageType> it(volumes[volume], region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+      {
+      sum += it.Get();
+      }
+    double mean = sum / region.GetNumberOfPixels();
+    if (std::fabs(timeSeries[volume] - mean) > 1e-6 * (1.0 + std::fabs(mean)))
+      {
+      std::cerr << "GetRegionTimeSeries: mismatch for region " << region << " in volume " << volume
+                << ": " << timeSeries[volume] << " != " << mean << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int CheckDatabase(const std::string& databaseFileName, const std::string& archetype,
+                  const std::vector<ImageType::Pointer>& volumes, bool compress)
+{
+  DatabaseType::CreateFromFileArchetype(databaseFileName.c_str(), archetype.c_str(), 1073741824, compress);
+
+  DatabaseType::Pointer database = DatabaseType::New();
+  database->Connect(databaseFileName.c_str());
+  if (database->GetCompressed() != compress)
+    {
+    std::cerr << "Database compression mismatch for " << databaseFileName << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (database->GetNumberOfVolumes() != static_cast<int>(volumes.size()))
+    {
+    std::cerr << "Expected " << volumes.size() << " volumes in " << databaseFileName
+              << ", got " << database->GetNumberOfVolumes() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Voxels in full blocks, partial blocks and at the image corners
+  const ImageType::SizeType size = volumes[0]->GetLargestPossibleRegion().GetSize();
+  const long voxels[][3] = {
+    {0, 0, 0}, {5, 9, 3}, {16, 15, 16}, {35, 19, 17},
+    {static_cast<long>(size[0]) - 1, static_cast<long>(size[1]) - 1, static_cast<long>(size[2]) - 1} };
+  for (const long* voxel : voxels)
+    {
+    ImageType::IndexType index = {{ voxel[0], voxel[1], voxel[2] }};
+    if (CheckVoxelTimeSeries(database, volumes, index) != EXIT_SUCCESS)
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Region within a block, across blocks, and the whole image
+  ImageType::RegionType regions[3];
+  regions[0].SetIndex(0, 2); regions[0].SetIndex(1, 3); regions[0].SetIndex(2, 4);
+  regions[0].SetSize(0, 5); regions[0].SetSize(1, 4); regions[0].SetSize(2, 3);
+  regions[1].SetIndex(0, 10); regions[1].SetIndex(1, 12); regions[1].SetIndex(2, 14);
+  regions[1].SetSize(0, 25); regions[1].SetSize(1, 8); regions[1].SetSize(2, 4);
+  regions[2] = volumes[0]->GetLargestPossibleRegion();
+  for (const ImageType::RegionType& region : regions)
+    {
+    if (CheckRegionTimeSeries(database, volumes, region) != EXIT_SUCCESS)
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  database->Disconnect();
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  itk::itkFactoryRegistration();
+
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " <temporary directory>" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string directory = std::string(argv[1]) + "/itkTimeSeriesDatabaseTest";
+  itksys::SystemTools::RemoveADirectory(directory);
+  itksys::SystemTools::MakeDirectory(directory);
+
+  // Source volumes, named so that the archetype matches all of them
+  const unsigned int numberOfVolumes = 5;
+  std::vector<ImageType::Pointer> volumes;
+  std::string archetype;
+  for (unsigned int volume = 0; volume < numberOfVolumes; ++volume)
+    {
+    volumes.push_back(CreateVolume(volume));
+    std::ostringstream fileName;
+    fileName << directory << "/Volume" << volume + 1 << ".nrrd";
+    if (archetype.empty())
+      {
+      archetype = fileName.str();
+      }
+    typedef itk::ImageFileWriter<ImageType> WriterType;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetFileName(fileName.str());
+    writer->SetInput(volumes.back());
+    writer->Update();
+    }
+
+  try
+    {
+    if (CheckDatabase(directory + "/Uncompressed.tsd", archetype, volumes, false) != EXIT_SUCCESS)
+      {
+      std::cerr << "Uncompressed database test failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (CheckDatabase(directory + "/Compressed.tsd", archetype, volumes, true) != EXIT_SUCCESS)
+      {
+      std::cerr << "Compressed database test failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  catch (itk::ExceptionObject& err)
+    {
+    std::cerr << "Exception caught: " << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itksys::SystemTools::RemoveADirectory(directory);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+
+#include <vtkITKArchetypeImageSeriesScalarReader.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// ITK includes
+#include <itkConfigure.h>
+#include <itkFactoryRegistration.h>
+#include <itksys/Directory.hxx>
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader> ReadSeries(
+  const char* archetype, bool useHeaderIndexFile, const std::string& headerIndexDirectory)
+{
+  vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader> reader =
+    vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader>::New();
+  reader->SetArchetype(archetype);
+  reader->SetSingleFile(0);
+  reader->SetOutputScalarTypeToNative();
+  reader->SetDesiredCoordinateOrientationToNative();
+  reader->SetUseHeaderIndexFile(useHeaderIndexFile);
+  reader->SetHeaderIndexDirectory(headerIndexDirectory.c_str());
+  try
+    {
+    reader->Update();
+    }
+  catch (itk::ExceptionObject &err)
+    {
+    std::cerr << "Unable to read series '" << archetype << "', err = \n" << err << std::endl;
+    return nullptr;
+    }
+  return reader;
+}
+
+//----------------------------------------------------------------------------
+bool IsSameSeries(vtkITKArchetypeImageSeriesScalarReader* reader,
+                  vtkITKArchetypeImageSeriesScalarReader* baselineReader)
+{
+  if (reader->GetNumberOfFileNames() != baselineReader->GetNumberOfFileNames())
+    {
+    std::cerr << "Number of files mismatch: " << reader->GetNumberOfFileNames()
+              << " != " << baselineReader->GetNumberOfFileNames() << std::endl;
+    return false;
+    }
+  for (int i = 0; i < 4; i++)
+    {
+    for (int j = 0; j < 4; j++)
+      {
+      if (reader->GetRasToIjkMatrix()->GetElement(i, j) != baselineReader->GetRasToIjkMatrix()->GetElement(i, j))
+        {
+        std::cerr << "RasToIjk matrix mismatch at (" << i << ", " << j << ")" << std::endl;
+        return false;
+        }
+      }
+    }
+  vtkImageData* image = reader->GetOutput();
+  vtkImageData* baselineImage = baselineReader->GetOutput();
+  int* dimensions = image->GetDimensions();
+  int* baselineDimensions = baselineImage->GetDimensions();
+  if (dimensions[0] != baselineDimensions[0] || dimensions[1] != baselineDimensions[1]
+    || dimensions[2] != baselineDimensions[2])
+    {
+    std::cerr << "Image dimensions mismatch" << std::endl;
+    return false;
+    }
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  vtkDataArray* baselineScalars = baselineImage->GetPointData()->GetScalars();
+  if (!scalars || !baselineScalars
+    || scalars->GetDataType() != baselineScalars->GetDataType()
+    || scalars->GetDataSize() != baselineScalars->GetDataSize()
+    || memcmp(scalars->GetVoidPointer(0), baselineScalars->GetVoidPointer(0),
+              scalars->GetDataSize() * scalars->GetDataTypeSize()) != 0)
+    {
+    std::cerr << "Voxel values mismatch" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  itk::itkFactoryRegistration();
+
+  if (argc < 3)
+    {
+    std::cerr << "Usage: " << argv[0] << " <archetype DICOM file> <temporary directory>" << std::endl;
+    return 1;
+    }
+  const char* archetype = argv[1];
+  std::string dicomDirectory = itksys::SystemTools::GetFilenamePath(
+    itksys::SystemTools::CollapseFullPath(archetype));
+  std::string headerIndexDirectory = std::string(argv[2]) + "/vtkITKArchetypeImageSeriesReaderHeaderIndexTest";
+  itksys::SystemTools::RemoveADirectory(headerIndexDirectory);
+
+  itksys::Directory dicomFiles;
+  dicomFiles.Load(dicomDirectory);
+  unsigned long numberOfDICOMDirectoryFiles = dicomFiles.GetNumberOfFiles();
+
+  vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader> baselineReader =
+    ReadSeries(archetype, false, headerIndexDirectory);
+  if (!baselineReader)
+    {
+    return 1;
+    }
+  if (itksys::SystemTools::FileExists(headerIndexDirectory))
+    {
+    std::cerr << "Header index is written while it is disabled" << std::endl;
+    return 1;
+    }
+
+  // First read with the index enabled: the headers are analyzed and indexed
+  vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader> indexingReader =
+    ReadSeries(archetype, true, headerIndexDirectory);
+  if (!indexingReader || !IsSameSeries(indexingReader, baselineReader))
+    {
+    std::cerr << "First read with header index failed" << std::endl;
+    return 1;
+    }
+  std::string headerIndexFilePath = indexingReader->GetHeaderIndexFilePath(dicomDirectory);
+  if (!itksys::SystemTools::FileExists(headerIndexFilePath, true))
+    {
+    std::cerr << "Header index file not found: " << headerIndexFilePath << std::endl;
+    return 1;
+    }
+  dicomFiles.Load(dicomDirectory);
+  if (dicomFiles.GetNumberOfFiles() != numberOfDICOMDirectoryFiles)
+    {
+    std::cerr << "Files were written in the DICOM directory " << dicomDirectory << std::endl;
+    return 1;
+    }
+
+  // Second read with the index enabled: the header values come from the index
+  vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader> indexedReader =
+    ReadSeries(archetype, true, headerIndexDirectory);
+  if (!indexedReader || !IsSameSeries(indexedReader, baselineReader))
+    {
+    std::cerr << "Second read with header index failed" << std::endl;
+    return 1;
+    }
+
+  itksys::SystemTools::RemoveADirectory(headerIndexDirectory);
+  return 0;
+}
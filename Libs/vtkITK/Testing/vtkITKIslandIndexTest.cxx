@@ -0,0 +1,204 @@
+
+#include <vtkITKIslandIndex.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Image size is chosen so that islands touch the image boundaries
+vtkSmartPointer<vtkImageData> CreateLabelmap()
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(0, 39, 0, 29, 0, 19);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* voxels = static_cast<unsigned char*>(image->GetScalarPointer());
+  unsigned int seed = 12345;
+  for (vtkIdType index = 0; index < image->GetNumberOfPoints(); ++index)
+    {
+    seed = seed * 1103515245 + 12345;
+    // About 40% of the voxels are foreground, using different label values
+    unsigned int value = (seed >> 16) % 10;
+    voxels[index] = (value < 4 ? static_cast<unsigned char>(value + 1) : 0);
+    }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+void FillExtent(vtkImageData* image, const int extent[6], unsigned char value)
+{
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        *static_cast<unsigned char*>(image->GetScalarPointer(i, j, k)) = value;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool IsSameIndex(vtkITKIslandIndex* index, vtkITKIslandIndex* baselineIndex, vtkImageData* image)
+{
+  if (index->GetNumberOfIslands() != baselineIndex->GetNumberOfIslands())
+    {
+    std::cerr << "Number of islands mismatch: " << index->GetNumberOfIslands()
+              << " != " << baselineIndex->GetNumberOfIslands() << std::endl;
+    return false;
+    }
+  vtkNew<vtkIdTypeArray> sizes;
+  index->GetIslandSizes(sizes.GetPointer());
+  vtkNew<vtkIdTypeArray> baselineSizes;
+  baselineIndex->GetIslandSizes(baselineSizes.GetPointer());
+  if (sizes->GetNumberOfValues() != baselineSizes->GetNumberOfValues())
+    {
+    std::cerr << "Number of island sizes mismatch" << std::endl;
+    return false;
+    }
+  for (vtkIdType islandIndex = 0; islandIndex < sizes->GetNumberOfValues(); ++islandIndex)
+    {
+    if (sizes->GetValue(islandIndex) != baselineSizes->GetValue(islandIndex))
+      {
+      std::cerr << "Size mismatch for island " << islandIndex << ": " << sizes->GetValue(islandIndex)
+                << " != " << baselineSizes->GetValue(islandIndex) << std::endl;
+      return false;
+      }
+    }
+  int* extent = image->GetExtent();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        if (index->GetIslandSize(i, j, k) != baselineIndex->GetIslandSize(i, j, k))
+          {
+          std::cerr << "Island size mismatch at (" << i << ", " << j << ", " << k << "): "
+                    << index->GetIslandSize(i, j, k) << " != " << baselineIndex->GetIslandSize(i, j, k) << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool IsSameImage(vtkImageData* image, vtkImageData* baselineImage)
+{
+  return memcmp(image->GetScalarPointer(), baselineImage->GetScalarPointer(),
+    image->GetNumberOfPoints() * image->GetScalarSize()) == 0;
+}
+
+//----------------------------------------------------------------------------
+int TestUpdateExtent(bool fullyConnected)
+{
+  vtkSmartPointer<vtkImageData> image = CreateLabelmap();
+  vtkNew<vtkITKIslandIndex> index;
+  index->SetFullyConnected(fullyConnected);
+  if (!index->Build(image))
+    {
+    std::cerr << "Failed to build island index" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Modifications that merge islands (solid block), split islands (empty slab),
+  // and change voxels at the image boundaries and in a single voxel
+  const int modifiedExtents[][6] = {
+    { 5, 20, 3, 12, 2, 9 },
+    { 0, 39, 14, 15, 0, 19 },
+    { 30, 39, 25, 29, 15, 19 },
+    { 0, 0, 0, 0, 0, 0 },
+    { 10, 12, 0, 29, 4, 4 } };
+  const unsigned char values[] = { 3, 0, 1, 2, 0 };
+  for (int modification = 0; modification < 5; ++modification)
+    {
+    FillExtent(image, modifiedExtents[modification], values[modification]);
+    if (!index->UpdateExtent(image, modifiedExtents[modification]))
+      {
+      std::cerr << "Failed to update island index" << std::endl;
+      return EXIT_FAILURE;
+      }
+    vtkNew<vtkITKIslandIndex> baselineIndex;
+    baselineIndex->SetFullyConnected(fullyConnected);
+    baselineIndex->Build(image);
+    if (!IsSameIndex(index.GetPointer(), baselineIndex.GetPointer(), image))
+      {
+      std::cerr << "Updated index differs from the rebuilt index after modification " << modification
+                << " (FullyConnected=" << fullyConnected << ")" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Removing islands using the updated index gives the same result as using a rebuilt index
+  vtkNew<vtkImageData> baselineImage;
+  baselineImage->DeepCopy(image);
+  vtkNew<vtkITKIslandIndex> baselineIndex;
+  baselineIndex->SetFullyConnected(fullyConnected);
+  baselineIndex->Build(baselineImage.GetPointer());
+  const vtkIdType minimumSize = 10;
+  int removedIslandCount = index->RemoveSmallIslands(image, minimumSize);
+  int baselineRemovedIslandCount = baselineIndex->RemoveSmallIslands(baselineImage.GetPointer(), minimumSize);
+  if (removedIslandCount <= 0 || removedIslandCount != baselineRemovedIslandCount
+    || !IsSameImage(image, baselineImage.GetPointer())
+    || !IsSameIndex(index.GetPointer(), baselineIndex.GetPointer(), image))
+    {
+    std::cerr << "RemoveSmallIslands result mismatch: " << removedIslandCount
+              << " != " << baselineRemovedIslandCount << std::endl;
+    return EXIT_FAILURE;
+    }
+  removedIslandCount = index->KeepLargestIsland(image);
+  baselineRemovedIslandCount = baselineIndex->KeepLargestIsland(baselineImage.GetPointer());
+  if (removedIslandCount != baselineRemovedIslandCount
+    || !IsSameImage(image, baselineImage.GetPointer())
+    || index->GetNumberOfIslands() != 1)
+    {
+    std::cerr << "KeepLargestIsland result mismatch: " << removedIslandCount
+              << " != " << baselineRemovedIslandCount << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Index is rebuilt if the extent of the image changed
+  vtkNew<vtkImageData> croppedImage;
+  croppedImage->SetExtent(0, 9, 0, 9, 0, 9);
+  croppedImage->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  croppedImage->GetPointData()->GetScalars()->Fill(1);
+  const int croppedExtent[6] = { 0, 0, 0, 0, 0, 0 };
+  if (!index->UpdateExtent(croppedImage.GetPointer(), croppedExtent)
+    || index->GetNumberOfIslands() != 1 || index->GetLargestIslandSize() != 1000)
+    {
+    std::cerr << "Index is not rebuilt after the image extent changed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int main(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  if (TestUpdateExtent(false) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+  if (TestUpdateExtent(true) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
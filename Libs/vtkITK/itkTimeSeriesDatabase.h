@@ -7,6 +7,8 @@
 #include <itkImageSource.h>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <itkTimeSeriesDatabaseHelper.h>
 
 #define TimeSeriesBlockSize 16
@@ -24,6 +26,13 @@ namespace itk
  * The main idea behind TimeSeriesDatabase is to have a representation of a 4 dimensional dataset that
  * is larger than main memory, but may still be accessed in a rapid manner.  Though not strictly
  * ITK conforming, this initial pass is strictly 4 dimensional datasets.
+ *
+ * The database files are memory mapped when possible: uncompressed blocks are
+ * then read directly from the mapping without copy, and reading is thread safe.
+ * Blocks may optionally be stored compressed (see CreateFromFileArchetype),
+ * decompressed blocks are kept in an LRU cache shared between threads.
+ * When a volume is read, the same blocks of the following volumes are
+ * prefetched in the background (see SetReadAheadVolumes).
  */
 template <class TPixel> class TimeSeriesDatabase : public ImageSource<Image<TPixel,3> > {
 public:
@@ -68,6 +77,11 @@ public:
    */
   static void CreateFromFileArchetype ( const char* filename, const char* archetype );
   static void CreateFromFileArchetype ( const char* filename, const char* archetype, unsigned long BlocksPerFile );
+  /** Create a new TimeSeriesDatabase, optionally compressing each block with zlib.
+   * Compressed databases are smaller and faster to read from slow storage, at the
+   * cost of decompressing each block when it is first accessed.
+   */
+  static void CreateFromFileArchetype ( const char* filename, const char* archetype, unsigned long FileSize, bool Compress );
 
   /** Set the image to be read when GenerateData is called.
    * This method selects the image to be returned by an Update
@@ -89,11 +103,26 @@ public:
   void GenerateData(void) override;
 
   /** A convenience method for reading a voxel's time course
-   * Subsequent calls to voxels in the immediate region of this will be
-   * cached for quick access
+   * The blocks containing the voxel are prefetched for all the volumes
+   * at once. Throws an exception if the index is outside of the image.
    */
   void GetVoxelTimeSeries ( typename OutputImageType::IndexType idx, ArrayType& array );
 
+  /** Mean time course of the voxels of a region.
+   * The region is cropped to the image. Volumes are processed concurrently.
+   * Throws an exception if the region does not intersect the image.
+   */
+  void GetRegionTimeSeries ( typename OutputImageType::RegionType region, Array<double>& array );
+
+  /** Number of following volumes that are prefetched when a volume is read
+   * (default 8). 0 disables read-ahead.
+   */
+  itkSetMacro ( ReadAheadVolumes, unsigned int );
+  itkGetMacro ( ReadAheadVolumes, unsigned int );
+
+  /** Return true if the blocks are stored compressed */
+  itkGetMacro ( Compressed, bool );
+
   /** Set the size of the cache in MiB (1 MiB = 2^20 bytes)
    */
   void SetCacheSizeInMiB ( float sz );
@@ -116,6 +145,18 @@ protected:
   typename OutputImageType::DirectionType m_OutputDirection;
 
   typedef itk::TimeSeriesDatabaseHelper::counted_ptr<std::fstream> StreamPtr;
+  typedef std::shared_ptr<itk::TimeSeriesDatabaseHelper::MappedFile> MappedFilePtr;
+
+  /// Pointer to the pixels of a block, keeps the block memory valid while it is in use
+  typedef std::shared_ptr<const TPixel> BlockPointer;
+
+  /// Location of a compressed block in the database files
+  struct BlockLocation
+  {
+    unsigned long long Offset;
+    unsigned int       Size;
+    unsigned int       FileIndex;
+  };
 
   static std::streampos CalculatePosition ( unsigned long index, unsigned long BlocksPerFile );
 
@@ -130,23 +171,44 @@ protected:
                                typename OutputImageType::RegionType& ImageRegion );
   bool IsOpen() const;
 
+  /// Return the pixels of the block at index. Thread safe.
+  BlockPointer GetBlock ( unsigned long index );
+  /// Start loading the block at index in the background, if the files are memory mapped
+  void PrefetchBlock ( unsigned long index ) const;
+  /// Return false if the block is not in the database files
+  bool GetBlockLocation ( unsigned long index, unsigned int& fileIndex, unsigned long long& offset, unsigned int& size ) const;
+  /// Read the block from a stream or decompress it from a memory mapped file
+  void ReadBlock ( unsigned long index, TPixel* data );
+  /// Prefetch the block at BlockPosition in NumberOfImages volumes, starting at FirstImage
+  void PrefetchTimeSeries ( Size<3> BlockPosition, int FirstImage, int NumberOfImages );
+
   /// How many pixels are in the last block?
   Array<unsigned int> m_PixelRemainder;
 
   std::string  m_Filename;
   unsigned int m_CurrentImage;
 
-  std::vector<StreamPtr>   m_DatabaseFiles;
-  std::vector<std::string> m_DatabaseFileNames;
-  unsigned long            m_BlocksPerFile;
+  /// Streams are used only for the files that cannot be memory mapped
+  std::vector<StreamPtr>     m_DatabaseFiles;
+  std::vector<MappedFilePtr> m_MappedFiles;
+  std::vector<std::string>   m_DatabaseFileNames;
+  unsigned long              m_BlocksPerFile;
+  unsigned long              m_NumberOfBlocks;
+  std::mutex                 m_StreamMutex;
+
+  /// Compressed databases store the location of each block in a block table file
+  bool                       m_Compressed;
+  std::vector<BlockLocation> m_BlockTable;
+
+  unsigned int m_ReadAheadVolumes;
 
-  /// our cache
+  /// our cache, for blocks that are not read directly from a memory mapped file
   struct CacheBlock
   {
     TPixel data[TimeSeriesBlockSize*TimeSeriesBlockSize*TimeSeriesBlockSize];
   };
-  TimeSeriesDatabaseHelper::LRUCache<unsigned long, CacheBlock> m_Cache;
-  CacheBlock* GetCacheBlock ( unsigned long index );
+  TimeSeriesDatabaseHelper::LRUCache<unsigned long, std::shared_ptr<CacheBlock> > m_Cache;
+  std::mutex m_CacheMutex;
 };
 
 } // end namespace itk
@@ -11,6 +11,10 @@
 #include <itkImageFileReader.h>
 #include <itksys/SystemTools.hxx>
 #include "itkArchetypeSeriesFileNames.h"
+#include <itkMultiThreaderBase.h>
+#include "itk_zlib.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <vector>
 
@@ -53,19 +57,30 @@ bool TimeSeriesDatabase<TPixel>::CalculateIntersection ( Size<3> BlockIndex,
 template <class TPixel>
 bool TimeSeriesDatabase<TPixel>::IsOpen () const
 {
-  if ( this->m_DatabaseFiles.size() == 0 ) { return false; }
-  return const_cast<std::fstream*>(this->m_DatabaseFiles[0].get())->is_open();
+  return this->m_DatabaseFileNames.size() > 0;
 }
 
 template <class TPixel>
 void TimeSeriesDatabase<TPixel>::Disconnect ()
 {
-  for ( int idx = 0; idx < this->m_DatabaseFiles.size(); idx++ )
+  {
+  std::lock_guard<std::mutex> lock ( this->m_StreamMutex );
+  for ( ::size_t idx = 0; idx < this->m_DatabaseFiles.size(); idx++ )
     {
-    this->m_DatabaseFiles[idx]->close();
+    if ( this->m_DatabaseFiles[idx].get() )
+      {
+      this->m_DatabaseFiles[idx]->close();
+      }
     }
   this->m_DatabaseFiles.clear();
+  }
+  this->m_MappedFiles.clear();
   this->m_DatabaseFileNames.clear();
+  this->m_BlockTable.clear();
+  this->m_Compressed = false;
+  this->m_NumberOfBlocks = 0;
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  this->m_Cache.clear();
 }
 
 template <class TPixel>
@@ -90,9 +105,10 @@ void TimeSeriesDatabase<TPixel>::Connect ( const char* filename )
   ::std::string foo;
   float version;
   o >> foo >> foo >> version;
-  if ( version != 1.0 )
+  // Version 1.1 adds optional block compression
+  if ( version != 1.0f && version != 1.1f )
   {
-    itkExceptionMacro ( "TimeSeriesDatabase::Connect: Version string does not match.  Expecting 1.0, found " << version );
+    itkExceptionMacro ( "TimeSeriesDatabase::Connect: Version string does not match.  Expecting 1.0 or 1.1, found " << version );
   }
   // Start reading our data
   std::string dummy;
@@ -121,15 +137,63 @@ void TimeSeriesDatabase<TPixel>::Connect ( const char* filename )
   // Read the "Filenames:" line
   o >> dummy;
   this->m_DatabaseFiles.clear();
+  this->m_MappedFiles.clear();
   this->m_DatabaseFileNames.clear();
+  {
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  this->m_Cache.clear();
+  }
+  this->m_NumberOfBlocks = 1 + m_BlocksPerImage[0] * m_BlocksPerImage[1] * m_BlocksPerImage[2] * m_Dimensions[3];
   // Read and open the files
+  std::vector<std::string> Filenames;
   for ( int idx = 0; idx < NumberOfFiles; idx++ )
     {
     std::string Filename;
     o >> Filename;
-    // std::cout << "Reading file " << idx << " " << Filename << std::endl;
-    this->m_DatabaseFileNames.push_back ( Filename );
-    this->m_DatabaseFiles.push_back ( StreamPtr ( new std::fstream ( Filename.c_str(), ::std::ios::in | ::std::ios::binary ) ) );
+    Filenames.push_back ( Filename );
+    }
+  std::string BlockTableFilename;
+  this->m_Compressed = false;
+  if ( version > 1.0f )
+    {
+    std::string Compression;
+    o >> dummy >> Compression;
+    o >> dummy >> BlockTableFilename;
+    if ( Compression != "zlib" && Compression != "none" )
+      {
+      itkExceptionMacro ( "TimeSeriesDatabase::Connect: Unknown compression " << Compression );
+      }
+    this->m_Compressed = ( Compression == "zlib" );
+    }
+  for ( int idx = 0; idx < NumberOfFiles; idx++ )
+    {
+    // Map the file in memory if possible (address space may be limited), use a stream otherwise
+    MappedFilePtr mapped ( new TimeSeriesDatabaseHelper::MappedFile );
+    StreamPtr stream;
+    if ( !mapped->Map ( Filenames[idx] ) )
+      {
+      mapped.reset();
+      stream = StreamPtr ( new std::fstream ( Filenames[idx].c_str(), ::std::ios::in | ::std::ios::binary ) );
+      if ( !stream->is_open() )
+        {
+        this->Disconnect();
+        itkExceptionMacro ( "TimeSeriesDatabase::Connect: Failed to open " << Filenames[idx] );
+        }
+      }
+    this->m_DatabaseFileNames.push_back ( Filenames[idx] );
+    this->m_MappedFiles.push_back ( mapped );
+    this->m_DatabaseFiles.push_back ( stream );
+    }
+  if ( this->m_Compressed )
+    {
+    this->m_BlockTable.resize ( this->m_NumberOfBlocks );
+    std::ifstream BlockTableFile ( BlockTableFilename.c_str(), ::std::ios::in | ::std::ios::binary );
+    BlockTableFile.read ( reinterpret_cast<char*> ( &this->m_BlockTable[0] ), this->m_NumberOfBlocks * sizeof ( BlockLocation ) );
+    if ( !BlockTableFile )
+      {
+      this->Disconnect();
+      itkExceptionMacro ( "TimeSeriesDatabase::Connect: Failed to read block table " << BlockTableFilename );
+      }
     }
   /*
   std::cout << "ImageSize: " << m_OutputRegion.GetSize() << endl;
@@ -184,45 +248,210 @@ template <class TPixel>
 
 
 template <class TPixel>
-typename TimeSeriesDatabase<TPixel>::CacheBlock* TimeSeriesDatabase<TPixel>::GetCacheBlock ( unsigned long index )
+bool TimeSeriesDatabase<TPixel>::GetBlockLocation ( unsigned long index, unsigned int& fileIndex, unsigned long long& offset, unsigned int& size ) const
+{
+  if ( index == 0 || index >= this->m_NumberOfBlocks )
+    {
+    return false;
+    }
+  if ( this->m_Compressed )
+    {
+    const BlockLocation& location = this->m_BlockTable[index];
+    fileIndex = location.FileIndex;
+    offset = location.Offset;
+    size = location.Size;
+    }
+  else
+    {
+    fileIndex = CalculateFileIndex ( index, this->m_BlocksPerFile );
+    offset = static_cast<unsigned long long> ( index % this->m_BlocksPerFile ) * sizeof ( TPixel ) * TimeSeriesVolumeBlockSize;
+    size = sizeof ( TPixel ) * TimeSeriesVolumeBlockSize;
+    }
+  return fileIndex < this->m_DatabaseFileNames.size() && size > 0;
+}
+
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::ReadBlock ( unsigned long index, TPixel* data )
+{
+  const unsigned int BlockBytes = sizeof ( TPixel ) * TimeSeriesVolumeBlockSize;
+  unsigned int fileIndex = 0;
+  unsigned long long offset = 0;
+  unsigned int size = 0;
+  if ( !this->GetBlockLocation ( index, fileIndex, offset, size ) || size > compressBound ( BlockBytes ) )
+    {
+    itkExceptionMacro ( "TimeSeriesDatabase::ReadBlock: block " << index << " is not in the database" );
+    }
+  const char* source = nullptr;
+  std::vector<char> buffer;
+  const MappedFilePtr& mapped = this->m_MappedFiles[fileIndex];
+  if ( mapped && offset + size <= mapped->GetLength() )
+    {
+    source = mapped->GetData() + offset;
+    }
+  else
+    {
+    buffer.resize ( size );
+    std::lock_guard<std::mutex> lock ( this->m_StreamMutex );
+    const StreamPtr& stream = this->m_DatabaseFiles[fileIndex];
+    if ( stream.get() )
+      {
+      stream->clear();
+      stream->seekg ( static_cast<std::streamoff> ( offset ) );
+      stream->read ( &buffer[0], size );
+      }
+    if ( !stream.get() || !*stream )
+      {
+      itkExceptionMacro ( "TimeSeriesDatabase::ReadBlock: failed to read block " << index << " from " << this->m_DatabaseFileNames[fileIndex] );
+      }
+    source = &buffer[0];
+    }
+  // Blocks that do not compress are stored as is
+  if ( size == BlockBytes )
+    {
+    memcpy ( data, source, BlockBytes );
+    return;
+    }
+  uLongf dataLength = BlockBytes;
+  if ( uncompress ( reinterpret_cast<Bytef*> ( data ), &dataLength, reinterpret_cast<const Bytef*> ( source ), size ) != Z_OK
+       || dataLength != BlockBytes )
+    {
+    itkExceptionMacro ( "TimeSeriesDatabase::ReadBlock: failed to decompress block " << index );
+    }
+}
+
+template <class TPixel>
+typename TimeSeriesDatabase<TPixel>::BlockPointer TimeSeriesDatabase<TPixel>::GetBlock ( unsigned long index )
 {
-  CacheBlock* Buffer = this->m_Cache.find ( index );
-  if ( Buffer == nullptr ) {
-    // Fill it in
-    CacheBlock B;
-    int FileIdx = this->CalculateFileIndex ( index );
-
-    this->m_DatabaseFiles[FileIdx]->seekg ( this->CalculatePosition ( index, this->m_BlocksPerFile ) );
-    this->m_DatabaseFiles[FileIdx]->read ( reinterpret_cast<char*> ( B.data ), TimeSeriesVolumeBlockSize * sizeof ( TPixel ) );
-    this->m_Cache.insert ( index, B );
-    Buffer = this->m_Cache.find ( index );
+  if ( !this->m_Compressed )
+    {
+    unsigned int fileIndex = 0;
+    unsigned long long offset = 0;
+    unsigned int size = 0;
+    if ( this->GetBlockLocation ( index, fileIndex, offset, size ) )
+      {
+      const MappedFilePtr& mapped = this->m_MappedFiles[fileIndex];
+      if ( mapped && offset + size <= mapped->GetLength() )
+        {
+        // No copy, the mapping is kept alive as long as the block is referenced
+        return BlockPointer ( mapped, reinterpret_cast<const TPixel*> ( mapped->GetData() + offset ) );
+        }
+      }
+    }
+  {
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  std::shared_ptr<CacheBlock>* cached = this->m_Cache.find ( index );
+  if ( cached )
+    {
+    return BlockPointer ( *cached, (*cached)->data );
+    }
+  }
+  // Read without holding the lock so that other threads can use the cache meanwhile
+  std::shared_ptr<CacheBlock> block = std::make_shared<CacheBlock>();
+  this->ReadBlock ( index, block->data );
+  {
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  this->m_Cache.insert ( index, block );
   }
-  return Buffer;
+  return BlockPointer ( block, block->data );
 }
 
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::PrefetchBlock ( unsigned long index ) const
+{
+  unsigned int fileIndex = 0;
+  unsigned long long offset = 0;
+  unsigned int size = 0;
+  if ( this->GetBlockLocation ( index, fileIndex, offset, size ) && this->m_MappedFiles[fileIndex] )
+    {
+    this->m_MappedFiles[fileIndex]->WillNeed ( static_cast<size_t> ( offset ), size );
+    }
+}
+
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::PrefetchTimeSeries ( Size<3> BlockPosition, int FirstImage, int NumberOfImages )
+{
+  int LastImage = TSD_MIN<int> ( FirstImage + NumberOfImages, this->m_Dimensions[3] );
+  for ( int image = TSD_MAX<int> ( FirstImage, 0 ); image < LastImage; image++ )
+    {
+    this->PrefetchBlock ( this->CalculateIndex ( BlockPosition, image ) );
+    }
+}
 
 template <class TPixel>
 void TimeSeriesDatabase<TPixel>::GetVoxelTimeSeries ( typename OutputImageType::IndexType idx, ArrayType& array )
 {
   // See if the index is inside the volume
   // and figure out which cache block we need
+  if ( !this->m_OutputRegion.IsInside ( idx ) )
+    {
+    itkExceptionMacro ( "TimeSeriesDatabase::GetVoxelTimeSeries: index " << idx << " is outside of the image" );
+    }
   Size<3> CurrentBlock;
   Size<3> Offset;
   for ( int i = 0; i < 3; i++ ) {
-    if ( idx[i] < 0 || idx[i] > this->m_OutputRegion.Size[i] ) {
-      throw 1;
-    }
-    CurrentBlock[i] = reinterpret_cast<unsigned long> ( idx[i] / (double)TimeSeriesBlockSize );
+    CurrentBlock[i] = idx[i] / TimeSeriesBlockSize;
     Offset[i] = idx[i] % TimeSeriesBlockSize;
   }
   unsigned long offset = Offset[0] + Offset[1] * TimeSeriesBlockSize + Offset[2] * TimeSeriesBlockSizeP2;
-  array = ArrayType ( this->m_Dimensions[3] );
-  for ( int volume = 0; volume < this->m_Dimensions[3]; volume++ ) {
-    CacheBlock* cache = this->GetCacheBlock ( CurrentBlock, volume );
-    array[volume] = cache->data[offset];
+  int NumberOfVolumes = this->m_Dimensions[3];
+  // Let the system load all the blocks concurrently
+  this->PrefetchTimeSeries ( CurrentBlock, 0, NumberOfVolumes );
+  array.SetSize ( NumberOfVolumes );
+  for ( int volume = 0; volume < NumberOfVolumes; volume++ ) {
+    BlockPointer block = this->GetBlock ( this->CalculateIndex ( CurrentBlock, volume ) );
+    array[volume] = block.get()[offset];
   }
 }
 
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::GetRegionTimeSeries ( typename OutputImageType::RegionType region, Array<double>& array )
+{
+  if ( !region.Crop ( this->m_OutputRegion ) || region.GetNumberOfPixels() == 0 )
+    {
+    itkExceptionMacro ( "TimeSeriesDatabase::GetRegionTimeSeries: region " << region << " does not intersect the image" );
+    }
+  Size<3> BlockStart, BlockEnd, CurrentBlock;
+  for ( unsigned int i = 0; i < 3; i++ ) {
+    BlockStart[i] = region.GetIndex(i) / TimeSeriesBlockSize;
+    BlockEnd[i] = ( region.GetIndex(i) + region.GetSize(i) - 1 ) / TimeSeriesBlockSize + 1;
+  }
+  int NumberOfVolumes = this->m_Dimensions[3];
+  for ( CurrentBlock[2] = BlockStart[2]; CurrentBlock[2] < BlockEnd[2]; CurrentBlock[2]++ ) {
+    for ( CurrentBlock[1] = BlockStart[1]; CurrentBlock[1] < BlockEnd[1]; CurrentBlock[1]++ ) {
+      for ( CurrentBlock[0] = BlockStart[0]; CurrentBlock[0] < BlockEnd[0]; CurrentBlock[0]++ ) {
+        this->PrefetchTimeSeries ( CurrentBlock, 0, NumberOfVolumes );
+      }
+    }
+  }
+
+  const double NumberOfVoxels = region.GetNumberOfPixels();
+  array.SetSize ( NumberOfVolumes );
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  threader->ParallelizeArray ( 0, NumberOfVolumes, [&] ( SizeValueType volume )
+    {
+    double sum = 0.0;
+    Size<3> Block;
+    for ( Block[2] = BlockStart[2]; Block[2] < BlockEnd[2]; Block[2]++ ) {
+      for ( Block[1] = BlockStart[1]; Block[1] < BlockEnd[1]; Block[1]++ ) {
+        for ( Block[0] = BlockStart[0]; Block[0] < BlockEnd[0]; Block[0]++ ) {
+          typename OutputImageType::RegionType BR, IR;
+          this->CalculateIntersection ( Block, region, BR, IR );
+          BlockPointer block = this->GetBlock ( this->CalculateIndex ( Block, volume ) );
+          for ( unsigned int bz = BR.GetIndex(2); bz < BR.GetIndex(2) + BR.GetSize(2); bz++ ) {
+            for ( unsigned int by = BR.GetIndex(1); by < BR.GetIndex(1) + BR.GetSize(1); by++ ) {
+              const TPixel* row = block.get() + BR.GetIndex(0) + TimeSeriesBlockSize*by + TimeSeriesBlockSizeP2*bz;
+              for ( unsigned int bx = 0; bx < BR.GetSize(0); bx++ ) {
+                sum += row[bx];
+              }
+            }
+          }
+        }
+      }
+    }
+    array[volume] = sum / NumberOfVoxels;
+    }, nullptr );
+}
+
 
 template <class TPixel>
 void TimeSeriesDatabase<TPixel>::GenerateOutputInformation ( )
@@ -275,7 +504,8 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
         typename OutputImageType::RegionType BR, IR;
         if ( print ) {  std::cout << "For Block Index: " << CurrentBlock << std::endl; }
         unsigned long index = this->CalculateIndex ( CurrentBlock, this->m_CurrentImage );
-        CacheBlock* Buffer = this->GetCacheBlock ( index );
+        BlockPointer Block = this->GetBlock ( index );
+        const TPixel* BlockData = Block.get();
         if ( this->CalculateIntersection ( CurrentBlock, Region, BR, IR ) ) {
           // Just iterate over whole block
           // Good we can use an iterator!
@@ -290,7 +520,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
           BlockRegion.SetIndex ( BlockIndex );
           ImageRegionIterator<OutputImageType> it ( output, IR );
           it.GoToBegin();
-          TPixel* ptr = Buffer->data;
+          const TPixel* ptr = BlockData;
           while ( !it.IsAtEnd() ) {
             it.Set ( *ptr );
             ++it;
@@ -305,7 +535,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
             std::cout << "Count: " << Count << std::endl;
             std::cout << "Block Region: " << BR;
             std::cout << "Image Region: " << IR;
-            std::cout << "First voxel: " << Buffer->data[0] << std::endl;
+            std::cout << "First voxel: " << BlockData[0] << std::endl;
           }
           unsigned int bx, by, bz, x, y, z;
           for ( z = 0; z < Count[2]; z++ ) {
@@ -325,7 +555,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
                 }
                 */
 
-                output->SetPixel ( ImageIndex, Buffer->data[bx + TimeSeriesBlockSize*by + TimeSeriesBlockSize*TimeSeriesBlockSize*bz] );
+                output->SetPixel ( ImageIndex, BlockData[bx + TimeSeriesBlockSize*by + TimeSeriesBlockSize*TimeSeriesBlockSize*bz] );
                 }
               }
             }
@@ -334,6 +564,19 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
       }
     }
 
+  // Read ahead the same blocks in the following volumes,
+  // so that browsing through time does not wait for the disk
+  if ( this->m_ReadAheadVolumes > 0 )
+    {
+    for ( CurrentBlock[2] = BlockStart[2]; CurrentBlock[2] < BlockStart[2] + BlockCount[2]; CurrentBlock[2]++ ) {
+      for ( CurrentBlock[1] = BlockStart[1]; CurrentBlock[1] < BlockStart[1] + BlockCount[1]; CurrentBlock[1]++ ) {
+        for ( CurrentBlock[0] = BlockStart[0]; CurrentBlock[0] < BlockStart[0] + BlockCount[0]; CurrentBlock[0]++ ) {
+          this->PrefetchTimeSeries ( CurrentBlock, this->m_CurrentImage + 1, this->m_ReadAheadVolumes );
+        }
+      }
+    }
+    }
+
   return;
 }
 
@@ -349,6 +592,12 @@ void TimeSeriesDatabase<TPixel>::CreateFromFileArchetype ( const char* TSDFilena
 
 template <class TPixel>
 void TimeSeriesDatabase<TPixel>::CreateFromFileArchetype ( const char* TSDFilename, const char* archetype, unsigned long FileSize )
+{
+  CreateFromFileArchetype ( TSDFilename, archetype, FileSize, false );
+}
+
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::CreateFromFileArchetype ( const char* TSDFilename, const char* archetype, unsigned long FileSize, bool Compress )
 {
 
   unsigned long BlocksPerFile = FileSize / ( TimeSeriesVolumeBlockSize * sizeof ( TPixel ) );
@@ -398,6 +647,13 @@ void TimeSeriesDatabase<TPixel>::CreateFromFileArchetype ( const char* TSDFilena
   std::vector<std::string> Filenames;
   Filenames.push_back ( std::string ( TSDFilename ) );
 
+  // Compressed blocks are written one after the other, the first block of the
+  // first file is reserved for the header. Their locations are stored in the block table.
+  const unsigned int BlockBytes = TimeSeriesVolumeBlockSize * sizeof ( TPixel );
+  std::vector<BlockLocation> BlockTable;
+  std::vector<Bytef> CompressedBuffer ( Compress ? compressBound ( BlockBytes ) : 0 );
+  unsigned long long CompressedOffset = BlockBytes;
+
   // Start reading and writing out the images, 16x16x16 blocks at a time.
   for ( unsigned int i = 0; i < candidateFiles.size(); i++ )
     {
@@ -502,6 +758,38 @@ void TimeSeriesDatabase<TPixel>::CreateFromFileArchetype ( const char* TSDFilena
             }
           // Calculate where to write...  This code is copied from CalculatePosition and CalculateIndex
           unsigned long index = CalculateIndex ( CurrentBlock, i, m_BlocksPerImage );
+          if ( Compress )
+            {
+            // Blocks that do not compress are stored as is
+            const char* BlockData = reinterpret_cast<const char*> ( buffer );
+            unsigned int BlockDataSize = BlockBytes;
+            uLongf CompressedLength = static_cast<uLongf> ( CompressedBuffer.size() );
+            if ( compress2 ( &CompressedBuffer[0], &CompressedLength, reinterpret_cast<const Bytef*> ( buffer ), BlockBytes, Z_BEST_SPEED ) == Z_OK
+                 && CompressedLength < BlockBytes )
+              {
+              BlockData = reinterpret_cast<const char*> ( &CompressedBuffer[0] );
+              BlockDataSize = static_cast<unsigned int> ( CompressedLength );
+              }
+            if ( CompressedOffset + BlockDataSize > FileSize )
+              {
+              ::std::ostringstream newFN;
+              newFN << TSDFilename << db.size();
+              db.push_back ( StreamPtr ( new std::fstream ( newFN.str().c_str(), ::std::ios::out | ::std::ios::binary ) ) );
+              Filenames.push_back ( newFN.str() );
+              CompressedOffset = 0;
+              }
+            if ( index >= BlockTable.size() )
+              {
+              BlockTable.resize ( index + 1 );
+              }
+            BlockTable[index].Offset = CompressedOffset;
+            BlockTable[index].Size = BlockDataSize;
+            BlockTable[index].FileIndex = static_cast<unsigned int> ( db.size() - 1 );
+            db.back()->seekp ( static_cast<std::streamoff> ( CompressedOffset ) );
+            db.back()->write ( BlockData, BlockDataSize );
+            CompressedOffset += BlockDataSize;
+            continue;
+            }
           // Adjust the position, based on the FileIndex
           ::std::streampos position = CalculatePosition ( index, BlocksPerFile );
           unsigned long FileIndex = CalculateFileIndex ( index, BlocksPerFile );
@@ -527,7 +815,7 @@ void TimeSeriesDatabase<TPixel>::CreateFromFileArchetype ( const char* TSDFilena
   db[0]->seekp ( 0 );
   ::std::ostringstream b;
   b << "TimeSeriesDatabase" << ::std::endl;
-  b << "Version 1.0" << ::std::endl;
+  b << ( Compress ? "Version 1.1" : "Version 1.0" ) << ::std::endl;
   b << "Dimensions: " << m_Dimensions[0] << " " << m_Dimensions[1] << " " << m_Dimensions[2] << " " << m_Dimensions[3] << std::endl;
   b << "ImageSize: " << m_OutputRegion.GetSize()[0] << " "<< m_OutputRegion.GetSize()[1] << " " << m_OutputRegion.GetSize()[2] << std::endl;
   b << "ImageOrigin: " << m_OutputOrigin[0] << " " << m_OutputOrigin[1] << " " << m_OutputOrigin[2] << std::endl;
@@ -548,6 +836,14 @@ void TimeSeriesDatabase<TPixel>::CreateFromFileArchetype ( const char* TSDFilena
     {
     b << Filenames[idx] << std::endl;
     }
+  if ( Compress )
+    {
+    std::string BlockTableFilename = std::string ( TSDFilename ) + ".blocks";
+    b << "Compression: zlib" << std::endl;
+    b << "BlockTable: " << BlockTableFilename << std::endl;
+    std::ofstream BlockTableFile ( BlockTableFilename.c_str(), ::std::ios::out | ::std::ios::binary );
+    BlockTableFile.write ( reinterpret_cast<const char*> ( &BlockTable[0] ), BlockTable.size() * sizeof ( BlockLocation ) );
+    }
   // std::cout << b.str() << endl;
   db[0]->write ( b.str().c_str(), strlen ( b.str().c_str() ) );
   for ( ::size_t idx = 0; idx < db.size(); idx++ )
@@ -569,14 +865,22 @@ void TimeSeriesDatabase<TPixel>::SetCacheSizeInMiB ( float sz )
 {
   // How many blocks is this?
   double BlockSizeInMiB = sizeof ( TPixel ) * TimeSeriesVolumeBlockSize / ( 1024*1024.);
-  unsigned long int blocks = (unsigned long int) ceil ( sz * BlockSizeInMiB );
+  unsigned long int blocks = (unsigned long int) ceil ( sz / BlockSizeInMiB );
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
   this->m_Cache.set_maxsize ( blocks );
 }
 
 template <class TPixel>
 TimeSeriesDatabase<TPixel>::TimeSeriesDatabase () : m_Cache ( 1024 ){
   this->m_Dimensions.SetSize ( 4 );
+  this->m_Dimensions.Fill ( 0 );
   this->m_BlocksPerImage.SetSize ( 4 );
+  this->m_BlocksPerImage.Fill ( 0 );
+  this->m_CurrentImage = 0;
+  this->m_BlocksPerFile = 0;
+  this->m_NumberOfBlocks = 0;
+  this->m_Compressed = false;
+  this->m_ReadAheadVolumes = 8;
 }
 
 template <class TPixel>
@@ -598,9 +902,11 @@ TimeSeriesDatabase<TPixel>
   os << indent << "OutputRegion: " << m_OutputRegion;
   os << indent << "OutputOrigin: " << m_OutputOrigin << "\n";
   os << indent << "OutputDirection: " << m_OutputDirection << "\n";
+  os << indent << "ReadAheadVolumes: " << m_ReadAheadVolumes << "\n";
   if ( this->IsOpen() ) {
     os << indent << "Database is open." << "\n";
     os << indent << "Blocks per file: " << this->m_BlocksPerFile << "\n";
+    os << indent << "Compressed: " << ( this->m_Compressed ? "true" : "false" ) << "\n";
     os << indent << "File names: " << "\n";
     for ( ::size_t idx = 0; idx < this->m_DatabaseFileNames.size(); idx++ )
       {
@@ -0,0 +1,134 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   vtkITK
+
+==========================================================================*/
+
+#include "itkTimeSeriesDatabaseHelper.h"
+
+// ITK includes
+#include <itksys/Encoding.hxx>
+
+// STD includes
+#include <algorithm>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace itk {
+  namespace TimeSeriesDatabaseHelper {
+
+//----------------------------------------------------------------------------
+MappedFile::MappedFile()
+  : m_Address(nullptr)
+  , m_Length(0)
+{
+}
+
+//----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+  this->Unmap();
+}
+
+//----------------------------------------------------------------------------
+bool MappedFile::Map(const std::string& fileName)
+{
+  this->Unmap();
+#ifdef _WIN32
+  HANDLE file = CreateFileW(itksys::Encoding::ToWide(fileName).c_str(), GENERIC_READ,
+    FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    {
+    return false;
+    }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0
+    || static_cast<unsigned long long>(fileSize.QuadPart) > static_cast<size_t>(-1))
+    {
+    CloseHandle(file);
+    return false;
+    }
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping)
+    {
+    return false;
+    }
+  m_Address = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  CloseHandle(mapping);
+  m_Length = (m_Address ? static_cast<size_t>(fileSize.QuadPart) : 0);
+#else
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    {
+    return false;
+    }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0
+    || static_cast<unsigned long long>(fileStat.st_size) > static_cast<size_t>(-1))
+    {
+    close(fd);
+    return false;
+    }
+  size_t length = static_cast<size_t>(fileStat.st_size);
+  void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address != MAP_FAILED)
+    {
+    m_Address = static_cast<char*>(address);
+    m_Length = length;
+    }
+#endif
+  return m_Address != nullptr;
+}
+
+//----------------------------------------------------------------------------
+void MappedFile::Unmap()
+{
+  if (!m_Address)
+    {
+    return;
+    }
+#ifdef _WIN32
+  UnmapViewOfFile(m_Address);
+#else
+  munmap(m_Address, m_Length);
+#endif
+  m_Address = nullptr;
+  m_Length = 0;
+}
+
+//----------------------------------------------------------------------------
+void MappedFile::WillNeed(size_t offset, size_t length) const
+{
+  if (!m_Address || offset >= m_Length)
+    {
+    return;
+    }
+  length = std::min(length, m_Length - offset);
+#ifdef _WIN32
+  // Pages are read on first access, there is no portable asynchronous
+  // read-ahead before Windows 8 (PrefetchVirtualMemory).
+  (void)length;
+#else
+  // madvise requires a page-aligned address
+  static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t alignedOffset = offset - offset % pageSize;
+  madvise(m_Address + alignedOffset, length + (offset - alignedOffset), MADV_WILLNEED);
+#endif
+}
+
+  } // end namespace TimeSeriesDatabaseHelper
+} // end namespace itk
@@ -1,5 +1,7 @@
 #ifndef itkTimeSeriesDatabaseHelper_h
 #define itkTimeSeriesDatabaseHelper_h
+#include "vtkITK.h"
+#include <cstddef>
 #include <list>
 #include <iostream>
 #include <map>
@@ -68,6 +70,37 @@ namespace itk {
         }
       };
 
+    /// Read-only memory mapping of a whole file.
+    ///
+    /// Pages are loaded on demand by the operating system, so files larger
+    /// than main memory can be mapped, and the mapped data can be read
+    /// concurrently from multiple threads without locking.
+    class VTK_ITK_EXPORT MappedFile
+      {
+      public:
+        MappedFile();
+        ~MappedFile();
+
+        /// Map the file. Returns false if the file cannot be opened or mapped
+        /// (e.g. not enough address space).
+        bool Map(const std::string& fileName);
+        void Unmap();
+
+        const char* GetData() const { return m_Address; }
+        size_t GetLength() const { return m_Length; }
+
+        /// Hint that the range will be read soon, so that the operating
+        /// system starts loading it in the background.
+        void WillNeed(size_t offset, size_t length) const;
+
+      private:
+        MappedFile(const MappedFile&) = delete;
+        void operator=(const MappedFile&) = delete;
+
+        char*  m_Address;
+        size_t m_Length;
+      };
+
     /// LRU Cache
 
     using namespace std;
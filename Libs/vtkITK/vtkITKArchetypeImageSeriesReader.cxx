@@ -35,10 +35,17 @@
 #include <itkMetaDataObjectBase.h>
 #include <itkMetaDataObject.h>
 #include <itkMetaImageIO.h>
+#include <itkMultiThreaderBase.h>
 #include <itkTimeProbe.h>
+#include <itksys/FStream.hxx>
+#include <itksys/SystemTools.hxx>
 
 // STD includes
 #include <algorithm>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
 #include <vector>
 
 #include "itkArchetypeSeriesFileNames.h"
@@ -48,6 +55,11 @@
 #include "itkDCMTKImageIO.h"
 #include "itkGDCMSeriesFileNames.h"
 #include "itkGDCMImageIO.h"
+
+// GDCM includes
+#include "gdcmReader.h"
+#include "gdcmStringFilter.h"
+#include "gdcmTag.h"
 #endif
 
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesReader);
@@ -91,6 +103,9 @@ vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
   this->ImageOrientationPatient.resize( 0 );
 
   this->AnalyzeHeader = true;
+  this->UseHeaderIndexFile = false;
+  this->HeaderIndexDirectory = nullptr;
+  this->NumberOfHeaderAnalysisThreads = 0;
 
   this->GroupingByTags = false;
   this->IsOnlyFile = false;
@@ -116,6 +131,7 @@ vtkITKArchetypeImageSeriesReader::~vtkITKArchetypeImageSeriesReader()
     delete [] this->Archetype;
     this->Archetype = nullptr;
     }
+  this->SetHeaderIndexDirectory(nullptr);
  if (RasToIjkMatrix)
    {
    RasToIjkMatrix->Delete();
@@ -157,6 +173,12 @@ void vtkITKArchetypeImageSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
      << this->FileNameSliceSpacing << "\n";
   os << indent << "FileNameSliceCount: "
      << this->FileNameSliceCount << "\n";
+  os << indent << "UseHeaderIndexFile: "
+     << (this->UseHeaderIndexFile ? "true" : "false") << "\n";
+  os << indent << "HeaderIndexDirectory: "
+     << (this->HeaderIndexDirectory ? this->HeaderIndexDirectory : "(none)") << "\n";
+  os << indent << "NumberOfHeaderAnalysisThreads: "
+     << this->NumberOfHeaderAnalysisThreads << "\n";
 
   os << indent << "OutputScalarType: "
      << vtkImageScalarTypeNameMacro(this->OutputScalarType)
@@ -1114,6 +1136,194 @@ void vtkITKArchetypeImageSeriesReader::GroupFiles ( int idxSeriesInstanceUID,
   return;
 }
 
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+namespace
+{
+
+/// DICOM tags used for grouping files, see AnalyzeDicomHeaders()
+enum DICOMGroupingTagIndex
+{
+  SeriesInstanceUIDTag = 0,
+  ContentTimeTag,
+  TriggerTimeTag,
+  EchoNumbersTag,
+  DiffusionGradientOrientationTag,
+  SliceLocationTag,
+  ImageOrientationPatientTag,
+  ImagePositionPatientTag,
+  NumberOfGroupingTags
+};
+
+const char* const DICOMGroupingTagKeys[NumberOfGroupingTags] =
+{
+  "0020|000e", "0008|0033", "0018|1060", "0018|0086", "0010|9089", "0020|1041", "0020|0037", "0020|0032"
+};
+
+const char DICOMHeaderIndexSignature[] = "# vtkITKArchetypeImageSeriesReader DICOM header index v1";
+
+/// Grouping tag values of a file, valid as long as the file size and
+/// modification time are unchanged
+struct DICOMHeaderIndexEntry
+{
+  unsigned long FileSize{0};
+  long ModifiedTime{0};
+  std::vector<std::string> TagValues{std::vector<std::string>(NumberOfGroupingTags)};
+};
+
+/// Index entries by file name (relative to the index file directory) or full path
+typedef std::map<std::string, DICOMHeaderIndexEntry> DICOMHeaderIndex;
+
+//----------------------------------------------------------------------------
+std::string RemoveSpaces(std::string value)
+{
+  value.erase(std::remove_if(value.begin(), value.end(),
+    [](char c) { return c == '\0' || isspace(static_cast<unsigned char>(c)); }), value.end());
+  return value;
+}
+
+//----------------------------------------------------------------------------
+bool ReadDICOMGroupingTagValues(const std::string& fileName, std::vector<std::string>& tagValues)
+{
+  static const std::set<gdcm::Tag> groupingTags = []()
+    {
+    std::set<gdcm::Tag> tags;
+    for (int k = 0; k < NumberOfGroupingTags; ++k)
+      {
+      gdcm::Tag tag;
+      tag.ReadFromPipeSeparatedString(DICOMGroupingTagKeys[k]);
+      tags.insert(tag);
+      }
+    return tags;
+    }();
+
+  // Parsing stops after the last grouping tag, the rest of the header and the
+  // pixel data are not read.
+  gdcm::Reader reader;
+  reader.SetFileName(fileName.c_str());
+  if (!reader.ReadSelectedTags(groupingTags))
+    {
+    return false;
+    }
+  gdcm::StringFilter stringFilter;
+  stringFilter.SetFile(reader.GetFile());
+  const gdcm::DataSet& dataSet = reader.GetFile().GetDataSet();
+  for (int k = 0; k < NumberOfGroupingTags; ++k)
+    {
+    gdcm::Tag tag;
+    tag.ReadFromPipeSeparatedString(DICOMGroupingTagKeys[k]);
+    if (dataSet.FindDataElement(tag) && !dataSet.GetDataElement(tag).IsEmpty())
+      {
+      tagValues[k] = RemoveSpaces(stringFilter.ToString(tag));
+      }
+    else
+      {
+      tagValues[k].clear();
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool ReadDICOMHeaderIndex(const std::string& fileName, DICOMHeaderIndex& index)
+{
+  itksys::ifstream file(fileName.c_str());
+  if (!file)
+    {
+    return false;
+    }
+  std::string line;
+  if (!std::getline(file, line) || line != DICOMHeaderIndexSignature)
+    {
+    return false;
+    }
+  // Each line contains tab-separated key, file size, modification time, and tag values
+  while (std::getline(file, line))
+    {
+    std::vector<std::string> fields;
+    std::string::size_type fieldStart = 0;
+    for (std::string::size_type separator = line.find('\t'); separator != std::string::npos;
+      separator = line.find('\t', fieldStart))
+      {
+      fields.push_back(line.substr(fieldStart, separator - fieldStart));
+      fieldStart = separator + 1;
+      }
+    fields.push_back(line.substr(fieldStart));
+    if (fields.size() != 3 + NumberOfGroupingTags || fields[0].empty())
+      {
+      continue;
+      }
+    DICOMHeaderIndexEntry& entry = index[fields[0]];
+    entry.FileSize = strtoul(fields[1].c_str(), nullptr, 10);
+    entry.ModifiedTime = strtol(fields[2].c_str(), nullptr, 10);
+    std::copy(fields.begin() + 3, fields.end(), entry.TagValues.begin());
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool WriteDICOMHeaderIndex(const std::string& fileName, const DICOMHeaderIndex& index)
+{
+  // Write to a temporary file first so that concurrent readers never see a partial index
+  std::string tempFileName = fileName + ".tmp";
+  {
+  itksys::ofstream file(tempFileName.c_str());
+  if (!file)
+    {
+    return false;
+    }
+  file << DICOMHeaderIndexSignature << "\n";
+  for (DICOMHeaderIndex::const_iterator indexIt = index.begin(); indexIt != index.end(); ++indexIt)
+    {
+    if (indexIt->first.find_first_of("\t\n\r") != std::string::npos)
+      {
+      continue;
+      }
+    file << indexIt->first << "\t" << indexIt->second.FileSize << "\t" << indexIt->second.ModifiedTime;
+    for (const std::string& tagValue : indexIt->second.TagValues)
+      {
+      file << "\t" << tagValue;
+      }
+    file << "\n";
+    }
+  if (!file.good())
+    {
+    file.close();
+    itksys::SystemTools::RemoveFile(tempFileName);
+    return false;
+    }
+  }
+  if (!itksys::SystemTools::RenameFile(tempFileName, fileName))
+    {
+    itksys::SystemTools::RemoveFile(tempFileName);
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+#endif
+
+//----------------------------------------------------------------------------
+std::string vtkITKArchetypeImageSeriesReader::GetHeaderIndexFilePath(const std::string& dicomDirectory)
+{
+  if (!this->HeaderIndexDirectory || strlen(this->HeaderIndexDirectory) == 0)
+    {
+    return std::string();
+    }
+  // 64-bit FNV-1a hash of the directory path
+  unsigned long long hash = 14695981039346656037ULL;
+  for (const char c : dicomDirectory)
+    {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+    }
+  std::ostringstream fileName;
+  fileName << this->HeaderIndexDirectory << "/DICOMHeaderIndex-"
+    << std::hex << std::setw(16) << std::setfill('0') << hash << ".txt";
+  return fileName.str();
+}
+
+//----------------------------------------------------------------------------
 std::string vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(const itk::MetaDataDictionary &dict, const std::string& tag)
 {
   std::string tagValue;
@@ -1229,20 +1439,133 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
   // if Archetype is a Dicom File
-  gdcmIO->SetFileName( this->Archetype );
+
+  // Get the values of the grouping tags of each file, either from the header
+  // index file or from the file headers. Headers are read concurrently, the
+  // values are then inserted in file order so that the resulting indices do not
+  // depend on the number of threads.
+  std::string indexDirectory = itksys::SystemTools::GetFilenamePath(
+    itksys::SystemTools::CollapseFullPath(this->Archetype));
+  std::string indexFileName;
+  if (this->UseHeaderIndexFile)
+    {
+    indexFileName = this->GetHeaderIndexFilePath(indexDirectory);
+    }
+  bool useHeaderIndex = !indexFileName.empty();
+  DICOMHeaderIndex headerIndex;
+  if (useHeaderIndex)
+    {
+    ReadDICOMHeaderIndex(indexFileName, headerIndex);
+    }
+
+  std::vector<DICOMHeaderIndexEntry> fileEntries(nFiles);
+  std::vector<std::string> fileKeys(nFiles);
+  std::vector<char> fileParsed(nFiles, 0);
+  auto analyzeFile = [&](itk::SizeValueType f)
+    {
+    std::string filePath = itksys::SystemTools::CollapseFullPath(this->AllFileNames[f]);
+    if (itksys::SystemTools::GetFilenamePath(filePath) == indexDirectory)
+      {
+      fileKeys[f] = itksys::SystemTools::GetFilenameName(filePath);
+      }
+    else
+      {
+      fileKeys[f] = filePath;
+      }
+    DICOMHeaderIndexEntry& entry = fileEntries[f];
+    entry.FileSize = itksys::SystemTools::FileLength(filePath);
+    entry.ModifiedTime = itksys::SystemTools::ModifiedTime(filePath);
+    DICOMHeaderIndex::const_iterator indexIt = headerIndex.find(fileKeys[f]);
+    if (indexIt != headerIndex.end()
+      && indexIt->second.FileSize == entry.FileSize
+      && indexIt->second.ModifiedTime == entry.ModifiedTime)
+      {
+      entry.TagValues = indexIt->second.TagValues;
+      return;
+      }
+    if (ReadDICOMGroupingTagValues(filePath, entry.TagValues))
+      {
+      fileParsed[f] = 1;
+      return;
+      }
+    // GDCM could not read the selected tags only (e.g. deflated transfer syntax),
+    // read the full header instead.
+    itk::GDCMImageIO::Pointer fileIO = itk::GDCMImageIO::New();
+    fileIO->SetFileName(filePath);
+    try
+      {
+      fileIO->ReadImageInformation();
+      }
+    catch (itk::ExceptionObject&)
+      {
+      // the file is ignored, it is not stored in the index so that it is read again next time
+      return;
+      }
+    const itk::MetaDataDictionary& dict = fileIO->GetMetaDataDictionary();
+    for (int k = 0; k < NumberOfGroupingTags; ++k)
+      {
+      std::string tagValue;
+      itk::ExposeMetaData<std::string>(dict, DICOMGroupingTagKeys[k], tagValue);
+      entry.TagValues[k] = RemoveSpaces(tagValue);
+      }
+    fileParsed[f] = 1;
+    };
+
+  itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+  if (this->NumberOfHeaderAnalysisThreads > 0)
+    {
+    threader->SetMaximumNumberOfThreads(this->NumberOfHeaderAnalysisThreads);
+    threader->SetNumberOfWorkUnits(this->NumberOfHeaderAnalysisThreads);
+    }
+  threader->ParallelizeArray(0, nFiles, analyzeFile, nullptr);
+
+  if (useHeaderIndex)
+    {
+    bool headerIndexModified = false;
+    for (int f = 0; f < nFiles; f++)
+      {
+      if (fileParsed[f])
+        {
+        headerIndex[fileKeys[f]] = fileEntries[f];
+        headerIndexModified = true;
+        }
+      }
+    if (headerIndexModified)
+      {
+      // Remove the entries of files that were deleted
+      std::set<std::string> currentKeys(fileKeys.begin(), fileKeys.end());
+      for (DICOMHeaderIndex::iterator indexIt = headerIndex.begin(); indexIt != headerIndex.end(); )
+        {
+        std::string filePath = itksys::SystemTools::FileIsFullPath(indexIt->first) ?
+          indexIt->first : indexDirectory + "/" + indexIt->first;
+        if (currentKeys.find(indexIt->first) == currentKeys.end()
+          && !itksys::SystemTools::FileExists(filePath, true))
+          {
+          indexIt = headerIndex.erase(indexIt);
+          }
+        else
+          {
+          ++indexIt;
+          }
+        }
+      itksys::SystemTools::MakeDirectory(this->HeaderIndexDirectory);
+      if (!WriteDICOMHeaderIndex(indexFileName, headerIndex))
+        {
+        vtkDebugMacro("AnalyzeDicomHeaders: failed to write header index file " << indexFileName);
+        }
+      }
+    }
+
   for (int f = 0; f < nFiles; f++)
   {
-    gdcmIO->SetFileName( this->AllFileNames[f] );
-    gdcmIO->ReadImageInformation();
-    itk::MetaDataDictionary &dict = gdcmIO->GetMetaDataDictionary();
+    const std::vector<std::string>& tagValues = fileEntries[f].TagValues;
     std::string tagValue;
 
-    // Use vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces to remove extra spaces
-    // from the DICOM tag, because extra spaces were found in some DICOM file before/after the
-    // multi-value separator backslashes.
+    // Extra spaces are removed from the tag values (see RemoveSpaces()), because extra
+    // spaces were found in some DICOM file before/after the multi-value separator backslashes.
 
     // series instance UID
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|000e");
+    tagValue = tagValues[SeriesInstanceUIDTag];
     if (!tagValue.empty())
     {
       int idx = InsertSeriesInstanceUIDs( tagValue.c_str() );
@@ -1254,7 +1577,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // content time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0008|0033");
+    tagValue = tagValues[ContentTimeTag];
     if (!tagValue.empty())
     {
       int idx = InsertContentTime( tagValue.c_str() );
@@ -1266,7 +1589,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // trigger time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|1060");
+    tagValue = tagValues[TriggerTimeTag];
     if (!tagValue.empty())
     {
       int idx = InsertTriggerTime( tagValue.c_str() );
@@ -1278,7 +1601,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // echo numbers
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|0086");
+    tagValue = tagValues[EchoNumbersTag];
     if (!tagValue.empty())
     {
       int idx = InsertEchoNumbers( tagValue.c_str() );
@@ -1290,7 +1613,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // diffision gradient orientation
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0010|9089");
+    tagValue = tagValues[DiffusionGradientOrientationTag];
     if (!tagValue.empty())
     {
       float a[3] = { -1 };
@@ -1304,7 +1627,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // slice location
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|1041");
+    tagValue = tagValues[SliceLocationTag];
     if (!tagValue.empty())
     {
       float a = -1;
@@ -1318,7 +1641,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
     // image orientation patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0037");
+    tagValue = tagValues[ImageOrientationPatientTag];
     if (!tagValue.empty())
     {
       float a[6] = { -1 };
@@ -1331,7 +1654,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       this->IndexImageOrientationPatient[f] = -1;
     }
     // image position patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0032");
+    tagValue = tagValues[ImagePositionPatientTag];
     if (!tagValue.empty())
     {
       float a[3] = { -1 };
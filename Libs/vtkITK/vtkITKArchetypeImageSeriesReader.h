@@ -246,6 +246,36 @@ public:
   vtkSetMacro(AnalyzeHeader, bool);
   vtkGetMacro(AnalyzeHeader, bool);
 
+  ///
+  /// Whether to store the analyzed DICOM header values in an index file
+  /// in HeaderIndexDirectory (see GetHeaderIndexFilePath()) and reuse them
+  /// when the series is loaded again. Each file is identified by its path,
+  /// size and modification time; modified files are parsed again.
+  /// The index is not used if HeaderIndexDirectory is not set.
+  /// Default is off.
+  vtkSetMacro(UseHeaderIndexFile, bool);
+  vtkGetMacro(UseHeaderIndexFile, bool);
+  vtkBooleanMacro(UseHeaderIndexFile, bool);
+
+  ///
+  /// Directory where the DICOM header index files are stored, typically a
+  /// subdirectory of the application cache directory. Nothing is written
+  /// in the directories of the DICOM files.
+  vtkSetStringMacro(HeaderIndexDirectory);
+  vtkGetStringMacro(HeaderIndexDirectory);
+
+  ///
+  /// Path of the header index file of the DICOM files in \a dicomDirectory.
+  /// There is one index file per directory, named after a hash of the
+  /// directory path. Empty if HeaderIndexDirectory is not set.
+  std::string GetHeaderIndexFilePath(const std::string& dicomDirectory);
+
+  ///
+  /// Number of threads used for reading DICOM headers.
+  /// 0 (default) means ITK global default number of threads.
+  vtkSetClampMacro(NumberOfHeaderAnalysisThreads, int, 0, 256);
+  vtkGetMacro(NumberOfHeaderAnalysisThreads, int);
+
   ///
   /// Whether to use orientation from file
   vtkSetMacro(UseOrientationFromFile, int);
@@ -872,6 +902,9 @@ protected:
 
   std::vector<std::string> AllFileNames;
   bool AnalyzeHeader;
+  bool UseHeaderIndexFile;
+  char* HeaderIndexDirectory;
+  int NumberOfHeaderAnalysisThreads;
   bool IsOnlyFile;
   bool ArchetypeIsDICOM;
 
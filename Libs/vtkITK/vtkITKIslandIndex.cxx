@@ -0,0 +1,515 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#include "vtkITKIslandIndex.h"
+
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+vtkStandardNewMacro(vtkITKIslandIndex);
+
+namespace
+{
+
+/// Consecutive foreground voxels of an image row, I indices inclusive
+struct IslandRun
+{
+  int Begin;
+  int End;
+};
+
+typedef std::vector<IslandRun> IslandRunRow;
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkITKIslandIndexEncodeRow(const T* rowPtr, int firstIndex, int numberOfVoxels, IslandRunRow& runs)
+{
+  runs.clear();
+  int i = 0;
+  while (i < numberOfVoxels)
+    {
+    if (rowPtr[i] == 0)
+      {
+      ++i;
+      continue;
+      }
+    IslandRun run;
+    run.Begin = firstIndex + i;
+    while (i < numberOfVoxels && rowPtr[i] != 0)
+      {
+      ++i;
+      }
+    run.End = firstIndex + i - 1;
+    runs.push_back(run);
+    }
+}
+
+}
+
+//----------------------------------------------------------------------------
+class vtkITKIslandIndex::vtkInternal
+{
+public:
+  /// Re-scan rows of the image in the J and K range (inclusive)
+  void EncodeRows(vtkImageData* image, int jMin, int jMax, int kMin, int kMax);
+
+  /// Connect runs of neighbor rows and compute island sizes
+  void Link(bool fullyConnected);
+
+  /// Set voxels to zero in the image and remove runs from the index
+  /// for all islands that the predicate (called with root run index) selects.
+  /// Returns number of removed islands.
+  int RemoveIslands(vtkImageData* image, const std::function<bool(vtkIdType)>& removeIsland, bool fullyConnected);
+
+  vtkIdType Find(vtkIdType runIndex);
+  void Union(vtkIdType runIndexA, vtkIdType runIndexB);
+  void LinkRows(int rowIndexA, int rowIndexB, int tolerance);
+
+  /// Index of the run containing the voxel, -1 if not found
+  vtkIdType FindRun(int i, int j, int k);
+
+  int RowIndex(int j, int k)
+    {
+    return (k - this->Extent[4]) * (this->Extent[3] - this->Extent[2] + 1) + (j - this->Extent[2]);
+    }
+
+  bool MatchesExtent(vtkImageData* image)
+    {
+    int* extent = image->GetExtent();
+    return std::equal(extent, extent + 6, this->Extent);
+    }
+
+  bool Valid{false};
+  int Extent[6] = { 0, -1, 0, -1, 0, -1 };
+  std::vector<IslandRunRow> Rows;
+
+  /// Index of the first run of each row in the union-find arrays
+  std::vector<vtkIdType> RowRunOffsets;
+  std::vector<vtkIdType> Parent;
+  /// Number of voxels of the island, valid for root runs only
+  std::vector<vtkIdType> IslandSize;
+  /// Root run of each island, sorted by decreasing island size
+  std::vector<vtkIdType> IslandRoots;
+};
+
+//----------------------------------------------------------------------------
+void vtkITKIslandIndex::vtkInternal::EncodeRows(vtkImageData* image, int jMin, int jMax, int kMin, int kMax)
+{
+  int numberOfVoxels = this->Extent[1] - this->Extent[0] + 1;
+  for (int k = kMin; k <= kMax; ++k)
+    {
+    for (int j = jMin; j <= jMax; ++j)
+      {
+      void* rowPtr = image->GetScalarPointer(this->Extent[0], j, k);
+      IslandRunRow& runs = this->Rows[this->RowIndex(j, k)];
+      switch (image->GetScalarType())
+        {
+        vtkTemplateMacro(vtkITKIslandIndexEncodeRow(static_cast<VTK_TT*>(rowPtr), this->Extent[0], numberOfVoxels, runs));
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkITKIslandIndex::vtkInternal::Find(vtkIdType runIndex)
+{
+  vtkIdType root = runIndex;
+  while (this->Parent[root] != root)
+    {
+    root = this->Parent[root];
+    }
+  // Path compression
+  while (this->Parent[runIndex] != root)
+    {
+    vtkIdType next = this->Parent[runIndex];
+    this->Parent[runIndex] = root;
+    runIndex = next;
+    }
+  return root;
+}
+
+//----------------------------------------------------------------------------
+void vtkITKIslandIndex::vtkInternal::Union(vtkIdType runIndexA, vtkIdType runIndexB)
+{
+  vtkIdType rootA = this->Find(runIndexA);
+  vtkIdType rootB = this->Find(runIndexB);
+  if (rootA == rootB)
+    {
+    return;
+    }
+  // Keep the smaller index as root so that roots are deterministic
+  if (rootA < rootB)
+    {
+    this->Parent[rootB] = rootA;
+    }
+  else
+    {
+    this->Parent[rootA] = rootB;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkITKIslandIndex::vtkInternal::LinkRows(int rowIndexA, int rowIndexB, int tolerance)
+{
+  const IslandRunRow& runsA = this->Rows[rowIndexA];
+  const IslandRunRow& runsB = this->Rows[rowIndexB];
+  size_t a = 0;
+  size_t b = 0;
+  while (a < runsA.size() && b < runsB.size())
+    {
+    if (runsA[a].End + tolerance < runsB[b].Begin)
+      {
+      ++a;
+      continue;
+      }
+    if (runsB[b].End + tolerance < runsA[a].Begin)
+      {
+      ++b;
+      continue;
+      }
+    this->Union(this->RowRunOffsets[rowIndexA] + a, this->RowRunOffsets[rowIndexB] + b);
+    if (runsA[a].End < runsB[b].End)
+      {
+      ++a;
+      }
+    else
+      {
+      ++b;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkITKIslandIndex::vtkInternal::Link(bool fullyConnected)
+{
+  vtkIdType numberOfRuns = 0;
+  this->RowRunOffsets.resize(this->Rows.size());
+  for (size_t rowIndex = 0; rowIndex < this->Rows.size(); ++rowIndex)
+    {
+    this->RowRunOffsets[rowIndex] = numberOfRuns;
+    numberOfRuns += static_cast<vtkIdType>(this->Rows[rowIndex].size());
+    }
+  this->Parent.resize(numberOfRuns);
+  for (vtkIdType runIndex = 0; runIndex < numberOfRuns; ++runIndex)
+    {
+    this->Parent[runIndex] = runIndex;
+    }
+
+  // Only previous rows are linked to avoid processing each neighbor pair twice
+  int tolerance = fullyConnected ? 1 : 0;
+  for (int k = this->Extent[4]; k <= this->Extent[5]; ++k)
+    {
+    for (int j = this->Extent[2]; j <= this->Extent[3]; ++j)
+      {
+      int rowIndex = this->RowIndex(j, k);
+      if (this->Rows[rowIndex].empty())
+        {
+        continue;
+        }
+      if (j > this->Extent[2])
+        {
+        this->LinkRows(rowIndex, this->RowIndex(j - 1, k), tolerance);
+        }
+      if (k > this->Extent[4])
+        {
+        this->LinkRows(rowIndex, this->RowIndex(j, k - 1), tolerance);
+        if (fullyConnected)
+          {
+          if (j > this->Extent[2])
+            {
+            this->LinkRows(rowIndex, this->RowIndex(j - 1, k - 1), tolerance);
+            }
+          if (j < this->Extent[3])
+            {
+            this->LinkRows(rowIndex, this->RowIndex(j + 1, k - 1), tolerance);
+            }
+          }
+        }
+      }
+    }
+
+  this->IslandSize.assign(numberOfRuns, 0);
+  for (size_t rowIndex = 0; rowIndex < this->Rows.size(); ++rowIndex)
+    {
+    const IslandRunRow& runs = this->Rows[rowIndex];
+    for (size_t runIndex = 0; runIndex < runs.size(); ++runIndex)
+      {
+      vtkIdType root = this->Find(this->RowRunOffsets[rowIndex] + runIndex);
+      this->IslandSize[root] += runs[runIndex].End - runs[runIndex].Begin + 1;
+      }
+    }
+  this->IslandRoots.clear();
+  for (vtkIdType runIndex = 0; runIndex < numberOfRuns; ++runIndex)
+    {
+    if (this->Parent[runIndex] == runIndex)
+      {
+      this->IslandRoots.push_back(runIndex);
+      }
+    }
+  std::stable_sort(this->IslandRoots.begin(), this->IslandRoots.end(),
+    [this](vtkIdType rootA, vtkIdType rootB) { return this->IslandSize[rootA] > this->IslandSize[rootB]; });
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkITKIslandIndex::vtkInternal::FindRun(int i, int j, int k)
+{
+  if (i < this->Extent[0] || i > this->Extent[1]
+    || j < this->Extent[2] || j > this->Extent[3]
+    || k < this->Extent[4] || k > this->Extent[5])
+    {
+    return -1;
+    }
+  int rowIndex = this->RowIndex(j, k);
+  const IslandRunRow& runs = this->Rows[rowIndex];
+  // First run that ends at or after i
+  IslandRunRow::const_iterator runIt = std::lower_bound(runs.begin(), runs.end(), i,
+    [](const IslandRun& run, int index) { return run.End < index; });
+  if (runIt == runs.end() || runIt->Begin > i)
+    {
+    return -1;
+    }
+  return this->RowRunOffsets[rowIndex] + (runIt - runs.begin());
+}
+
+//----------------------------------------------------------------------------
+int vtkITKIslandIndex::vtkInternal::RemoveIslands(vtkImageData* image,
+  const std::function<bool(vtkIdType)>& removeIsland, bool fullyConnected)
+{
+  int numberOfRemovedIslands = 0;
+  for (std::vector<vtkIdType>::iterator rootIt = this->IslandRoots.begin(); rootIt != this->IslandRoots.end(); ++rootIt)
+    {
+    if (removeIsland(*rootIt))
+      {
+      ++numberOfRemovedIslands;
+      }
+    }
+  if (numberOfRemovedIslands == 0)
+    {
+    return 0;
+    }
+
+  int scalarSize = image->GetScalarSize();
+  for (int k = this->Extent[4]; k <= this->Extent[5]; ++k)
+    {
+    for (int j = this->Extent[2]; j <= this->Extent[3]; ++j)
+      {
+      int rowIndex = this->RowIndex(j, k);
+      IslandRunRow& runs = this->Rows[rowIndex];
+      IslandRunRow keptRuns;
+      for (size_t runIndex = 0; runIndex < runs.size(); ++runIndex)
+        {
+        const IslandRun& run = runs[runIndex];
+        if (!removeIsland(this->Find(this->RowRunOffsets[rowIndex] + runIndex)))
+          {
+          keptRuns.push_back(run);
+          continue;
+          }
+        // Zero bit pattern is 0 value for all scalar types
+        memset(image->GetScalarPointer(run.Begin, j, k), 0, scalarSize * (run.End - run.Begin + 1));
+        }
+      if (keptRuns.size() != runs.size())
+        {
+        runs.swap(keptRuns);
+        }
+      }
+    }
+  image->GetPointData()->GetScalars()->Modified();
+  this->Link(fullyConnected);
+  return numberOfRemovedIslands;
+}
+
+//----------------------------------------------------------------------------
+vtkITKIslandIndex::vtkITKIslandIndex()
+{
+  this->FullyConnected = 0;
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkITKIslandIndex::~vtkITKIslandIndex()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkITKIslandIndex::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "FullyConnected: " << this->FullyConnected << std::endl;
+  os << indent << "NumberOfIslands: " << this->Internal->IslandRoots.size() << std::endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkITKIslandIndex::Reset()
+{
+  delete this->Internal;
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKIslandIndex::Build(vtkImageData* image)
+{
+  this->Reset();
+  if (!image || !image->GetPointData() || !image->GetPointData()->GetScalars())
+    {
+    vtkErrorMacro("Build: Invalid input image");
+    return false;
+    }
+  if (image->GetNumberOfScalarComponents() != 1)
+    {
+    vtkErrorMacro("Build: Only single component images are supported");
+    return false;
+    }
+  image->GetExtent(this->Internal->Extent);
+  int* extent = this->Internal->Extent;
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+    {
+    // Empty image, valid but contains no islands
+    this->Internal->Valid = true;
+    return true;
+    }
+  this->Internal->Rows.resize(static_cast<size_t>(extent[3] - extent[2] + 1) * (extent[5] - extent[4] + 1));
+  this->Internal->EncodeRows(image, extent[2], extent[3], extent[4], extent[5]);
+  this->Internal->Link(this->FullyConnected != 0);
+  this->Internal->Valid = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKIslandIndex::UpdateExtent(vtkImageData* image, const int modifiedExtent[6])
+{
+  if (!image || !modifiedExtent)
+    {
+    vtkErrorMacro("UpdateExtent: Invalid input");
+    return false;
+    }
+  if (!this->Internal->Valid || !this->Internal->MatchesExtent(image))
+    {
+    // Geometry changed, the whole index has to be rebuilt
+    return this->Build(image);
+    }
+  int* extent = this->Internal->Extent;
+  int jMin = std::max(modifiedExtent[2], extent[2]);
+  int jMax = std::min(modifiedExtent[3], extent[3]);
+  int kMin = std::max(modifiedExtent[4], extent[4]);
+  int kMax = std::min(modifiedExtent[5], extent[5]);
+  if (modifiedExtent[0] > extent[1] || modifiedExtent[1] < extent[0] || jMin > jMax || kMin > kMax)
+    {
+    // Modified region is outside of the image
+    return true;
+    }
+  this->Internal->EncodeRows(image, jMin, jMax, kMin, kMax);
+  this->Internal->Link(this->FullyConnected != 0);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkITKIslandIndex::GetNumberOfIslands()
+{
+  return static_cast<vtkIdType>(this->Internal->IslandRoots.size());
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkITKIslandIndex::GetLargestIslandSize()
+{
+  if (this->Internal->IslandRoots.empty())
+    {
+    return 0;
+    }
+  return this->Internal->IslandSize[this->Internal->IslandRoots[0]];
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkITKIslandIndex::GetIslandSize(int i, int j, int k)
+{
+  vtkIdType runIndex = this->Internal->FindRun(i, j, k);
+  if (runIndex < 0)
+    {
+    return 0;
+    }
+  return this->Internal->IslandSize[this->Internal->Find(runIndex)];
+}
+
+//----------------------------------------------------------------------------
+void vtkITKIslandIndex::GetIslandSizes(vtkIdTypeArray* sizes)
+{
+  if (!sizes)
+    {
+    vtkErrorMacro("GetIslandSizes: Invalid output array");
+    return;
+    }
+  sizes->SetNumberOfValues(static_cast<vtkIdType>(this->Internal->IslandRoots.size()));
+  for (size_t islandIndex = 0; islandIndex < this->Internal->IslandRoots.size(); ++islandIndex)
+    {
+    sizes->SetValue(static_cast<vtkIdType>(islandIndex), this->Internal->IslandSize[this->Internal->IslandRoots[islandIndex]]);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkITKIslandIndex::RemoveSmallIslands(vtkImageData* image, vtkIdType minimumSize)
+{
+  if (!image || !this->Internal->Valid || !this->Internal->MatchesExtent(image))
+    {
+    vtkErrorMacro("RemoveSmallIslands: Invalid image, index must be built from the same image");
+    return -1;
+    }
+  vtkInternal* internal = this->Internal;
+  return this->Internal->RemoveIslands(image,
+    [internal, minimumSize](vtkIdType root) { return internal->IslandSize[root] < minimumSize; },
+    this->FullyConnected != 0);
+}
+
+//----------------------------------------------------------------------------
+int vtkITKIslandIndex::KeepLargestIsland(vtkImageData* image, vtkIdType minimumSize/*=0*/)
+{
+  if (!image || !this->Internal->Valid || !this->Internal->MatchesExtent(image))
+    {
+    vtkErrorMacro("KeepLargestIsland: Invalid image, index must be built from the same image");
+    return -1;
+    }
+  if (this->Internal->IslandRoots.empty())
+    {
+    return 0;
+    }
+  vtkInternal* internal = this->Internal;
+  vtkIdType largestRoot = this->Internal->IslandRoots[0];
+  return this->Internal->RemoveIslands(image,
+    [internal, largestRoot, minimumSize](vtkIdType root) { return root != largestRoot || internal->IslandSize[root] < minimumSize; },
+    this->FullyConnected != 0);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkITKIslandIndex::RemoveIsland(vtkImageData* image, int i, int j, int k)
+{
+  if (!image || !this->Internal->Valid || !this->Internal->MatchesExtent(image))
+    {
+    vtkErrorMacro("RemoveIsland: Invalid image, index must be built from the same image");
+    return -1;
+    }
+  vtkIdType runIndex = this->Internal->FindRun(i, j, k);
+  if (runIndex < 0)
+    {
+    return 0;
+    }
+  vtkIdType selectedRoot = this->Internal->Find(runIndex);
+  vtkIdType numberOfRemovedVoxels = this->Internal->IslandSize[selectedRoot];
+  this->Internal->RemoveIslands(image,
+    [selectedRoot](vtkIdType root) { return root == selectedRoot; },
+    this->FullyConnected != 0);
+  return numberOfRemovedVoxels;
+}
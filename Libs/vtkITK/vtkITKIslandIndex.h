@@ -0,0 +1,99 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#ifndef __vtkITKIslandIndex_h
+#define __vtkITKIslandIndex_h
+
+#include "vtkITK.h"
+#include "vtkObject.h"
+
+class vtkIdTypeArray;
+class vtkImageData;
+
+/// \brief Incrementally updatable index of connected regions (islands) in a label map.
+///
+/// Non-zero voxels of the image are foreground, all foreground voxels that touch
+/// each other belong to the same island (label values are not distinguished),
+/// similarly to vtkITKIslandMath.
+///
+/// The image is stored as runs of consecutive foreground voxels along the I axis,
+/// which are connected using union-find. After the index is built, only the rows
+/// of a modified extent have to be re-scanned (see UpdateExtent); island sizes can
+/// be queried and small islands can be removed without visiting all voxels again.
+///
+/// \sa vtkITKIslandMath
+class VTK_ITK_EXPORT vtkITKIslandIndex : public vtkObject
+{
+public:
+  static vtkITKIslandIndex *New();
+  vtkTypeMacro(vtkITKIslandIndex, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  ///
+  /// If non-zero, islands are defined by pixels that touch on edges and/or vertices.
+  /// If zero, pixels are only considered part of the same island if their faces touch.
+  /// The index must be rebuilt after this value is changed.
+  vtkGetMacro(FullyConnected, int);
+  vtkSetMacro(FullyConnected, int);
+
+  /// Scan the whole image and build the index. Only single-component images are supported.
+  /// \return True on success.
+  bool Build(vtkImageData* image);
+
+  /// Update the index after voxels within the extent were modified in the image.
+  /// The image must have the same extent as the one the index was built from.
+  /// Only the rows intersecting the modified extent are scanned.
+  /// \return True on success.
+  bool UpdateExtent(vtkImageData* image, const int modifiedExtent[6]);
+
+  /// Remove all content from the index.
+  void Reset();
+
+  /// Number of islands in the image
+  vtkIdType GetNumberOfIslands();
+
+  /// Number of voxels in the largest island. Returns 0 if there are no islands.
+  vtkIdType GetLargestIslandSize();
+
+  /// Number of voxels in the island that contains the specified voxel.
+  /// Returns 0 if the voxel is background or outside of the image.
+  vtkIdType GetIslandSize(int i, int j, int k);
+
+  /// Get size of all islands, in decreasing order.
+  void GetIslandSizes(vtkIdTypeArray* sizes);
+
+  /// Set all voxels of islands smaller than minimumSize to 0 in the image
+  /// and update the index accordingly.
+  /// \return Number of removed islands, -1 on error.
+  int RemoveSmallIslands(vtkImageData* image, vtkIdType minimumSize);
+
+  /// Set all voxels to 0 in the image that are not in the largest island.
+  /// If the largest island is smaller than minimumSize then it is removed, too.
+  /// \return Number of removed islands, -1 on error.
+  int KeepLargestIsland(vtkImageData* image, vtkIdType minimumSize = 0);
+
+  /// Set all voxels of the island containing the specified voxel to 0 in the image.
+  /// \return Number of removed voxels, -1 on error.
+  vtkIdType RemoveIsland(vtkImageData* image, int i, int j, int k);
+
+protected:
+  vtkITKIslandIndex();
+  ~vtkITKIslandIndex() override;
+
+  int FullyConnected;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkITKIslandIndex(const vtkITKIslandIndex&) = delete;
+  void operator=(const vtkITKIslandIndex&) = delete;
+};
+
+#endif
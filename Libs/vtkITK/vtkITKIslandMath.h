@@ -17,6 +17,10 @@
 /// Limitation: The filter does not work correctly with input volume that has
 /// unsigned long scalar type on Linux and MacOSX.
 ///
+/// For repeated island size queries and removal of islands on a label map
+/// that is edited incrementally, use vtkITKIslandIndex instead.
+///
+/// \sa vtkITKIslandIndex
 class VTK_ITK_EXPORT vtkITKIslandMath : public vtkSimpleImageToImageFilter
 {
  public:
@@ -13,12 +13,97 @@
 ==========================================================================*/
 #include "vtkITKTimeSeriesDatabase.h"
 
+#include <vtkDataArray.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkUnsignedLongArray.h>
 
 vtkStandardNewMacro(vtkITKTimeSeriesDatabase);
+
+//----------------------------------------------------------------------------
+bool vtkITKTimeSeriesDatabase::Connect ( const char* filename )
+{
+  try
+    {
+    this->m_Filter->Connect ( filename );
+    }
+  catch ( itk::ExceptionObject& e )
+    {
+    vtkErrorMacro ( "Connect: failed to open " << ( filename ? filename : "(null)" ) << ": " << e.GetDescription() );
+    return false;
+    }
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKTimeSeriesDatabase::GetVoxelTimeCurve ( int i, int j, int k, vtkDataArray* curve )
+{
+  if ( !curve )
+    {
+    vtkErrorMacro ( "GetVoxelTimeCurve: invalid curve array" );
+    return false;
+    }
+  SourceType::OutputImageType::IndexType index = {{ i, j, k }};
+  SourceType::ArrayType values;
+  try
+    {
+    this->m_Filter->GetVoxelTimeSeries ( index, values );
+    }
+  catch ( itk::ExceptionObject& e )
+    {
+    vtkErrorMacro ( "GetVoxelTimeCurve: " << e.GetDescription() );
+    return false;
+    }
+  curve->SetNumberOfComponents ( 1 );
+  curve->SetNumberOfTuples ( values.GetSize() );
+  for ( unsigned int volume = 0; volume < values.GetSize(); volume++ )
+    {
+    curve->SetTuple1 ( volume, values[volume] );
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKTimeSeriesDatabase::GetRegionTimeCurve ( int extent[6], vtkDataArray* curve )
+{
+  if ( !curve )
+    {
+    vtkErrorMacro ( "GetRegionTimeCurve: invalid curve array" );
+    return false;
+    }
+  if ( extent[1] < extent[0] || extent[3] < extent[2] || extent[5] < extent[4] )
+    {
+    vtkErrorMacro ( "GetRegionTimeCurve: empty extent" );
+    return false;
+    }
+  SourceType::OutputImageType::RegionType region;
+  for ( int i = 0; i < 3; i++ )
+    {
+    region.SetIndex ( i, extent[2*i] );
+    region.SetSize ( i, extent[2*i+1] - extent[2*i] + 1 );
+    }
+  itk::Array<double> values;
+  try
+    {
+    this->m_Filter->GetRegionTimeSeries ( region, values );
+    }
+  catch ( itk::ExceptionObject& e )
+    {
+    vtkErrorMacro ( "GetRegionTimeCurve: " << e.GetDescription() );
+    return false;
+    }
+  curve->SetNumberOfComponents ( 1 );
+  curve->SetNumberOfTuples ( values.GetSize() );
+  for ( unsigned int volume = 0; volume < values.GetSize(); volume++ )
+    {
+    curve->SetTuple1 ( volume, values[volume] );
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
 int vtkITKTimeSeriesDatabase::RequestInformation(
   vtkInformation * vtkNotUsed(request),
   vtkInformationVector ** vtkNotUsed(inputVector),
@@ -28,6 +28,8 @@
 #include "vtkITK.h"
 #include "vtkITKUtility.h"
 
+class vtkDataArray;
+
 /// \brief Efficiently process large datasets in small memory.
 ///
 /// TimeSeriesDatabase creates a database on disk from a series of volumes
@@ -52,10 +54,16 @@ public:
   {
     itk::TimeSeriesDatabase<OutputImagePixelType>::CreateFromFileArchetype ( TSDFilename, ArchetypeFilename );
   };
+  /// Create a TimeSeriesDatabase with zlib compressed blocks, the files are at most 1 GiB
+  static void CreateCompressedFromFileArchetype ( const char* TSDFilename, const char* ArchetypeFilename )
+  {
+    itk::TimeSeriesDatabase<OutputImagePixelType>::CreateFromFileArchetype ( TSDFilename, ArchetypeFilename, 1073741824, true );
+  };
 
   /// Connect/Disconnect to a database
-  /// void Connect ( const char* filename ) { this->m_Filter->Connect ( filename ); this->Modified(); };
-  /// void Disconnect() { this->m_Filter->Disconnect(); }
+  /// Returns false if the database cannot be opened.
+  bool Connect ( const char* filename );
+  void Disconnect() { this->m_Filter->Disconnect(); this->Modified(); };
 
   /// Get/Set the current time stamp to read
   void SetCurrentImage ( unsigned int value )
@@ -66,6 +74,20 @@ public:
   int GetNumberOfVolumes()
   { DelegateITKOutputMacro ( GetNumberOfVolumes ); };
 
+  /// Number of following volumes prefetched in the background when a volume is read
+  void SetReadAheadVolumes ( unsigned int value )
+  { DelegateITKInputMacro ( SetReadAheadVolumes, value ); };
+  unsigned int GetReadAheadVolumes()
+  { DelegateITKOutputMacro ( GetReadAheadVolumes ); };
+
+  /// Get the time curve of voxel (i,j,k): one value per volume.
+  /// Returns false if the voxel is outside of the image.
+  bool GetVoxelTimeCurve ( int i, int j, int k, vtkDataArray* curve );
+
+  /// Get the mean time curve of the voxels in extent (clipped to the image extent):
+  /// one value per volume. Returns false if the extent does not intersect the image.
+  bool GetRegionTimeCurve ( int extent[6], vtkDataArray* curve );
+
 protected:
   vtkITKTimeSeriesDatabase()
     {
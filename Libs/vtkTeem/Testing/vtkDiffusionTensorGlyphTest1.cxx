@@ -0,0 +1,148 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkDiffusionTensorGlyph.h>
+#include <vtkDiffusionTensorMathematics.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+//----------------------------------------------------------------------------
+int vtkDiffusionTensorGlyphTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // 3x3x1 tensor image: diag(3, 2, 1) * 1e-3 everywhere except in the first
+  // voxel where the tensor is null (not glyphed)
+  vtkNew<vtkImageData> tensorImage;
+  int dimensions[3] = {3, 3, 1};
+  tensorImage->SetDimensions(dimensions);
+  vtkNew<vtkFloatArray> tensors;
+  tensors->SetNumberOfComponents(9);
+  tensors->SetNumberOfTuples(9);
+  for (vtkIdType i = 0; i < 9; ++i)
+    {
+    float tensor[9] = {3e-3f, 0.f, 0.f, 0.f, 2e-3f, 0.f, 0.f, 0.f, 1e-3f};
+    if (i == 0)
+      {
+      tensor[0] = tensor[4] = tensor[8] = 0.f;
+      }
+    tensors->SetTypedTuple(i, tensor);
+    }
+  tensorImage->GetPointData()->SetTensors(tensors.GetPointer());
+
+  // Glyph: a triangle with normals
+  vtkNew<vtkPolyData> source;
+  vtkNew<vtkPoints> sourcePoints;
+  sourcePoints->InsertNextPoint(1., 0., 0.);
+  sourcePoints->InsertNextPoint(0., 1., 0.);
+  sourcePoints->InsertNextPoint(0., 0., 1.);
+  source->SetPoints(sourcePoints.GetPointer());
+  vtkNew<vtkCellArray> sourcePolys;
+  vtkIdType triangle[3] = {0, 1, 2};
+  sourcePolys->InsertNextCell(3, triangle);
+  source->SetPolys(sourcePolys.GetPointer());
+  vtkNew<vtkFloatArray> sourceNormals;
+  sourceNormals->SetNumberOfComponents(3);
+  for (int i = 0; i < 3; ++i)
+    {
+    sourceNormals->InsertNextTuple3(1., 0., 0.);
+    }
+  source->GetPointData()->SetNormals(sourceNormals.GetPointer());
+
+  vtkNew<vtkDiffusionTensorGlyph> glyph;
+  glyph->SetInputData(tensorImage.GetPointer());
+  glyph->SetSourceData(source.GetPointer());
+  glyph->SetDimensionResolution(1, 1);
+  glyph->ColorGlyphsByTrace();
+  glyph->Update();
+
+  vtkPolyData* output = glyph->GetOutput();
+  if (output->GetNumberOfPoints() != 8 * 3
+    || output->GetNumberOfPolys() != 8
+    || !output->GetPointData()->GetScalars()
+    || output->GetPointData()->GetScalars()->GetNumberOfTuples() != 8 * 3
+    || !output->GetPointData()->GetNormals())
+    {
+    std::cerr << "Line " << __LINE__ << " - Wrong output size: "
+              << output->GetNumberOfPoints() << " points, "
+              << output->GetNumberOfPolys() << " polys" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Each glyph is scaled by the square root of the eigenvalues along the
+  // eigenvectors and centered on its input point
+  output->GetPolys()->InitTraversal();
+  for (vtkIdType glyphId = 0; glyphId < 8; ++glyphId)
+    {
+    double center[3];
+    tensorImage->GetPoint(glyphId + 1, center);
+    const double expectedScale[3] = {sqrt(3e-3) * 1000., sqrt(2e-3) * 1000., sqrt(1e-3) * 1000.};
+    for (int i = 0; i < 3; ++i)
+      {
+      double point[3];
+      output->GetPoint(glyphId * 3 + i, point);
+      const double scale = sqrt(vtkMath::Distance2BetweenPoints(point, center));
+      if (fabs(scale - expectedScale[i]) > 1e-3 * expectedScale[i])
+        {
+        std::cerr << "Line " << __LINE__ << " - Wrong glyph " << glyphId << " point " << i
+                  << " scale: " << scale << " (expected " << expectedScale[i] << ")" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    const double trace = output->GetPointData()->GetScalars()->GetTuple1(glyphId * 3);
+    if (fabs(trace - 6e-3) > 1e-6)
+      {
+      std::cerr << "Line " << __LINE__ << " - Wrong scalar: " << trace << std::endl;
+      return EXIT_FAILURE;
+      }
+    vtkIdType npts;
+    vtkIdType* pts;
+    if (!output->GetPolys()->GetNextCell(npts, pts)
+      || npts != 3 || pts[0] != glyphId * 3 || pts[2] != glyphId * 3 + 2)
+      {
+      std::cerr << "Line " << __LINE__ << " - Wrong glyph " << glyphId << " topology" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Closed-form eigen solver
+  const double xx[1] = {2.}, xy[1] = {1.}, xz[1] = {0.}, yy[1] = {2.}, yz[1] = {0.}, zz[1] = {5.};
+  const double* const components[6] = {xx, xy, xz, yy, yz, zz};
+  double w0[1], w1[1], w2[1];
+  double* const eigenvalues[3] = {w0, w1, w2};
+  double v[9][1];
+  double* const eigenvectors[9] = {v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8]};
+  vtkDiffusionTensorMathematics::SymmetricEigenSolverBatch(1, components, eigenvalues, eigenvectors);
+  if (fabs(w0[0] - 5.) > 1e-12 || fabs(w1[0] - 3.) > 1e-12 || fabs(w2[0] - 1.) > 1e-12
+    || fabs(fabs(v[2][0]) - 1.) > 1e-12
+    || fabs(fabs(v[3][0]) - sqrt(0.5)) > 1e-12 || fabs(v[3][0] - v[4][0]) > 1e-12)
+    {
+    std::cerr << "Line " << __LINE__ << " - Wrong eigen decomposition: "
+              << w0[0] << " " << w1[0] << " " << w2[0] << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
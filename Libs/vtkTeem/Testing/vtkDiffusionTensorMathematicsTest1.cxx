@@ -29,6 +29,9 @@
 #include <vtkPointData.h>
 #include <vtkVersion.h>
 
+// STD includes
+#include <cmath>
+
 //----------------------------------------------------------------------------
 int vtkDiffusionTensorMathematicsTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
@@ -119,5 +122,25 @@ int vtkDiffusionTensorMathematicsTest1(int vtkNotUsed(argc), char* vtkNotUsed(ar
       }
     std::cout << std::endl << std::endl;
     }
+
+  // Compute several measures in one pass
+  filter->SetMaskWithScalars(0);
+  filter->SetOperationToFractionalAnisotropy();
+  filter->AddAdditionalOperation(vtkDiffusionTensorMathematics::VTK_TENS_TRACE);
+  filter->AddAdditionalOperation(vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE);
+  filter->Update();
+  vtkDataArray* traceArray = filter->GetOutput()->GetPointData()->GetArray(
+    vtkDiffusionTensorMathematics::GetOperationAsString(vtkDiffusionTensorMathematics::VTK_TENS_TRACE));
+  vtkDataArray* maxEigenvalueArray = filter->GetOutput()->GetPointData()->GetArray("MaxEigenvalue");
+  if (!traceArray || !maxEigenvalueArray
+    || traceArray->GetNumberOfTuples() != 8
+    || traceArray->GetTuple1(0) != 3. || traceArray->GetTuple1(7) != 4.
+    || fabs(maxEigenvalueArray->GetTuple1(0) - 1.) > 1e-6
+    || fabs(maxEigenvalueArray->GetTuple1(7) - 2.) > 1e-6
+    || fabs(filter->GetOutput()->GetPointData()->GetScalars()->GetTuple1(0)) > 1e-6)
+    {
+    std::cerr << "Line " << __LINE__ << " - Additional operations failed" << std::endl;
+    return EXIT_FAILURE;
+    }
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,232 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkShortArray.h>
+#include <vtksys/FStream.hxx>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <iterator>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Voxel value is a unique function of the voxel position
+short ExpectedValue(int i, int j, int k, int component)
+{
+  return static_cast<short>(((k * 100 + j) * 100 + i) * 2 + component - 10000);
+}
+
+//----------------------------------------------------------------------------
+bool CheckImage(vtkImageData* image, const int expectedExtent[6])
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(extent);
+  for (int i = 0; i < 6; ++i)
+    {
+    if (extent[i] != expectedExtent[i])
+      {
+      std::cerr << "Extent mismatch at index " << i << ": "
+                << extent[i] << " != " << expectedExtent[i] << std::endl;
+      return false;
+      }
+    }
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfComponents() != 2)
+    {
+    std::cerr << "Invalid scalars" << std::endl;
+    return false;
+    }
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        for (int c = 0; c < 2; ++c)
+          {
+          double value = image->GetScalarComponentAsDouble(i, j, k, c);
+          if (value != ExpectedValue(i, j, k, c))
+            {
+            std::cerr << "Value mismatch at (" << i << ", " << j << ", " << k << ") component "
+                      << c << ": " << value << " != " << ExpectedValue(i, j, k, c) << std::endl;
+            return false;
+            }
+          }
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int TestReadExtents(const std::string& fileName, bool expectMemoryMapping)
+{
+  const int wholeExtent[6] = { 0, 12, 0, 9, 0, 7 };
+
+  // Whole image
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetMemoryMapping(expectMemoryMapping);
+  reader->Update();
+  if (!CheckImage(reader->GetOutput(), wholeExtent))
+    {
+    std::cerr << "Failed to read whole image from " << fileName << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (reader->GetOutputMemoryMapped() != expectMemoryMapping)
+    {
+    std::cerr << "Whole image of " << fileName << " is" << (expectMemoryMapping ? " " : " not ")
+              << "expected to be memory mapped" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Modifying the output does not modify the file
+  reader->GetOutput()->SetScalarComponentFromDouble(0, 0, 0, 0, 1.0);
+  vtkNew<vtkTeemNRRDReader> reader2;
+  reader2->SetFileName(fileName.c_str());
+  reader2->Update();
+  if (!CheckImage(reader2->GetOutput(), wholeExtent))
+    {
+    std::cerr << "File " << fileName << " was modified through the output image" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Sub-extents: arbitrary box, full slices, single row
+  const int extents[3][6] =
+    {
+    { 3, 7, 2, 8, 1, 5 },
+    { 0, 12, 0, 9, 2, 4 },
+    { 0, 12, 5, 5, 6, 6 }
+    };
+  for (int extentIndex = 0; extentIndex < 3; ++extentIndex)
+    {
+    vtkNew<vtkTeemNRRDReader> extentReader;
+    extentReader->SetFileName(fileName.c_str());
+    extentReader->UpdateInformation();
+    extentReader->UpdateExtent(const_cast<int*>(extents[extentIndex]));
+    if (!CheckImage(extentReader->GetOutput(), extents[extentIndex]))
+      {
+      std::cerr << "Failed to read extent " << extentIndex << " from " << fileName << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Whole image is read if requested extent reading is disabled
+  vtkNew<vtkTeemNRRDReader> wholeReader;
+  wholeReader->SetFileName(fileName.c_str());
+  wholeReader->ReadRequestedExtentOff();
+  wholeReader->UpdateInformation();
+  wholeReader->UpdateExtent(const_cast<int*>(extents[0]));
+  if (!CheckImage(wholeReader->GetOutput(), wholeExtent))
+    {
+    std::cerr << "Failed to read whole image with ReadRequestedExtent off from " << fileName << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDReaderTest1(int argc, char* argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = std::string(argv[1]) + "/vtkTeemNRRDReaderTest1";
+  vtksys::SystemTools::RemoveADirectory(tempDir);
+  vtksys::SystemTools::MakeDirectory(tempDir);
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(13, 10, 8);
+  vtkNew<vtkShortArray> scalars;
+  scalars->SetNumberOfComponents(2);
+  scalars->SetNumberOfTuples(13 * 10 * 8);
+  image->GetPointData()->SetScalars(scalars.GetPointer());
+  for (int k = 0; k < 8; ++k)
+    {
+    for (int j = 0; j < 10; ++j)
+      {
+      for (int i = 0; i < 13; ++i)
+        {
+        for (int c = 0; c < 2; ++c)
+          {
+          image->SetScalarComponentFromDouble(i, j, k, c, ExpectedValue(i, j, k, c));
+          }
+        }
+      }
+    }
+
+  for (int compressed = 0; compressed < 2; ++compressed)
+    {
+    std::string fileName = tempDir + (compressed ? "/compressed.nrrd" : "/raw.nrrd");
+    vtkNew<vtkTeemNRRDWriter> writer;
+    writer->SetFileName(fileName.c_str());
+    writer->SetUseCompression(compressed);
+    writer->SetInputData(image.GetPointer());
+    writer->Write();
+    if (!vtksys::SystemTools::FileExists(fileName, true))
+      {
+      std::cerr << "Failed to write " << fileName << std::endl;
+      return EXIT_FAILURE;
+      }
+    // Attached data follows a header of arbitrary length, so alignment
+    // required for memory mapping is not guaranteed.
+    if (TestReadExtents(fileName, false) != EXIT_SUCCESS)
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Detached raw data starts at the beginning of the data file,
+  // so it can always be memory mapped.
+  std::string dataFileName = tempDir + "/detached.raw";
+  {
+    std::string rawFileName = tempDir + "/raw.nrrd";
+    vtksys::ifstream rawFile(rawFileName.c_str(), std::ios::in | std::ios::binary);
+    std::string line;
+    std::string header;
+    while (std::getline(rawFile, line) && !line.empty())
+      {
+      header += line + "\n";
+      }
+    std::string data((std::istreambuf_iterator<char>(rawFile)), std::istreambuf_iterator<char>());
+    vtksys::ofstream dataFile(dataFileName.c_str(), std::ios::out | std::ios::binary);
+    dataFile.write(data.data(), data.size());
+    vtksys::ofstream headerFile((tempDir + "/detached.nhdr").c_str(), std::ios::out | std::ios::binary);
+    headerFile << header << "data file: detached.raw\n\n";
+  }
+  if (TestReadExtents(tempDir + "/detached.nhdr", true) != EXIT_SUCCESS
+    || TestReadExtents(tempDir + "/detached.nhdr", false) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
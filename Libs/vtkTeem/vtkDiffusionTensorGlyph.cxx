@@ -15,19 +15,27 @@
 
 #include "vtkCellArray.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include <vtkNew.h>
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include "vtkTransform.h"
 
 #include "vtkImageData.h"
 #include "vtkDiffusionTensorMathematics.h"
 
+#include <algorithm>
 #include <ctime>
+#include <vector>
 
 vtkCxxSetObjectMacro(vtkDiffusionTensorGlyph,Mask,vtkImageData);
 vtkCxxSetObjectMacro(vtkDiffusionTensorGlyph,VolumePositionMatrix,vtkMatrix4x4);
@@ -138,6 +146,432 @@ void vtkDiffusionTensorGlyph::ColorGlyphsBy(int invariant) {
     }
 }
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Connectivity of one type of cells (verts, lines, polys or strips) of the
+// glyph source and the output array where it is copied for each glyph.
+// Cells are stored in the vtkCellArray legacy layout: (npts, pt ids...) per cell.
+struct GlyphCellTemplate
+{
+  vtkIdType NumberOfCells = 0;
+  std::vector<vtkIdType> Cells;
+  vtkIdType* OutputCells = nullptr;
+};
+
+}
+
+//----------------------------------------------------------------------------
+// Generates the glyphs of a range of kept input points into preallocated
+// output arrays. Glyph g (kept point index * number of directions + direction)
+// owns the output points [g * numSourcePts, (g + 1) * numSourcePts) and the
+// output cells copied for it, so that threads never write to the same place.
+class vtkDiffusionTensorGlyphFunctor
+{
+public:
+  vtkDiffusionTensorGlyphFunctor(vtkDiffusionTensorGlyph* self, vtkDataSet* input,
+    vtkDataArray* inTensors, vtkDataArray* inScalars, const std::vector<vtkIdType>& keptPointIds,
+    const std::vector<double>& sourcePoints, const std::vector<double>& sourceNormals,
+    std::vector<GlyphCellTemplate>& cells, float* outPoints, float* outNormals, float* outScalars)
+    : Self(self)
+    , Input(input)
+    , InTensors(inTensors)
+    , InScalars(inScalars)
+    , KeptPointIds(keptPointIds)
+    , SourcePoints(sourcePoints)
+    , SourceNormals(sourceNormals)
+    , Cells(cells)
+    , OutPoints(outPoints)
+    , OutNormals(outNormals)
+    , OutScalars(outScalars)
+  {
+    this->NumberOfSourcePoints = static_cast<vtkIdType>(sourcePoints.size() / 3);
+    this->NumberOfDirections = (self->ThreeGlyphs ? 3 : 1) * (self->Symmetric + 1);
+    // user-specified matrix moving the output point locations
+    for (int i = 0; i < 4; ++i)
+      {
+      for (int j = 0; j < 4; ++j)
+        {
+        this->VolumePosition[i][j] = (self->VolumePositionMatrix ?
+          self->VolumePositionMatrix->GetElement(i, j) : (i == j ? 1. : 0.));
+        }
+      }
+    this->FlipNormals = (self->TensorRotationMatrix && self->TensorRotationMatrix->Determinant() < 0);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    // Tensors are diagonalized by blocks to let the eigen solver vectorize
+    const vtkIdType blockSize = 64;
+    double tensors[blockSize][3][3];
+    double components[6][blockSize];
+    double eigenvalues[3][blockSize];
+    double eigenvectors[9][blockSize];
+    const double* componentPointers[6];
+    double* eigenvaluePointers[3];
+    double* eigenvectorPointers[9];
+    for (int k = 0; k < 6; ++k)
+      {
+      componentPointers[k] = components[k];
+      }
+    for (int k = 0; k < 3; ++k)
+      {
+      eigenvaluePointers[k] = eigenvalues[k];
+      }
+    for (int k = 0; k < 9; ++k)
+      {
+      eigenvectorPointers[k] = eigenvectors[k];
+      }
+
+    for (vtkIdType blockBegin = begin; blockBegin < end; blockBegin += blockSize)
+      {
+      const vtkIdType count = std::min(blockSize, end - blockBegin);
+      for (vtkIdType k = 0; k < count; ++k)
+        {
+        this->InTensors->GetTuple(this->KeptPointIds[blockBegin + k], (double *)tensors[k]);
+        components[0][k] = tensors[k][0][0];
+        components[1][k] = tensors[k][0][1];
+        components[2][k] = tensors[k][0][2];
+        components[3][k] = tensors[k][1][1];
+        components[4][k] = tensors[k][1][2];
+        components[5][k] = tensors[k][2][2];
+        }
+      if (this->Self->ExtractEigenvalues)
+        {
+        vtkDiffusionTensorMathematics::SymmetricEigenSolverBatch(
+          count, componentPointers, eigenvaluePointers, eigenvectorPointers);
+        }
+
+      for (vtkIdType k = 0; k < count; ++k)
+        {
+        double w[3], xv[3], yv[3], zv[3];
+        if (this->Self->ExtractEigenvalues)
+          {
+          for (int i = 0; i < 3; ++i)
+            {
+            w[i] = eigenvalues[i][k];
+            xv[i] = eigenvectors[i][k];
+            yv[i] = eigenvectors[3 + i][k];
+            zv[i] = eigenvectors[6 + i][k];
+            }
+          }
+        else // use tensor columns as eigenvectors
+          {
+          for (int i = 0; i < 3; ++i)
+            {
+            xv[i] = tensors[k][0][i];
+            yv[i] = tensors[k][1][i];
+            zv[i] = tensors[k][2][i];
+            }
+          w[0] = vtkMath::Normalize(xv);
+          w[1] = vtkMath::Normalize(yv);
+          w[2] = vtkMath::Normalize(zv);
+          }
+        this->GeneratePointGlyphs(blockBegin + k, w, xv, yv, zv);
+        }
+      }
+  }
+
+protected:
+  // Output the glyphs of the kept point keptId
+  void GeneratePointGlyphs(vtkIdType keptId, double w[3], double xv[3], double yv[3], double zv[3])
+  {
+    vtkDiffusionTensorGlyph* self = this->Self;
+    const vtkIdType inPtId = this->KeptPointIds[keptId];
+    vtkIdType i;
+    double s = 0.;
+    double maxScale;
+
+    // Calculate output scalars before computing glyph scale factors from eigenvalues.
+    // First, pass through input scalars if requested.
+    if ( this->InScalars && self->ColorGlyphs && ( self->ColorMode == vtkTensorGlyph::COLOR_BY_SCALARS ) )
+      {
+      // Copy point data from source
+      s = this->InScalars->GetComponent(inPtId, 0);
+      }
+
+    // Output scalar invariants if requested
+    else if ( self->ColorGlyphs && ( self->ColorMode == vtkTensorGlyph::COLOR_BY_EIGENVALUES ) )
+      {
+      // Correct for negative eigenvalues: use logic coded in vtkDiffusionTensorMathematics
+      vtkDiffusionTensorMathematics::FixNegativeEigenvaluesMethod(w);
+
+      switch (self->ScalarInvariant)
+        {
+        case vtkDiffusionTensorMathematics::VTK_TENS_LINEAR_MEASURE:
+          s = vtkDiffusionTensorMathematics::LinearMeasure(w);
+          break;
+        case vtkDiffusionTensorMathematics::VTK_TENS_PLANAR_MEASURE:
+          s = vtkDiffusionTensorMathematics::PlanarMeasure(w);
+          break;
+        case vtkDiffusionTensorMathematics::VTK_TENS_SPHERICAL_MEASURE:
+          s = vtkDiffusionTensorMathematics::SphericalMeasure(w);
+          break;
+        case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE:
+          s = w[0];
+          break;
+        case vtkDiffusionTensorMathematics::VTK_TENS_MID_EIGENVALUE:
+          s = w[1];
+          break;
+        case vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE:
+          s = w[2];
+          break;
+        case vtkDiffusionTensorMathematics::VTK_TENS_PARALLEL_DIFFUSIVITY:
+          s = w[0];
+          break;
+        case vtkDiffusionTensorMathematics::VTK_TENS_PERPENDICULAR_DIFFUSIVITY:
+          s = 0.5*(w[1]+w[2]);
+          break;
+        case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION:
+          {
+          double v_maj[3] = { xv[0], xv[1], xv[2] };
+          if (self->TensorRotationMatrix)
+            {
+            const double v_in[4] = { v_maj[0], v_maj[1], v_maj[2], 1. };
+            double v_rot[4];
+            self->TensorRotationMatrix->MultiplyPoint(v_in, v_rot);
+            v_maj[0] = v_rot[0];
+            v_maj[1] = v_rot[1];
+            v_maj[2] = v_rot[2];
+            }
+          // TO DO: here output as RGB. Need to allocate 3-component scalars first.
+          vtkDiffusionTensorMathematics::RGBToIndex(fabs(v_maj[0]),fabs(v_maj[1]),fabs(v_maj[2]),s);
+          break;
+          }
+        case vtkDiffusionTensorMathematics::VTK_TENS_RELATIVE_ANISOTROPY:
+          s = vtkDiffusionTensorMathematics::RelativeAnisotropy(w);
+          break;
+        case vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY:
+          s = vtkDiffusionTensorMathematics::FractionalAnisotropy(w);
+          break;
+        case vtkDiffusionTensorMathematics::VTK_TENS_TRACE:
+          s = vtkDiffusionTensorMathematics::Trace(w);
+          break;
+        default:
+          s = 0;
+          break;
+        }
+      }
+
+    // Use the square root of the eigenvalues for scaling
+    // for DTI
+    w[0] = sqrt( w[0] );
+    w[1] = sqrt( w[1] );
+    w[2] = sqrt( w[2] );
+
+    // compute scale factors (this modifies eigenvalues so
+    // scalar invariants were computed already above)
+    w[0] *= self->ScaleFactor;
+    w[1] *= self->ScaleFactor;
+    w[2] *= self->ScaleFactor;
+
+    if ( self->ClampScaling )
+      {
+      for (maxScale=0.0, i=0; i<3; i++)
+        {
+        if ( maxScale < fabs(w[i]) )
+          {
+          maxScale = fabs(w[i]);
+          }
+        }
+      if ( maxScale > self->MaxScaleFactor )
+        {
+        maxScale = self->MaxScaleFactor / maxScale;
+        for (i=0; i<3; i++)
+          {
+          w[i] *= maxScale; //preserve overall shape of glyph
+          }
+        }
+      }
+
+    // make sure scale is okay (non-zero) and scale data
+    // this scale checking is from superclass code
+    for (maxScale=0.0, i=0; i<3; i++)
+      {
+      if ( w[i] > maxScale )
+        {
+        maxScale = w[i];
+        }
+      }
+    if ( maxScale == 0.0 )
+      {
+      maxScale = 1.0;
+      }
+    for (i=0; i<3; i++)
+      {
+      if ( w[i] == 0.0 )
+        {
+        w[i] = maxScale * 1.0e-06;
+        }
+      }
+
+    // translate Source to Input point, moved by the user-specified matrix if any
+    double x[3], x2[3];
+    this->Input->GetPoint(inPtId, x);
+    for (i=0; i<3; i++)
+      {
+      x2[i] = this->VolumePosition[i][0] * x[0] + this->VolumePosition[i][1] * x[1]
+        + this->VolumePosition[i][2] * x[2] + this->VolumePosition[i][3];
+      }
+
+    vtkTransform* trans = this->Transform.Local();
+    vtkMatrix4x4* matrix = this->Matrix.Local();
+    trans->PreMultiply();
+
+    // normalized eigenvectors rotate object for eigen direction 0
+    matrix->Identity();
+    matrix->Element[0][0] = xv[0];
+    matrix->Element[0][1] = yv[0];
+    matrix->Element[0][2] = zv[0];
+    matrix->Element[1][0] = xv[1];
+    matrix->Element[1][1] = yv[1];
+    matrix->Element[1][2] = zv[1];
+    matrix->Element[2][0] = xv[2];
+    matrix->Element[2][1] = yv[2];
+    matrix->Element[2][2] = zv[2];
+
+    // Now do the real work for each "direction"
+    // This is a loop over each eigenvector allowing
+    // a separate glyph for each (or two loops per eigenvector
+    // allowing two symmetric glyphs for each)
+    for (int dir=0; dir < this->NumberOfDirections; dir++)
+      {
+      const int eigen_dir = dir%(self->ThreeGlyphs?3:1);
+      const int symmetric_dir = dir/(self->ThreeGlyphs?3:1);
+      const vtkIdType glyphId = keptId * this->NumberOfDirections + dir;
+      const vtkIdType ptOffset = glyphId * this->NumberOfSourcePoints;
+
+      // Remove previous scales ...
+      trans->Identity();
+      trans->Translate(x2[0], x2[1], x2[2]);
+
+      // If we have a user-specified matrix rotating each tensor
+      if (self->TensorRotationMatrix)
+        {
+        trans->Concatenate(self->TensorRotationMatrix);
+        }
+      trans->Concatenate(matrix);
+
+      if (eigen_dir == 1)
+        {
+        trans->RotateZ(90.0);
+        }
+
+      if (eigen_dir == 2)
+        {
+        trans->RotateY(-90.0);
+        }
+
+      if (self->ThreeGlyphs)
+        {
+        trans->Scale(w[eigen_dir], self->ScaleFactor, self->ScaleFactor);
+        }
+      else
+        {
+        trans->Scale(w[0], w[1], w[2]);
+        }
+
+      // Mirror second set to the symmetric position
+      if (symmetric_dir == 1)
+        {
+        trans->Scale(-1.,1.,1.);
+        }
+
+      // if the eigenvalue is negative, shift to reverse direction.
+      // The && is there to ensure that we do not change the
+      // old behaviour of vtkTensorGlyphs (which only used one dir),
+      // in case there is an oriented glyph, e.g. an arrow.
+      if (w[eigen_dir] < 0 && this->NumberOfDirections > 1)
+        {
+        trans->Translate(-self->Length, 0., 0.);
+        }
+
+      // multiply points (and normals if available) by resulting matrix.
+      double (*e)[4] = trans->GetMatrix()->Element;
+      const double* inPt = this->SourcePoints.data();
+      float* outPt = this->OutPoints + 3 * ptOffset;
+      for (i=0; i < this->NumberOfSourcePoints; i++, inPt += 3, outPt += 3)
+        {
+        outPt[0] = static_cast<float>(e[0][0] * inPt[0] + e[0][1] * inPt[1] + e[0][2] * inPt[2] + e[0][3]);
+        outPt[1] = static_cast<float>(e[1][0] * inPt[0] + e[1][1] * inPt[1] + e[1][2] * inPt[2] + e[1][3]);
+        outPt[2] = static_cast<float>(e[2][0] * inPt[0] + e[2][1] * inPt[1] + e[2][2] * inPt[2] + e[2][3]);
+        }
+
+      if (this->OutNormals)
+        {
+        // normals are transformed by the inverse transpose of the linear part
+        double linear[3][3], inverse[3][3];
+        for (int r=0; r<3; r++)
+          {
+          linear[r][0] = e[r][0];
+          linear[r][1] = e[r][1];
+          linear[r][2] = e[r][2];
+          }
+        vtkMath::Invert3x3(linear, inverse);
+        const double sign = (this->FlipNormals ? -1. : 1.);
+        const double* inNormal = this->SourceNormals.data();
+        float* outNormal = this->OutNormals + 3 * ptOffset;
+        for (i=0; i < this->NumberOfSourcePoints; i++, inNormal += 3, outNormal += 3)
+          {
+          double normal[3];
+          for (int r=0; r<3; r++)
+            {
+            normal[r] = sign * (inverse[0][r] * inNormal[0] + inverse[1][r] * inNormal[1] + inverse[2][r] * inNormal[2]);
+            }
+          vtkMath::Normalize(normal);
+          outNormal[0] = static_cast<float>(normal[0]);
+          outNormal[1] = static_cast<float>(normal[1]);
+          outNormal[2] = static_cast<float>(normal[2]);
+          }
+        }
+
+      // Actually output the scalar invariant calculated above
+      if (this->OutScalars)
+        {
+        std::fill(this->OutScalars + ptOffset, this->OutScalars + ptOffset + this->NumberOfSourcePoints,
+                  static_cast<float>(s));
+        }
+
+      // copy topology of output glyph
+      for (GlyphCellTemplate& cells : this->Cells)
+        {
+        const vtkIdType cellsSize = static_cast<vtkIdType>(cells.Cells.size());
+        const vtkIdType* inCells = cells.Cells.data();
+        const vtkIdType* inCellsEnd = inCells + cellsSize;
+        vtkIdType* outCells = cells.OutputCells + glyphId * cellsSize;
+        while (inCells < inCellsEnd)
+          {
+          const vtkIdType npts = *(inCells++);
+          *(outCells++) = npts;
+          for (vtkIdType j=0; j < npts; j++)
+            {
+            *(outCells++) = *(inCells++) + ptOffset;
+            }
+          }
+        }
+      } // end for number of dirs
+  }
+
+  vtkDiffusionTensorGlyph* Self;
+  vtkDataSet* Input;
+  vtkDataArray* InTensors;
+  vtkDataArray* InScalars;
+  const std::vector<vtkIdType>& KeptPointIds;
+  const std::vector<double>& SourcePoints;
+  const std::vector<double>& SourceNormals;
+  std::vector<GlyphCellTemplate>& Cells;
+  float* OutPoints;
+  float* OutNormals;
+  float* OutScalars;
+  vtkIdType NumberOfSourcePoints;
+  int NumberOfDirections;
+  double VolumePosition[4][4];
+  bool FlipNormals;
+  vtkSMPThreadLocalObject<vtkTransform> Transform;
+  vtkSMPThreadLocalObject<vtkMatrix4x4> Matrix;
+};
+
 // TO DO: make input mask a point data object or scalars
 
 int vtkDiffusionTensorGlyph::RequestData(
@@ -160,37 +594,10 @@ int vtkDiffusionTensorGlyph::RequestData(
 
   vtkDataArray *inTensors;
   vtkDataArray *inScalars;
-  vtkIdType numPts, numSourcePts, numSourceCells, inPtId, i;
-  int j;
+  vtkIdType numPts, numSourcePts, inPtId, i;
   vtkPoints *sourcePts;
   vtkDataArray *sourceNormals;
-  vtkCellArray *sourceCells, *cells;
-  vtkPoints *newPts;
-  vtkFloatArray *newScalars=nullptr;
-  vtkFloatArray *newNormals=nullptr;
-  double x[3], x2[3], s;
-  vtkTransform *trans;
-  vtkCell *cell;
-  vtkIdList *cellPts;
-  int npts;
-  vtkIdType *pts;
-  vtkIdType cellId;
-  vtkIdType subIncr;
-  int numDirs, dir, eigen_dir, symmetric_dir;
-  vtkMatrix4x4 *matrix;
-  double *m[3], w[3], *v[3];
-  double m0[3], m1[3], m2[3];
-  double v0[3], v1[3], v2[3];
-  double xv[3], yv[3], zv[3];
-  double maxScale;
   vtkPointData *pd, *outPD;
-
-  // Keeps track of the number of points added to the output polydata so far.
-  // this replaces variable ptIncr in superclass vtkTensorGlyph.
-  vtkIdType ptOffset = 0;
-
-  // coordinate systems for DTI
-  vtkTransform *userVolumeTransform = nullptr;
   // masking of glyphs
   vtkDataArray *inMask;
   // glyph timing
@@ -202,15 +609,7 @@ int vtkDiffusionTensorGlyph::RequestData(
   double tensor[3][3];
 
   // the number of eigenvectors to glyph * if there are two glyphs per vector
-  numDirs = (this->ThreeGlyphs?3:1)*(this->Symmetric+1);
-
-  pts = new vtkIdType[source->GetMaxCellSize()];
-  trans = vtkTransform::New();
-  matrix = vtkMatrix4x4::New();
-
-  // set up working matrices
-  m[0] = m0; m[1] = m1; m[2] = m2;
-  v[0] = v0; v[1] = v1; v[2] = v2;
+  int numDirs = (this->ThreeGlyphs?3:1)*(this->Symmetric+1);
 
   vtkDebugMacro(<<"Generating tensor glyphs");
 
@@ -222,14 +621,25 @@ int vtkDiffusionTensorGlyph::RequestData(
   if ( !inTensors || numPts < 1 )
     {
     vtkErrorMacro(<<"No data to glyph!");
-    trans->Delete();
-    matrix->Delete();
     return 1;
     }
 
+  // Figure out if we are masking some of the glyphs
+  inMask = nullptr;
+
+  if (this->MaskGlyphs)
+    {
+    if (this->Mask != nullptr)
+      {
+      inMask = this->Mask->GetPointData()->GetScalars();
+      }
+    else
+      {
+      vtkErrorMacro("User has not set input mask, but has requested MaskGlyphs");
+      }
+    }
+
   // Compute steps along dimensions
-  // and real number of input points
-  int numInputPts = numPts;
   int skipRows = 0;
   int skipCols = this->Resolution;
   int rowLength = numPts;
@@ -247,69 +657,124 @@ int vtkDiffusionTensorGlyph::RequestData(
     skipRows = DimensionResolution[1];
     skipCols = DimensionResolution[0];
     rowLength = dimensions[0];
-    if (skipCols)
+    }
+
+  //
+  // First pass: find the input points to glyph (not masked and included by
+  // this->Resolution) so that the output can be allocated exactly.
+  //
+  vtkDebugMacro(<<"Generating tensor glyphs: TRAVERSE POINTS");
+
+  std::vector<vtkIdType> keptPointIds;
+  for (inPtId=0; inPtId < numPts; inPtId += skipCols)
+    {
+    if (col >= rowLength)
+      {
+      row += skipRows;
+      inPtId = row * rowLength;
+      col = 0;
+      if (inPtId >= numPts)
+        {
+        break;
+        }
+      }
+    col += skipCols;
+    // progress notification
+    if ( ! (inPtId % 10000) )
+      {
+      this->UpdateProgress (0.5*inPtId/numPts);
+      if (this->GetAbortExecute())
+        {
+        break;
+        }
+      }
+
+    // Only display this glyph if either:
+    // a) we are masking and the mask is 1 at this location.
+    // b) the trace is positive and we are not masking (default).
+    if (inMask != nullptr)
       {
-      numInputPts = (numInputPts+1)/skipCols;
+      if (inMask->GetTuple1( inPtId ))
+        {
+        keptPointIds.push_back(inPtId);
+        }
       }
-    if (skipRows)
+    else if (!this->MaskGlyphs)
       {
-      numInputPts = (numInputPts+1)/skipRows;
+      // Threshold by trace ( must be > 0)
+      inTensors->GetTuple(inPtId, (double *)tensor);
+      if (vtkDiffusionTensorMathematics::Trace(tensor) > 0)
+        {
+        keptPointIds.push_back(inPtId);
+        }
       }
     }
+  const vtkIdType numGlyphs = static_cast<vtkIdType>(keptPointIds.size()) * numDirs;
 
   //
   // Allocate storage for output PolyData
   //
   sourcePts = source->GetPoints();
   numSourcePts = sourcePts->GetNumberOfPoints();
-  numSourceCells = source->GetNumberOfCells();
-
-  newPts = vtkPoints::New();
-  // Allocate as if we will glyph every point
-  // If some are masked/skipped for Resolution this will be fixed later with Squeeze
-  // TO DO allocate less for lower resolution
-  newPts->Allocate(numDirs*numInputPts*numSourcePts);
+  pd = source->GetPointData();
+  sourceNormals = pd->GetNormals();
 
-  // Setting up for calls to PolyData::InsertNextCell()
-  if ( (sourceCells=source->GetVerts())->GetNumberOfCells() > 0 )
+  std::vector<double> sourcePoints(3 * numSourcePts);
+  std::vector<double> sourcePointNormals(sourceNormals ? 3 * numSourcePts : 0);
+  for (i=0; i < numSourcePts; i++)
     {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs*numInputPts*sourceCells->GetSize());
-    output->SetVerts(cells);
-    cells->Delete();
-    }
-  if ( (sourceCells=this->GetSource()->GetLines())->GetNumberOfCells() > 0 )
-    {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs*numInputPts*sourceCells->GetSize());
-    output->SetLines(cells);
-    cells->Delete();
-    }
-  if ( (sourceCells=this->GetSource()->GetPolys())->GetNumberOfCells() > 0 )
-    {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs*numInputPts*sourceCells->GetSize());
-    output->SetPolys(cells);
-    cells->Delete();
+    sourcePts->GetPoint(i, &sourcePoints[3 * i]);
+    if (sourceNormals)
+      {
+      sourceNormals->GetTuple(i, &sourcePointNormals[3 * i]);
+      }
     }
-  if ( (sourceCells=this->GetSource()->GetStrips())->GetNumberOfCells() > 0 )
+
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataTypeToFloat();
+  newPts->SetNumberOfPoints(numGlyphs*numSourcePts);
+  float* newPtsPointer = vtkFloatArray::SafeDownCast(newPts->GetData())->GetPointer(0);
+
+  // Glyph topology is copied by type of cells
+  vtkCellArray* sourceCells[4] =
+    { source->GetVerts(), source->GetLines(), source->GetPolys(), source->GetStrips() };
+  std::vector<GlyphCellTemplate> cellTemplates;
+  std::vector<vtkSmartPointer<vtkIdTypeArray> > outCells;
+  int cellTypes[4];
+  for (int type = 0; type < 4; type++)
     {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs*numInputPts*sourceCells->GetSize());
-    output->SetStrips(cells);
-    cells->Delete();
+    const vtkIdType numCells = sourceCells[type]->GetNumberOfCells();
+    if (numCells == 0)
+      {
+      continue;
+      }
+    GlyphCellTemplate cells;
+    cells.NumberOfCells = numCells;
+    cells.Cells.reserve(sourceCells[type]->GetNumberOfConnectivityEntries());
+    vtkIdType npts;
+    vtkIdType* pts;
+    for (sourceCells[type]->InitTraversal(); sourceCells[type]->GetNextCell(npts, pts);)
+      {
+      cells.Cells.push_back(npts);
+      cells.Cells.insert(cells.Cells.end(), pts, pts + npts);
+      }
+    vtkNew<vtkIdTypeArray> cellsArray;
+    cellsArray->SetNumberOfValues(numGlyphs*static_cast<vtkIdType>(cells.Cells.size()));
+    cells.OutputCells = cellsArray->GetPointer(0);
+    cellTypes[cellTemplates.size()] = type;
+    cellTemplates.push_back(cells);
+    outCells.push_back(cellsArray.GetPointer());
     }
 
-  // Get point data, decide how to allocate scalars
-  pd = this->GetSource()->GetPointData();
-
   // generate scalars if eigenvalues are chosen or if scalars exist.
+  vtkNew<vtkFloatArray> newScalars;
+  float* newScalarsPointer = nullptr;
   if (this->ColorGlyphs &&
       ((this->ColorMode == COLOR_BY_EIGENVALUES) ||
        (inScalars && (this->ColorMode == COLOR_BY_SCALARS)) ) )
     {
-    newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numDirs*numInputPts*numSourcePts);
+    newScalars->SetNumberOfValues(numGlyphs*numSourcePts);
+    newScalarsPointer = newScalars->GetPointer(0);
     }
   else
     {
@@ -317,437 +782,79 @@ int vtkDiffusionTensorGlyph::RequestData(
     // (superclass does this but why? if user has not asked for ColorGlyphs)
     outPD->CopyAllOff();
     outPD->CopyScalarsOn();
-    outPD->CopyAllocate(pd,numDirs*numInputPts*numSourcePts);
+    outPD->CopyAllocate(pd,numGlyphs*numSourcePts);
     }
-  if ( (sourceNormals = pd->GetNormals()) )
+  vtkNew<vtkFloatArray> newNormals;
+  float* newNormalsPointer = nullptr;
+  if ( sourceNormals )
     {
-    newNormals = vtkFloatArray::New();
     newNormals->SetNumberOfComponents(3);
-    newNormals->Allocate(numDirs*3*numInputPts*numSourcePts);
+    newNormals->SetNumberOfTuples(numGlyphs*numSourcePts);
+    newNormalsPointer = newNormals->GetPointer(0);
     }
 
-  // Don't copy all topology here as in superclass because
-  // we are not necessarily outputting a glyph for every point.
-
-  // Figure out if we are masking some of the glyphs
-  inMask = nullptr;
-
-  if (this->MaskGlyphs)
-    {
-    if (this->Mask != nullptr)
-      {
-      inMask = this->Mask->GetPointData()->GetScalars();
-      }
-    else
-      {
-      vtkErrorMacro("User has not set input mask, but has requested MaskGlyphs");
-      }
-    }
+  vtkDebugMacro("Scalar coloring (" <<  this->ColorMode << ")  ["<< vtkTensorGlyph::COLOR_BY_EIGENVALUES << "] is evals. Scalar Invariant (" << this->ScalarInvariant << ")") ;
 
-  // Figure out if we are transforming output point locations
-  if (this->VolumePositionMatrix)
+  //
+  // Second pass: transform the glyph in this->Source by the tensor of each
+  // kept point and output it at the point location, in parallel.
+  //
+  if (!keptPointIds.empty() && !this->GetAbortExecute())
     {
-    // user transform to move points
-    userVolumeTransform = vtkTransform::New();
-
-    userVolumeTransform->SetMatrix(this->VolumePositionMatrix);
-    userVolumeTransform->PreMultiply();
+    // vtkDataSet::GetPoint() is thread safe once it has been called from a single thread
+    double x[3];
+    input->GetPoint(keptPointIds[0], x);
+
+    vtkDiffusionTensorGlyphFunctor functor(this, input, inTensors, inScalars, keptPointIds,
+      sourcePoints, sourcePointNormals, cellTemplates,
+      newPtsPointer, newNormalsPointer, newScalarsPointer);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(keptPointIds.size()), functor);
     }
+  this->UpdateProgress(1.0);
 
-  vtkDebugMacro(<<"Generating tensor glyphs: TRAVERSE POINTS");
-
-  vtkDebugMacro("Scalar coloring (" <<  this->ColorMode << ")  ["<< vtkTensorGlyph::COLOR_BY_EIGENVALUES << "] is evals. Scalar Invariant (" << this->ScalarInvariant << ")") ;
+  vtkDebugMacro(<<"Generated " << keptPointIds.size() <<" tensor glyphs");
 
   //
-  // Traverse all Input points, transforming glyph in this->Source by tensor,
-  // and outputting it at each point.  (Input points are not all used, only
-  // those not masked and included by this->Resolution.)
+  // Update output
   //
-  trans->PreMultiply();
-
-  for (inPtId=0; inPtId < numPts; inPtId += skipCols)
+  if ( newScalarsPointer == nullptr )
     {
-    if (col >= rowLength)
-      {
-      row += skipRows;
-      inPtId = row * rowLength;
-      col = 0;
-      if (inPtId >= numPts)
-        {
-        break;
-        }
-      }
-    col += skipCols;
-    // progress notification
-    if ( ! (inPtId % 10000) )
+    for (vtkIdType glyphId=0; glyphId < numGlyphs; glyphId++)
       {
-      this->UpdateProgress ((double)inPtId/numPts);
-
-      vtkDebugMacro(<<"Generating diffusion tensor glyphs: PROGRESS" << (double)inPtId/numPts);
-      if (this->GetAbortExecute())
+      for (i=0; i < numSourcePts; i++)
         {
-        break;
+        // TO DO: why does superclass have this if no scalar output?
+        // in this case it appears copy scalars is on (above in
+        // scalar allocation section).
+        outPD->CopyData(pd,i,glyphId*numSourcePts+i);
         }
       }
+    }
 
-    inTensors->GetTuple(inPtId, (double *)tensor);
-
-    // Decide whether this tensor will be glyphed:
-    // Threshold by trace ( must be > 0)
-    double trace = vtkDiffusionTensorMathematics::Trace(tensor);
+  output->SetPoints(newPts);
 
-    // Only display this glyph if either:
-    // a) we are masking and the mask is 1 at this location.
-    // b) the trace is positive and we are not masking (default).
-    if (( ( inMask != nullptr ) && inMask->GetTuple1( inPtId ) ) || ( !this->MaskGlyphs && trace > 0 ))
+  for (size_t cellsIndex = 0; cellsIndex < cellTemplates.size(); cellsIndex++)
+    {
+    vtkNew<vtkCellArray> cells;
+    cells->SetCells(numGlyphs*cellTemplates[cellsIndex].NumberOfCells, outCells[cellsIndex].GetPointer());
+    switch (cellTypes[cellsIndex])
       {
-      // copy topology of output glyph for this point
-      for (cellId=0; cellId < numSourceCells; cellId++)
-        {
-        cell = this->GetSource()->GetCell(cellId);
-        cellPts = cell->GetPointIds();
-        npts = cellPts->GetNumberOfIds();
-        for (dir=0; dir < numDirs; dir++)
-          {
-          // This variable may be removed, but that
-          // will not improve readability
-          //subIncr = ptIncr + dir*numSourcePts;
-
-          // Add offset calculated from all non-masked points added to output so far
-          subIncr = ptOffset + dir*numSourcePts;
-
-          for (i=0; i < npts; i++)
-            {
-            pts[i] = cellPts->GetId(i) + subIncr;
-            }
-          output->InsertNextCell(cell->GetCellType(),npts,pts);
-          }
-        }
-
-      // compute orientation vectors and scale factors from tensor
-      if ( this->ExtractEigenvalues ) // extract appropriate eigenfunctions
-        {
-        for (j=0; j<3; j++)
-          {
-          for (i=0; i<3; i++)
-            {
-            // this line from vtkTensorGlyph actually transposes
-            //m[i][j] = tensor[i+3*j];
-            // simpler code with 3x3 array:
-            m[i][j] = tensor[j][i];
-            }
-          }
-
-        //vtkMath::Jacobi(m, w, v);
-        // Use superior eigensolve from teem.
-        vtkDiffusionTensorMathematics::TeemEigenSolver(m,w,v);
-
-        //copy eigenvectors
-        xv[0] = v[0][0]; xv[1] = v[1][0]; xv[2] = v[2][0];
-        yv[0] = v[0][1]; yv[1] = v[1][1]; yv[2] = v[2][1];
-        zv[0] = v[0][2]; zv[1] = v[1][2]; zv[2] = v[2][2];
-        }
-      else //use tensor columns as eigenvectors
-        {
-        for (i=0; i<3; i++)
-          {
-          //xv[i] = tensor[i]; // from vtkTensorGlyph
-          //yv[i] = tensor[i+3];
-          //zv[i] = tensor[i+6];
-          xv[i] = tensor[0][i]; // with 3x3 matrix
-          yv[i] = tensor[1][i];
-          zv[i] = tensor[2][i];
-          }
-        w[0] = vtkMath::Normalize(xv);
-        w[1] = vtkMath::Normalize(yv);
-        w[2] = vtkMath::Normalize(zv);
-        }
-
-      // Calculate output scalars before computing glyph scale factors from eigenvalues.
-      // First, pass through input scalars if requested.
-      if ( inScalars && this->ColorGlyphs && ( this->ColorMode == vtkTensorGlyph::COLOR_BY_SCALARS ) )
-        {
-        // Copy point data from source
-        s = inScalars->GetComponent(inPtId, 0);
-        }
-
-      // Output scalar invariants if requested
-      else if ( this->ColorGlyphs && ( this->ColorMode == vtkTensorGlyph::COLOR_BY_EIGENVALUES ) )
-        {
-        // Correct for negative eigenvalues: use logic coded in vtkDiffusionTensorMathematics
-        vtkDiffusionTensorMathematics::FixNegativeEigenvaluesMethod(w);
-
-        switch (this->ScalarInvariant)
-          {
-          case vtkDiffusionTensorMathematics::VTK_TENS_LINEAR_MEASURE:
-            s = vtkDiffusionTensorMathematics::LinearMeasure(w);
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_PLANAR_MEASURE:
-            s = vtkDiffusionTensorMathematics::PlanarMeasure(w);
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_SPHERICAL_MEASURE:
-            s = vtkDiffusionTensorMathematics::SphericalMeasure(w);
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE:
-            s = w[0];
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_MID_EIGENVALUE:
-            s = w[1];
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE:
-            s = w[2];
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_PARALLEL_DIFFUSIVITY:
-            s = w[0];
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_PERPENDICULAR_DIFFUSIVITY:
-            s = 0.5*(w[1]+w[2]);
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION:
-            double v_maj[3];
-            v_maj[0]=v[0][0];
-            v_maj[1]=v[1][0];
-            v_maj[2]=v[2][0];
-            if (this->TensorRotationMatrix)
-              {
-              vtkNew<vtkTransform> rotate;
-              rotate->SetMatrix(this->TensorRotationMatrix);
-              rotate->TransformPoint(v_maj,v_maj);
-              }
-            // TO DO: here output as RGB. Need to allocate 3-component scalars first.
-            s = 0;
-            vtkDiffusionTensorMathematics::RGBToIndex(fabs(v_maj[0]),fabs(v_maj[1]),fabs(v_maj[2]),s);
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_RELATIVE_ANISOTROPY:
-            s = vtkDiffusionTensorMathematics::RelativeAnisotropy(w);
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY:
-            s = vtkDiffusionTensorMathematics::FractionalAnisotropy(w);
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_TRACE:
-            s = vtkDiffusionTensorMathematics::Trace(w);
-            break;
-          default:
-            s = 0;
-            break;
-          }
-        }
-
-      // Use the square root of the eigenvalues for scaling
-      // for DTI
-      w[0] = sqrt( w[0] );
-      w[1] = sqrt( w[1] );
-      w[2] = sqrt( w[2] );
-
-      // compute scale factors (this modifies eigenvalues so
-      // scalar invariants were computed already above)
-      w[0] *= this->ScaleFactor;
-      w[1] *= this->ScaleFactor;
-      w[2] *= this->ScaleFactor;
-
-      if ( this->ClampScaling )
-        {
-        for (maxScale=0.0, i=0; i<3; i++)
-          {
-          if ( maxScale < fabs(w[i]) )
-            {
-            maxScale = fabs(w[i]);
-            }
-          }
-        if ( maxScale > this->MaxScaleFactor )
-          {
-          maxScale = this->MaxScaleFactor / maxScale;
-          for (i=0; i<3; i++)
-            {
-            w[i] *= maxScale; //preserve overall shape of glyph
-            }
-          }
-        }
-
-      // normalization is postponed
-
-      // make sure scale is okay (non-zero) and scale data
-      // this scale checking is from superclass code
-      for (maxScale=0.0, i=0; i<3; i++)
-        {
-        if ( w[i] > maxScale )
-          {
-          maxScale = w[i];
-          }
-        }
-      if ( maxScale == 0.0 )
-        {
-        maxScale = 1.0;
-        }
-      for (i=0; i<3; i++)
-        {
-        if ( w[i] == 0.0 )
-          {
-          w[i] = maxScale * 1.0e-06;
-          }
-        }
-
-      // Now do the real work for each "direction"
-      // This is a loop over each eigenvector allowing
-      // a separate glyph for each (or two loops per eigenvector
-      // allowing two symmetric glyphs for each)
-
-      int flipNormals = 0;
-      if ( this->TensorRotationMatrix && this->TensorRotationMatrix->Determinant() < 0 )
-        {
-        flipNormals = 1;
-        }
-
-      for (dir=0; dir < numDirs; dir++)
-        {
-        eigen_dir = dir%(this->ThreeGlyphs?3:1);
-        symmetric_dir = dir/(this->ThreeGlyphs?3:1);
-
-        // Remove previous scales ...
-        trans->Identity();
-
-        // Actually output the scalar invariant calculated above
-        if ( newScalars != nullptr )
-          {
-          for (i=0; i < numSourcePts; i++)
-            {
-            newScalars->InsertTuple(ptOffset+i, &s);
-            }
-          }
-        else
-          {
-          for (i=0; i < numSourcePts; i++)
-            {
-            // TO DO: why does superclass have this if no scalar output?
-            // in this case it appears copy scalars is on (above in
-            // scalar allocation section).
-            outPD->CopyData(pd,i,ptOffset+i);
-            }
-          }
-
-        // translate Source to Input point
-        input->GetPoint(inPtId, x);
-
-        // If we have a user-specified matrix modifying the output point locations
-        if ( userVolumeTransform != nullptr )
-          {
-          userVolumeTransform->TransformPoint(x,x2);
-          trans->Translate(x2[0], x2[1], x2[2]);
-          }
-        else
-          {
-          trans->Translate(x[0], x[1], x[2]);
-          }
-
-        // If we have a user-specified matrix rotating each tensor
-        if (this->TensorRotationMatrix)
-          {
-          trans->Concatenate(this->TensorRotationMatrix);
-          }
-
-        // normalized eigenvectors rotate object for eigen direction 0
-        matrix->Element[0][0] = xv[0];
-        matrix->Element[0][1] = yv[0];
-        matrix->Element[0][2] = zv[0];
-        matrix->Element[1][0] = xv[1];
-        matrix->Element[1][1] = yv[1];
-        matrix->Element[1][2] = zv[1];
-        matrix->Element[2][0] = xv[2];
-        matrix->Element[2][1] = yv[2];
-        matrix->Element[2][2] = zv[2];
-        trans->Concatenate(matrix);
-
-        if (eigen_dir == 1)
-          {
-          trans->RotateZ(90.0);
-          }
-
-        if (eigen_dir == 2)
-          {
-          trans->RotateY(-90.0);
-          }
-
-        if (this->ThreeGlyphs)
-          {
-          trans->Scale(w[eigen_dir], this->ScaleFactor, this->ScaleFactor);
-          }
-        else
-          {
-          trans->Scale(w[0], w[1], w[2]);
-          }
-
-        // Mirror second set to the symmetric position
-        if (symmetric_dir == 1)
-          {
-          trans->Scale(-1.,1.,1.);
-          }
-
-        // if the eigenvalue is negative, shift to reverse direction.
-        // The && is there to ensure that we do not change the
-        // old behaviour of vtkTensorGlyphs (which only used one dir),
-        // in case there is an oriented glyph, e.g. an arrow.
-        if (w[eigen_dir] < 0 && numDirs > 1)
-          {
-          trans->Translate(-this->Length, 0., 0.);
-          }
-
-        // multiply points (and normals if available) by resulting
-        // matrix.
-        // This also appends them to the output "new" data.
-        trans->TransformPoints(sourcePts,newPts);
-
-        // Apply the transformation to a series of points,
-        // and append the results to outPts.
-        if ( newNormals )
-          {
-          if ( flipNormals )
-            {
-            trans->Scale(-1.,-1.,-1.);
-            trans->TransformNormals(sourceNormals,newNormals);
-            trans->Scale(-1.,-1.,-1.);
-            }
-          else
-            {
-            trans->TransformNormals(sourceNormals,newNormals);
-            }
-          }
-
-        // Keep track of the number of points output so far.
-        ptOffset += numSourcePts;
-        } // end for number of dirs
-      } // end if mask is 1 OR trace is ok (so tensor was glyphed)
-    } // end loop over input points
-
-  vtkDebugMacro(<<"Generated " << numInputPts <<" tensor glyphs");
-
-  //
-  // Update output and release memory
-  //
-  delete [] pts;
-
-  output->SetPoints(newPts);
-  newPts->Delete();
+      case 0: output->SetVerts(cells); break;
+      case 1: output->SetLines(cells); break;
+      case 2: output->SetPolys(cells); break;
+      default: output->SetStrips(cells); break;
+      }
+    }
 
-  if ( newScalars )
+  if ( newScalarsPointer )
     {
     int idx = outPD->AddArray(newScalars);
     outPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
-    newScalars->Delete();
     }
 
-  if ( newNormals )
+  if ( newNormalsPointer )
     {
     outPD->SetNormals(newNormals);
-    newNormals->Delete();
-    }
-
-  output->Squeeze();
-  trans->Delete();
-  matrix->Delete();
-
-  if ( userVolumeTransform )
-    {
-    userVolumeTransform->Delete();
     }
 
   vtkDebugMacro("glyph time: " << clock() - tStart );
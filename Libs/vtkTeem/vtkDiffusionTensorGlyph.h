@@ -65,6 +65,9 @@ class vtkMatrix4x4;
 /// functions are scalar invariants of the diffusion tensor.  They are selected
 /// by calling ColorGlyphsByFractionalAnisotropy, etc.
 ///
+/// The points to glyph are selected first so that the output is allocated
+/// exactly, glyphs are then generated in parallel using vtkSMPTools.
+///
 /// \sa vtkTensorGlyph
 /// \sa vtkDiffusionTensorMathematics
 /// \sa vtkSuperquadricTensorGlyph
@@ -187,6 +190,8 @@ protected:
   vtkImageData *Mask;  /// display glyphs at points where mask is nonzero
 
 private:
+  friend class vtkDiffusionTensorGlyphFunctor;
+
   vtkDiffusionTensorGlyph(const vtkDiffusionTensorGlyph&) = delete;
   void operator=(const vtkDiffusionTensorGlyph&) = delete;
 };
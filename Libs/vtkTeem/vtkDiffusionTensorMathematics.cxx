@@ -19,12 +19,14 @@
 
 // But, if you are on VS6.0 you don't get the define...
 #include "vtkDataArray.h"
+#include "vtkFloatArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkImageData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkDiffusionTensorMathematics.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkTransform.h"
 #include "vtkPointData.h"
@@ -126,6 +128,184 @@ int vtkDiffusionTensorMathematics::RequestInformation (
 
 
 
+//----------------------------------------------------------------------------
+// Returns true if the operation output is a RGBA color
+static bool vtkDiffusionTensorMathematicsIsColorOperation(int op)
+{
+  return op == vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION
+    || op == vtkDiffusionTensorMathematics::VTK_TENS_COLOR_MODE
+    || op == vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIDDLE_EIGENVECTOR
+    || op == vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIN_EIGENVECTOR;
+}
+
+//----------------------------------------------------------------------------
+// Returns true if the operation needs the eigenvectors of the tensors
+static bool vtkDiffusionTensorMathematicsUsesEigenvectors(int op)
+{
+  switch (op)
+    {
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJX:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJY:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJZ:
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJX:
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJY:
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJZ:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJX:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJY:
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJZ:
+    case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION:
+    case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIDDLE_EIGENVECTOR:
+    case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION_MIN_EIGENVECTOR:
+      return true;
+    default:
+      return false;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Scalar (not color) measure of a tensor, computed from its eigensystem.
+static double vtkDiffusionTensorMathematicsScalarMeasure(int op, double tensor[3][3],
+                                                         double w[3], double **v)
+{
+  switch (op)
+    {
+    case vtkDiffusionTensorMathematics::VTK_TENS_D11:
+      return tensor[0][0];
+    case vtkDiffusionTensorMathematics::VTK_TENS_D22:
+      return tensor[1][1];
+    case vtkDiffusionTensorMathematics::VTK_TENS_D33:
+      return tensor[2][2];
+    case vtkDiffusionTensorMathematics::VTK_TENS_TRACE:
+      return vtkDiffusionTensorMathematics::Trace(tensor);
+    case vtkDiffusionTensorMathematics::VTK_TENS_DETERMINANT:
+      return vtkDiffusionTensorMathematics::Determinant(tensor);
+    case vtkDiffusionTensorMathematics::VTK_TENS_RELATIVE_ANISOTROPY:
+      return vtkDiffusionTensorMathematics::RelativeAnisotropy(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY:
+      return vtkDiffusionTensorMathematics::FractionalAnisotropy(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_LINEAR_MEASURE:
+      return vtkDiffusionTensorMathematics::LinearMeasure(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_PLANAR_MEASURE:
+      return vtkDiffusionTensorMathematics::PlanarMeasure(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_SPHERICAL_MEASURE:
+      return vtkDiffusionTensorMathematics::SphericalMeasure(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE:
+      return w[0];
+    case vtkDiffusionTensorMathematics::VTK_TENS_MID_EIGENVALUE:
+      return w[1];
+    case vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE:
+      return w[2];
+    case vtkDiffusionTensorMathematics::VTK_TENS_PARALLEL_DIFFUSIVITY:
+      return vtkDiffusionTensorMathematics::ParallelDiffusivity(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_PERPENDICULAR_DIFFUSIVITY:
+      return vtkDiffusionTensorMathematics::PerpendicularDiffusivity(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MEAN_DIFFUSIVITY:
+      return vtkDiffusionTensorMathematics::MeanDiffusivity(w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJX:
+      return vtkDiffusionTensorMathematics::MaxEigenvalueProjectionX(v,w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJY:
+      return vtkDiffusionTensorMathematics::MaxEigenvalueProjectionY(v,w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJZ:
+      return vtkDiffusionTensorMathematics::MaxEigenvalueProjectionZ(v,w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJX:
+      return vtkDiffusionTensorMathematics::RAIMaxEigenvecX(v,w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJY:
+      return vtkDiffusionTensorMathematics::RAIMaxEigenvecY(v,w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJZ:
+      return vtkDiffusionTensorMathematics::RAIMaxEigenvecZ(v,w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJX:
+      return vtkDiffusionTensorMathematics::MaxEigenvecX(v,w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJY:
+      return vtkDiffusionTensorMathematics::MaxEigenvecY(v,w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJZ:
+      return vtkDiffusionTensorMathematics::MaxEigenvecZ(v,w);
+    case vtkDiffusionTensorMathematics::VTK_TENS_MODE:
+      return vtkDiffusionTensorMathematics::Mode(w);
+    default:
+      return 0.;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorMathematics::AddAdditionalOperation(int operation)
+{
+  if (operation < VTK_TENS_TRACE || operation > VTK_TENS_MEAN_DIFFUSIVITY
+    || vtkDiffusionTensorMathematicsIsColorOperation(operation))
+    {
+    vtkErrorMacro(<< "AddAdditionalOperation: invalid operation " << operation);
+    return;
+    }
+  this->AdditionalOperations.push_back(operation);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorMathematics::RemoveAllAdditionalOperations()
+{
+  if (this->AdditionalOperations.empty())
+    {
+    return;
+    }
+  this->AdditionalOperations.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkDiffusionTensorMathematics::GetNumberOfAdditionalOperations()
+{
+  return static_cast<int>(this->AdditionalOperations.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkDiffusionTensorMathematics::GetAdditionalOperation(int index)
+{
+  if (index < 0 || index >= static_cast<int>(this->AdditionalOperations.size()))
+    {
+    vtkErrorMacro(<< "GetAdditionalOperation: index out of range " << index);
+    return -1;
+    }
+  return this->AdditionalOperations[index];
+}
+
+//----------------------------------------------------------------------------
+const char* vtkDiffusionTensorMathematics::GetOperationAsString(int operation)
+{
+  switch (operation)
+    {
+    case VTK_TENS_TRACE: return "Trace";
+    case VTK_TENS_DETERMINANT: return "Determinant";
+    case VTK_TENS_RELATIVE_ANISOTROPY: return "RelativeAnisotropy";
+    case VTK_TENS_FRACTIONAL_ANISOTROPY: return "FractionalAnisotropy";
+    case VTK_TENS_MAX_EIGENVALUE: return "MaxEigenvalue";
+    case VTK_TENS_MID_EIGENVALUE: return "MidEigenvalue";
+    case VTK_TENS_MIN_EIGENVALUE: return "MinEigenvalue";
+    case VTK_TENS_LINEAR_MEASURE: return "LinearMeasure";
+    case VTK_TENS_PLANAR_MEASURE: return "PlanarMeasure";
+    case VTK_TENS_SPHERICAL_MEASURE: return "SphericalMeasure";
+    case VTK_TENS_COLOR_ORIENTATION: return "ColorOrientation";
+    case VTK_TENS_D11: return "D11";
+    case VTK_TENS_D22: return "D22";
+    case VTK_TENS_D33: return "D33";
+    case VTK_TENS_MODE: return "Mode";
+    case VTK_TENS_COLOR_MODE: return "ColorMode";
+    case VTK_TENS_MAX_EIGENVALUE_PROJX: return "MaxEigenvalueProjectionX";
+    case VTK_TENS_MAX_EIGENVALUE_PROJY: return "MaxEigenvalueProjectionY";
+    case VTK_TENS_MAX_EIGENVALUE_PROJZ: return "MaxEigenvalueProjectionZ";
+    case VTK_TENS_RAI_MAX_EIGENVEC_PROJX: return "RAIMaxEigenvecX";
+    case VTK_TENS_RAI_MAX_EIGENVEC_PROJY: return "RAIMaxEigenvecY";
+    case VTK_TENS_RAI_MAX_EIGENVEC_PROJZ: return "RAIMaxEigenvecZ";
+    case VTK_TENS_MAX_EIGENVEC_PROJX: return "MaxEigenvecX";
+    case VTK_TENS_MAX_EIGENVEC_PROJY: return "MaxEigenvecY";
+    case VTK_TENS_MAX_EIGENVEC_PROJZ: return "MaxEigenvecZ";
+    case VTK_TENS_PARALLEL_DIFFUSIVITY: return "ParallelDiffusivity";
+    case VTK_TENS_PERPENDICULAR_DIFFUSIVITY: return "PerpendicularDiffusivity";
+    case VTK_TENS_COLOR_ORIENTATION_MIDDLE_EIGENVECTOR: return "ColorOrientationMiddleEigenvector";
+    case VTK_TENS_COLOR_ORIENTATION_MIN_EIGENVECTOR: return "ColorOrientationMinEigenvector";
+    case VTK_TENS_MEAN_DIFFUSIVITY: return "MeanDiffusivity";
+    default: return "Unknown";
+    }
+}
+
 //----------------------------------------------------------------------------
 int vtkDiffusionTensorMathematics::FillInputPortInformation(
   int port, vtkInformation* info)
@@ -154,6 +334,21 @@ int vtkDiffusionTensorMathematics
   return res;
 }
 
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorMathematics::CopyAttributeData(vtkImageData* in, vtkImageData* out,
+                                                      vtkInformationVector** inputVector)
+{
+  this->Superclass::CopyAttributeData(in, out, inputVector);
+  // Arrays of the additional operations, filled by ThreadedRequestData
+  for (int operation : this->AdditionalOperations)
+    {
+    vtkNew<vtkFloatArray> array;
+    array->SetName(vtkDiffusionTensorMathematics::GetOperationAsString(operation));
+    array->SetNumberOfTuples(out->GetNumberOfPoints());
+    out->GetPointData()->AddArray(array);
+    }
+}
+
 //----------------------------------------------------------------------------
 static void GetContinuousIncrements(vtkImageData* img, int extent[6], vtkIdType &incX,
                                     vtkIdType &incY, vtkIdType &incZ)
@@ -397,13 +592,11 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
   tStart = clock();
 #endif
   // working matrices
-  double *m[3], w[3], *v[3];
-  double m0[3], m1[3], m2[3];
+  double w[3], *v[3];
   double v0[3], v1[3], v2[3];
   double v_maj[3];
-  m[0] = m0; m[1] = m1; m[2] = m2;
   v[0] = v0; v[1] = v1; v[2] = v2;
-  int i, j;
+  int i, j, k;
   double r, g, b;
   int extractEigenvalues;
   double cl;
@@ -452,6 +645,49 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
   // decide whether to extract eigenfunctions or just use input cols
   extractEigenvalues = self->GetExtractEigenvalues();
 
+  // measures computed in the same pass
+  const int numAdditionalOps = self->GetNumberOfAdditionalOperations();
+  std::vector<int> additionalOps(numAdditionalOps);
+  std::vector<vtkDataArray*> additionalArrays(numAdditionalOps);
+  std::vector<float*> additionalPtrs(numAdditionalOps);
+  bool useEigenvectors = vtkDiffusionTensorMathematicsUsesEigenvectors(op);
+  for (k = 0; k < numAdditionalOps; k++)
+    {
+    additionalOps[k] = self->GetAdditionalOperation(k);
+    additionalArrays[k] = outData->GetPointData()->GetArray(
+      vtkDiffusionTensorMathematics::GetOperationAsString(additionalOps[k]));
+    if (!additionalArrays[k] || additionalArrays[k]->GetDataType() != VTK_FLOAT)
+      {
+      vtkGenericWarningMacro(<<"Missing output array for additional operation " << additionalOps[k]);
+      return;
+      }
+    useEigenvectors = useEigenvectors || vtkDiffusionTensorMathematicsUsesEigenvectors(additionalOps[k]);
+    }
+
+  // The tensors of a row are read from the input array as structure of
+  // arrays and diagonalized together by the closed-form batch solver.
+  std::vector<double> rowTensors(extractEigenvalues ? 6 * rowLength : 0);
+  std::vector<double> rowEigenvalues(extractEigenvalues ? 3 * rowLength : 0);
+  std::vector<double> rowEigenvectors(extractEigenvalues && useEigenvectors ? 9 * rowLength : 0);
+  const double* rowTensorComponents[6];
+  double* rowEigenvalueComponents[3];
+  double* rowEigenvectorComponents[9];
+  if (extractEigenvalues)
+    {
+    for (k = 0; k < 6; k++)
+      {
+      rowTensorComponents[k] = &rowTensors[k * rowLength];
+      }
+    for (k = 0; k < 3; k++)
+      {
+      rowEigenvalueComponents[k] = &rowEigenvalues[k * rowLength];
+      }
+    for (k = 0; k < 9 && useEigenvectors; k++)
+      {
+      rowEigenvectorComponents[k] = &rowEigenvectors[k * rowLength];
+      }
+    }
+
   // transformation of tensor orientations for coloring
   vtkTransform *trans = vtkTransform::New();
   int useTransform = 0;
@@ -494,11 +730,38 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
         count++;
         }
 
+      if (extractEigenvalues)
+        {
+        // symmetric tensor components: xx, xy, xz, yy, yz, zz
+        const float* rowPtr = inPtr;
+        for (idxR = 0; idxR < rowLength; idxR++, rowPtr += 9)
+          {
+          rowTensors[idxR] = rowPtr[0];
+          rowTensors[rowLength + idxR] = rowPtr[1];
+          rowTensors[2 * rowLength + idxR] = rowPtr[2];
+          rowTensors[3 * rowLength + idxR] = rowPtr[4];
+          rowTensors[4 * rowLength + idxR] = rowPtr[5];
+          rowTensors[5 * rowLength + idxR] = rowPtr[8];
+          }
+        vtkDiffusionTensorMathematics::SymmetricEigenSolverBatch(rowLength,
+          rowTensorComponents, rowEigenvalueComponents,
+          useEigenvectors ? rowEigenvectorComponents : nullptr);
+        }
+      for (k = 0; k < numAdditionalOps; k++)
+        {
+        int rowStart[3] = { outExt[0], outExt[2] + idxY, outExt[4] + idxZ };
+        additionalPtrs[k] = static_cast<float*>(outData->GetArrayPointer(additionalArrays[k], rowStart));
+        }
+
       for (idxR = 0; idxR < rowLength; idxR++)
         {
         if (doMasking && *inMaskPtr != self->GetMaskLabelValue())
           {
           *outPtr = 0;
+          for (k = 0; k < numAdditionalOps; k++)
+            {
+            additionalPtrs[k][idxR] = 0.f;
+            }
 
           if (op ==  vtkDiffusionTensorMathematics::VTK_TENS_COLOR_MODE ||
             op ==  vtkDiffusionTensorMathematics::VTK_TENS_COLOR_ORIENTATION) {
@@ -526,17 +789,15 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
           // get eigenvalues and eigenvectors appropriately
           if (extractEigenvalues)
             {
+            // eigensystem computed for the whole row
             for (j=0; j<3; j++)
               {
-              for (i=0; i<3; i++)
+              w[j] = rowEigenvalues[j * rowLength + idxR];
+              for (i=0; i<3 && useEigenvectors; i++)
                 {
-                // transpose
-                m[i][j] = tensor[j][i];
+                v[i][j] = rowEigenvectors[(3 * j + i) * rowLength + idxR];
                 }
               }
-            // compute eigensystem
-            //vtkMath::Jacobi(m, w, v);
-            vtkDiffusionTensorMathematics::TeemEigenSolver(m,w,v);
             }
           else
             {
@@ -580,91 +841,18 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
               w[2] = DOUBLE_NAN;
           }
 
+          // measures computed in the same pass
+          for (k = 0; k < numAdditionalOps; k++)
+            {
+            additionalPtrs[k][idxR] = static_cast<float>(scaleFactor *
+              vtkDiffusionTensorMathematicsScalarMeasure(additionalOps[k], tensor, w, v));
+            }
+
           // pixel operation
           switch (op)
             {
-          case vtkDiffusionTensorMathematics::VTK_TENS_RELATIVE_ANISOTROPY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RelativeAnisotropy(w));
-            break;
-          case vtkDiffusionTensorMathematics::VTK_TENS_FRACTIONAL_ANISOTROPY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::FractionalAnisotropy(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_LINEAR_MEASURE:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::LinearMeasure(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_PLANAR_MEASURE:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::PlanarMeasure(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_SPHERICAL_MEASURE:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::SphericalMeasure(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE:
-            *outPtr = (T)w[0];
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MID_EIGENVALUE:
-            *outPtr = (T)w[1];
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MIN_EIGENVALUE:
-            *outPtr = (T)w[2];
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_PARALLEL_DIFFUSIVITY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::ParallelDiffusivity(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_PERPENDICULAR_DIFFUSIVITY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::PerpendicularDiffusivity(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MEAN_DIFFUSIVITY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MeanDiffusivity(w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJX:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvalueProjectionX(v,w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJY:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvalueProjectionY(v,w));
-            break;
-
-          case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVALUE_PROJZ:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvalueProjectionZ(v,w));
-            break;
-
-      case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJX:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RAIMaxEigenvecX(v,w));
-        break;
-
-      case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJY:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RAIMaxEigenvecY(v,w));
-        break;
-
-      case vtkDiffusionTensorMathematics::VTK_TENS_RAI_MAX_EIGENVEC_PROJZ:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::RAIMaxEigenvecZ(v,w));
-        break;
-
-      case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJX:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvecX(v,w));
-        break;
-
-      case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJY:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvecY(v,w));
-        break;
-
-      case vtkDiffusionTensorMathematics::VTK_TENS_MAX_EIGENVEC_PROJZ:
-        *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::MaxEigenvecZ(v,w));
-        break;
-
-
-      case vtkDiffusionTensorMathematics::VTK_TENS_MODE:
-            *outPtr = static_cast<T> (vtkDiffusionTensorMathematics::Mode(w));
+          default:
+            *outPtr = static_cast<T> (vtkDiffusionTensorMathematicsScalarMeasure(op, tensor, w, v));
             break;
 
           case vtkDiffusionTensorMathematics::VTK_TENS_COLOR_MODE:
@@ -854,28 +1042,17 @@ void vtkDiffusionTensorMathematics::ThreadedRequestData(
   // single input only for now
   vtkDebugMacro ("In Threaded Execute. scalar type is " << inData[0][0]->GetScalarType() << "op is: " << this->Operation);
 
+  bool computeEigenvalues = false;
   switch (this->GetOperation())
     {
-
-      // Operations where eigenvalues are not computed
+    // Operations where eigenvalues are not computed
     case VTK_TENS_D11:
     case VTK_TENS_D22:
     case VTK_TENS_D33:
     case VTK_TENS_TRACE:
     case VTK_TENS_DETERMINANT:
-      switch (outData[0]->GetScalarType())
-      {
-      // we set the output data scalar type depending on the op
-      // already.  And we only access the input tensors
-      // which are float.  So this switch statement on output
-      // scalar type is sufficient.
-      vtkTemplateMacro(vtkDiffusionTensorMathematicsExecute1(
-                this,inData[0][0], outData[0],
-                static_cast<VTK_TT*>(outPtr), outExt, id));
-      default:
-        vtkErrorMacro(<< "Execute: Unknown ScalarType");
-        return;
-      }
+      // unless additional operations need them
+      computeEigenvalues = !this->AdditionalOperations.empty();
       break;
 
     // Operations where eigenvalues are computed
@@ -899,6 +1076,31 @@ void vtkDiffusionTensorMathematics::ThreadedRequestData(
     case VTK_TENS_PARALLEL_DIFFUSIVITY:
     case VTK_TENS_PERPENDICULAR_DIFFUSIVITY:
     case VTK_TENS_MEAN_DIFFUSIVITY:
+      computeEigenvalues = true;
+      break;
+
+    default:
+      return;
+    }
+
+  if (!computeEigenvalues)
+    {
+      switch (outData[0]->GetScalarType())
+      {
+      // we set the output data scalar type depending on the op
+      // already.  And we only access the input tensors
+      // which are float.  So this switch statement on output
+      // scalar type is sufficient.
+      vtkTemplateMacro(vtkDiffusionTensorMathematicsExecute1(
+                this,inData[0][0], outData[0],
+                static_cast<VTK_TT*>(outPtr), outExt, id));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        return;
+      }
+    }
+  else
+    {
       switch (outData[0]->GetScalarType())
       {
         vtkTemplateMacro(vtkDiffusionTensorMathematicsExecute1Eigen(
@@ -908,8 +1110,7 @@ void vtkDiffusionTensorMathematics::ThreadedRequestData(
         vtkErrorMacro(<< "Execute: Unknown ScalarType");
         return;
       }
-    break;
-  }
+    }
 }
 
 
@@ -1163,6 +1364,12 @@ void vtkDiffusionTensorMathematics::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Operation: " << this->Operation << "\n";
+  os << indent << "AdditionalOperations:";
+  for (int operation : this->AdditionalOperations)
+    {
+    os << " " << operation;
+    }
+  os << "\n";
 }
 
 // Colormap: convert our mode value (-1..1) to RGB
@@ -1368,3 +1575,225 @@ int vtkDiffusionTensorMathematics::TeemEigenSolver(double **m, double *w, double
     return res;
 
 }
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Product of the symmetric matrix a (xx, xy, xz, yy, yz, zz) by the vector x
+void SymmetricMatrixVectorProduct(const double a[6], const double x[3], double y[3])
+{
+  y[0] = a[0] * x[0] + a[1] * x[1] + a[2] * x[2];
+  y[1] = a[1] * x[0] + a[3] * x[1] + a[4] * x[2];
+  y[2] = a[2] * x[0] + a[4] * x[1] + a[5] * x[2];
+}
+
+//----------------------------------------------------------------------------
+// Unit eigenvector of the symmetric matrix a for the eigenvalue eval of
+// multiplicity 1. The rows of (a - eval I) span the plane orthogonal to the
+// eigenvector, the most accurate normal of that plane is the largest cross
+// product of two rows.
+void ComputeSimpleEigenvector(const double a[6], double eval, double evec[3])
+{
+  const double row0[3] = { a[0] - eval, a[1], a[2] };
+  const double row1[3] = { a[1], a[3] - eval, a[4] };
+  const double row2[3] = { a[2], a[4], a[5] - eval };
+  double cross[3][3];
+  vtkMath::Cross(row0, row1, cross[0]);
+  vtkMath::Cross(row0, row2, cross[1]);
+  vtkMath::Cross(row1, row2, cross[2]);
+  int best = 0;
+  double bestNorm2 = vtkMath::Dot(cross[0], cross[0]);
+  for (int i = 1; i < 3; ++i)
+    {
+    const double norm2 = vtkMath::Dot(cross[i], cross[i]);
+    if (norm2 > bestNorm2)
+      {
+      best = i;
+      bestNorm2 = norm2;
+      }
+    }
+  if (bestNorm2 <= 0.)
+    {
+    evec[0] = 1.;
+    evec[1] = 0.;
+    evec[2] = 0.;
+    return;
+    }
+  const double invNorm = 1. / sqrt(bestNorm2);
+  evec[0] = cross[best][0] * invNorm;
+  evec[1] = cross[best][1] * invNorm;
+  evec[2] = cross[best][2] * invNorm;
+}
+
+//----------------------------------------------------------------------------
+// Unit eigenvector of the symmetric matrix a for the eigenvalue eval that is
+// orthogonal to the unit eigenvector known. The 2x2 restriction of
+// (a - eval I) to the plane orthogonal to known is singular, its null space
+// is the eigenvector.
+void ComputeOrthogonalEigenvector(const double a[6], const double known[3], double eval, double evec[3])
+{
+  // Orthonormal basis (u, v) of the plane orthogonal to known
+  double u[3];
+  double v[3];
+  if (fabs(known[0]) > fabs(known[1]))
+    {
+    const double invLength = 1. / sqrt(known[0] * known[0] + known[2] * known[2]);
+    u[0] = -known[2] * invLength;
+    u[1] = 0.;
+    u[2] = known[0] * invLength;
+    }
+  else
+    {
+    const double invLength = 1. / sqrt(known[1] * known[1] + known[2] * known[2]);
+    u[0] = 0.;
+    u[1] = known[2] * invLength;
+    u[2] = -known[1] * invLength;
+    }
+  vtkMath::Cross(known, u, v);
+
+  double au[3];
+  double av[3];
+  SymmetricMatrixVectorProduct(a, u, au);
+  SymmetricMatrixVectorProduct(a, v, av);
+  double m00 = vtkMath::Dot(u, au) - eval;
+  double m01 = vtkMath::Dot(u, av);
+  double m11 = vtkMath::Dot(v, av) - eval;
+
+  // Normalize the largest row of the 2x2 matrix to get its null vector
+  const double absM00 = fabs(m00);
+  const double absM01 = fabs(m01);
+  const double absM11 = fabs(m11);
+  double cu = 1.;
+  double cv = 0.;
+  if (absM00 >= absM11)
+    {
+    if (MAX(absM00, absM01) > 0.)
+      {
+      if (absM00 >= absM01)
+        {
+        m01 /= m00;
+        m00 = 1. / sqrt(1. + m01 * m01);
+        m01 *= m00;
+        }
+      else
+        {
+        m00 /= m01;
+        m01 = 1. / sqrt(1. + m00 * m00);
+        m00 *= m01;
+        }
+      cu = m01;
+      cv = -m00;
+      }
+    }
+  else
+    {
+    if (MAX(absM11, absM01) > 0.)
+      {
+      if (absM11 >= absM01)
+        {
+        m01 /= m11;
+        m11 = 1. / sqrt(1. + m01 * m01);
+        m01 *= m11;
+        }
+      else
+        {
+        m11 /= m01;
+        m01 = 1. / sqrt(1. + m11 * m11);
+        m11 *= m01;
+        }
+      cu = m11;
+      cv = -m01;
+      }
+    }
+  evec[0] = cu * u[0] + cv * v[0];
+  evec[1] = cu * u[1] + cv * v[1];
+  evec[2] = cu * u[2] + cv * v[2];
+}
+
+}
+
+//----------------------------------------------------------------------------
+void vtkDiffusionTensorMathematics::SymmetricEigenSolverBatch(vtkIdType numberOfTensors,
+                                                              const double* const tensors[6],
+                                                              double* const eigenvalues[3],
+                                                              double* const eigenvectors[9])
+{
+  const double* const xx = tensors[0];
+  const double* const xy = tensors[1];
+  const double* const xz = tensors[2];
+  const double* const yy = tensors[3];
+  const double* const yz = tensors[4];
+  const double* const zz = tensors[5];
+  double* const w0 = eigenvalues[0];
+  double* const w1 = eigenvalues[1];
+  double* const w2 = eigenvalues[2];
+  const double twoThirdPi = 2. * vtkMath::Pi() / 3.;
+
+  // Eigenvalues are the roots of the characteristic polynomial, computed with
+  // the trigonometric solution of the cubic equation. The loop has no data
+  // dependent branches so that the compiler can vectorize it.
+  for (vtkIdType i = 0; i < numberOfTensors; ++i)
+    {
+    // Shift by the mean eigenvalue and scale to improve accuracy
+    const double q = (xx[i] + yy[i] + zz[i]) / 3.;
+    const double b00 = xx[i] - q;
+    const double b11 = yy[i] - q;
+    const double b22 = zz[i] - q;
+    const double b01 = xy[i];
+    const double b02 = xz[i];
+    const double b12 = yz[i];
+    const double p2 = b00 * b00 + b11 * b11 + b22 * b22
+                      + 2. * (b01 * b01 + b02 * b02 + b12 * b12);
+    const double p = sqrt(p2 / 6.);
+    const double invP = (p > 0. ? 1. / p : 0.);
+    // Half determinant of (a - q I) / p, within [-1, 1]
+    const double det = b00 * (b11 * b22 - b12 * b12)
+                       - b01 * (b01 * b22 - b12 * b02)
+                       + b02 * (b01 * b12 - b11 * b02);
+    const double halfDet = MIN(1., MAX(-1., 0.5 * det * invP * invP * invP));
+    const double angle = acos(halfDet) / 3.;
+    w0[i] = q + 2. * p * cos(angle);
+    w2[i] = q + 2. * p * cos(angle + twoThirdPi);
+    // middle eigenvalue from the trace, clamped for repeated eigenvalues
+    w1[i] = MIN(w0[i], MAX(w2[i], 3. * q - w0[i] - w2[i]));
+    }
+
+  if (eigenvectors == nullptr)
+    {
+    return;
+    }
+
+  for (vtkIdType i = 0; i < numberOfTensors; ++i)
+    {
+    const double a[6] = { xx[i], xy[i], xz[i], yy[i], yz[i], zz[i] };
+    double evec[3][3];
+    if (w0[i] == w2[i])
+      {
+      // isotropic tensor, any basis is an eigenbasis
+      evec[0][0] = 1.; evec[0][1] = 0.; evec[0][2] = 0.;
+      evec[1][0] = 0.; evec[1][1] = 1.; evec[1][2] = 0.;
+      evec[2][0] = 0.; evec[2][1] = 0.; evec[2][2] = 1.;
+      }
+    else if (w0[i] - w1[i] >= w1[i] - w2[i])
+      {
+      // the largest eigenvalue is the most separated, its eigenvector is
+      // computed first as it is the most accurate one.
+      ComputeSimpleEigenvector(a, w0[i], evec[0]);
+      ComputeOrthogonalEigenvector(a, evec[0], w1[i], evec[1]);
+      vtkMath::Cross(evec[0], evec[1], evec[2]);
+      }
+    else
+      {
+      ComputeSimpleEigenvector(a, w2[i], evec[2]);
+      ComputeOrthogonalEigenvector(a, evec[2], w1[i], evec[1]);
+      vtkMath::Cross(evec[1], evec[2], evec[0]);
+      }
+    for (int j = 0; j < 3; ++j)
+      {
+      eigenvectors[3 * j][i] = evec[j][0];
+      eigenvectors[3 * j + 1][i] = evec[j][1];
+      eigenvectors[3 * j + 2][i] = evec[j][2];
+      }
+    }
+}
@@ -32,6 +32,9 @@
 // VTK includes
 #include <vtkThreadedImageAlgorithm.h>
 
+// STD includes
+#include <vector>
+
 class vtkMatrix4x4;
 class vtkImageData;
 class VTK_Teem_EXPORT vtkDiffusionTensorMathematics : public vtkThreadedImageAlgorithm
@@ -80,6 +83,21 @@ public:
   vtkGetMacro(Operation,int);
   vtkSetClampMacro(Operation,int, VTK_TENS_TRACE, VTK_TENS_MEAN_DIFFUSIVITY);
 
+  ///
+  /// Additional scalar measures computed in the same pass as Operation,
+  /// from the same eigen decomposition of the tensors. Each additional
+  /// operation is output as a float point data array named after the
+  /// operation (see GetOperationAsString()) and scaled by ScaleFactor.
+  /// Color operations can't be additional operations.
+  void AddAdditionalOperation(int operation);
+  void RemoveAllAdditionalOperations();
+  int GetNumberOfAdditionalOperations();
+  int GetAdditionalOperation(int index);
+
+  ///
+  /// Return the name of an operation, e.g. "FractionalAnisotropy"
+  static const char* GetOperationAsString(int operation);
+
   ///
   /// Output the trace (sum of eigenvalues = sum along diagonal)
   void SetOperationToTrace()
@@ -268,6 +286,20 @@ public:
   //Description
   //Wrap function to teem eigen solver
   static int TeemEigenSolver(double **m, double *w, double **v);
+
+  /// Closed-form (non-iterative) eigen decomposition of a batch of
+  /// symmetric 3x3 tensors. Tensors are given as structure of arrays so that
+  /// the computation can be vectorized: tensors[k][i] is the unique
+  /// component k (xx, xy, xz, yy, yz, zz) of the i-th tensor.
+  /// Eigenvalues are sorted in decreasing order: eigenvalues[j][i] is the
+  /// j-th eigenvalue of the i-th tensor and eigenvectors[3*j+c][i] is the
+  /// component c of the associated unit eigenvector (right-handed basis).
+  /// Eigenvectors are not computed if \a eigenvectors is nullptr.
+  static void SymmetricEigenSolverBatch(vtkIdType numberOfTensors,
+                                        const double* const tensors[6],
+                                        double* const eigenvalues[3],
+                                        double* const eigenvectors[9]);
+
   void ComputeTensorIncrements(vtkImageData *imageData, vtkIdType incr[3]);
 
 protected:
@@ -285,6 +317,8 @@ protected:
   vtkMatrix4x4 *TensorRotationMatrix;
   int FixNegativeEigenvalues;
 
+  std::vector<int> AdditionalOperations;
+
   int RequestInformation (vtkInformation*,
                                   vtkInformationVector**,
                                   vtkInformationVector*) override;
@@ -302,6 +336,10 @@ protected:
   int RequestData(vtkInformation* request,
                           vtkInformationVector** inputVector,
                           vtkInformationVector* outputVector) override;
+
+  // Reimplemented to allocate the arrays of the additional operations.
+  void CopyAttributeData(vtkImageData* in, vtkImageData* out,
+                         vtkInformationVector** inputVector) override;
 private:
   vtkDiffusionTensorMathematics(const vtkDiffusionTensorMathematics&) = delete;
   void operator=(const vtkDiffusionTensorMathematics&) = delete;
@@ -30,6 +30,7 @@
 
 // VTK includes
 #include "vtkBitArray.h"
+#include <vtkByteSwap.h>
 #include "vtkCharArray.h"
 #include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
@@ -47,13 +48,280 @@
 #include "vtkUnsignedShortArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
+#include <vtk_zlib.h>
+#include <vtksys/Encoding.hxx>
+#include <vtksys/FStream.hxx>
 #include <vtksys/SystemTools.hxx>
 
 // Teem includes
 #include "teem/ten.h"
 
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
 vtkStandardNewMacro(vtkTeemNRRDReader);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Read-only file mapped in memory with copy-on-write semantic: filters
+// modifying the image in place get private copies of the modified pages.
+class MappedFile
+{
+public:
+  MappedFile() = default;
+  ~MappedFile()
+  {
+#ifdef _WIN32
+    if (this->Address)
+      {
+      UnmapViewOfFile(this->Address);
+      }
+#else
+    if (this->Address)
+      {
+      munmap(this->Address, this->Length);
+      }
+#endif
+  }
+
+  bool Map(const std::string& fileName)
+  {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(vtksys::Encoding::ToWide(fileName).c_str(), GENERIC_READ,
+      FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      {
+      return false;
+      }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+      {
+      CloseHandle(file);
+      return false;
+      }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+      {
+      return false;
+      }
+    this->Address = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    this->Length = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+      {
+      return false;
+      }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+      {
+      close(fd);
+      return false;
+      }
+    this->Length = static_cast<size_t>(fileStat.st_size);
+    void* address = mmap(nullptr, this->Length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    this->Address = (address == MAP_FAILED ? nullptr : address);
+#endif
+    return this->Address != nullptr;
+  }
+
+  void* Address{nullptr};
+  size_t Length{0};
+};
+
+//----------------------------------------------------------------------------
+// Arrays referencing mapped memory keep the mapping alive. The mapping is
+// released when the last array referencing it is deleted.
+std::mutex MappedArraysMutex;
+std::map<void*, std::shared_ptr<MappedFile> > MappedArrays;
+
+//----------------------------------------------------------------------------
+void ReleaseMappedArray(void* pointer)
+{
+  std::lock_guard<std::mutex> lock(MappedArraysMutex);
+  MappedArrays.erase(pointer);
+}
+
+//----------------------------------------------------------------------------
+bool IsMappedArray(vtkDataArray* array)
+{
+  if (!array || array->GetNumberOfTuples() == 0)
+    {
+    return false;
+    }
+  std::lock_guard<std::mutex> lock(MappedArraysMutex);
+  return MappedArrays.find(array->GetVoidPointer(0)) != MappedArrays.end();
+}
+
+//----------------------------------------------------------------------------
+// Returns the position in the file after the NRRD header (if skipHeader is
+// true) and after lineSkip additional lines. Returns -1 on error.
+vtkTypeInt64 GetDataStartPosition(const std::string& fileName, bool skipHeader, unsigned int lineSkip)
+{
+  vtksys::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  if (skipHeader)
+    {
+    // the header ends with an empty line
+    do
+      {
+      if (!std::getline(file, line))
+        {
+        return -1;
+        }
+      }
+    while (!line.empty() && line != "\r");
+    }
+  for (unsigned int lineIndex = 0; lineIndex < lineSkip; ++lineIndex)
+    {
+    if (!std::getline(file, line))
+      {
+      return -1;
+      }
+    }
+  return static_cast<vtkTypeInt64>(file.tellg());
+}
+
+//----------------------------------------------------------------------------
+// Reads voxel data from a data file. Raw data can be read at any position.
+// Gzip compressed data is decompressed on the fly and can only be read
+// forward: data before the requested position is decompressed and discarded.
+class DataFileReader
+{
+public:
+  DataFileReader(const std::string& fileName, vtkTypeInt64 dataOffset, bool compressed)
+    : File(fileName.c_str(), std::ios::in | std::ios::binary)
+    , DataOffset(dataOffset)
+    , Compressed(compressed)
+  {
+    memset(&this->Stream, 0, sizeof(this->Stream));
+    if (!this->File.good())
+      {
+      return;
+      }
+    this->File.seekg(dataOffset);
+    if (compressed)
+      {
+      this->InputBuffer.resize(1 << 16);
+      this->DiscardBuffer.resize(1 << 16);
+      // 15 + 32: maximum window size, automatic zlib or gzip header detection
+      this->Initialized = (inflateInit2(&this->Stream, 15 + 32) == Z_OK);
+      }
+    else
+      {
+      this->Initialized = true;
+      }
+  }
+
+  ~DataFileReader()
+  {
+    if (this->Compressed && this->Initialized)
+      {
+      inflateEnd(&this->Stream);
+      }
+  }
+
+  bool IsValid() const
+  {
+    return this->Initialized && this->File.good();
+  }
+
+  /// Read length bytes at position (relative to the beginning of the data).
+  bool Read(vtkTypeUInt64 position, char* buffer, vtkTypeUInt64 length)
+  {
+    if (!this->Compressed)
+      {
+      this->File.seekg(static_cast<std::streamoff>(this->DataOffset + position));
+      this->File.read(buffer, static_cast<std::streamsize>(length));
+      return !this->File.fail();
+      }
+    if (position < this->Position)
+      {
+      return false;
+      }
+    return this->Inflate(nullptr, position - this->Position)
+      && this->Inflate(buffer, length);
+  }
+
+private:
+  /// Decompress length bytes into buffer. Data is discarded if buffer is nullptr.
+  bool Inflate(char* buffer, vtkTypeUInt64 length)
+  {
+    while (length > 0)
+      {
+      char* output = (buffer ? buffer : &this->DiscardBuffer[0]);
+      const vtkTypeUInt64 maximumChunkSize = (buffer ? (1 << 30) : this->DiscardBuffer.size());
+      const uInt chunkSize = static_cast<uInt>(std::min(length, maximumChunkSize));
+      this->Stream.next_out = reinterpret_cast<Bytef*>(output);
+      this->Stream.avail_out = chunkSize;
+      while (this->Stream.avail_out > 0)
+        {
+        if (this->Stream.avail_in == 0)
+          {
+          this->File.read(&this->InputBuffer[0], static_cast<std::streamsize>(this->InputBuffer.size()));
+          std::streamsize count = this->File.gcount();
+          if (count <= 0)
+            {
+            return false;
+            }
+          this->Stream.next_in = reinterpret_cast<Bytef*>(&this->InputBuffer[0]);
+          this->Stream.avail_in = static_cast<uInt>(count);
+          }
+        int status = inflate(&this->Stream, Z_NO_FLUSH);
+        if (status == Z_STREAM_END)
+          {
+          // data may be stored as several concatenated gzip members
+          if (inflateReset(&this->Stream) != Z_OK)
+            {
+            return false;
+            }
+          }
+        else if (status != Z_OK && status != Z_BUF_ERROR)
+          {
+          return false;
+          }
+        }
+      if (buffer)
+        {
+        buffer += chunkSize;
+        }
+      length -= chunkSize;
+      this->Position += chunkSize;
+      }
+    return true;
+  }
+
+  vtksys::ifstream File;
+  vtkTypeInt64 DataOffset{0};
+  bool Compressed{false};
+  bool Initialized{false};
+  z_stream Stream;
+  vtkTypeUInt64 Position{0};
+  std::vector<char> InputBuffer;
+  std::vector<char> DiscardBuffer;
+};
+
+}
+
 //----------------------------------------------------------------------------
 vtkTeemNRRDReader::vtkTeemNRRDReader()
 {
@@ -66,6 +334,12 @@ vtkTeemNRRDReader::vtkTeemNRRDReader()
   this->PointDataType = -1;
   this->DataType = -1;
   this->NumberOfComponents = -1;
+  this->ReadRequestedExtent = true;
+  this->MemoryMapping = false;
+  this->OutputMemoryMapped = false;
+  this->DataFileOffset = 0;
+  this->DataCompressed = false;
+  this->DataByteSwap = false;
 }
 
 //----------------------------------------------------------------------------
@@ -349,6 +623,7 @@ void vtkTeemNRRDReader::ExecuteInformation()
     return;
     }
   this->CurrentFileName = this->GetFileName();
+  this->DataFileName.clear();
 
   nrrdNuke(this->nrrd); // nuke and reallocate to reset the state
   this->nrrd = nrrdNew();
@@ -664,10 +939,102 @@ void vtkTeemNRRDReader::ExecuteInformation()
       }
     }
 
+  this->UpdateDataFileInformation(nio);
+
   this->vtkImageReader2::ExecuteInformation();
   nio = nrrdIoStateNix(nio);
 }
 
+//----------------------------------------------------------------------------
+void vtkTeemNRRDReader::UpdateDataFileInformation(NrrdIoState* nio)
+{
+  this->DataFileName.clear();
+  this->DataFileOffset = 0;
+  this->DataCompressed = (nio->encoding == nrrdEncodingGzip);
+  this->DataByteSwap = false;
+
+  if (nio->encoding != nrrdEncodingRaw && nio->encoding != nrrdEncodingGzip)
+    {
+    return;
+    }
+  if (nio->dataFNFormat || nio->dataFNArr->len > 1)
+    {
+    // data is split into multiple files
+    return;
+    }
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
+  unsigned int rangeAxisNum = nrrdRangeAxesGet(this->nrrd, rangeAxisIdx);
+  if (rangeAxisNum > 1 || (rangeAxisNum == 1 && rangeAxisIdx[0] != 0))
+    {
+    // axes have to be permuted
+    return;
+    }
+  if (nrrdKind3DMaskedSymMatrix == this->nrrd->axis[0].kind
+    || nrrdKind3DSymMatrix == this->nrrd->axis[0].kind)
+    {
+    // tensors have to be expanded
+    return;
+    }
+  size_t numberOfComponentsInFile = (rangeAxisNum == 1 ? this->nrrd->axis[0].size : 1);
+  if (numberOfComponentsInFile != static_cast<size_t>(this->NumberOfComponents))
+    {
+    return;
+    }
+  if (this->DataCompressed && nio->byteSkip != 0)
+    {
+    // byte skip applies to the decompressed data, let nrrdLoad handle it
+    return;
+    }
+
+  bool attachedData = (nio->dataFNArr->len == 0);
+  std::string dataFileName = this->GetFileName();
+  if (!attachedData)
+    {
+    dataFileName = nio->dataFN[0];
+    if (!vtksys::SystemTools::FileIsFullPath(dataFileName))
+      {
+      // relative paths are relative to the header file
+      std::string headerDirectory = vtksys::SystemTools::GetFilenamePath(this->GetFileName());
+      std::string pathFromHeader = headerDirectory.empty() ? dataFileName : headerDirectory + "/" + dataFileName;
+      if (vtksys::SystemTools::FileExists(pathFromHeader, true))
+        {
+        dataFileName = pathFromHeader;
+        }
+      }
+    if (!vtksys::SystemTools::FileExists(dataFileName, true))
+      {
+      return;
+      }
+    }
+
+  vtkTypeInt64 dataOffset = GetDataStartPosition(dataFileName, attachedData, nio->lineSkip);
+  if (dataOffset < 0)
+    {
+    return;
+    }
+  vtkTypeInt64 dataSize = static_cast<vtkTypeInt64>(nrrdElementSize(this->nrrd) * nrrdElementNumber(this->nrrd));
+  vtkTypeInt64 fileSize = static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(dataFileName));
+  if (!this->DataCompressed)
+    {
+    // byte skip -1 means that the data is at the end of the file
+    dataOffset = (nio->byteSkip == -1 ? fileSize - dataSize : dataOffset + nio->byteSkip);
+    if (dataOffset < 0 || dataOffset + dataSize > fileSize)
+      {
+      return;
+      }
+    }
+
+#ifdef VTK_WORDS_BIGENDIAN
+  const int nativeEndian = airEndianBig;
+#else
+  const int nativeEndian = airEndianLittle;
+#endif
+  this->DataByteSwap = (nrrdElementSize(this->nrrd) > 1 && nio->endian != airEndianUnknown
+    && nio->endian != nativeEndian);
+  this->DataFileOffset = dataOffset;
+  this->DataFileName = dataFileName;
+}
+
 //----------------------------------------------------------------------------
 vtkImageData *vtkTeemNRRDReader::AllocateOutputData(vtkDataObject *out, vtkInformation* outInfo)
 {
@@ -725,8 +1092,9 @@ void vtkTeemNRRDReader::AllocatePointData(vtkImageData *out, vtkInformation* out
   int extent[6] = { 0, -1, 0, -1, 0, -1 };
   out->GetExtent(extent);
 
+  // memory mapped arrays cannot be resized
   if (pd && pd->GetDataType() == this->DataType
-    && pd->GetReferenceCount() == 1)
+    && pd->GetReferenceCount() == 1 && !IsMappedArray(pd))
     {
     pd->SetNumberOfComponents(this->GetNumberOfComponents());
     pd->SetNumberOfTuples(vtkIdType(extent[1] - extent[0] + 1)*
@@ -897,6 +1265,34 @@ int vtkTeemNRRDReader::tenSpaceDirectionReduce(Nrrd *nout, const Nrrd *nin, doub
 // are assumed to be the same as the file extent/order.
 void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInformation* outInfo)
 {
+  this->OutputMemoryMapped = false;
+  if (this->GetFileName() == nullptr)
+    {
+    vtkErrorMacro(<< "Either a FileName or FilePrefix must be specified.");
+    return;
+    }
+
+  // Raw and gzip encoded data is read directly from the data file,
+  // only the requested extent is read.
+  this->ExecuteInformation();
+  vtkImageData* outputImage = vtkImageData::SafeDownCast(output);
+  if (outputImage && !this->DataFileName.empty())
+    {
+    if (!this->ReadRequestedExtent && this->GetOutputInformation(0))
+      {
+      this->GetOutputInformation(0)->Set(
+        vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+        this->GetOutputInformation(0)->Get(
+          vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+      }
+    if (this->ReadDataFromFile(outputImage, outInfo))
+      {
+      return;
+      }
+    vtkWarningMacro("Read: Failed to read voxel data directly from " << this->DataFileName
+      << ", reading the whole image using nrrdLoad");
+    }
+
   if (this->GetOutputInformation(0))
     {
     this->GetOutputInformation(0)->Set(
@@ -907,12 +1303,6 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
 
   vtkImageData *imageData = this->AllocateOutputData(output, outInfo);
 
-  if (this->GetFileName() == nullptr)
-    {
-    vtkErrorMacro(<< "Either a FileName or FilePrefix must be specified.");
-    return;
-    }
-
   // Read in the this->nrrd.  Yes, this means that the header is being read
   // twice: once by ExecuteInformation, and once here
   if ( nrrdLoad(this->nrrd, this->GetFileName(), nullptr) != 0 )
@@ -1098,8 +1488,152 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
   nrrdEmpty(this->nrrd);
 }
 
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::ReadDataFromFile(vtkImageData* imageData, vtkInformation* outInfo)
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), extent);
+  vtkIdType numberOfTuples = 1;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    extent[2 * axis] = std::max(extent[2 * axis], this->DataExtent[2 * axis]);
+    extent[2 * axis + 1] = std::min(extent[2 * axis + 1], this->DataExtent[2 * axis + 1]);
+    numberOfTuples *= std::max(0, extent[2 * axis + 1] - extent[2 * axis] + 1);
+    }
+  imageData->SetExtent(extent);
+
+  vtkSmartPointer<vtkDataArray> array;
+
+  // The requested voxels are contiguous in the file if they span whole rows
+  // (or a single row) of whole slices (or a single slice).
+  const bool fullRows = (extent[0] == this->DataExtent[0] && extent[1] == this->DataExtent[1]);
+  const bool fullSlices = fullRows && extent[2] == this->DataExtent[2] && extent[3] == this->DataExtent[3];
+  const bool contiguous = fullSlices || (extent[4] == extent[5] && (fullRows || extent[2] == extent[3]));
+  if (this->MemoryMapping && !this->DataCompressed && !this->DataByteSwap
+    && contiguous && numberOfTuples > 0)
+    {
+    const vtkTypeInt64 elementSize = static_cast<vtkTypeInt64>(nrrdElementSize(this->nrrd));
+    const vtkTypeInt64 rowLength = this->DataExtent[1] - this->DataExtent[0] + 1;
+    const vtkTypeInt64 sliceLength = rowLength * (this->DataExtent[3] - this->DataExtent[2] + 1);
+    const vtkTypeInt64 firstVoxelIndex = (extent[4] - this->DataExtent[4]) * sliceLength
+      + (extent[2] - this->DataExtent[2]) * rowLength + (extent[0] - this->DataExtent[0]);
+    const vtkTypeInt64 offset = this->DataFileOffset + firstVoxelIndex * elementSize * this->NumberOfComponents;
+    const vtkTypeInt64 size = numberOfTuples * elementSize * this->NumberOfComponents;
+    std::shared_ptr<MappedFile> mapping = std::make_shared<MappedFile>();
+    // the mapping starts at a page boundary, so aligned offset means aligned data
+    if (offset % elementSize == 0 && mapping->Map(this->DataFileName)
+      && offset + size <= static_cast<vtkTypeInt64>(mapping->Length))
+      {
+      array = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(this->DataType));
+      array->SetNumberOfComponents(this->NumberOfComponents);
+      void* pointer = static_cast<char*>(mapping->Address) + offset;
+        {
+        std::lock_guard<std::mutex> lock(MappedArraysMutex);
+        MappedArrays[pointer] = mapping;
+        }
+      array->SetArrayFreeFunction(ReleaseMappedArray);
+      array->SetVoidArray(pointer, numberOfTuples * this->NumberOfComponents, 0,
+        vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+      this->OutputMemoryMapped = true;
+      }
+    }
+
+  if (!array)
+    {
+    array = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(this->DataType));
+    if (!array)
+      {
+      vtkErrorMacro("Could not allocate data type.");
+      return false;
+      }
+    array->SetNumberOfComponents(this->NumberOfComponents);
+    array->SetNumberOfTuples(numberOfTuples);
+    if (numberOfTuples > 0
+      && !this->ReadDataExtent(extent, static_cast<char*>(array->GetVoidPointer(0))))
+      {
+      return false;
+      }
+    }
+
+  array->SetName("NRRDImage");
+  this->SetOutputPointDataArray(imageData, outInfo, array);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::ReadDataExtent(const int extent[6], char* buffer)
+{
+  DataFileReader reader(this->DataFileName, this->DataFileOffset, this->DataCompressed);
+  if (!reader.IsValid())
+    {
+    return false;
+    }
+
+  const vtkTypeUInt64 elementSize = nrrdElementSize(this->nrrd);
+  const vtkTypeUInt64 voxelSize = elementSize * this->NumberOfComponents;
+  const vtkTypeUInt64 rowSize = voxelSize * (this->DataExtent[1] - this->DataExtent[0] + 1);
+  const vtkTypeUInt64 sliceSize = rowSize * (this->DataExtent[3] - this->DataExtent[2] + 1);
+  const vtkTypeUInt64 readRowSize = voxelSize * (extent[1] - extent[0] + 1);
+  const vtkTypeUInt64 rowOffset = voxelSize * (extent[0] - this->DataExtent[0]);
+
+  // Rows of a slice are read at once if they are contiguous in the file
+  const int numberOfRows = extent[3] - extent[2] + 1;
+  const int rowsPerRead = (readRowSize == rowSize ? numberOfRows : 1);
+  const vtkTypeUInt64 readSize = readRowSize * rowsPerRead;
+
+  char* output = buffer;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; j += rowsPerRead)
+      {
+      vtkTypeUInt64 position = sliceSize * (k - this->DataExtent[4])
+        + rowSize * (j - this->DataExtent[2]) + rowOffset;
+      if (!reader.Read(position, output, readSize))
+        {
+        return false;
+        }
+      output += readSize;
+      }
+    this->UpdateProgress(static_cast<double>(k - extent[4] + 1) / (extent[5] - extent[4] + 1));
+    }
+
+  if (this->DataByteSwap)
+    {
+    vtkByteSwap::SwapVoidRange(buffer, static_cast<size_t>(output - buffer) / elementSize, elementSize);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkTeemNRRDReader::SetOutputPointDataArray(vtkImageData* imageData, vtkInformation* outInfo, vtkDataArray* array)
+{
+  switch (this->PointDataType)
+    {
+    case vtkDataSetAttributes::SCALARS:
+      imageData->GetPointData()->SetScalars(array);
+      vtkDataObject::SetPointDataActiveScalarInfo(outInfo, this->DataType, this->GetNumberOfComponents());
+      break;
+    case vtkDataSetAttributes::VECTORS:
+      imageData->GetPointData()->SetVectors(array);
+      break;
+    case vtkDataSetAttributes::NORMALS:
+      imageData->GetPointData()->SetNormals(array);
+      break;
+    case vtkDataSetAttributes::TENSORS:
+      imageData->GetPointData()->SetTensors(array);
+      break;
+    default:
+      vtkErrorMacro("Unknown PointData Type.");
+      break;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkTeemNRRDReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "ReadRequestedExtent: " << this->ReadRequestedExtent << "\n";
+  os << indent << "MemoryMapping: " << this->MemoryMapping << "\n";
+  os << indent << "OutputMemoryMapped: " << this->OutputMemoryMapped << "\n";
+  os << indent << "DataFileName: " << this->DataFileName << "\n";
 }
@@ -46,6 +46,8 @@
 
 #include "teem/nrrd.h"
 
+class vtkDataArray;
+
 /// \brief Reads Nearly Raw Raster Data files.
 ///
 /// Reads Nearly Raw Raster Data files using the nrrdio library as used in ITK
@@ -133,6 +135,33 @@ public:
   vtkGetMacro(NumberOfComponents,int);
 
 
+  ///
+  /// Read only the requested update extent instead of the whole image.
+  /// Used only when the voxel data is stored raw or gzip compressed in a
+  /// single file and does not need axis permutation or tensor expansion,
+  /// otherwise the whole image is read. Default is true.
+  vtkSetMacro(ReadRequestedExtent, bool);
+  vtkGetMacro(ReadRequestedExtent, bool);
+  vtkBooleanMacro(ReadRequestedExtent, bool);
+
+  ///
+  /// Map raw, uncompressed voxel data stored in native byte order directly
+  /// into the output image instead of copying it. Used when the requested
+  /// extent is contiguous in the file and the data is properly aligned.
+  /// The mapping is copy-on-write: modifying the output image does not modify
+  /// the file. However the file must not be overwritten or truncated while the
+  /// output image exists (accessing the image would then crash on Linux and
+  /// macOS, and the file is locked on Windows), so this must only be enabled
+  /// for files that are not saved again while loaded. Default is false.
+  vtkSetMacro(MemoryMapping, bool);
+  vtkGetMacro(MemoryMapping, bool);
+  vtkBooleanMacro(MemoryMapping, bool);
+
+  ///
+  /// Returns true if the output image of the last update references
+  /// memory mapped file data.
+  vtkGetMacro(OutputMemoryMapped, bool);
+
   ///
   /// Use image origin from the file
   void SetUseNativeOriginOn()
@@ -242,6 +271,20 @@ protected:
 
   static bool GetPointType(Nrrd* nrrdTemp, int& pointDataType, int &numOfComponents);
 
+  /// Determine where and how the voxel data is stored, to allow reading it
+  /// without nrrdLoad. Leaves DataFileName empty if it is not possible.
+  void UpdateDataFileInformation(NrrdIoState* nio);
+
+  /// Read the requested extent of the voxel data directly from the data file,
+  /// by memory mapping or by reading only the needed rows.
+  bool ReadDataFromFile(vtkImageData* imageData, vtkInformation* outInfo);
+
+  /// Read voxels of \a extent from the data file into \a buffer.
+  bool ReadDataExtent(const int extent[6], char* buffer);
+
+  /// Set \a array as the point data array of the output image.
+  void SetOutputPointDataArray(vtkImageData* imageData, vtkInformation* outInfo, vtkDataArray* array);
+
   vtkSmartPointer<vtkMatrix4x4> RasToIjkMatrix;
   vtkSmartPointer<vtkMatrix4x4> MeasurementFrameMatrix;
   vtkSmartPointer<vtkMatrix4x4> NRRDWorldToRasMatrix;
@@ -257,6 +300,16 @@ protected:
   int NumberOfComponents;
   bool UseNativeOrigin;
 
+  bool ReadRequestedExtent;
+  bool MemoryMapping;
+  bool OutputMemoryMapped;
+
+  /// Voxel data location, empty file name if data cannot be read directly
+  std::string DataFileName;
+  vtkTypeInt64 DataFileOffset;
+  bool DataCompressed;
+  bool DataByteSwap;
+
   std::map <std::string, std::string> HeaderKeyValue;
   std::string HeaderKeys; // buffer for returning key list
 
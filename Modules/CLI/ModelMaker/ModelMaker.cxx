@@ -43,12 +43,14 @@ Version:   $Revision$
 #include <vtkGeometryFilter.h>
 #include <vtkImageAccumulate.h>
 #include <vtkImageChangeInformation.h>
+#include <vtkImageClip.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageData.h>
 #include <vtkImageThreshold.h>
 #include <vtkImageToStructuredPoints.h>
 #include <vtkInformation.h>
 #include <vtkLookupTable.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkPolyDataNormals.h>
@@ -59,6 +61,7 @@ Version:   $Revision$
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkStripper.h>
 #include <vtkThreshold.h>
+#include <vtkTimerLog.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkUnstructuredGrid.h>
@@ -67,6 +70,612 @@ Version:   $Revision$
 // VTKsys includes
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Time spent in each stage of the model generation, in seconds
+struct ModelMakerTimings
+{
+  ModelMakerTimings()
+    : Threshold(0.0), MarchingCubes(0.0), Decimation(0.0), Smoothing(0.0), Normals(0.0), Writing(0.0)
+  {
+  }
+
+  void Add(const ModelMakerTimings& other)
+  {
+    this->Threshold += other.Threshold;
+    this->MarchingCubes += other.MarchingCubes;
+    this->Decimation += other.Decimation;
+    this->Smoothing += other.Smoothing;
+    this->Normals += other.Normals;
+    this->Writing += other.Writing;
+  }
+
+  double Threshold;
+  double MarchingCubes;
+  double Decimation;
+  double Smoothing;
+  double Normals;
+  double Writing;
+};
+
+//----------------------------------------------------------------------------
+/// Bounding box of the voxels of a label, in IJK coordinates
+struct LabelExtent
+{
+  int Extent[6];
+};
+
+//----------------------------------------------------------------------------
+/// Compute the bounding box of all the labels of the image in one pass.
+/// Consecutive voxels of a row that have the same label are processed at once.
+template <class T>
+void ComputeLabelExtents(vtkImageData* image, T* scalars, std::map<int, LabelExtent>& labelExtents)
+{
+  int extent[6];
+  image->GetExtent(extent);
+  int rowLength = extent[1] - extent[0] + 1;
+  std::map<int, LabelExtent>::iterator labelIt = labelExtents.end();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      T* row = scalars + (static_cast<vtkIdType>(k - extent[4]) * (extent[3] - extent[2] + 1) + (j - extent[2])) * rowLength;
+      int runStart = 0;
+      while (runStart < rowLength)
+        {
+        T value = row[runStart];
+        int runEnd = runStart + 1;
+        while (runEnd < rowLength && row[runEnd] == value)
+          {
+          ++runEnd;
+          }
+        int label = static_cast<int>(value);
+        if (static_cast<T>(label) == value)
+          {
+          if (labelIt == labelExtents.end() || labelIt->first != label)
+            {
+            labelIt = labelExtents.find(label);
+            }
+          int runExtent[6] = { extent[0] + runStart, extent[0] + runEnd - 1, j, j, k, k };
+          if (labelIt == labelExtents.end())
+            {
+            LabelExtent labelExtent;
+            std::copy(runExtent, runExtent + 6, labelExtent.Extent);
+            labelIt = labelExtents.insert(std::make_pair(label, labelExtent)).first;
+            }
+          else
+            {
+            int* labelExtent = labelIt->second.Extent;
+            for (int axis = 0; axis < 3; ++axis)
+              {
+              labelExtent[2 * axis] = std::min(labelExtent[2 * axis], runExtent[2 * axis]);
+              labelExtent[2 * axis + 1] = std::max(labelExtent[2 * axis + 1], runExtent[2 * axis + 1]);
+              }
+            }
+          }
+        runStart = runEnd;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Extent that needs to be thresholded to extract the surface of a label: its
+/// bounding box with a margin of one voxel so that the surface is closed,
+/// clipped to the extent of the (padded) input image.
+void GetLabelThresholdExtent(const LabelExtent& labelExtent, const int imageExtent[6], bool pad, int thresholdExtent[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    thresholdExtent[2 * axis] = labelExtent.Extent[2 * axis] - 1;
+    thresholdExtent[2 * axis + 1] = labelExtent.Extent[2 * axis + 1] + 1;
+    if (!pad)
+      {
+      thresholdExtent[2 * axis] = std::max(thresholdExtent[2 * axis], imageExtent[2 * axis]);
+      thresholdExtent[2 * axis + 1] = std::min(thresholdExtent[2 * axis + 1], imageExtent[2 * axis + 1]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Binary image of a label (200 inside, 0 outside), on the given extent of
+/// the input image. Voxels outside of the input image are set to 0.
+template <class T>
+void ThresholdLabel(vtkImageData* image, T* scalars, int label, vtkImageData* output)
+{
+  int imageExtent[6];
+  image->GetExtent(imageExtent);
+  int outputExtent[6];
+  output->GetExtent(outputExtent);
+  unsigned char* outputScalars = static_cast<unsigned char*>(output->GetScalarPointer());
+  for (int k = outputExtent[4]; k <= outputExtent[5]; ++k)
+    {
+    for (int j = outputExtent[2]; j <= outputExtent[3]; ++j)
+      {
+      for (int i = outputExtent[0]; i <= outputExtent[1]; ++i, ++outputScalars)
+        {
+        if (i < imageExtent[0] || i > imageExtent[1]
+          || j < imageExtent[2] || j > imageExtent[3]
+          || k < imageExtent[4] || k > imageExtent[5])
+          {
+          *outputScalars = 0;
+          continue;
+          }
+        vtkIdType index = (static_cast<vtkIdType>(k - imageExtent[4]) * (imageExtent[3] - imageExtent[2] + 1)
+          + (j - imageExtent[2])) * (imageExtent[1] - imageExtent[0] + 1) + (i - imageExtent[0]);
+        *outputScalars = (scalars[index] == static_cast<T>(label) ? 200 : 0);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+std::string GetModelFileName(const std::string& rootDir, const std::string& labelName)
+{
+  if (rootDir != "")
+    {
+    return rootDir + std::string("/") + labelName + std::string(".vtk");
+    }
+  return labelName + std::string(".vtk");
+}
+
+//----------------------------------------------------------------------------
+/// Header written in model files, to identify the input volume and the
+/// parameters the model was generated with.
+std::string GetModelFileHeader(const std::string& inputVolumeStamp, int label, int smooth,
+  const std::string& filterType, double decimate, bool splitNormals, bool pointNormals, bool pad)
+{
+  if (filterType == "Sinc" && smooth == 1)
+    {
+    // Sinc filter requires at least 2 iterations
+    smooth = 2;
+    }
+  std::stringstream header;
+  header << "ModelMaker input=" << inputVolumeStamp << " label=" << label << " smooth=" << smooth
+         << " filter=" << filterType << " decimate=" << decimate << " splitNormals=" << splitNormals
+         << " pointNormals=" << pointNormals << " pad=" << pad;
+  return header.str();
+}
+
+//----------------------------------------------------------------------------
+/// Returns true if the model file exists and has been written with the same header.
+bool IsModelFileUpToDate(const std::string& fileName, const std::string& header)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+    return false;
+    }
+  // second line of VTK legacy files is the header
+  std::string line;
+  if (!std::getline(file, line) || !std::getline(file, line))
+    {
+    return false;
+    }
+  if (!line.empty() && line[line.size() - 1] == '\r')
+    {
+    line.erase(line.size() - 1);
+    }
+  return line == header;
+}
+
+//----------------------------------------------------------------------------
+/// Generates the models of labels independently of each other, from the
+/// input image cropped to the bounding box of each label. Each label is
+/// processed by its own pipeline so that several labels can be processed at
+/// the same time by a pool of worker threads. Same filters and parameters as
+/// the sequential generation without joint smoothing.
+class LabelModelGenerator
+{
+public:
+  enum Status
+    {
+    NotGenerated,
+    UpToDate,
+    Generated,
+    NoPolygons,
+    Failed
+    };
+
+  struct Task
+  {
+    int Label;
+    std::string LabelName;
+    std::string FileName;
+    std::string Header;
+  };
+
+  LabelModelGenerator(vtkImageData* image, const std::map<int, LabelExtent>& labelExtents,
+    vtkMatrix4x4* ijkToRAS, const std::vector<Task>& tasks, std::vector<int>& status)
+    : Image(image)
+    , Scalars(image->GetScalarPointer())
+    , LabelExtents(labelExtents)
+    , IJKToRAS(ijkToRAS)
+    , Tasks(tasks)
+    , TaskStatus(status)
+  {
+    this->Smooth = 10;
+    this->Decimate = 0.25;
+    this->SplitNormals = true;
+    this->PointNormals = true;
+    this->Pad = true;
+  }
+
+  /// Generate the models of all the tasks that are not up-to-date using
+  /// numberOfThreads worker threads. Meanwhile, the calling thread reports
+  /// the progress, from progressStart to progressStart + progressFraction,
+  /// and forwards abort requests of the calling application to the workers.
+  /// Returns false if the generation was aborted, the tasks that were not
+  /// processed are left NotGenerated.
+  bool Run(unsigned int numberOfThreads, ModuleProcessInformation* processInformation,
+    double progressStart, double progressFraction)
+  {
+    this->NextTaskIndex = 0;
+    this->NumberOfFinishedTasks = 0;
+    this->NumberOfRunningThreads = std::max(numberOfThreads, 1u);
+    this->AbortRequested = false;
+    std::vector<ModelMakerTimings> threadTimings(std::max(numberOfThreads, 1u));
+    std::vector<std::thread> threads;
+    for (::size_t threadIndex = 0; threadIndex < threadTimings.size(); ++threadIndex)
+      {
+      threads.push_back(std::thread(&LabelModelGenerator::GenerateModels, this, std::ref(threadTimings[threadIndex])));
+      }
+
+    ::size_t numberOfReportedTasks = 0;
+    this->ReportProgress(processInformation, progressStart, progressFraction, numberOfReportedTasks);
+    {
+      std::unique_lock<std::mutex> lock(this->ProgressMutex);
+      while (this->NumberOfRunningThreads > 0)
+        {
+        this->ProgressCondition.wait_for(lock, std::chrono::milliseconds(100));
+        if (processInformation && processInformation->Abort)
+          {
+          this->AbortRequested = true;
+          }
+        if (this->NumberOfFinishedTasks != numberOfReportedTasks)
+          {
+          numberOfReportedTasks = this->NumberOfFinishedTasks;
+          this->ReportProgress(processInformation, progressStart, progressFraction, numberOfReportedTasks);
+          }
+        }
+    }
+
+    for (::size_t threadIndex = 0; threadIndex < threads.size(); ++threadIndex)
+      {
+      threads[threadIndex].join();
+      }
+    for (::size_t threadIndex = 0; threadIndex < threadTimings.size(); ++threadIndex)
+      {
+      this->TotalTimings.Add(threadTimings[threadIndex]);
+      }
+    return !this->AbortRequested;
+  }
+
+  /// Generate models until no task is left or the generation is aborted.
+  /// Tasks are taken one at a time so that threads processing small labels
+  /// take over more of them.
+  void GenerateModels(ModelMakerTimings& timings)
+  {
+    for (::size_t taskIndex = this->NextTaskIndex++; taskIndex < this->Tasks.size() && !this->AbortRequested;
+      taskIndex = this->NextTaskIndex++)
+      {
+      if (this->TaskStatus[taskIndex] == NotGenerated)
+        {
+        this->TaskStatus[taskIndex] = this->GenerateModel(this->Tasks[taskIndex], timings);
+        }
+      ++this->NumberOfFinishedTasks;
+      this->ProgressCondition.notify_one();
+      }
+    std::lock_guard<std::mutex> lock(this->ProgressMutex);
+    --this->NumberOfRunningThreads;
+    this->ProgressCondition.notify_one();
+  }
+
+  /// Report the progress to the calling application, the same way as
+  /// vtkPluginFilterWatcher does for a filter.
+  void ReportProgress(ModuleProcessInformation* processInformation, double progressStart,
+    double progressFraction, ::size_t numberOfFinishedTasks)
+  {
+    double stageProgress = (this->Tasks.empty() ? 1.0
+      : static_cast<double>(numberOfFinishedTasks) / static_cast<double>(this->Tasks.size()));
+    if (processInformation)
+      {
+      strncpy(processInformation->ProgressMessage, "Generate Models", 1023);
+      processInformation->Progress = progressStart + stageProgress * progressFraction;
+      processInformation->StageProgress = stageProgress;
+      if (processInformation->ProgressCallbackFunction && processInformation->ProgressCallbackClientData)
+        {
+        (*(processInformation->ProgressCallbackFunction))(processInformation->ProgressCallbackClientData);
+        }
+      }
+    else
+      {
+      std::cout << "<filter-progress>" << progressStart + stageProgress * progressFraction << "</filter-progress>\n"
+                << "<filter-stage-progress>" << stageProgress << "</filter-stage-progress>" << std::endl;
+      }
+  }
+
+  int GenerateModel(const Task& task, ModelMakerTimings& timings)
+  {
+    std::map<int, LabelExtent>::const_iterator labelExtentIt = this->LabelExtents.find(task.Label);
+    if (labelExtentIt == this->LabelExtents.end())
+      {
+      return NoPolygons;
+      }
+
+    // Threshold
+    double startTime = vtkTimerLog::GetUniversalTime();
+    int imageExtent[6];
+    this->Image->GetExtent(imageExtent);
+    int thresholdExtent[6];
+    GetLabelThresholdExtent(labelExtentIt->second, imageExtent, this->Pad, thresholdExtent);
+    vtkNew<vtkImageData> labelImage;
+    labelImage->SetExtent(thresholdExtent);
+    labelImage->SetOrigin(this->Image->GetOrigin());
+    labelImage->SetSpacing(this->Image->GetSpacing());
+    labelImage->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    switch (this->Image->GetScalarType())
+      {
+      vtkTemplateMacro(ThresholdLabel(this->Image, static_cast<VTK_TT*>(this->Scalars),
+        task.Label, labelImage.GetPointer()));
+      default:
+        return Failed;
+      }
+    timings.Threshold += vtkTimerLog::GetUniversalTime() - startTime;
+
+    // Marching cubes
+    startTime = vtkTimerLog::GetUniversalTime();
+#if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
+    vtkNew<vtkFlyingEdges3D> mcubes;
+#else
+    vtkNew<vtkMarchingCubes> mcubes;
+#endif
+    mcubes->SetInputData(labelImage.GetPointer());
+    mcubes->SetValue(0, 100.5);
+    mcubes->ComputeScalarsOff();
+    mcubes->ComputeGradientsOff();
+    mcubes->ComputeNormalsOff();
+    mcubes->Update();
+    timings.MarchingCubes += vtkTimerLog::GetUniversalTime() - startTime;
+    if (mcubes->GetOutput()->GetNumberOfPolys() == 0)
+      {
+      return NoPolygons;
+      }
+
+    // Decimation
+    startTime = vtkTimerLog::GetUniversalTime();
+    vtkNew<vtkDecimatePro> decimator;
+    decimator->SetInputConnection(mcubes->GetOutputPort());
+    decimator->SetFeatureAngle(60);
+    decimator->SplittingOff();
+    decimator->PreserveTopologyOn();
+    decimator->SetMaximumError(1);
+    decimator->SetTargetReduction(this->Decimate);
+    decimator->Update();
+    timings.Decimation += vtkTimerLog::GetUniversalTime() - startTime;
+
+    // Smoothing
+    startTime = vtkTimerLog::GetUniversalTime();
+    vtkSmartPointer<vtkPolyDataAlgorithm> surface = decimator.GetPointer();
+    if (this->IJKToRAS->Determinant() < 0)
+      {
+      vtkNew<vtkReverseSense> reverser;
+      reverser->SetInputConnection(decimator->GetOutputPort());
+      reverser->ReverseNormalsOn();
+      surface = reverser.GetPointer();
+      }
+    if (this->FilterType == "Sinc")
+      {
+      vtkNew<vtkWindowedSincPolyDataFilter> smootherSinc;
+      smootherSinc->SetPassBand(0.1);
+      smootherSinc->SetInputConnection(surface->GetOutputPort());
+      smootherSinc->SetNumberOfIterations(this->Smooth == 1 ? 2 : this->Smooth);
+      smootherSinc->FeatureEdgeSmoothingOff();
+      smootherSinc->BoundarySmoothingOff();
+      smootherSinc->Update();
+      surface = smootherSinc.GetPointer();
+      }
+    else
+      {
+      vtkNew<vtkSmoothPolyDataFilter> smootherPoly;
+      smootherPoly->SetRelaxationFactor(0.33);
+      smootherPoly->SetFeatureAngle(60);
+      smootherPoly->SetConvergence(0);
+      smootherPoly->SetInputConnection(surface->GetOutputPort());
+      smootherPoly->SetNumberOfIterations(this->Smooth);
+      smootherPoly->FeatureEdgeSmoothingOff();
+      smootherPoly->BoundarySmoothingOff();
+      smootherPoly->Update();
+      surface = smootherPoly.GetPointer();
+      }
+    timings.Smoothing += vtkTimerLog::GetUniversalTime() - startTime;
+
+    // Transform, normals and strips
+    startTime = vtkTimerLog::GetUniversalTime();
+    vtkNew<vtkTransform> transformIJKtoRAS;
+    transformIJKtoRAS->SetMatrix(this->IJKToRAS);
+    vtkNew<vtkTransformPolyDataFilter> transformer;
+    transformer->SetInputConnection(surface->GetOutputPort());
+    transformer->SetTransform(transformIJKtoRAS.GetPointer());
+    vtkNew<vtkPolyDataNormals> normals;
+    normals->SetComputePointNormals(this->PointNormals);
+    normals->SetInputConnection(transformer->GetOutputPort());
+    normals->SetFeatureAngle(60);
+    normals->SetSplitting(this->SplitNormals);
+    vtkNew<vtkStripper> stripper;
+    stripper->SetInputConnection(normals->GetOutputPort());
+    stripper->Update();
+    timings.Normals += vtkTimerLog::GetUniversalTime() - startTime;
+
+    // Write
+    startTime = vtkTimerLog::GetUniversalTime();
+    vtkNew<vtkPolyDataWriter> writer;
+    writer->SetInputConnection(stripper->GetOutputPort());
+    writer->SetFileType(2);
+    writer->SetHeader(task.Header.c_str());
+    writer->SetFileName(task.FileName.c_str());
+    int success = writer->Write();
+    timings.Writing += vtkTimerLog::GetUniversalTime() - startTime;
+    return success ? Generated : Failed;
+  }
+
+  int Smooth;
+  std::string FilterType;
+  double Decimate;
+  bool SplitNormals;
+  bool PointNormals;
+  bool Pad;
+  ModelMakerTimings TotalTimings;
+
+private:
+  vtkImageData* Image;
+  void* Scalars;
+  const std::map<int, LabelExtent>& LabelExtents;
+  vtkMatrix4x4* IJKToRAS;
+  const std::vector<Task>& Tasks;
+  std::vector<int>& TaskStatus;
+  std::atomic< ::size_t > NextTaskIndex;
+  std::atomic< ::size_t > NumberOfFinishedTasks;
+  std::atomic<bool> AbortRequested;
+  unsigned int NumberOfRunningThreads;
+  std::mutex ProgressMutex;
+  std::condition_variable ProgressCondition;
+};
+
+//----------------------------------------------------------------------------
+/// Add a model node, with its storage and display node, for a model file
+/// to the output scene, under the color hierarchy node matching the name of
+/// the label (if any) or else under the top level model hierarchy node.
+void AddModelToScene(vtkMRMLScene* modelScene, const std::string& labelName, const std::string& fileName,
+  int label, vtkMRMLColorTableNode* colorNode, vtkMRMLModelHierarchyNode* topColorHierarchyNode,
+  vtkMRMLNode* rnd, bool debug)
+{
+  if (debug)
+    {
+    std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str()
+              << endl;
+    }
+  // each model needs a mrml node, a storage node and a display node
+  vtkNew<vtkMRMLModelNode> mnode;
+  mnode->SetScene(modelScene);
+  mnode->SetName(labelName.c_str());
+
+  vtkNew<vtkMRMLModelStorageNode> snode;
+  snode->SetFileName(fileName.c_str());
+  if (modelScene->AddNode(snode.GetPointer()) == nullptr)
+    {
+    std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
+    }
+  vtkNew<vtkMRMLModelDisplayNode> dnode;
+  dnode->SetColor(0.5, 0.5, 0.5);
+  double *rgba;
+  if (colorNode != nullptr)
+    {
+    rgba = colorNode->GetLookupTable()->GetTableValue(label);
+    if (rgba != nullptr)
+      {
+      if (debug)
+        {
+        std::cout << "Got colour: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
+        }
+      dnode->SetColor(rgba[0], rgba[1], rgba[2]);
+      }
+    else
+      {
+      std::cerr << "Couldn't get look up table value for " << label << ", display node colour is not set (grey)"
+                << endl;
+      }
+    }
+
+  dnode->SetVisibility(1);
+  modelScene->AddNode(dnode.GetPointer());
+  if (debug)
+    {
+    std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
+    std::cout << "Setting model's storage node: id = "
+              << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
+    }
+  mnode->SetAndObserveStorageNodeID(snode->GetID());
+  mnode->SetAndObserveDisplayNodeID(dnode->GetID());
+  modelScene->AddNode(mnode.GetPointer());
+
+  // put it in the hierarchy, either the flat one by default or
+  // try to find the matching color hierarchy node to make this an
+  // associated node
+  std::string colorName;
+  if (colorNode != nullptr)
+    {
+    colorName = std::string(colorNode->GetColorNameAsFileName(label));
+    }
+  else
+    {
+    // might be in a testing case where the hierarchy nodes are
+    // numbered (made from the generic colors)
+    std::stringstream ss;
+    ss << label;
+    colorName = ss.str();
+    if (debug)
+      {
+      std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
+      }
+    }
+  vtkMRMLNode *mrmlNode = nullptr;
+  if (colorName.compare("") != 0)
+    {
+    mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
+    }
+  // if there's no color hierarchy, or no color name or the mrml node
+  // named for the color isn't a model hierarchy node, use a flat hierarchy
+  if (topColorHierarchyNode == nullptr ||
+      colorName.compare("") == 0 ||
+      mrmlNode == nullptr ||
+      strcmp(mrmlNode->GetClassName(),"vtkMRMLModelHierarchyNode") != 0)
+    {
+    vtkNew<vtkMRMLModelHierarchyNode> mhnd;
+    mhnd->SetHideFromEditors(1);
+    modelScene->AddNode(mhnd.GetPointer());
+    mhnd->SetParentNodeID(rnd->GetID());
+    mhnd->SetModelNodeID(mnode->GetID());
+    }
+  else
+    {
+    // use the template color hierarchy
+    vtkMRMLModelHierarchyNode *colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
+    if (colorHierarchyNode)
+      {
+      colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
+      // and hide it so that it doesn't clutter up the tree
+      colorHierarchyNode->SetHideFromEditors(1);
+      if (debug)
+        {
+        std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID() << std::endl;
+        }
+      }
+    }
+  if (debug)
+    {
+    std::cout << "...done adding model to output scene" << endl;
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
 int main(int argc, char * argv[])
 {
   PARSE_ARGS;
@@ -98,6 +707,8 @@ int main(int argc, char * argv[])
               << (ModelSceneFile.size() > 0 ? ModelSceneFile[0].c_str() : "None") << std::endl;
     std::cout << "Color table file : " << ColorTable.c_str() << std::endl;
     std::cout << "Save intermediate models: " << SaveIntermediateModels << std::endl;
+    std::cout << "Number of threads: " << NumberOfThreads << std::endl;
+    std::cout << "Skip existing models: " << SkipExisting << std::endl;
     std::cout << "Debug: " << debug << std::endl;
     std::cout << "\nStarting..." << std::endl;
     }
@@ -300,6 +911,7 @@ int main(int argc, char * argv[])
   vtkSmartPointer<vtkMarchingCubes>           mcubes;
 #endif
   vtkSmartPointer<vtkImageThreshold>          imageThreshold;
+  vtkSmartPointer<vtkImageClip>               imageClip;
   vtkSmartPointer<vtkThreshold>               threshold;
   vtkSmartPointer<vtkImageToStructuredPoints> imageToStructuredPoints;
   vtkSmartPointer<vtkGeometryFilter>          geometryFilter;
@@ -428,6 +1040,7 @@ int main(int argc, char * argv[])
     }
 
   // Read the file
+  double readStartTime = vtkTimerLog::GetUniversalTime();
   reader = vtkSmartPointer<vtkITKArchetypeImageSeriesScalarReader>::New();
   std::string            comment = "Read Volume";
   vtkPluginFilterWatcher watchReader(reader,
@@ -452,6 +1065,7 @@ int main(int argc, char * argv[])
 
   image = ici->GetOutput();
   ici->Update();
+  double readTime = vtkTimerLog::GetUniversalTime() - readStartTime;
 
   // add padding if flag is set
   if (Pad)
@@ -869,6 +1483,43 @@ int main(int argc, char * argv[])
     }
   transformIJKtoRAS->Inverse();
 
+  // Compute the bounding box of all the labels in one pass, the threshold
+  // and marching cubes are then only run on the bounding box of each label
+  double labelExtentsStartTime = vtkTimerLog::GetUniversalTime();
+  std::map<int, LabelExtent> labelExtents;
+  bool useLabelExtents = (JointSmoothing == 0 && image->GetNumberOfScalarComponents() == 1);
+  if (useLabelExtents)
+    {
+    switch (image->GetScalarType())
+      {
+      vtkTemplateMacro(ComputeLabelExtents(image, static_cast<VTK_TT*>(image->GetScalarPointer()), labelExtents));
+      default:
+        useLabelExtents = false;
+        break;
+      }
+    }
+  double labelExtentsTime = vtkTimerLog::GetUniversalTime() - labelExtentsStartTime;
+
+  // Labels are processed independently of each other, several at a time, when
+  // there is no joint smoothing. The models are then added to the scene in
+  // the order of the labels once all of them have been generated.
+  bool generateInParallel = (useLabelExtents && !SaveIntermediateModels && NumberOfThreads != 1);
+  std::vector<LabelModelGenerator::Task> parallelTasks;
+  std::vector<int>                       parallelTaskStatus;
+
+  // Models whose file was written from the same input volume with the same
+  // parameters are not generated again.
+  std::string inputVolumeStamp;
+  if (SkipExisting && JointSmoothing == 0 && InputVolume.find(std::string("slicer:")) != 0)
+    {
+    std::stringstream stamp;
+    stamp << std::hex << std::hash<std::string>()(InputVolume) << std::dec
+          << "-" << vtksys::SystemTools::FileLength(InputVolume)
+          << "-" << vtksys::SystemTools::ModifiedTime(InputVolume);
+    inputVolumeStamp = stamp.str();
+    }
+  ModelMakerTimings timings;
+
   //
   // Loop through all the labels
   //
@@ -999,6 +1650,38 @@ int main(int argc, char * argv[])
       */
       }
 
+    std::string modelFileName;
+    std::string modelFileHeader;
+    if (JointSmoothing == 0)
+      {
+      modelFileName = GetModelFileName(rootDir, labelName);
+      modelFileHeader = GetModelFileHeader(inputVolumeStamp, i, Smooth, FilterType, Decimate,
+                                           SplitNormals, PointNormals, Pad);
+      bool upToDate = (!inputVolumeStamp.empty() && IsModelFileUpToDate(modelFileName, modelFileHeader));
+      if (upToDate)
+        {
+        std::cout << "Model " << labelName << " is up-to-date in " << modelFileName << ", skipping." << endl;
+        }
+      if (generateInParallel)
+        {
+        LabelModelGenerator::Task task;
+        task.Label = i;
+        task.LabelName = labelName;
+        task.FileName = modelFileName;
+        task.Header = modelFileHeader;
+        parallelTasks.push_back(task);
+        parallelTaskStatus.push_back(upToDate ? LabelModelGenerator::UpToDate : LabelModelGenerator::NotGenerated);
+        continue;
+        }
+      if (upToDate)
+        {
+        currentFilterOffset += numRepeatedFilterSteps;
+        AddModelToScene(modelScene.GetPointer(), labelName, modelFileName, i, colorNode,
+                        topColorHierarchyNode, rnd, debug);
+        continue;
+        }
+      }
+
     // threshold
     if (JointSmoothing == 0)
       {
@@ -1020,7 +1703,37 @@ int main(int argc, char * argv[])
         {
         watchImageThreshold.QuietOn();
         }
-      if (Pad)
+      double thresholdStartTime = vtkTimerLog::GetUniversalTime();
+      std::map<int, LabelExtent>::const_iterator labelExtentIt = labelExtents.find(i);
+      if (useLabelExtents && labelExtentIt != labelExtents.end())
+        {
+        // only threshold the bounding box of the label
+        int thresholdExtent[6];
+        GetLabelThresholdExtent(labelExtentIt->second, extents, Pad, thresholdExtent);
+        if (imageClip)
+          {
+          imageClip->SetInputData(nullptr);
+          imageClip = nullptr;
+          }
+        imageClip = vtkSmartPointer<vtkImageClip>::New();
+        if (Pad)
+          {
+          // the padded image is shifted by 1 voxel
+          for (int e = 0; e < 6; ++e)
+            {
+            thresholdExtent[e] += 1;
+            }
+          imageClip->SetInputConnection(padder->GetOutputPort());
+          }
+        else
+          {
+          imageClip->SetInputData(image);
+          }
+        imageClip->SetOutputWholeExtent(thresholdExtent);
+        imageClip->ClipDataOn();
+        imageThreshold->SetInputConnection(imageClip->GetOutputPort());
+        }
+      else if (Pad)
         {
         imageThreshold->SetInputConnection(padder->GetOutputPort());
         }
@@ -1053,6 +1766,7 @@ int main(int argc, char * argv[])
         return EXIT_FAILURE;
         }
       imageToStructuredPoints->ReleaseDataFlagOn();
+      timings.Threshold += vtkTimerLog::GetUniversalTime() - thresholdStartTime;
       }
     else
       {
@@ -1128,6 +1842,7 @@ int main(int argc, char * argv[])
       mcubes->ComputeGradientsOff();
       mcubes->ComputeNormalsOff();
       mcubes->ReleaseDataFlagOn();
+      double marchingCubesStartTime = vtkTimerLog::GetUniversalTime();
       try
         {
         mcubes->Update();
@@ -1137,6 +1852,7 @@ int main(int argc, char * argv[])
         std::cerr << "ERROR while running marching cubes, for label " << i << std::endl;
         return EXIT_FAILURE;
         }
+      timings.MarchingCubes += vtkTimerLog::GetUniversalTime() - marchingCubesStartTime;
       if (debug)
         {
         std::cout << "\nNumber of polygons = " << (mcubes->GetOutput())->GetNumberOfPolys() << endl;
@@ -1257,6 +1973,7 @@ int main(int argc, char * argv[])
       // decimator->SetErrorIncrement(0.002);
       decimator->ReleaseDataFlagOff();
 
+      double decimationStartTime = vtkTimerLog::GetUniversalTime();
       try
         {
         decimator->Update();
@@ -1266,6 +1983,7 @@ int main(int argc, char * argv[])
         std::cerr << "ERROR decimating model " << i << std::endl;
         return EXIT_FAILURE;
         }
+      timings.Decimation += vtkTimerLog::GetUniversalTime() - decimationStartTime;
       if (debug)
         {
         std::cout << "After decimation, number of polygons = " << (decimator->GetOutput())->GetNumberOfPolys() << endl;
@@ -1382,6 +2100,7 @@ int main(int argc, char * argv[])
           smootherSinc->FeatureEdgeSmoothingOff();
           smootherSinc->BoundarySmoothingOff();
           smootherSinc->ReleaseDataFlagOn();
+          double smoothingStartTime = vtkTimerLog::GetUniversalTime();
           try
             {
             smootherSinc->Update();
@@ -1391,6 +2110,7 @@ int main(int argc, char * argv[])
             std::cerr << "ERROR updating Sinc smoother for model " << i << std::endl;
             return EXIT_FAILURE;
             }
+          timings.Smoothing += vtkTimerLog::GetUniversalTime() - smoothingStartTime;
           }
         else
           {
@@ -1429,6 +2149,7 @@ int main(int argc, char * argv[])
           smootherPoly->FeatureEdgeSmoothingOff();
           smootherPoly->BoundarySmoothingOff();
           smootherPoly->ReleaseDataFlagOn();
+          double smoothingStartTime = vtkTimerLog::GetUniversalTime();
           try
             {
             smootherPoly->Update();
@@ -1438,6 +2159,7 @@ int main(int argc, char * argv[])
             std::cerr << "ERROR updating Poly smoother for model " << i << std::endl;
             return EXIT_FAILURE;
             }
+          timings.Smoothing += vtkTimerLog::GetUniversalTime() - smoothingStartTime;
           }
 
         if (SaveIntermediateModels)
@@ -1584,6 +2306,7 @@ int main(int argc, char * argv[])
 
       // the poly data output from the stripper can be set as an input to a
       // model's polydata
+      double normalsStartTime = vtkTimerLog::GetUniversalTime();
       try
         {
         stripper->Update();
@@ -1593,6 +2316,7 @@ int main(int argc, char * argv[])
         std::cerr << "ERROR updating stripper for model " << i << std::endl;
         return EXIT_FAILURE;
         }
+      timings.Normals += vtkTimerLog::GetUniversalTime() - normalsStartTime;
 
       // but for now we're just going to write it out
       writer = vtkSmartPointer<vtkPolyDataWriter>::New();
@@ -1609,136 +2333,33 @@ int main(int argc, char * argv[])
         }
       writer->SetInputConnection(stripper->GetOutputPort());
       writer->SetFileType(2);
-      std::string fileName;
-      if (rootDir != "")
-        {
-        fileName = rootDir + std::string("/") + labelName + std::string(".vtk");
-        }
-      else
+      if (rootDir == "")
         {
         std::cout << "WARNING: output directory is an empty string..." << endl;
-        fileName = labelName + std::string(".vtk");
         }
+      std::string fileName = GetModelFileName(rootDir, labelName);
       writer->SetFileName(fileName.c_str());
+      if (!modelFileHeader.empty())
+        {
+        writer->SetHeader(modelFileHeader.c_str());
+        }
 
       if (debug)
         {
         std::cout << "Writing model " << " " << labelName << " to file " << writer->GetFileName()  << endl;
         }
+      double writingStartTime = vtkTimerLog::GetUniversalTime();
       if (!writer->Write())
         {
         std::cerr << "ERROR: Failed to write model file " << fileName.c_str() << std::endl;
         }
+      timings.Writing += vtkTimerLog::GetUniversalTime() - writingStartTime;
       writer->SetInputData(nullptr);
       writer = nullptr;
       if (modelScene.GetPointer() != nullptr)
         {
-        if (debug)
-          {
-          std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str()
-                    << endl;
-          }
-        // each model needs a mrml node, a storage node and a display node
-        vtkNew<vtkMRMLModelNode> mnode;
-        mnode->SetScene(modelScene.GetPointer());
-        mnode->SetName(labelName.c_str());
-
-        vtkNew<vtkMRMLModelStorageNode> snode;
-        snode->SetFileName(fileName.c_str());
-        if (modelScene->AddNode(snode.GetPointer()) == nullptr)
-          {
-          std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
-          }
-        vtkNew<vtkMRMLModelDisplayNode> dnode;
-        dnode->SetColor(0.5, 0.5, 0.5);
-        double *rgba;
-        if (colorNode != nullptr)
-          {
-          rgba = colorNode->GetLookupTable()->GetTableValue(i);
-          if (rgba != nullptr)
-            {
-            if (debug)
-              {
-              std::cout << "Got colour: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
-              }
-            dnode->SetColor(rgba[0], rgba[1], rgba[2]);
-            }
-          else
-            {
-            std::cerr << "Couldn't get look up table value for " << i << ", display node colour is not set (grey)"
-                      << endl;
-            }
-          }
-
-        dnode->SetVisibility(1);
-        modelScene->AddNode(dnode.GetPointer());
-        if (debug)
-          {
-          std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
-          std::cout << "Setting model's storage node: id = "
-                    << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
-          }
-        mnode->SetAndObserveStorageNodeID(snode->GetID());
-        mnode->SetAndObserveDisplayNodeID(dnode->GetID());
-        modelScene->AddNode(mnode.GetPointer());
-
-        // put it in the hierarchy, either the flat one by default or
-        // try to find the matching color hierarchy node to make this an
-        // associated node
-        std::string colorName;
-        if (colorNode != nullptr)
-          {
-          colorName = std::string(colorNode->GetColorNameAsFileName(i));
-          }
-        else
-          {
-          // might be in a testing case where the hierarchy nodes are
-          // numbered (made from the generic colors)
-          std::stringstream ss;
-          ss << i;
-          colorName = ss.str();
-          if (debug)
-            {
-            std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
-            }
-          }
-        vtkMRMLNode *mrmlNode = nullptr;
-        if (colorName.compare("") != 0)
-          {
-          mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
-          }
-        // if there's no color hierarchy, or no color name or the mrml node
-        // named for the color isn't a model hierarchy node, use a flat hierarchy
-        if (topColorHierarchyNode == nullptr ||
-            colorName.compare("") == 0 ||
-            mrmlNode == nullptr ||
-            strcmp(mrmlNode->GetClassName(),"vtkMRMLModelHierarchyNode") != 0)
-          {
-          vtkNew<vtkMRMLModelHierarchyNode> mhnd;
-          mhnd->SetHideFromEditors(1);
-          modelScene->AddNode(mhnd.GetPointer());
-          mhnd->SetParentNodeID(rnd->GetID());
-          mhnd->SetModelNodeID(mnode->GetID());
-          }
-        else
-          {
-          // use the template color hierarchy
-          vtkMRMLModelHierarchyNode *colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
-          if (colorHierarchyNode)
-            {
-            colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
-            // and hide it so that it doesn't clutter up the tree
-            colorHierarchyNode->SetHideFromEditors(1);
-            if (debug)
-              {
-              std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID() << std::endl;
-              }
-            }
-          }
-        if (debug)
-          {
-          std::cout << "...done adding model to output scene" << endl;
-          }
+        AddModelToScene(modelScene.GetPointer(), labelName, fileName, i, colorNode,
+                        topColorHierarchyNode, rnd, debug);
         }
       } // end of skipping an empty label
     }   // end of loop over labels
@@ -1746,6 +2367,57 @@ int main(int argc, char * argv[])
     {
     std::cout << "End of looping over labels" << endl;
     }
+
+  // Generate the models of the labels collected in the loop
+  if (!parallelTasks.empty())
+    {
+    vtkNew<vtkMatrix4x4> ijkToRASMatrix;
+    ijkToRASMatrix->DeepCopy(transformIJKtoRAS->GetMatrix());
+    if (FilterType == "Sinc" && Smooth == 1)
+      {
+      std::cerr << "Warning: Smoothing iterations of 1 not allowed for Sinc filter, using 2" << endl;
+      }
+    LabelModelGenerator generator(image, labelExtents, ijkToRASMatrix.GetPointer(), parallelTasks, parallelTaskStatus);
+    generator.Smooth = Smooth;
+    generator.FilterType = FilterType;
+    generator.Decimate = Decimate;
+    generator.SplitNormals = SplitNormals;
+    generator.PointNormals = PointNormals;
+    generator.Pad = Pad;
+    // 0 uses all the processors
+    unsigned int numberOfThreads = (NumberOfThreads > 0 ? static_cast<unsigned int>(NumberOfThreads)
+                                                        : std::thread::hardware_concurrency());
+    numberOfThreads = std::max(std::min(numberOfThreads, static_cast<unsigned int>(parallelTasks.size())), 1u);
+    std::cout << "Generating " << parallelTasks.size() << " models using "
+              << numberOfThreads << " threads" << endl;
+    bool completed = generator.Run(numberOfThreads, CLPProcessInformation, currentFilterOffset / numFilterSteps,
+                                   numRepeatedFilterSteps * parallelTasks.size() / numFilterSteps);
+    timings.Add(generator.TotalTimings);
+    currentFilterOffset += numRepeatedFilterSteps * parallelTasks.size();
+    if (!completed)
+      {
+      std::cerr << "Model generation aborted" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    for (::size_t t = 0; t < parallelTasks.size(); ++t)
+      {
+      const LabelModelGenerator::Task& task = parallelTasks[t];
+      if (parallelTaskStatus[t] == LabelModelGenerator::NoPolygons)
+        {
+        std::cout << "Cannot create a model from label " << task.Label
+                  << "\nNo polygons can be created,\nthere may be no voxels with this label in the volume." << endl;
+        std::cout << "...continuing" << endl;
+        continue;
+        }
+      if (parallelTaskStatus[t] == LabelModelGenerator::Failed)
+        {
+        std::cerr << "ERROR: Failed to write model file " << task.FileName.c_str() << std::endl;
+        }
+      AddModelToScene(modelScene.GetPointer(), task.LabelName, task.FileName, task.Label, colorNode,
+                      topColorHierarchyNode, rnd, debug);
+      }
+    }
   // Report what was done
   if (madeModels.size() > 0)
     {
@@ -1765,6 +2437,7 @@ int main(int argc, char * argv[])
       }
     std::cout << endl;
     }
+  double sceneTime = 0.0;
   if (sceneFilename != "")
     {
     if (debug)
@@ -1814,7 +2487,9 @@ int main(int argc, char * argv[])
         }
       }
     // write to disk
+    double sceneStartTime = vtkTimerLog::GetUniversalTime();
     modelScene->Commit();
+    sceneTime = vtkTimerLog::GetUniversalTime() - sceneStartTime;
     std::cout << "Models saved to scene file " << sceneFilename.c_str() << "\n";
     if (ModelSceneFile.size() == 0)
       {
@@ -1823,6 +2498,25 @@ int main(int argc, char * argv[])
       }
     }
 
+  // Report the time spent in each stage
+  std::cout << "Time spent in each stage (seconds"
+            << (parallelTasks.empty() ? "" : ", model generation stages are summed over all threads") << "):\n"
+            << "\tRead volume: " << readTime << "\n";
+  if (useLabelExtents)
+    {
+    std::cout << "\tLabel bounding boxes: " << labelExtentsTime << "\n";
+    }
+  if (JointSmoothing == 0)
+    {
+    std::cout << "\tThreshold: " << timings.Threshold << "\n"
+              << "\tMarching cubes: " << timings.MarchingCubes << "\n"
+              << "\tDecimation: " << timings.Decimation << "\n"
+              << "\tSmoothing: " << timings.Smoothing << "\n"
+              << "\tTransform, normals and strips: " << timings.Normals << "\n"
+              << "\tWrite models: " << timings.Writing << "\n";
+    }
+  std::cout << "\tWrite scene: " << sceneTime << std::endl;
+
   // Clean up
   if (debug)
     {
@@ -1909,6 +2603,15 @@ int main(int argc, char * argv[])
       std::cout << "... done deleting image threshold" << endl;
       }
     }
+  if (imageClip)
+    {
+    if (debug)
+      {
+      std::cout << "Deleting image clip" << endl;
+      }
+    imageClip->SetInputData(nullptr);
+    imageClip = nullptr;
+    }
   if (threshold)
     {
     if (debug)
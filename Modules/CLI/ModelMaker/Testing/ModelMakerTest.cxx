@@ -1,5 +1,16 @@
 #include "itkTestMain.h"
 
+// VTK includes
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataReader.h>
+
+// STD includes
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
 #ifdef WIN32
 #define MODULE_IMPORT __declspec(dllimport)
 #else
@@ -8,7 +19,80 @@
 
 extern "C" MODULE_IMPORT int ModuleEntryPoint(int, char * []);
 
+//----------------------------------------------------------------------------
+/// Check that two model files have the same cells and the same points, up to
+/// an optional tolerance (1e-4 by default).
+int CompareModels(int argc, char * argv[])
+{
+  if (argc < 3)
+    {
+    std::cerr << "Usage: " << argv[0] << " model1 model2 [tolerance]" << std::endl;
+    return EXIT_FAILURE;
+    }
+  double tolerance = (argc > 3 ? atof(argv[3]) : 1e-4);
+
+  vtkNew<vtkPolyDataReader> reader1;
+  reader1->SetFileName(argv[1]);
+  reader1->Update();
+  vtkPolyData* model1 = reader1->GetOutput();
+  vtkNew<vtkPolyDataReader> reader2;
+  reader2->SetFileName(argv[2]);
+  reader2->Update();
+  vtkPolyData* model2 = reader2->GetOutput();
+  if (model1->GetNumberOfPoints() == 0 || model2->GetNumberOfPoints() == 0)
+    {
+    std::cerr << "Failed to read models " << argv[1] << " and " << argv[2] << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (model1->GetNumberOfPoints() != model2->GetNumberOfPoints()
+    || model1->GetNumberOfCells() != model2->GetNumberOfCells())
+    {
+    std::cerr << "Number of points or cells mismatch: " << model1->GetNumberOfPoints() << " points, "
+              << model1->GetNumberOfCells() << " cells in " << argv[1] << ", "
+              << model2->GetNumberOfPoints() << " points, " << model2->GetNumberOfCells()
+              << " cells in " << argv[2] << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (vtkIdType pointId = 0; pointId < model1->GetNumberOfPoints(); ++pointId)
+    {
+    double point1[3];
+    double point2[3];
+    model1->GetPoint(pointId, point1);
+    model2->GetPoint(pointId, point2);
+    for (int i = 0; i < 3; ++i)
+      {
+      if (std::fabs(point1[i] - point2[i]) > tolerance)
+        {
+        std::cerr << "Point " << pointId << " mismatch: (" << point1[0] << ", " << point1[1] << ", " << point1[2]
+                  << ") != (" << point2[0] << ", " << point2[1] << ", " << point2[2] << ")" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  vtkNew<vtkIdList> cellPointIds1;
+  vtkNew<vtkIdList> cellPointIds2;
+  for (vtkIdType cellId = 0; cellId < model1->GetNumberOfCells(); ++cellId)
+    {
+    model1->GetCellPoints(cellId, cellPointIds1.GetPointer());
+    model2->GetCellPoints(cellId, cellPointIds2.GetPointer());
+    bool sameCell = (model1->GetCellType(cellId) == model2->GetCellType(cellId)
+      && cellPointIds1->GetNumberOfIds() == cellPointIds2->GetNumberOfIds());
+    for (vtkIdType i = 0; sameCell && i < cellPointIds1->GetNumberOfIds(); ++i)
+      {
+      sameCell = (cellPointIds1->GetId(i) == cellPointIds2->GetId(i));
+      }
+    if (!sameCell)
+      {
+      std::cerr << "Cell " << cellId << " mismatch" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
 void RegisterTests()
 {
   StringToTestFunctionMap["ModuleEntryPoint"] = ModuleEntryPoint;
+  StringToTestFunctionMap["CompareModels"] = CompareModels;
 }
@@ -0,0 +1,76 @@
+# test_cmd .........: command to run without args
+# test_name ........: name of the test found in the testing wrapper <test_cmd>
+# input_volume .....: label volume the models are generated from
+# output_dir .......: directory where the models are written
+#
+# Models are generated one after the other, then by several threads. The
+# models generated by threads must match the others, and must not be
+# generated again when running a second time with the same parameters. The
+# progress of the threaded generation must be reported.
+
+# Sanity checks
+set(expected_defined_vars test_cmd test_name input_volume output_dir)
+foreach(var ${expected_defined_vars})
+  if(NOT ${var})
+    message(FATAL_ERROR "Variable ${var} not defined !")
+  endif()
+endforeach()
+
+set(serial_dir ${output_dir}/Serial)
+set(threads_dir ${output_dir}/Threads)
+file(REMOVE_RECURSE ${serial_dir} ${threads_dir})
+file(MAKE_DIRECTORY ${serial_dir} ${threads_dir})
+
+macro(run_model_maker output_scene number_of_threads)
+  execute_process(
+    COMMAND ${test_cmd} ${test_name}
+      --generateAll
+      --numberOfThreads ${number_of_threads}
+      --skipExisting
+      --modelSceneFile ${output_scene}\#vtkMRMLModelHierarchyNode1
+      ${input_volume}
+    RESULT_VARIABLE exec_not_successful
+    OUTPUT_VARIABLE model_maker_output
+    )
+  if(exec_not_successful)
+    message(FATAL_ERROR "${test_cmd} failed with ${number_of_threads} threads:\n${model_maker_output}")
+  endif()
+endmacro()
+
+# Serial and threaded generation
+run_model_maker(${serial_dir}/ModelMakerThreadsTest.mrml 1)
+run_model_maker(${threads_dir}/ModelMakerThreadsTest.mrml 3)
+if(NOT model_maker_output MATCHES "models using 3 threads.*<filter-stage-progress>1</filter-stage-progress>")
+  message(SEND_ERROR "Progress of the threaded generation not reported:\n${model_maker_output}")
+endif()
+
+file(GLOB serial_models RELATIVE ${serial_dir} ${serial_dir}/*.vtk)
+list(LENGTH serial_models number_of_models)
+if(number_of_models EQUAL 0)
+  message(FATAL_ERROR "No model generated in ${serial_dir}")
+endif()
+foreach(model ${serial_models})
+  execute_process(
+    COMMAND ${test_cmd} CompareModels ${serial_dir}/${model} ${threads_dir}/${model}
+    RESULT_VARIABLE test_not_successful
+    )
+  if(test_not_successful)
+    message(SEND_ERROR "${threads_dir}/${model} does not match ${serial_dir}/${model}!")
+  endif()
+endforeach()
+
+# Models are up-to-date, they are only added to the scene
+file(REMOVE ${threads_dir}/ModelMakerThreadsTest.mrml)
+run_model_maker(${threads_dir}/ModelMakerThreadsTest.mrml 3)
+string(REGEX MATCHALL "is up-to-date in" skipped_models "${model_maker_output}")
+list(LENGTH skipped_models number_of_skipped_models)
+if(NOT number_of_skipped_models EQUAL number_of_models)
+  message(SEND_ERROR "${number_of_skipped_models} models skipped instead of ${number_of_models}:\n${model_maker_output}")
+endif()
+file(READ ${threads_dir}/ModelMakerThreadsTest.mrml output_scene)
+foreach(model ${serial_models})
+  string(FIND "${output_scene}" "${model}" model_position)
+  if(model_position EQUAL -1)
+    message(SEND_ERROR "${model} is missing from ${threads_dir}/ModelMakerThreadsTest.mrml")
+  endif()
+endforeach()
@@ -19,13 +19,16 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QDir>
 #include <QSettings>
+#include <QStandardPaths>
 
 // CTK includes
 #include <ctkColorDialog.h>
 
 // SlicerQt includes
 #include "qSlicerApplication.h"
+#include "qSlicerCommandOptions.h"
 #include "qSlicerCoreIOManager.h"
 #include "qSlicerNodeWriter.h"
 
@@ -89,27 +92,12 @@ void qSlicerColorsModule::setup()
     return;
     }
   vtkSlicerColorLogic* colorLogic = vtkSlicerColorLogic::SafeDownCast(this->logic());
-  if (this->appLogic() != nullptr)
-    {
-    this->appLogic()->SetColorLogic(colorLogic);
-    }
   app->coreIOManager()->registerIO(
     new qSlicerColorsReader(colorLogic, this));
   app->coreIOManager()->registerIO(new qSlicerNodeWriter(
     "Colors", QString("ColorTableFile"),
     QStringList() << "vtkMRMLColorNode", true, this));
 
-  QStringList paths = app->userSettings()->value("QTCoreModules/Colors/ColorFilePaths").toStringList();
-#ifdef Q_OS_WIN32
-  QString joinedPaths = paths.join(";");
-#else
-  QString joinedPaths = paths.join(":");
-#endif
-  // Warning: If the logic has already created the color nodes (AddDefaultColorNodes),
-  // setting the user color file paths doesn't trigger any action to add new nodes.
-  // It's something that must be fixed into the logic, not here
-  colorLogic->SetUserColorFilePaths(joinedPaths.toLatin1());
-
   // Color picker
   d->ColorDialogPickerWidget->setMRMLColorLogic(colorLogic);
   ctkColorDialog::addDefaultTab(d->ColorDialogPickerWidget.data(),
@@ -136,7 +124,38 @@ qSlicerAbstractModuleRepresentation * qSlicerColorsModule::createWidgetRepresent
 //-----------------------------------------------------------------------------
 vtkMRMLAbstractLogic* qSlicerColorsModule::createLogic()
 {
-  return vtkSlicerColorLogic::New();
+  vtkSlicerColorLogic* colorLogic = vtkSlicerColorLogic::New();
+  if (this->appLogic() != nullptr)
+    {
+    this->appLogic()->SetColorLogic(colorLogic);
+    }
+  // The logic is configured before it is given the scene: default color
+  // nodes are added as soon as the logic has a scene, even if the setup
+  // of the module is deferred.
+  qSlicerApplication * app = qSlicerApplication::application();
+  if (!app)
+    {
+    return colorLogic;
+    }
+  QStringList paths = app->userSettings()->value("QTCoreModules/Colors/ColorFilePaths").toStringList();
+#ifdef Q_OS_WIN32
+  QString joinedPaths = paths.join(";");
+#else
+  QString joinedPaths = paths.join(":");
+#endif
+  colorLogic->SetUserColorFilePaths(joinedPaths.toLatin1());
+
+  // Cache the parsed default color tables in the user cache directory. The
+  // file name is revision specific so that application versions installed
+  // side by side do not overwrite each other's cache.
+  QString cacheDirectory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if (!app->commandOptions()->settingsDisabled() && !cacheDirectory.isEmpty())
+    {
+    QString cacheFilePath = QDir(cacheDirectory).filePath(
+      QString("ColorTableCache-%1.bin").arg(app->repositoryRevision()));
+    colorLogic->SetColorTableCacheFileName(cacheFilePath.toUtf8());
+    }
+  return colorLogic;
 }
 
 //-----------------------------------------------------------------------------
@@ -123,11 +123,17 @@ void vtkSlicerCropVolumeLogic::PrintSelf(ostream& os, vtkIndent indent)
 //----------------------------------------------------------------------------
 void vtkSlicerCropVolumeLogic::RegisterNodes()
 {
-  if (!this->GetMRMLScene())
+  vtkSlicerCropVolumeLogic::RegisterNodeClasses(this->GetMRMLScene());
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCropVolumeLogic::RegisterNodeClasses(vtkMRMLScene* scene)
+{
+  if (!scene)
     {
     return;
     }
-  this->GetMRMLScene()->RegisterNodeClass(vtkSmartPointer<vtkMRMLCropVolumeParametersNode>::New());
+  scene->RegisterNodeClass(vtkSmartPointer<vtkMRMLCropVolumeParametersNode>::New());
 }
 
 //----------------------------------------------------------------------------
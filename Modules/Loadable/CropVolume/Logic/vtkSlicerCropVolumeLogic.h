@@ -108,6 +108,10 @@ public:
 
   void RegisterNodes() override;
 
+  /// Register the node classes of the module in \a scene.
+  /// Called by RegisterNodes(), and by the module before the logic is created.
+  static void RegisterNodeClasses(vtkMRMLScene* scene);
+
 protected:
   vtkSlicerCropVolumeLogic();
   ~vtkSlicerCropVolumeLogic() override;
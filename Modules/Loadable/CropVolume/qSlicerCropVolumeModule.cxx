@@ -138,3 +138,10 @@ QStringList qSlicerCropVolumeModule::associatedNodeTypes() const
 {
   return QStringList() << "vtkMRMLCropVolumeParametersNode";
 }
+
+//-----------------------------------------------------------------------------
+bool qSlicerCropVolumeModule::registerNodes(vtkMRMLScene* scene)
+{
+  vtkSlicerCropVolumeLogic::RegisterNodeClasses(scene);
+  return true;
+}
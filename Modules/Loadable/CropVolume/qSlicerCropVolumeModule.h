@@ -37,6 +37,9 @@ public:
   /// Specify editable node types
   QStringList associatedNodeTypes()const override;
 
+  /// Register the parameters node class without creating the logic
+  bool registerNodes(vtkMRMLScene* scene) override;
+
 protected:
   /// Initialize the module. Register the volumes reader/writer
   void setup() override;
@@ -20,6 +20,7 @@
 #include <vtkMRMLModelDisplayNode.h>
 #include <vtkMRMLModelHierarchyNode.h>
 #include <vtkMRMLModelNode.h>
+#include <vtkMRMLModelStorageNode.h>
 #include <vtkMRMLSelectionNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLSubjectHierarchyNode.h>
@@ -48,6 +49,7 @@ vtkCxxSetObjectMacro(vtkSlicerModelsLogic, ColorLogic, vtkMRMLColorLogic);
 vtkSlicerModelsLogic::vtkSlicerModelsLogic()
 {
   this->ColorLogic = nullptr;
+  this->MeshCacheEnabled = false;
 }
 
 //----------------------------------------------------------------------------
@@ -67,6 +69,42 @@ void vtkSlicerModelsLogic::SetMRMLSceneInternal(vtkMRMLScene* newScene)
   sceneEvents->InsertNextValue(vtkMRMLScene::NodeRemovedEvent);
   sceneEvents->InsertNextValue(vtkMRMLScene::EndImportEvent);
   this->SetAndObserveMRMLSceneEventsInternal(newScene, sceneEvents.GetPointer());
+  this->UpdateDefaultModelStorageNode();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerModelsLogic::SetMeshCacheEnabled(bool enabled)
+{
+  if (this->MeshCacheEnabled == enabled)
+    {
+    return;
+    }
+  this->MeshCacheEnabled = enabled;
+  this->UpdateDefaultModelStorageNode();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerModelsLogic::UpdateDefaultModelStorageNode()
+{
+  vtkMRMLScene* scene = this->GetMRMLScene();
+  if (!scene)
+    {
+    return;
+    }
+  vtkMRMLModelStorageNode* defaultStorageNode = vtkMRMLModelStorageNode::SafeDownCast(
+    scene->GetDefaultNodeByClass("vtkMRMLModelStorageNode"));
+  if (!defaultStorageNode)
+    {
+    if (!this->MeshCacheEnabled)
+      {
+      return;
+      }
+    vtkNew<vtkMRMLModelStorageNode> newDefaultStorageNode;
+    scene->AddDefaultNode(newDefaultStorageNode.GetPointer());
+    defaultStorageNode = newDefaultStorageNode.GetPointer();
+    }
+  defaultStorageNode->SetUseMeshCache(this->MeshCacheEnabled);
 }
 
 //----------------------------------------------------------------------------
@@ -261,6 +299,7 @@ vtkMRMLModelNode* vtkSlicerModelsLogic::AddModel (const char* filename)
   vtkNew<vtkMRMLModelStorageNode> mStorageNode;
   vtkNew<vtkMRMLFreeSurferModelStorageNode> fsmStorageNode;
   fsmStorageNode->SetUseStripper(0);  // turn off stripping by default (breaks some pickers)
+  mStorageNode->SetUseMeshCache(this->MeshCacheEnabled);
   vtkSmartPointer<vtkMRMLStorageNode> storageNode;
 
   // check for local or remote files
@@ -401,6 +440,7 @@ void vtkSlicerModelsLogic::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "ColorLogic: ";
     this->ColorLogic->PrintSelf(os, indent);
     }
+  os << indent << "MeshCacheEnabled: " << this->MeshCacheEnabled << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -75,6 +75,14 @@ class VTK_SLICER_MODELS_MODULE_LOGIC_EXPORT vtkSlicerModelsLogic
                               int transformNormals,
                               vtkMRMLModelNode *modelOut);
 
+  /// Enable/disable the binary mesh cache of model storage nodes created
+  /// by AddModel() or when a scene is loaded. The setting is applied to
+  /// the scene default vtkMRMLModelStorageNode.
+  /// Disabled by default.
+  /// \sa vtkMRMLModelStorageNode::SetUseMeshCache
+  void SetMeshCacheEnabled(bool enabled);
+  vtkGetMacro(MeshCacheEnabled, bool);
+
   /// Iterate through all models in the scene, find all their display nodes
   /// and set their visibility flag to flag. Does not touch model hierarchy
   /// nodes with display nodes
@@ -95,9 +103,14 @@ protected:
 
   void OnMRMLSceneEndImport() override;
 
+  /// Set UseMeshCache on the scene default model storage node.
+  void UpdateDefaultModelStorageNode();
+
 private:
   /// Color logic
   vtkMRMLColorLogic* ColorLogic;
+
+  bool MeshCacheEnabled;
 };
 
 #endif
@@ -18,6 +18,9 @@
 
 ==============================================================================*/
 
+// Qt includes
+#include <QSettings>
+
 // Models includes
 #include "qSlicerModelsModule.h"
 #include "qSlicerModelsModuleWidget.h"
@@ -148,6 +151,11 @@ void qSlicerModelsModule::setup()
         vtkMRMLColorLogic::SafeDownCast(colorsModule->logic());
       modelsLogic->SetColorLogic(colorLogic);
       }
+    // Cache parsed STL/OBJ/PLY/VTK meshes in the cache manager directory,
+    // if enabled in the application settings (disabled by default)
+    QSettings settings;
+    modelsLogic->SetMeshCacheEnabled(
+      settings.value("Models/MeshCache", false).toBool());
     // Register IOs
     qSlicerIOManager* ioManager = qSlicerApplication::application()->ioManager();
     ioManager->registerIO(new qSlicerModelsReader(modelsLogic, this));
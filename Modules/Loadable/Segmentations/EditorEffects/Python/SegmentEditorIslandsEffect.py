@@ -12,6 +12,10 @@ class SegmentEditorIslandsEffect(AbstractScriptedSegmentEditorEffect):
     scriptedEffect.name = 'Islands'
     AbstractScriptedSegmentEditorEffect.__init__(self, scriptedEffect)
     self.widgetToOperationNameMap = {}
+    # Island index of the selected segment and the labelmap it was last updated from
+    self.islandIndex = None
+    self.islandIndexLabelmap = None
+    self.islandIndexSegmentKey = None
 
   def clone(self):
     import qSlicerSegmentationsEditorEffectsPythonQt as effects
@@ -112,12 +116,81 @@ class SegmentEditorIslandsEffect(AbstractScriptedSegmentEditorEffect):
     operationName = self.scriptedEffect.parameter("Operation")
     minimumSize = self.scriptedEffect.integerParameter("MinimumSize")
     if operationName == KEEP_LARGEST_ISLAND:
-      self.splitSegments(minimumSize = minimumSize, maxNumberOfSegments = 1)
+      self.removeIslands(minimumSize = minimumSize, keepLargestIslandOnly = True)
     elif operationName == REMOVE_SMALL_ISLANDS:
-      self.splitSegments(minimumSize = minimumSize, split = False)
+      self.removeIslands(minimumSize = minimumSize)
     elif operationName == SPLIT_ISLANDS_TO_SEGMENTS:
       self.splitSegments(minimumSize = minimumSize)
 
+  def removeIslands(self, minimumSize = 0, keepLargestIslandOnly = False):
+    """
+    Remove islands from the selected segment without creating a label image for each island.
+    minimumSize: islands smaller than this are removed
+    keepLargestIslandOnly: if True then all islands except the largest one are removed
+    """
+    # This can be a long operation - indicate it to the user
+    qt.QApplication.setOverrideCursor(qt.Qt.WaitCursor)
+
+    self.scriptedEffect.saveStateForUndo()
+
+    # Islands are removed from a copy of the selected segment, in place
+    selectedSegmentLabelmap = self.scriptedEffect.selectedSegmentLabelmap()
+    modifierLabelmap = slicer.vtkOrientedImageData()
+    modifierLabelmap.DeepCopy(selectedSegmentLabelmap)
+
+    islandIndex = self.updateIslandIndex(modifierLabelmap)
+    islandCount = islandIndex.GetNumberOfIslands()
+    if keepLargestIslandOnly:
+      removedIslandCount = islandIndex.KeepLargestIsland(modifierLabelmap, minimumSize)
+    else:
+      removedIslandCount = islandIndex.RemoveSmallIslands(modifierLabelmap, minimumSize)
+    logging.info( "%d islands found (%d removed)" % (islandCount, removedIslandCount) )
+    # The index was updated along with the removed voxels, it describes the modified labelmap now.
+    # A copy is kept because the labelmap may be shared with the segment that is edited later.
+    self.islandIndexLabelmap = slicer.vtkOrientedImageData()
+    self.islandIndexLabelmap.DeepCopy(modifierLabelmap)
+
+    if removedIslandCount > 0:
+      self.scriptedEffect.modifySelectedSegmentByLabelmap(modifierLabelmap, slicer.qSlicerSegmentEditorAbstractEffect.ModificationModeSet)
+
+    qt.QApplication.restoreOverrideCursor()
+
+  def updateIslandIndex(self, labelmap):
+    """
+    Get an island index that describes the labelmap of the selected segment.
+    If the segment was already processed then only the extent that changed
+    since then is scanned again, otherwise the index is built from scratch.
+    """
+    segmentationNode = self.scriptedEffect.parameterSetNode().GetSegmentationNode()
+    segmentID = self.scriptedEffect.parameterSetNode().GetSelectedSegmentID()
+    segmentKey = (segmentationNode.GetID() if segmentationNode else None, segmentID)
+
+    previousLabelmap = self.islandIndexLabelmap
+    if (self.islandIndex is None or previousLabelmap is None or segmentKey != self.islandIndexSegmentKey
+        or previousLabelmap.GetExtent() != labelmap.GetExtent()
+        or previousLabelmap.GetScalarType() != labelmap.GetScalarType()):
+      self.islandIndex = vtkITK.vtkITKIslandIndex()
+      self.islandIndex.SetFullyConnected(False)
+      self.islandIndex.Build(labelmap)
+    else:
+      # Modified extent is the bounding box of the voxels that were added to or removed from
+      # the foreground since the index was last updated (label values are not distinguished)
+      difference = vtk.vtkImageLogic()
+      difference.SetOperationToXor()
+      difference.SetOutputTrueValue(1)
+      difference.SetInput1Data(labelmap)
+      difference.SetInput2Data(previousLabelmap)
+      difference.Update()
+      differenceLabelmap = slicer.vtkOrientedImageData()
+      differenceLabelmap.ShallowCopy(difference.GetOutput())
+      modifiedExtent = [0, -1, 0, -1, 0, -1]
+      if slicer.vtkOrientedImageDataResample.CalculateEffectiveExtent(differenceLabelmap, modifiedExtent):
+        self.islandIndex.UpdateExtent(labelmap, modifiedExtent)
+
+    self.islandIndexLabelmap = labelmap
+    self.islandIndexSegmentKey = segmentKey
+    return self.islandIndex
+
   def splitSegments(self, minimumSize = 0, maxNumberOfSegments = 0, split = True):
     """
     minimumSize: if 0 then it means that all islands are kept, regardless of size
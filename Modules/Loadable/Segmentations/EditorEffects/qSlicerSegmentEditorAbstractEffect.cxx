@@ -200,12 +200,16 @@ bool qSlicerSegmentEditorAbstractEffect::active()
 
 //-----------------------------------------------------------------------------
 void qSlicerSegmentEditorAbstractEffect::setCallbackSlots(QObject* receiver, const char* selectEffectSlot,
-  const char* updateVolumeSlot, const char* saveStateForUndoSlot)
+  const char* updateVolumeSlot, const char* saveStateForUndoSlot, const char* modifierLabelmapModifiedSlot/*=nullptr*/)
 {
   Q_D(qSlicerSegmentEditorAbstractEffect);
   QObject::connect(d, SIGNAL(selectEffectSignal(QString)), receiver, selectEffectSlot);
   QObject::connect(d, SIGNAL(updateVolumeSignal(void*,bool&)), receiver, updateVolumeSlot);
   QObject::connect(d, SIGNAL(saveStateForUndoSignal()), receiver, saveStateForUndoSlot);
+  if (modifierLabelmapModifiedSlot)
+    {
+    QObject::connect(d, SIGNAL(modifierLabelmapModifiedSignal(const QList<int>&)), receiver, modifierLabelmapModifiedSlot);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -271,6 +275,37 @@ void qSlicerSegmentEditorAbstractEffect::modifySegmentByLabelmap(vtkMRMLSegmenta
 
   vtkSmartPointer<vtkOrientedImageData> modifierLabelmap = modifierLabelmapInput;
 
+  // Only the modified region of the modifier labelmap needs to be processed
+  bool validModificationExtent = (modificationExtent[0] <= modificationExtent[1]
+    && modificationExtent[2] <= modificationExtent[3] && modificationExtent[4] <= modificationExtent[5]);
+  if (modifierLabelmapInput && validModificationExtent)
+    {
+    int* inputExtent = modifierLabelmapInput->GetExtent();
+    int croppedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    for (int i = 0; i < 3; ++i)
+      {
+      croppedExtent[2 * i] = std::max(modificationExtent[2 * i], inputExtent[2 * i]);
+      croppedExtent[2 * i + 1] = std::min(modificationExtent[2 * i + 1], inputExtent[2 * i + 1]);
+      }
+    if (croppedExtent[0] <= croppedExtent[1] && croppedExtent[2] <= croppedExtent[3] && croppedExtent[4] <= croppedExtent[5]
+      && !std::equal(croppedExtent, croppedExtent + 6, inputExtent))
+      {
+      modifierLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+      vtkOrientedImageDataResample::CopyImage(modifierLabelmapInput, modifierLabelmap, croppedExtent);
+      }
+    }
+  if (modifierLabelmapInput && modifierLabelmapInput == d->ModifierLabelmap.GetPointer())
+    {
+    // Let the editor know which region has to be cleared when the modifier labelmap is reset
+    int* modifiedExtent = validModificationExtent ? const_cast<int*>(modificationExtent) : modifierLabelmapInput->GetExtent();
+    QList<int> modifiedExtentList;
+    for (int i = 0; i < 6; ++i)
+      {
+      modifiedExtentList << modifiedExtent[i];
+      }
+    emit d->modifierLabelmapModifiedSignal(modifiedExtentList);
+    }
+
   // Apply mask to modifier labelmap if paint over is turned off
   if (!bypassMasking && parameterSetNode->GetMaskMode() != vtkMRMLSegmentEditorNode::PaintAllowedEverywhere)
     {
@@ -304,9 +339,11 @@ void qSlicerSegmentEditorAbstractEffect::modifySegmentByLabelmap(vtkMRMLSegmenta
       return;
       }
 
-    // Create threshold image
+    // Create threshold image, only in the region of the modifier labelmap
+    vtkNew<vtkOrientedImageData> masterVolumeRegion;
+    vtkOrientedImageDataResample::CopyImage(masterVolumeOrientedImageData, masterVolumeRegion.GetPointer(), modifierLabelmap->GetExtent());
     vtkSmartPointer<vtkImageThreshold> threshold = vtkSmartPointer<vtkImageThreshold>::New();
-    threshold->SetInputData(masterVolumeOrientedImageData);
+    threshold->SetInputData(masterVolumeRegion.GetPointer());
     threshold->ThresholdBetween(parameterSetNode->GetMasterVolumeIntensityMaskRange()[0], parameterSetNode->GetMasterVolumeIntensityMaskRange()[1]);
     threshold->SetInValue(1);
     threshold->SetOutValue(0);
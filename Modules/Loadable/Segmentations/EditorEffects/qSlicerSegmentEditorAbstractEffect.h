@@ -121,6 +121,10 @@ public:
   /// Returns true if the effect is currently active (activated and has not deactivated since then)
   Q_INVOKABLE virtual bool active();
 
+  /// Modify the selected segment by the modifier labelmap.
+  /// If a valid modificationExtent is specified then only that region of the modifier labelmap is
+  /// merged into the segment. Effects that use the default modifier labelmap must not modify voxels
+  /// outside the specified extent, as only this region is cleared when the modifier labelmap is reset.
   Q_INVOKABLE virtual void modifySelectedSegmentByLabelmap(vtkOrientedImageData* modifierLabelmap,
     ModificationMode modificationMode, const int modificationExtent[6],bool bypassMasking = false);
   Q_INVOKABLE virtual void modifySelectedSegmentByLabelmap(vtkOrientedImageData* modifierLabelmap,
@@ -254,7 +258,10 @@ public:
   /// \param selectEffectSlot called from the active effect to initiate switching to another effect (or de-select).
   /// \param updateVolumeSlot called to request update of a volume (modifierLabelmap, alignedMasterVolume, maskLabelmap).
   /// \param saveStateForUndoSlot called to request saving of segmentation state for undo operation
-  void setCallbackSlots(QObject* receiver, const char* selectEffectSlot, const char* updateVolumeSlot, const char* saveStateForUndoSlot);
+  /// \param modifierLabelmapModifiedSlot called with the extent of the modifier labelmap that an effect
+  ///   has modified, so that only this region has to be cleared when the modifier labelmap is reset
+  void setCallbackSlots(QObject* receiver, const char* selectEffectSlot, const char* updateVolumeSlot, const char* saveStateForUndoSlot,
+    const char* modifierLabelmapModifiedSlot = nullptr);
 
   /// Called by the editor widget.
   void setVolumes(vtkOrientedImageData* alignedMasterVolume, vtkOrientedImageData* modifierLabelmap,
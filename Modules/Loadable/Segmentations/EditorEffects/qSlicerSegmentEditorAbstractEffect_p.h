@@ -70,6 +70,7 @@ signals:
   void selectEffectSignal(QString);
   void updateVolumeSignal(void*,bool&);
   void saveStateForUndoSignal();
+  void modifierLabelmapModifiedSignal(const QList<int>&);
 public:
   /// Segment editor parameter set node
   vtkWeakPointer<vtkMRMLSegmentEditorNode> ParameterSetNode;
@@ -47,10 +47,8 @@
 #include <vtkGlyph2D.h>
 #include <vtkGlyph3D.h>
 #include <vtkIdList.h>
-#include <vtkImageChangeInformation.h>
 #include <vtkImageStencil.h>
 #include <vtkImageStencilData.h>
-#include <vtkImageStencilToImage.h>
 #include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -93,7 +91,6 @@
 #include "qSlicerApplication.h"
 #include "vtkMRMLSliceLogic.h"
 #include "vtkMRMLSliceLayerLogic.h"
-#include "vtkOrientedImageDataResample.h"
 
 //-----------------------------------------------------------------------------
 /// Visualization objects and pipeline for each slice view for the paint brush
@@ -220,8 +217,11 @@ public:
 qSlicerSegmentEditorPaintEffectPrivate::qSlicerSegmentEditorPaintEffectPrivate(qSlicerSegmentEditorPaintEffect& object)
   : q_ptr(&object)
   , MinimumPaintPointDistance2(0.0)
+  , BrushMaskRunsTime(0)
+  , BrushSweepStep(1.0)
   , DelayedPaint(true)
   , IsPainting(false)
+  , PaintStrokeHasLastPosition(false)
   , ActiveViewWidget(nullptr)
   , BrushDiameterFrame(nullptr)
   , BrushDiameterSpinBox(nullptr)
@@ -269,6 +269,9 @@ qSlicerSegmentEditorPaintEffectPrivate::qSlicerSegmentEditorPaintEffectPrivate(q
   this->ActiveViewLastInteractionPosition[1] = 0;
   this->ActiveViewLastPaintPosition[0] = 0;
   this->ActiveViewLastPaintPosition[1] = 0;
+  this->PaintStrokeLastPosition_World[0] = 0.0;
+  this->PaintStrokeLastPosition_World[1] = 0.0;
+  this->PaintStrokeLastPosition_World[2] = 0.0;
 }
 
 //-----------------------------------------------------------------------------
@@ -372,12 +375,13 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintApply(qMRMLWidget* viewWidget)
     this->paintBrushes(modifierLabelmap, viewWidget, this->PaintCoordinates_World, updateExtent);
     }
 
+  // Only the painted region is merged into the segment
   int modifierExtent[6] = { 0,-1,0,-1,0,-1 };
   modifierLabelmap->GetExtent(modifierExtent);
   for (int i = 0; i < 3; i++)
     {
-    updateExtent[2 * i] = std::min(updateExtent[2 * i], modifierExtent[2 * i]);
-    updateExtent[2 * i + 1] = std::max(updateExtent[2 * i + 1], modifierExtent[2 * i + 1]);
+    updateExtent[2 * i] = std::max(updateExtent[2 * i], modifierExtent[2 * i]);
+    updateExtent[2 * i + 1] = std::min(updateExtent[2 * i + 1], modifierExtent[2 * i + 1]);
     }
   for (int i = 0; i < 6; i++)
     {
@@ -553,6 +557,165 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintPixels(
   modifierLabelmap->Modified();
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerSegmentEditorPaintEffectPrivate::updateBrushMask()
+{
+  this->BrushPolyDataToStencil->Update();
+  vtkImageStencilData* stencilData = this->BrushPolyDataToStencil->GetOutput();
+  if (stencilData->GetMTime() == this->BrushMaskRunsTime)
+    {
+    return;
+    }
+  this->BrushMaskRunsTime = stencilData->GetMTime();
+  this->BrushMaskRuns.clear();
+
+  int stencilExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  stencilData->GetExtent(stencilExtent);
+  for (int k = stencilExtent[4]; k <= stencilExtent[5]; k++)
+    {
+    for (int j = stencilExtent[2]; j <= stencilExtent[3]; j++)
+      {
+      int iter = 0;
+      int iMin = 0;
+      int iMax = 0;
+      while (stencilData->GetNextExtent(iMin, iMax, stencilExtent[0], stencilExtent[1], j, k, iter))
+        {
+        BrushMaskRun run = { j, k, iMin, iMax };
+        this->BrushMaskRuns.push_back(run);
+        }
+      }
+    }
+
+  // Sweep step is half of the brush radius along the axes where the brush is more than one voxel wide
+  // (in slice views the brush is a thin cylinder), so that consecutive brush positions overlap.
+  double minimumHalfSize = VTK_DOUBLE_MAX;
+  for (int i = 0; i < 3; i++)
+    {
+    int size = stencilExtent[2 * i + 1] - stencilExtent[2 * i] + 1;
+    if (size > 3)
+      {
+      // stencil extent has a margin of one voxel on each side
+      minimumHalfSize = std::min(minimumHalfSize, (size - 2) * 0.5);
+      }
+    }
+  this->BrushSweepStep = (minimumHalfSize < VTK_DOUBLE_MAX ? std::max(1.0, minimumHalfSize * 0.5) : 1.0);
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerSegmentEditorPaintEffectPrivate::brushPositionsAlongStroke(
+  vtkPoints* strokePoints_Ijk, bool skipFirstPoint, std::vector<int>& brushPositions_Ijk)
+{
+  brushPositions_Ijk.clear();
+  vtkIdType numberOfPoints = strokePoints_Ijk->GetNumberOfPoints();
+  if (numberOfPoints == 0)
+    {
+    return;
+    }
+
+  int lastPosition[3] = { 0, 0, 0 };
+  double previousPoint[3] = { 0.0, 0.0, 0.0 };
+  strokePoints_Ijk->GetPoint(0, previousPoint);
+  for (int i = 0; i < 3; i++)
+    {
+    lastPosition[i] = static_cast<int>(std::floor(previousPoint[i] + 0.5));
+    }
+  if (!skipFirstPoint)
+    {
+    brushPositions_Ijk.insert(brushPositions_Ijk.end(), lastPosition, lastPosition + 3);
+    }
+
+  for (vtkIdType pointIndex = 1; pointIndex < numberOfPoints; pointIndex++)
+    {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    strokePoints_Ijk->GetPoint(pointIndex, point);
+    double distance = sqrt(vtkMath::Distance2BetweenPoints(previousPoint, point));
+    int numberOfSteps = std::max(1, static_cast<int>(std::ceil(distance / this->BrushSweepStep)));
+    for (int step = 1; step <= numberOfSteps; step++)
+      {
+      double t = static_cast<double>(step) / numberOfSteps;
+      int position[3] = { 0, 0, 0 };
+      for (int i = 0; i < 3; i++)
+        {
+        position[i] = static_cast<int>(std::floor(previousPoint[i] + t * (point[i] - previousPoint[i]) + 0.5));
+        }
+      if (position[0] == lastPosition[0] && position[1] == lastPosition[1] && position[2] == lastPosition[2])
+        {
+        // brush is already painted at this position
+        continue;
+        }
+      brushPositions_Ijk.insert(brushPositions_Ijk.end(), position, position + 3);
+      lastPosition[0] = position[0];
+      lastPosition[1] = position[1];
+      lastPosition[2] = position[2];
+      }
+    previousPoint[0] = point[0];
+    previousPoint[1] = point[1];
+    previousPoint[2] = point[2];
+    }
+}
+
+namespace
+{
+//-----------------------------------------------------------------------------
+template <class T>
+void PaintBrushMaskRuns(vtkImageData* image, T* imageScalars,
+  const std::vector<qSlicerSegmentEditorPaintEffectPrivate::BrushMaskRun>& brushMaskRuns,
+  const std::vector<int>& brushPositions_Ijk, double fillValue, int updateExtent[6])
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(extent);
+  vtkIdType increments[3] = { 0, 0, 0 };
+  image->GetIncrements(increments);
+  T value = static_cast<T>(fillValue);
+
+  bool painted = false;
+  int paintedExtent[6] = { VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+  for (size_t positionIndex = 0; positionIndex + 2 < brushPositions_Ijk.size(); positionIndex += 3)
+    {
+    const int* position = &brushPositions_Ijk[positionIndex];
+    for (const qSlicerSegmentEditorPaintEffectPrivate::BrushMaskRun& run : brushMaskRuns)
+      {
+      int j = run.J + position[1];
+      int k = run.K + position[2];
+      if (j < extent[2] || j > extent[3] || k < extent[4] || k > extent[5])
+        {
+        continue;
+        }
+      int iMin = std::max(run.IMin + position[0], extent[0]);
+      int iMax = std::min(run.IMax + position[0], extent[1]);
+      if (iMin > iMax)
+        {
+        continue;
+        }
+      T* voxel = imageScalars + (iMin - extent[0]) * increments[0]
+        + (j - extent[2]) * increments[1] + (k - extent[4]) * increments[2];
+      for (int i = iMin; i <= iMax; i++, voxel += increments[0])
+        {
+        // same as maximum operation of brush image and modifier labelmap
+        if (*voxel < value)
+          {
+          *voxel = value;
+          }
+        }
+      painted = true;
+      paintedExtent[0] = std::min(paintedExtent[0], iMin);
+      paintedExtent[1] = std::max(paintedExtent[1], iMax);
+      paintedExtent[2] = std::min(paintedExtent[2], j);
+      paintedExtent[3] = std::max(paintedExtent[3], j);
+      paintedExtent[4] = std::min(paintedExtent[4], k);
+      paintedExtent[5] = std::max(paintedExtent[5], k);
+      }
+    }
+  if (painted)
+    {
+    for (int i = 0; i < 6; i++)
+      {
+      updateExtent[i] = paintedExtent[i];
+      }
+    }
+}
+}
+
 //-----------------------------------------------------------------------------
 void qSlicerSegmentEditorPaintEffectPrivate::paintBrushes(
   vtkOrientedImageData* modifierLabelmap,
@@ -576,55 +739,38 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintBrushes(
     return;
     }
 
-  this->BrushPolyDataToStencil->Update();
-  vtkImageStencilData* stencilData = this->BrushPolyDataToStencil->GetOutput();
-  int stencilExtent[6]={0,-1,0,-1,0,-1};
-  stencilData->GetExtent(stencilExtent);
+  vtkIdType numberOfPoints = pixelPositions_World->GetNumberOfPoints();
+  if (numberOfPoints == 0)
+    {
+    return;
+    }
 
-  vtkNew<vtkPoints> paintCoordinates_Ijk;
-  this->transformPointsFromWorldToIJK(modifierLabelmap, segmentationNode, this->PaintCoordinates_World, paintCoordinates_Ijk);
+  this->updateBrushMask();
 
-  vtkNew<vtkImageStencilToImage> stencilToImage;
-  stencilToImage->SetInputConnection(this->BrushPolyDataToStencil->GetOutputPort());
-  stencilToImage->SetInsideValue(q->m_FillValue);
-  stencilToImage->SetOutsideValue(q->m_EraseValue);
-  stencilToImage->SetOutputScalarType(modifierLabelmap->GetScalarType());
+  // Sweep the brush from the last painted position of the stroke
+  vtkNew<vtkPoints> strokePoints_World;
+  if (this->PaintStrokeHasLastPosition)
+    {
+    strokePoints_World->InsertNextPoint(this->PaintStrokeLastPosition_World);
+    }
+  strokePoints_World->InsertPoints(strokePoints_World->GetNumberOfPoints(), numberOfPoints, 0, pixelPositions_World);
+  pixelPositions_World->GetPoint(numberOfPoints - 1, this->PaintStrokeLastPosition_World);
+  bool skipFirstPoint = this->PaintStrokeHasLastPosition;
+  this->PaintStrokeHasLastPosition = true;
 
-  vtkNew<vtkImageChangeInformation> brushPositioner;
-  brushPositioner->SetInputConnection(stencilToImage->GetOutputPort());
-  brushPositioner->SetOutputSpacing(modifierLabelmap->GetSpacing());
-  brushPositioner->SetOutputOrigin(modifierLabelmap->GetOrigin());
+  vtkNew<vtkPoints> strokePoints_Ijk;
+  this->transformPointsFromWorldToIJK(modifierLabelmap, segmentationNode, strokePoints_World, strokePoints_Ijk);
+  std::vector<int> brushPositions_Ijk;
+  this->brushPositionsAlongStroke(strokePoints_Ijk, skipFirstPoint, brushPositions_Ijk);
 
-  vtkIdType numberOfPoints = this->PaintCoordinates_World->GetNumberOfPoints();
-  for (int pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+  // Brush voxels are written directly into the modifier labelmap
+  switch (modifierLabelmap->GetScalarType())
     {
-    double* shiftDouble = paintCoordinates_Ijk->GetPoint(pointIndex);
-    int shift[3] = {int(shiftDouble[0]+0.5), int(shiftDouble[1]+0.5), int(shiftDouble[2]+0.5)};
-    brushPositioner->SetExtentTranslation(shift);
-    brushPositioner->Update();
-    vtkNew<vtkOrientedImageData> orientedBrushPositionerOutput;
-    orientedBrushPositionerOutput->ShallowCopy(brushPositioner->GetOutput());
-    orientedBrushPositionerOutput->CopyDirections(modifierLabelmap);
-    if (pointIndex == 0)
-      {
-      orientedBrushPositionerOutput->GetExtent(updateExtent);
-      }
-    else
-      {
-      int* brushExtent = orientedBrushPositionerOutput->GetExtent();
-      for (int i = 0; i < 3; i++)
-        {
-        if (brushExtent[i * 2] < updateExtent[i * 2])
-          {
-          updateExtent[i * 2] = brushExtent[i * 2];
-          }
-        if (brushExtent[i * 2 + 1] > updateExtent[i * 2 + 1])
-          {
-          updateExtent[i * 2 + 1] = brushExtent[i * 2 + 1];
-          }
-        }
-      }
-    vtkOrientedImageDataResample::ModifyImage(modifierLabelmap, orientedBrushPositionerOutput.GetPointer(), vtkOrientedImageDataResample::OPERATION_MAXIMUM);
+    vtkTemplateMacro(PaintBrushMaskRuns(modifierLabelmap, static_cast<VTK_TT*>(modifierLabelmap->GetScalarPointer()),
+      this->BrushMaskRuns, brushPositions_Ijk, q->m_FillValue, updateExtent));
+    default:
+      qCritical() << Q_FUNC_INFO << ": Unsupported modifier labelmap scalar type";
+      return;
     }
   modifierLabelmap->Modified();
 }
@@ -1226,6 +1372,7 @@ bool qSlicerSegmentEditorPaintEffect::processInteractionEvents(
   if (eid == vtkCommand::LeftButtonPressEvent && !shiftKeyPressed)
     {
     d->IsPainting = true;
+    d->PaintStrokeHasLastPosition = false;
     if (!this->integerParameter("BrushPixelMode"))
       {
       //this->cursorOff(sliceWidget);
@@ -1280,6 +1427,7 @@ bool qSlicerSegmentEditorPaintEffect::processInteractionEvents(
       }
     d->paintApply(viewWidget);
     d->IsPainting = false;
+    d->PaintStrokeHasLastPosition = false;
 
     QList<qMRMLWidget*> viewWidgets = d->BrushPipelines.keys();
     foreach (qMRMLWidget* viewWidget, viewWidgets)
@@ -51,6 +51,9 @@
 #include <QList>
 #include <QMap>
 
+// STD includes
+#include <vector>
+
 class BrushPipeline;
 class ctkDoubleSlider;
 class QPoint;
@@ -106,6 +109,14 @@ protected:
   /// Paint labelmap
   void paintApply(qMRMLWidget* viewWidget);
 
+  /// Update brush mask runs from the brush stencil.
+  /// The mask is only recomputed if the brush stencil has changed.
+  void updateBrushMask();
+
+  /// Get brush positions (in modifier labelmap IJK coordinates) along the stroke.
+  /// Brush positions are added between consecutive points so that there are no gaps in the stroke.
+  void brushPositionsAlongStroke(vtkPoints* strokePoints_Ijk, bool skipFirstPoint, std::vector<int>& brushPositions_Ijk);
+
   /// Paint brushes to the modifier labelmap
   void paintBrushes(vtkOrientedImageData* modifierLabelmap, qMRMLWidget* viewWidget, vtkPoints* pixelPositions_World, int extent[6]=nullptr);
 
@@ -134,6 +145,15 @@ public slots:
   void onDiameterValueChanged(double);
 
 public:
+  /// Run of brush voxels along the I axis, relative to the brush center
+  struct BrushMaskRun
+    {
+    int J;
+    int K;
+    int IMin;
+    int IMax;
+    };
+
   QIcon PaintIcon;
 
   vtkSmartPointer<vtkCylinderSource> BrushCylinderSource;
@@ -148,6 +168,12 @@ public:
   vtkSmartPointer<vtkTransform> WorldOriginToModifierLabelmapIjkTransform; // transforms from polydata source to modifierLabelmap's IJK coordinate system (brush origin in IJK origin)
   vtkSmartPointer<vtkPolyDataToImageStencil> BrushPolyDataToStencil;
 
+  // Brush shape in modifierLabelmap's IJK coordinate system, rasterized directly into the labelmap at each brush position
+  std::vector<BrushMaskRun> BrushMaskRuns;
+  vtkMTimeType BrushMaskRunsTime;
+  // Maximum distance between brush positions (in voxels) when sweeping the brush between stroke points
+  double BrushSweepStep;
+
   vtkSmartPointer<vtkGlyph3D> FeedbackGlyphFilter;
 
   vtkSmartPointer<vtkPoints> PaintCoordinates_World;
@@ -163,6 +189,11 @@ public:
   bool DelayedPaint;
   bool IsPainting;
 
+  // Last painted position of the current stroke. The brush is swept from this position
+  // to the next painted point, even if it is painted by a later paintApply call.
+  bool PaintStrokeHasLastPosition;
+  double PaintStrokeLastPosition_World[3];
+
   // Observed view node
   qMRMLWidget* ActiveViewWidget;
   int ActiveViewLastInteractionPosition[2];
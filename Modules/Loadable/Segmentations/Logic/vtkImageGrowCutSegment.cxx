@@ -1,5 +1,7 @@
 #include "vtkImageGrowCutSegment.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -10,6 +12,8 @@
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkTimerLog.h>
 
@@ -27,6 +31,204 @@ const int MaskPixelTypeID = VTK_UNSIGNED_CHAR;
 const NodeKeyValueType DIST_INF = std::numeric_limits<NodeKeyValueType>::max();
 const NodeKeyValueType DIST_EPSILON = 1e-3;
 
+//----------------------------------------------------------------------------
+// Monotone priority queue for shortest path computation (radix heap).
+//
+// Distances are non-negative floating-point values, therefore their bit patterns
+// (interpreted as unsigned integers) have the same ordering as the values themselves.
+// Items are stored in buckets based on the highest bit that differs from the last
+// extracted key. Since the extracted keys never decrease in Dijkstra's algorithm,
+// each item is moved to a lower bucket at most 32 times, and the items are extracted
+// in exactly the same order of distances as from a binary or Fibonacci heap.
+//
+// Items are not updated in the queue when their distance is decreased but a new item is
+// pushed instead, so only voxels that are actually reached need memory in the queue.
+class GrowCutBucketQueue
+{
+public:
+  GrowCutBucketQueue()
+  {
+    this->Clear();
+  }
+
+  /// Remove all items and release memory
+  void Clear()
+  {
+    for (int bucketIndex = 0; bucketIndex < NumberOfBuckets; bucketIndex++)
+      {
+      std::vector<Item>().swap(this->Buckets[bucketIndex]);
+      }
+    this->LastKey = 0;
+    this->Size = 0;
+  }
+
+  bool IsEmpty()
+  {
+    return this->Size == 0;
+  }
+
+  /// Add an item. Distance must not be smaller than the distance of the last extracted item.
+  inline void Push(NodeKeyValueType distance, NodeIndexType index)
+  {
+    Item item;
+    item.Key = KeyFromDistance(distance);
+    item.Index = index;
+    this->Buckets[this->GetBucketIndex(item.Key)].push_back(item);
+    this->Size++;
+  }
+
+  /// Extract an item with the smallest distance. Returns false if the queue is empty.
+  inline bool Pop(NodeKeyValueType& distance, NodeIndexType& index)
+  {
+    if (this->Size == 0)
+      {
+      return false;
+      }
+    if (this->Buckets[0].empty())
+      {
+      // Find the first non-empty bucket and redistribute its items
+      // based on its minimum key. All of them go to lower buckets.
+      int bucketIndex = 1;
+      while (this->Buckets[bucketIndex].empty())
+        {
+        bucketIndex++;
+        }
+      std::vector<Item>& bucket = this->Buckets[bucketIndex];
+      vtkTypeUInt32 minimumKey = bucket[0].Key;
+      for (const Item& item : bucket)
+        {
+        minimumKey = std::min(minimumKey, item.Key);
+        }
+      this->LastKey = minimumKey;
+      for (const Item& item : bucket)
+        {
+        this->Buckets[this->GetBucketIndex(item.Key)].push_back(item);
+        }
+      bucket.clear();
+      }
+    const Item& item = this->Buckets[0].back();
+    distance = DistanceFromKey(item.Key);
+    index = item.Index;
+    this->Buckets[0].pop_back();
+    this->Size--;
+    return true;
+  }
+
+protected:
+  struct Item
+    {
+    vtkTypeUInt32 Key;
+    NodeIndexType Index;
+    };
+
+  static const int NumberOfBuckets = 33;
+
+  static inline vtkTypeUInt32 KeyFromDistance(NodeKeyValueType distance)
+  {
+    vtkTypeUInt32 key = 0;
+    memcpy(&key, &distance, sizeof(key));
+    return key;
+  }
+
+  static inline NodeKeyValueType DistanceFromKey(vtkTypeUInt32 key)
+  {
+    NodeKeyValueType distance = 0;
+    memcpy(&distance, &key, sizeof(distance));
+    return distance;
+  }
+
+  /// Returns 0 for keys equal to the last extracted key, otherwise
+  /// the position of the highest bit that differs from the last extracted key (1-32).
+  inline int GetBucketIndex(vtkTypeUInt32 key)
+  {
+    vtkTypeUInt32 difference = key ^ this->LastKey;
+    int bucketIndex = 0;
+    if (difference >= (1u << 16)) { bucketIndex += 16; difference >>= 16; }
+    if (difference >= (1u << 8)) { bucketIndex += 8; difference >>= 8; }
+    if (difference >= (1u << 4)) { bucketIndex += 4; difference >>= 4; }
+    if (difference >= (1u << 2)) { bucketIndex += 2; difference >>= 2; }
+    if (difference >= (1u << 1)) { bucketIndex += 1; difference >>= 1; }
+    return bucketIndex + static_cast<int>(difference);
+  }
+
+  std::vector<Item> Buckets[NumberOfBuckets];
+  vtkTypeUInt32 LastKey;
+  vtkIdType Size;
+};
+
+//----------------------------------------------------------------------------
+// Initializes result labels and distances from the seeds and mask, in multiple threads.
+// Voxels where labels need to be propagated from are collected in each thread.
+template<typename LabelPixelType>
+class GrowCutSeedInitializer
+{
+public:
+  GrowCutSeedInitializer(LabelPixelType* seedLabels, MaskPixelType* maskLabels,
+    LabelPixelType* resultLabels, NodeKeyValueType* distances, bool incremental)
+    : SeedLabels(seedLabels)
+    , MaskLabels(maskLabels)
+    , ResultLabels(resultLabels)
+    , Distances(distances)
+    , Incremental(incremental)
+  {
+  }
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType beginIndex, vtkIdType endIndex)
+  {
+    std::vector<NodeIndexType>& seeds = this->Seeds.Local();
+    for (vtkIdType index = beginIndex; index < endIndex; index++)
+      {
+      LabelPixelType seedValue = this->SeedLabels[index];
+      if (this->Incremental)
+        {
+        // Only grow from new/changed seeds
+        if (seedValue != 0 &&
+          (this->ResultLabels[index] != seedValue // changed seed
+          || this->Distances[index] > DIST_EPSILON)) // new seed
+          {
+          this->Distances[index] = DIST_EPSILON;
+          this->ResultLabels[index] = seedValue;
+          seeds.push_back(static_cast<NodeIndexType>(index));
+          }
+        }
+      else if (this->MaskLabels && this->MaskLabels[index] != 0)
+        {
+        // masked region, small distance will prevent overwriting of masked voxels
+        this->ResultLabels[index] = 0;
+        this->Distances[index] = DIST_EPSILON;
+        }
+      else
+        {
+        this->ResultLabels[index] = seedValue;
+        if (seedValue == 0)
+          {
+          this->Distances[index] = DIST_INF;
+          }
+        else
+          {
+          this->Distances[index] = DIST_EPSILON;
+          seeds.push_back(static_cast<NodeIndexType>(index));
+          }
+        }
+      }
+  }
+
+  void Reduce()
+  {
+  }
+
+  LabelPixelType* SeedLabels;
+  MaskPixelType* MaskLabels;
+  LabelPixelType* ResultLabels;
+  NodeKeyValueType* Distances;
+  bool Incremental;
+  vtkSMPThreadLocal<std::vector<NodeIndexType> > Seeds;
+};
+
 //----------------------------------------------------------------------------
 class vtkImageGrowCutSegment::vtkInternal
 {
@@ -36,18 +238,29 @@ public:
 
   void Reset();
 
+  /// Allocate result and distance volumes and compute neighborhood.
+  /// Used before the first (full) computation.
+  void InitializeVolumesAndNeighborhood(vtkImageData *seedLabelVolume, double distancePenalty);
+
   template<typename IntensityPixelType, typename LabelPixelType>
   bool InitializationAHP(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume, double distancePenalty);
 
   template<typename IntensityPixelType, typename LabelPixelType>
   void DijkstraBasedClassificationAHP(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume);
 
+  template<typename LabelPixelType>
+  void InitializationBucketQueue(vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume, double distancePenalty);
+
+  template<typename IntensityPixelType, typename LabelPixelType>
+  void DijkstraBasedClassificationBucketQueue(vtkImageData *intensityVolume);
+
   template <class SourceVolType>
   bool ExecuteGrowCut(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume,
-    vtkImageData *resultLabelVolume, double distancePenalty);
+    vtkImageData *resultLabelVolume, double distancePenalty, int priorityQueueType);
 
   template< class SourceVolType, class SeedVolType>
-  bool ExecuteGrowCut2(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume, double distancePenalty);
+  bool ExecuteGrowCut2(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume,
+    double distancePenalty, int priorityQueueType);
 
   // Stores the shortest distance from known labels to each point
   // If a point is set to DIST_INF then that point will modified, as a shorter distance path will be found.
@@ -69,6 +282,7 @@ public:
 
   FibHeap *m_Heap;
   FibHeapNode *m_HeapNodes; // a node is stored for each voxel
+  GrowCutBucketQueue m_BucketQueue;
   bool m_bSegInitialized;
 };
 
@@ -102,11 +316,76 @@ void vtkImageGrowCutSegment::vtkInternal::Reset()
     delete[]m_HeapNodes;
     m_HeapNodes = nullptr;
     }
+  m_BucketQueue.Clear();
   m_bSegInitialized = false;
   m_DistanceVolume->Initialize();
   m_ResultLabelVolume->Initialize();
 }
 
+//-----------------------------------------------------------------------------
+void vtkImageGrowCutSegment::vtkInternal::InitializeVolumesAndNeighborhood(vtkImageData *seedLabelVolume, double distancePenalty)
+{
+  NodeIndexType dimXYZ = m_DimX * m_DimY * m_DimZ;
+  m_ResultLabelVolume->SetOrigin(seedLabelVolume->GetOrigin());
+  m_ResultLabelVolume->SetSpacing(seedLabelVolume->GetSpacing());
+  m_ResultLabelVolume->SetExtent(seedLabelVolume->GetExtent());
+  m_ResultLabelVolume->AllocateScalars(seedLabelVolume->GetScalarType(), 1);
+  m_DistanceVolume->SetOrigin(seedLabelVolume->GetOrigin());
+  m_DistanceVolume->SetSpacing(seedLabelVolume->GetSpacing());
+  m_DistanceVolume->SetExtent(seedLabelVolume->GetExtent());
+  m_DistanceVolume->AllocateScalars(NodeKeyValueTypeID, 1);
+
+  // Compute index offset
+  m_DistancePenalty = distancePenalty;
+  m_NeighborIndexOffsets.clear();
+  m_NeighborDistancePenalties.clear();
+  // Neighbors are traversed in the order of m_NeighborIndexOffsets,
+  // therefore one would expect that the offsets should
+  // be as continuous as possible (e.g., x coordinate
+  // should change most quickly), but that resulted in
+  // about 5-6% longer computation time. Therefore,
+  // we put indices in order x1y1z1, x1y1z2, x1y1z3, etc.
+  double* spacing = seedLabelVolume->GetSpacing();
+  for (long ix = -1; ix <= 1; ix++)
+  {
+    for (long iy = -1; iy <= 1; iy++)
+    {
+      for (long iz = -1; iz <= 1; iz++)
+      {
+        if (ix == 0 && iy == 0 && iz == 0)
+          {
+          continue;
+          }
+        m_NeighborIndexOffsets.push_back(ix + long(m_DimX)*(iy + long(m_DimY)*iz));
+        m_NeighborDistancePenalties.push_back(this->m_DistancePenalty * sqrt((spacing[0] * ix) * (spacing[0] * ix)
+          + (spacing[1] * iy) * (spacing[1] * iy) + (spacing[2] * iz) * (spacing[2] * iz)));
+        }
+      }
+    }
+
+  // Determine neighborhood size for computation at each voxel.
+  // The neighborhood size is everywhere the same (size of m_NeighborIndexOffsets)
+  // except at the edges of the volume, where the neighborhood size is 0.
+  m_NumberOfNeighbors.resize(dimXYZ);
+  const unsigned char numberOfNeighbors = m_NeighborIndexOffsets.size();
+  unsigned char* nbSizePtr = &(m_NumberOfNeighbors[0]);
+  for (NodeIndexType z = 0; z < m_DimZ; z++)
+    {
+    bool zEdge = (z == 0 || z == m_DimZ - 1);
+    for (NodeIndexType y = 0; y < m_DimY; y++)
+      {
+      bool yEdge = (y == 0 || y == m_DimY - 1);
+      *(nbSizePtr++) = 0; // x == 0 (there is always padding, so we don't need to check if m_DimX>0)
+      unsigned char nbSize = (zEdge || yEdge) ? 0 : numberOfNeighbors;
+      for (NodeIndexType x = m_DimX-2; x > 0; x--)
+        {
+        *(nbSizePtr++) = nbSize;
+        }
+      *(nbSizePtr++) = 0; // x == m_DimX-1 (there is always padding, so we don'neighborNewDistance need to check if m_DimX>1)
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 template<typename IntensityPixelType, typename LabelPixelType>
 bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
@@ -126,74 +405,17 @@ bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
   m_Heap->SetHeapNodes(m_HeapNodes);
   LabelPixelType* seedLabelVolumePtr = static_cast<LabelPixelType*>(seedLabelVolume->GetScalarPointer());
   MaskPixelType* maskLabelVolumePtr = nullptr;
-  if (seedLabelVolume != nullptr)
+  if (maskLabelVolume != nullptr)
     {
     maskLabelVolumePtr = static_cast<MaskPixelType*>(maskLabelVolume->GetScalarPointer());
     }
 
   if (!m_bSegInitialized)
     {
-    m_ResultLabelVolume->SetOrigin(seedLabelVolume->GetOrigin());
-    m_ResultLabelVolume->SetSpacing(seedLabelVolume->GetSpacing());
-    m_ResultLabelVolume->SetExtent(seedLabelVolume->GetExtent());
-    m_ResultLabelVolume->AllocateScalars(seedLabelVolume->GetScalarType(), 1);
-    m_DistanceVolume->SetOrigin(seedLabelVolume->GetOrigin());
-    m_DistanceVolume->SetSpacing(seedLabelVolume->GetSpacing());
-    m_DistanceVolume->SetExtent(seedLabelVolume->GetExtent());
-    m_DistanceVolume->AllocateScalars(NodeKeyValueTypeID, 1);
+    this->InitializeVolumesAndNeighborhood(seedLabelVolume, distancePenalty);
     LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
     NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
 
-    // Compute index offset
-    m_DistancePenalty = distancePenalty;
-    m_NeighborIndexOffsets.clear();
-    m_NeighborDistancePenalties.clear();
-    // Neighbors are traversed in the order of m_NeighborIndexOffsets,
-    // therefore one would expect that the offsets should
-    // be as continuous as possible (e.g., x coordinate
-    // should change most quickly), but that resulted in
-    // about 5-6% longer computation time. Therefore,
-    // we put indices in order x1y1z1, x1y1z2, x1y1z3, etc.
-    double* spacing = seedLabelVolume->GetSpacing();
-    for (long ix = -1; ix <= 1; ix++)
-    {
-      for (long iy = -1; iy <= 1; iy++)
-      {
-        for (long iz = -1; iz <= 1; iz++)
-        {
-          if (ix == 0 && iy == 0 && iz == 0)
-            {
-            continue;
-            }
-          m_NeighborIndexOffsets.push_back(ix + long(m_DimX)*(iy + long(m_DimY)*iz));
-          m_NeighborDistancePenalties.push_back(this->m_DistancePenalty * sqrt((spacing[0] * ix) * (spacing[0] * ix)
-            + (spacing[1] * iy) * (spacing[1] * iy) + (spacing[2] * iz) * (spacing[2] * iz)));
-          }
-        }
-      }
-
-    // Determine neighborhood size for computation at each voxel.
-    // The neighborhood size is everywhere the same (size of m_NeighborIndexOffsets)
-    // except at the edges of the volume, where the neighborhood size is 0.
-    m_NumberOfNeighbors.resize(dimXYZ);
-    const unsigned char numberOfNeighbors = m_NeighborIndexOffsets.size();
-    unsigned char* nbSizePtr = &(m_NumberOfNeighbors[0]);
-    for (NodeIndexType z = 0; z < m_DimZ; z++)
-      {
-      bool zEdge = (z == 0 || z == m_DimZ - 1);
-      for (NodeIndexType y = 0; y < m_DimY; y++)
-        {
-        bool yEdge = (y == 0 || y == m_DimY - 1);
-        *(nbSizePtr++) = 0; // x == 0 (there is always padding, so we don't need to check if m_DimX>0)
-        unsigned char nbSize = (zEdge || yEdge) ? 0 : numberOfNeighbors;
-        for (NodeIndexType x = m_DimX-2; x > 0; x--)
-          {
-          *(nbSizePtr++) = nbSize;
-          }
-        *(nbSizePtr++) = 0; // x == m_DimX-1 (there is always padding, so we don'neighborNewDistance need to check if m_DimX>1)
-        }
-      }
-
     if (!maskLabelVolumePtr)
       {
       // no mask
@@ -389,10 +611,93 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
     }
 }
 
+//-----------------------------------------------------------------------------
+template<typename LabelPixelType>
+void vtkImageGrowCutSegment::vtkInternal::InitializationBucketQueue(
+  vtkImageData *seedLabelVolume,
+  vtkImageData *maskLabelVolume,
+  double distancePenalty)
+{
+  bool incremental = m_bSegInitialized;
+  if (!incremental)
+    {
+    this->InitializeVolumesAndNeighborhood(seedLabelVolume, distancePenalty);
+    }
+
+  MaskPixelType* maskLabelVolumePtr = nullptr;
+  if (maskLabelVolume != nullptr)
+    {
+    maskLabelVolumePtr = static_cast<MaskPixelType*>(maskLabelVolume->GetScalarPointer());
+    }
+  GrowCutSeedInitializer<LabelPixelType> seedInitializer(
+    static_cast<LabelPixelType*>(seedLabelVolume->GetScalarPointer()),
+    maskLabelVolumePtr,
+    static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer()),
+    static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer()),
+    incremental);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(m_DimX) * m_DimY * m_DimZ, seedInitializer);
+
+  // Only seeds are added to the queue. Voxels that are not reachable from the seeds
+  // (infinite distance) are never added, unlike with the Fibonacci heap.
+  m_BucketQueue.Clear();
+  for (typename vtkSMPThreadLocal<std::vector<NodeIndexType> >::iterator seedsIt = seedInitializer.Seeds.begin();
+    seedsIt != seedInitializer.Seeds.end(); ++seedsIt)
+    {
+    for (NodeIndexType index : *seedsIt)
+      {
+      m_BucketQueue.Push(DIST_EPSILON, index);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+template<typename IntensityPixelType, typename LabelPixelType>
+void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationBucketQueue(vtkImageData *intensityVolume)
+{
+  LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
+  NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
+  IntensityPixelType* imSrc = static_cast<IntensityPixelType*>(intensityVolume->GetScalarPointer());
+
+  // Same computation is used for full computation and quick update: in quick update
+  // only new seeds are in the queue and distances are kept from the previous computation.
+  NodeKeyValueType currentDistance = 0;
+  NodeIndexType index = 0;
+  while (m_BucketQueue.Pop(currentDistance, index))
+    {
+    if (currentDistance > distanceVolumePtr[index])
+      {
+      // A shorter path has been found to this voxel since it was added to the queue
+      continue;
+      }
+    LabelPixelType currentLabel = resultLabelVolumePtr[index];
+
+    // Update neighbors
+    NodeKeyValueType pixCenter = imSrc[index];
+    unsigned char nbSize = m_NumberOfNeighbors[index];
+    for (unsigned char i = 0; i < nbSize; i++)
+      {
+      NodeIndexType indexNgbh = index + m_NeighborIndexOffsets[i];
+      NodeKeyValueType neighborCurrentDistance = distanceVolumePtr[indexNgbh];
+      NodeKeyValueType neighborNewDistance = fabs(pixCenter - imSrc[indexNgbh]) + currentDistance + m_NeighborDistancePenalties[i];
+      if (neighborCurrentDistance > neighborNewDistance)
+        {
+        distanceVolumePtr[indexNgbh] = neighborNewDistance;
+        resultLabelVolumePtr[indexNgbh] = currentLabel;
+        m_BucketQueue.Push(neighborNewDistance, indexNgbh);
+        }
+      }
+    }
+
+  m_bSegInitialized = true;
+
+  // Release memory
+  m_BucketQueue.Clear();
+}
+
 //-----------------------------------------------------------------------------
 template< class IntensityPixelType, class LabelPixelType>
 bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume,
-  vtkImageData *maskLabelVolume, double distancePenalty)
+  vtkImageData *maskLabelVolume, double distancePenalty, int priorityQueueType)
 {
   int* imSize = intensityVolume->GetDimensions();
 
@@ -419,6 +724,13 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData *intensit
     return false;
     }
 
+  if (priorityQueueType == vtkImageGrowCutSegment::BucketPriorityQueue)
+    {
+    InitializationBucketQueue<LabelPixelType>(seedLabelVolume, maskLabelVolume, distancePenalty);
+    DijkstraBasedClassificationBucketQueue<IntensityPixelType, LabelPixelType>(intensityVolume);
+    return true;
+    }
+
   if (!InitializationAHP<IntensityPixelType, LabelPixelType>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty))
     {
     return false;
@@ -431,7 +743,7 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData *intensit
 //----------------------------------------------------------------------------
 template <class SourceVolType>
 bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume,
-  vtkImageData *maskLabelVolume, vtkImageData *resultLabelVolume, double distancePenalty)
+  vtkImageData *maskLabelVolume, vtkImageData *resultLabelVolume, double distancePenalty, int priorityQueueType)
 {
   int* extent = intensityVolume->GetExtent();
   double* spacing = intensityVolume->GetSpacing();
@@ -507,7 +819,8 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut(vtkImageData *intensity
   bool success = false;
   switch (seedLabelVolume->GetScalarType())
   {
-    vtkTemplateMacro((success = ExecuteGrowCut2<SourceVolType, VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty)));
+    vtkTemplateMacro((success = ExecuteGrowCut2<SourceVolType, VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume,
+      distancePenalty, priorityQueueType)));
   default:
     vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImage: Unknown ScalarType");
   }
@@ -530,6 +843,7 @@ vtkImageGrowCutSegment::vtkImageGrowCutSegment()
   this->SetNumberOfInputPorts(3);
   this->SetNumberOfOutputPorts(1);
   this->DistancePenalty = 0.0;
+  this->PriorityQueueType = BucketPriorityQueue;
 }
 
 //-----------------------------------------------------------------------------
@@ -552,7 +866,8 @@ void vtkImageGrowCutSegment::ExecuteDataWithInformation(
 
   switch (intensityVolume->GetScalarType())
     {
-    vtkTemplateMacro(this->Internal->ExecuteGrowCut<VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, resultLabelVolume, this->DistancePenalty));
+    vtkTemplateMacro(this->Internal->ExecuteGrowCut<VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, resultLabelVolume,
+      this->DistancePenalty, this->PriorityQueueType));
     break;
     }
   logger->StopTimer();
@@ -583,6 +898,8 @@ void vtkImageGrowCutSegment::Reset()
 //-----------------------------------------------------------------------------
 void vtkImageGrowCutSegment::PrintSelf(ostream &os, vtkIndent indent)
 {
-  // XXX Implement this function
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DistancePenalty: " << this->DistancePenalty << std::endl;
+  os << indent << "PriorityQueueType: "
+    << (this->PriorityQueueType == BucketPriorityQueue ? "Bucket" : "FibonacciHeap") << std::endl;
 }
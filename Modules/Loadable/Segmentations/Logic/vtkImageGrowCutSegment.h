@@ -35,6 +35,24 @@ public:
   vtkGetMacro(DistancePenalty, double);
   vtkSetMacro(DistancePenalty, double);
 
+  enum PriorityQueueTypes
+  {
+    /// Fibonacci heap, with one heap node allocated for each voxel
+    FibonacciHeapPriorityQueue,
+    /// Radix heap over the bit patterns of the distances, with voxels only queued when their distance is updated.
+    /// Gives the same distances as the Fibonacci heap, using much less memory and time.
+    BucketPriorityQueue,
+    PriorityQueue_Last // must be last
+  };
+
+  /// Priority queue implementation used for computing shortest distances from the seeds.
+  /// Default is BucketPriorityQueue. Changing the priority queue type does not reset the
+  /// segmentation, incremental updates can be computed using any of the queue types.
+  vtkGetMacro(PriorityQueueType, int);
+  vtkSetClampMacro(PriorityQueueType, int, 0, PriorityQueue_Last - 1);
+  void SetPriorityQueueTypeToFibonacciHeap() { this->SetPriorityQueueType(FibonacciHeapPriorityQueue); }
+  void SetPriorityQueueTypeToBucket() { this->SetPriorityQueueType(BucketPriorityQueue); }
+
 protected:
   vtkImageGrowCutSegment();
   ~vtkImageGrowCutSegment() override;
@@ -46,6 +64,7 @@ private:
   class vtkInternal;
   vtkInternal * Internal;
   double DistancePenalty;
+  int PriorityQueueType;
 };
 
 #endif
@@ -39,12 +39,15 @@
 #include <vtkAppendPolyData.h>
 #include <vtkCallbackCommand.h>
 #include <vtkDataObject.h>
+#include <vtkDoubleArray.h>
 #include <vtkGeneralTransform.h>
+#include <vtkIdTypeArray.h>
 #include <vtkImageAccumulate.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageMathematics.h>
 #include <vtkImageThreshold.h>
 #include <vtkLookupTable.h>
+#include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
@@ -55,8 +58,11 @@
 #include <vtkProperty.h>
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
 #include <vtkSTLWriter.h>
 #include <vtkStringArray.h>
+#include <vtkTable.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkTriangleFilter.h>
@@ -77,9 +83,13 @@
 #include <vtkMRMLLabelMapVolumeDisplayNode.h>
 #include <vtkMRMLModelDisplayNode.h>
 #include <vtkMRMLModelNode.h>
+#include <vtkMRMLScalarVolumeNode.h>
 #include <vtkEventBroker.h>
 
 // STD includes
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <sstream>
 
 //----------------------------------------------------------------------------
@@ -2651,3 +2661,514 @@ void vtkSlicerSegmentationsModuleLogic::CollapseBinaryLabelmaps(vtkMRMLSegmentat
   segmentationNode->GetSegmentation()->SetMasterRepresentationModifiedEnabled(wasMasterRepresentationModifiedEnabled);
   vtkSlicerSegmentationsModuleLogic::ReconvertAllRepresentations(segmentationNode);
 }
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+struct SegmentStatisticsAccumulator
+{
+  vtkIdType VoxelCount{0};
+  double IjkSum[3] = { 0.0, 0.0, 0.0 };
+  double IntensitySum{0.0};
+  double IntensitySquareSum{0.0};
+  double IntensityMin{VTK_DOUBLE_MAX};
+  double IntensityMax{VTK_DOUBLE_MIN};
+  std::vector<vtkIdType> Histogram;
+
+  void Merge(const SegmentStatisticsAccumulator& other)
+    {
+    this->VoxelCount += other.VoxelCount;
+    for (int i = 0; i < 3; ++i)
+      {
+      this->IjkSum[i] += other.IjkSum[i];
+      }
+    this->IntensitySum += other.IntensitySum;
+    this->IntensitySquareSum += other.IntensitySquareSum;
+    this->IntensityMin = std::min(this->IntensityMin, other.IntensityMin);
+    this->IntensityMax = std::max(this->IntensityMax, other.IntensityMax);
+    if (other.Histogram.empty())
+      {
+      return;
+      }
+    if (this->Histogram.empty())
+      {
+      this->Histogram = other.Histogram;
+      return;
+      }
+    for (size_t bin = 0; bin < this->Histogram.size(); ++bin)
+      {
+      this->Histogram[bin] += other.Histogram[bin];
+      }
+    }
+};
+
+//-----------------------------------------------------------------------------
+struct SegmentStatisticsHistogram
+{
+  bool Enabled{false};
+  /// Each bin contains a single integer value
+  bool Exact{false};
+  double Minimum{0.0};
+  double BinWidth{1.0};
+  int NumberOfBins{0};
+};
+
+//-----------------------------------------------------------------------------
+/// Accumulates statistics of all segments of a labelmap layer in one pass.
+/// Slices of the processed extent are distributed between threads, each thread
+/// collects statistics in its own accumulators, which are merged at the end.
+template <class LabelT, class IntensityT>
+class SegmentStatisticsFunctor
+{
+public:
+  SegmentStatisticsFunctor(vtkImageData* labelImage, vtkImageData* intensityImage, const int intensityOffset[3],
+    const int extent[6], const std::vector<int>& labelToSegmentIndex, int numberOfSegments,
+    const SegmentStatisticsHistogram& histogram)
+    : LabelImage(labelImage)
+    , IntensityImage(intensityImage)
+    , LabelToSegmentIndex(labelToSegmentIndex)
+    , NumberOfSegments(numberOfSegments)
+    , Histogram(histogram)
+  {
+    std::copy(intensityOffset, intensityOffset + 3, this->IntensityOffset);
+    std::copy(extent, extent + 6, this->Extent);
+  }
+
+  void Initialize()
+  {
+    this->Accumulators.Local().resize(this->NumberOfSegments);
+  }
+
+  void operator()(vtkIdType beginSlice, vtkIdType endSlice)
+  {
+    std::vector<SegmentStatisticsAccumulator>& accumulators = this->Accumulators.Local();
+    const int numberOfLabels = static_cast<int>(this->LabelToSegmentIndex.size());
+    const int numberOfIntensityComponents = this->IntensityImage ? this->IntensityImage->GetNumberOfScalarComponents() : 0;
+    for (int k = this->Extent[4] + static_cast<int>(beginSlice); k < this->Extent[4] + static_cast<int>(endSlice); ++k)
+      {
+      for (int j = this->Extent[2]; j <= this->Extent[3]; ++j)
+        {
+        const LabelT* label = static_cast<const LabelT*>(this->LabelImage->GetScalarPointer(this->Extent[0], j, k));
+        const IntensityT* intensity = nullptr;
+        if (this->IntensityImage)
+          {
+          intensity = static_cast<const IntensityT*>(this->IntensityImage->GetScalarPointer(
+            this->Extent[0] + this->IntensityOffset[0], j + this->IntensityOffset[1], k + this->IntensityOffset[2]));
+          }
+        for (int i = this->Extent[0]; i <= this->Extent[1]; ++i, ++label, intensity += numberOfIntensityComponents)
+          {
+          int labelValue = static_cast<int>(*label);
+          if (labelValue <= 0 || labelValue >= numberOfLabels)
+            {
+            continue;
+            }
+          int segmentIndex = this->LabelToSegmentIndex[labelValue];
+          if (segmentIndex < 0)
+            {
+            continue;
+            }
+          SegmentStatisticsAccumulator& accumulator = accumulators[segmentIndex];
+          ++accumulator.VoxelCount;
+          accumulator.IjkSum[0] += i;
+          accumulator.IjkSum[1] += j;
+          accumulator.IjkSum[2] += k;
+          if (!intensity)
+            {
+            continue;
+            }
+          double value = static_cast<double>(*intensity);
+          accumulator.IntensitySum += value;
+          accumulator.IntensitySquareSum += value * value;
+          accumulator.IntensityMin = std::min(accumulator.IntensityMin, value);
+          accumulator.IntensityMax = std::max(accumulator.IntensityMax, value);
+          if (this->Histogram.Enabled)
+            {
+            if (accumulator.Histogram.empty())
+              {
+              accumulator.Histogram.resize(this->Histogram.NumberOfBins, 0);
+              }
+            int bin = static_cast<int>((value - this->Histogram.Minimum) / this->Histogram.BinWidth);
+            accumulator.Histogram[std::max(0, std::min(bin, this->Histogram.NumberOfBins - 1))]++;
+            }
+          }
+        }
+      }
+  }
+
+  void Reduce()
+  {
+    this->Result.resize(this->NumberOfSegments);
+    for (typename vtkSMPThreadLocal<std::vector<SegmentStatisticsAccumulator> >::iterator threadIt = this->Accumulators.begin();
+      threadIt != this->Accumulators.end(); ++threadIt)
+      {
+      for (int segmentIndex = 0; segmentIndex < this->NumberOfSegments; ++segmentIndex)
+        {
+        this->Result[segmentIndex].Merge((*threadIt)[segmentIndex]);
+        }
+      }
+  }
+
+  std::vector<SegmentStatisticsAccumulator> Result;
+
+private:
+  vtkImageData* LabelImage;
+  vtkImageData* IntensityImage;
+  int IntensityOffset[3];
+  int Extent[6];
+  const std::vector<int>& LabelToSegmentIndex;
+  int NumberOfSegments;
+  SegmentStatisticsHistogram Histogram;
+  vtkSMPThreadLocal<std::vector<SegmentStatisticsAccumulator> > Accumulators;
+};
+
+//-----------------------------------------------------------------------------
+template <class LabelT, class IntensityT>
+void ComputeLayerStatistics(vtkImageData* labelImage, vtkImageData* intensityImage, const int intensityOffset[3],
+  const int extent[6], const std::vector<int>& labelToSegmentIndex, int numberOfSegments,
+  const SegmentStatisticsHistogram& histogram, std::vector<SegmentStatisticsAccumulator>& result)
+{
+  SegmentStatisticsFunctor<LabelT, IntensityT> functor(labelImage, intensityImage, intensityOffset,
+    extent, labelToSegmentIndex, numberOfSegments, histogram);
+  vtkSMPTools::For(0, extent[5] - extent[4] + 1, functor);
+  result.swap(functor.Result);
+}
+
+//-----------------------------------------------------------------------------
+template <class LabelT>
+void ComputeLayerStatisticsForLabelType(LabelT*, vtkImageData* labelImage, vtkImageData* intensityImage, const int intensityOffset[3],
+  const int extent[6], const std::vector<int>& labelToSegmentIndex, int numberOfSegments,
+  const SegmentStatisticsHistogram& histogram, std::vector<SegmentStatisticsAccumulator>& result)
+{
+  if (!intensityImage)
+    {
+    ComputeLayerStatistics<LabelT, unsigned char>(labelImage, nullptr, intensityOffset,
+      extent, labelToSegmentIndex, numberOfSegments, histogram, result);
+    return;
+    }
+  switch (intensityImage->GetScalarType())
+    {
+    vtkTemplateMacro((ComputeLayerStatistics<LabelT, VTK_TT>(labelImage, intensityImage, intensityOffset,
+      extent, labelToSegmentIndex, numberOfSegments, histogram, result)));
+    }
+}
+
+//-----------------------------------------------------------------------------
+double GetPercentileFromHistogram(const SegmentStatisticsAccumulator& accumulator,
+  const SegmentStatisticsHistogram& histogram, double percentile)
+{
+  if (accumulator.VoxelCount == 0 || accumulator.Histogram.empty())
+    {
+    return 0.0;
+    }
+  double rank = std::max(0.0, std::min(percentile, 100.0)) / 100.0 * (accumulator.VoxelCount - 1);
+  vtkIdType countBelowBin = 0;
+  for (int bin = 0; bin < histogram.NumberOfBins; ++bin)
+    {
+    vtkIdType binCount = accumulator.Histogram[bin];
+    if (countBelowBin + binCount > rank)
+      {
+      if (histogram.Exact)
+        {
+        return histogram.Minimum + bin;
+        }
+      // Assume uniform distribution of values within the bin
+      double value = histogram.Minimum + histogram.BinWidth * (bin + (rank - countBelowBin + 0.5) / binCount);
+      return std::max(accumulator.IntensityMin, std::min(value, accumulator.IntensityMax));
+      }
+    countBelowBin += binCount;
+    }
+  return accumulator.IntensityMax;
+}
+
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics(vtkMRMLSegmentationNode* segmentationNode, vtkStringArray* segmentIDs,
+  vtkMRMLScalarVolumeNode* scalarVolumeNode, vtkTable* statisticsTable, vtkDoubleArray* percentiles /*=nullptr*/)
+{
+  if (!segmentationNode || !segmentationNode->GetSegmentation() || !statisticsTable)
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics: Invalid input");
+    return false;
+    }
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  std::string labelmapRepresentationName = vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName();
+  if (!segmentation->CreateRepresentation(labelmapRepresentationName))
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics: Failed to create binary labelmap representation");
+    return false;
+    }
+  if (scalarVolumeNode && !scalarVolumeNode->GetImageData())
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics: Invalid scalar volume");
+    return false;
+    }
+
+  std::vector<std::string> segmentIDsToCompute;
+  if (segmentIDs && segmentIDs->GetNumberOfValues() > 0)
+    {
+    for (vtkIdType index = 0; index < segmentIDs->GetNumberOfValues(); ++index)
+      {
+      segmentIDsToCompute.push_back(segmentIDs->GetValue(index));
+      }
+    }
+  else
+    {
+    segmentation->GetSegmentIDs(segmentIDsToCompute);
+    }
+  std::map<std::string, int> segmentIDToIndex;
+  for (size_t segmentIndex = 0; segmentIndex < segmentIDsToCompute.size(); ++segmentIndex)
+    {
+    if (!segmentation->GetSegment(segmentIDsToCompute[segmentIndex]))
+      {
+      vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics: Segment not found: " << segmentIDsToCompute[segmentIndex]);
+      return false;
+      }
+    segmentIDToIndex[segmentIDsToCompute[segmentIndex]] = static_cast<int>(segmentIndex);
+    }
+  const int numberOfSegments = static_cast<int>(segmentIDsToCompute.size());
+
+  // Intensity volume in the segmentation's coordinate system.
+  // The image is shallow-copied if no transform is needed.
+  vtkSmartPointer<vtkOrientedImageData> intensityImage;
+  SegmentStatisticsHistogram histogram;
+  if (scalarVolumeNode)
+    {
+    if (scalarVolumeNode->GetParentTransformNode() == segmentationNode->GetParentTransformNode())
+      {
+      intensityImage = vtkSmartPointer<vtkOrientedImageData>::New();
+      intensityImage->vtkImageData::ShallowCopy(scalarVolumeNode->GetImageData());
+      vtkNew<vtkMatrix4x4> ijkToRasMatrix;
+      scalarVolumeNode->GetIJKToRASMatrix(ijkToRasMatrix.GetPointer());
+      intensityImage->SetGeometryFromImageToWorldMatrix(ijkToRasMatrix.GetPointer());
+      }
+    else
+      {
+      intensityImage = vtkSmartPointer<vtkOrientedImageData>::Take(
+        vtkSlicerSegmentationsModuleLogic::CreateOrientedImageDataFromVolumeNode(scalarVolumeNode, segmentationNode->GetParentTransformNode()));
+      }
+    if (percentiles && percentiles->GetNumberOfTuples() > 0)
+      {
+      double scalarRange[2] = { 0.0, 0.0 };
+      intensityImage->GetScalarRange(scalarRange);
+      const int maximumNumberOfBins = 4096;
+      histogram.Enabled = true;
+      histogram.Minimum = scalarRange[0];
+      int scalarType = intensityImage->GetScalarType();
+      histogram.Exact = (scalarType != VTK_FLOAT && scalarType != VTK_DOUBLE
+        && scalarRange[1] - scalarRange[0] < maximumNumberOfBins);
+      if (histogram.Exact)
+        {
+        histogram.NumberOfBins = static_cast<int>(scalarRange[1] - scalarRange[0]) + 1;
+        histogram.BinWidth = 1.0;
+        }
+      else
+        {
+        histogram.NumberOfBins = maximumNumberOfBins;
+        histogram.BinWidth = std::max(scalarRange[1] - scalarRange[0], 1e-6) / maximumNumberOfBins;
+        }
+      }
+    }
+
+  vtkNew<vtkGeneralTransform> segmentationToWorldTransform;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(segmentationNode->GetParentTransformNode(), nullptr, segmentationToWorldTransform.GetPointer());
+
+  std::vector<SegmentStatisticsAccumulator> statistics(numberOfSegments);
+  std::vector<double> voxelVolumes(numberOfSegments, 0.0);
+  std::vector<std::array<double, 3> > centroids(numberOfSegments, std::array<double, 3>{ { 0.0, 0.0, 0.0 } });
+
+  int numberOfLayers = segmentation->GetNumberOfLayers(labelmapRepresentationName);
+  for (int layer = 0; layer < numberOfLayers; ++layer)
+    {
+    // Map label values of the layer to segments
+    std::vector<int> labelToSegmentIndex;
+    std::vector<std::string> layerSegmentIDs = segmentation->GetSegmentIDsForLayer(layer, labelmapRepresentationName);
+    std::vector<int> layerSegmentIndices;
+    for (std::vector<std::string>::iterator segmentIDIt = layerSegmentIDs.begin(); segmentIDIt != layerSegmentIDs.end(); ++segmentIDIt)
+      {
+      std::map<std::string, int>::iterator indexIt = segmentIDToIndex.find(*segmentIDIt);
+      if (indexIt == segmentIDToIndex.end())
+        {
+        continue;
+        }
+      int labelValue = segmentation->GetSegment(*segmentIDIt)->GetLabelValue();
+      if (labelValue <= 0)
+        {
+        continue;
+        }
+      if (labelValue >= static_cast<int>(labelToSegmentIndex.size()))
+        {
+        labelToSegmentIndex.resize(labelValue + 1, -1);
+        }
+      labelToSegmentIndex[labelValue] = indexIt->second;
+      layerSegmentIndices.push_back(indexIt->second);
+      }
+    vtkOrientedImageData* layerImage = vtkOrientedImageData::SafeDownCast(
+      segmentation->GetLayerDataObject(layer, labelmapRepresentationName));
+    if (layerSegmentIndices.empty() || !layerImage || !layerImage->GetPointData() || !layerImage->GetPointData()->GetScalars())
+      {
+      continue;
+      }
+
+    // Find the intensity voxel that corresponds to each labelmap voxel.
+    // If the voxel grids are not aligned then the labelmap is resampled to the intensity volume geometry.
+    vtkSmartPointer<vtkOrientedImageData> labelImage = layerImage;
+    int intensityOffset[3] = { 0, 0, 0 };
+    int extent[6] = { 0, -1, 0, -1, 0, -1 };
+    layerImage->GetExtent(extent);
+    if (intensityImage)
+      {
+      vtkNew<vtkTransform> labelToIntensityTransform;
+      vtkOrientedImageDataResample::GetTransformBetweenOrientedImages(layerImage, intensityImage, labelToIntensityTransform.GetPointer());
+      vtkMatrix4x4* labelToIntensityMatrix = labelToIntensityTransform->GetMatrix();
+      bool aligned = true;
+      for (int row = 0; row < 3 && aligned; ++row)
+        {
+        for (int column = 0; column < 3; ++column)
+          {
+          if (fabs(labelToIntensityMatrix->GetElement(row, column) - (row == column ? 1.0 : 0.0)) > 1e-4)
+            {
+            aligned = false;
+            break;
+            }
+          }
+        double translation = labelToIntensityMatrix->GetElement(row, 3);
+        if (fabs(translation - vtkMath::Round(translation)) > 1e-3)
+          {
+          aligned = false;
+          }
+        intensityOffset[row] = vtkMath::Round(translation);
+        }
+      if (!aligned)
+        {
+        labelImage = vtkSmartPointer<vtkOrientedImageData>::New();
+        if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(layerImage, intensityImage, labelImage))
+          {
+          vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics: Failed to resample labelmap to scalar volume geometry");
+          return false;
+          }
+        labelImage->GetExtent(extent);
+        intensityOffset[0] = intensityOffset[1] = intensityOffset[2] = 0;
+        }
+      int* intensityExtent = intensityImage->GetExtent();
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        extent[2 * axis] = std::max(extent[2 * axis], intensityExtent[2 * axis] - intensityOffset[axis]);
+        extent[2 * axis + 1] = std::min(extent[2 * axis + 1], intensityExtent[2 * axis + 1] - intensityOffset[axis]);
+        }
+      }
+
+    std::vector<SegmentStatisticsAccumulator> layerStatistics;
+    if (extent[0] <= extent[1] && extent[2] <= extent[3] && extent[4] <= extent[5])
+      {
+      switch (labelImage->GetScalarType())
+        {
+        vtkTemplateMacro(ComputeLayerStatisticsForLabelType(static_cast<VTK_TT*>(nullptr), labelImage, intensityImage,
+          intensityOffset, extent, labelToSegmentIndex, numberOfSegments, histogram, layerStatistics));
+        default:
+          vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics: Unsupported labelmap scalar type");
+          return false;
+        }
+      }
+
+    double spacing[3] = { 1.0, 1.0, 1.0 };
+    labelImage->GetSpacing(spacing);
+    vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+    labelImage->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+    for (int segmentIndex : layerSegmentIndices)
+      {
+      if (layerStatistics.empty())
+        {
+        continue;
+        }
+      statistics[segmentIndex] = layerStatistics[segmentIndex];
+      voxelVolumes[segmentIndex] = spacing[0] * spacing[1] * spacing[2];
+      const SegmentStatisticsAccumulator& accumulator = statistics[segmentIndex];
+      if (accumulator.VoxelCount > 0)
+        {
+        double centroidIjk[4] =
+          {
+          accumulator.IjkSum[0] / accumulator.VoxelCount,
+          accumulator.IjkSum[1] / accumulator.VoxelCount,
+          accumulator.IjkSum[2] / accumulator.VoxelCount,
+          1.0
+          };
+        double centroidSegmentation[4] = { 0.0, 0.0, 0.0, 1.0 };
+        imageToWorldMatrix->MultiplyPoint(centroidIjk, centroidSegmentation);
+        segmentationToWorldTransform->TransformPoint(centroidSegmentation, centroids[segmentIndex].data());
+        }
+      }
+    }
+
+  // Fill output table
+  statisticsTable->Initialize();
+  vtkNew<vtkStringArray> segmentIDColumn;
+  segmentIDColumn->SetName("Segment ID");
+  statisticsTable->AddColumn(segmentIDColumn.GetPointer());
+  vtkNew<vtkIdTypeArray> voxelCountColumn;
+  voxelCountColumn->SetName("Voxel count");
+  statisticsTable->AddColumn(voxelCountColumn.GetPointer());
+  std::vector<std::string> doubleColumnNames;
+  doubleColumnNames.push_back("Volume [mm3]");
+  doubleColumnNames.push_back("Centroid R");
+  doubleColumnNames.push_back("Centroid A");
+  doubleColumnNames.push_back("Centroid S");
+  if (intensityImage)
+    {
+    doubleColumnNames.push_back("Minimum");
+    doubleColumnNames.push_back("Maximum");
+    doubleColumnNames.push_back("Mean");
+    doubleColumnNames.push_back("Standard deviation");
+    for (vtkIdType percentileIndex = 0; histogram.Enabled && percentileIndex < percentiles->GetNumberOfTuples(); ++percentileIndex)
+      {
+      std::stringstream columnName;
+      columnName << "Percentile " << percentiles->GetValue(percentileIndex);
+      doubleColumnNames.push_back(columnName.str());
+      }
+    }
+  std::vector<vtkDoubleArray*> doubleColumns;
+  for (std::vector<std::string>::iterator nameIt = doubleColumnNames.begin(); nameIt != doubleColumnNames.end(); ++nameIt)
+    {
+    vtkNew<vtkDoubleArray> column;
+    column->SetName(nameIt->c_str());
+    statisticsTable->AddColumn(column.GetPointer());
+    doubleColumns.push_back(column.GetPointer());
+    }
+  statisticsTable->SetNumberOfRows(numberOfSegments);
+
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+    const SegmentStatisticsAccumulator& accumulator = statistics[segmentIndex];
+    segmentIDColumn->SetValue(segmentIndex, segmentIDsToCompute[segmentIndex]);
+    voxelCountColumn->SetValue(segmentIndex, accumulator.VoxelCount);
+    int columnIndex = 0;
+    doubleColumns[columnIndex++]->SetValue(segmentIndex, accumulator.VoxelCount * voxelVolumes[segmentIndex]);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      doubleColumns[columnIndex++]->SetValue(segmentIndex, centroids[segmentIndex][axis]);
+      }
+    if (!intensityImage)
+      {
+      continue;
+      }
+    double mean = 0.0;
+    double standardDeviation = 0.0;
+    if (accumulator.VoxelCount > 0)
+      {
+      mean = accumulator.IntensitySum / accumulator.VoxelCount;
+      standardDeviation = sqrt(std::max(0.0, accumulator.IntensitySquareSum / accumulator.VoxelCount - mean * mean));
+      }
+    doubleColumns[columnIndex++]->SetValue(segmentIndex, accumulator.VoxelCount > 0 ? accumulator.IntensityMin : 0.0);
+    doubleColumns[columnIndex++]->SetValue(segmentIndex, accumulator.VoxelCount > 0 ? accumulator.IntensityMax : 0.0);
+    doubleColumns[columnIndex++]->SetValue(segmentIndex, mean);
+    doubleColumns[columnIndex++]->SetValue(segmentIndex, standardDeviation);
+    for (vtkIdType percentileIndex = 0; histogram.Enabled && percentileIndex < percentiles->GetNumberOfTuples(); ++percentileIndex)
+      {
+      doubleColumns[columnIndex++]->SetValue(segmentIndex,
+        GetPercentileFromHistogram(accumulator, histogram, percentiles->GetValue(percentileIndex)));
+      }
+    }
+
+  return true;
+}
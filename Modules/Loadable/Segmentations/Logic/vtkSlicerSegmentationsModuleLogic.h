@@ -34,10 +34,12 @@
 #include "vtkMRMLSegmentationNode.h"
 
 class vtkCallbackCommand;
+class vtkDoubleArray;
 class vtkOrientedImageData;
 class vtkPolyData;
 class vtkDataObject;
 class vtkGeneralTransform;
+class vtkTable;
 
 class vtkMRMLSegmentationStorageNode;
 class vtkMRMLScalarVolumeNode;
@@ -385,6 +387,26 @@ public:
   /// \return True if the representation was created, False otherwise
   static void CollapseBinaryLabelmaps(vtkMRMLSegmentationNode* segmentationNode, bool forceToSingleLayer);
 
+  /// Compute statistics of multiple segments at once.
+  /// Each shared labelmap layer is processed in a single multithreaded pass that only visits
+  /// voxels within the layer's extent, so computation time does not grow with the number of segments
+  /// and no temporary labelmaps are created for each segment.
+  /// Output table contains one row for each segment, with columns "Segment ID", "Voxel count",
+  /// "Volume [mm3]", "Centroid R", "Centroid A", "Centroid S" (in world coordinate system), and if
+  /// a scalar volume is specified: "Minimum", "Maximum", "Mean", "Standard deviation" and
+  /// "Percentile <value>" columns.
+  /// \param segmentationNode Node containing the segmentation. Master representation must be binary labelmap.
+  /// \param segmentIDs Segments to compute statistics for. If nullptr or empty then all segments are used.
+  /// \param scalarVolumeNode Intensity volume. Optional. If its voxels are not aligned with the
+  ///   segmentation's labelmap voxels then the labelmap is resampled to the volume geometry.
+  /// \param statisticsTable Output table.
+  /// \param percentiles List of percentiles (between 0 and 100) to compute. Optional.
+  ///   Percentiles are exact for integer volumes with a scalar range smaller than 4096, otherwise they are
+  ///   interpolated from a 4096-bin histogram.
+  /// \return True if statistics were computed successfully.
+  static bool ComputeSegmentStatistics(vtkMRMLSegmentationNode* segmentationNode, vtkStringArray* segmentIDs,
+    vtkMRMLScalarVolumeNode* scalarVolumeNode, vtkTable* statisticsTable, vtkDoubleArray* percentiles = nullptr);
+
 public:
   /// Set Terminologies module logic
   void SetTerminologiesLogic(vtkSlicerTerminologiesModuleLogic* terminologiesLogic);
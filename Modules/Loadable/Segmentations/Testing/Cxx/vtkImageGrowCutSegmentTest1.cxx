@@ -0,0 +1,197 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Segmentations includes
+#include "vtkImageGrowCutSegment.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkTimerLog.h>
+
+// vtkAddon includes
+#include "vtkAddonTestingMacros.h"
+
+namespace
+{
+const int VOLUME_SIZE = 64;
+
+//----------------------------------------------------------------------------
+// Two regions of different intensity with random noise, so that there are no
+// equal-distance paths from different seeds.
+void CreateIntensityVolume(vtkImageData* image)
+{
+  image->SetDimensions(VOLUME_SIZE, VOLUME_SIZE, VOLUME_SIZE);
+  image->SetSpacing(0.8, 0.8, 1.5);
+  image->AllocateScalars(VTK_FLOAT, 1);
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1234);
+  float* voxels = static_cast<float*>(image->GetScalarPointer());
+  for (int z = 0; z < VOLUME_SIZE; z++)
+    {
+    for (int y = 0; y < VOLUME_SIZE; y++)
+      {
+      for (int x = 0; x < VOLUME_SIZE; x++)
+        {
+        random->Next();
+        *(voxels++) = (x < VOLUME_SIZE / 2 ? 100.0f : 200.0f) + static_cast<float>(random->GetValue() * 20.0);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void AddSeed(vtkImageData* seedLabelVolume, int center[3], short label)
+{
+  for (int z = center[2] - 1; z <= center[2] + 1; z++)
+    {
+    for (int y = center[1] - 1; y <= center[1] + 1; y++)
+      {
+      for (int x = center[0] - 1; x <= center[0] + 1; x++)
+        {
+        seedLabelVolume->SetScalarComponentFromDouble(x, y, z, 0, label);
+        }
+      }
+    }
+  seedLabelVolume->Modified();
+}
+
+//----------------------------------------------------------------------------
+void CreateLabelVolume(vtkImageData* image, int scalarType)
+{
+  image->SetDimensions(VOLUME_SIZE, VOLUME_SIZE, VOLUME_SIZE);
+  image->SetSpacing(0.8, 0.8, 1.5);
+  image->AllocateScalars(scalarType, 1);
+  image->GetPointData()->GetScalars()->Fill(0);
+}
+
+//----------------------------------------------------------------------------
+double UpdateGrowCut(vtkImageGrowCutSegment* growCut, vtkImageData* result)
+{
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  growCut->Update();
+  timer->StopTimer();
+  result->DeepCopy(growCut->GetOutput());
+  return timer->GetElapsedTime();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType GetNumberOfDifferentVoxels(vtkImageData* image1, vtkImageData* image2)
+{
+  short* voxels1 = static_cast<short*>(image1->GetScalarPointer());
+  short* voxels2 = static_cast<short*>(image2->GetScalarPointer());
+  vtkIdType numberOfVoxels = image1->GetNumberOfPoints();
+  if (!voxels1 || !voxels2 || image2->GetNumberOfPoints() != numberOfVoxels)
+    {
+    return -1;
+    }
+  vtkIdType numberOfDifferentVoxels = 0;
+  for (vtkIdType i = 0; i < numberOfVoxels; i++)
+    {
+    if (voxels1[i] != voxels2[i])
+      {
+      numberOfDifferentVoxels++;
+      }
+    }
+  return numberOfDifferentVoxels;
+}
+
+//----------------------------------------------------------------------------
+void SetupGrowCut(vtkImageGrowCutSegment* growCut, vtkImageData* intensityVolume,
+  vtkImageData* seedLabelVolume, vtkImageData* maskVolume, int priorityQueueType)
+{
+  growCut->SetIntensityVolume(intensityVolume);
+  growCut->SetSeedLabelVolume(seedLabelVolume);
+  growCut->SetMaskVolume(maskVolume);
+  growCut->SetDistancePenalty(0.5);
+  growCut->SetPriorityQueueType(priorityQueueType);
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkImageGrowCutSegmentTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkImageData> intensityVolume;
+  CreateIntensityVolume(intensityVolume.GetPointer());
+  vtkNew<vtkImageData> seedLabelVolume;
+  CreateLabelVolume(seedLabelVolume.GetPointer(), VTK_SHORT);
+  int seed1[3] = { 10, 32, 32 };
+  AddSeed(seedLabelVolume.GetPointer(), seed1, 1);
+  int seed2[3] = { 50, 32, 32 };
+  AddSeed(seedLabelVolume.GetPointer(), seed2, 2);
+  vtkNew<vtkImageData> maskVolume;
+  CreateLabelVolume(maskVolume.GetPointer(), VTK_UNSIGNED_CHAR);
+  for (int y = 0; y < VOLUME_SIZE; y++)
+    {
+    for (int x = 0; x < VOLUME_SIZE; x++)
+      {
+      maskVolume->SetScalarComponentFromDouble(x, y, 5, 0, 1);
+      }
+    }
+
+  // Full computation
+  vtkNew<vtkImageGrowCutSegment> fibonacciHeapGrowCut;
+  SetupGrowCut(fibonacciHeapGrowCut.GetPointer(), intensityVolume.GetPointer(), seedLabelVolume.GetPointer(),
+    maskVolume.GetPointer(), vtkImageGrowCutSegment::FibonacciHeapPriorityQueue);
+  vtkNew<vtkImageGrowCutSegment> bucketGrowCut;
+  SetupGrowCut(bucketGrowCut.GetPointer(), intensityVolume.GetPointer(), seedLabelVolume.GetPointer(),
+    maskVolume.GetPointer(), vtkImageGrowCutSegment::BucketPriorityQueue);
+  vtkNew<vtkImageGrowCutSegment> mixedGrowCut;
+  SetupGrowCut(mixedGrowCut.GetPointer(), intensityVolume.GetPointer(), seedLabelVolume.GetPointer(),
+    maskVolume.GetPointer(), vtkImageGrowCutSegment::BucketPriorityQueue);
+
+  vtkNew<vtkImageData> fibonacciHeapResult;
+  double fibonacciHeapTime = UpdateGrowCut(fibonacciHeapGrowCut.GetPointer(), fibonacciHeapResult.GetPointer());
+  vtkNew<vtkImageData> bucketResult;
+  double bucketTime = UpdateGrowCut(bucketGrowCut.GetPointer(), bucketResult.GetPointer());
+  vtkNew<vtkImageData> mixedResult;
+  UpdateGrowCut(mixedGrowCut.GetPointer(), mixedResult.GetPointer());
+  std::cout << "Full computation time: FibonacciHeap = " << fibonacciHeapTime
+    << "s, Bucket = " << bucketTime << "s" << std::endl;
+
+  CHECK_INT(GetNumberOfDifferentVoxels(fibonacciHeapResult.GetPointer(), bucketResult.GetPointer()), 0);
+  CHECK_INT(static_cast<int>(bucketResult->GetScalarComponentAsDouble(seed1[0] + 5, seed1[1], seed1[2], 0)), 1);
+  CHECK_INT(static_cast<int>(bucketResult->GetScalarComponentAsDouble(seed2[0] - 5, seed2[1], seed2[2], 0)), 2);
+  CHECK_INT(static_cast<int>(bucketResult->GetScalarComponentAsDouble(seed1[0], seed1[1], 5, 0)), 0); // masked
+
+  // Incremental update after adding a seed
+  int seed3[3] = { 20, 10, 40 };
+  AddSeed(seedLabelVolume.GetPointer(), seed3, 3);
+  // priority queue type can be changed between updates
+  mixedGrowCut->SetPriorityQueueTypeToFibonacciHeap();
+  fibonacciHeapTime = UpdateGrowCut(fibonacciHeapGrowCut.GetPointer(), fibonacciHeapResult.GetPointer());
+  bucketTime = UpdateGrowCut(bucketGrowCut.GetPointer(), bucketResult.GetPointer());
+  UpdateGrowCut(mixedGrowCut.GetPointer(), mixedResult.GetPointer());
+  std::cout << "Incremental update time: FibonacciHeap = " << fibonacciHeapTime
+    << "s, Bucket = " << bucketTime << "s" << std::endl;
+
+  // Incremental update gives the same result as full computation
+  vtkNew<vtkImageGrowCutSegment> fullGrowCut;
+  SetupGrowCut(fullGrowCut.GetPointer(), intensityVolume.GetPointer(), seedLabelVolume.GetPointer(),
+    maskVolume.GetPointer(), vtkImageGrowCutSegment::BucketPriorityQueue);
+  vtkNew<vtkImageData> fullResult;
+  UpdateGrowCut(fullGrowCut.GetPointer(), fullResult.GetPointer());
+
+  CHECK_INT(GetNumberOfDifferentVoxels(fibonacciHeapResult.GetPointer(), fullResult.GetPointer()), 0);
+  CHECK_INT(GetNumberOfDifferentVoxels(bucketResult.GetPointer(), fullResult.GetPointer()), 0);
+  CHECK_INT(GetNumberOfDifferentVoxels(mixedResult.GetPointer(), fullResult.GetPointer()), 0);
+  CHECK_INT(static_cast<int>(bucketResult->GetScalarComponentAsDouble(seed3[0], seed3[1], seed3[2], 0)), 3);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,129 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Segmentations includes
+#include "vtkSlicerSegmentationsModuleLogic.h"
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+
+// MRML includes
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSegmentationNode.h>
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
+
+// vtkAddon includes
+#include "vtkAddonTestingMacros.h"
+
+// STD includes
+#include <cmath>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Labelmap filled with ones, with the same spacing as the intensity volume
+void CreateLabelmap(vtkOrientedImageData* labelmap, int dimensions[3], double originI)
+{
+  labelmap->SetDimensions(dimensions);
+  labelmap->SetSpacing(1.0, 1.0, 2.0);
+  labelmap->SetOrigin(originI, 0.0, 0.0);
+  labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  labelmap->GetPointData()->GetScalars()->Fill(1);
+}
+
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerSegmentationsModuleLogicStatisticsTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  // Intensity of each voxel is its I index
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(20, 20, 10);
+  image->AllocateScalars(VTK_SHORT, 1);
+  for (int k = 0; k < 10; ++k)
+    {
+    for (int j = 0; j < 20; ++j)
+      {
+      for (int i = 0; i < 20; ++i)
+        {
+        *static_cast<short*>(image->GetScalarPointer(i, j, k)) = static_cast<short>(i);
+        }
+      }
+    }
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(image.GetPointer());
+  volumeNode->SetSpacing(1.0, 1.0, 2.0);
+  scene->AddNode(volumeNode.GetPointer());
+
+  vtkNew<vtkMRMLSegmentationNode> segmentationNode;
+  scene->AddNode(segmentationNode.GetPointer());
+
+  // Segment covering voxels I=0..9
+  vtkNew<vtkOrientedImageData> labelmapA;
+  int dimensionsA[3] = { 10, 20, 10 };
+  CreateLabelmap(labelmapA.GetPointer(), dimensionsA, 0.0);
+  std::string segmentIdA = segmentationNode->AddSegmentFromBinaryLabelmapRepresentation(labelmapA.GetPointer(), "A");
+
+  // Segment covering voxels I=10..14, stored with a shifted origin
+  vtkNew<vtkOrientedImageData> labelmapB;
+  int dimensionsB[3] = { 5, 20, 10 };
+  CreateLabelmap(labelmapB.GetPointer(), dimensionsB, 10.0);
+  std::string segmentIdB = segmentationNode->AddSegmentFromBinaryLabelmapRepresentation(labelmapB.GetPointer(), "B");
+
+  // Geometry statistics only
+  vtkNew<vtkTable> table;
+  CHECK_BOOL(vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics(
+    segmentationNode.GetPointer(), nullptr, nullptr, table.GetPointer()), true);
+  CHECK_INT(table->GetNumberOfRows(), 2);
+  CHECK_INT(table->GetNumberOfColumns(), 6);
+  CHECK_STRING(table->GetValueByName(0, "Segment ID").ToString().c_str(), segmentIdA.c_str());
+  CHECK_INT(table->GetValueByName(0, "Voxel count").ToInt(), 2000);
+  CHECK_DOUBLE_TOLERANCE(table->GetValueByName(0, "Volume [mm3]").ToDouble(), 4000.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(table->GetValueByName(1, "Centroid R").ToDouble(), 12.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(table->GetValueByName(1, "Centroid S").ToDouble(), 9.0, 1e-6);
+
+  // Intensity statistics for a selected segment
+  vtkNew<vtkStringArray> segmentIds;
+  segmentIds->InsertNextValue(segmentIdB);
+  vtkNew<vtkDoubleArray> percentiles;
+  percentiles->InsertNextValue(0.0);
+  percentiles->InsertNextValue(50.0);
+  percentiles->InsertNextValue(100.0);
+  CHECK_BOOL(vtkSlicerSegmentationsModuleLogic::ComputeSegmentStatistics(
+    segmentationNode.GetPointer(), segmentIds.GetPointer(), volumeNode.GetPointer(), table.GetPointer(), percentiles.GetPointer()), true);
+  CHECK_INT(table->GetNumberOfRows(), 1);
+  CHECK_INT(table->GetValueByName(0, "Voxel count").ToInt(), 1000);
+  CHECK_DOUBLE_TOLERANCE(table->GetValueByName(0, "Minimum").ToDouble(), 10.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(table->GetValueByName(0, "Maximum").ToDouble(), 14.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(table->GetValueByName(0, "Mean").ToDouble(), 12.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(table->GetValueByName(0, "Standard deviation").ToDouble(), sqrt(2.0), 1e-6);
+  CHECK_DOUBLE_TOLERANCE(table->GetValueByName(0, "Percentile 0").ToDouble(), 10.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(table->GetValueByName(0, "Percentile 50").ToDouble(), 12.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(table->GetValueByName(0, "Percentile 100").ToDouble(), 14.0, 1e-6);
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -54,6 +54,7 @@
 #include <vtkImageThreshold.h>
 #include <vtkImageExtractComponents.h>
 #include <vtkInteractorObserver.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkRenderer.h>
@@ -261,6 +262,12 @@ public:
   /// Modifier labelmap that is kept in memory to avoid memory reallocations on each editing operation.
   /// When update of this labelmap is requested its geometry is reset and its content is cleared.
   vtkOrientedImageData* ModifierLabelmap;
+  /// Region of the modifier labelmap that may contain non-empty voxels.
+  /// Only this region is cleared when the modifier labelmap is reset with unchanged geometry.
+  int ModifierLabelmapModifiedExtent[6];
+  /// True if an effect reported the modified region since the last reset.
+  /// Until then the entire modifier labelmap is considered modified.
+  bool ModifierLabelmapModifiedExtentReported;
   vtkOrientedImageData* SelectedSegmentLabelmap;
   vtkOrientedImageData* MaskLabelmap;
   /// Image that contains reference geometry. Scalars are not allocated.
@@ -305,6 +312,7 @@ qMRMLSegmentEditorWidgetPrivate::qMRMLSegmentEditorWidgetPrivate(qMRMLSegmentEdi
   , AutoShowMasterVolumeNode(true)
   , AlignedMasterVolume(nullptr)
   , ModifierLabelmap(nullptr)
+  , ModifierLabelmapModifiedExtentReported(false)
   , SelectedSegmentLabelmap(nullptr)
   , MaskLabelmap(nullptr)
   , ReferenceGeometryImage(nullptr)
@@ -317,6 +325,10 @@ qMRMLSegmentEditorWidgetPrivate::qMRMLSegmentEditorWidgetPrivate(qMRMLSegmentEdi
 {
   this->AlignedMasterVolume = vtkOrientedImageData::New();
   this->ModifierLabelmap = vtkOrientedImageData::New();
+  for (int i = 0; i < 6; ++i)
+    {
+    this->ModifierLabelmapModifiedExtent[i] = (i % 2 == 0 ? 0 : -1);
+    }
   this->MaskLabelmap = vtkOrientedImageData::New();
   this->SelectedSegmentLabelmap = vtkOrientedImageData::New();
   this->ReferenceGeometryImage = vtkOrientedImageData::New();
@@ -571,15 +583,49 @@ bool qMRMLSegmentEditorWidgetPrivate::resetModifierLabelmapToDefault()
     return false;
     }
 
-  std::string modifierLabelmapReferenceImageGeometryBaseline = vtkSegmentationConverter::SerializeImageGeometry(this->ModifierLabelmap);
-
-  // Set reference geometry to labelmap (origin, spacing, directions, extents) and allocate scalars
   vtkNew<vtkMatrix4x4> referenceGeometryMatrix;
   int referenceExtent[6] = {0,-1,0,-1,0,-1};
   vtkSegmentationConverter::DeserializeImageGeometry(referenceImageGeometry, referenceGeometryMatrix.GetPointer(), referenceExtent);
-  vtkSegmentationConverter::DeserializeImageGeometry(referenceImageGeometry, this->ModifierLabelmap, true, BINARY_LABELMAP_SCALAR_TYPE, 1);
 
-  vtkOrientedImageDataResample::FillImage(this->ModifierLabelmap, BINARY_LABELMAP_VOXEL_EMPTY);
+  // If the geometry has not changed since the last reset then the allocated scalars are reused
+  // and only the region that effects may have modified is cleared.
+  // A paint stroke touches only a few voxels, so this avoids clearing the entire reference volume.
+  vtkNew<vtkMatrix4x4> modifierLabelmapGeometryMatrix;
+  this->ModifierLabelmap->GetImageToWorldMatrix(modifierLabelmapGeometryMatrix.GetPointer());
+  int* modifierLabelmapExtent = this->ModifierLabelmap->GetExtent();
+  vtkDataArray* modifierLabelmapScalars = this->ModifierLabelmap->GetPointData()->GetScalars();
+  bool geometryUnchanged = modifierLabelmapScalars
+    && modifierLabelmapScalars->GetReferenceCount() == 1 // scalars are not shared with any other image
+    && modifierLabelmapScalars->GetDataType() == BINARY_LABELMAP_SCALAR_TYPE
+    && modifierLabelmapScalars->GetNumberOfComponents() == 1
+    && modifierLabelmapScalars->GetNumberOfTuples() == this->ModifierLabelmap->GetNumberOfPoints()
+    && std::equal(referenceExtent, referenceExtent + 6, modifierLabelmapExtent)
+    && vtkOrientedImageDataResample::IsEqual(referenceGeometryMatrix.GetPointer(), modifierLabelmapGeometryMatrix.GetPointer());
+
+  if (geometryUnchanged)
+    {
+    int clearExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    for (int i = 0; i < 3; ++i)
+      {
+      clearExtent[2 * i] = std::max(this->ModifierLabelmapModifiedExtent[2 * i], referenceExtent[2 * i]);
+      clearExtent[2 * i + 1] = std::min(this->ModifierLabelmapModifiedExtent[2 * i + 1], referenceExtent[2 * i + 1]);
+      }
+    if (clearExtent[0] <= clearExtent[1] && clearExtent[2] <= clearExtent[3] && clearExtent[4] <= clearExtent[5])
+      {
+      vtkOrientedImageDataResample::FillImage(this->ModifierLabelmap, BINARY_LABELMAP_VOXEL_EMPTY, clearExtent);
+      }
+    }
+  else
+    {
+    // Set reference geometry to labelmap (origin, spacing, directions, extents) and allocate scalars
+    vtkSegmentationConverter::DeserializeImageGeometry(referenceImageGeometry, this->ModifierLabelmap, true, BINARY_LABELMAP_SCALAR_TYPE, 1);
+    vtkOrientedImageDataResample::FillImage(this->ModifierLabelmap, BINARY_LABELMAP_VOXEL_EMPTY);
+    }
+
+  // The effect that requested the reset may write anywhere in the labelmap,
+  // until it reports the modified region.
+  this->ModifierLabelmap->GetExtent(this->ModifierLabelmapModifiedExtent);
+  this->ModifierLabelmapModifiedExtentReported = false;
 
   return true;
 }
@@ -1077,7 +1123,8 @@ void qMRMLSegmentEditorWidget::updateEffectList()
     effect->setCallbackSlots(this,
       SLOT(setActiveEffectByName(QString)),
       SLOT(updateVolume(void*, bool&)),
-      SLOT(saveStateForUndo()));
+      SLOT(saveStateForUndo()),
+      SLOT(onModifierLabelmapModified(const QList<int>&)));
 
     // Set parameter set node (if it has been already set in the widget)
     if (d->ParameterSetNode)
@@ -2689,6 +2736,32 @@ void qMRMLSegmentEditorWidget::saveStateForUndo()
     }
 }
 
+//---------------------------------------------------------------------------
+void qMRMLSegmentEditorWidget::onModifierLabelmapModified(const QList<int>& modifiedExtent)
+{
+  Q_D(qMRMLSegmentEditorWidget);
+  if (modifiedExtent.size() != 6)
+    {
+    qCritical() << Q_FUNC_INFO << " failed: extent must have 6 int values";
+    return;
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    if (d->ModifierLabelmapModifiedExtentReported)
+      {
+      // Multiple modifications since the last reset, keep the union of all modified regions
+      d->ModifierLabelmapModifiedExtent[2 * i] = std::min(d->ModifierLabelmapModifiedExtent[2 * i], modifiedExtent[2 * i]);
+      d->ModifierLabelmapModifiedExtent[2 * i + 1] = std::max(d->ModifierLabelmapModifiedExtent[2 * i + 1], modifiedExtent[2 * i + 1]);
+      }
+    else
+      {
+      d->ModifierLabelmapModifiedExtent[2 * i] = modifiedExtent[2 * i];
+      d->ModifierLabelmapModifiedExtent[2 * i + 1] = modifiedExtent[2 * i + 1];
+      }
+    }
+  d->ModifierLabelmapModifiedExtentReported = true;
+}
+
 //---------------------------------------------------------------------------
 void qMRMLSegmentEditorWidget::updateVolume(void* volumeToUpdate, bool& success)
 {
@@ -228,6 +228,10 @@ public slots:
   /// Update modifierLabelmap, maskLabelmap, or alignedMasterVolumeNode
   void updateVolume(void* volumePtr, bool& success);
 
+  /// Record the region of the modifier labelmap that an effect has modified,
+  /// so that only this region is cleared when the modifier labelmap is reset.
+  void onModifierLabelmapModified(const QList<int>& modifiedExtent);
+
   /// Show/hide the segmentation node selector widget.
   void setSegmentationNodeSelectorVisible(bool);
   /// Show/hide the master volume node selector widget.
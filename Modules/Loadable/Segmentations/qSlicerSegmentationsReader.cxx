@@ -91,7 +91,7 @@ qSlicerIO::IOFileType qSlicerSegmentationsReader::fileType()const
 QStringList qSlicerSegmentationsReader::extensions()const
 {
   return QStringList() << "Segmentation (*.seg.nrrd)" << "Segmentation (*.seg.vtm)"
-    << "Segmentation (*.nrrd)" << "Segmentation (*.vtm)"
+    << "Segmentation (*.seg.cvol)" << "Segmentation (*.nrrd)" << "Segmentation (*.vtm)"
     << "Segmentation (*.nii.gz)" << "Segmentation (*.nii)" << "Segmentation (*.hdr)"
     << "Segmentation (*.stl)" << "Segmentation (*.obj)";
 }
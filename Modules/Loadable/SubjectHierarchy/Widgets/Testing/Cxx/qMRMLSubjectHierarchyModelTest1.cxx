@@ -0,0 +1,179 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QDebug>
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// SubjectHierarchy includes
+#include "qMRMLSubjectHierarchyModel.h"
+
+// qMRML includes
+#include "qMRMLWidget.h"
+
+// MRML includes
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSubjectHierarchyNode.h>
+
+// VTK includes
+#include <vtkNew.h>
+
+// STD includes
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// Check that the rows below parentIndex are the same in both models and that
+// each item is found at its own index.
+bool IsSameBranch(qMRMLSubjectHierarchyModel* model, const QModelIndex& parentIndex,
+                  qMRMLSubjectHierarchyModel* baselineModel, const QModelIndex& baselineParentIndex)
+{
+  int rowCount = model->rowCount(parentIndex);
+  if (rowCount != baselineModel->rowCount(baselineParentIndex))
+    {
+    qWarning() << "Row count mismatch under item" << model->subjectHierarchyItemFromIndex(parentIndex)
+               << ":" << rowCount << "!=" << baselineModel->rowCount(baselineParentIndex);
+    return false;
+    }
+  for (int row = 0; row < rowCount; ++row)
+    {
+    QModelIndex index = model->index(row, model->nameColumn(), parentIndex);
+    QModelIndex baselineIndex = baselineModel->index(row, baselineModel->nameColumn(), baselineParentIndex);
+    vtkIdType itemID = model->subjectHierarchyItemFromIndex(index);
+    if (itemID != baselineModel->subjectHierarchyItemFromIndex(baselineIndex))
+      {
+      qWarning() << "Item mismatch at row" << row << "under item" << model->subjectHierarchyItemFromIndex(parentIndex)
+                 << ":" << itemID << "!=" << baselineModel->subjectHierarchyItemFromIndex(baselineIndex);
+      return false;
+      }
+    if (model->data(index).toString() != baselineModel->data(baselineIndex).toString())
+      {
+      qWarning() << "Name mismatch for item" << itemID << ":" << model->data(index).toString()
+                 << "!=" << baselineModel->data(baselineIndex).toString();
+      return false;
+      }
+    if (model->indexFromSubjectHierarchyItem(itemID, model->nameColumn()) != index)
+      {
+      qWarning() << "Index lookup mismatch for item" << itemID;
+      return false;
+      }
+    if (!IsSameBranch(model, index, baselineModel, baselineIndex))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// Compare the model with a model freshly built from the same scene
+bool IsSameAsFreshModel(qMRMLSubjectHierarchyModel* model, vtkMRMLScene* scene)
+{
+  qMRMLSubjectHierarchyModel baselineModel;
+  baselineModel.setMRMLScene(scene);
+  return IsSameBranch(model, model->subjectHierarchySceneIndex(),
+                      &baselineModel, baselineModel.subjectHierarchySceneIndex());
+}
+
+//-----------------------------------------------------------------------------
+std::string ItemName(const char* prefix, int index)
+{
+  std::stringstream ss;
+  ss << prefix << index;
+  return ss.str();
+}
+
+//-----------------------------------------------------------------------------
+// Create folders under parentItemID, each containing a model node item
+std::vector<vtkIdType> CreateFolders(vtkMRMLScene* scene, vtkMRMLSubjectHierarchyNode* shNode,
+                                     vtkIdType parentItemID, const char* prefix, int count)
+{
+  std::vector<vtkIdType> folderItemIDs;
+  for (int index = 0; index < count; ++index)
+    {
+    vtkIdType folderItemID = shNode->CreateFolderItem(parentItemID, ItemName(prefix, index));
+    vtkNew<vtkMRMLModelNode> modelNode;
+    modelNode->SetName(ItemName("Model", index).c_str());
+    scene->AddNode(modelNode.GetPointer());
+    shNode->CreateItem(folderItemID, modelNode.GetPointer());
+    folderItemIDs.push_back(folderItemID);
+    }
+  return folderItemIDs;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qMRMLSubjectHierarchyModelTest1(int argc, char* argv[])
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSubjectHierarchyNode* shNode = vtkMRMLSubjectHierarchyNode::ResolveSubjectHierarchy(scene.GetPointer());
+  CHECK_NOT_NULL(shNode);
+  vtkIdType sceneItemID = shNode->GetSceneItemID();
+
+  qMRMLSubjectHierarchyModel model;
+  model.setMRMLScene(scene.GetPointer());
+
+  // Items added one by one
+  std::vector<vtkIdType> folderItemIDs = CreateFolders(scene.GetPointer(), shNode, sceneItemID, "Folder", 5);
+  std::vector<vtkIdType> subfolderItemIDs = CreateFolders(scene.GetPointer(), shNode, folderItemIDs[0], "Subfolder", 3);
+  CHECK_BOOL(IsSameAsFreshModel(&model, scene.GetPointer()), true);
+
+  // Reparenting and removal one by one
+  shNode->SetItemParent(subfolderItemIDs[1], folderItemIDs[3]);
+  shNode->SetItemParent(folderItemIDs[4], subfolderItemIDs[0]);
+  CHECK_BOOL(IsSameAsFreshModel(&model, scene.GetPointer()), true);
+  shNode->RemoveItem(folderItemIDs[2]);
+  shNode->RemoveItem(subfolderItemIDs[2], true, false); // children are moved to the parent
+  CHECK_BOOL(IsSameAsFreshModel(&model, scene.GetPointer()), true);
+
+  // Bulk changes, the model is rebuilt once when batch processing ends
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  std::vector<vtkIdType> batchFolderItemIDs = CreateFolders(scene.GetPointer(), shNode, sceneItemID, "BatchFolder", 20);
+  for (size_t index = 0; index < batchFolderItemIDs.size(); index += 2)
+    {
+    shNode->SetItemParent(batchFolderItemIDs[index], batchFolderItemIDs[index + 1]);
+    }
+  shNode->SetItemParent(folderItemIDs[1], batchFolderItemIDs[5]);
+  shNode->RemoveItem(batchFolderItemIDs[7]);
+  shNode->RemoveItem(folderItemIDs[0]);
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  CHECK_BOOL(IsSameAsFreshModel(&model, scene.GetPointer()), true);
+
+  // Items added after the batch are inserted one by one again
+  CreateFolders(scene.GetPointer(), shNode, batchFolderItemIDs[9], "LateFolder", 2);
+  shNode->SetItemParent(batchFolderItemIDs[3], sceneItemID);
+  CHECK_BOOL(IsSameAsFreshModel(&model, scene.GetPointer()), true);
+
+  // Removing everything during a batch leaves only the scene item
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  shNode->RemoveAllItems();
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  CHECK_INT(model.rowCount(model.subjectHierarchySceneIndex()), 0);
+  CHECK_BOOL(IsSameAsFreshModel(&model, scene.GetPointer()), true);
+
+  return EXIT_SUCCESS;
+}
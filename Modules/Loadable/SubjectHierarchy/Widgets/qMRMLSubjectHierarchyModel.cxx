@@ -22,6 +22,7 @@
 
 // Qt includes
 #include <QDebug>
+#include <QMap>
 #include <QMimeData>
 #include <QApplication>
 #include <QMessageBox>
@@ -81,6 +82,7 @@ qMRMLSubjectHierarchyModelPrivate::qMRMLSubjectHierarchyModelPrivate(qMRMLSubjec
   this->DeformableTransformIcon = QIcon(":Icons/DeformableTransform.png");
 
   this->DelayedItemChangedInvoked = false;
+  this->RebuildPending = false;
 
   qRegisterMetaType<QStandardItem*>("QStandardItem*");
 }
@@ -106,6 +108,11 @@ void qMRMLSubjectHierarchyModelPrivate::init()
   this->CallBack->SetCallback(qMRMLSubjectHierarchyModel::onEvent);
 
   QObject::connect(q, SIGNAL(itemChanged(QStandardItem*)), q, SLOT(onItemChanged(QStandardItem*)));
+  // Connected before any view so that the item cache is up-to-date when views are notified
+  QObject::connect(q, SIGNAL(rowsInserted(QModelIndex,int,int)),
+                   q, SLOT(onRowsInserted(QModelIndex,int,int)));
+  QObject::connect(q, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)),
+                   q, SLOT(onRowsAboutToBeRemoved(QModelIndex,int,int)));
 
   q->setNameColumn(0);
   q->setDescriptionColumn(1);
@@ -179,6 +186,114 @@ QStandardItem* qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItem(vtk
   return item;
 }
 
+//------------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyModelPrivate::populateItems(std::vector<vtkIdType>& allItemIDs)
+{
+  Q_Q(qMRMLSubjectHierarchyModel);
+
+  this->ItemCache.clear();
+
+  // Enabled so it can be interacted with
+  q->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
+
+  if (!this->SubjectHierarchyNode)
+    {
+    // Remove all items
+    const int oldColumnCount = q->columnCount();
+    q->removeRows(0, q->rowCount());
+    q->setColumnCount(oldColumnCount);
+    return false;
+    }
+  else if (!q->subjectHierarchySceneItem())
+    {
+    // No subject hierarchy root item has been created yet, but the subject hierarchy
+    // node is valid, so we need to create a scene item
+    vtkIdType sceneItemID = this->SubjectHierarchyNode->GetSceneItemID();
+    QList<QStandardItem*> sceneItems;
+    QStandardItem* sceneItem = new QStandardItem();
+    sceneItem->setFlags(Qt::ItemIsDropEnabled | Qt::ItemIsEnabled);
+    sceneItem->setText("Scene");
+    sceneItem->setData(sceneItemID, qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole);
+    sceneItems << sceneItem;
+    for (int i = 1; i < q->columnCount(); ++i)
+      {
+      QStandardItem* sceneOtherColumn = new QStandardItem();
+      sceneOtherColumn->setFlags(nullptr);
+      sceneItems << sceneOtherColumn;
+      }
+    sceneItem->setColumnCount(q->columnCount());
+    q->insertRow(0, sceneItems);
+    }
+  else
+    {
+    // Update the scene item index in case subject hierarchy node has changed
+    q->subjectHierarchySceneItem()->setData(
+      QVariant::fromValue(this->SubjectHierarchyNode->GetSceneItemID()), qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole );
+    }
+
+  QStandardItem* sceneItem = q->subjectHierarchySceneItem();
+  if (!sceneItem)
+    {
+    qCritical() << Q_FUNC_INFO << ": Failed to create subject hierarchy scene item";
+    return false;
+    }
+
+  // Remove rows before populating
+  sceneItem->removeRows(0, sceneItem->rowCount());
+  this->ItemCache[this->SubjectHierarchyNode->GetSceneItemID()] = sceneItem;
+
+  // Populate subject hierarchy with the items
+  this->SubjectHierarchyNode->GetItemChildren(this->SubjectHierarchyNode->GetSceneItemID(), allItemIDs, true);
+  for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
+    {
+    vtkIdType itemID = (*itemIt);
+    int index = this->SubjectHierarchyNode->GetItemPositionUnderParent(itemID);
+    this->insertSubjectHierarchyItem(itemID, index);
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::addToItemCache(QStandardItem* item)
+{
+  if (!item)
+    {
+    return;
+    }
+  QVariant itemID = item->data(qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole);
+  if (itemID.isValid())
+    {
+    this->ItemCache[itemID.toLongLong()] = item;
+    }
+  for (int row = 0; row < item->rowCount(); ++row)
+    {
+    this->addToItemCache(item->child(row, 0));
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::removeFromItemCache(QStandardItem* item)
+{
+  if (!item)
+    {
+    return;
+    }
+  QVariant itemID = item->data(qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole);
+  if (itemID.isValid())
+    {
+    QHash<vtkIdType, QStandardItem*>::iterator cacheIt = this->ItemCache.find(itemID.toLongLong());
+    // The entry may already point to a new item of the same subject hierarchy item
+    if (cacheIt != this->ItemCache.end() && cacheIt.value() == item)
+      {
+      this->ItemCache.erase(cacheIt);
+      }
+    }
+  for (int row = 0; row < item->rowCount(); ++row)
+    {
+    this->removeFromItemCache(item->child(row, 0));
+    }
+}
+
 //------------------------------------------------------------------------------
 vtkSlicerTerminologiesModuleLogic* qMRMLSubjectHierarchyModelPrivate::terminologiesModuleLogic()
 {
@@ -371,47 +486,20 @@ QModelIndex qMRMLSubjectHierarchyModel::indexFromSubjectHierarchyItem(vtkIdType
 {
   Q_D(const qMRMLSubjectHierarchyModel);
 
-  QModelIndex itemIndex;
   if (!itemID)
     {
-    return itemIndex;
-    }
-
-  // Try to find the nodeIndex in the cache first
-  QMap<vtkIdType,QPersistentModelIndex>::iterator rowCacheIt = d->RowCache.find(itemID);
-  if (rowCacheIt==d->RowCache.end())
-    {
-    // Not found in cache, therefore it cannot be in the model
-    return itemIndex;
-    }
-  if (rowCacheIt.value().isValid())
-    {
-    // An entry found in the cache. If the item at the cached index matches the requested item ID then we use it.
-    QStandardItem* item = this->itemFromIndex(rowCacheIt.value());
-    if (item && item->data(qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole).toLongLong() == itemID)
-      {
-      // ID matched
-      itemIndex = rowCacheIt.value();
-      }
+    return QModelIndex();
     }
 
-  // The cache was not up-to-date. Do a slow linear search.
-  if (!itemIndex.isValid())
+  QStandardItem* item = d->ItemCache.value(itemID, nullptr);
+  if (!item)
     {
-    // QAbstractItemModel::match doesn't browse through columns, we need to do it manually
-    QModelIndexList itemIndexes = this->match(
-      this->subjectHierarchySceneIndex(), SubjectHierarchyItemIDRole, itemID, 1, Qt::MatchExactly | Qt::MatchRecursive);
-    if (itemIndexes.size() == 0)
-      {
-      d->RowCache.remove(itemID);
-      return QModelIndex();
-      }
-    itemIndex = itemIndexes[0];
-    d->RowCache[itemID] = itemIndex;
+    // Not found in cache, therefore it is not in the model
+    return QModelIndex();
     }
-  if (column == 0)
+  QModelIndex itemIndex = item->index();
+  if (column == 0 || !itemIndex.isValid())
     {
-    // QAbstractItemModel::match only search through the first column
     return itemIndex;
     }
   // Add the QModelIndexes from the other columns
@@ -428,21 +516,16 @@ QModelIndex qMRMLSubjectHierarchyModel::indexFromSubjectHierarchyItem(vtkIdType
 //------------------------------------------------------------------------------
 QModelIndexList qMRMLSubjectHierarchyModel::indexes(vtkIdType itemID)const
 {
-  QModelIndex scene = this->subjectHierarchySceneIndex();
-  if (scene == QModelIndex())
+  QModelIndex itemIndex = this->indexFromSubjectHierarchyItem(itemID);
+  if (!itemIndex.isValid())
     {
     return QModelIndexList();
     }
-  // QAbstractItemModel::match doesn't browse through columns, we need to do it manually
-  QModelIndexList shItemIndexes = this->match(
-    scene, qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole, QVariant(qlonglong(itemID)), 1, Qt::MatchExactly | Qt::MatchRecursive);
-  if (shItemIndexes.size() != 1)
-    {
-    return QModelIndexList(); // If 0 it's empty, if >1 it's invalid (one item for each UID)
-    }
+  QModelIndexList shItemIndexes;
+  shItemIndexes << itemIndex;
   // Add the QModelIndexes from the other columns
-  const int row = shItemIndexes[0].row();
-  QModelIndex shItemParentIndex = shItemIndexes[0].parent();
+  const int row = itemIndex.row();
+  QModelIndex shItemParentIndex = itemIndex.parent();
   const int sceneColumnCount = this->columnCount(shItemParentIndex);
   for (int col=1; col<sceneColumnCount; ++col)
     {
@@ -682,67 +765,19 @@ void qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy()
 {
   Q_D(qMRMLSubjectHierarchyModel);
 
-  d->RowCache.clear();
-
-  // Enabled so it can be interacted with
-  this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
-
-  if (!d->SubjectHierarchyNode)
-    {
-    // Remove all items
-    const int oldColumnCount = this->columnCount();
-    this->removeRows(0, this->rowCount());
-    this->setColumnCount(oldColumnCount);
-    return;
-    }
-  else if (!this->subjectHierarchySceneItem())
-    {
-    // No subject hierarchy root item has been created yet, but the subject hierarchy
-    // node is valid, so we need to create a scene item
-    vtkIdType sceneItemID = d->SubjectHierarchyNode->GetSceneItemID();
-    QList<QStandardItem*> sceneItems;
-    QStandardItem* sceneItem = new QStandardItem();
-    sceneItem->setFlags(Qt::ItemIsDropEnabled | Qt::ItemIsEnabled);
-    sceneItem->setText("Scene");
-    sceneItem->setData(sceneItemID, qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole);
-    sceneItems << sceneItem;
-    for (int i = 1; i < this->columnCount(); ++i)
-      {
-      QStandardItem* sceneOtherColumn = new QStandardItem();
-      sceneOtherColumn->setFlags(nullptr);
-      sceneItems << sceneOtherColumn;
-      }
-    sceneItem->setColumnCount(this->columnCount());
-
-    d->RowCache[sceneItemID] = QModelIndex(); // Insert invalid item in cache to indicate that item is in the model but its index is unknown
-    this->insertRow(0, sceneItems);
-    d->RowCache[sceneItemID] = sceneItem->index();
-    }
-  else
-    {
-    // Update the scene item index in case subject hierarchy node has changed
-    this->subjectHierarchySceneItem()->setData(
-      QVariant::fromValue(d->SubjectHierarchyNode->GetSceneItemID()), qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole );
-    d->RowCache[d->SubjectHierarchyNode->GetSceneItemID()] = this->subjectHierarchySceneItem()->index();
-    }
-
-  if (!this->subjectHierarchySceneItem())
-    {
-    qCritical() << Q_FUNC_INFO << ": Failed to create subject hierarchy scene item";
-    return;
-    }
-
-  // Remove rows before populating
-  this->subjectHierarchySceneItem()->removeRows(0, this->subjectHierarchySceneItem()->rowCount());
+  d->RebuildPending = false;
 
-  // Populate subject hierarchy with the items
+  // Notifying the views about the insertion of each item is much slower than having them
+  // reset once, therefore the items are populated with signals blocked.
   std::vector<vtkIdType> allItemIDs;
-  d->SubjectHierarchyNode->GetItemChildren(d->SubjectHierarchyNode->GetSceneItemID(), allItemIDs, true);
-  for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
+  this->beginResetModel();
+  bool wasBlocked = this->blockSignals(true);
+  bool populated = d->populateItems(allItemIDs);
+  this->blockSignals(wasBlocked);
+  this->endResetModel();
+  if (!populated)
     {
-    vtkIdType itemID = (*itemIt);
-    int index = d->SubjectHierarchyNode->GetItemPositionUnderParent(itemID);
-    d->insertSubjectHierarchyItem(itemID, index);
+    return;
     }
 
   // Update expanded states (during inserting the update calls did not find valid indices, so
@@ -781,7 +816,7 @@ void qMRMLSubjectHierarchyModel::updateFromSubjectHierarchy()
     // Update the scene item index in case subject hierarchy node has changed
     this->subjectHierarchySceneItem()->setData(
       QVariant::fromValue(d->SubjectHierarchyNode->GetSceneItemID()), qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole );
-    d->RowCache[d->SubjectHierarchyNode->GetSceneItemID()] = this->subjectHierarchySceneItem()->index();
+    d->ItemCache[d->SubjectHierarchyNode->GetSceneItemID()] = this->subjectHierarchySceneItem();
     }
 
 
@@ -829,12 +864,10 @@ QStandardItem* qMRMLSubjectHierarchyModel::insertSubjectHierarchyItem(vtkIdType
     items.append(newItem);
     }
 
-  // Insert an invalid item in the cache to indicate that the subject hierarchy item is in the
-  // model but we don't know its index yet. This is needed because a custom widget may be notified
-  // abot row insertion before insertRow() returns (and the RowCache entry is added).
-  d->RowCache[itemID] = QModelIndex();
+  // The item cache is updated in onRowsInserted() before the views are notified about the
+  // new row. Signals are blocked while the model is rebuilt, so the item is added here as well.
   parent->insertRow(row, items);
-  d->RowCache[itemID] = items[0]->index();
+  d->ItemCache[itemID] = items[0];
 
   return items[0];
 }
@@ -1439,6 +1472,13 @@ void qMRMLSubjectHierarchyModel::onEvent(
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAdded(vtkIdType itemID)
 {
+  Q_D(qMRMLSubjectHierarchyModel);
+  if (d->MRMLScene && d->MRMLScene->IsBatchProcessing())
+    {
+    // Insert all the items at once when batch processing ends
+    d->RebuildPending = true;
+    return;
+    }
   this->insertSubjectHierarchyItem(itemID);
 }
 
@@ -1448,14 +1488,14 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAboutToBeRemoved(vtkIdTyp
   Q_D(qMRMLSubjectHierarchyModel);
   if (d->MRMLScene->IsClosing() || d->MRMLScene->IsBatchProcessing())
     {
+    d->RebuildPending = true;
     return;
     }
 
-  QModelIndexList itemIndexes = this->match(
-    this->subjectHierarchySceneIndex(), SubjectHierarchyItemIDRole, itemID, 1, Qt::MatchExactly | Qt::MatchRecursive );
-  if (itemIndexes.count() > 0)
+  QModelIndex itemIndex = this->indexFromSubjectHierarchyItem(itemID);
+  if (itemIndex.isValid())
     {
-    QStandardItem* item = this->itemFromIndex(itemIndexes[0].sibling(itemIndexes[0].row(),0));
+    QStandardItem* item = this->itemFromIndex(itemIndex);
     // The children may be lost if not reparented, we ensure they got reparented.
     while (item->rowCount())
       {
@@ -1470,7 +1510,7 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAboutToBeRemoved(vtkIdTyp
         d->Orphans.removeAll(orphans);
         }
       }
-    this->removeRow(itemIndexes[0].row(), itemIndexes[0].parent());
+    this->removeRow(itemIndex.row(), itemIndex.parent());
     }
 }
 
@@ -1516,7 +1556,13 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemModified(vtkIdType itemID
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onMRMLSceneImported(vtkMRMLScene* scene)
 {
-  Q_UNUSED(scene);
+  Q_D(qMRMLSubjectHierarchyModel);
+  if (scene && scene->IsBatchProcessing())
+    {
+    // Import is part of a larger batch process, rebuild only once at the end
+    d->RebuildPending = true;
+    return;
+    }
   this->rebuildFromSubjectHierarchy();
 }
 
@@ -1543,7 +1589,14 @@ void qMRMLSubjectHierarchyModel::onMRMLSceneStartBatchProcess(vtkMRMLScene* scen
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onMRMLSceneEndBatchProcess(vtkMRMLScene* scene)
 {
+  Q_D(qMRMLSubjectHierarchyModel);
   Q_UNUSED(scene);
+  if (d->RebuildPending)
+    {
+    // Items were added or removed during batch processing
+    this->rebuildFromSubjectHierarchy();
+    return;
+    }
   this->updateFromSubjectHierarchy();
 }
 
@@ -1615,6 +1668,36 @@ void qMRMLSubjectHierarchyModel::delayedItemChanged()
   d->DelayedItemChangedInvoked = false;
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModel::onRowsInserted(const QModelIndex& parent, int start, int end)
+{
+  Q_D(qMRMLSubjectHierarchyModel);
+  QStandardItem* parentItem = parent.isValid() ? this->itemFromIndex(parent) : this->invisibleRootItem();
+  if (!parentItem || parent.column() > 0)
+    {
+    return;
+    }
+  for (int row = start; row <= end; ++row)
+    {
+    d->addToItemCache(parentItem->child(row, 0));
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModel::onRowsAboutToBeRemoved(const QModelIndex& parent, int start, int end)
+{
+  Q_D(qMRMLSubjectHierarchyModel);
+  QStandardItem* parentItem = parent.isValid() ? this->itemFromIndex(parent) : this->invisibleRootItem();
+  if (!parentItem || parent.column() > 0)
+    {
+    return;
+    }
+  for (int row = start; row <= end; ++row)
+    {
+    d->removeFromItemCache(parentItem->child(row, 0));
+    }
+}
+
 //------------------------------------------------------------------------------
 Qt::DropActions qMRMLSubjectHierarchyModel::supportedDropActions()const
 {
@@ -192,6 +192,11 @@ protected slots:
   virtual void onItemChanged(QStandardItem* item);
   virtual void delayedItemChanged();
 
+  /// Keep the item cache up-to-date when rows are inserted or removed,
+  /// including when items are reparented or moved.
+  void onRowsInserted(const QModelIndex& parent, int start, int end);
+  void onRowsAboutToBeRemoved(const QModelIndex& parent, int start, int end);
+
   /// Recompute the number of columns in the model. Called when a [some]Column property is set.
   /// Needs maxColumnId() to be reimplemented in subclasses
   void updateColumnCount();
@@ -204,6 +209,7 @@ protected:
 
   /// Rebuild model from scratch.
   /// This is a hard-update that is uses more resources. Use sparingly.
+  /// Views are notified by a single model reset instead of one row insertion per item.
   virtual void rebuildFromSubjectHierarchy();
   /// Updates properties in the model based on subject hierarchy.
   /// This is a soft update that is quick. Calls \sa rebuildFromSubjectHierarchy if necessary.
@@ -36,7 +36,7 @@
 
 // Qt includes
 #include <QFlags>
-#include <QMap>
+#include <QHash>
 
 // SubjectHierarchy includes
 #include "qSlicerSubjectHierarchyModuleWidgetsExport.h"
@@ -79,6 +79,16 @@ public:
   /// Get terminologies module logic. If not found in cache get from module object
   vtkSlicerTerminologiesModuleLogic* terminologiesModuleLogic();
 
+  /// Create the scene item if needed and insert all the subject hierarchy items.
+  /// No signal is expected to be emitted during the population (\sa rebuildFromSubjectHierarchy).
+  /// \return False if there is no valid subject hierarchy to populate the model from.
+  bool populateItems(std::vector<vtkIdType>& allItemIDs);
+
+  /// Add the item and all its descendants to the item cache
+  void addToItemCache(QStandardItem* item);
+  /// Remove the item and all its descendants from the item cache
+  void removeFromItemCache(QStandardItem* item);
+
 public:
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   int PendingItemModified;
@@ -114,11 +124,15 @@ public:
   // unreachable when browsing the model
   QList<QList<QStandardItem*> > Orphans;
 
-  // Map from subject hierarchy item to row.
-  // It just stores the result of the latest lookup by \sa indexFromSubjectHierarchyItem,
-  // not guaranteed to contain up-to-date information, should be just used as a search hint.
-  // If the item cannot be found at the given index then we need to browse through all model items.
-  mutable QMap<vtkIdType, QPersistentModelIndex> RowCache;
+  // Map from subject hierarchy item to the model item of the first column.
+  // It is updated when rows are inserted into or removed from the model (which includes moving
+  // and reparenting items), therefore the parent and row of an item are always known without
+  // browsing through the model items.
+  QHash<vtkIdType, QStandardItem*> ItemCache;
+
+  // Set if subject hierarchy items were added or removed while the scene was batch processing.
+  // The model is then rebuilt once when batch processing ends.
+  bool RebuildPending;
 };
 
 #endif
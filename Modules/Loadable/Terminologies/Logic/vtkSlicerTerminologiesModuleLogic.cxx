@@ -44,6 +44,7 @@
 
 // STD includes
 #include <algorithm>
+#include <unordered_map>
 
 #include "rapidjson/document.h"     // rapidjson's DOM-style API
 #include "rapidjson/prettywriter.h" // for stringify JSON
@@ -69,11 +70,61 @@ public:
   vtkInternal();
   ~vtkInternal();
 
+  /// Lookup and search index of a Json code array (categories, types, regions, or modifiers)
+  struct CodeArrayIndex
+    {
+    /// Size of the array when the index was built
+    rapidjson::SizeType ArraySize{0};
+    /// Position in the array of each code, key is given by \sa GetCodeKey
+    std::unordered_map<std::string, rapidjson::SizeType> PositionByCode;
+    /// Valid codes (with designator, value, and meaning) in array order
+    std::vector<CodeIdentifier> Codes;
+    /// Lowercase code meanings, same order as \sa Codes
+    std::vector<std::string> LowerCaseNames;
+    /// Last search string and the positions in \sa Codes that matched it.
+    /// When the search string is extended (e.g. while typing in a search box)
+    /// only the previous matches need to be tested.
+    std::string LastSearch;
+    std::vector<size_t> LastMatches;
+    };
+  typedef std::map<const rapidjson::Value*, CodeArrayIndex> CodeArrayIndexMap;
+
+  /// Terminology entry containing a given 3dSlicerLabel attribute
+  struct SlicerLabelEntry
+    {
+    CodeIdentifier CategoryId;
+    CodeIdentifier TypeId;
+    CodeIdentifier TypeModifierId;
+    };
+  typedef std::unordered_map<std::string, SlicerLabelEntry> SlicerLabelMap;
+
   /// Utility function to get code in Json array
+  /// Indexed arrays (i.e. arrays of loaded contexts) are looked up in constant time,
+  /// other arrays are traversed.
   /// \param foundIndex Output parameter for index of found object in input array. -1 if not found
   /// \return Json object if found, otherwise null Json object
   rapidjson::Value& GetCodeInArray(CodeIdentifier codeId, rapidjson::Value& jsonArray, int &foundIndex);
 
+  /// Get codes in Json array with code meaning containing a given string
+  /// \param search Lowercase string to look for. All valid codes are returned if empty
+  void FindCodesInArray(rapidjson::Value& jsonArray, const std::string& search, std::vector<CodeIdentifier>& codes);
+
+  /// Get key of a code in \sa CodeArrayIndex::PositionByCode
+  static std::string GetCodeKey(const std::string& codingSchemeDesignator, const std::string& codeValue)
+    {
+    std::string key(codingSchemeDesignator);
+    key.push_back('\0');
+    key.append(codeValue);
+    return key;
+    }
+
+  /// Build index of a Json code array (and of the modifier or type arrays of its items
+  /// if \a nestedArrayName is specified)
+  void AddCodeArrayIndex(rapidjson::Value& jsonArray, const char* nestedArrayName=nullptr, const char* nestedNestedArrayName=nullptr);
+  /// Rebuild the indices of all loaded terminologies and anatomic contexts.
+  /// Must be called whenever a loaded Json document is changed.
+  void UpdateCodeArrayIndices();
+
   /// Get root Json value for the terminology with given name
   rapidjson::Value& GetTerminologyRootByName(std::string terminologyName);
 
@@ -138,13 +189,15 @@ public:
   void GetJsonCodeFromIdentifier(rapidjson::Value& code, CodeIdentifier identifier, rapidjson::Document::AllocatorType& allocator);
 
   /// Utility function for safe (memory-leak-free) setting of a document pointer in map
-  static void SetDocumentInTerminologyMap(TerminologyMap& terminologyMap, const std::string& name, rapidjson::Document* doc)
+  /// Indices of the loaded contexts are updated.
+  void SetDocumentInTerminologyMap(TerminologyMap& terminologyMap, const std::string& name, rapidjson::Document* doc)
     {
     if (terminologyMap.find(name) != terminologyMap.end())
       {
       if (doc == terminologyMap[name])
         {
-        // The two objects are the same, there is nothing to do
+        // The two objects are the same, only the content may have changed
+        this->UpdateCodeArrayIndices();
         return;
         }
       // Make sure the previous document object is deleted
@@ -152,6 +205,7 @@ public:
       }
     // Set new document object
     terminologyMap[name] = doc;
+    this->UpdateCodeArrayIndices();
     }
 
 public:
@@ -160,6 +214,12 @@ public:
 
   /// Loaded anatomical region contexts. Key is the context name, value is the root item.
   TerminologyMap LoadedAnatomicContexts;
+
+  /// Indices of the code arrays of the loaded contexts. Key is the array Json value.
+  CodeArrayIndexMap CodeArrayIndices;
+
+  /// 3dSlicerLabel index of the loaded terminologies. Key is the context name.
+  std::map<std::string, SlicerLabelMap> SlicerLabelIndices;
 };
 
 //---------------------------------------------------------------------------
@@ -192,6 +252,21 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeInArray
     return JSON_EMPTY_VALUE;
     }
 
+  // Use index if the array belongs to a loaded context
+  CodeArrayIndexMap::iterator indexIt = this->CodeArrayIndices.find(&jsonArray);
+  if (indexIt != this->CodeArrayIndices.end() && indexIt->second.ArraySize == jsonArray.Size())
+    {
+    std::unordered_map<std::string, rapidjson::SizeType>::iterator positionIt =
+      indexIt->second.PositionByCode.find(GetCodeKey(codeId.CodingSchemeDesignator, codeId.CodeValue));
+    if (positionIt == indexIt->second.PositionByCode.end())
+      {
+      foundIndex = -1;
+      return JSON_EMPTY_VALUE;
+      }
+    foundIndex = static_cast<int>(positionIt->second);
+    return jsonArray[positionIt->second];
+    }
+
   // Traverse array and try to find the object with given identifier
   rapidjson::SizeType index = 0;
   while (index<jsonArray.Size())
@@ -216,6 +291,207 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeInArray
   return JSON_EMPTY_VALUE;
 }
 
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::FindCodesInArray(
+  rapidjson::Value& jsonArray, const std::string& search, std::vector<CodeIdentifier>& codes)
+{
+  codes.clear();
+  if (!jsonArray.IsArray())
+    {
+    return;
+    }
+
+  CodeArrayIndexMap::iterator indexIt = this->CodeArrayIndices.find(&jsonArray);
+  if (indexIt == this->CodeArrayIndices.end() || indexIt->second.ArraySize != jsonArray.Size())
+    {
+    this->AddCodeArrayIndex(jsonArray);
+    indexIt = this->CodeArrayIndices.find(&jsonArray);
+    }
+  CodeArrayIndex& codeIndex = indexIt->second;
+
+  if (search.empty())
+    {
+    codes = codeIndex.Codes;
+    return;
+    }
+
+  // If the new search string contains the previous one then only the previous matches can match
+  std::vector<size_t> matches;
+  if (!codeIndex.LastSearch.empty() && search.find(codeIndex.LastSearch) != std::string::npos)
+    {
+    for (size_t position : codeIndex.LastMatches)
+      {
+      if (codeIndex.LowerCaseNames[position].find(search) != std::string::npos)
+        {
+        matches.push_back(position);
+        }
+      }
+    }
+  else
+    {
+    for (size_t position = 0; position < codeIndex.LowerCaseNames.size(); ++position)
+      {
+      if (codeIndex.LowerCaseNames[position].find(search) != std::string::npos)
+        {
+        matches.push_back(position);
+        }
+      }
+    }
+
+  codes.reserve(matches.size());
+  for (size_t position : matches)
+    {
+    codes.push_back(codeIndex.Codes[position]);
+    }
+  codeIndex.LastSearch = search;
+  codeIndex.LastMatches.swap(matches);
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::AddCodeArrayIndex(
+  rapidjson::Value& jsonArray, const char* nestedArrayName/*=nullptr*/, const char* nestedNestedArrayName/*=nullptr*/)
+{
+  if (!jsonArray.IsArray())
+    {
+    return;
+    }
+
+  CodeArrayIndex& codeIndex = this->CodeArrayIndices[&jsonArray];
+  codeIndex = CodeArrayIndex();
+  codeIndex.ArraySize = jsonArray.Size();
+  codeIndex.PositionByCode.reserve(jsonArray.Size());
+
+  for (rapidjson::SizeType index = 0; index < jsonArray.Size(); ++index)
+    {
+    rapidjson::Value& currentObject = jsonArray[index];
+    if (!currentObject.IsObject())
+      {
+      continue;
+      }
+    rapidjson::Value::MemberIterator codingSchemeDesignator = currentObject.FindMember("CodingSchemeDesignator");
+    rapidjson::Value::MemberIterator codeValue = currentObject.FindMember("CodeValue");
+    rapidjson::Value::MemberIterator codeMeaning = currentObject.FindMember("CodeMeaning");
+    if ( codingSchemeDesignator == currentObject.MemberEnd() || !codingSchemeDesignator->value.IsString()
+      || codeValue == currentObject.MemberEnd() || !codeValue->value.IsString() )
+      {
+      vtkGenericWarningMacro("AddCodeArrayIndex: Invalid code at index " << index);
+      continue;
+      }
+
+    // First occurrence of a code is used, as when traversing the array
+    codeIndex.PositionByCode.emplace(
+      GetCodeKey(codingSchemeDesignator->value.GetString(), codeValue->value.GetString()), index);
+
+    if (codeMeaning != currentObject.MemberEnd() && codeMeaning->value.IsString())
+      {
+      std::string name = codeMeaning->value.GetString();
+      codeIndex.Codes.emplace_back(codingSchemeDesignator->value.GetString(), codeValue->value.GetString(), name);
+      // Make lowercase for case-insensitive comparison
+      std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+      codeIndex.LowerCaseNames.push_back(name);
+      }
+
+    if (nestedArrayName)
+      {
+      rapidjson::Value::MemberIterator nestedArray = currentObject.FindMember(nestedArrayName);
+      if (nestedArray != currentObject.MemberEnd())
+        {
+        this->AddCodeArrayIndex(nestedArray->value, nestedNestedArrayName);
+        }
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::UpdateCodeArrayIndices()
+{
+  this->CodeArrayIndices.clear();
+  this->SlicerLabelIndices.clear();
+
+  for (TerminologyMap::iterator termIt = this->LoadedTerminologies.begin();
+    termIt != this->LoadedTerminologies.end(); ++termIt)
+    {
+    rapidjson::Value& categoryArray = this->GetCategoryArrayInTerminology(termIt->first);
+    if (categoryArray.IsNull())
+      {
+      continue;
+      }
+    // Categories contain types, types contain modifiers
+    this->AddCodeArrayIndex(categoryArray, "Type", "Modifier");
+
+    // Collect 3dSlicerLabel attributes in traversal order so that the first
+    // occurrence of each label is kept
+    SlicerLabelMap& slicerLabels = this->SlicerLabelIndices[termIt->first];
+    for (const CodeIdentifier& categoryId : this->CodeArrayIndices[&categoryArray].Codes)
+      {
+      int foundCategoryIndex = -1;
+      rapidjson::Value& category = this->GetCodeInArray(categoryId, categoryArray, foundCategoryIndex);
+      if (!category.IsObject())
+        {
+        continue;
+        }
+      rapidjson::Value::MemberIterator typeArrayIt = category.FindMember("Type");
+      if (typeArrayIt == category.MemberEnd() || !typeArrayIt->value.IsArray())
+        {
+        continue;
+        }
+      rapidjson::Value& typeArray = typeArrayIt->value;
+      for (const CodeIdentifier& typeId : this->CodeArrayIndices[&typeArray].Codes)
+        {
+        int foundTypeIndex = -1;
+        rapidjson::Value& type = this->GetCodeInArray(typeId, typeArray, foundTypeIndex);
+        if (!type.IsObject())
+          {
+          continue;
+          }
+        rapidjson::Value::MemberIterator slicerLabelIt = type.FindMember("3dSlicerLabel");
+        if (slicerLabelIt != type.MemberEnd() && slicerLabelIt->value.IsString())
+          {
+          SlicerLabelEntry labelEntry;
+          labelEntry.CategoryId = categoryId;
+          labelEntry.TypeId = typeId;
+          slicerLabels.emplace(slicerLabelIt->value.GetString(), labelEntry);
+          }
+        rapidjson::Value::MemberIterator typeModifierArrayIt = type.FindMember("Modifier");
+        if (typeModifierArrayIt == type.MemberEnd() || !typeModifierArrayIt->value.IsArray())
+          {
+          continue;
+          }
+        rapidjson::Value& typeModifierArray = typeModifierArrayIt->value;
+        for (const CodeIdentifier& typeModifierId : this->CodeArrayIndices[&typeModifierArray].Codes)
+          {
+          int foundTypeModifierIndex = -1;
+          rapidjson::Value& typeModifier = this->GetCodeInArray(typeModifierId, typeModifierArray, foundTypeModifierIndex);
+          if (!typeModifier.IsObject())
+            {
+            continue;
+            }
+          rapidjson::Value::MemberIterator modifierSlicerLabelIt = typeModifier.FindMember("3dSlicerLabel");
+          if (modifierSlicerLabelIt != typeModifier.MemberEnd() && modifierSlicerLabelIt->value.IsString())
+            {
+            SlicerLabelEntry labelEntry;
+            labelEntry.CategoryId = categoryId;
+            labelEntry.TypeId = typeId;
+            labelEntry.TypeModifierId = typeModifierId;
+            slicerLabels.emplace(modifierSlicerLabelIt->value.GetString(), labelEntry);
+            }
+          }
+        }
+      }
+    }
+
+  for (TerminologyMap::iterator anIt = this->LoadedAnatomicContexts.begin();
+    anIt != this->LoadedAnatomicContexts.end(); ++anIt)
+    {
+    rapidjson::Value& regionArray = this->GetRegionArrayInAnatomicContext(anIt->first);
+    if (!regionArray.IsNull())
+      {
+      // Regions contain modifiers
+      this->AddCodeArrayIndex(regionArray, "Modifier");
+      }
+    }
+}
+
 //---------------------------------------------------------------------------
 rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetTerminologyRootByName(std::string terminologyName)
 {
@@ -1062,7 +1338,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadContextFromFile(std::string filePath
     {
     // Store terminology
     std::string contextName = (*jsonRoot)["SegmentationCategoryTypeContextName"].GetString();
-    vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+    this->Internal->SetDocumentInTerminologyMap(
       this->Internal->LoadedTerminologies, contextName, jsonRoot);
     vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
     }
@@ -1070,7 +1346,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadContextFromFile(std::string filePath
     {
     // Store anatomic context
     std::string contextName = (*jsonRoot)["AnatomicContextName"].GetString();
-    vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+    this->Internal->SetDocumentInTerminologyMap(
       this->Internal->LoadedAnatomicContexts, contextName, jsonRoot);
     vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
     }
@@ -1124,7 +1400,7 @@ std::string vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromFile(std::stri
 
   // Store terminology
   std::string contextName = (*terminologyRoot)["SegmentationCategoryTypeContextName"].GetString();
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedTerminologies, contextName, terminologyRoot);
 
   vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1169,12 +1445,13 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
   if (!success)
     {
     vtkErrorMacro("LoadTerminologyFromSegmentDescriptorFile: Failed to parse descriptor file '" << filePath);
+    this->Internal->UpdateCodeArrayIndices();
     fclose(fp);
     return false;
     }
 
   // Store terminology
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedTerminologies, contextName, convertedDoc );
 
   vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1238,7 +1515,7 @@ std::string vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromFile(std::
 
   // Store anatomic context
   std::string contextName = (*anatomicContextRoot)["AnatomicContextName"].GetString();
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedAnatomicContexts, contextName, anatomicContextRoot);
 
   vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1283,12 +1560,13 @@ bool vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromSegmentDescriptor
   if (!success)
     {
     // Anatomic context is optional in descriptor file
+    this->Internal->UpdateCodeArrayIndices();
     fclose(fp);
     return false;
     }
 
   // Store anatomic context
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedAnatomicContexts, contextName, convertedDoc );
 
   vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1425,35 +1703,8 @@ bool vtkSlicerTerminologiesModuleLogic::FindCategoriesInTerminology(std::string
   // Make lowercase for case-insensitive comparison
   std::transform(search.begin(), search.end(), search.begin(), ::tolower);
 
-  // Traverse categories
-  rapidjson::SizeType index = 0;
-  while (index < categoryArray.Size())
-    {
-    rapidjson::Value& category = categoryArray[index];
-    if (category.IsObject())
-      {
-      rapidjson::Value& categoryName = category["CodeMeaning"];
-      rapidjson::Value& categoryCodingSchemeDesignator = category["CodingSchemeDesignator"];
-      rapidjson::Value& categoryCodeValue = category["CodeValue"];
-      if (categoryName.IsString() && categoryCodingSchemeDesignator.IsString() && categoryCodeValue.IsString())
-        {
-        // Add category to list if search string is empty or is contained by the current category name
-        std::string categoryNameStr = categoryName.GetString();
-        std::string categoryNameLowerCase(categoryNameStr);
-        std::transform(categoryNameLowerCase.begin(), categoryNameLowerCase.end(), categoryNameLowerCase.begin(), ::tolower);
-        if (search.empty() || categoryNameLowerCase.find(search) != std::string::npos)
-          {
-          CodeIdentifier categoryId(categoryCodingSchemeDesignator.GetString(), categoryCodeValue.GetString(), categoryNameStr);
-          categories.push_back(categoryId);
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindCategoriesInTerminology: Invalid category '" << categoryName.GetString() << "' in terminology '" << terminologyName << "'");
-        }
-      }
-    ++index;
-    }
+  // Add categories with names containing the search string
+  this->Internal->FindCodesInArray(categoryArray, search, categories);
 
   return true;
 }
@@ -1500,36 +1751,8 @@ bool vtkSlicerTerminologiesModuleLogic::FindTypesInTerminologyCategory(
   // Make lowercase for case-insensitive comparison
   std::transform(search.begin(), search.end(), search.begin(), ::tolower);
 
-  // Traverse types
-  rapidjson::SizeType index = 0;
-  while (index < typeArray.Size())
-    {
-    rapidjson::Value& type = typeArray[index];
-    if (type.IsObject())
-      {
-      rapidjson::Value& typeName = type["CodeMeaning"];
-      rapidjson::Value& typeCodingSchemeDesignator = type["CodingSchemeDesignator"];
-      rapidjson::Value& typeCodeValue = type["CodeValue"];
-      if (typeName.IsString() && typeCodingSchemeDesignator.IsString() && typeCodeValue.IsString())
-        {
-        // Add type to list if search string is empty or is contained by the current type name
-        std::string typeNameStr = typeName.GetString();
-        std::string typeNameLowerCase(typeNameStr);
-        std::transform(typeNameLowerCase.begin(), typeNameLowerCase.end(), typeNameLowerCase.begin(), ::tolower);
-        if (search.empty() || typeNameLowerCase.find(search) != std::string::npos)
-          {
-          CodeIdentifier typeId(typeCodingSchemeDesignator.GetString(), typeCodeValue.GetString(), typeNameStr);
-          types.push_back(typeId);
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindTypesInTerminologyCategory: Invalid type '" << typeName.GetString() << "in category '"
-          << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
-        }
-      }
-    ++index;
-    }
+  // Add types with names containing the search string
+  this->Internal->FindCodesInArray(typeArray, search, types);
 
   return true;
 }
@@ -1570,24 +1793,7 @@ bool vtkSlicerTerminologiesModuleLogic::GetTypeModifiersInTerminologyType(
     }
 
   // Collect type modifiers
-  rapidjson::SizeType index = 0;
-  while (index < typeModifierArray.Size())
-    {
-    rapidjson::Value& typeModifier = typeModifierArray[index];
-    if (typeModifier.IsObject())
-      {
-      rapidjson::Value& typeModifierName = typeModifier["CodeMeaning"];
-      rapidjson::Value& typeModifierCodingSchemeDesignator = typeModifier["CodingSchemeDesignator"];
-      rapidjson::Value& typeModifierCodeValue = typeModifier["CodeValue"];
-      if (typeModifierName.IsString() && typeModifierCodingSchemeDesignator.IsString() && typeModifierCodeValue.IsString())
-        {
-        CodeIdentifier typeModifierId(typeModifierCodingSchemeDesignator.GetString(),
-          typeModifierCodeValue.GetString(), typeModifierName.GetString());
-        typeModifiers.push_back(typeModifierId);
-        }
-      }
-    ++index;
-    } // For each type modifier index
+  this->Internal->FindCodesInArray(typeModifierArray, "", typeModifiers);
 
   return true;
 }
@@ -1634,36 +1840,8 @@ bool vtkSlicerTerminologiesModuleLogic::FindRegionsInAnatomicContext(std::string
   // Make lowercase for case-insensitive comparison
   std::transform(search.begin(), search.end(), search.begin(), ::tolower);
 
-  // Traverse regions
-  rapidjson::SizeType index = 0;
-  while (index<regionArray.Size())
-    {
-    rapidjson::Value& region = regionArray[index];
-    if (region.IsObject())
-      {
-      rapidjson::Value& regionName = region["CodeMeaning"];
-      rapidjson::Value& regionCodingSchemeDesignator = region["CodingSchemeDesignator"];
-      rapidjson::Value& regionCodeValue = region["CodeValue"];
-      if (regionName.IsString() && regionCodingSchemeDesignator.IsString() && regionCodeValue.IsString())
-        {
-        // Add region name to list if search string is empty or is contained by the current region name
-        std::string regionNameStr = regionName.GetString();
-        std::string regionNameLowerCase(regionNameStr);
-        std::transform(regionNameLowerCase.begin(), regionNameLowerCase.end(), regionNameLowerCase.begin(), ::tolower);
-        if (search.empty() || regionNameLowerCase.find(search) != std::string::npos)
-          {
-          CodeIdentifier regionId(regionCodingSchemeDesignator.GetString(), regionCodeValue.GetString(), regionNameStr);
-          regions.push_back(regionId);
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindRegionsInAnatomicContext: Invalid region '" << regionName.GetString()
-          << "' in anatomic context '" << anatomicContextName << "'");
-        }
-      }
-    ++index;
-    }
+  // Add regions with names containing the search string
+  this->Internal->FindCodesInArray(regionArray, search, regions);
 
   return true;
 }
@@ -1702,24 +1880,7 @@ bool vtkSlicerTerminologiesModuleLogic::GetRegionModifiersInAnatomicRegion(
     }
 
   // Collect region modifiers
-  rapidjson::SizeType index = 0;
-  while (index<regionModifierArray.Size())
-    {
-    rapidjson::Value& regionModifier = regionModifierArray[index];
-    if (regionModifier.IsObject())
-      {
-      rapidjson::Value& regionModifierName = regionModifier["CodeMeaning"];
-      rapidjson::Value& regionModifierCodingSchemeDesignator = regionModifier["CodingSchemeDesignator"];
-      rapidjson::Value& regionModifierCodeValue = regionModifier["CodeValue"];
-      if (regionModifierName.IsString() && regionModifierCodingSchemeDesignator.IsString() && regionModifierCodeValue.IsString())
-        {
-        CodeIdentifier regionModifierId(regionModifierCodingSchemeDesignator.GetString(),
-          regionModifierCodeValue.GetString(), regionModifierName.GetString());
-          regionModifiers.push_back(regionModifierId);
-        }
-      }
-    ++index;
-    } // For each region index
+  this->Internal->FindCodesInArray(regionModifierArray, "", regionModifiers);
 
   return true;
 }
@@ -2053,118 +2214,23 @@ bool vtkSlicerTerminologiesModuleLogic::FindTypeInTerminologyBy3dSlicerLabel(std
     return false;
     }
 
+  // Look up the label in the index built when the terminology was loaded
   bool found = false;
   CodeIdentifier foundCategoryId;
   CodeIdentifier foundTypeId;
   CodeIdentifier foundTypeModifierId;
-
-  // Traverse categories
-  rapidjson::SizeType categoryIndex = 0;
-  while (categoryIndex < categoryArray.Size())
+  std::map<std::string, vtkInternal::SlicerLabelMap>::iterator labelsIt = this->Internal->SlicerLabelIndices.find(terminologyName);
+  if (labelsIt != this->Internal->SlicerLabelIndices.end())
     {
-    rapidjson::Value& category = categoryArray[categoryIndex];
-    if (category.IsObject())
+    vtkInternal::SlicerLabelMap::iterator labelIt = labelsIt->second.find(slicerLabel);
+    if (labelIt != labelsIt->second.end())
       {
-      rapidjson::Value& categoryName = category["CodeMeaning"];
-      rapidjson::Value& categoryCodingSchemeDesignator = category["CodingSchemeDesignator"];
-      rapidjson::Value& categoryCodeValue = category["CodeValue"];
-      if (categoryName.IsString() && categoryCodingSchemeDesignator.IsString() && categoryCodeValue.IsString())
-        {
-        CodeIdentifier categoryId(categoryCodingSchemeDesignator.GetString(), categoryCodeValue.GetString(), categoryName.GetString());
-        rapidjson::Value& typeArray = this->Internal->GetTypeArrayInTerminologyCategory(terminologyName, categoryId);
-        if (typeArray.IsNull())
-          {
-          vtkErrorMacro("FindTypeInTerminologyBy3dSlicerLabel: Failed to find category '"
-            << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
-          ++categoryIndex;
-          continue;
-          }
-
-        // Traverse types
-        rapidjson::SizeType typeIndex = 0;
-        while (typeIndex < typeArray.Size())
-          {
-          rapidjson::Value& type = typeArray[typeIndex];
-          if (type.IsObject())
-            {
-            rapidjson::Value& typeName = type["CodeMeaning"];
-            rapidjson::Value& typeCodingSchemeDesignator = type["CodingSchemeDesignator"];
-            rapidjson::Value& typeCodeValue = type["CodeValue"];
-            if (typeName.IsString() && typeCodingSchemeDesignator.IsString() && typeCodeValue.IsString())
-              {
-              CodeIdentifier typeId(typeCodingSchemeDesignator.GetString(), typeCodeValue.GetString(), typeName.GetString());
-              rapidjson::Value::MemberIterator currentSlicerLabelIt = type.FindMember("3dSlicerLabel");
-              if (currentSlicerLabelIt != type.MemberEnd() && !slicerLabel.compare(currentSlicerLabelIt->value.GetString()))
-                {
-                // 3dSlicerLabel found in type
-                found = true;
-                foundCategoryId = categoryId;
-                foundTypeId = typeId;
-                break;
-                }
-
-              rapidjson::Value& typeModifierArray = this->Internal->GetTypeModifierArrayInTerminologyType(terminologyName, categoryId, typeId);
-              if (typeModifierArray.IsNull())
-                {
-                ++typeIndex;
-                continue;
-                }
-
-              // Traverse type modifiers
-              rapidjson::SizeType typeModifierIndex = 0;
-              while (typeModifierIndex < typeModifierArray.Size())
-                {
-                rapidjson::Value& typeModifier = typeModifierArray[typeModifierIndex];
-                if (typeModifier.IsObject())
-                  {
-                  rapidjson::Value& typeModifierName = typeModifier["CodeMeaning"];
-                  rapidjson::Value& typeModifierCodingSchemeDesignator = typeModifier["CodingSchemeDesignator"];
-                  rapidjson::Value& typeModifierCodeValue = typeModifier["CodeValue"];
-                  if (typeModifierName.IsString() && typeModifierCodingSchemeDesignator.IsString() && typeModifierCodeValue.IsString())
-                    {
-                    CodeIdentifier typeModifierId(typeModifierCodingSchemeDesignator.GetString(),
-                      typeModifierCodeValue.GetString(), typeModifierName.GetString());
-                    rapidjson::Value::MemberIterator currentSlicerLabelIt = typeModifier.FindMember("3dSlicerLabel");
-                    if (currentSlicerLabelIt != typeModifier.MemberEnd() && !slicerLabel.compare(currentSlicerLabelIt->value.GetString()))
-                      {
-                      // 3dSlicerLabel found in type modifier
-                      found = true;
-                      foundCategoryId = categoryId;
-                      foundTypeId = typeId;
-                      foundTypeModifierId = typeModifierId;
-                      break;
-                      }
-                    }
-                  }
-                ++typeModifierIndex;
-                } // For all type modifiers
-
-              if (found)
-                {
-                break;
-                }
-              }
-            else
-              {
-              vtkErrorMacro("FindTypeInTerminologyBy3dSlicerLabel: Invalid type '" << typeName.GetString() << "in category '"
-                << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
-              }
-            }
-          ++typeIndex;
-          } // For all types
-
-        if (found)
-          {
-          break;
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindTypeInTerminologyBy3dSlicerLabel: Invalid category '" << categoryName.GetString() << "' in terminology '" << terminologyName << "'");
-        }
+      found = true;
+      foundCategoryId = labelIt->second.CategoryId;
+      foundTypeId = labelIt->second.TypeId;
+      foundTypeModifierId = labelIt->second.TypeModifierId;
       }
-    ++categoryIndex;
-    } // For all categories
+    }
 
   if (found)
     {
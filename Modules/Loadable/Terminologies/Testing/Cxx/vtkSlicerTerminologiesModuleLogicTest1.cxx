@@ -0,0 +1,298 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Terminologies includes
+#include "vtkSlicerTerminologiesModuleLogic.h"
+#include "vtkSlicerTerminologyCategory.h"
+#include "vtkSlicerTerminologyEntry.h"
+#include "vtkSlicerTerminologyType.h"
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <fstream>
+#include <string>
+#include <vector>
+
+typedef vtkSlicerTerminologiesModuleLogic::CodeIdentifier CodeIdentifier;
+
+namespace
+{
+
+const char* TERMINOLOGY_NAME = "Test terminology";
+
+// Initial content of the terminology
+const char* TERMINOLOGY_JSON = R"({
+  "@schema": "https://raw.githubusercontent.com/qiicr/dcmqi/master/doc/schemas/segment-context-schema.json#",
+  "SegmentationCategoryTypeContextName": "Test terminology",
+  "SegmentationCodes": {
+    "Category": [
+      {
+        "CodeMeaning": "Tissue", "CodingSchemeDesignator": "SCT", "CodeValue": "85756007",
+        "Type": [
+          {
+            "CodeMeaning": "Artery", "CodingSchemeDesignator": "SCT", "CodeValue": "51114001",
+            "3dSlicerLabel": "artery", "recommendedDisplayRGBValue": [216, 101, 79],
+            "Modifier": [
+              {
+                "CodeMeaning": "Right", "CodingSchemeDesignator": "SCT", "CodeValue": "24028007",
+                "3dSlicerLabel": "right artery", "recommendedDisplayRGBValue": [216, 101, 79]
+              },
+              {
+                "CodeMeaning": "Left", "CodingSchemeDesignator": "SCT", "CodeValue": "7771000",
+                "3dSlicerLabel": "left artery", "recommendedDisplayRGBValue": [216, 101, 79]
+              }
+            ]
+          },
+          {
+            "CodeMeaning": "Vein", "CodingSchemeDesignator": "SCT", "CodeValue": "29092000",
+            "3dSlicerLabel": "vein", "recommendedDisplayRGBValue": [0, 151, 206]
+          },
+          {
+            "CodeMeaning": "Cartilage", "CodingSchemeDesignator": "SCT", "CodeValue": "309312004",
+            "3dSlicerLabel": "cartilage", "recommendedDisplayRGBValue": [111, 184, 210]
+          }
+        ]
+      },
+      {
+        "CodeMeaning": "Anatomical Structure", "CodingSchemeDesignator": "SCT", "CodeValue": "123037004",
+        "Type": [
+          {
+            "CodeMeaning": "Liver", "CodingSchemeDesignator": "SCT", "CodeValue": "10200004",
+            "3dSlicerLabel": "liver", "recommendedDisplayRGBValue": [221, 130, 101]
+          }
+        ]
+      }
+    ]
+  }
+})";
+
+// Replacement with the same context name: artery is removed, vein is renamed,
+// a type and a category are added
+const char* REPLACED_TERMINOLOGY_JSON = R"({
+  "@schema": "https://raw.githubusercontent.com/qiicr/dcmqi/master/doc/schemas/segment-context-schema.json#",
+  "SegmentationCategoryTypeContextName": "Test terminology",
+  "SegmentationCodes": {
+    "Category": [
+      {
+        "CodeMeaning": "Tissue", "CodingSchemeDesignator": "SCT", "CodeValue": "85756007",
+        "Type": [
+          {
+            "CodeMeaning": "Cartilage", "CodingSchemeDesignator": "SCT", "CodeValue": "309312004",
+            "3dSlicerLabel": "cartilage", "recommendedDisplayRGBValue": [111, 184, 210]
+          },
+          {
+            "CodeMeaning": "Venous structure", "CodingSchemeDesignator": "SCT", "CodeValue": "29092000",
+            "3dSlicerLabel": "vein", "recommendedDisplayRGBValue": [0, 151, 206]
+          },
+          {
+            "CodeMeaning": "Capillary", "CodingSchemeDesignator": "SCT", "CodeValue": "87247006",
+            "3dSlicerLabel": "capillary", "recommendedDisplayRGBValue": [200, 90, 80]
+          }
+        ]
+      },
+      {
+        "CodeMeaning": "Anatomical Structure", "CodingSchemeDesignator": "SCT", "CodeValue": "123037004",
+        "Type": [
+          {
+            "CodeMeaning": "Liver", "CodingSchemeDesignator": "SCT", "CodeValue": "10200004",
+            "3dSlicerLabel": "liver", "recommendedDisplayRGBValue": [221, 130, 101]
+          }
+        ]
+      },
+      {
+        "CodeMeaning": "Physical object", "CodingSchemeDesignator": "SCT", "CodeValue": "260787004",
+        "Type": [
+          {
+            "CodeMeaning": "Needle", "CodingSchemeDesignator": "SCT", "CodeValue": "79068005",
+            "3dSlicerLabel": "needle", "recommendedDisplayRGBValue": [216, 216, 216]
+          }
+        ]
+      }
+    ]
+  }
+})";
+
+const CodeIdentifier TISSUE("SCT", "85756007", "Tissue");
+const CodeIdentifier ANATOMICAL_STRUCTURE("SCT", "123037004", "Anatomical Structure");
+const CodeIdentifier PHYSICAL_OBJECT("SCT", "260787004", "Physical object");
+const CodeIdentifier ARTERY("SCT", "51114001", "Artery");
+const CodeIdentifier VEIN("SCT", "29092000", "Vein");
+const CodeIdentifier CAPILLARY("SCT", "87247006", "Capillary");
+
+//----------------------------------------------------------------------------
+bool WriteFile(const std::string& filePath, const char* content)
+{
+  std::ofstream file(filePath.c_str());
+  if (!file.is_open())
+    {
+    std::cerr << "Failed to write file " << filePath << std::endl;
+    return false;
+    }
+  file << content;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Code meanings of the types found in the Tissue category, in terminology order
+std::vector<std::string> FindTissueTypes(vtkSlicerTerminologiesModuleLogic* logic, const std::string& search)
+{
+  std::vector<CodeIdentifier> types;
+  logic->FindTypesInTerminologyCategory(TERMINOLOGY_NAME, TISSUE, types, search);
+  std::vector<std::string> names;
+  for (const CodeIdentifier& type : types)
+    {
+    names.push_back(type.CodeMeaning);
+    }
+  return names;
+}
+
+//----------------------------------------------------------------------------
+int TestLookupAndSearch(vtkSlicerTerminologiesModuleLogic* logic)
+{
+  // Lookup by code
+  vtkNew<vtkSlicerTerminologyCategory> category;
+  CHECK_BOOL(logic->GetCategoryInTerminology(TERMINOLOGY_NAME, ANATOMICAL_STRUCTURE, category.GetPointer()), true);
+  CHECK_STRING(category->GetCodeMeaning(), "Anatomical Structure");
+  vtkNew<vtkSlicerTerminologyType> type;
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(TERMINOLOGY_NAME, TISSUE, VEIN, type.GetPointer()), true);
+  CHECK_STRING(type->GetCodeMeaning(), "Vein");
+  CHECK_STRING(type->GetSlicerLabel(), "vein");
+  std::vector<CodeIdentifier> typeModifiers;
+  CHECK_BOOL(logic->GetTypeModifiersInTerminologyType(TERMINOLOGY_NAME, TISSUE, ARTERY, typeModifiers), true);
+  CHECK_INT(typeModifiers.size(), 2);
+  CHECK_STD_STRING(typeModifiers[1].CodeMeaning, "Left");
+
+  // Lookup of a code that is in another category
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(TERMINOLOGY_NAME, ANATOMICAL_STRUCTURE, VEIN, type.GetPointer()), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  // Search by name, case-insensitive
+  std::vector<CodeIdentifier> categories;
+  CHECK_BOOL(logic->FindCategoriesInTerminology(TERMINOLOGY_NAME, categories, "STRUCT"), true);
+  CHECK_INT(categories.size(), 1);
+  CHECK_STD_STRING(categories[0].CodeValue, ANATOMICAL_STRUCTURE.CodeValue);
+  CHECK_INT(FindTissueTypes(logic, "").size(), 3);
+  CHECK_INT(FindTissueTypes(logic, "ar").size(), 2);
+  // Searches extending the previous one are narrowed from the previous matches
+  CHECK_INT(FindTissueTypes(logic, "art").size(), 2);
+  std::vector<std::string> names = FindTissueTypes(logic, "arte");
+  CHECK_INT(names.size(), 1);
+  CHECK_STD_STRING(names[0], "Artery");
+  // Searches not extending the previous one are not limited to the previous matches
+  names = FindTissueTypes(logic, "VE");
+  CHECK_INT(names.size(), 1);
+  CHECK_STD_STRING(names[0], "Vein");
+  CHECK_INT(FindTissueTypes(logic, "nothing").size(), 0);
+
+  // Lookup by 3dSlicerLabel, for types and type modifiers
+  vtkNew<vtkSlicerTerminologyEntry> entry;
+  CHECK_BOOL(logic->FindTypeInTerminologyBy3dSlicerLabel(TERMINOLOGY_NAME, "liver", entry.GetPointer()), true);
+  CHECK_STRING(entry->GetCategoryObject()->GetCodeValue(), ANATOMICAL_STRUCTURE.CodeValue.c_str());
+  CHECK_STRING(entry->GetTypeObject()->GetCodeMeaning(), "Liver");
+  vtkNew<vtkSlicerTerminologyEntry> modifierEntry;
+  CHECK_BOOL(logic->FindTypeInTerminologyBy3dSlicerLabel(TERMINOLOGY_NAME, "left artery", modifierEntry.GetPointer()), true);
+  CHECK_STRING(modifierEntry->GetTypeObject()->GetCodeMeaning(), "Artery");
+  CHECK_STRING(modifierEntry->GetTypeModifierObject()->GetCodeMeaning(), "Left");
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// The indices must reflect the replaced document, not the one loaded first
+int TestLookupAndSearchAfterReplace(vtkSlicerTerminologiesModuleLogic* logic)
+{
+  std::vector<std::string> terminologyNames;
+  logic->GetLoadedTerminologyNames(terminologyNames);
+  CHECK_INT(terminologyNames.size(), 1);
+
+  // Lookup by code
+  vtkNew<vtkSlicerTerminologyType> type;
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(TERMINOLOGY_NAME, TISSUE, ARTERY, type.GetPointer()), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(TERMINOLOGY_NAME, TISSUE, VEIN, type.GetPointer()), true);
+  CHECK_STRING(type->GetCodeMeaning(), "Venous structure");
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(TERMINOLOGY_NAME, TISSUE, CAPILLARY, type.GetPointer()), true);
+  CHECK_STRING(type->GetCodeMeaning(), "Capillary");
+  vtkNew<vtkSlicerTerminologyCategory> category;
+  CHECK_BOOL(logic->GetCategoryInTerminology(TERMINOLOGY_NAME, PHYSICAL_OBJECT, category.GetPointer()), true);
+  CHECK_STRING(category->GetCodeMeaning(), "Physical object");
+
+  // Search by name
+  std::vector<CodeIdentifier> categories;
+  CHECK_BOOL(logic->GetCategoriesInTerminology(TERMINOLOGY_NAME, categories), true);
+  CHECK_INT(categories.size(), 3);
+  std::vector<std::string> names = FindTissueTypes(logic, "ar");
+  CHECK_INT(names.size(), 2);
+  CHECK_STD_STRING(names[0], "Cartilage");
+  CHECK_STD_STRING(names[1], "Capillary");
+  names = FindTissueTypes(logic, "ve");
+  CHECK_INT(names.size(), 1);
+  CHECK_STD_STRING(names[0], "Venous structure");
+  CHECK_INT(FindTissueTypes(logic, "arte").size(), 0);
+
+  // Lookup by 3dSlicerLabel
+  vtkNew<vtkSlicerTerminologyEntry> entry;
+  CHECK_BOOL(logic->FindTypeInTerminologyBy3dSlicerLabel(TERMINOLOGY_NAME, "artery", entry.GetPointer()), false);
+  CHECK_BOOL(logic->FindTypeInTerminologyBy3dSlicerLabel(TERMINOLOGY_NAME, "left artery", entry.GetPointer()), false);
+  CHECK_BOOL(logic->FindTypeInTerminologyBy3dSlicerLabel(TERMINOLOGY_NAME, "vein", entry.GetPointer()), true);
+  CHECK_STRING(entry->GetTypeObject()->GetCodeMeaning(), "Venous structure");
+  CHECK_BOOL(logic->FindTypeInTerminologyBy3dSlicerLabel(TERMINOLOGY_NAME, "needle", entry.GetPointer()), true);
+  CHECK_STRING(entry->GetCategoryObject()->GetCodeValue(), PHYSICAL_OBJECT.CodeValue.c_str());
+  CHECK_STRING(entry->GetTypeObject()->GetCodeMeaning(), "Needle");
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSlicerTerminologiesModuleLogicTest1(int argc, char* argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string directory = std::string(argv[1]) + "/vtkSlicerTerminologiesModuleLogicTest1";
+  vtksys::SystemTools::MakeDirectory(directory);
+  std::string terminologyFilePath = directory + "/TestTerminology.json";
+  std::string replacedTerminologyFilePath = directory + "/TestTerminologyReplaced.json";
+  CHECK_BOOL(WriteFile(terminologyFilePath, TERMINOLOGY_JSON), true);
+  CHECK_BOOL(WriteFile(replacedTerminologyFilePath, REPLACED_TERMINOLOGY_JSON), true);
+
+  // No scene is set, so the default terminologies are not loaded
+  vtkNew<vtkSlicerTerminologiesModuleLogic> logic;
+  CHECK_STD_STRING(logic->LoadTerminologyFromFile(terminologyFilePath), TERMINOLOGY_NAME);
+  CHECK_EXIT_SUCCESS(TestLookupAndSearch(logic.GetPointer()));
+
+  // Loading a terminology with the same context name replaces the previous one
+  CHECK_STD_STRING(logic->LoadTerminologyFromFile(replacedTerminologyFilePath), TERMINOLOGY_NAME);
+  CHECK_EXIT_SUCCESS(TestLookupAndSearchAfterReplace(logic.GetPointer()));
+
+  // Loading the original terminology again restores the original content
+  CHECK_STD_STRING(logic->LoadTerminologyFromFile(terminologyFilePath), TERMINOLOGY_NAME);
+  CHECK_EXIT_SUCCESS(TestLookupAndSearch(logic.GetPointer()));
+
+  vtksys::SystemTools::RemoveADirectory(directory);
+  return EXIT_SUCCESS;
+}
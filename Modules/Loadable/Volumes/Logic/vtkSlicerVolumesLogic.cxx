@@ -26,6 +26,7 @@
 // MRML nodes includes
 #include "vtkCacheManager.h"
 #include "vtkDataIOManager.h"
+#include "vtkMRMLChunkedVolumeStorageNode.h"
 #include "vtkMRMLDiffusionTensorVolumeDisplayNode.h"
 #include "vtkMRMLDiffusionTensorVolumeNode.h"
 #include "vtkMRMLDiffusionTensorVolumeSliceDisplayNode.h"
@@ -35,6 +36,7 @@
 #include "vtkMRMLLabelMapVolumeNode.h"
 #include "vtkMRMLNRRDStorageNode.h"
 #include "vtkMRMLScene.h"
+#include "vtkMRMLStreamingVolumeNode.h"
 #include "vtkMRMLVectorVolumeDisplayNode.h"
 #include "vtkMRMLVectorVolumeNode.h"
 #include "vtkMRMLVolumeArchetypeStorageNode.h"
@@ -46,6 +48,7 @@
 #include <vtkGeneralTransform.h>
 #include <vtkImageData.h>
 #include <vtkImageThreshold.h>
+#include <vtkIntArray.h>
 #include <vtkMathUtilities.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -389,6 +392,46 @@ ArchetypeVolumeNodeSet ScalarVolumeNodeSetFactory(std::string& volumeName, vtkMR
   return nodeSet;
 }
 
+//----------------------------------------------------------------------------
+ArchetypeVolumeNodeSet ChunkedVolumeNodeSetFactory(std::string& volumeName, vtkMRMLScene* scene, int options, bool labelMap)
+{
+  ArchetypeVolumeNodeSet nodeSet(scene);
+
+  // set up the scalar node's support nodes
+  vtkMRMLVolumeDisplayNode* displayNode = vtkMRMLVolumeDisplayNode::SafeDownCast(nodeSet.Scene->AddNewNodeByClass(
+    labelMap ? "vtkMRMLLabelMapVolumeDisplayNode" : "vtkMRMLScalarVolumeDisplayNode"));
+
+  vtkMRMLScalarVolumeNode* scalarNode = vtkMRMLScalarVolumeNode::SafeDownCast(nodeSet.Scene->AddNewNodeByClass(
+    labelMap ? "vtkMRMLLabelMapVolumeNode" : "vtkMRMLScalarVolumeNode", volumeName));
+  scalarNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+
+  vtkMRMLChunkedVolumeStorageNode* storageNode =
+      vtkMRMLChunkedVolumeStorageNode::SafeDownCast(
+        nodeSet.Scene->AddNewNodeByClass("vtkMRMLChunkedVolumeStorageNode"));
+  storageNode->SetCenterImage(options & vtkSlicerVolumesLogic::CenterImage);
+  scalarNode->SetAndObserveStorageNodeID(storageNode->GetID());
+
+  nodeSet.StorageNode = storageNode;
+  nodeSet.DisplayNode = displayNode;
+  nodeSet.Node = scalarNode;
+
+  nodeSet.LabelMap = labelMap;
+
+  return nodeSet;
+}
+
+//----------------------------------------------------------------------------
+ArchetypeVolumeNodeSet ChunkedLabelMapVolumeNodeSetFactory(std::string& volumeName, vtkMRMLScene* scene, int options)
+{
+  return ChunkedVolumeNodeSetFactory(volumeName, scene, options, true);
+}
+
+//----------------------------------------------------------------------------
+ArchetypeVolumeNodeSet ChunkedScalarVolumeNodeSetFactory(std::string& volumeName, vtkMRMLScene* scene, int options)
+{
+  return ChunkedVolumeNodeSetFactory(volumeName, scene, options, false);
+}
+
 } // end of anonymous namespace
 
 //----------------------------------------------------------------------------
@@ -399,6 +442,8 @@ vtkSlicerVolumesLogic::vtkSlicerVolumesLogic()
   this->RegisterArchetypeVolumeNodeSetFactory( DiffusionTensorVolumeNodeSetFactory );
   this->RegisterArchetypeVolumeNodeSetFactory( NRRDVectorVolumeNodeSetFactory );
   this->RegisterArchetypeVolumeNodeSetFactory( ArchetypeVectorVolumeNodeSetFactory );
+  this->RegisterArchetypeVolumeNodeSetFactory( ChunkedLabelMapVolumeNodeSetFactory );
+  this->RegisterArchetypeVolumeNodeSetFactory( ChunkedScalarVolumeNodeSetFactory );
   this->RegisterArchetypeVolumeNodeSetFactory( LabelMapVolumeNodeSetFactory );
   this->RegisterArchetypeVolumeNodeSetFactory( ScalarVolumeNodeSetFactory );
 
@@ -411,7 +456,71 @@ vtkSlicerVolumesLogic::~vtkSlicerVolumesLogic()
 = default;
 
 //----------------------------------------------------------------------------
-void vtkSlicerVolumesLogic::ProcessMRMLNodesEvents(vtkObject *vtkNotUsed(caller),
+void vtkSlicerVolumesLogic::SetMRMLSceneInternal(vtkMRMLScene* newScene)
+{
+  vtkNew<vtkIntArray> events;
+  events->InsertNextValue(vtkMRMLScene::NodeAddedEvent);
+  events->InsertNextValue(vtkMRMLScene::NodeRemovedEvent);
+  events->InsertNextValue(vtkMRMLScene::EndCloseEvent);
+  this->SetAndObserveMRMLSceneEventsInternal(newScene, events.GetPointer());
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumesLogic::UpdateFromMRMLScene()
+{
+  bool hadAsynchronousNodes = !this->AsynchronousStreamingVolumeNodes.empty();
+  this->AsynchronousStreamingVolumeNodes.clear();
+  if (this->GetMRMLScene())
+    {
+    std::vector<vtkMRMLNode*> nodes;
+    this->GetMRMLScene()->GetNodesByClass("vtkMRMLStreamingVolumeNode", nodes);
+    for (vtkMRMLNode* node : nodes)
+      {
+      this->OnMRMLSceneNodeAdded(node);
+      }
+    }
+  if (hadAsynchronousNodes && this->AsynchronousStreamingVolumeNodes.empty())
+    {
+    this->InvokeEvent(AsynchronousStreamingVolumeNodesModifiedEvent);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumesLogic::OnMRMLSceneNodeAdded(vtkMRMLNode* node)
+{
+  vtkMRMLStreamingVolumeNode* streamingVolumeNode = vtkMRMLStreamingVolumeNode::SafeDownCast(node);
+  if (!streamingVolumeNode)
+    {
+    return;
+    }
+  // Asynchronous decoding is turned on and off after the node is added
+  if (!vtkIsObservedMRMLNodeEventMacro(streamingVolumeNode, vtkCommand::ModifiedEvent))
+    {
+    vtkObserveMRMLNodeMacro(streamingVolumeNode);
+    }
+  this->UpdateAsynchronousStreamingVolumeNode(streamingVolumeNode);
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumesLogic::OnMRMLSceneNodeRemoved(vtkMRMLNode* node)
+{
+  vtkMRMLStreamingVolumeNode* streamingVolumeNode = vtkMRMLStreamingVolumeNode::SafeDownCast(node);
+  if (!streamingVolumeNode)
+    {
+    return;
+    }
+  vtkUnObserveMRMLNodeMacro(streamingVolumeNode);
+  this->UpdateAsynchronousStreamingVolumeNode(streamingVolumeNode, true);
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumesLogic::OnMRMLSceneEndClose()
+{
+  this->UpdateFromMRMLScene();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumesLogic::ProcessMRMLNodesEvents(vtkObject *caller,
                                             unsigned long event,
                                             void *callData)
 {
@@ -419,6 +528,42 @@ void vtkSlicerVolumesLogic::ProcessMRMLNodesEvents(vtkObject *vtkNotUsed(caller)
     {
     this->InvokeEvent ( vtkCommand::ProgressEvent,callData );
     }
+  else if (event == vtkCommand::ModifiedEvent)
+    {
+    vtkMRMLStreamingVolumeNode* streamingVolumeNode = vtkMRMLStreamingVolumeNode::SafeDownCast(caller);
+    if (streamingVolumeNode)
+      {
+      this->UpdateAsynchronousStreamingVolumeNode(streamingVolumeNode);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumesLogic::UpdateAsynchronousStreamingVolumeNode(vtkMRMLStreamingVolumeNode* node, bool removed)
+{
+  std::vector< vtkWeakPointer<vtkMRMLStreamingVolumeNode> >::iterator it =
+    std::find(this->AsynchronousStreamingVolumeNodes.begin(), this->AsynchronousStreamingVolumeNodes.end(), node);
+  bool wasAsynchronous = (it != this->AsynchronousStreamingVolumeNodes.end());
+  bool asynchronous = (!removed && node->GetAsynchronousDecoding());
+  if (asynchronous == wasAsynchronous)
+    {
+    return;
+    }
+  if (asynchronous)
+    {
+    this->AsynchronousStreamingVolumeNodes.push_back(node);
+    }
+  else
+    {
+    this->AsynchronousStreamingVolumeNodes.erase(it);
+    }
+  this->InvokeEvent(AsynchronousStreamingVolumeNodesModifiedEvent);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerVolumesLogic::GetNumberOfAsynchronousStreamingVolumeNodes()const
+{
+  return static_cast<int>(this->AsynchronousStreamingVolumeNodes.size());
 }
 
 //----------------------------------------------------------------------------
@@ -1332,6 +1477,27 @@ void vtkSlicerVolumesLogic::ComputeTkRegVox2RASMatrix ( vtkMRMLVolumeNode *VNode
     M->SetElement ( 3, 3, 1.0 );
 }
 
+//-------------------------------------------------------------------------
+int vtkSlicerVolumesLogic::UpdateStreamingVolumeNodes()
+{
+  // Only the nodes that decode in the background are visited, the list is
+  // kept up-to-date from the scene and node events. A copy is iterated as
+  // updating a node may modify the list.
+  std::vector< vtkWeakPointer<vtkMRMLStreamingVolumeNode> > asynchronousNodes =
+    this->AsynchronousStreamingVolumeNodes;
+  int numberOfAsynchronousNodes = 0;
+  for (vtkMRMLStreamingVolumeNode* streamingVolumeNode : asynchronousNodes)
+    {
+    if (!streamingVolumeNode)
+      {
+      continue;
+      }
+    ++numberOfAsynchronousNodes;
+    streamingVolumeNode->UpdateDecodedImage();
+    }
+  return numberOfAsynchronousNodes;
+}
+
 //-------------------------------------------------------------------------
 void vtkSlicerVolumesLogic::CenterVolume(vtkMRMLVolumeNode* volumeNode)
 {
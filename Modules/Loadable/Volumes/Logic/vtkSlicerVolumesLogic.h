@@ -29,15 +29,20 @@
 #include "vtkMRMLScene.h"
 #include "vtkMRMLVolumeNode.h"
 
+// VTK includes
+#include <vtkWeakPointer.h>
+
 // STD includes
 #include <cstdlib>
 #include <list>
+#include <vector>
 
 #include "vtkSlicerVolumesModuleLogicExport.h"
 
 class vtkMRMLLabelMapVolumeNode;
 class vtkMRMLScalarVolumeNode;
 class vtkMRMLScalarVolumeDisplayNode;
+class vtkMRMLStreamingVolumeNode;
 class vtkMRMLVolumeHeaderlessStorageNode;
 class vtkStringArray;
 
@@ -69,6 +74,14 @@ public:
 
   typedef vtkSlicerVolumesLogic Self;
 
+  enum Events
+  {
+    /// Invoked when a streaming volume node starts or stops decoding its
+    /// frames in a background thread
+    /// \sa GetNumberOfAsynchronousStreamingVolumeNodes()
+    AsynchronousStreamingVolumeNodesModifiedEvent = vtkCommand::UserEvent + 1
+  };
+
   /// Loading options, bitfield
   enum LoadingOptions {
     LabelMap = 1,
@@ -286,16 +299,40 @@ public:
   /// \sa SetCompareVolumeGeometryEpsilon
   vtkGetMacro(CompareVolumeGeometryPrecision, int);
 
+  /// Update the image data of the streaming volume nodes that decode their
+  /// frames in background threads with their most recently decoded image.
+  /// Does not wait for the decoding threads. Must be called from the main thread.
+  /// Returns the number of streaming volume nodes using asynchronous decoding.
+  /// \sa vtkMRMLStreamingVolumeNode::UpdateDecodedImage()
+  int UpdateStreamingVolumeNodes();
+
+  /// Number of streaming volume nodes of the scene that decode their frames
+  /// in background threads.
+  /// \sa AsynchronousStreamingVolumeNodesModifiedEvent
+  int GetNumberOfAsynchronousStreamingVolumeNodes()const;
+
 protected:
   vtkSlicerVolumesLogic();
   ~vtkSlicerVolumesLogic() override;
   vtkSlicerVolumesLogic(const vtkSlicerVolumesLogic&);
   void operator=(const vtkSlicerVolumesLogic&);
 
+  void SetMRMLSceneInternal(vtkMRMLScene* newScene) override;
+  void UpdateFromMRMLScene() override;
+  void OnMRMLSceneNodeAdded(vtkMRMLNode* node) override;
+  void OnMRMLSceneNodeRemoved(vtkMRMLNode* node) override;
+  void OnMRMLSceneEndClose() override;
+
   void ProcessMRMLNodesEvents(vtkObject * caller,
                                   unsigned long event,
                                   void * callData) override;
 
+  /// Add or remove the streaming volume node from the asynchronously decoded
+  /// nodes, depending on its decoding mode. The node is removed if
+  /// \a removed is true.
+  /// \sa AsynchronousStreamingVolumeNodesModifiedEvent
+  void UpdateAsynchronousStreamingVolumeNode(vtkMRMLStreamingVolumeNode* node, bool removed = false);
+
 
   void InitializeStorageNode(vtkMRMLStorageNode * storageNode,
                              const char * filename,
@@ -328,6 +365,10 @@ protected:
   /// Error print out precision, paried with CompareVolumeGeometryEpsilon.
   /// defaults to 6
   int CompareVolumeGeometryPrecision;
+
+  /// Streaming volume nodes of the scene that decode their frames in
+  /// background threads
+  std::vector< vtkWeakPointer<vtkMRMLStreamingVolumeNode> > AsynchronousStreamingVolumeNodes;
 };
 
 #endif
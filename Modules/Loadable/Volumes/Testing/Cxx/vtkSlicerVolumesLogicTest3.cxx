@@ -0,0 +1,93 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Volumes logic
+#include "vtkSlicerVolumesLogic.h"
+#include "vtkMRMLCoreTestingMacros.h"
+
+// MRML includes
+#include <vtkMRMLScene.h>
+#include <vtkMRMLStreamingVolumeNode.h>
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkNew.h>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+void CountEvents(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                 void* clientData, void* vtkNotUsed(callData))
+{
+  ++(*reinterpret_cast<int*>(clientData));
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+// Check that the logic keeps track of the streaming volume nodes that decode
+// their frames in the background, without polling the scene.
+int vtkSlicerVolumesLogicTest3(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLStreamingVolumeNode> existingNode;
+  existingNode->SetAsynchronousDecoding(true);
+  scene->AddNode(existingNode.GetPointer());
+
+  vtkNew<vtkSlicerVolumesLogic> logic;
+  int numberOfEvents = 0;
+  vtkNew<vtkCallbackCommand> callback;
+  callback->SetCallback(CountEvents);
+  callback->SetClientData(&numberOfEvents);
+  logic->AddObserver(vtkSlicerVolumesLogic::AsynchronousStreamingVolumeNodesModifiedEvent, callback.GetPointer());
+
+  // Nodes already in the scene
+  logic->SetMRMLScene(scene.GetPointer());
+  CHECK_INT(logic->GetNumberOfAsynchronousStreamingVolumeNodes(), 1);
+  CHECK_INT(logic->UpdateStreamingVolumeNodes(), 1);
+
+  // Synchronous decoding by default
+  vtkNew<vtkMRMLStreamingVolumeNode> node;
+  scene->AddNode(node.GetPointer());
+  CHECK_INT(logic->GetNumberOfAsynchronousStreamingVolumeNodes(), 1);
+  numberOfEvents = 0;
+
+  node->SetAsynchronousDecoding(true);
+  CHECK_INT(logic->GetNumberOfAsynchronousStreamingVolumeNodes(), 2);
+  CHECK_INT(numberOfEvents, 1);
+  CHECK_INT(logic->UpdateStreamingVolumeNodes(), 2);
+
+  // Other modifications of the node do not change the list
+  node->SetName("Streaming");
+  CHECK_INT(numberOfEvents, 1);
+
+  node->SetAsynchronousDecoding(false);
+  CHECK_INT(logic->GetNumberOfAsynchronousStreamingVolumeNodes(), 1);
+  CHECK_INT(numberOfEvents, 2);
+
+  scene->RemoveNode(existingNode.GetPointer());
+  CHECK_INT(logic->GetNumberOfAsynchronousStreamingVolumeNodes(), 0);
+  CHECK_INT(numberOfEvents, 3);
+  CHECK_INT(logic->UpdateStreamingVolumeNodes(), 0);
+
+  // Removed from the list when the scene is closed
+  node->SetAsynchronousDecoding(true);
+  CHECK_INT(logic->GetNumberOfAsynchronousStreamingVolumeNodes(), 1);
+  scene->Clear(0);
+  CHECK_INT(logic->GetNumberOfAsynchronousStreamingVolumeNodes(), 0);
+
+  return EXIT_SUCCESS;
+}
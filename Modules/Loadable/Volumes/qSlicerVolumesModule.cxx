@@ -18,6 +18,9 @@
 
 ==============================================================================*/
 
+// Qt includes
+#include <QTimer>
+
 // SlicerQt includes
 #include <qSlicerCoreApplication.h>
 #include <qSlicerIOManager.h>
@@ -49,8 +52,16 @@
 class qSlicerVolumesModulePrivate
 {
 public:
+  /// Polls the streaming volume nodes that decode frames in the background
+  QTimer StreamingVolumeUpdateTimer;
 };
 
+namespace
+{
+/// Polling interval when asynchronously decoded streaming volumes are in the scene
+const int StreamingVolumeUpdateInterval = 15;
+}
+
 //-----------------------------------------------------------------------------
 qSlicerVolumesModule::qSlicerVolumesModule(QObject* _parent)
   : Superclass(_parent)
@@ -147,12 +158,50 @@ void qSlicerVolumesModule::setup()
     "Volumes", QString("VolumeFile"),
     QStringList() << "vtkMRMLVolumeNode", true, this));
 
+  // Decoded frames of streaming volumes are picked up in the main thread,
+  // the timer only runs while asynchronous decoding is used
+  Q_D(qSlicerVolumesModule);
+  d->StreamingVolumeUpdateTimer.setInterval(StreamingVolumeUpdateInterval);
+  QObject::connect(&d->StreamingVolumeUpdateTimer, SIGNAL(timeout()),
+                   this, SLOT(updateStreamingVolumeNodes()));
+  qvtkConnect(volumesLogic, vtkSlicerVolumesLogic::AsynchronousStreamingVolumeNodesModifiedEvent,
+              this, SLOT(updateStreamingVolumeUpdateTimer()));
+  this->updateStreamingVolumeUpdateTimer();
+
   // Register Subject Hierarchy core plugins
   qSlicerSubjectHierarchyPluginHandler::instance()->registerPlugin(new qSlicerSubjectHierarchyVolumesPlugin());
   qSlicerSubjectHierarchyPluginHandler::instance()->registerPlugin(new qSlicerSubjectHierarchyLabelMapsPlugin());
   qSlicerSubjectHierarchyPluginHandler::instance()->registerPlugin(new qSlicerSubjectHierarchyDiffusionTensorVolumesPlugin());
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerVolumesModule::updateStreamingVolumeNodes()
+{
+  vtkSlicerVolumesLogic* volumesLogic =
+    vtkSlicerVolumesLogic::SafeDownCast(this->logic());
+  if (volumesLogic)
+    {
+    volumesLogic->UpdateStreamingVolumeNodes();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerVolumesModule::updateStreamingVolumeUpdateTimer()
+{
+  Q_D(qSlicerVolumesModule);
+  vtkSlicerVolumesLogic* volumesLogic =
+    vtkSlicerVolumesLogic::SafeDownCast(this->logic());
+  bool asynchronousNodes = volumesLogic && volumesLogic->GetNumberOfAsynchronousStreamingVolumeNodes() > 0;
+  if (asynchronousNodes && !d->StreamingVolumeUpdateTimer.isActive())
+    {
+    d->StreamingVolumeUpdateTimer.start();
+    }
+  else if (!asynchronousNodes)
+    {
+    d->StreamingVolumeUpdateTimer.stop();
+    }
+}
+
 //-----------------------------------------------------------------------------
 qSlicerAbstractModuleRepresentation* qSlicerVolumesModule::createWidgetRepresentation()
 {
@@ -21,6 +21,9 @@
 #ifndef __qSlicerVolumesModule_h
 #define __qSlicerVolumesModule_h
 
+// CTK includes
+#include <ctkVTKObject.h>
+
 // SlicerQt includes
 #include "qSlicerLoadableModule.h"
 
@@ -34,6 +37,7 @@ class Q_SLICER_QTMODULES_VOLUMES_EXPORT qSlicerVolumesModule :
   public qSlicerLoadableModule
 {
   Q_OBJECT
+  QVTK_OBJECT
   Q_PLUGIN_METADATA(IID "org.slicer.modules.loadable.qSlicerLoadableModule/1.0");
   Q_INTERFACES(qSlicerLoadableModule);
 
@@ -51,6 +55,15 @@ public:
   QStringList dependencies()const override;
   qSlicerGetTitleMacro(QTMODULE_TITLE);
 
+protected slots:
+  /// Update the image data of the streaming volume nodes decoded in the background.
+  /// Called periodically from a timer.
+  void updateStreamingVolumeNodes();
+
+  /// Run the timer that updates the streaming volume nodes only while some
+  /// of them decode their frames in the background.
+  void updateStreamingVolumeUpdateTimer();
+
 protected:
   /// Initialize the module. Register the volumes reader/writer
   void setup() override;
@@ -104,7 +104,7 @@ QStringList qSlicerVolumesReader::extensions()const
 {
   // pic files are bio-rad images (see itkBioRadImageIO)
   return QStringList()
-    << "Volume (*.hdr *.nhdr *.nrrd *.mhd *.mha *.mnc *.vti *.nii *.nii.gz *.mgh *.mgz *.mgh.gz *.img *.img.gz *.pic)"
+    << "Volume (*.hdr *.nhdr *.nrrd *.mhd *.mha *.mnc *.vti *.nii *.nii.gz *.mgh *.mgz *.mgh.gz *.img *.img.gz *.pic *.cvol)"
     << "Dicom (*.dcm *.ima)"
     << "Image (*.png *.tif *.tiff *.jpg *.jpeg)"
     << "All Files (*)";
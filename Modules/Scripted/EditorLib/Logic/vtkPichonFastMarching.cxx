@@ -20,26 +20,25 @@
 #include <vtkMath.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 
 ///////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////
 
-// used to compute the median
-int compareInt(const void *a, const void *b)
-{
-  return  (*(int*)a) - (*(int*)b);
-}
-
-///////////////////////////////////////////////////////////////////////
-///////////////////////////////////////////////////////////////////////
-
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkPichonFastMarching);
 
 //------------------------------------------------------------------------------
 void vtkPichonFastMarching::collectInfoSeed( int index )
 {
+  if( indata==nullptr )
+    {
+    // input is not available yet, statistics will be collected in the first execution
+    pendingInfoPoints.push_back(index);
+    return;
+    }
+
   int med, inh;
   getMedianInhomo(index, med, inh);
 
@@ -100,15 +99,16 @@ void vtkPichonFastMarching::setSeed( int index )
       return;
     }
 
-  if( node[index].status!=fmsFAR )
+  FMnode& seedNode = getNode(index);
+  if( seedNode.status!=fmsFAR )
     {
       // this seed has already been planted
       return;
     }
 
   // by definition, T=0, and that voxel is known
-  node[index].T=0.0;
-  node[index].status=fmsKNOWN;
+  seedNode.T=0.0;
+  seedNode.status=fmsKNOWN;
 
   knownPoints.push_back(index);
 
@@ -117,56 +117,215 @@ void vtkPichonFastMarching::setSeed( int index )
     {
       FMleaf f;
       f.nodeIndex=index + shiftNeighbor(n);
-      if( node[ f.nodeIndex ].status==fmsFAR )
+      if( getStatus( f.nodeIndex )==fmsFAR )
     {
-      node[f.nodeIndex].status=fmsTRIAL;
-      node[f.nodeIndex].T = (float) ( distanceNeighbor(n) / speed(f.nodeIndex) );
+      FMnode& neighborNode = getNode(f.nodeIndex);
+      neighborNode.status=fmsTRIAL;
+      neighborNode.T = (float) ( distanceNeighbor(n) / speed(f.nodeIndex) );
 
       insert( f ); // insert in minheap
     }
     }
 }
 
-inline void vtkPichonFastMarching::getMedianInhomo( int index, int &med, int &inh )
+//------------------------------------------------------------------------------
+// Computes median intensity and inhomogeneity of voxels in parallel.
+class vtkPichonFastMarchingMedianInhomoFunctor
 {
-  // assert( (index>=(1+dimX+dimXY)) && (index<(dimXYZ-1-dimX-dimXY)) );
+public:
+  vtkPichonFastMarchingMedianInhomoFunctor(const vtkPichonFastMarching* self, const VecInt& indices,
+    std::vector<FMmedianInhomo>& result)
+    : Self(self), Indices(indices), Result(result)
+  {
+  }
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      this->Self->computeMedianInhomo(this->Indices[i], this->Result[i].median, this->Result[i].inhomo);
+      }
+  }
+private:
+  const vtkPichonFastMarching* Self;
+  const VecInt& Indices;
+  std::vector<FMmedianInhomo>& Result;
+};
 
-  inh = inhomo[index];
-  if( inh != (-1) )
+//------------------------------------------------------------------------------
+inline void vtkPichonFastMarching::getMedianInhomo( int index, int &med, int &inh )
+{
+  MapFMmedianInhomo::const_iterator it = medianInhomo.find(index);
+  if( it != medianInhomo.end() )
     // then the values have already been computed
     {
-      med = median[index];
+      med = it->second.median;
+      inh = it->second.inhomo;
       return;
     }
 
   // otherwise, just do it
+  computeMedianInhomo( index, med, inh );
+  FMmedianInhomo& values = medianInhomo[index];
+  values.median = med;
+  values.inhomo = inh;
+}
+
+//------------------------------------------------------------------------------
+void vtkPichonFastMarching::computeMedianInhomo( int index, int &med, int &inh ) const
+{
+  // we should never have to look at these values anyway !
+  if( isInOutsideBand(index) )
+    {
+      inh = depth;
+      med = 0;
+      return;
+    }
+
+  int neighborhood[27];
   for(int k=0;k<=26;k++)
-      tmpNeighborhood[k] = (int)indata[index + arrayShiftNeighbor[k]];
+      neighborhood[k] = (int)indata[index + arrayShiftNeighbor[k]];
 
-  qsort( (void*)tmpNeighborhood, 27, sizeof(int), &compareInt );
+  std::sort( neighborhood, neighborhood+27 );
 
-  inh = inhomo[ index ] = (tmpNeighborhood[21] - tmpNeighborhood[5]);
-  med = median[ index ] = tmpNeighborhood[13];
+  inh = (neighborhood[21] - neighborhood[5]);
+  med = neighborhood[13];
+}
 
-  /*
-    // same thing for 125-neighbors
+//------------------------------------------------------------------------------
+void vtkPichonFastMarching::precomputeMedianInhomo( const VecInt& indices )
+{
+  VecInt missingIndices;
+  for(VecInt::const_iterator it=indices.begin(); it!=indices.end(); ++it)
+    {
+      if( medianInhomo.find(*it)==medianInhomo.end() )
+        missingIndices.push_back(*it);
+    }
+  std::sort( missingIndices.begin(), missingIndices.end() );
+  missingIndices.erase( std::unique( missingIndices.begin(), missingIndices.end() ), missingIndices.end() );
+  if( missingIndices.empty() )
+    return;
 
-    int p=0;
-    for(int px=-2;px<=2;px++)
-    for(int py=-2;py<=2;py++)
-    for(int pz=-2;pz<=2;pz++)
+  std::vector<FMmedianInhomo> values( missingIndices.size() );
+  vtkPichonFastMarchingMedianInhomoFunctor functor( this, missingIndices, values );
+  vtkSMPTools::For( 0, (vtkIdType)missingIndices.size(), functor );
+
+  medianInhomo.reserve( medianInhomo.size() + missingIndices.size() );
+  for(size_t i=0; i<missingIndices.size(); i++)
+    medianInhomo[ missingIndices[i] ] = values[i];
+}
+
+//------------------------------------------------------------------------------
+bool vtkPichonFastMarching::isInOutsideBand( int index ) const
+{
+  int i = index % dimX;
+  int j = (index / dimX) % dimY;
+  int k = index / dimXY;
+  return ( (i<BAND_OUT) || (j<BAND_OUT) || (k<BAND_OUT) ||
+    (i >= (dimX - BAND_OUT)) || (j >= (dimY - BAND_OUT)) || (k >= (dimZ - BAND_OUT)) );
+}
+
+//------------------------------------------------------------------------------
+FMstatus vtkPichonFastMarching::defaultStatus( int index )
+{
+  if( isInOutsideBand(index) )
+    return fmsOUT;
+  return ( outdata[index]==0 ? fmsFAR : fmsDONE );
+}
+
+//------------------------------------------------------------------------------
+FMnode& vtkPichonFastMarching::getNode( int index )
+{
+  std::unique_ptr<FMnode[]>& block = nodeBlocks[index >> FM_NODE_BLOCK_BITS];
+  if( !block )
+    {
+      // status is resolved when a node is first accessed, as it depends on the output image
+      block.reset( new FMnode[FM_NODE_BLOCK_SIZE] );
+      for( int i=0; i<FM_NODE_BLOCK_SIZE; i++ )
     {
-    int k=index + px + py * dimX + pz * dimXY;
-    tmpNeighborhood[p++] = (int)indata[k];
+      block[i].status = fmsUNVISITED;
+      block[i].T = (float)INF;
+      block[i].leafIndex = -1;
     }
+    }
+  FMnode& n = block[index & (FM_NODE_BLOCK_SIZE - 1)];
+  if( n.status==fmsUNVISITED )
+    n.status = defaultStatus(index);
+  return n;
+}
 
-    qsort( (void*)tmpNeighborhood, 125, sizeof(int), &compareInt );
+//------------------------------------------------------------------------------
+FMstatus vtkPichonFastMarching::getStatus( int index )
+{
+  if( !nodeBlocks[index >> FM_NODE_BLOCK_BITS] )
+    return defaultStatus(index);
+  const FMnode& n = node(index);
+  if( n.status==fmsUNVISITED )
+    return defaultStatus(index);
+  return n.status;
+}
 
-    inh = inhomo[ index ] = (tmpNeighborhood[105] - tmpNeighborhood[20]);
-    med = median[ index ] = tmpNeighborhood[63];
-  */
+//------------------------------------------------------------------------------
+float vtkPichonFastMarching::getT( int index )
+{
+  // T is INF for unvisited nodes
+  if( !nodeBlocks[index >> FM_NODE_BLOCK_BITS] )
+    return (float)INF;
+  return node(index).T;
 }
 
+//------------------------------------------------------------------------------
+// Finds voxels of the active label and their seeds, one slice at a time.
+// Results are stored per slice so that they can be merged in a deterministic order.
+class vtkPichonFastMarchingSeedFunctor
+{
+public:
+  struct SliceResult
+  {
+    VecInt labelPoints;
+    std::vector<FMmedianInhomo> labelMedianInhomo;
+    VecInt seedPoints;
+  };
+
+  vtkPichonFastMarchingSeedFunctor(const vtkPichonFastMarching* self, std::vector<SliceResult>& result)
+    : Self(self), Result(result)
+  {
+  }
+  void operator()(vtkIdType beginSlice, vtkIdType endSlice) const
+  {
+    const vtkPichonFastMarching* self = this->Self;
+    for (vtkIdType k = beginSlice; k < endSlice; ++k)
+      {
+      SliceResult& result = this->Result[k];
+      int index = (int)k * self->dimXY;
+      for (int j = 0; j < self->dimY; j++)
+        {
+        for (int i = 0; i < self->dimX; i++, index++)
+          {
+          if ( (self->outdata[index] != self->label) || self->isInOutsideBand(index) )
+            {
+            continue;
+            }
+          FMmedianInhomo values;
+          self->computeMedianInhomo(index, values.median, values.inhomo);
+          result.labelPoints.push_back(index);
+          result.labelMedianInhomo.push_back(values);
+          for (int n = 1; n < self->nNeighbors; n++)
+            {
+            if (self->outdata[index + self->arrayShiftNeighbor[n]] == 0)
+              {
+              result.seedPoints.push_back(index + self->arrayShiftNeighbor[n]);
+              }
+            }
+          }
+        }
+      }
+  }
+private:
+  const vtkPichonFastMarching* Self;
+  std::vector<SliceResult>& Result;
+};
+
+//------------------------------------------------------------------------------
 void vtkPichonFastMarching::initNewExpansion( void )
 {
   if(invalidInputs)
@@ -178,61 +337,41 @@ void vtkPichonFastMarching::initNewExpansion( void )
   // empty interface points
   while(tree.size()>0)
     {
-      node[ tree[tree.size()-1].nodeIndex ].status=fmsFAR;
-      node[ tree[tree.size()-1].nodeIndex ].T=(float)INF;
+      FMnode& interfaceNode = getNode( tree[tree.size()-1].nodeIndex );
+      interfaceNode.status=fmsFAR;
+      interfaceNode.T=(float)INF;
       tree.pop_back();
     }
 
   // empty the list of known points
-  while(knownPoints.size()>0)
-    {
-      knownPoints.pop_back();
-    }
+  knownPoints.clear();
   nEvolutions=-1;
 
   firstCall=true;
 
-  while(seedPoints.size()>0)
-    seedPoints.pop_back();
+  seedPoints.clear();
 
-  int index=0;
-  for(int k=0;k<dimZ;k++)
-    for(int j=0;j<dimY;j++)
-      for(int i=0;i<dimX;i++)
+  if( outdata==nullptr || indata==nullptr )
     {
-      if( (outdata[index]==label) && (node[index].status!=fmsOUT) )
-        {
-            collectInfoSeed( index );
-            for(int n=1;n<nNeighbors;n++)
-            if(outdata[index+shiftNeighbor(n)]==0)
-              {
-                seedPoints.push_back( index+shiftNeighbor(n) );
-                }
+      // there is no image to collect seeds from yet
+      return;
+    }
 
-/*
-          bool hasIntensityZeroNeighbor = false;
-          for(int n=1;n<nNeighbors;n++)
-        if(outdata[index+shiftNeighbor(n)]==0)
-          {
-            hasIntensityZeroNeighbor=true;
-            break;
-          }
+  // voxels of the active label are searched in parallel, statistics are then
+  // collected and seeds are added in the same order as a sequential scan would
+  std::vector<vtkPichonFastMarchingSeedFunctor::SliceResult> sliceResults( dimZ );
+  vtkPichonFastMarchingSeedFunctor functor( this, sliceResults );
+  vtkSMPTools::For( 0, dimZ, functor );
 
-          if(hasIntensityZeroNeighbor)
-        {
-          node[index].status=fmsFAR;
-          seedPoints.push_back( index );
-        }
-          else
+  for(int k=0;k<dimZ;k++)
+    {
+      vtkPichonFastMarchingSeedFunctor::SliceResult& result = sliceResults[k];
+      for(size_t p=0;p<result.labelPoints.size();p++)
         {
-          node[index].status=fmsDONE;
-          node[index].T=0.0;
-        }
-*/
-
+          medianInhomo[ result.labelPoints[p] ] = result.labelMedianInhomo[p];
+          collectInfoSeed( result.labelPoints[p] );
         }
-
-      index++;
+      seedPoints.insert( seedPoints.end(), result.seedPoints.begin(), result.seedPoints.end() );
     }
 }
 
@@ -266,47 +405,9 @@ void vtkPichonFastMarchingExecute(vtkPichonFastMarching *self,
 
   if( !self->initialized )
     {
+    // nodes and statistics are created on demand, when the front reaches them,
+    // so there is no need to visit all the voxels here
     self->initialized = true;
-
-    int index=0;
-    int lastPercentageProgressBarUpdated=-1;
-
-    for(k=0;k<self->dimZ;k++)
-      {
-      // update progress bar
-      int currentPercentage = GRANULARITY_PROGRESS * index / self->dimXYZ;
-      if (currentPercentage > lastPercentageProgressBarUpdated)
-        {
-        lastPercentageProgressBarUpdated = currentPercentage;
-        self->UpdateProgress(float(currentPercentage) / float(GRANULARITY_PROGRESS));
-        }
-      for (int j = 0; j<self->dimY; j++)
-        for (int i = 0; i<self->dimX; i++)
-        {
-          self->node[index].T = (float)INF;
-
-          if (self->outdata[index] == 0)
-            self->node[index].status = fmsFAR;
-          else
-            self->node[index].status = fmsDONE;
-
-          self->inhomo[index] = -1; // meaning inhomo and median have not been computed there
-
-          if ((i<BAND_OUT) || (j<BAND_OUT) || (k<BAND_OUT) ||
-            (i >= (self->dimX - BAND_OUT)) || (j >= (self->dimY - BAND_OUT)) || (k >= (self->dimZ - BAND_OUT)))
-          {
-
-            self->node[index].status = fmsOUT;
-
-            // we should never have to look at these values anyway !
-            self->inhomo[index] = self->depth;
-            self->median[index] = 0;
-          }
-
-          index++;
-        }
-      }
-
     return;
     }
 
@@ -322,6 +423,20 @@ void vtkPichonFastMarchingExecute(vtkPichonFastMarching *self,
       self->firstCall=true; // we did not complete this step
       return;
       }
+
+    // compute statistics of all the seeds and their neighbors in parallel
+    VecInt infoPoints( self->pendingInfoPoints );
+    for(k=0;k<(int)self->seedPoints.size();k++)
+      for(n=0;n<=26;n++)
+        infoPoints.push_back( self->seedPoints[k]+self->shiftNeighbor(n) );
+    self->precomputeMedianInhomo( infoPoints );
+
+    // seeds added before the input was available
+    VecInt pendingInfoPoints;
+    pendingInfoPoints.swap( self->pendingInfoPoints );
+    for(k=0;k<(int)pendingInfoPoints.size();k++)
+      self->collectInfoSeed( pendingInfoPoints[k] );
+
     for(k=0;k<(int)self->seedPoints.size();k++)
       self->collectInfoSeed( self->seedPoints[k] );
 
@@ -342,8 +457,9 @@ void vtkPichonFastMarchingExecute(vtkPichonFastMarching *self,
       for(k=self->nPointsBeforeLeakEvolution;k<(int)self->knownPoints.size();k++)
         {
         int index = self->knownPoints[k];
-        self->node[ index ].status = fmsFAR;
-        self->node[ index ].T = (float)INF;
+        FMnode& knownNode = self->getNode( index );
+        knownNode.status = fmsFAR;
+        knownNode.T = (float)INF;
 
         /*
            we also want to remove the neighbors of these points that would be in TRIAL
@@ -354,10 +470,11 @@ void vtkPichonFastMarchingExecute(vtkPichonFastMarching *self,
         for(n=1;n<=self->nNeighbors;n++)
           {
           int indexN=index+self->shiftNeighbor(n);
-          if( self->node[indexN].status==fmsTRIAL )
+          if( self->getStatus(indexN)==fmsTRIAL )
             {
-            self->node[indexN].T=(float)INF;
-            self->downTree( self->node[indexN].leafIndex );
+            FMnode& trialNode = self->getNode( indexN );
+            trialNode.T=(float)INF;
+            self->downTree( trialNode.leafIndex );
             }
           }
         }
@@ -372,16 +489,18 @@ void vtkPichonFastMarchingExecute(vtkPichonFastMarching *self,
         for(n=1;n<=self->nNeighbors;n++)
           {
           indexN=index+self->shiftNeighbor(n);
-          if( self->node[indexN].status==fmsKNOWN )
+          if( self->getStatus(indexN)==fmsKNOWN )
             hasKnownNeighbor=true;
           }
 
-        if( (hasKnownNeighbor) && (self->node[index].status!=fmsOUT) )
+        if( (hasKnownNeighbor) && (self->getStatus(index)!=fmsOUT) )
           {
           FMleaf f;
 
-          self->node[index].T=self->computeT(index);
-          self->node[index].status=fmsTRIAL;
+          float T=self->computeT(index);
+          FMnode& trialNode = self->getNode( index );
+          trialNode.T=T;
+          trialNode.status=fmsTRIAL;
           f.nodeIndex=index;
 
           self->insert( f );
@@ -418,7 +537,14 @@ void vtkPichonFastMarchingExecute(vtkPichonFastMarching *self,
   for(n=0;n<self->nPointsEvolution;n++)
     {
     if( (n*GRANULARITY_PROGRESS) % self->nPointsEvolution == 0 )
+      {
       self->UpdateProgress(float(n)/float(self->nPointsEvolution));
+      if( self->GetAbortExecute() )
+        {
+        // keep the points that have been reached so far
+        break;
+        }
+      }
 
     float T=self->step();
 
@@ -467,14 +593,14 @@ void vtkPichonFastMarching::show(float r)
   if( newIndex > oldIndex )
     for(int index=(oldIndex+1);index<=newIndex;index++)
       {
-    if( node[ knownPoints[index] ].status==fmsKNOWN )
+    if( getNode(knownPoints[index]).status==fmsKNOWN )
         if(outdata[ knownPoints[index] ]==0)
           outdata[ knownPoints[index] ]=label;
       }
   else if( newIndex < oldIndex )
     for(int index=oldIndex;index>newIndex;index--)
       {
-    if(node[ knownPoints[index] ].status==fmsKNOWN )
+    if(getNode(knownPoints[index]).status==fmsKNOWN )
         if(outdata[ knownPoints[index] ]==label)
           outdata[ knownPoints[index] ]=0;
       }
@@ -554,7 +680,7 @@ void vtkPichonFastMarching::insert(const FMleaf leaf) {
 
   // insert element at the back
   tree.push_back( leaf );
-  node[ leaf.nodeIndex ].leafIndex=(int)(tree.size()-1);
+  node(leaf.nodeIndex).leafIndex=(int)(tree.size()-1);
 
   // trickle the element up until everything
   // is sorted again
@@ -568,7 +694,7 @@ bool vtkPichonFastMarching::minHeapIsSorted( void )
 
   for(k=(N-1);k>=1;k--)
     {
-      if(node[tree[k].nodeIndex].leafIndex!=k)
+      if(node(tree[k].nodeIndex).leafIndex!=k)
     {
       vtkErrorMacro( "Error in vtkPichonFastMarching::minHeapIsSorted(): "
              << "tree[" << k << "] : pb leafIndex/nodeIndex (size="
@@ -577,16 +703,16 @@ bool vtkPichonFastMarching::minHeapIsSorted( void )
     }
   for(k=(N-1);k>=1;k--)
     {
-      if( vtkMath::IsFinite( node[tree[k].nodeIndex].T)==0 )
+      if( vtkMath::IsFinite( node(tree[k].nodeIndex).T)==0 )
     vtkErrorMacro( "Error in vtkPichonFastMarching::minHeapIsSorted(): "
-               << "NaN or Inf value in minHeap : " << node[tree[k].nodeIndex].T );
+               << "NaN or Inf value in minHeap : " << node(tree[k].nodeIndex).T );
 
-      if( node[tree[k].nodeIndex].T<node[ (int)(tree[(k-1)/2].nodeIndex) ].T )
+      if( node(tree[k].nodeIndex).T<node(tree[(k-1)/2].nodeIndex).T )
     {
       vtkErrorMacro( "Error in vtkPichonFastMarching::minHeapIsSorted(): "
              << "minHeapIsSorted is false! : size=" << (unsigned int)tree.size() << "at leafIndex=" << k
-             << " node[tree[k].nodeIndex].T=" << node[tree[k].nodeIndex].T
-             << "<node[ (int)(tree[(k-1)/2].nodeIndex) ].T=" << node[ (int)(tree[(k-1)/2].nodeIndex) ].T);
+             << " node[tree[k].nodeIndex].T=" << node(tree[k].nodeIndex).T
+             << "<node[tree[(k-1)/2].nodeIndex].T=" << node(tree[(k-1)/2].nodeIndex).T);
 
       return false;
     }
@@ -626,8 +752,8 @@ void vtkPichonFastMarching::downTree(int index) {
        */
       if (RightChild < (int)tree.size()) {
 
-    if (node[tree[LeftChild].nodeIndex].T>
-        node[tree[RightChild].nodeIndex].T)
+    if (node(tree[LeftChild].nodeIndex).T>
+        node(tree[RightChild].nodeIndex).T)
       MinChild = RightChild;
       }
 
@@ -635,16 +761,16 @@ void vtkPichonFastMarching::downTree(int index) {
        * If the MinChild has smaller T than the current leaf,
        * swap them, and move the current leaf to the MinChild.
        */
-      if (node[tree[MinChild].nodeIndex].T<
-      node[tree[index].nodeIndex].T)
+      if (node(tree[MinChild].nodeIndex).T<
+      node(tree[index].nodeIndex).T)
     {
       FMleaf tmp=tree[index];
       tree[index]=tree[MinChild];
       tree[MinChild]=tmp;
 
       // make sure pointers remain correct
-      node[ tree[MinChild].nodeIndex ].leafIndex = MinChild;
-      node[ tree[index].nodeIndex ].leafIndex = index;
+      node(tree[MinChild].nodeIndex).leafIndex = MinChild;
+      node(tree[index].nodeIndex).leafIndex = index;
 
       index = MinChild;
 
@@ -672,8 +798,8 @@ void vtkPichonFastMarching::upTree(int index) {
     {
       int upIndex = (int) (index-1)/2;
 
-      if( node[tree[index].nodeIndex].T <
-      node[tree[upIndex].nodeIndex].T )
+      if( node(tree[index].nodeIndex).T <
+      node(tree[upIndex].nodeIndex).T )
     {
       // then swap the 2 nodes
 
@@ -682,8 +808,8 @@ void vtkPichonFastMarching::upTree(int index) {
       tree[upIndex]=tmp;
 
       // make sure pointers remain correct
-      node[ tree[upIndex].nodeIndex ].leafIndex = upIndex;
-      node[ tree[index].nodeIndex ].leafIndex = index;
+      node(tree[upIndex].nodeIndex).leafIndex = upIndex;
+      node(tree[index].nodeIndex).leafIndex = index;
 
       index = upIndex;
     }
@@ -705,7 +831,7 @@ FMleaf vtkPichonFastMarching::removeSmallest( void ) {
   tree[0]=tree[ tree.size()-1 ];
 
   // make sure pointers remain correct
-  node[ tree[0].nodeIndex ].leafIndex = 0;
+  node(tree[0].nodeIndex).leafIndex = 0;
 
   tree.pop_back();
 
@@ -724,9 +850,8 @@ vtkPichonFastMarching::vtkPichonFastMarching()
   initialized=false;
   invalidInputs=true;
 
-  node = nullptr;
-  inhomo = nullptr;
-  median = nullptr;
+  indata = nullptr;
+  outdata = nullptr;
 
   pdfIntensityIn = nullptr;
   pdfInhomoIn = nullptr;
@@ -816,29 +941,17 @@ void vtkPichonFastMarching::init(int _dimX, int _dimY, int _dimZ, double _depth,
 
   this->depth = (int) _depth;
 
-  delete[] node;
-  node = new FMnode[ dimX*dimY*dimZ ];
-  if(node==nullptr)
-    {
-      vtkErrorMacro("Error in void vtkPichonFastMarching::init(), not enough memory for allocation of 'node'");
-      return;
-    }
-
-  delete[] inhomo;
-  inhomo = new int[ dimX*dimY*dimZ ];
-  if(inhomo==nullptr)
-    {
-      vtkErrorMacro("Error in void vtkPichonFastMarching::init(), not enough memory for allocation of 'inhomo'");
-      return;
-    }
+  // Node state is only allocated for the blocks of voxels that the front reaches.
+  // Blocks are indexed directly so that the minheap can access nodes without lookups.
+  nodeBlocks.clear();
+  nodeBlocks.resize( (dimXYZ + FM_NODE_BLOCK_SIZE - 1) >> FM_NODE_BLOCK_BITS );
+  // statistics are only stored for voxels that are visited
+  medianInhomo.clear();
+  pendingInfoPoints.clear();
 
-  delete[] median;
-  median = new int[ dimX*dimY*dimZ ];
-  if(median==nullptr)
-    {
-      vtkErrorMacro("Error in void vtkPichonFastMarching::init(), not enough memory for allocation of 'median'");
-      return;
-    }
+  // image buffers of a previous execution may have different dimensions
+  indata = nullptr;
+  outdata = nullptr;
 
   delete pdfIntensityIn;
   pdfIntensityIn = new PichonFastMarchingPDF( (int) _depth );
@@ -876,13 +989,6 @@ void vtkPichonFastMarching::setOutData(short* data)
 
 vtkPichonFastMarching::~vtkPichonFastMarching()
 {
-  delete[] node;
-  node = nullptr;
-  delete[] inhomo;
-  inhomo = nullptr;
-  delete[] median;
-  median = nullptr;
-
   delete pdfIntensityIn;
   pdfIntensityIn = nullptr;
   delete pdfInhomoIn;
@@ -915,9 +1021,10 @@ int vtkPichonFastMarching::indexFather(int n )
   for(int k=1;k<=6;k++)
   {
     index = n+shiftNeighbor(k);
-    if( node[index].T<Tmin )
+    float T = getT(index);
+    if( T<Tmin )
     {
-      Tmin = node[index].T;
+      Tmin = T;
       indexMin = index;
     }
   }
@@ -954,7 +1061,8 @@ float vtkPichonFastMarching::step( void )
 
   min=removeSmallest();
 
-  if( node[min.nodeIndex].T>=INF )
+  FMnode& minNode = getNode(min.nodeIndex);
+  if( minNode.T>=INF )
     {
       vtkErrorMacro( " node[min.nodeIndex].T>=INF " << endl );
 
@@ -971,7 +1079,7 @@ float vtkPichonFastMarching::step( void )
   pdfIntensityIn->addRealization( I );
   pdfInhomoIn->addRealization( H );
 
-  node[min.nodeIndex].status=fmsKNOWN;
+  minNode.status=fmsKNOWN;
   knownPoints.push_back(min.nodeIndex);
 
   /* then we consider all the neighbors */
@@ -989,34 +1097,38 @@ float vtkPichonFastMarching::step( void )
        * If they are fmsFAR, recompute their crossing times, and move
        * them into fmsTRIAL.
        */
-      if( node[indexN].status==fmsFAR )
+      FMstatus statusN = getStatus(indexN);
+      if( statusN==fmsFAR )
     {
       FMleaf f;
-      node[indexN].T=computeT(indexN);
+      float T=computeT(indexN);
+      FMnode& nodeN = getNode(indexN);
+      nodeN.T=T;
       f.nodeIndex=indexN;
 
       insert( f );
 
-      node[indexN].status=fmsTRIAL;
+      nodeN.status=fmsTRIAL;
     }
-      else if( node[indexN].status==fmsTRIAL )
+      else if( statusN==fmsTRIAL )
     {
+      FMnode& nodeN = getNode(indexN);
       float t1,  t2;
-      t1 = node[indexN].T;
+      t1 = nodeN.T;
 
-      node[indexN].T=computeT(indexN);
+      nodeN.T=computeT(indexN);
 
-      t2 = node[indexN].T;
+      t2 = nodeN.T;
 
       if( t2<t1 )
-          upTree( node[indexN].leafIndex );
+          upTree( nodeN.leafIndex );
       else
-          downTree( node[indexN].leafIndex );
+          downTree( nodeN.leafIndex );
 
     }
     }
 
-  return node[min.nodeIndex].T;
+  return minNode.T;
 }
 
 float vtkPichonFastMarching::computeT(int index )
@@ -1041,16 +1153,16 @@ float vtkPichonFastMarching::computeT(int index )
 
   double Tij, Txm, Txp, Tym, Typ, Tzm, Tzp, TijNew;
 
-  Tij = node[index].T;
+  Tij = getT(index);
 
   /* we know that all neighbors are defined
      because this node is not fmsOUT */
-  Txm = node[index+shiftNeighbor(4)].T;
-  Txp = node[index+shiftNeighbor(2)].T;
-  Tym = node[index+shiftNeighbor(1)].T;
-  Typ = node[index+shiftNeighbor(3)].T;
-  Tzm = node[index+shiftNeighbor(5)].T;
-  Tzp = node[index+shiftNeighbor(6)].T;
+  Txm = getT(index+shiftNeighbor(4));
+  Txp = getT(index+shiftNeighbor(2));
+  Tym = getT(index+shiftNeighbor(1));
+  Typ = getT(index+shiftNeighbor(3));
+  Tzm = getT(index+shiftNeighbor(5));
+  Tzp = getT(index+shiftNeighbor(6));
 
   double Dxm, Dxp, Dym, Dyp, Dzm, Dzp;
 
@@ -1113,10 +1225,11 @@ float vtkPichonFastMarching::computeT(int index )
     for(int n=1;n<=nNeighbors;n++)
       {
     candidateIndex = index + shiftNeighbor(n);
-    if( (node[candidateIndex].status==fmsTRIAL)
-        || (node[candidateIndex].status==fmsKNOWN) )
+    FMstatus candidateStatus = getStatus(candidateIndex);
+    if( (candidateStatus==fmsTRIAL)
+        || (candidateStatus==fmsKNOWN) )
       {
-        candidateT = node[candidateIndex].T + distanceNeighbor(n)/s;
+        candidateT = getT(candidateIndex) + distanceNeighbor(n)/s;
 
         if( candidateT<Tij )
           Tij=candidateT;
@@ -19,6 +19,8 @@
 // STD includes
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <unordered_map>
 
 #define MAJOR_VERSION 3
 #define MINOR_VERSION 1
@@ -35,10 +37,14 @@
 
 #define GRANULARITY_PROGRESS 20
 
+/// node state is allocated by blocks of 2^FM_NODE_BLOCK_BITS voxels
+#define FM_NODE_BLOCK_BITS 12
+#define FM_NODE_BLOCK_SIZE (1 << FM_NODE_BLOCK_BITS)
+
 ///////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////
 
-typedef enum fmstatus { fmsDONE, fmsKNOWN, fmsTRIAL, fmsFAR, fmsOUT } FMstatus;
+typedef enum fmstatus { fmsDONE, fmsKNOWN, fmsTRIAL, fmsFAR, fmsOUT, fmsUNVISITED } FMstatus;
 #define MASK_BIT 256
 
 struct FMnode {
@@ -51,14 +57,34 @@ struct FMleaf {
   int nodeIndex;
 };
 
+/// median intensity and inhomogeneity in the 27-neighborhood of a voxel
+struct FMmedianInhomo {
+  int median;
+  int inhomo;
+};
+
 /// these typedef are for tclwrapper...
 typedef std::vector<FMleaf> VecFMleaf;
 typedef std::vector<int> VecInt;
+typedef std::vector< std::unique_ptr<FMnode[]> > VecFMnodeBlock;
+typedef std::unordered_map<int, FMmedianInhomo> MapFMmedianInhomo;
 
 class PichonFastMarchingPDF;
 
 ///////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////
+/// \brief Fast marching segmentation.
+///
+/// Arrival time, status and heap position are allocated by blocks of voxels
+/// when the front first reaches the block, and neighborhood statistics are only
+/// stored for visited voxels (narrow band and known points). Apart from one
+/// pointer per block, memory usage depends on the region reached by the front
+/// rather than on the size of the input volume.
+/// Neighborhood statistics of seeds are computed in parallel.
+///
+/// Progress is reported by ProgressEvent. The evolution can be interrupted
+/// by calling SetAbortExecute(1) (for example, from a progress observer);
+/// the points that have been reached until then are kept.
 class VTK_SLICER_EDITORLIB_MODULE_LOGIC_EXPORT vtkPichonFastMarching
   : public vtkImageAlgorithm
 {
@@ -103,6 +129,8 @@ protected:
   void ExecuteDataWithInformation(vtkDataObject *, vtkInformation *) override;
 
 
+  friend class vtkPichonFastMarchingMedianInhomoFunctor;
+  friend class vtkPichonFastMarchingSeedFunctor;
   friend void vtkPichonFastMarchingExecute(vtkPichonFastMarching *self,
                      vtkImageData *inData, short *inPtr,
                      vtkImageData *outData, short *outPtr,
@@ -119,8 +147,6 @@ private:
   int nNeighbors; /// =6 pb wrap, cannot be defined as constant
   int arrayShiftNeighbor[27];
   double arrayDistanceNeighbor[27];
-  int tmpNeighborhood[125]; /// allocate it here so that we do not have to
-  /// allocate it over and over in getMedianInhomo
 
   float dx;
   float dy;
@@ -133,9 +159,9 @@ private:
   bool initialized;
   bool firstCall;
 
-  FMnode *node;  /// arrival time and status for all voxels
-  int *inhomo; /// inhomogeneity
-  int *median; /// medican intensity
+  VecFMnodeBlock nodeBlocks; /// arrival time, status and heap position of voxels, by block (null until a voxel of the block is accessed)
+  MapFMmedianInhomo medianInhomo; /// median intensity and inhomogeneity for visited voxels
+  VecInt pendingInfoPoints; /// seed statistics to be collected when input is available
 
   short* outdata; /// output
   short* indata;  /// input
@@ -198,7 +224,25 @@ private:
 
   int indexFather(int index );
 
+  /// Get node of a voxel, its status is initialized if it has not been visited yet
+  FMnode& getNode(int index);
+  /// Get node of a voxel whose block is already allocated (voxels of the minheap)
+  FMnode& node(int index)
+    {
+    return nodeBlocks[index >> FM_NODE_BLOCK_BITS][index & (FM_NODE_BLOCK_SIZE - 1)];
+    }
+  /// Get status of a voxel without marking it as visited
+  FMstatus getStatus(int index);
+  /// Get arrival time of a voxel (INF if it has not been visited yet)
+  float getT(int index);
+  /// Status of a voxel that has not been visited yet
+  FMstatus defaultStatus(int index);
+  bool isInOutsideBand(int index) const;
+
   void getMedianInhomo(int index, int &median, int &inhomo );
+  void computeMedianInhomo(int index, int &median, int &inhomo ) const;
+  /// Compute median and inhomogeneity of multiple voxels in parallel
+  void precomputeMedianInhomo(const VecInt& indices);
 
   int shiftNeighbor(int n);
   double distanceNeighbor(int n);
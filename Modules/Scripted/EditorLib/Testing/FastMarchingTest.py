@@ -0,0 +1,112 @@
+from __future__ import print_function
+
+import unittest
+import vtk, slicer
+from slicer.ScriptedLoadableModule import *
+
+#
+# FastMarchingTest
+#
+
+class FastMarchingTest(ScriptedLoadableModule):
+  def __init__(self, parent):
+    ScriptedLoadableModule.__init__(self, parent)
+    parent.title = "FastMarchingTest"
+    parent.categories = ["Testing.TestCases"]
+    parent.contributors = ["Slicer Community"]
+    parent.helpText = """
+    Self test for the fast marching filter used by the editor.
+    No module interface here, only used in SelfTests module
+    """
+
+#
+# FastMarchingTestWidget
+#
+
+class FastMarchingTestWidget(ScriptedLoadableModuleWidget):
+
+  def setup(self):
+    ScriptedLoadableModuleWidget.setup(self)
+
+
+class FastMarchingTestTest(ScriptedLoadableModuleTest):
+
+  dimension = 32
+  boxExtent = [8, 23]
+
+  def setUp(self):
+    slicer.mrmlScene.Clear(0)
+
+  def runTest(self):
+    self.test_FastMarchingInsideBox()
+
+  def isInsideBox(self, i, j, k):
+    return all(self.boxExtent[0] <= x <= self.boxExtent[1] for x in (i, j, k))
+
+  def createImages(self):
+    """Bright box with some texture on a dark background, and a label image with seeds in the box center"""
+    dim = self.dimension
+    image = vtk.vtkImageData()
+    image.SetDimensions(dim, dim, dim)
+    image.AllocateScalars(vtk.VTK_SHORT, 1)
+    label = vtk.vtkImageData()
+    label.SetDimensions(dim, dim, dim)
+    label.AllocateScalars(vtk.VTK_SHORT, 1)
+    center = dim // 2
+    for k in range(dim):
+      for j in range(dim):
+        for i in range(dim):
+          texture = (i * 7 + j * 13 + k * 3) % 5
+          image.SetScalarComponentFromDouble(i, j, k, 0, (100 if self.isInsideBox(i, j, k) else 10) + texture)
+          isSeed = max(abs(i - center), abs(j - center), abs(k - center)) <= 1
+          label.SetScalarComponentFromDouble(i, j, k, 0, 1 if isSeed else 0)
+    return image, label
+
+  def runFastMarching(self, image, label, numberOfPoints):
+    dim = image.GetDimensions()
+    scalarRange = image.GetScalarRange()
+    fm = slicer.vtkPichonFastMarching()
+    fm.init(dim[0], dim[1], dim[2], scalarRange[1] - scalarRange[0], 1, 1, 1)
+    fm.SetInputData(image)
+    fm.setNPointsEvolution(numberOfPoints)
+    fm.setActiveLabel(1)
+    self.assertGreater(fm.addSeedsFromImage(label), 0)
+    fm.Modified()
+    fm.Update()
+    fm.show(1)
+    fm.Modified()
+    fm.Update()
+    output = vtk.vtkImageData()
+    output.DeepCopy(fm.GetOutput())
+    return output
+
+  def labeledVoxels(self, output):
+    dim = output.GetDimensions()
+    voxels = []
+    for k in range(dim[2]):
+      for j in range(dim[1]):
+        for i in range(dim[0]):
+          if output.GetScalarComponentAsDouble(i, j, k, 0) == 1:
+            voxels.append((i, j, k))
+    return voxels
+
+  def test_FastMarchingInsideBox(self):
+    """
+    The front starts from the seeds in the center of the box and is expected
+    to fill the homogeneous box region before leaking into the background.
+    """
+    self.delayDisplay("Starting the test")
+    image, label = self.createImages()
+    numberOfPoints = 2000  # fewer than the number of voxels in the box
+
+    output = self.runFastMarching(image, label, numberOfPoints)
+    voxels = self.labeledVoxels(output)
+    self.assertGreater(len(voxels), numberOfPoints // 2)
+    voxelsInsideBox = [voxel for voxel in voxels if self.isInsideBox(*voxel)]
+    self.assertGreaterEqual(len(voxelsInsideBox), 0.95 * len(voxels))
+
+    # The result does not depend on previous executions
+    repeatedVoxels = self.labeledVoxels(self.runFastMarching(image, label, numberOfPoints))
+    self.assertEqual(voxels, repeatedVoxels)
+
+    self.delayDisplay("Test passed!")